@@ -362,6 +362,11 @@ function build_webgl_with_target {
             tar -cvf "../../../filament-${lc_target}-web.tar" filament.js
             tar -rvf "../../../filament-${lc_target}-web.tar" filament.wasm
             tar -rvf "../../../filament-${lc_target}-web.tar" filament.d.ts
+            for mt_file in filament-mt.js filament-mt.wasm filament-mt.worker.js; do
+                if [[ -f "${mt_file}" ]]; then
+                    tar -rvf "../../../filament-${lc_target}-web.tar" "${mt_file}"
+                fi
+            done
             popd > /dev/null
             gzip -c "../filament-${lc_target}-web.tar" > "../filament-${lc_target}-web.tgz"
             rm "../filament-${lc_target}-web.tar"
@@ -371,6 +376,42 @@ function build_webgl_with_target {
     popd > /dev/null
 }
 
+# Builds the multi-threaded (pthreads) flavor of filament-js, and copies it next to the
+# single-threaded one so that both are packaged together.
+function build_webgl_threads_with_target {
+    local lc_target=$(echo "$1" | tr '[:upper:]' '[:lower:]')
+
+    echo "Building multi-threaded WebGL ${lc_target}..."
+    mkdir -p "out/cmake-webgl-mt-${lc_target}"
+    pushd "out/cmake-webgl-mt-${lc_target}" > /dev/null
+
+    (
+    # shellcheck disable=SC1090
+    source "${EMSDK}/emsdk_env.sh"
+    cmake \
+        -G "${BUILD_GENERATOR}" \
+        -DIMPORT_EXECUTABLES_DIR=out \
+        -DCMAKE_TOOLCHAIN_FILE="${EMSDK}/upstream/emscripten/cmake/Modules/Platform/Emscripten.cmake" \
+        -DCMAKE_BUILD_TYPE="$1" \
+        -DWEBGL=1 \
+        -DWEBGL_PTHREADS=1 \
+        ${WEBGPU_OPTION} \
+        ${BACKEND_DEBUG_FLAG_OPTION} \
+        ../..
+    ${BUILD_COMMAND} filament-js
+    )
+
+    local st_folder="../cmake-webgl-${lc_target}/web/filament-js"
+    mkdir -p "${st_folder}"
+    for mt_file in filament-mt.js filament-mt.wasm filament-mt.worker.js; do
+        if [[ -f "web/filament-js/${mt_file}" ]]; then
+            cp "web/filament-js/${mt_file}" "${st_folder}"
+        fi
+    done
+
+    popd > /dev/null
+}
+
 function build_webgl {
     # For the host tools, suppress install and always use Release.
     local old_install_command=${INSTALL_COMMAND}; INSTALL_COMMAND=
@@ -384,10 +425,12 @@ function build_webgl {
     ISSUE_RELEASE_BUILD=${old_issue_release_build}
 
     if [[ "${ISSUE_DEBUG_BUILD}" == "true" ]]; then
+        build_webgl_threads_with_target "Debug"
         build_webgl_with_target "Debug"
     fi
 
     if [[ "${ISSUE_RELEASE_BUILD}" == "true" ]]; then
+        build_webgl_threads_with_target "Release"
         build_webgl_with_target "Release"
     fi
 }
@@ -96,6 +96,23 @@ static constexpr uint64_t SWAP_CHAIN_HAS_STENCIL_BUFFER         = SWAP_CHAIN_CON
  */
 static constexpr uint64_t SWAP_CHAIN_CONFIG_PROTECTED_CONTENT   = 0x40;
 
+/**
+ * Presentation modes, the default is FIFO (v-synced, no tearing). MAILBOX replaces the queued
+ * image with the newest one, IMMEDIATE presents without waiting for v-sync, and FIFO_RELAXED only
+ * tears when a frame is late. Backends fall back to FIFO when the mode isn't supported.
+ * Currently only supported by the Vulkan backend.
+ */
+static constexpr uint64_t SWAP_CHAIN_CONFIG_PRESENT_MODE_MAILBOX        = 0x80;
+static constexpr uint64_t SWAP_CHAIN_CONFIG_PRESENT_MODE_IMMEDIATE      = 0x100;
+static constexpr uint64_t SWAP_CHAIN_CONFIG_PRESENT_MODE_FIFO_RELAXED   = 0x200;
+
+/**
+ * The SwapChain uses the fewest images the surface allows, instead of one more. This reduces
+ * the display latency, but the GPU may have to wait for an image to become available.
+ * Currently only supported by the Vulkan backend.
+ */
+static constexpr uint64_t SWAP_CHAIN_CONFIG_MINIMUM_IMAGE_COUNT = 0x400;
+
 static constexpr size_t MAX_VERTEX_ATTRIBUTE_COUNT  = 16;   // This is guaranteed by OpenGL ES.
 static constexpr size_t MAX_SAMPLER_COUNT           = 62;   // Maximum needed at feature level 3.
 static constexpr size_t MAX_VERTEX_BUFFER_COUNT     = 16;   // Max number of bound buffer objects.
@@ -158,6 +175,16 @@ enum class TimerQueryResult : int8_t {
     AVAILABLE = 1,  // result is available
 };
 
+/**
+ * GPU memory used by the process and the amount it can use, in bytes. A budget of 0 means the
+ * backend doesn't know it.
+ */
+struct MemoryBudget {
+    uint64_t usage = 0;     // memory allocated by the backend
+    uint64_t budget = 0;    // memory that can be allocated before performance degrades or
+                            // allocations start failing
+};
+
 static constexpr const char* backendToString(Backend backend) {
     switch (backend) {
         case Backend::NOOP:
@@ -343,6 +370,14 @@ struct Viewport {
     }
 };
 
+/**
+ * A range of indices drawn by DriverApi::multiDraw2()
+ */
+struct DrawRange {
+    uint32_t indexOffset;   //!< offset of the first index, in indices
+    uint32_t indexCount;    //!< number of indices to draw
+};
+
 /**
  * Specifies the mapping of the near and far clipping plane to window coordinates.
  */
@@ -775,6 +810,8 @@ enum class TextureUsage : uint16_t {
     BLIT_SRC            = 0x0040,            //!< Texture can be used the source of a blit()
     BLIT_DST            = 0x0080,            //!< Texture can be used the destination of a blit()
     PROTECTED           = 0x0100,            //!< Texture can be used for protected content
+    SPARSE              = 0x0200,            //!< Texture memory is committed page by page
+    TRANSIENT           = 0x0400,            //!< Content never outlives a render pass
     DEFAULT             = UPLOADABLE | SAMPLEABLE,   //!< Default texture usage
     ALL_ATTACHMENTS     = COLOR_ATTACHMENT | DEPTH_ATTACHMENT | STENCIL_ATTACHMENT | SUBPASS_INPUT,   //!< Mask of all attachments
 };
@@ -32,6 +32,7 @@ namespace filament::backend {
 struct HwBufferObject;
 struct HwFence;
 struct HwIndexBuffer;
+struct HwPipelineState;
 struct HwProgram;
 struct HwRenderPrimitive;
 struct HwRenderTarget;
@@ -145,6 +146,7 @@ private:
 using BufferObjectHandle        = Handle<HwBufferObject>;
 using FenceHandle               = Handle<HwFence>;
 using IndexBufferHandle         = Handle<HwIndexBuffer>;
+using PipelineStateHandle       = Handle<HwPipelineState>;
 using ProgramHandle             = Handle<HwProgram>;
 using RenderPrimitiveHandle     = Handle<HwRenderPrimitive>;
 using RenderTargetHandle        = Handle<HwRenderTarget>;
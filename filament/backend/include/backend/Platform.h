@@ -149,6 +149,12 @@ public:
          *      - PlatformEGLAndroid
          */
         bool assertNativeWindowIsValid = false;
+
+        /**
+         * Number of compiler threads (each with its own shared context) used for parallel
+         * shader compilation. 0 lets the backend decide. Currently only honored by the GL backend.
+         */
+        uint32_t shaderCompilerThreadCount = 0;
     };
 
     Platform() noexcept;
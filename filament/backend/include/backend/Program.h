@@ -144,6 +144,10 @@ public:
         return mSpecializationConstants;
     }
 
+    DescriptorSetInfo const& getDescriptorBindings() const noexcept {
+        return mDescriptorBindings;
+    }
+
     DescriptorSetInfo& getDescriptorBindings() noexcept {
         return mDescriptorBindings;
     }
@@ -242,6 +242,21 @@ public:
      */
     virtual void setPresentationTime(int64_t presentationTimeInNanosecond) noexcept;
 
+    /**
+     * Set the region of the next committed buffer that changed since the previous one. The
+     * compositor may then only update that region. An empty region means the whole buffer
+     * changed. The region is reset after each commit().
+     *
+     * The default implementation does nothing.
+     *
+     * @param left      left edge of the region in pixels
+     * @param bottom    bottom edge of the region in pixels (origin at the bottom)
+     * @param width     width of the region in pixels
+     * @param height    height of the region in pixels
+     */
+    virtual void setPresentationDamage(int32_t left, int32_t bottom,
+            uint32_t width, uint32_t height) noexcept;
+
     // --------------------------------------------------------------------------------------------
     // Fence support
 
@@ -52,6 +52,35 @@ public:
      */
     ExternalImageHandle UTILS_PUBLIC createExternalImage(EGLImageKHR eglImage) noexcept;
 
+    /**
+     * Describes a Linux DMA-BUF image with up to 3 planes, e.g. a camera or video decoder
+     * frame. See EGL_EXT_image_dma_buf_import.
+     */
+    struct DmaBufImage {
+        struct Plane {
+            int fd = -1;            //!< DMA-BUF file descriptor, not closed by Filament
+            uint32_t offset = 0;    //!< offset in bytes of the plane's first pixel
+            uint32_t pitch = 0;     //!< size in bytes of a row of the plane
+        };
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t fourcc = 0;        //!< DRM format code, e.g. DRM_FORMAT_NV12
+        uint32_t planeCount = 1;
+        Plane planes[3] = {};
+        //! DRM format modifier, DRM_FORMAT_MOD_INVALID if implicit. Requires
+        //! EGL_EXT_image_dma_buf_import_modifiers.
+        uint64_t modifier = (uint64_t(1) << 56u) - 1u;
+    };
+
+    /**
+     * Creates an ExternalImage sampling a Linux DMA-BUF without any copy. The EGLImage is
+     * created here and destroyed with the ExternalImage.
+     *
+     * @return the ExternalImage, or a null handle if EGL_EXT_image_dma_buf_import isn't
+     *         supported or the image couldn't be imported.
+     */
+    ExternalImageHandle UTILS_PUBLIC createExternalImage(DmaBufImage const& image) noexcept;
+
 protected:
     // --------------------------------------------------------------------------------------------
     // Helper for EGL configs and attributes parameters
@@ -117,6 +146,9 @@ protected:
 
     void commit(SwapChain* swapChain) noexcept override;
 
+    void setPresentationDamage(int32_t left, int32_t bottom,
+            uint32_t width, uint32_t height) noexcept override;
+
     bool canCreateFence() noexcept override;
     Fence* createFence() noexcept override;
     void destroyFence(Fence* fence) noexcept override;
@@ -179,10 +211,16 @@ protected:
             bool KHR_gl_colorspace = false;
             bool KHR_no_config_context = false;
             bool KHR_surfaceless_context = false;
+            bool KHR_swap_buffers_with_damage = false;
             bool EXT_protected_content = false;
+            bool EXT_image_dma_buf_import = false;
+            bool EXT_image_dma_buf_import_modifiers = false;
         } egl;
     } ext;
 
+    // damage rectangle of the next eglSwapBuffers(), as {x, y, width, height}; empty if none
+    EGLint mPresentationDamage[4] = {};
+
     struct SwapChainEGL : public Platform::SwapChain {
         EGLSurface sur = EGL_NO_SURFACE;
         Config attribs{};
@@ -195,6 +233,8 @@ protected:
 
     struct ExternalImageEGL : public ExternalImage {
         EGLImageKHR eglImage = EGL_NO_IMAGE;
+        // set when eglImage was created by the platform, which then destroys it
+        EGLDisplay ownerDisplay = EGL_NO_DISPLAY;
     protected:
         ~ExternalImageEGL() override;
     };
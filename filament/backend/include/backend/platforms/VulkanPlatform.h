@@ -195,6 +195,10 @@ public:
      * @param finishedDrawing    Backend passes in a semaphore that the client will signal to
      *                           indicate that the client may render into the image.
      * @return                   Result of present
+     *
+     * A platform that overrides createSwapChain() with its own images, e.g. allocated with
+     * exportable memory, can hand the presented image to another API from here (such as a
+     * hardware video encoder) without reading it back, once `finishedDrawing` is signaled.
      */
     virtual VkResult present(SwapChainPtr handle, uint32_t index, VkSemaphore finishedDrawing);
 
@@ -297,6 +301,17 @@ public:
      */
     VkQueue getProtectedGraphicsQueue() const noexcept;
 
+    /**
+     * @return The family index of the dedicated transfer queue, or 0xFFFFFFFF if the device
+     *         doesn't have a transfer-only queue family (or the context is shared).
+     */
+    uint32_t getTransferQueueFamilyIndex() const noexcept;
+
+    /**
+     * @return The dedicated transfer queue, or VK_NULL_HANDLE if there isn't one.
+     */
+    VkQueue getTransferQueue() const noexcept;
+
     struct ExternalImageMetadata {
         /**
          * The width of the external image
@@ -40,6 +40,27 @@ public:
 
     ~CircularBuffer() noexcept;
 
+    // The memory of a circular buffer: two virtual copies of the same `size` bytes, followed by a
+    // guard page.
+    struct Mapping {
+        void* data = nullptr;
+        size_t size = 0;
+        int ashmemFd = -1;
+    };
+
+    // Maps the memory for a circular buffer of the given size.
+    static Mapping map(size_t size);
+
+    // Frees a mapping returned by map().
+    static void unmap(Mapping const& mapping) noexcept;
+
+    // Moves the buffer to the given mapping, which must have the same size, and returns the
+    // previous one. The buffer must be empty. Ranges returned by getBuffer() stay in the previous
+    // mapping, which the caller must unmap() once they're no longer in use.
+    Mapping exchange(Mapping const& mapping) noexcept;
+
+    Mapping const& getMapping() const noexcept { return mMapping; }
+
     static size_t getBlockSize() noexcept { return sPageSize; }
 
     // Total size of circular buffer. This is a constant.
@@ -72,12 +93,8 @@ public:
     Range getBuffer() noexcept;
 
 private:
-    void* alloc(size_t size) noexcept;
-    void dealloc() noexcept;
-
-    // pointer to the beginning of the circular buffer (constant)
-    void* mData = nullptr;
-    int mAshmemFd = -1;
+    // memory of the circular buffer
+    Mapping mMapping;
 
     // size of the circular buffer (constant)
     size_t const mSize;
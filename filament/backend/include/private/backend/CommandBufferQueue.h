@@ -21,7 +21,10 @@
 
 #include <utils/Condition.h>
 #include <utils/Mutex.h>
+#include <utils/SpscQueue.h>
 
+#include <atomic>
+#include <memory>
 #include <vector>
 
 #include <stddef.h>
@@ -30,30 +33,77 @@
 namespace filament::backend {
 
 /*
- * A producer-consumer command queue that uses a CircularBuffer as main storage
+ * A producer-consumer command queue that uses a CircularBuffer as main storage.
+ *
+ * Command buffers are handed from the producer (main thread) to the consumer (driver thread)
+ * through a lock-free single-producer / single-consumer queue, and so is the free space
+ * accounting. A lock is only taken when a thread needs to sleep, or to wake up the other one
+ * if it's sleeping.
  */
 class CommandBufferQueue {
+    // A mapping of the circular buffer's memory and the space available in it. When the consumer
+    // falls behind and the current region runs low, the producer continues in a new region
+    // instead of waiting, and the previous region is recycled once all its commands have been
+    // executed.
+    struct Region {
+        CircularBuffer::Mapping mapping;
+        std::atomic<size_t> freeSpace;
+    };
+
     struct Range {
         void* begin;
         void* end;
+        Region* region;
     };
 
+    // maximum number of flushed command buffers not yet picked up by the consumer
+    static constexpr size_t MAX_PENDING_COMMAND_BUFFERS = 256;
+
+    // maximum number of regions still in use by the consumer, besides the current one
+    static constexpr size_t MAX_RETIRED_REGIONS = 3;
+
+    // flushes after which an unused spare region is unmapped
+    static constexpr uint32_t SPARE_REGION_LIFETIME = 600;
+
     const size_t mRequiredSize;
 
     CircularBuffer mCircularBuffer;
 
-    // space available in the circular buffer
+    mutable utils::SpscQueue<Range, MAX_PENDING_COMMAND_BUFFERS> mCommandBuffersToExecute;
+
+    // The region the circular buffer currently uses, the ones that still hold commands not yet
+    // executed, and a free one kept around to avoid remapping memory on every spike. Only the
+    // producer changes these, the consumer only updates the free space of regions.
+    std::unique_ptr<Region> mCurrentRegion;
+    std::vector<std::unique_ptr<Region>> mRetiredRegions;
+    std::unique_ptr<Region> mSpareRegion;
+    uint32_t mFlushesSinceSpareUsed = 0;
 
+    // only used to put a thread to sleep and wake it up, see wait() and wake()
     mutable utils::Mutex mLock;
     mutable utils::Condition mCondition;
-    mutable std::vector<Range> mCommandBuffersToExecute;
-    size_t mFreeSpace = 0;
+    mutable std::atomic<uint32_t> mSleepers{ 0 };
+    uint32_t mSpinCount = 0;
+
     size_t mHighWatermark = 0;
-    uint32_t mExitRequested = 0;
-    bool mPaused = false;
+    std::atomic<uint32_t> mExitRequested{ 0 };
+    std::atomic<bool> mPaused;
 
     static constexpr uint32_t EXIT_REQUESTED = 0x31415926;
 
+    // waits for predicate() to become true, polling it up to mSpinCount times before sleeping
+    template<typename Predicate>
+    void wait(Predicate&& predicate) const;
+
+    // wakes up the other thread if it's sleeping in wait()
+    void wake() const noexcept;
+
+    // moves the circular buffer to a free region, the current one is retired
+    void switchRegion();
+
+    // recycles the retired regions that no longer hold any commands
+    void reclaimRegions() noexcept;
+
 public:
     // requiredSize: guaranteed available space after flush()
     CommandBufferQueue(size_t requiredSize, size_t bufferSize, bool paused);
@@ -66,6 +116,12 @@ public:
 
     size_t getHighWatermark() const noexcept { return mHighWatermark; }
 
+    // Number of times a thread polls the queue before going to sleep when it has to wait for
+    // the other one. Spinning avoids a sleep/wake-up round trip when the wait is short, at the
+    // cost of burning some cpu time. The default, 0, sleeps right away.
+    // This must be set before the queue is used.
+    void setSpinCount(uint32_t count) noexcept { mSpinCount = count; }
+
     // wait for commands to be available and returns an array containing these commands
     std::vector<Range> waitForCommands() const;
 
@@ -74,8 +130,9 @@ public:
     // waitForCommands()
     void releaseBuffer(Range const& buffer);
 
-    // all commands buffers (Slices) written to this point are returned by waitForCommand(). This
-    // call blocks until the CircularBuffer has at least mRequiredSize bytes available.
+    // all commands buffers (Slices) written to this point are returned by waitForCommand(). After
+    // this call, the CircularBuffer has at least mRequiredSize bytes available: it moves to a
+    // new region if needed, and only blocks once too many regions are in use.
     void flush() noexcept;
 
     // returns from waitForCommands() immediately.
@@ -36,6 +36,12 @@
 #include <utils/debug.h>
 #include <utils/ThreadUtils.h>
 
+#if FILAMENT_ENABLE_COMMAND_PROFILING
+#include <utils/Mutex.h>
+#include <tsl/robin_map.h>
+#include <vector>
+#endif
+
 #include <cstddef>
 #include <functional>
 #include <tuple>
@@ -53,6 +59,12 @@
 // Set to true to print every command out on log.d. This requires RTTI and DEBUG
 #define DEBUG_COMMAND_STREAM false
 
+// When enabled (with the FILAMENT_ENABLE_COMMAND_PROFILING cmake option), the count and the
+// cumulative execution time of each command type is measured on the driver thread.
+#ifndef FILAMENT_ENABLE_COMMAND_PROFILING
+#define FILAMENT_ENABLE_COMMAND_PROFILING 0
+#endif
+
 namespace filament::backend {
 
 class CommandBase {
@@ -82,6 +94,9 @@ public:
 
     inline ~CommandBase() noexcept = default;
 
+    // identifies the type of this command
+    Execute getExecute() const noexcept { return mExecute; }
+
 private:
     Execute mExecute;
 };
@@ -281,6 +296,18 @@ public:
     inline PodType* allocatePod(
             size_t count = 1, size_t alignment = alignof(PodType)) noexcept;
 
+#if FILAMENT_ENABLE_COMMAND_PROFILING
+    struct CommandProfile {
+        const char* name;       // name of the DriverApi method
+        uint32_t count;         // number of commands executed
+        uint64_t duration;      // cumulative execution time in nanoseconds
+    };
+
+    // Returns the profile of the last frame completed by the driver thread (i.e. up to the last
+    // endFrame command), sorted by decreasing duration. Can be called from any thread.
+    std::vector<CommandProfile> getCommandProfile() const;
+#endif
+
 private:
     inline void* allocateCommand(size_t size) {
         assert_invariant(utils::ThreadUtils::isThisThread(mThreadId));
@@ -299,6 +326,17 @@ private:
 #endif
 
     bool mUsePerformanceCounter = false;
+
+#if FILAMENT_ENABLE_COMMAND_PROFILING
+    void initProfiling() noexcept;
+    void executeProfiled(void* buffer);
+
+    // maps a command's Execute function to its index in mCurrentProfile
+    tsl::robin_map<Dispatcher::Execute, uint32_t> mCommandIndices;
+    std::vector<CommandProfile> mCurrentProfile;        // only accessed by the driver thread
+    mutable utils::Mutex mProfileLock;
+    std::vector<CommandProfile> mLastFrameProfile;      // guarded by mProfileLock
+#endif
 };
 
 void* CommandStream::allocate(size_t size, size_t alignment) noexcept {
@@ -23,6 +23,7 @@
 #include <utils/CString.h>
 #include <utils/Log.h>
 #include <utils/Panic.h>
+#include <utils/StringPool.h>
 #include <utils/compiler.h>
 #include <utils/debug.h>
 #include <utils/ostream.h>
@@ -33,6 +34,7 @@
 #include <cstddef>
 #include <exception>
 #include <mutex>
+#include <thread>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
@@ -58,8 +60,10 @@ private:
     // This is used to associate a tag to a handle. mDebugTags is only written the in the main
     // driver thread, but it can be accessed from any thread, because it's called from handle_cast<>
     // which is used by synchronous calls.
+    // Tags are interned, because many handles share the same tag (e.g. a material's name).
     mutable utils::Mutex mDebugTagLock;
-    tsl::robin_map<HandleBase::HandleId, utils::CString> mDebugTags;
+    tsl::robin_map<HandleBase::HandleId, utils::StringPool::Id> mDebugTags;
+    utils::StringPool mDebugTagStrings;
 };
 
 /*
@@ -246,6 +250,14 @@ public:
         return handle_cast<Dp>(const_cast<Handle<B>&>(handle));
     }
 
+    struct Stats {
+        uint32_t heapAllocations;   // handles allocated on the heap because the arena was full
+        uint32_t heapHandles;       // heap handles currently alive
+        uint32_t arenaLocks;        // number of times the arena lock was taken
+    };
+
+    Stats getStats() const noexcept;
+
     void associateTagToHandle(HandleBase::HandleId id, utils::CString&& tag) noexcept {
         // TODO: for now, only pool handles check for use-after-free, so we only keep tags for
         // those
@@ -271,6 +283,14 @@ private:
         return P2;
     }
 
+    template<size_t SIZE>
+    static constexpr size_t getPoolIndex() noexcept {
+        if constexpr (SIZE == P0) { return 0; }
+        if constexpr (SIZE == P1) { return 1; }
+        static_assert(SIZE == P0 || SIZE == P1 || SIZE == P2);
+        return 2;
+    }
+
     class Allocator {
         friend class HandleAllocator;
         static constexpr size_t MIN_ALIGNMENT = alignof(std::max_align_t);
@@ -304,8 +324,10 @@ private:
             return p;
         }
 
-        // this is in fact always called with a constexpr size argument
-        inline void free(void* p, size_t size, uint8_t age) noexcept {
+        // Checks for double-free and ages the node, so that stale handles to it can be detected.
+        // This must be called once when a handle is freed, before the node is returned to a pool
+        // or a thread cache. This doesn't touch the pools and doesn't need the arena lock.
+        inline void retire(void* p, size_t size, uint8_t age) noexcept {
             assert_invariant(p >= mArea.begin() && (char*)p + size <= (char*)mArea.end());
 
             // check for double-free
@@ -316,25 +338,66 @@ private:
                         "double-free of Handle of size " << size << " at " << p;
             }
             expectedAge = (expectedAge + 1) & 0xF; // fixme
+        }
 
+        // this is in fact always called with a constexpr size argument
+        inline void free(void* p, size_t size) noexcept {
             if (size <= mPool0.getSize()) { mPool0.free(p); return; }
             if (size <= mPool1.getSize()) { mPool1.free(p); return; }
             if (size <= mPool2.getSize()) { mPool2.free(p); return; }
         }
     };
 
-// FIXME: We should be using a Spinlock here, at least on platforms where mutexes are not
-//        efficient (i.e. non-Linux). However, we've seen some hangs on that spinlock, which
-//        we don't understand well (b/308029108).
+    // The arena is synchronized by mArenaLock rather than by its own locking policy, so that
+    // thread caches can be refilled or drained with a single lock.
 #ifndef NDEBUG
     using HandleArena = utils::Arena<Allocator,
-            utils::LockingPolicy::Mutex,
+            utils::LockingPolicy::NoLock,
             utils::TrackingPolicy::DebugAndHighWatermark>;
 #else
     using HandleArena = utils::Arena<Allocator,
-            utils::LockingPolicy::Mutex>;
+            utils::LockingPolicy::NoLock>;
 #endif
 
+    // Handles are typically allocated on one thread and freed on another (e.g. created by the
+    // engine, destroyed by the driver thread). Each thread using the allocator gets a small cache
+    // of free nodes per pool, which is refilled from and returned to the arena in batches. Threads
+    // get a cache the first time they use the allocator and keep it, once all caches are taken,
+    // other threads go straight to the arena.
+    static constexpr size_t MAX_THREAD_CACHES = 4;
+    static constexpr uint32_t THREAD_CACHE_CAPACITY = 32;
+    static constexpr uint32_t THREAD_CACHE_BATCH = THREAD_CACHE_CAPACITY / 2;
+
+    struct ThreadCache {
+        struct Bucket {
+            uint32_t count = 0;
+            void* items[THREAD_CACHE_CAPACITY];
+        };
+        std::atomic<std::thread::id> owner{};
+        Bucket buckets[3];
+    };
+
+    ThreadCache* getThreadCache() noexcept {
+        std::thread::id const self = std::this_thread::get_id();
+        for (auto& cache : mThreadCaches) {
+            std::thread::id owner = cache.owner.load(std::memory_order_relaxed);
+            if (owner == self) {
+                return &cache;
+            }
+            if (owner == std::thread::id{} &&
+                    cache.owner.compare_exchange_strong(owner, self, std::memory_order_relaxed)) {
+                return &cache;
+            }
+        }
+        return nullptr;
+    }
+
+    // moves up to THREAD_CACHE_BATCH nodes from the arena to the bucket
+    void refill(typename ThreadCache::Bucket& bucket, size_t size) noexcept;
+
+    // moves THREAD_CACHE_BATCH nodes from the bucket back to the arena
+    void drain(typename ThreadCache::Bucket& bucket, size_t size) noexcept;
+
     // allocateHandle()/deallocateHandle() selects the pool to use at compile-time based on the
     // allocation size this is always inlined, because all these do is to call
     // allocateHandleInPool()/deallocateHandleFromPool() with the right pool size.
@@ -356,9 +419,25 @@ private:
     template<size_t SIZE>
     UTILS_NOINLINE
     HandleBase::HandleId allocateHandleInPool() noexcept {
-        uint8_t age;
-        void* p = mHandleArena.alloc(SIZE, alignof(std::max_align_t), 0, &age);
+        void* p = nullptr;
+        if (ThreadCache* const cache = getThreadCache(); UTILS_LIKELY(cache)) {
+            auto& bucket = cache->buckets[getPoolIndex<SIZE>()];
+            if (UTILS_UNLIKELY(!bucket.count)) {
+                refill(bucket, SIZE);
+            }
+            if (UTILS_LIKELY(bucket.count)) {
+                p = bucket.items[--bucket.count];
+            }
+        } else {
+            std::lock_guard const lock(mArenaLock);
+            mArenaLockCount++;
+            uint8_t age;
+            p = mHandleArena.alloc(SIZE, alignof(std::max_align_t), 0, &age);
+        }
         if (UTILS_LIKELY(p)) {
+            // we are guaranteed to have at least sizeof<Node> bytes of extra storage before
+            // the allocation address.
+            uint8_t const age = static_cast<typename Allocator::Node const*>(p)[-1].age;
             uint32_t const tag = (uint32_t(age) << HANDLE_AGE_SHIFT) & HANDLE_AGE_MASK;
             return arenaPointerToHandle(p, tag);
         }
@@ -371,7 +450,18 @@ private:
         if (UTILS_LIKELY(isPoolHandle(id))) {
             auto [p, tag] = handleToPointer(id);
             uint8_t const age = (tag & HANDLE_AGE_MASK) >> HANDLE_AGE_SHIFT;
-            mHandleArena.free(p, SIZE, age);
+            mHandleArena.getAllocator().retire(p, SIZE, age);
+            if (ThreadCache* const cache = getThreadCache(); UTILS_LIKELY(cache)) {
+                auto& bucket = cache->buckets[getPoolIndex<SIZE>()];
+                if (UTILS_UNLIKELY(bucket.count == THREAD_CACHE_CAPACITY)) {
+                    drain(bucket, SIZE);
+                }
+                bucket.items[bucket.count++] = p;
+            } else {
+                std::lock_guard const lock(mArenaLock);
+                mArenaLockCount++;
+                mHandleArena.free(p, SIZE);
+            }
         } else {
             deallocateHandleSlow(id, SIZE);
         }
@@ -431,10 +521,18 @@ private:
 
     HandleArena mHandleArena;
 
+    // FIXME: We should be using a Spinlock here, at least on platforms where mutexes are not
+    //        efficient (i.e. non-Linux). However, we've seen some hangs on that spinlock, which
+    //        we don't understand well (b/308029108).
+    mutable utils::Mutex mArenaLock;
+    uint32_t mArenaLockCount = 0;   // guarded by mArenaLock
+    ThreadCache mThreadCaches[MAX_THREAD_CACHES];
+
     // Below is only used when running out of space in the HandleArena
     mutable utils::Mutex mLock;
     tsl::robin_map<HandleBase::HandleId, void*> mOverflowMap;
     std::atomic<HandleBase::HandleId> mId = 0;
+    std::atomic<uint32_t> mHeapAllocationCount = 0;
 
     // constants
     const bool mUseAfterFreeCheckDisabled;
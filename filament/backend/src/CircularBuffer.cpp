@@ -45,14 +45,23 @@ namespace filament::backend {
 size_t CircularBuffer::sPageSize = arch::getPageSize();
 
 CircularBuffer::CircularBuffer(size_t size)
-    : mSize(size) {
-    mData = alloc(size);
-    mTail = mData;
-    mHead = mData;
+    : mMapping(map(size)), mSize(size) {
+    mTail = mMapping.data;
+    mHead = mMapping.data;
 }
 
 CircularBuffer::~CircularBuffer() noexcept {
-    dealloc();
+    unmap(mMapping);
+}
+
+CircularBuffer::Mapping CircularBuffer::exchange(Mapping const& mapping) noexcept {
+    assert_invariant(empty());
+    assert_invariant(mapping.size == mSize);
+    Mapping const previous = mMapping;
+    mMapping = mapping;
+    mTail = mMapping.data;
+    mHead = mMapping.data;
+    return previous;
 }
 
 // If the system support mmap(), use it for creating a "hard circular buffer" where two virtual
@@ -65,7 +74,8 @@ CircularBuffer::~CircularBuffer() noexcept {
 // to each others and a special case in circularize()
 
 UTILS_NOINLINE
-void* CircularBuffer::alloc(size_t size) noexcept {
+CircularBuffer::Mapping CircularBuffer::map(size_t size) {
+    Mapping mapping{ .size = size };
 #if HAS_MMAP
     void* data = nullptr;
     void* vaddr = MAP_FAILED;
@@ -94,7 +104,7 @@ void* CircularBuffer::alloc(size_t size) noexcept {
                             MAP_PRIVATE, fd, (off_t)size);
                     if (vaddr_guard != MAP_FAILED && (vaddr_guard == (char*)vaddr_shadow + size)) {
                         // woo-hoo success!
-                        mAshmemFd = fd;
+                        mapping.ashmemFd = fd;
                         data = vaddr;
                     }
                 }
@@ -102,7 +112,7 @@ void* CircularBuffer::alloc(size_t size) noexcept {
         }
     }
 
-    if (UTILS_UNLIKELY(mAshmemFd < 0)) {
+    if (UTILS_UNLIKELY(mapping.ashmemFd < 0)) {
         // ashmem failed
         if (vaddr_guard != MAP_FAILED) {
             munmap(vaddr_guard, BLOCK_SIZE);
@@ -133,39 +143,38 @@ void* CircularBuffer::alloc(size_t size) noexcept {
         void* guard = (void*)(uintptr_t(data) + size * 2);
         mprotect(guard, BLOCK_SIZE, PROT_NONE);
     }
-    return data;
+    mapping.data = data;
 #else
-    return ::malloc(2 * size);
+    mapping.data = ::malloc(2 * size);
 #endif
+    return mapping;
 }
 
 UTILS_NOINLINE
-void CircularBuffer::dealloc() noexcept {
+void CircularBuffer::unmap(Mapping const& mapping) noexcept {
 #if HAS_MMAP
-    if (mData) {
+    if (mapping.data) {
         size_t const BLOCK_SIZE = getBlockSize();
-        munmap(mData, mSize * 2 + BLOCK_SIZE);
-        if (mAshmemFd >= 0) {
-            close(mAshmemFd);
-            mAshmemFd = -1;
+        munmap(mapping.data, mapping.size * 2 + BLOCK_SIZE);
+        if (mapping.ashmemFd >= 0) {
+            close(mapping.ashmemFd);
         }
     }
 #else
-    ::free(mData);
+    ::free(mapping.data);
 #endif
-    mData = nullptr;
 }
 
 
 CircularBuffer::Range CircularBuffer::getBuffer() noexcept {
     Range const range{ .tail = mTail, .head = mHead };
 
-    char* const pData = static_cast<char*>(mData);
+    char* const pData = static_cast<char*>(mMapping.data);
     char const* const pEnd = pData + mSize;
     char const* const pHead = static_cast<char const*>(mHead);
     if (UTILS_UNLIKELY(pHead >= pEnd)) {
         size_t const overflow = pHead - pEnd;
-        if (UTILS_LIKELY(mAshmemFd > 0)) {
+        if (UTILS_LIKELY(mMapping.ashmemFd > 0)) {
             assert_invariant(overflow <= mSize);
             mHead = static_cast<void*>(pData + overflow);
             // Data         Tail  End   Head              [virtual]
@@ -182,7 +191,7 @@ CircularBuffer::Range CircularBuffer::getBuffer() noexcept {
             //  +-----|------------+-----|--------------+
             //        |<---------------->|
             //           sliding window
-            mHead = mData;
+            mHead = mMapping.data;
         }
     }
     mTail = mHead;
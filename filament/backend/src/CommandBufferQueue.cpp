@@ -42,41 +42,107 @@ namespace filament::backend {
 CommandBufferQueue::CommandBufferQueue(size_t requiredSize, size_t bufferSize, bool paused)
         : mRequiredSize((requiredSize + (CircularBuffer::getBlockSize() - 1u)) & ~(CircularBuffer::getBlockSize() -1u)),
           mCircularBuffer(bufferSize),
-          mFreeSpace(mCircularBuffer.size()),
+          mCurrentRegion(new Region{ mCircularBuffer.getMapping(), mCircularBuffer.size() }),
           mPaused(paused) {
     assert_invariant(mCircularBuffer.size() > requiredSize);
 }
 
 CommandBufferQueue::~CommandBufferQueue() {
     assert_invariant(mCommandBuffersToExecute.empty());
+    // the current region's mapping is owned by the circular buffer
+    for (auto const& region : mRetiredRegions) {
+        CircularBuffer::unmap(region->mapping);
+    }
+    if (mSpareRegion) {
+        CircularBuffer::unmap(mSpareRegion->mapping);
+    }
+}
+
+template<typename Predicate>
+void CommandBufferQueue::wait(Predicate&& predicate) const {
+    for (uint32_t i = 0, n = mSpinCount; i < n; i++) {
+        if (predicate()) {
+            return;
+        }
+        UTILS_PAUSE();
+    }
+
+    std::unique_lock<utils::Mutex> lock(mLock);
+    mSleepers.fetch_add(1, std::memory_order_relaxed);
+    // pairs with the fence in wake(): either we see the new state, or wake() sees the sleeper
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    mCondition.wait(lock, std::forward<Predicate>(predicate));
+    mSleepers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void CommandBufferQueue::wake() const noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (UTILS_UNLIKELY(mSleepers.load(std::memory_order_relaxed))) {
+        // taking the lock guarantees the sleeper is either waiting already, or will see the
+        // new state when it evaluates its predicate.
+        std::lock_guard<utils::Mutex> const lock(mLock);
+        mCondition.notify_all();
+    }
 }
 
 void CommandBufferQueue::requestExit() {
-    std::lock_guard<utils::Mutex> const lock(mLock);
-    mExitRequested = EXIT_REQUESTED;
-    mCondition.notify_one();
+    mExitRequested.store(EXIT_REQUESTED, std::memory_order_release);
+    wake();
 }
 
 bool CommandBufferQueue::isPaused() const noexcept {
-    std::lock_guard<utils::Mutex> const lock(mLock);
-    return mPaused;
+    return mPaused.load(std::memory_order_acquire);
 }
 
 void CommandBufferQueue::setPaused(bool paused) {
-    std::lock_guard<utils::Mutex> const lock(mLock);
-    if (paused) {
-        mPaused = true;
-    } else {
-        mPaused = false;
-        mCondition.notify_one();
+    mPaused.store(paused, std::memory_order_release);
+    if (!paused) {
+        wake();
     }
 }
 
 bool CommandBufferQueue::isExitRequested() const {
-    std::lock_guard<utils::Mutex> const lock(mLock);
-    return (bool)mExitRequested;
+    return (bool)mExitRequested.load(std::memory_order_acquire);
+}
+
+
+void CommandBufferQueue::switchRegion() {
+    SYSTRACE_CALL();
+
+    std::unique_ptr<Region> region = std::move(mSpareRegion);
+    if (!region) {
+        size_t const size = mCircularBuffer.size();
+        region.reset(new Region{ CircularBuffer::map(size), size });
+    }
+    mFlushesSinceSpareUsed = 0;
+
+    mCircularBuffer.exchange(region->mapping);
+    mRetiredRegions.push_back(std::move(mCurrentRegion));
+    mCurrentRegion = std::move(region);
 }
 
+void CommandBufferQueue::reclaimRegions() noexcept {
+    size_t const size = mCircularBuffer.size();
+    for (auto it = mRetiredRegions.begin(); it != mRetiredRegions.end();) {
+        // all the space is free once the consumer has released all the region's buffers
+        if ((*it)->freeSpace.load(std::memory_order_acquire) == size) {
+            if (!mSpareRegion) {
+                mSpareRegion = std::move(*it);
+            } else {
+                CircularBuffer::unmap((*it)->mapping);
+            }
+            it = mRetiredRegions.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // shrink back once the spike is over
+    if (mSpareRegion && ++mFlushesSinceSpareUsed > SPARE_REGION_LIFETIME) {
+        CircularBuffer::unmap(mSpareRegion->mapping);
+        mSpareRegion.reset();
+    }
+}
 
 void CommandBufferQueue::flush() noexcept {
     SYSTRACE_CALL();
@@ -101,27 +167,55 @@ void CommandBufferQueue::flush() noexcept {
     size_t const used = std::distance(
             static_cast<char const*>(begin), static_cast<char const*>(end));
 
+    Region& region = *mCurrentRegion;
 
-    std::unique_lock<utils::Mutex> lock(mLock);
+    // the consumer can only increase the free space, so this check can't be invalidated
+    size_t const freeSpace = region.freeSpace.load(std::memory_order_acquire);
 
     // circular buffer is too small, we corrupted the stream
-    FILAMENT_CHECK_POSTCONDITION(used <= mFreeSpace) <<
+    FILAMENT_CHECK_POSTCONDITION(used <= freeSpace) <<
             "Backend CommandStream overflow. Commands are corrupted and unrecoverable.\n"
             "Please increase minCommandBufferSizeMB inside the Config passed to Engine::create.\n"
             "Space used at this time: " << used <<
-            " bytes, overflow: " << used - mFreeSpace << " bytes";
+            " bytes, overflow: " << used - freeSpace << " bytes";
+
+    region.freeSpace.fetch_sub(used, std::memory_order_relaxed);
+
+    SYSTRACE_CONTEXT();
+    SYSTRACE_VALUE32("CommandBufferQueue::used", used);
+    SYSTRACE_VALUE32("CommandBufferQueue::free", freeSpace - used);
+    // links this flush to the execution of the buffer on the driver thread
+    SYSTRACE_FLOW_BEGIN("CommandBuffer", uintptr_t(begin));
 
-    mFreeSpace -= used;
-    mCommandBuffersToExecute.push_back({ begin, end });
-    mCondition.notify_one();
+    if (UTILS_UNLIKELY(!mCommandBuffersToExecute.push({ begin, end, &region }))) {
+        // too many command buffers are pending, wait for the consumer to pick them up
+        SYSTRACE_NAME("waiting: CommandBufferQueue::flush()");
+        FILAMENT_CHECK_POSTCONDITION(!isPaused()) <<
+                "CommandStream is full, but since the rendering thread is paused, "
+                "the buffer cannot flush and we will deadlock. Instead, abort.";
+        wait([this]() { return !mCommandBuffersToExecute.full(); });
+        UTILS_UNUSED_IN_RELEASE bool const success =
+                mCommandBuffersToExecute.push({ begin, end, &region });
+        assert_invariant(success);
+    }
+    wake();
+
+    reclaimRegions();
 
-    // wait until there is enough space in the buffer
-    if (UTILS_UNLIKELY(mFreeSpace < requiredSize)) {
+    if (UTILS_UNLIKELY(region.freeSpace.load(std::memory_order_acquire) < requiredSize)) {
+        // Rather than waiting for the consumer to catch up, continue in another region. The
+        // spare region, if any, is used first.
+        if (mRetiredRegions.size() < MAX_RETIRED_REGIONS) {
+            switchRegion();
+            return;
+        }
 
+        // too many regions are in use, wait until there is enough space in the buffer
 #ifndef NDEBUG
-        size_t const totalUsed = circularBuffer.size() - mFreeSpace;
+        size_t const currentFreeSpace = region.freeSpace.load(std::memory_order_relaxed);
+        size_t const totalUsed = circularBuffer.size() - currentFreeSpace;
         slog.d << "CommandStream used too much space (will block): "
-                << "needed space " << requiredSize << " out of " << mFreeSpace
+                << "needed space " << requiredSize << " out of " << currentFreeSpace
                 << ", totalUsed=" << totalUsed << ", current=" << used
                 << ", queue size=" << mCommandBuffersToExecute.size() << " buffers"
                 << io::endl;
@@ -131,34 +225,41 @@ void CommandBufferQueue::flush() noexcept {
 
         SYSTRACE_NAME("waiting: CircularBuffer::flush()");
 
-        FILAMENT_CHECK_POSTCONDITION(!mPaused) <<
+        FILAMENT_CHECK_POSTCONDITION(!isPaused()) <<
                 "CommandStream is full, but since the rendering thread is paused, "
                 "the buffer cannot flush and we will deadlock. Instead, abort.";
 
-        mCondition.wait(lock, [this, requiredSize]() -> bool {
+        wait([&region, requiredSize]() -> bool {
             // TODO: on macOS, we need to call pumpEvents from time to time
-            return mFreeSpace >= requiredSize;
+            return region.freeSpace.load(std::memory_order_acquire) >= requiredSize;
         });
     }
 }
 
 std::vector<CommandBufferQueue::Range> CommandBufferQueue::waitForCommands() const {
-    if (!UTILS_HAS_THREADING) {
-        return std::move(mCommandBuffersToExecute);
+    if (UTILS_HAS_DRIVER_THREAD) {
+        wait([this]() {
+            return (!mCommandBuffersToExecute.empty() && !isPaused()) || isExitRequested();
+        });
     }
-    std::unique_lock<utils::Mutex> lock(mLock);
-    while ((mCommandBuffersToExecute.empty() || mPaused) && !mExitRequested) {
-        mCondition.wait(lock);
+
+    std::vector<Range> buffers;
+    buffers.reserve(mCommandBuffersToExecute.size());
+    Range range;
+    while (mCommandBuffersToExecute.pop(range)) {
+        buffers.push_back(range);
     }
-    return std::move(mCommandBuffersToExecute);
+
+    // the producer might be waiting for room in the queue
+    wake();
+    return buffers;
 }
 
 void CommandBufferQueue::releaseBuffer(CommandBufferQueue::Range const& buffer) {
     size_t const used = std::distance(
             static_cast<char const*>(buffer.begin), static_cast<char const*>(buffer.end));
-    std::lock_guard<utils::Mutex> const lock(mLock);
-    mFreeSpace += used;
-    mCondition.notify_one();
+    buffer.region->freeSpace.fetch_add(used, std::memory_order_release);
+    wake();
 }
 
 } // namespace filament::backend
@@ -26,8 +26,11 @@
 #include <utils/Profiler.h>
 #include <utils/Systrace.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <functional>
+#include <mutex>
 #include <string>
 #include <utility>
 
@@ -76,12 +79,21 @@ CommandStream::CommandStream(Driver& driver, CircularBuffer& buffer) noexcept
     __system_property_get("debug.filament.perfcounters", property);
     mUsePerformanceCounter = bool(atoi(property));
 #endif
+#if FILAMENT_ENABLE_COMMAND_PROFILING
+    initProfiling();
+#endif
 }
 
 void CommandStream::execute(void* buffer) {
     // NOTE: we can't use SYSTRACE_CALL() or similar here because, execute() below, also
     // uses systrace BEGIN/END and the END is not guaranteed to be happening in this scope.
 
+    {
+        // this binds to the next slice, i.e. the first command executed from this buffer
+        SYSTRACE_CONTEXT();
+        SYSTRACE_FLOW_END("CommandBuffer", uintptr_t(buffer));
+    }
+
     Profiler profiler;
 
     if (SYSTRACE_TAG) {
@@ -92,6 +104,11 @@ void CommandStream::execute(void* buffer) {
         }
     }
 
+#if FILAMENT_ENABLE_COMMAND_PROFILING
+    mDriver.execute([this, buffer]() {
+        executeProfiled(buffer);
+    });
+#else
     mDriver.execute([this, buffer]() {
         Driver& UTILS_RESTRICT driver = mDriver;
         CommandBase* UTILS_RESTRICT base = static_cast<CommandBase*>(buffer);
@@ -99,6 +116,7 @@ void CommandStream::execute(void* buffer) {
             base = base->execute(driver);
         }
     });
+#endif
 
     if (SYSTRACE_TAG) {
         if (UTILS_UNLIKELY(mUsePerformanceCounter)) {
@@ -116,6 +134,74 @@ void CommandStream::execute(void* buffer) {
     }
 }
 
+#if FILAMENT_ENABLE_COMMAND_PROFILING
+
+void CommandStream::initProfiling() noexcept {
+    auto add = [this](const char* name, Dispatcher::Execute const execute) {
+        // the first entry collects the commands that are not DriverApi methods, e.g. the
+        // NoopCommand terminating each buffer and queueCommand()
+        if (execute && mCommandIndices.find(execute) == mCommandIndices.end()) {
+            mCommandIndices[execute] = uint32_t(mCurrentProfile.size());
+            mCurrentProfile.push_back({ name, 0, 0 });
+        }
+    };
+    mCurrentProfile.push_back({ "(other)", 0, 0 });
+
+#define DECL_DRIVER_API(methodName, paramsDecl, params)                                         \
+    add(#methodName, mDispatcher.methodName##_);
+#define DECL_DRIVER_API_RETURN(RetType, methodName, paramsDecl, params)                         \
+    add(#methodName, mDispatcher.methodName##_);
+#define DECL_DRIVER_API_SYNCHRONOUS(RetType, methodName, paramsDecl, params)
+#include "private/backend/DriverAPI.inc"
+}
+
+void CommandStream::executeProfiled(void* buffer) {
+    using clock = std::chrono::steady_clock;
+    Driver& UTILS_RESTRICT driver = mDriver;
+    Dispatcher::Execute const endFrame = mDispatcher.endFrame_;
+    CommandBase* UTILS_RESTRICT base = static_cast<CommandBase*>(buffer);
+    while (UTILS_LIKELY(base)) {
+        Dispatcher::Execute const execute = base->getExecute();
+        auto const start = clock::now();
+        base = base->execute(driver);
+        auto const duration = clock::now() - start;
+
+        auto const pos = mCommandIndices.find(execute);
+        CommandProfile& profile =
+                mCurrentProfile[pos == mCommandIndices.end() ? 0 : pos->second];
+        profile.count++;
+        profile.duration += uint64_t(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+
+        if (UTILS_UNLIKELY(execute == endFrame)) {
+            // publish this frame's profile and start a new one
+            std::lock_guard const lock(mProfileLock);
+            mLastFrameProfile = mCurrentProfile;
+            for (auto& p : mCurrentProfile) {
+                p.count = 0;
+                p.duration = 0;
+            }
+        }
+    }
+}
+
+std::vector<CommandStream::CommandProfile> CommandStream::getCommandProfile() const {
+    std::vector<CommandProfile> result;
+    {
+        std::lock_guard const lock(mProfileLock);
+        result = mLastFrameProfile;
+    }
+    result.erase(std::remove_if(result.begin(), result.end(),
+            [](CommandProfile const& p) { return p.count == 0; }), result.end());
+    std::sort(result.begin(), result.end(),
+            [](CommandProfile const& lhs, CommandProfile const& rhs) {
+                return lhs.duration > rhs.duration;
+            });
+    return result;
+}
+
+#endif // FILAMENT_ENABLE_COMMAND_PROFILING
+
 void CommandStream::queueCommand(std::function<void()> command) {
     new(allocateCommand(CustomCommand::align(sizeof(CustomCommand)))) CustomCommand(std::move(command));
 }
@@ -25,6 +25,7 @@
 #include <backend/BufferDescriptor.h>
 #include <backend/DriverEnums.h>
 #include <backend/CallbackHandler.h>
+#include <backend/PipelineState.h>
 
 #include "private/backend/Dispatcher.h"
 #include "private/backend/Driver.h"
@@ -95,6 +96,12 @@ struct HwRenderPrimitive : public HwBase {
     PrimitiveType type = PrimitiveType::TRIANGLES;
 };
 
+struct HwPipelineState : public HwBase {
+    PipelineState state;
+    HwPipelineState() noexcept = default;
+    explicit HwPipelineState(PipelineState const& state) noexcept : state(state) { }
+};
+
 struct HwProgram : public HwBase {
     utils::CString name;
     explicit HwProgram(utils::CString name) noexcept : name(std::move(name)) { }
@@ -63,6 +63,7 @@ io::ostream& operator<<(io::ostream& out, const Handle<T>& h) noexcept {
 template io::ostream& operator<<(io::ostream& out, const Handle<HwVertexBuffer>& h) noexcept;
 template io::ostream& operator<<(io::ostream& out, const Handle<HwIndexBuffer>& h) noexcept;
 template io::ostream& operator<<(io::ostream& out, const Handle<HwRenderPrimitive>& h) noexcept;
+template io::ostream& operator<<(io::ostream& out, const Handle<HwPipelineState>& h) noexcept;
 template io::ostream& operator<<(io::ostream& out, const Handle<HwProgram>& h) noexcept;
 template io::ostream& operator<<(io::ostream& out, const Handle<HwTexture>& h) noexcept;
 template io::ostream& operator<<(io::ostream& out, const Handle<HwRenderTarget>& h) noexcept;
@@ -116,8 +116,56 @@ void* HandleAllocator<P0, P1, P2>::handleToPointerSlow(HandleBase::HandleId id)
     return nullptr;
 }
 
+template <size_t P0, size_t P1, size_t P2>
+UTILS_NOINLINE
+void HandleAllocator<P0, P1, P2>::refill(typename ThreadCache::Bucket& bucket,
+        size_t size) noexcept {
+    std::lock_guard const lock(mArenaLock);
+    mArenaLockCount++;
+    while (bucket.count < THREAD_CACHE_BATCH) {
+        uint8_t age;
+        void* const p = mHandleArena.alloc(size, alignof(std::max_align_t), 0, &age);
+        if (!p) {
+            break;
+        }
+        bucket.items[bucket.count++] = p;
+    }
+}
+
+template <size_t P0, size_t P1, size_t P2>
+UTILS_NOINLINE
+void HandleAllocator<P0, P1, P2>::drain(typename ThreadCache::Bucket& bucket,
+        size_t size) noexcept {
+    assert_invariant(bucket.count >= THREAD_CACHE_BATCH);
+    std::lock_guard const lock(mArenaLock);
+    mArenaLockCount++;
+    // return the oldest nodes, the most recently freed ones are the warmest
+    for (uint32_t i = 0; i < THREAD_CACHE_BATCH; i++) {
+        mHandleArena.free(bucket.items[i], size);
+    }
+    bucket.count -= THREAD_CACHE_BATCH;
+    std::copy_n(bucket.items + THREAD_CACHE_BATCH, bucket.count, bucket.items);
+}
+
+template <size_t P0, size_t P1, size_t P2>
+typename HandleAllocator<P0, P1, P2>::Stats
+HandleAllocator<P0, P1, P2>::getStats() const noexcept {
+    Stats stats{};
+    stats.heapAllocations = mHeapAllocationCount.load(std::memory_order_relaxed);
+    {
+        std::lock_guard const lock(mLock);
+        stats.heapHandles = uint32_t(mOverflowMap.size());
+    }
+    {
+        std::lock_guard const lock(mArenaLock);
+        stats.arenaLocks = mArenaLockCount;
+    }
+    return stats;
+}
+
 template <size_t P0, size_t P1, size_t P2>
 HandleBase::HandleId HandleAllocator<P0, P1, P2>::allocateHandleSlow(size_t size) {
+    mHeapAllocationCount.fetch_add(1, std::memory_order_relaxed);
     void* p = ::malloc(size);
     std::unique_lock lock(mLock);
 
@@ -175,27 +223,23 @@ UTILS_NOINLINE
 CString DebugTag::findHandleTag(HandleBase::HandleId key) const noexcept {
     std::unique_lock const lock(mDebugTagLock);
     if (auto pos = mDebugTags.find(key); pos != mDebugTags.end()) {
-        return pos->second;
+        return { mDebugTagStrings.get(pos->second), mDebugTagStrings.length(pos->second) };
     }
     return "(no tag)";
 }
 
 UTILS_NOINLINE
 void DebugTag::writePoolHandleTag(HandleBase::HandleId key, CString&& tag) noexcept {
-    // This line is the costly part. In the future, we could potentially use a custom
-    // allocator.
     std::unique_lock const lock(mDebugTagLock);
     // Pool based tags will be recycled after a certain age.
-    mDebugTags[key] = std::move(tag);
+    mDebugTags[key] = mDebugTagStrings.intern({ tag.c_str_safe(), tag.size() });
 }
 
 UTILS_NOINLINE
 void DebugTag::writeHeapHandleTag(HandleBase::HandleId key, CString&& tag) noexcept {
-    // This line is the costly part. In the future, we could potentially use a custom
-    // allocator.
     std::unique_lock const lock(mDebugTagLock);
     // FIXME: Heap-based tag will never be recycled, therefore, this can grow indefinitely, once we're in the slow mode.
-    mDebugTags[key] = std::move(tag);
+    mDebugTags[key] = mDebugTagStrings.intern({ tag.c_str_safe(), tag.size() });
 }
 
 // Explicit template instantiations.
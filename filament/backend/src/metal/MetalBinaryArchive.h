@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_DRIVER_METALBINARYARCHIVE_H
+#define TNT_FILAMENT_DRIVER_METALBINARYARCHIVE_H
+
+#import <Metal/Metal.h>
+
+#include <string>
+
+#include <stdint.h>
+
+namespace filament::backend {
+
+class Platform;
+
+// Persists the compiled render pipeline states across launches in a MTLBinaryArchive, which is
+// stored with the Platform's blob cache (see Platform::setBlobFunc).
+//
+// The archive is loaded when the driver is created, and pipeline states found in it aren't
+// recompiled. New pipeline states are added to the archive, which is written back to the blob
+// cache once no new pipeline state was created for a while (see endFrame()), and when the
+// driver terminates.
+//
+// The archive is only accessed from the driver thread. It does nothing before macOS 11 and
+// iOS 14, or if the Platform has no blob cache.
+class MetalBinaryArchive {
+public:
+    MetalBinaryArchive(id<MTLDevice> device, Platform& platform) noexcept;
+    ~MetalBinaryArchive() noexcept;
+
+    MetalBinaryArchive(MetalBinaryArchive const&) = delete;
+    MetalBinaryArchive& operator=(MetalBinaryArchive const&) = delete;
+
+    // Returns the pipeline state for descriptor if it's in the archive, nil otherwise.
+    id<MTLRenderPipelineState> find(id<MTLDevice> device,
+            MTLRenderPipelineDescriptor* descriptor) noexcept;
+
+    // Adds the pipeline state created from descriptor to the archive, after a miss.
+    void add(MTLRenderPipelineDescriptor* descriptor) noexcept;
+
+    // Writes the archive to the blob cache once no pipeline state was added for a few frames,
+    // so that the cost of serializing it is paid once the set of pipelines settles.
+    void endFrame() noexcept;
+
+    // Writes the archive to the blob cache if it has pending changes.
+    void flush() noexcept;
+
+private:
+    // number of frames without new pipeline states after which the archive is written
+    static constexpr uint32_t IDLE_FRAME_COUNT = 60;
+
+    Platform& mPlatform;
+    std::string mKey;
+    API_AVAILABLE(macos(11.0), ios(14.0))
+    id<MTLBinaryArchive> mArchive = nil;
+    uint32_t mIdleFrames = 0;
+    bool mDirty = false;
+};
+
+} // namespace filament::backend
+
+#endif // TNT_FILAMENT_DRIVER_METALBINARYARCHIVE_H
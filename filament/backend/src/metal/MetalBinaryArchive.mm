@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MetalBinaryArchive.h"
+
+#include <backend/Platform.h>
+
+#include <utils/Log.h>
+
+#include <memory>
+
+namespace filament::backend {
+
+namespace {
+
+// MTLBinaryArchive can only be loaded from and serialized to a file.
+NSURL* makeTemporaryURL() {
+    NSString* name = [NSString stringWithFormat:@"filament-%@.metallib",
+            [NSUUID UUID].UUIDString];
+    return [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:name]];
+}
+
+} // anonymous namespace
+
+MetalBinaryArchive::MetalBinaryArchive(id<MTLDevice> device, Platform& platform) noexcept
+        : mPlatform(platform) {
+    if (@available(macOS 11.0, iOS 14.0, *)) {
+        if (!platform.hasBlobFunc()) {
+            return;
+        }
+
+        // The binaries are specific to the GPU and the OS version, the archive is simply
+        // discarded when one of them changes.
+        NSString* os = [NSProcessInfo processInfo].operatingSystemVersionString;
+        mKey = std::string("filament.metal.binaryArchive:")
+                + device.name.UTF8String + ":" + os.UTF8String;
+
+        NSURL* url = nil;
+        if (platform.hasRetrieveBlobFunc()) {
+            uint8_t dummy;
+            size_t const size = platform.retrieveBlob(mKey.data(), mKey.size(), &dummy, 0);
+            if (size > 0) {
+                std::unique_ptr<uint8_t[]> blob{ new uint8_t[size] };
+                if (platform.retrieveBlob(mKey.data(), mKey.size(), blob.get(), size) == size) {
+                    url = makeTemporaryURL();
+                    NSData* data = [NSData dataWithBytesNoCopy:blob.get()
+                                                        length:size
+                                                  freeWhenDone:NO];
+                    if (![data writeToURL:url atomically:NO]) {
+                        url = nil;
+                    }
+                }
+            }
+        }
+
+        MTLBinaryArchiveDescriptor* descriptor = [MTLBinaryArchiveDescriptor new];
+        descriptor.url = url;
+        NSError* error = nil;
+        mArchive = [device newBinaryArchiveWithDescriptor:descriptor error:&error];
+        if (url) {
+            // the archive's contents are loaded at creation, the file isn't needed anymore
+            [[NSFileManager defaultManager] removeItemAtURL:url error:nil];
+            if (!mArchive) {
+                // the archive is invalid or incompatible, start over with an empty one
+                utils::slog.w << "Could not load the Metal binary archive: "
+                              << error.localizedDescription.UTF8String << utils::io::endl;
+                descriptor.url = nil;
+                mArchive = [device newBinaryArchiveWithDescriptor:descriptor error:&error];
+            }
+        }
+        if (!mArchive) {
+            utils::slog.w << "Could not create the Metal binary archive: "
+                          << error.localizedDescription.UTF8String << utils::io::endl;
+        }
+    }
+}
+
+MetalBinaryArchive::~MetalBinaryArchive() noexcept = default;
+
+id<MTLRenderPipelineState> MetalBinaryArchive::find(id<MTLDevice> device,
+        MTLRenderPipelineDescriptor* descriptor) noexcept {
+    if (@available(macOS 11.0, iOS 14.0, *)) {
+        if (!mArchive) {
+            return nil;
+        }
+        // Fail instead of compiling the pipeline state, so we know whether to add it.
+        descriptor.binaryArchives = @[ mArchive ];
+        NSError* error = nil;
+        return [device newRenderPipelineStateWithDescriptor:descriptor
+                                                    options:MTLPipelineOptionFailOnBinaryArchiveMiss
+                                                 reflection:nil
+                                                      error:&error];
+    }
+    return nil;
+}
+
+void MetalBinaryArchive::add(MTLRenderPipelineDescriptor* descriptor) noexcept {
+    if (@available(macOS 11.0, iOS 14.0, *)) {
+        if (!mArchive || !mPlatform.hasInsertBlobFunc()) {
+            return;
+        }
+        NSError* error = nil;
+        if ([mArchive addRenderPipelineFunctionsWithDescriptor:descriptor error:&error]) {
+            mDirty = true;
+            mIdleFrames = 0;
+        }
+    }
+}
+
+void MetalBinaryArchive::endFrame() noexcept {
+    if (mDirty && ++mIdleFrames >= IDLE_FRAME_COUNT) {
+        flush();
+    }
+}
+
+void MetalBinaryArchive::flush() noexcept {
+    if (@available(macOS 11.0, iOS 14.0, *)) {
+        if (!mDirty) {
+            return;
+        }
+        mDirty = false;
+        mIdleFrames = 0;
+
+        NSURL* url = makeTemporaryURL();
+        NSError* error = nil;
+        if (![mArchive serializeToURL:url error:&error]) {
+            utils::slog.w << "Could not serialize the Metal binary archive: "
+                          << error.localizedDescription.UTF8String << utils::io::endl;
+            return;
+        }
+        NSData* data = [NSData dataWithContentsOfURL:url];
+        [[NSFileManager defaultManager] removeItemAtURL:url error:nil];
+        if (data.length) {
+            mPlatform.insertBlob(mKey.data(), mKey.size(), data.bytes, data.length);
+        }
+    }
+}
+
+} // namespace filament::backend
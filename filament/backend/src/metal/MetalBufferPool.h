@@ -21,49 +21,80 @@
 
 #include "MetalBuffer.h"
 
-#include <map>
-#include <mutex>
-#include <unordered_set>
+#include <array>
+#include <atomic>
+#include <utility>
+
+#include <stddef.h>
+#include <stdint.h>
 
 namespace filament {
 namespace backend {
 
 struct MetalContext;
 
-// Immutable POD representing a shared CPU-GPU buffer.
+// A shared CPU-GPU buffer. Only its reference count and access time change once it's created.
 struct MetalBufferPoolEntry {
     TrackedMetalBuffer buffer;
     size_t capacity;
+    uint32_t sizeClass;     // MetalBufferPool::UNPOOLED for buffers that are never recycled
     mutable uint64_t lastAccessed;
-    mutable uint32_t referenceCount;
+    mutable std::atomic<uint32_t> referenceCount;
 };
 
+class MetalBufferPool;
+
+// Sub-allocates small uploads from a ring of pooled buffers. A buffer goes back to the pool once
+// the command buffer that last used it has completed, so the steady state doesn't create buffers.
 class MetalBumpAllocator {
 public:
-    MetalBumpAllocator(id<MTLDevice> device, size_t capacity);
+    MetalBumpAllocator(MetalContext& context, size_t capacity);
 
     /**
      * Allocates a staging area of the given size. Returns a pair of the buffer and the offset
      * within the buffer. The buffer is guaranteed to be at least the given size, but may be larger.
      * Clients must not write to the buffer beyond the returned offset + size.
-     * Clients are responsible for holding a reference to the returned buffer.
+     * The staging area stays valid until the pending command buffer completes, so clients must
+     * encode their use of it into the pending command buffer.
      * Allocations are guaranteed to be aligned to 4 bytes.
      */
     std::pair<id<MTLBuffer>, size_t> allocateStagingArea(size_t size);
 
+    // Returns the current buffer to the pool. Must only be called once all GPU work has finished.
+    void reset() noexcept;
+
     size_t getCapacity() const noexcept { return mCapacity; }
 
 private:
-    id<MTLDevice> mDevice;
-    TrackedMetalBuffer mCurrentUploadBuffer = nil;
+    // Returns the given buffer to the pool once the pending command buffer has completed.
+    void releaseAfterPendingCommands(MetalBufferPoolEntry const* stage);
+
+    MetalContext& mContext;
+    MetalBufferPoolEntry const* mCurrentUploadBuffer = nullptr;
     size_t mHead = 0;
     size_t mCapacity;
 };
 
 // Manages a pool of Metal buffers, periodically releasing ones that have been unused for awhile.
+//
+// Buffers are bucketed in power-of-two size classes. Each class keeps a small array of free slots
+// that are claimed and filled with atomic operations, so acquireBuffer() and releaseBuffer() never
+// take a lock, even though they may be called on separate threads (the engine thread and a Metal
+// callback thread, for example).
 class MetalBufferPool {
 public:
-    explicit MetalBufferPool(MetalContext& context) noexcept : mContext(context) {}
+    struct Statistics {
+        uint64_t acquireCount;      // calls to acquireBuffer()
+        uint64_t reuseCount;        // acquisitions served from a free list
+        uint64_t allocationCount;   // buffers created
+        uint64_t evictionCount;     // buffers destroyed by gc() or because their free list was full
+        uint64_t allocatedBytes;    // capacity of all the live buffers, free or in use
+        uint32_t inUseCount;        // buffers currently acquired
+    };
+
+    static constexpr uint32_t UNPOOLED = UINT32_MAX;
+
+    explicit MetalBufferPool(MetalContext& context) noexcept;
 
     // Finds or creates a buffer whose capacity is at least the given number of bytes.
     MetalBufferPoolEntry const* acquireBuffer(size_t numBytes);
@@ -81,20 +112,35 @@ public:
     // Destroys all unused buffers.
     void reset() noexcept;
 
+    Statistics getStatistics() const noexcept;
+
 private:
-    MetalContext& mContext;
+    static constexpr uint32_t MIN_SIZE_CLASS_SHIFT = 12;     // 4 KiB
+    static constexpr uint32_t SIZE_CLASS_COUNT = 20;         // up to 2 GiB
+    static constexpr size_t FREE_SLOT_COUNT = 16;
+
+    // Returns the size class of the given size, or UNPOOLED if it's too large to be pooled.
+    static uint32_t getSizeClass(size_t numBytes) noexcept;
 
-    // Synchronizes access to mFreeStages, mUsedStages, and mutable data inside MetalBufferPoolEntrys.
-    // acquireBuffer and releaseBuffer may be called on separate threads (the engine thread and a
-    // Metal callback thread, for example).
-    std::mutex mMutex;
+    // Tries to store the given entry in a free slot of its size class.
+    bool pushFreeEntry(MetalBufferPoolEntry const* stage) noexcept;
 
-    // Use an ordered multimap for quick (capacity => stage) lookups using lower_bound().
-    std::multimap<size_t, MetalBufferPoolEntry const*> mFreeStages;
+    void destroyEntry(MetalBufferPoolEntry const* stage) noexcept;
 
-    // Simple unordered set for stashing a list of in-use stages that can be reclaimed later.
-    // In theory this need not exist, but is useful for validation and ensuring no leaks.
-    std::unordered_set<MetalBufferPoolEntry const*> mUsedStages;
+    MetalContext& mContext;
+    size_t mMaxBufferLength;
+
+    // A free list is a fixed array of slots, each holding an entry or null. Claiming an entry with
+    // an exchange, unlike popping a linked list, isn't subject to the ABA problem.
+    using FreeList = std::array<std::atomic<MetalBufferPoolEntry const*>, FREE_SLOT_COUNT>;
+    std::array<FreeList, SIZE_CLASS_COUNT> mFreeLists{};
+
+    std::atomic<uint64_t> mAcquireCount = 0;
+    std::atomic<uint64_t> mReuseCount = 0;
+    std::atomic<uint64_t> mAllocationCount = 0;
+    std::atomic<uint64_t> mEvictionCount = 0;
+    std::atomic<uint64_t> mAllocatedBytes = 0;
+    std::atomic<uint32_t> mInUseCount = 0;
 
     // Store the current "time" (really just a frame count) and LRU eviction parameters.
     // An atomic is necessary as mCurrentFrame is incremented in gc() (called on
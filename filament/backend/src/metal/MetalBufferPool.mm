@@ -18,72 +18,115 @@
 
 #include "MetalContext.h"
 
+#include <utils/algorithm.h>
 #include <utils/Panic.h>
 #include <utils/Log.h>
 #include <utils/trap.h>
 
-#include <thread>
-#include <chrono>
+#include <algorithm>
 
 namespace filament {
 namespace backend {
 
+MetalBufferPool::MetalBufferPool(MetalContext& context) noexcept : mContext(context) {
+    // Earlier versions of iOS don't have the maxBufferLength query, but 256 MB is a safe bet.
+    mMaxBufferLength = 256 * 1024 * 1024;
+    if (@available(iOS 12, *)) {
+        mMaxBufferLength = context.device.maxBufferLength;
+    }
+}
+
+uint32_t MetalBufferPool::getSizeClass(size_t numBytes) noexcept {
+    const size_t size = std::max(numBytes, size_t(1) << MIN_SIZE_CLASS_SHIFT);
+    // ceil(log2(size))
+    const uint32_t shift = uint32_t(sizeof(size_t) * 8 - utils::clz(size - 1));
+    const uint32_t sizeClass = shift - MIN_SIZE_CLASS_SHIFT;
+    return sizeClass < SIZE_CLASS_COUNT ? sizeClass : UNPOOLED;
+}
+
 MetalBufferPoolEntry const* MetalBufferPool::acquireBuffer(size_t numBytes) {
-    std::lock_guard<std::mutex> lock(mMutex);
-
-    // First check if a stage exists whose capacity is greater than or equal to the requested size.
-    auto iter = mFreeStages.lower_bound(numBytes);
-    if (iter != mFreeStages.end()) {
-        auto stage = iter->second;
-        mFreeStages.erase(iter);
-        mUsedStages.insert(stage);
-        stage->referenceCount = 1;
-        return stage;
+    mAcquireCount.fetch_add(1, std::memory_order_relaxed);
+
+    uint32_t sizeClass = getSizeClass(numBytes);
+    size_t capacity = numBytes;
+    if (sizeClass != UNPOOLED) {
+        // First check if a free stage exists in the requested size class.
+        for (auto& slot : mFreeLists[sizeClass]) {
+            if (!slot.load(std::memory_order_relaxed)) {
+                continue;
+            }
+            if (auto stage = slot.exchange(nullptr, std::memory_order_acquire)) {
+                stage->referenceCount.store(1, std::memory_order_relaxed);
+                mReuseCount.fetch_add(1, std::memory_order_relaxed);
+                mInUseCount.fetch_add(1, std::memory_order_relaxed);
+                return stage;
+            }
+        }
+        capacity = size_t(1) << (sizeClass + MIN_SIZE_CLASS_SHIFT);
+        // Rounding up can exceed the device limit even when the requested size doesn't.
+        if (capacity > mMaxBufferLength) {
+            sizeClass = UNPOOLED;
+            capacity = numBytes;
+        }
     }
 
-    // We were not able to find a sufficiently large stage, so create a new one.
+    // We were not able to find a free stage, so create a new one.
     id<MTLBuffer> buffer = nil;
     {
         ScopedAllocationTimer timer("staging");
-        buffer = [mContext.device newBufferWithLength:numBytes
+        buffer = [mContext.device newBufferWithLength:capacity
                                               options:MTLResourceStorageModeShared];
     }
     FILAMENT_CHECK_POSTCONDITION(buffer)
-            << "Could not allocate Metal staging buffer of size " << numBytes << ".";
+            << "Could not allocate Metal staging buffer of size " << capacity << ".";
     MetalBufferPoolEntry* stage = new MetalBufferPoolEntry {
         .buffer = { buffer, TrackedMetalBuffer::Type::STAGING },
-        .capacity = numBytes,
+        .capacity = capacity,
+        .sizeClass = sizeClass,
         .lastAccessed = mCurrentFrame,
         .referenceCount = 1
     };
-    mUsedStages.insert(stage);
-
+    mAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    mAllocatedBytes.fetch_add(capacity, std::memory_order_relaxed);
+    mInUseCount.fetch_add(1, std::memory_order_relaxed);
     return stage;
 }
 
 void MetalBufferPool::retainBuffer(MetalBufferPoolEntry const *stage) noexcept {
-    std::lock_guard<std::mutex> lock(mMutex);
-
-    (stage->referenceCount)++;
+    stage->referenceCount.fetch_add(1, std::memory_order_relaxed);
 }
 
 void MetalBufferPool::releaseBuffer(MetalBufferPoolEntry const *stage) noexcept {
-    std::lock_guard<std::mutex> lock(mMutex);
-
     // Decrement the ref count. If it is at 0, move the buffer entry to the free list.
-    if (--(stage->referenceCount) > 0) {
+    if (stage->referenceCount.fetch_sub(1, std::memory_order_acq_rel) > 1) {
         return;
     }
+    mInUseCount.fetch_sub(1, std::memory_order_relaxed);
 
-    auto iter = mUsedStages.find(stage);
-    if (iter == mUsedStages.end()) {
-        utils::slog.e << "Unknown Metal buffer: " << stage->capacity << " bytes"
-                << utils::io::endl;
-        return;
-    }
     stage->lastAccessed = mCurrentFrame;
-    mUsedStages.erase(iter);
-    mFreeStages.insert(std::make_pair(stage->capacity, stage));
+    if (!pushFreeEntry(stage)) {
+        destroyEntry(stage);
+    }
+}
+
+bool MetalBufferPool::pushFreeEntry(MetalBufferPoolEntry const* stage) noexcept {
+    if (stage->sizeClass == UNPOOLED) {
+        return false;
+    }
+    for (auto& slot : mFreeLists[stage->sizeClass]) {
+        MetalBufferPoolEntry const* expected = nullptr;
+        if (slot.compare_exchange_strong(expected, stage,
+                std::memory_order_release, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void MetalBufferPool::destroyEntry(MetalBufferPoolEntry const* stage) noexcept {
+    mEvictionCount.fetch_add(1, std::memory_order_relaxed);
+    mAllocatedBytes.fetch_sub(stage->capacity, std::memory_order_relaxed);
+    delete stage;
 }
 
 void MetalBufferPool::gc() noexcept {
@@ -93,61 +136,97 @@ void MetalBufferPool::gc() noexcept {
     }
     const uint64_t evictionTime = mCurrentFrame - TIME_BEFORE_EVICTION;
 
-    std::lock_guard<std::mutex> lock(mMutex);
-
-    decltype(mFreeStages) stages;
-    stages.swap(mFreeStages);
-    for (auto pair : stages) {
-        if (pair.second->lastAccessed < evictionTime) {
-            delete pair.second;
-        } else {
-            mFreeStages.insert(pair);
+    for (auto& freeList : mFreeLists) {
+        for (auto& slot : freeList) {
+            if (!slot.load(std::memory_order_relaxed)) {
+                continue;
+            }
+            // Take the stage out of its slot before looking at it, so that it can't be acquired
+            // concurrently. It is put back (possibly in another slot) if it's still recent.
+            auto stage = slot.exchange(nullptr, std::memory_order_acquire);
+            if (!stage) {
+                continue;
+            }
+            if (stage->lastAccessed >= evictionTime && pushFreeEntry(stage)) {
+                continue;
+            }
+            destroyEntry(stage);
         }
     }
 }
 
 void MetalBufferPool::reset() noexcept {
-    std::lock_guard<std::mutex> lock(mMutex);
-
-    assert_invariant(mUsedStages.empty());
-    for (auto pair : mFreeStages) {
-        delete pair.second;
+    assert_invariant(mInUseCount == 0);
+    for (auto& freeList : mFreeLists) {
+        for (auto& slot : freeList) {
+            if (auto stage = slot.exchange(nullptr, std::memory_order_acquire)) {
+                destroyEntry(stage);
+            }
+        }
     }
-    mFreeStages.clear();
 }
 
-MetalBumpAllocator::MetalBumpAllocator(id<MTLDevice> device, size_t capacity)
-    : mDevice(device), mCapacity(capacity) {
-    if (mCapacity > 0) {
-        mCurrentUploadBuffer = { [device newBufferWithLength:capacity options:MTLStorageModeShared],
-            TrackedMetalBuffer::Type::STAGING };
-    }
+MetalBufferPool::Statistics MetalBufferPool::getStatistics() const noexcept {
+    return {
+        .acquireCount = mAcquireCount.load(std::memory_order_relaxed),
+        .reuseCount = mReuseCount.load(std::memory_order_relaxed),
+        .allocationCount = mAllocationCount.load(std::memory_order_relaxed),
+        .evictionCount = mEvictionCount.load(std::memory_order_relaxed),
+        .allocatedBytes = mAllocatedBytes.load(std::memory_order_relaxed),
+        .inUseCount = mInUseCount.load(std::memory_order_relaxed),
+    };
+}
+
+MetalBumpAllocator::MetalBumpAllocator(MetalContext& context, size_t capacity)
+    : mContext(context), mCapacity(capacity) {
+}
+
+void MetalBumpAllocator::releaseAfterPendingCommands(MetalBufferPoolEntry const* stage) {
+    // All the blits that use this stage were encoded into the pending command buffer or into one
+    // that was committed before it, so it's free once the pending command buffer completes.
+    MetalBufferPool* bufferPool = mContext.bufferPool;
+    [getPendingCommandBuffer(&mContext) addCompletedHandler:^(id<MTLCommandBuffer> cb) {
+        bufferPool->releaseBuffer(stage);
+    }];
 }
 
 std::pair<id<MTLBuffer>, size_t> MetalBumpAllocator::allocateStagingArea(size_t size) {
     if (size == 0) {
         return { nil, 0 };
     }
+    MetalBufferPool* bufferPool = mContext.bufferPool;
     if (size > mCapacity) {
-        return { [mDevice newBufferWithLength:size options:MTLStorageModeShared], 0 };
+        MetalBufferPoolEntry const* const stage = bufferPool->acquireBuffer(size);
+        releaseAfterPendingCommands(stage);
+        return { stage->buffer.get(), 0 };
     }
-    assert_invariant(mCurrentUploadBuffer);
 
     // Align the head to a 4-byte boundary.
     mHead = (mHead + 3) & ~3;
 
-    if (UTILS_LIKELY(mHead + size <= mCapacity)) {
+    if (UTILS_LIKELY(mCurrentUploadBuffer && mHead + size <= mCapacity)) {
         const size_t oldHead = mHead;
         mHead += size;
-        return { mCurrentUploadBuffer.get(), oldHead };
+        return { mCurrentUploadBuffer->buffer.get(), oldHead };
     }
 
-    // We're finished with the current allocation.
-    mCurrentUploadBuffer = { [mDevice newBufferWithLength:mCapacity options:MTLStorageModeShared],
-        TrackedMetalBuffer::Type::STAGING };
+    // We're finished with the current buffer, it goes back to the pool once the GPU is done
+    // with it, and will be handed out again in a later frame.
+    if (mCurrentUploadBuffer) {
+        releaseAfterPendingCommands(mCurrentUploadBuffer);
+    }
+    mCurrentUploadBuffer = bufferPool->acquireBuffer(mCapacity);
     mHead = size;
 
-    return { mCurrentUploadBuffer.get(), 0 };
+    return { mCurrentUploadBuffer->buffer.get(), 0 };
+}
+
+void MetalBumpAllocator::reset() noexcept {
+    if (mCurrentUploadBuffer) {
+        mContext.bufferPool->releaseBuffer(mCurrentUploadBuffer);
+        mCurrentUploadBuffer = nullptr;
+        mHead = 0;
+    }
 }
 
 } // namespace backend
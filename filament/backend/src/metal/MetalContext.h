@@ -33,6 +33,13 @@
 #include <atomic>
 #include <stack>
 
+// MTLResidencySet is only declared by the macOS 15 / iOS 18 SDKs and later.
+#if MAC_OS_X_VERSION_MAX_ALLOWED >= 150000 || __IPHONE_OS_VERSION_MAX_ALLOWED >= 180000
+#define FILAMENT_METAL_RESIDENCY_SETS 1
+#else
+#define FILAMENT_METAL_RESIDENCY_SETS 0
+#endif
+
 #if defined(FILAMENT_METAL_PROFILING)
 #include <os/log.h>
 #include <os/signpost.h>
@@ -203,6 +210,13 @@ struct MetalContext {
     id<MTLTexture> emptyTexture = nil;
     id<MTLBuffer> emptyBuffer = nil;
 
+#if FILAMENT_METAL_RESIDENCY_SETS
+    // Keeps the resources above resident for the lifetime of the command queue, so they don't
+    // need a useResource call in each render pass. Only available on macOS 15 and iOS 18.
+    API_AVAILABLE(macos(15.0), ios(18.0))
+    id<MTLResidencySet> residencySet = nil;
+#endif
+
     MetalBlitter* blitter = nullptr;
 
     // Fences, only supported on macOS 10.14 and iOS 12 and above.
@@ -221,6 +235,9 @@ struct MetalContext {
 
     MetalShaderCompiler* shaderCompiler = nullptr;
 
+    // Persists pipelineStateCache's pipeline states across launches.
+    MetalBinaryArchive* binaryArchive = nullptr;
+
 #if defined(FILAMENT_METAL_PROFILING)
     // Logging and profiling.
     os_log_t log;
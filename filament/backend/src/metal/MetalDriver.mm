@@ -21,6 +21,7 @@
 
 #include <filament/SwapChain.h>
 
+#include "MetalBinaryArchive.h"
 #include "MetalBlitter.h"
 #include "MetalBufferPool.h"
 #include "MetalContext.h"
@@ -201,12 +202,14 @@ MetalDriver::MetalDriver(
 
     mContext->commandQueue = commandQueue.commandQueue;
     mContext->pipelineStateCache.setDevice(mContext->device);
+    mContext->binaryArchive = new MetalBinaryArchive(mContext->device, mPlatform);
+    mContext->pipelineStateCache.getCreator().archive = mContext->binaryArchive;
     mContext->depthStencilStateCache.setDevice(mContext->device);
     mContext->samplerStateCache.setDevice(mContext->device);
     mContext->argumentEncoderCache.setDevice(mContext->device);
     mContext->bufferPool = new MetalBufferPool(*mContext);
     mContext->bumpAllocator =
-            new MetalBumpAllocator(mContext->device, driverConfig.metalUploadBufferSizeBytes);
+            new MetalBumpAllocator(*mContext, driverConfig.metalUploadBufferSizeBytes);
     mContext->blitter = new MetalBlitter(*mContext);
 
     if (@available(iOS 12, *)) {
@@ -225,6 +228,27 @@ MetalDriver::MetalDriver(
         mContext->eventListener = [[MTLSharedEventListener alloc] initWithDispatchQueue:queue];
     }
 
+#if FILAMENT_METAL_RESIDENCY_SETS
+    if (@available(macOS 15.0, iOS 18.0, *)) {
+        MTLResidencySetDescriptor* residencySetDescriptor = [MTLResidencySetDescriptor new];
+        residencySetDescriptor.label = @"Filament static resources";
+        NSError* error = nil;
+        mContext->residencySet =
+                [mContext->device newResidencySetWithDescriptor:residencySetDescriptor
+                                                          error:&error];
+        if (mContext->residencySet) {
+            [mContext->residencySet addAllocation:mContext->emptyBuffer];
+            [mContext->residencySet addAllocation:getOrCreateEmptyTexture(mContext)];
+            [mContext->residencySet commit];
+            [mContext->residencySet requestResidency];
+            [mContext->commandQueue addResidencySet:mContext->residencySet];
+        } else {
+            utils::slog.w << "Could not create Metal residency set: "
+                          << error.localizedDescription.UTF8String << utils::io::endl;
+        }
+    }
+#endif
+
     const MetalShaderCompiler::Mode compilerMode = driverConfig.disableParallelShaderCompile
             ? MetalShaderCompiler::Mode::SYNCHRONOUS
             : MetalShaderCompiler::Mode::ASYNCHRONOUS;
@@ -249,6 +273,7 @@ MetalDriver::~MetalDriver() noexcept {
     delete mContext->blitter;
     delete mContext->timerQueryImpl;
     delete mContext->shaderCompiler;
+    delete mContext->binaryArchive;
     delete mContext;
 }
 
@@ -303,6 +328,9 @@ void MetalDriver::execute(std::function<void(void)> const& fn) noexcept {
 void MetalDriver::setPresentationTime(int64_t monotonic_clock_ns) {
 }
 
+void MetalDriver::setPresentationDamage(Viewport region) {
+}
+
 void MetalDriver::endFrame(uint32_t frameId) {
     DEBUG_LOG("endFrame(frameId = %d)\n", frameId);
     // If we haven't committed the command buffer (if the frame was canceled), do it now. There may
@@ -318,6 +346,8 @@ void MetalDriver::endFrame(uint32_t frameId) {
 
     CVMetalTextureCacheFlush(mContext->textureCache, 0);
 
+    mContext->binaryArchive->endFrame();
+
     assert_invariant(mContext->groupMarkers.empty());
 
     // If we exceeded memoryless limits, turn it off for the rest of the lifetime of the driver.
@@ -593,6 +623,12 @@ void MetalDriver::createProgramR(Handle<HwProgram> rph, Program&& program) {
     construct_handle<MetalProgram>(rph, *mContext, std::move(program));
 }
 
+void MetalDriver::createPipelineStateR(Handle<HwPipelineState> psh, PipelineState const& state) {
+    DEBUG_LOG("createPipelineStateR(psh = %d, program = %d)\n", psh.getId(),
+            state.program.getId());
+    construct_handle<HwPipelineState>(psh, state);
+}
+
 void MetalDriver::createDefaultRenderTargetR(Handle<HwRenderTarget> rth, int dummy) {
     construct_handle<MetalRenderTarget>(rth, mContext);
 }
@@ -792,6 +828,10 @@ Handle<HwProgram> MetalDriver::createProgramS() noexcept {
     return alloc_handle<MetalProgram>();
 }
 
+Handle<HwPipelineState> MetalDriver::createPipelineStateS() noexcept {
+    return alloc_handle<HwPipelineState>();
+}
+
 Handle<HwRenderTarget> MetalDriver::createDefaultRenderTargetS() noexcept {
     return alloc_handle<MetalRenderTarget>();
 }
@@ -876,6 +916,14 @@ void MetalDriver::destroyProgram(Handle<HwProgram> ph) {
     destruct_handle<MetalProgram>(ph);
 }
 
+void MetalDriver::destroyPipelineState(Handle<HwPipelineState> psh) {
+    DEBUG_LOG("destroyPipelineState(psh = %d)\n", psh.getId());
+    if (UTILS_UNLIKELY(!psh)) {
+        return;
+    }
+    destruct_handle<HwPipelineState>(psh);
+}
+
 void MetalDriver::destroyTexture(Handle<HwTexture> th) {
     DEBUG_LOG("destroyTexture(th = %d)\n", th.getId());
     if (!th) {
@@ -956,12 +1004,22 @@ void MetalDriver::terminate() {
     // This must be done before calling bufferPool->reset() to ensure no buffers are in flight.
     finish();
 
+    mContext->bumpAllocator->reset();
     mContext->bufferPool->reset();
+#if FILAMENT_METAL_RESIDENCY_SETS
+    if (@available(macOS 15.0, iOS 18.0, *)) {
+        if (mContext->residencySet) {
+            [mContext->commandQueue removeResidencySet:mContext->residencySet];
+            mContext->residencySet = nil;
+        }
+    }
+#endif
     mContext->commandQueue = nil;
 
     MetalExternalImage::shutdown(*mContext);
     mContext->blitter->shutdown();
     mContext->shaderCompiler->terminate();
+    mContext->binaryArchive->flush();
 }
 
 ShaderModel MetalDriver::getShaderModel() const noexcept {
@@ -1133,6 +1191,14 @@ bool MetalDriver::isDepthClampSupported() {
     return mContext->supportsDepthClamp;
 }
 
+MemoryBudget MetalDriver::getMemoryBudget() {
+    MemoryBudget budget{ .usage = mContext->device.currentAllocatedSize };
+    if (@available(iOS 16, *)) {
+        budget.budget = mContext->device.recommendedMaxWorkingSetSize;
+    }
+    return budget;
+}
+
 bool MetalDriver::isWorkaroundNeeded(Workaround workaround) {
     switch (workaround) {
         case Workaround::SPLIT_EASU:
@@ -1195,6 +1261,11 @@ size_t MetalDriver::getMaxArrayTextureLayers() {
     return 256;
 }
 
+math::uint3 MetalDriver::getSparseTexturePageSize(SamplerType, TextureFormat) {
+    // TODO: implement with MTLSparseTexture and placement sparse heaps
+    return {};
+}
+
 void MetalDriver::updateIndexBuffer(Handle<HwIndexBuffer> ibh, BufferDescriptor&& data,
         uint32_t byteOffset) {
     FILAMENT_CHECK_PRECONDITION(data.buffer)
@@ -1297,6 +1368,87 @@ void MetalDriver::generateMipmaps(Handle<HwTexture> th) {
     DEBUG_LOG("generateMipmaps(th = %d)\n", th.getId());
 }
 
+void MetalDriver::commitTexturePages(Handle<HwTexture> th, uint32_t level, uint32_t xoffset,
+        uint32_t yoffset, uint32_t width, uint32_t height, bool commit) {
+    // sparse textures are not supported, see getSparseTexturePageSize()
+}
+
+static MetalPipelineState createPipelineState(MetalRenderTarget* rt,
+        MetalVertexBufferInfo const* vbi, RasterState const& rs,
+        id<MTLFunction> vertex, id<MTLFunction> fragment) {
+    MTLPixelFormat colorPixelFormat[MRT::MAX_SUPPORTED_RENDER_TARGET_COUNT] = { MTLPixelFormatInvalid };
+    for (size_t i = 0; i < MRT::MAX_SUPPORTED_RENDER_TARGET_COUNT; i++) {
+        const auto& attachment = rt->getDrawColorAttachment(i);
+        if (!attachment) {
+            continue;
+        }
+        colorPixelFormat[i] = attachment.getPixelFormat();
+    }
+    MTLPixelFormat depthPixelFormat = MTLPixelFormatInvalid;
+    const auto& depthAttachment = rt->getDepthAttachment();
+    if (depthAttachment) {
+        depthPixelFormat = depthAttachment.getPixelFormat();
+    }
+    MTLPixelFormat stencilPixelFormat = MTLPixelFormatInvalid;
+    const auto& stencilAttachment = rt->getStencilAttachment();
+    if (stencilAttachment) {
+        stencilPixelFormat = stencilAttachment.getPixelFormat();
+        assert_invariant(isMetalFormatStencil(stencilPixelFormat));
+    }
+    return MetalPipelineState {
+        .vertexFunction = vertex,
+        .fragmentFunction = fragment,
+        .vertexDescription = vbi->vertexDescription,
+        .colorAttachmentPixelFormat = {
+            colorPixelFormat[0],
+            colorPixelFormat[1],
+            colorPixelFormat[2],
+            colorPixelFormat[3],
+            colorPixelFormat[4],
+            colorPixelFormat[5],
+            colorPixelFormat[6],
+            colorPixelFormat[7]
+        },
+        .depthAttachmentPixelFormat = depthPixelFormat,
+        .stencilAttachmentPixelFormat = stencilPixelFormat,
+        .sampleCount = rt->getSamples(),
+        .blendState = BlendState {
+            .alphaBlendOperation = getMetalBlendOperation(rs.blendEquationAlpha),
+            .rgbBlendOperation = getMetalBlendOperation(rs.blendEquationRGB),
+            .destinationAlphaBlendFactor = getMetalBlendFactor(rs.blendFunctionDstAlpha),
+            .destinationRGBBlendFactor = getMetalBlendFactor(rs.blendFunctionDstRGB),
+            .sourceAlphaBlendFactor = getMetalBlendFactor(rs.blendFunctionSrcAlpha),
+            .sourceRGBBlendFactor = getMetalBlendFactor(rs.blendFunctionSrcRGB),
+            .blendingEnabled = rs.hasBlending(),
+        },
+        .colorWrite = rs.colorWrite
+    };
+}
+
+void MetalDriver::prewarmPipeline(Handle<HwRenderTarget> rth, const RenderPassParams& params,
+        PipelineState const& ps) {
+    // Metal programs are compiled asynchronously by the shader compiler, but pipeline states are
+    // created on first use. Creating the pipeline state here takes that cost out of the first
+    // draw; this might block until the program is compiled.
+    auto rt = handle_cast<MetalRenderTarget>(rth);
+    auto program = handle_cast<MetalProgram>(ps.program);
+    MetalVertexBufferInfo const* const vbi =
+            handle_cast<MetalVertexBufferInfo>(ps.vertexBufferInfo);
+
+    auto functions = program->getFunctions();
+    if (UTILS_UNLIKELY(!functions)) {
+        return;
+    }
+    functions.validate();
+    auto [fragment, vertex] = functions.getRasterFunctions();
+
+    MetalPipelineState const pipelineState = createPipelineState(rt, vbi, ps.rasterState,
+            vertex, fragment);
+    UTILS_UNUSED_IN_RELEASE id<MTLRenderPipelineState> pipeline =
+            mContext->pipelineStateCache.getOrCreateState(pipelineState);
+    assert_invariant(pipeline != nil);
+}
+
 void MetalDriver::compilePrograms(CompilerPriorityQueue priority,
         CallbackHandler* handler, CallbackHandler::Callback callback, void* user) {
     if (callback) {
@@ -1363,6 +1515,21 @@ void MetalDriver::beginRenderPass(Handle<HwRenderTarget> rth,
     mContext->computeDescriptorBindings.invalidate();
     mContext->dynamicOffsets.setDirty(true);
 
+    // Unbound descriptors point to the empty buffer and texture, which are used by every
+    // argument buffer; they're made resident once here instead of once per descriptor set.
+    bool staticResourcesResident = false;
+#if FILAMENT_METAL_RESIDENCY_SETS
+    if (@available(macOS 15.0, iOS 18.0, *)) {
+        staticResourcesResident = mContext->residencySet != nil;
+    }
+#endif
+    if (!staticResourcesResident) {
+        [mContext->currentRenderPassEncoder useResource:mContext->emptyBuffer
+                                                  usage:MTLResourceUsageRead];
+        [mContext->currentRenderPassEncoder useResource:getOrCreateEmptyTexture(mContext)
+                                                  usage:MTLResourceUsageRead];
+    }
+
     // Finalize any descriptor sets that were bound before the render pass.
     for (size_t i = 0; i < MAX_DESCRIPTOR_SET_COUNT; i++) {
         auto* descriptorSet = mContext->currentDescriptorSets[i];
@@ -1772,53 +1939,8 @@ void MetalDriver::bindPipeline(PipelineState const& ps) {
     auto [fragment, vertex] = functions.getRasterFunctions();
 
     // Pipeline state
-    MTLPixelFormat colorPixelFormat[MRT::MAX_SUPPORTED_RENDER_TARGET_COUNT] = { MTLPixelFormatInvalid };
-    for (size_t i = 0; i < MRT::MAX_SUPPORTED_RENDER_TARGET_COUNT; i++) {
-        const auto& attachment = mContext->currentRenderTarget->getDrawColorAttachment(i);
-        if (!attachment) {
-            continue;
-        }
-        colorPixelFormat[i] = attachment.getPixelFormat();
-    }
-    MTLPixelFormat depthPixelFormat = MTLPixelFormatInvalid;
-    const auto& depthAttachment = mContext->currentRenderTarget->getDepthAttachment();
-    if (depthAttachment) {
-        depthPixelFormat = depthAttachment.getPixelFormat();
-    }
-    MTLPixelFormat stencilPixelFormat = MTLPixelFormatInvalid;
-    const auto& stencilAttachment = mContext->currentRenderTarget->getStencilAttachment();
-    if (stencilAttachment) {
-        stencilPixelFormat = stencilAttachment.getPixelFormat();
-        assert_invariant(isMetalFormatStencil(stencilPixelFormat));
-    }
-    MetalPipelineState const pipelineState {
-        .vertexFunction = vertex,
-        .fragmentFunction = fragment,
-        .vertexDescription = vbi->vertexDescription,
-        .colorAttachmentPixelFormat = {
-            colorPixelFormat[0],
-            colorPixelFormat[1],
-            colorPixelFormat[2],
-            colorPixelFormat[3],
-            colorPixelFormat[4],
-            colorPixelFormat[5],
-            colorPixelFormat[6],
-            colorPixelFormat[7]
-        },
-        .depthAttachmentPixelFormat = depthPixelFormat,
-        .stencilAttachmentPixelFormat = stencilPixelFormat,
-        .sampleCount = mContext->currentRenderTarget->getSamples(),
-        .blendState = BlendState {
-            .alphaBlendOperation = getMetalBlendOperation(rs.blendEquationAlpha),
-            .rgbBlendOperation = getMetalBlendOperation(rs.blendEquationRGB),
-            .destinationAlphaBlendFactor = getMetalBlendFactor(rs.blendFunctionDstAlpha),
-            .destinationRGBBlendFactor = getMetalBlendFactor(rs.blendFunctionDstRGB),
-            .sourceAlphaBlendFactor = getMetalBlendFactor(rs.blendFunctionSrcAlpha),
-            .sourceRGBBlendFactor = getMetalBlendFactor(rs.blendFunctionSrcRGB),
-            .blendingEnabled = rs.hasBlending(),
-        },
-        .colorWrite = rs.colorWrite
-    };
+    MetalPipelineState const pipelineState = createPipelineState(mContext->currentRenderTarget,
+            vbi, rs, vertex, fragment);
     mContext->pipelineState.updateState(pipelineState);
     if (mContext->pipelineState.stateChanged()) {
         id<MTLRenderPipelineState> pipeline =
@@ -1851,6 +1973,8 @@ void MetalDriver::bindPipeline(PipelineState const& ps) {
     }
 
     // Set the depth-stencil state, if a state change is needed.
+    const auto& depthAttachment = mContext->currentRenderTarget->getDepthAttachment();
+    const auto& stencilAttachment = mContext->currentRenderTarget->getStencilAttachment();
     DepthStencilState depthState;
     if (depthAttachment) {
         depthState.depthCompare = getMetalCompareFunction(rs.depthFunc);
@@ -1900,6 +2024,10 @@ void MetalDriver::bindPipeline(PipelineState const& ps) {
     mContext->validPipelineBound = true;
 }
 
+void MetalDriver::bindPipelineState(Handle<HwPipelineState> psh) {
+    bindPipeline(handle_cast<HwPipelineState>(psh)->state);
+}
+
 void MetalDriver::bindRenderPrimitive(Handle<HwRenderPrimitive> rph) {
     if (UTILS_UNLIKELY(mContext->currentRenderPassAbandoned)) {
         return;
@@ -2039,6 +2167,12 @@ void MetalDriver::draw2(uint32_t indexOffset, uint32_t indexCount, uint32_t inst
                                                 instanceCount:instanceCount];
 }
 
+void MetalDriver::multiDraw2(DrawRange const* ranges, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        draw2(ranges[i].indexOffset, ranges[i].indexCount, 1);
+    }
+}
+
 void MetalDriver::draw(PipelineState ps, Handle<HwRenderPrimitive> rph,
         uint32_t const indexOffset, uint32_t const indexCount, uint32_t const instanceCount) {
     if (UTILS_UNLIKELY(mContext->currentRenderPassAbandoned)) {
@@ -618,6 +618,14 @@ MetalTexture::MetalTexture(MetalContext& context, SamplerType target, uint8_t le
             descriptor.sampleCount = multisampled ? samples : 1;
             descriptor.usage = getMetalTextureUsage(usage);
             descriptor.storageMode = MTLStorageModePrivate;
+            // Attachments whose content never leaves a render pass can live in tile memory only.
+            if (any(usage & TextureUsage::TRANSIENT) &&
+                    none(usage & ~(TextureUsage::ALL_ATTACHMENTS | TextureUsage::TRANSIENT)) &&
+                    !mipmapped && context.supportsMemorylessRenderTargets) {
+                if (@available(macOS 11.0, *)) {
+                    descriptor.storageMode = MTLStorageModeMemoryless;
+                }
+            }
             texture = [context.device newTextureWithDescriptor:descriptor];
             break;
         case SamplerType::SAMPLER_CUBEMAP:
@@ -1398,28 +1406,32 @@ MetalDescriptorSet::MetalDescriptorSet(MetalDescriptorSetLayout* layout) noexcep
     : layout(layout) {}
 
 void MetalDescriptorSet::finalize(MetalDriver* driver) {
-    [driver->mContext->currentRenderPassEncoder useResource:driver->mContext->emptyBuffer
-                                                      usage:MTLResourceUsageRead];
-    [driver->mContext->currentRenderPassEncoder
-            useResource:getOrCreateEmptyTexture(driver->mContext)
-                  usage:MTLResourceUsageRead];
-
+    // The empty buffer and texture are made resident by beginRenderPass().
+    id<MTLRenderCommandEncoder> encoder = driver->mContext->currentRenderPassEncoder;
     if (@available(iOS 13.0, *)) {
-        [driver->mContext->currentRenderPassEncoder useResources:vertexResources.data()
-                                                           count:vertexResources.size()
-                                                           usage:MTLResourceUsageRead
-                                                          stages:MTLRenderStageVertex];
-        [driver->mContext->currentRenderPassEncoder useResources:fragmentResources.data()
-                                                           count:fragmentResources.size()
-                                                           usage:MTLResourceUsageRead
-                                                          stages:MTLRenderStageFragment];
+        if (!vertexResources.empty()) {
+            [encoder useResources:vertexResources.data()
+                            count:vertexResources.size()
+                            usage:MTLResourceUsageRead
+                           stages:MTLRenderStageVertex];
+        }
+        if (!fragmentResources.empty()) {
+            [encoder useResources:fragmentResources.data()
+                            count:fragmentResources.size()
+                            usage:MTLResourceUsageRead
+                           stages:MTLRenderStageFragment];
+        }
     } else {
-        [driver->mContext->currentRenderPassEncoder useResources:vertexResources.data()
-                                                           count:vertexResources.size()
-                                                           usage:MTLResourceUsageRead];
-        [driver->mContext->currentRenderPassEncoder useResources:fragmentResources.data()
-                                                           count:fragmentResources.size()
-                                                           usage:MTLResourceUsageRead];
+        if (!vertexResources.empty()) {
+            [encoder useResources:vertexResources.data()
+                            count:vertexResources.size()
+                            usage:MTLResourceUsageRead];
+        }
+        if (!fragmentResources.empty()) {
+            [encoder useResources:fragmentResources.data()
+                            count:fragmentResources.size()
+                            usage:MTLResourceUsageRead];
+        }
     }
 }
 
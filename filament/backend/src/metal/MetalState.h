@@ -35,6 +35,8 @@
 namespace filament {
 namespace backend {
 
+class MetalBinaryArchive;
+
 //   Rasterization Bindings
 //   ----------------------
 //   Bindings    Buffer name                          Count
@@ -173,6 +175,8 @@ public:
 
     void setDevice(id<MTLDevice> device) noexcept { mDevice = device; }
 
+    StateCreator& getCreator() noexcept { return creator; }
+
     void removeIf(utils::Invocable<bool(const StateType&)> fn) noexcept {
         typename MapType::const_iterator it = mStateCache.begin();
         while (it != mStateCache.end()) {
@@ -293,6 +297,9 @@ static_assert(sizeof(MetalPipelineState) == 696, "MetalPipelineState unexpected
 struct PipelineStateCreator {
     id<MTLRenderPipelineState> operator()(id<MTLDevice> device, const MetalPipelineState& state)
             noexcept;
+
+    // Optional persistent cache of the compiled pipeline states.
+    MetalBinaryArchive* archive = nullptr;
 };
 
 using PipelineStateTracker = StateTracker<MetalPipelineState>;
@@ -16,6 +16,7 @@
 
 #include "MetalState.h"
 
+#include "MetalBinaryArchive.h"
 #include "MetalEnums.h"
 
 #include <utils/Log.h>
@@ -87,6 +88,13 @@ id<MTLRenderPipelineState> PipelineStateCreator::operator()(id<MTLDevice> device
     // MSAA
     descriptor.rasterSampleCount = state.sampleCount;
 
+    if (archive) {
+        id<MTLRenderPipelineState> pipeline = archive->find(device, descriptor);
+        if (pipeline) {
+            return pipeline;
+        }
+    }
+
     NSError* error = nullptr;
     id<MTLRenderPipelineState> pipeline = [device newRenderPipelineStateWithDescriptor:descriptor
                                                                                  error:&error];
@@ -102,6 +110,10 @@ id<MTLRenderPipelineState> PipelineStateCreator::operator()(id<MTLDevice> device
     }
     FILAMENT_CHECK_POSTCONDITION(error == nil) << "Could not create Metal pipeline state.";
 
+    if (archive) {
+        archive->add(descriptor);
+    }
+
     return pipeline;
 }
 
@@ -77,6 +77,9 @@ void NoopDriver::setFrameCompletedCallback(Handle<HwSwapChain> sch,
 void NoopDriver::setPresentationTime(int64_t monotonic_clock_ns) {
 }
 
+void NoopDriver::setPresentationDamage(Viewport region) {
+}
+
 void NoopDriver::endFrame(uint32_t frameId) {
 }
 
@@ -107,6 +110,9 @@ void NoopDriver::destroyTexture(Handle<HwTexture> th) {
 void NoopDriver::destroyProgram(Handle<HwProgram> ph) {
 }
 
+void NoopDriver::destroyPipelineState(Handle<HwPipelineState> psh) {
+}
+
 void NoopDriver::destroyRenderTarget(Handle<HwRenderTarget> rth) {
 }
 
@@ -220,6 +226,10 @@ bool NoopDriver::isDepthClampSupported() {
     return false;
 }
 
+MemoryBudget NoopDriver::getMemoryBudget() {
+    return {};
+}
+
 bool NoopDriver::isWorkaroundNeeded(Workaround) {
     return false;
 }
@@ -250,6 +260,10 @@ size_t NoopDriver::getMaxArrayTextureLayers() {
     return 256u;
 }
 
+math::uint3 NoopDriver::getSparseTexturePageSize(SamplerType, TextureFormat) {
+    return {};
+}
+
 void NoopDriver::updateIndexBuffer(Handle<HwIndexBuffer> ibh, BufferDescriptor&& p,
         uint32_t byteOffset) {
     scheduleDestroy(std::move(p));
@@ -296,6 +310,9 @@ void NoopDriver::setExternalStream(Handle<HwTexture> th, Handle<HwStream> sh) {
 
 void NoopDriver::generateMipmaps(Handle<HwTexture> th) { }
 
+void NoopDriver::commitTexturePages(Handle<HwTexture> th, uint32_t level, uint32_t xoffset,
+        uint32_t yoffset, uint32_t width, uint32_t height, bool commit) { }
+
 void NoopDriver::compilePrograms(CompilerPriorityQueue priority,
         CallbackHandler* handler, CallbackHandler::Callback callback, void* user) {
     if (callback) {
@@ -303,6 +320,10 @@ void NoopDriver::compilePrograms(CompilerPriorityQueue priority,
     }
 }
 
+void NoopDriver::prewarmPipeline(Handle<HwRenderTarget> rth, const RenderPassParams& params,
+        PipelineState const& state) {
+}
+
 void NoopDriver::beginRenderPass(Handle<HwRenderTarget> rth, const RenderPassParams& params) {
 }
 
@@ -368,12 +389,18 @@ void NoopDriver::blit(
 void NoopDriver::bindPipeline(PipelineState const& pipelineState) {
 }
 
+void NoopDriver::bindPipelineState(Handle<HwPipelineState> psh) {
+}
+
 void NoopDriver::bindRenderPrimitive(Handle<HwRenderPrimitive> rph) {
 }
 
 void NoopDriver::draw2(uint32_t indexOffset, uint32_t indexCount, uint32_t instanceCount) {
 }
 
+void NoopDriver::multiDraw2(DrawRange const* ranges, uint32_t count) {
+}
+
 void NoopDriver::draw(PipelineState pipelineState, Handle<HwRenderPrimitive> rph,
         uint32_t indexOffset, uint32_t indexCount, uint32_t instanceCount) {
 }
@@ -23,10 +23,28 @@
 
 #include <backend/DriverEnums.h>
 
+#include <array>
+
 #include <stdint.h>
 
 namespace filament::backend {
 
+struct GLStreamingStorage;
+
+#ifndef FILAMENT_SILENCE_NOT_SUPPORTED_BY_ES2
+// Persistently mapped, coherent storage of a dynamic uniform buffer. The buffer is allocated
+// REGION_COUNT times and updates go to the next region once the GPU is done with it, which
+// replaces buffer orphaning.
+struct GLStreamingStorage {
+    static constexpr size_t REGION_COUNT = 3;
+    uint8_t* vaddr = nullptr;                   // mapping of all the regions
+    std::array<GLsync, REGION_COUNT> fences{};  // signaled when the GPU is done with a region
+    uint32_t regionSize = 0;                    // buffer size rounded to the UBO alignment
+    uint8_t current = 0;                        // index of the current region
+    bool synchronized = false;                  // current region may be in use by the GPU
+};
+#endif
+
 struct GLBufferObject : public HwBufferObject {
     using HwBufferObject::HwBufferObject;
     GLBufferObject(uint32_t size,
@@ -44,6 +62,18 @@ struct GLBufferObject : public HwBufferObject {
     BufferUsage usage;
     BufferObjectBinding bindingType;
     uint16_t age = 0;
+
+    // Dynamic uniform buffers may be backed by a persistently mapped ring of regions (see
+    // OpenGLDriver::createStreamingStorage), in which case streamingOffset is the offset of the
+    // region currently in use and must be added to all offsets into this buffer.
+    GLStreamingStorage* streaming = nullptr;
+    uint32_t streamingOffset = 0;
+
+    // WebGL only. Copy of a uniform buffer's content, updates are written here and the dirty
+    // range is uploaded in one go before the next draw (see OpenGLDriver::flushUniformUpdates).
+    uint8_t* shadow = nullptr;
+    uint32_t dirtyBegin = 0;
+    uint32_t dirtyEnd = 0;
 };
 
 } // namespace filament::backend
@@ -126,6 +126,7 @@ void GLDescriptorSet::update(OpenGLContext&,
             arg.id = bo ? bo->gl.id : 0;
             arg.offset = uint32_t(offset);
             arg.size = uint32_t(size);
+            arg.streaming = (bo && bo->streaming) ? bo : nullptr;
             assert_invariant(arg.id || (!arg.size && !offset));
         } else if constexpr (std::is_same_v<T, BufferGLES2>) {
             arg.bo = bo;
@@ -265,12 +266,14 @@ void GLDescriptorSet::bind(
             using T = std::decay_t<decltype(arg)>;
             if constexpr (std::is_same_v<T, Buffer>) {
                 GLuint const bindingPoint = p.getBufferBinding(set, binding);
-                GLintptr const offset = arg.offset;
+                GLintptr const offset = arg.offset +
+                        (arg.streaming ? arg.streaming->streamingOffset : 0);
                 assert_invariant(arg.id || (!arg.size && !offset));
                 gl.bindBufferRange(arg.target, bindingPoint, arg.id, offset, arg.size);
             } else if constexpr (std::is_same_v<T, DynamicBuffer>) {
                 GLuint const bindingPoint = p.getBufferBinding(set, binding);
-                GLintptr const offset = arg.offset + offsets[dynamicOffsetIndex++];
+                GLintptr const offset = arg.offset + offsets[dynamicOffsetIndex++] +
+                        (arg.streaming ? arg.streaming->streamingOffset : 0);
                 assert_invariant(arg.id || (!arg.size && !offset));
                 gl.bindBufferRange(arg.target, bindingPoint, arg.id, offset, arg.size);
             } else if constexpr (std::is_same_v<T, BufferGLES2>) {
@@ -88,6 +88,8 @@ private:
         GLuint id = 0;                          // 4
         uint32_t offset = 0;                    // 4
         uint32_t size = 0;                      // 4
+        // only set for streaming buffers, whose current region offset is added at bind time
+        GLBufferObject const* streaming{};      // 8
     };
 
     // a Buffer Descriptor such as SSBO or UBO with dynamic offset
@@ -98,6 +100,8 @@ private:
         GLuint id = 0;                          // 4
         uint32_t offset = 0;                    // 4
         uint32_t size = 0;                      // 4
+        // only set for streaming buffers, whose current region offset is added at bind time
+        GLBufferObject const* streaming{};      // 8
     };
 
     // a UBO descriptor for ES2
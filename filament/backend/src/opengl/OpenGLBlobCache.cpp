@@ -21,17 +21,49 @@
 #include <backend/Platform.h>
 #include <backend/Program.h>
 
+#include <utils/compiler.h>
+#include <utils/debug.h>
+#include <utils/Hash.h>
+#include <utils/JobSystem.h>
 #include <utils/Systrace.h>
 
+#include <mutex>
+#include <string_view>
+#include <utility>
+
+#include <stdlib.h>
+
 namespace filament::backend {
 
+using namespace utils;
+
 struct OpenGLBlobCache::Blob {
+    uint32_t driverHash;
     GLenum format;
     char data[];
 };
 
+static uint32_t hashString(char const* str, uint32_t seed) noexcept {
+    if (!str) {
+        return seed;
+    }
+    std::string_view const s{ str };
+    return hash::murmurSlow((uint8_t const*)s.data(), s.size(), seed);
+}
+
 OpenGLBlobCache::OpenGLBlobCache(OpenGLContext& gl) noexcept
     : mCachingSupported(gl.gets.num_program_binary_formats >= 1) {
+    // Program binaries are only valid for the driver that produced them. Tagging each blob with
+    // the driver identity lets us skip stale entries without a (possibly slow) glProgramBinary.
+    uint32_t h = 0;
+    h = hashString(gl.state.vendor, h);
+    h = hashString(gl.state.renderer, h);
+    h = hashString(gl.state.version, h);
+    mDriverHash = h;
+}
+
+OpenGLBlobCache::~OpenGLBlobCache() noexcept {
+    assert_invariant(!mWriterThread.joinable());
 }
 
 GLuint OpenGLBlobCache::retrieve(BlobCacheKey* outKey, Platform& platform,
@@ -50,12 +82,18 @@ GLuint OpenGLBlobCache::retrieve(BlobCacheKey* outKey, Platform& platform,
     // FIXME: use a static buffer to avoid systematic allocation
     // always attempt with 64 KiB
     constexpr size_t DEFAULT_BLOB_SIZE = 65536;
-    std::unique_ptr<Blob, decltype(&::free)> blob{ (Blob*)malloc(DEFAULT_BLOB_SIZE), &::free };
+    BlobPtr blob{ (Blob*)malloc(DEFAULT_BLOB_SIZE), &::free };
 
     size_t const blobSize = platform.retrieveBlob(
             key.data(), key.size(), blob.get(), DEFAULT_BLOB_SIZE);
 
-    if (blobSize > 0) {
+    if (blobSize == 0) {
+        mMisses.fetch_add(1, std::memory_order_relaxed);
+    } else if (blobSize <= sizeof(Blob) || blob->driverHash != mDriverHash) {
+        // this binary was produced by another driver (or an older cache format), don't even
+        // try to load it. It'll be overwritten once the program is compiled.
+        mStale.fetch_add(1, std::memory_order_relaxed);
+    } else {
         if (blobSize > DEFAULT_BLOB_SIZE) {
             // our buffer was too small, retry with the correct size
             blob.reset((Blob*)malloc(blobSize));
@@ -73,9 +111,13 @@ GLuint OpenGLBlobCache::retrieve(BlobCacheKey* outKey, Platform& platform,
         }
 
         if (UTILS_UNLIKELY(glGetError() != GL_NO_ERROR)) {
-            // glProgramBinary can fail if for instance the driver has been updated
+            // glProgramBinary can still fail, e.g. if the driver changed without its version
+            // string being updated
             glDeleteProgram(programId);
             programId = 0;
+            mFailures.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            mHits.fetch_add(1, std::memory_order_relaxed);
         }
     }
 
@@ -105,7 +147,7 @@ void OpenGLBlobCache::insert(Platform& platform,
     }
     if (programBinarySize) {
         size_t const size = sizeof(Blob) + programBinarySize;
-        std::unique_ptr<Blob, decltype(&::free)> blob{ (Blob*)malloc(size), &::free };
+        BlobPtr blob{ (Blob*)malloc(size), &::free };
         if (UTILS_LIKELY(blob)) {
             { // scope for systrace
                 SYSTRACE_NAME("glGetProgramBinary");
@@ -114,12 +156,79 @@ void OpenGLBlobCache::insert(Platform& platform,
             }
             GLenum const error = glGetError();
             if (error == GL_NO_ERROR) {
+                blob->driverHash = mDriverHash;
                 blob->format = format;
-                platform.insertBlob(key.data(), key.size(), blob.get(), size);
+                if constexpr (!UTILS_HAS_THREADING) {
+                    // no writer thread without threads support (e.g. single-threaded WASM)
+                    platform.insertBlob(key.data(), key.size(), blob.get(), size);
+                    mWrites.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                // Platform::insertBlob() typically hits the disk, so we hand it to our writer
+                // thread rather than delaying the caller (often the driver thread).
+                std::unique_lock const lock(mLock);
+                if (UTILS_UNLIKELY(mExitRequested)) {
+                    return;
+                }
+                if (UTILS_UNLIKELY(!mWriterThread.joinable())) {
+                    mWriterThread = std::thread(&OpenGLBlobCache::writerLoop, this);
+                }
+                mPendingWrites.push_back({ &platform, key, std::move(blob), size });
+                mCondition.notify_one();
             }
         }
     }
 #endif
 }
 
+void OpenGLBlobCache::writerLoop() noexcept {
+    JobSystem::setThreadName("OpenGLBlobCache");
+    JobSystem::setThreadPriority(JobSystem::Priority::BACKGROUND);
+
+    std::vector<PendingWrite> batch;
+    std::unique_lock lock(mLock);
+    while (true) {
+        mCondition.wait(lock, [this]() {
+            return mExitRequested || !mPendingWrites.empty();
+        });
+        if (mPendingWrites.empty()) {
+            // we only get here if exit was requested and everything was written
+            break;
+        }
+        // take everything that's been queued so far and write it without holding the lock
+        std::swap(batch, mPendingWrites);
+        lock.unlock();
+        for (auto const& item : batch) {
+            SYSTRACE_NAME("insertBlob");
+            item.platform->insertBlob(item.key.data(), item.key.size(),
+                    item.blob.get(), item.size);
+        }
+        mWrites.fetch_add(uint32_t(batch.size()), std::memory_order_relaxed);
+        batch.clear();
+        lock.lock();
+    }
+}
+
+void OpenGLBlobCache::terminate() noexcept {
+    { // scope for lock
+        std::unique_lock const lock(mLock);
+        mExitRequested = true;
+        mCondition.notify_one();
+    }
+    if (mWriterThread.joinable()) {
+        // this flushes all pending writes
+        mWriterThread.join();
+    }
+}
+
+OpenGLBlobCache::Stats OpenGLBlobCache::getStats() const noexcept {
+    return {
+            .hits = mHits.load(std::memory_order_relaxed),
+            .misses = mMisses.load(std::memory_order_relaxed),
+            .stale = mStale.load(std::memory_order_relaxed),
+            .failures = mFailures.load(std::memory_order_relaxed),
+            .writes = mWrites.load(std::memory_order_relaxed),
+    };
+}
+
 } // namespace filament::backend
@@ -21,6 +21,16 @@
 
 #include "BlobCacheKey.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
 namespace filament::backend {
 
 class Platform;
@@ -29,17 +39,60 @@ class OpenGLContext;
 
 class OpenGLBlobCache {
 public:
+    struct Stats {
+        uint32_t hits;      // programs loaded from the cache
+        uint32_t misses;    // programs not found in the cache
+        uint32_t stale;     // programs found but produced by a different driver
+        uint32_t failures;  // programs rejected by glProgramBinary
+        uint32_t writes;    // programs written to the cache
+    };
+
     explicit OpenGLBlobCache(OpenGLContext& gl) noexcept;
 
+    ~OpenGLBlobCache() noexcept;
+
     GLuint retrieve(BlobCacheKey* key, Platform& platform,
             Program const& program) const noexcept;
 
+    // Reads back the program binary and queues it for writing. The actual Platform::insertBlob()
+    // call happens later on a background thread, in batches.
     void insert(Platform& platform,
             BlobCacheKey const& key, GLuint program) noexcept;
 
+    // Writes all pending blobs and stops the writer thread.
+    void terminate() noexcept;
+
+    Stats getStats() const noexcept;
+
 private:
     struct Blob;
+    using BlobPtr = std::unique_ptr<Blob, decltype(&::free)>;
+
+    struct PendingWrite {
+        Platform* platform;
+        BlobCacheKey key;
+        BlobPtr blob;
+        size_t size;
+    };
+
+    void writerLoop() noexcept;
+
     bool mCachingSupported = false;
+
+    // identifies the GL driver that produced the binaries, stored with each blob
+    uint32_t mDriverHash = 0;
+
+    std::mutex mLock;
+    std::condition_variable mCondition;
+    std::vector<PendingWrite> mPendingWrites;
+    std::thread mWriterThread;
+    bool mExitRequested = false;
+
+    mutable std::atomic<uint32_t> mHits{};
+    mutable std::atomic<uint32_t> mMisses{};
+    mutable std::atomic<uint32_t> mStale{};
+    mutable std::atomic<uint32_t> mFailures{};
+    std::atomic<uint32_t> mWrites{};
 };
 
 } // namespace filament::backend
@@ -702,6 +702,9 @@ void OpenGLContext::initExtensionsGLES(Extensions* ext, GLint major, GLint minor
     // figure out and initialize the extensions we need
     using namespace std::literals;
     ext->APPLE_color_buffer_packed_float = exts.has("GL_APPLE_color_buffer_packed_float"sv);
+#if !defined(__EMSCRIPTEN__) && defined(GL_EXT_buffer_storage)
+    ext->EXT_buffer_storage = exts.has("GL_EXT_buffer_storage"sv);
+#endif
 #ifndef __EMSCRIPTEN__
     ext->EXT_clip_control = exts.has("GL_EXT_clip_control"sv);
 #endif
@@ -715,6 +718,11 @@ void OpenGLContext::initExtensionsGLES(Extensions* ext, GLint major, GLint minor
     ext->EXT_discard_framebuffer = exts.has("GL_EXT_discard_framebuffer"sv);
 #ifndef __EMSCRIPTEN__
     ext->EXT_disjoint_timer_query = exts.has("GL_EXT_disjoint_timer_query"sv);
+#endif
+#if !defined(__EMSCRIPTEN__) && defined(GL_EXT_multi_draw_arrays)
+    ext->EXT_multi_draw_arrays = exts.has("GL_EXT_multi_draw_arrays"sv);
+#endif
+#ifndef __EMSCRIPTEN__
     ext->EXT_multisampled_render_to_texture = exts.has("GL_EXT_multisampled_render_to_texture"sv);
     ext->EXT_multisampled_render_to_texture2 = exts.has("GL_EXT_multisampled_render_to_texture2"sv);
     ext->EXT_protected_textures = exts.has("GL_EXT_protected_textures"sv);
@@ -778,6 +786,7 @@ void OpenGLContext::initExtensionsGL(Extensions* ext, GLint major, GLint minor)
     using namespace std::literals;
     ext->APPLE_color_buffer_packed_float = true;  // Assumes core profile.
     ext->ARB_shading_language_packing = exts.has("GL_ARB_shading_language_packing"sv);
+    ext->EXT_buffer_storage = exts.has("GL_ARB_buffer_storage"sv);
     ext->EXT_color_buffer_float = true;  // Assumes core profile.
     ext->EXT_color_buffer_half_float = true;  // Assumes core profile.
     ext->EXT_clip_cull_distance = true;
@@ -785,6 +794,7 @@ void OpenGLContext::initExtensionsGL(Extensions* ext, GLint major, GLint minor)
     ext->EXT_depth_clamp = true;
     ext->EXT_discard_framebuffer = false;
     ext->EXT_disjoint_timer_query = true;
+    ext->EXT_multi_draw_arrays = true;  // Core since OpenGL 1.4.
     ext->EXT_multisampled_render_to_texture = false;
     ext->EXT_multisampled_render_to_texture2 = false;
     ext->EXT_shader_framebuffer_fetch = exts.has("GL_EXT_shader_framebuffer_fetch"sv);
@@ -821,6 +831,10 @@ void OpenGLContext::initExtensionsGL(Extensions* ext, GLint major, GLint minor)
         ext->EXT_discard_framebuffer = true;
         ext->KHR_debug = true;
     }
+    // OpenGL 4.4 implies ARB_buffer_storage
+    if (major > 4 || (major == 4 && minor >= 4)) {
+        ext->EXT_buffer_storage = true;
+    }
     // OpenGL 4.5 implies EXT_clip_control
     if (major > 4 || (major == 4 && minor >= 5)) {
         ext->EXT_clip_control = true;
@@ -880,8 +894,10 @@ void OpenGLContext::bindBuffer(GLenum target, GLuint buffer) noexcept {
         // GL_ELEMENT_ARRAY_BUFFER is a special case, where the currently bound VAO remembers
         // the index buffer, unless there are no VAO bound (see: bindVertexArray)
         assert_invariant(state.vao.p);
-        if (state.buffers.genericBinding[targetIndex] != buffer
-            || ((state.vao.p != &mDefaultVAO) && (state.vao.p->elementArray != buffer))) {
+        bool const changed = state.buffers.genericBinding[targetIndex] != buffer
+            || ((state.vao.p != &mDefaultVAO) && (state.vao.p->elementArray != buffer));
+        countStateChange(changed);
+        if (changed) {
             state.buffers.genericBinding[targetIndex] = buffer;
             if (state.vao.p != &mDefaultVAO) {
                 state.vao.p->elementArray = buffer;
@@ -223,6 +223,7 @@ public:
     struct Extensions {
         bool APPLE_color_buffer_packed_float;
         bool ARB_shading_language_packing;
+        bool EXT_buffer_storage;
         bool EXT_clip_control;
         bool EXT_clip_cull_distance;
         bool EXT_color_buffer_float;
@@ -231,6 +232,7 @@ public:
         bool EXT_depth_clamp;
         bool EXT_discard_framebuffer;
         bool EXT_disjoint_timer_query;
+        bool EXT_multi_draw_arrays;
         bool EXT_multisampled_render_to_texture2;
         bool EXT_multisampled_render_to_texture;
         bool EXT_protected_textures;
@@ -468,6 +470,15 @@ public:
         uint8_t age = 0;
     } state;
 
+    // Number of shadowed state changes that were issued to GL or skipped because they were
+    // redundant, since the last resetStateChangeStats().
+    struct StateChangeStats {
+        uint32_t issued = 0;
+        uint32_t skipped = 0;
+    };
+    StateChangeStats getStateChangeStats() const noexcept { return mStateChangeStats; }
+    void resetStateChangeStats() noexcept { mStateChangeStats = {}; }
+
     struct Procs {
         void (* bindVertexArray)(GLuint array);
         void (* deleteVertexArrays)(GLsizei n, const GLuint* arrays);
@@ -604,9 +615,21 @@ private:
             Gets const& gets,
             Bugs const& bugs) noexcept;
 
+    StateChangeStats mStateChangeStats;
+
+    void countStateChange(bool const issued) noexcept {
+        if (issued) {
+            mStateChangeStats.issued++;
+        } else {
+            mStateChangeStats.skipped++;
+        }
+    }
+
     template <typename T, typename F>
-    static inline void update_state(T& state, T const& expected, F functor, bool force = false) noexcept {
-        if (UTILS_UNLIKELY(force || state != expected)) {
+    inline void update_state(T& state, T const& expected, F functor, bool force = false) noexcept {
+        bool const changed = force || state != expected;
+        countStateChange(changed);
+        if (UTILS_UNLIKELY(changed)) {
             state = expected;
             functor();
         }
@@ -753,9 +776,11 @@ void OpenGLContext::bindBufferRange(GLenum target, GLuint index, GLuint buffer,
     size_t const targetIndex = getIndexForBufferTarget(target);
     // this ALSO sets the generic binding
     assert_invariant(targetIndex < sizeof(state.buffers.targets) / sizeof(*state.buffers.targets));
-    if (   state.buffers.targets[targetIndex].buffers[index].name != buffer
+    bool const changed = state.buffers.targets[targetIndex].buffers[index].name != buffer
            || state.buffers.targets[targetIndex].buffers[index].offset != offset
-           || state.buffers.targets[targetIndex].buffers[index].size != size) {
+           || state.buffers.targets[targetIndex].buffers[index].size != size;
+    countStateChange(changed);
+    if (changed) {
         state.buffers.targets[targetIndex].buffers[index].name = buffer;
         state.buffers.targets[targetIndex].buffers[index].offset = offset;
         state.buffers.targets[targetIndex].buffers[index].size = size;
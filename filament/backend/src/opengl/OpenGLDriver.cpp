@@ -96,6 +96,14 @@
 #define HAS_MAPBUFFERS 1
 #endif
 
+// In WebGL each glBufferSubData() crosses the WASM/JS boundary, so uniform buffer updates are
+// accumulated on the CPU and uploaded once per buffer before they're needed.
+#if defined(__EMSCRIPTEN__)
+#define COALESCE_UNIFORM_UPDATES 1
+#else
+#define COALESCE_UNIFORM_UPDATES 0
+#endif
+
 #define DEBUG_GROUP_MARKER_NONE       0x00    // no debug marker
 #define DEBUG_GROUP_MARKER_OPENGL     0x01    // markers in the gl command queue (req. driver support)
 #define DEBUG_GROUP_MARKER_BACKEND    0x02    // markers on the backend side (systrace)
@@ -314,6 +322,11 @@ Dispatcher OpenGLDriver::getDispatcher() const noexcept {
             OpenGLDriver& concreteDriver = static_cast<OpenGLDriver&>(driver);
             Cmd::execute(&OpenGLDriver::draw2GLES2, concreteDriver, base, next);
         };
+        dispatcher.multiDraw2_ = +[](Driver& driver, CommandBase* base, intptr_t* next){
+            using Cmd = COMMAND_TYPE(multiDraw2);
+            OpenGLDriver& concreteDriver = static_cast<OpenGLDriver&>(driver);
+            Cmd::execute(&OpenGLDriver::multiDraw2GLES2, concreteDriver, base, next);
+        };
     }
     return dispatcher;
 }
@@ -342,6 +355,13 @@ void OpenGLDriver::terminate() {
 
     // because we called glFinish(), all callbacks should have been executed
     assert_invariant(mGpuCommandCompleteOps.empty());
+
+    for (auto* pool : { &mReadPixelsPbos, &mTextureUploadPbos }) {
+        for (Pbo const& pbo : *pool) {
+            glDeleteBuffers(1, &pbo.id);
+        }
+        pool->clear();
+    }
 #endif
 
     delete mCurrentPushConstants;
@@ -575,6 +595,10 @@ Handle<HwProgram> OpenGLDriver::createProgramS() noexcept {
     return initHandle<OpenGLProgram>();
 }
 
+Handle<HwPipelineState> OpenGLDriver::createPipelineStateS() noexcept {
+    return initHandle<HwPipelineState>();
+}
+
 Handle<HwTexture> OpenGLDriver::createTextureS() noexcept {
     return initHandle<GLTexture>();
 }
@@ -662,6 +686,7 @@ void OpenGLDriver::createIndexBufferR(
     auto& gl = mContext;
     uint8_t const elementSize = static_cast<uint8_t>(getElementTypeSize(elementType));
     GLIndexBuffer* ib = construct<GLIndexBuffer>(ibh, elementSize, indexCount);
+    ib->usage = usage;
     glGenBuffers(1, &ib->gl.buffer);
     GLsizeiptr const size = elementSize * indexCount;
     gl.bindVertexArray(nullptr);
@@ -689,12 +714,110 @@ void OpenGLDriver::createBufferObjectR(Handle<HwBufferObject> boh,
         bo->gl.binding = getBufferBindingType(bindingType);
         glGenBuffers(1, &bo->gl.id);
         gl.bindBuffer(bo->gl.binding, bo->gl.id);
+#ifndef FILAMENT_SILENCE_NOT_SUPPORTED_BY_ES2
+        if (createStreamingStorage(bo)) {
+            CHECK_GL_ERROR(utils::slog.e)
+            return;
+        }
+#endif
         glBufferData(bo->gl.binding, byteCount, nullptr, getBufferUsage(usage));
+        if (COALESCE_UNIFORM_UPDATES && bindingType == BufferObjectBinding::UNIFORM) {
+            // the shadow must always mirror the buffer, since we upload ranges that can
+            // include bytes that weren't updated
+            bo->shadow = (uint8_t*)calloc(byteCount, 1);
+        }
     }
 
     CHECK_GL_ERROR(utils::slog.e)
 }
 
+#ifndef FILAMENT_SILENCE_NOT_SUPPORTED_BY_ES2
+bool OpenGLDriver::createStreamingStorage(GLBufferObject* bo) noexcept {
+    auto& gl = mContext;
+    if (!HAS_MAPBUFFERS || !gl.ext.EXT_buffer_storage || gl.isES2() ||
+            bo->bindingType != BufferObjectBinding::UNIFORM ||
+            bo->usage != BufferUsage::DYNAMIC) {
+        return false;
+    }
+
+#if defined(BACKEND_OPENGL_VERSION_GL) || defined(GL_EXT_buffer_storage)
+    uint32_t const alignment = uint32_t(gl.gets.uniform_buffer_offset_alignment);
+    uint32_t const regionSize = (bo->byteCount + alignment - 1) / alignment * alignment;
+    GLsizeiptr const size = GLsizeiptr(regionSize) * GLStreamingStorage::REGION_COUNT;
+
+    // the buffer must already be bound and not have any data store
+#   if defined(BACKEND_OPENGL_VERSION_GL)
+    glBufferStorage(bo->gl.binding, size, nullptr,
+            GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT |
+            GL_DYNAMIC_STORAGE_BIT);
+    void* const vaddr = glMapBufferRange(bo->gl.binding, 0, size,
+            GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+#   else
+    glBufferStorageEXT(bo->gl.binding, size, nullptr,
+            GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT_EXT | GL_MAP_COHERENT_BIT_EXT |
+            GL_DYNAMIC_STORAGE_BIT_EXT);
+    void* const vaddr = glMapBufferRange(bo->gl.binding, 0, size,
+            GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT_EXT | GL_MAP_COHERENT_BIT_EXT);
+#   endif
+
+    if (UTILS_UNLIKELY(!vaddr)) {
+        // The storage is immutable, so we need a new buffer name to fall back to glBufferData().
+        gl.deleteBuffer(bo->gl.id, bo->gl.binding);
+        glGenBuffers(1, &bo->gl.id);
+        gl.bindBuffer(bo->gl.binding, bo->gl.id);
+        return false;
+    }
+
+    bo->streaming = new GLStreamingStorage{
+            .vaddr = static_cast<uint8_t*>(vaddr),
+            .regionSize = regionSize };
+    bo->streamingOffset = 0;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool OpenGLDriver::acquireStreamingRegion(GLBufferObject* bo) noexcept {
+    GLStreamingStorage& s = *bo->streaming;
+    size_t const next = (s.current + 1) % GLStreamingStorage::REGION_COUNT;
+    if (GLsync const fence = s.fences[next]) {
+        // Normally the next region was last used a couple of frames ago and its fence has
+        // signaled. If it hasn't (e.g. several updates in the same frame) we don't wait,
+        // and the caller keeps using the current region with synchronized updates instead.
+        GLenum const status = glClientWaitSync(fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            s.synchronized = true;
+            return false;
+        }
+        glDeleteSync(fence);
+        s.fences[next] = nullptr;
+    }
+
+    // the region we're leaving can be used by all the commands issued so far
+    s.fences[s.current] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    s.current = uint8_t(next);
+    s.synchronized = false;
+    bo->streamingOffset = uint32_t(next * s.regionSize);
+
+    // descriptor sets referencing this buffer must be re-bound to pick up the new offset
+    mInvalidDescriptorSetBindings.setValue((1 << MAX_DESCRIPTOR_SET_COUNT) - 1);
+    return true;
+}
+
+void OpenGLDriver::destroyStreamingStorage(GLBufferObject* bo) noexcept {
+    GLStreamingStorage* const s = bo->streaming;
+    for (GLsync const fence : s->fences) {
+        if (fence) {
+            glDeleteSync(fence);
+        }
+    }
+    // the mapping is released when the buffer is deleted
+    delete s;
+    bo->streaming = nullptr;
+}
+#endif
+
 void OpenGLDriver::createRenderPrimitiveR(Handle<HwRenderPrimitive> rph,
         Handle<HwVertexBuffer> vbh, Handle<HwIndexBuffer> ibh,
         PrimitiveType pt) {
@@ -732,6 +855,12 @@ void OpenGLDriver::createRenderPrimitiveR(Handle<HwRenderPrimitive> rph,
     CHECK_GL_ERROR(utils::slog.e)
 }
 
+void OpenGLDriver::createPipelineStateR(Handle<HwPipelineState> psh,
+        PipelineState const& state) {
+    DEBUG_MARKER()
+    construct<HwPipelineState>(psh, state);
+}
+
 void OpenGLDriver::createProgramR(Handle<HwProgram> ph, Program&& program) {
     DEBUG_MARKER()
 
@@ -1863,10 +1992,22 @@ void OpenGLDriver::destroyBufferObject(Handle<HwBufferObject> boh) {
     DEBUG_MARKER()
     if (boh) {
         auto& gl = mContext;
-        GLBufferObject const* bo = handle_cast<const GLBufferObject*>(boh);
+        GLBufferObject* bo = handle_cast<GLBufferObject*>(boh);
         if (UTILS_UNLIKELY(bo->bindingType == BufferObjectBinding::UNIFORM && gl.isES2())) {
             free(bo->gl.buffer);
         } else {
+#ifndef FILAMENT_SILENCE_NOT_SUPPORTED_BY_ES2
+            if (bo->streaming) {
+                destroyStreamingStorage(bo);
+            }
+#endif
+            if (UTILS_UNLIKELY(bo->shadow)) {
+                if (bo->dirtyBegin != bo->dirtyEnd) {
+                    auto& dirty = mDirtyUniformBuffers;
+                    dirty.erase(std::find(dirty.begin(), dirty.end(), bo));
+                }
+                free(bo->shadow);
+            }
             gl.deleteBuffer(bo->gl.id, bo->gl.binding);
         }
         destruct(boh, bo);
@@ -1905,6 +2046,14 @@ void OpenGLDriver::destroyProgram(Handle<HwProgram> ph) {
     }
 }
 
+void OpenGLDriver::destroyPipelineState(Handle<HwPipelineState> psh) {
+    DEBUG_MARKER()
+    if (psh) {
+        HwPipelineState const* ps = handle_cast<HwPipelineState const*>(psh);
+        destruct(psh, ps);
+    }
+}
+
 void OpenGLDriver::destroyTexture(Handle<HwTexture> th) {
     DEBUG_MARKER()
 
@@ -2422,6 +2571,11 @@ bool OpenGLDriver::isDepthClampSupported() {
     return getContext().ext.EXT_depth_clamp;
 }
 
+MemoryBudget OpenGLDriver::getMemoryBudget() {
+    // GL doesn't report memory usage in a portable way
+    return {};
+}
+
 bool OpenGLDriver::isWorkaroundNeeded(Workaround workaround) {
     switch (workaround) {
         case Workaround::SPLIT_EASU:
@@ -2480,6 +2634,11 @@ size_t OpenGLDriver::getMaxArrayTextureLayers() {
     return mContext.gets.max_array_texture_layers;
 }
 
+math::uint3 OpenGLDriver::getSparseTexturePageSize(SamplerType, TextureFormat) {
+    // GL_EXT_sparse_texture is not supported
+    return {};
+}
+
 // ------------------------------------------------------------------------------------------------
 // Swap chains
 // ------------------------------------------------------------------------------------------------
@@ -2570,7 +2729,14 @@ void OpenGLDriver::updateIndexBuffer(
 
     gl.bindVertexArray(nullptr);
     gl.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, ib->gl.buffer);
-    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, byteOffset, (GLsizeiptr)p.size, p.buffer);
+    if (byteOffset == 0 && p.size == size_t(ib->elementSize) * ib->count) {
+        // Respecifying the whole storage lets the driver orphan the previous one instead of
+        // waiting for (or making a copy of) the indices still used by the GPU.
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)p.size, p.buffer,
+                getBufferUsage(ib->usage));
+    } else {
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, byteOffset, (GLsizeiptr)p.size, p.buffer);
+    }
 
     scheduleDestroy(std::move(p));
 
@@ -2639,6 +2805,20 @@ void OpenGLDriver::updateBufferObject(
         assert_invariant(bo->gl.buffer);
         memcpy(static_cast<uint8_t*>(bo->gl.buffer) + byteOffset, bd.buffer, bd.size);
         bo->age++;
+    } else if (COALESCE_UNIFORM_UPDATES && bo->shadow) {
+        updateUniformShadow(bo, bd.buffer, bd.size, byteOffset);
+    } else if (bo->streaming) {
+#ifndef FILAMENT_SILENCE_NOT_SUPPORTED_BY_ES2
+        // A full update goes to the next region if the GPU is done with it. Partial updates
+        // must preserve the rest of the buffer, so they're made in place by the driver.
+        if (byteOffset == 0 && bd.size == bo->byteCount && acquireStreamingRegion(bo)) {
+            memcpy(bo->streaming->vaddr + bo->streamingOffset, bd.buffer, bd.size);
+        } else {
+            gl.bindBuffer(bo->gl.binding, bo->gl.id);
+            glBufferSubData(bo->gl.binding, bo->streamingOffset + byteOffset,
+                    (GLsizeiptr)bd.size, bd.buffer);
+        }
+#endif
     } else {
         assert_invariant(bo->gl.id);
         gl.bindBuffer(bo->gl.binding, bo->gl.id);
@@ -2657,6 +2837,40 @@ void OpenGLDriver::updateBufferObject(
     CHECK_GL_ERROR(utils::slog.e)
 }
 
+void OpenGLDriver::updateUniformShadow(GLBufferObject* bo,
+        void const* data, uint32_t size, uint32_t byteOffset) noexcept {
+    memcpy(bo->shadow + byteOffset, data, size);
+    if (bo->dirtyBegin == bo->dirtyEnd) {
+        mDirtyUniformBuffers.push_back(bo);
+        bo->dirtyBegin = byteOffset;
+        bo->dirtyEnd = byteOffset + size;
+    } else {
+        // The shadow mirrors the whole buffer, so we can always merge into a single range,
+        // even if the updates are disjoint. A few extra bytes are much cheaper than an extra
+        // glBufferSubData() call.
+        bo->dirtyBegin = std::min(bo->dirtyBegin, byteOffset);
+        bo->dirtyEnd = std::max(bo->dirtyEnd, byteOffset + size);
+    }
+}
+
+void OpenGLDriver::flushUniformUpdates() noexcept {
+    SYSTRACE_CALL();
+    auto& gl = mContext;
+    for (GLBufferObject* const bo : mDirtyUniformBuffers) {
+        gl.bindBuffer(bo->gl.binding, bo->gl.id);
+        if (bo->dirtyBegin == 0 && bo->dirtyEnd == bo->byteCount) {
+            glBufferData(bo->gl.binding, (GLsizeiptr)bo->byteCount, bo->shadow,
+                    getBufferUsage(bo->usage));
+        } else {
+            glBufferSubData(bo->gl.binding, bo->dirtyBegin,
+                    (GLsizeiptr)(bo->dirtyEnd - bo->dirtyBegin), bo->shadow + bo->dirtyBegin);
+        }
+        bo->dirtyBegin = bo->dirtyEnd = 0;
+    }
+    mDirtyUniformBuffers.clear();
+    CHECK_GL_ERROR(utils::slog.e)
+}
+
 void OpenGLDriver::updateBufferObjectUnsynchronized(
         Handle<HwBufferObject> boh, BufferDescriptor&& bd, uint32_t byteOffset) {
     DEBUG_MARKER()
@@ -2678,6 +2892,18 @@ void OpenGLDriver::updateBufferObjectUnsynchronized(
         if (bo->gl.binding != GL_UNIFORM_BUFFER) {
             // TODO: use updateBuffer() for all types of buffer? Make sure GL supports that.
             updateBufferObject(boh, std::move(bd), byteOffset);
+        } else if (bo->streaming) {
+            if (UTILS_LIKELY(!bo->streaming->synchronized)) {
+                // the storage is coherent, the data is visible to the next commands
+                memcpy(bo->streaming->vaddr + bo->streamingOffset + byteOffset,
+                        bd.buffer, bd.size);
+            } else {
+                // resetBufferObject() couldn't get a free region, the GPU may be reading this one
+                mContext.bindBuffer(bo->gl.binding, bo->gl.id);
+                glBufferSubData(bo->gl.binding, bo->streamingOffset + byteOffset,
+                        (GLsizeiptr)bd.size, bd.buffer);
+            }
+            scheduleDestroy(std::move(bd));
         } else {
             auto& gl = mContext;
             gl.bindBuffer(bo->gl.binding, bo->gl.id);
@@ -2713,6 +2939,11 @@ void OpenGLDriver::resetBufferObject(Handle<HwBufferObject> boh) {
 
     if (UTILS_UNLIKELY(bo->bindingType == BufferObjectBinding::UNIFORM && gl.isES2())) {
         // nothing to do here
+    } else if (bo->streaming) {
+#ifndef FILAMENT_SILENCE_NOT_SUPPORTED_BY_ES2
+        // moving to the next region replaces orphaning, immutable storage can't be reallocated
+        acquireStreamingRegion(bo);
+#endif
     } else {
         assert_invariant(bo->gl.id);
         gl.bindBuffer(bo->gl.binding, bo->gl.id);
@@ -2754,6 +2985,11 @@ void OpenGLDriver::generateMipmaps(Handle<HwTexture> th) {
     CHECK_GL_ERROR(utils::slog.e)
 }
 
+void OpenGLDriver::commitTexturePages(Handle<HwTexture>, uint32_t, uint32_t, uint32_t, uint32_t,
+        uint32_t, bool) {
+    // sparse textures are not supported, see getSparseTexturePageSize()
+}
+
 void OpenGLDriver::setTextureData(GLTexture const* t, uint32_t level,
         uint32_t xoffset, uint32_t yoffset, uint32_t zoffset,
         uint32_t width, uint32_t height, uint32_t depth,
@@ -2794,9 +3030,39 @@ void OpenGLDriver::setTextureData(GLTexture const* t, uint32_t level,
     size_t const bpp = PBD::computeDataSize(p.format, p.type, 1, 1, 1);
     size_t const bpr = PBD::computeDataSize(p.format, p.type, stride, 1, p.alignment);
     size_t const bpl = bpr * height; // TODO: PBD should have a "layer stride"
-    void const* const buffer = static_cast<char const*>(p.buffer)
+    void const* buffer = static_cast<char const*>(p.buffer)
             + bpp* p.left + bpr * p.top + bpl * 0; // TODO: PBD should have a p.depth
 
+#if HAS_MAPBUFFERS && !defined(FILAMENT_SILENCE_NOT_SUPPORTED_BY_ES2)
+    // Large uploads are staged in a pixel unpack buffer, so that glTexSubImage*() doesn't have
+    // to copy (or wait on) client memory synchronously and the driver can DMA asynchronously.
+    // All the layers and faces use the same stride, so their data is copied as is.
+    Pbo pbo{};
+    size_t const dataOffset = bpp * p.left + bpr * p.top;
+    size_t const dataSize = bpl * depth;
+    if (!gl.isES2() && dataSize >= TEXTURE_UPLOAD_PBO_MIN_SIZE &&
+            dataOffset + dataSize <= p.size) {
+        pbo = acquirePbo(mTextureUploadPbos,
+                GL_PIXEL_UNPACK_BUFFER, GL_STREAM_DRAW, GLsizeiptr(dataSize));
+        gl.bindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo.id);
+        // the PBO is only returned to the pool once the GPU is done with it, so we don't
+        // need to synchronize
+        void* const vaddr = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, GLsizeiptr(dataSize),
+                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (UTILS_LIKELY(vaddr)) {
+            memcpy(vaddr, buffer, dataSize);
+        }
+        if (UTILS_LIKELY(vaddr && glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE)) {
+            // with a pixel unpack buffer bound, the "pointer" is an offset into it
+            buffer = nullptr;
+        } else {
+            gl.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            releasePbo(mTextureUploadPbos, pbo);
+            pbo.id = 0;
+        }
+    }
+#endif
+
     switch (t->target) {
         case SamplerType::SAMPLER_EXTERNAL:
             // if we get there, it's because the user is trying to use an external texture,
@@ -2858,6 +3124,15 @@ void OpenGLDriver::setTextureData(GLTexture const* t, uint32_t level,
         }
     }
 
+#if HAS_MAPBUFFERS && !defined(FILAMENT_SILENCE_NOT_SUPPORTED_BY_ES2)
+    if (pbo.id) {
+        gl.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        whenGpuCommandsComplete([this, pbo]() {
+            releasePbo(mTextureUploadPbos, pbo);
+        });
+    }
+#endif
+
     scheduleDestroy(std::move(p));
 
     CHECK_GL_ERROR(utils::slog.e)
@@ -3075,6 +3350,11 @@ void OpenGLDriver::compilePrograms(CompilerPriorityQueue,
     }
 }
 
+void OpenGLDriver::prewarmPipeline(Handle<HwRenderTarget>, const RenderPassParams&,
+        PipelineState const&) {
+    // there are no pipeline objects in GL, programs are compiled with compilePrograms()
+}
+
 void OpenGLDriver::beginRenderPass(Handle<HwRenderTarget> rth,
         const RenderPassParams& params) {
     DEBUG_MARKER()
@@ -3453,10 +3733,8 @@ void OpenGLDriver::readPixels(Handle<HwRenderTarget> src,
     // which we're always emulating. So if we have a resolved fbo (fbo_read), use that instead.
     gl.bindFramebuffer(GL_READ_FRAMEBUFFER, s->gl.fbo_read ? s->gl.fbo_read : s->gl.fbo);
 
-    GLuint pbo;
-    glGenBuffers(1, &pbo);
-    gl.bindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
-    glBufferData(GL_PIXEL_PACK_BUFFER, pboSize, nullptr, GL_STATIC_DRAW);
+    Pbo const pbo = acquirePbo(mReadPixelsPbos, GL_PIXEL_PACK_BUFFER, GL_STREAM_READ, pboSize);
+    gl.bindBuffer(GL_PIXEL_PACK_BUFFER, pbo.id);
     glReadPixels(GLint(x), GLint(y), GLint(width), GLint(height), glFormat, glType, nullptr);
     gl.bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
     CHECK_GL_ERROR(utils::slog.e)
@@ -3467,7 +3745,7 @@ void OpenGLDriver::readPixels(Handle<HwRenderTarget> src,
     whenGpuCommandsComplete([this, width, height, pbo, pboSize, pUserBuffer]() mutable {
         PixelBufferDescriptor& p = *pUserBuffer;
         auto& gl = mContext;
-        gl.bindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+        gl.bindBuffer(GL_PIXEL_PACK_BUFFER, pbo.id);
         void* vaddr = nullptr;
 #if defined(__EMSCRIPTEN__)
         std::unique_ptr<uint8_t[]> clientBuffer = std::make_unique<uint8_t[]>(pboSize);
@@ -3496,7 +3774,7 @@ void OpenGLDriver::readPixels(Handle<HwRenderTarget> src,
 #endif
         }
         gl.bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-        glDeleteBuffers(1, &pbo);
+        releasePbo(mReadPixelsPbos, pbo);
         scheduleDestroy(std::move(p));
         delete pUserBuffer;
         CHECK_GL_ERROR(utils::slog.e)
@@ -3504,6 +3782,49 @@ void OpenGLDriver::readPixels(Handle<HwRenderTarget> src,
 #endif
 }
 
+#ifndef FILAMENT_SILENCE_NOT_SUPPORTED_BY_ES2
+OpenGLDriver::Pbo OpenGLDriver::acquirePbo(std::vector<Pbo>& pool,
+        GLenum const target, GLenum const usage, GLsizeiptr const size) noexcept {
+    // Reading back or uploading every frame is common (e.g. video capture or playback), and
+    // always with the same size, so we reuse the smallest pixel buffer that's large enough
+    // rather than allocating one per call.
+    auto best = pool.end();
+    for (auto it = pool.begin(); it != pool.end(); ++it) {
+        if (it->size >= size && (best == pool.end() || it->size < best->size)) {
+            best = it;
+        }
+    }
+    if (best != pool.end()) {
+        Pbo const pbo = *best;
+        pool.erase(best);
+        return pbo;
+    }
+
+    Pbo pbo{ 0, size };
+    glGenBuffers(1, &pbo.id);
+    mContext.bindBuffer(target, pbo.id);
+    glBufferData(target, size, nullptr, usage);
+    return pbo;
+}
+
+void OpenGLDriver::releasePbo(std::vector<Pbo>& pool, Pbo const pbo) noexcept {
+    if (pool.size() == MAX_POOLED_PBO_COUNT) {
+        // evict the smallest buffer, the larger ones can serve any request
+        auto const smallest = std::min_element(pool.begin(), pool.end(),
+                [](Pbo const& lhs, Pbo const& rhs) {
+                    return lhs.size < rhs.size;
+                });
+        if (smallest->size >= pbo.size) {
+            glDeleteBuffers(1, &pbo.id);
+            return;
+        }
+        glDeleteBuffers(1, &smallest->id);
+        pool.erase(smallest);
+    }
+    pool.push_back(pbo);
+}
+#endif
+
 void OpenGLDriver::readBufferSubData(BufferObjectHandle boh,
         uint32_t offset, uint32_t size, BufferDescriptor&& p) {
     UTILS_UNUSED_IN_RELEASE auto& gl = mContext;
@@ -3512,50 +3833,42 @@ void OpenGLDriver::readBufferSubData(BufferObjectHandle boh,
 #ifndef FILAMENT_SILENCE_NOT_SUPPORTED_BY_ES2
     GLBufferObject const* bo = handle_cast<GLBufferObject const*>(boh);
 
-    // TODO: measure the two solutions
-    if constexpr (true) {
-        // schedule a copy of the buffer we're reading into a PBO, this *should* happen
-        // asynchronously without stalling the CPU.
-        GLuint pbo;
-        glGenBuffers(1, &pbo);
-        gl.bindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
-        glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)size, nullptr, GL_STATIC_DRAW);
-        gl.bindBuffer(bo->gl.binding, bo->gl.id);
-        glCopyBufferSubData(bo->gl.binding, GL_PIXEL_PACK_BUFFER, offset, 0, size);
-        gl.bindBuffer(bo->gl.binding, 0);
-        gl.bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-        CHECK_GL_ERROR(utils::slog.e)
+    if (COALESCE_UNIFORM_UPDATES && UTILS_UNLIKELY(!mDirtyUniformBuffers.empty())) {
+        flushUniformUpdates();
+    }
 
-        // then, we schedule a mapBuffer of the PBO later, once the fence has signaled
-        auto* pUserBuffer = new BufferDescriptor(std::move(p));
-        whenGpuCommandsComplete([this, size, pbo, pUserBuffer]() mutable {
-            BufferDescriptor& p = *pUserBuffer;
-            auto& gl = mContext;
-            gl.bindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
-            void* vaddr = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
-            if (vaddr) {
-                memcpy(p.buffer, vaddr, size);
-                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
-            }
-            gl.bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-            glDeleteBuffers(1, &pbo);
-            scheduleDestroy(std::move(p));
-            delete pUserBuffer;
-            CHECK_GL_ERROR(utils::slog.e)
-        });
-    } else {
-        gl.bindBuffer(bo->gl.binding, bo->gl.id);
-        // TODO: this glMapBufferRange may stall. Ideally we want to use whenGpuCommandsComplete
-        //       but that's tricky because boh could be destroyed right after this call.
-        void* vaddr = glMapBufferRange(bo->gl.binding, offset, size, GL_MAP_READ_BIT);
+    // Mapping the buffer right away would stall until the GPU is done writing it. Instead, we
+    // schedule a copy into a PBO, which happens asynchronously, and map the PBO once a fence
+    // tells us the copy completed (the fence is polled in tick()). Going through a PBO also
+    // makes this safe if boh is destroyed before then.
+    Pbo const pbo = acquirePbo(mReadPixelsPbos, GL_PIXEL_PACK_BUFFER, GL_STREAM_READ, size);
+    gl.bindBuffer(GL_PIXEL_PACK_BUFFER, pbo.id);
+    gl.bindBuffer(bo->gl.binding, bo->gl.id);
+    glCopyBufferSubData(bo->gl.binding, GL_PIXEL_PACK_BUFFER,
+            bo->streamingOffset + offset, 0, size);
+    gl.bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    CHECK_GL_ERROR(utils::slog.e)
+
+    auto* const pUserBuffer = new BufferDescriptor(std::move(p));
+    whenGpuCommandsComplete([this, size, pbo, pUserBuffer]() mutable {
+        BufferDescriptor& p = *pUserBuffer;
+        auto& gl = mContext;
+        gl.bindBuffer(GL_PIXEL_PACK_BUFFER, pbo.id);
+#if defined(__EMSCRIPTEN__)
+        glGetBufferSubData(GL_PIXEL_PACK_BUFFER, 0, size, p.buffer);
+#else
+        void* const vaddr = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
         if (vaddr) {
             memcpy(p.buffer, vaddr, size);
-            glUnmapBuffer(bo->gl.binding);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
         }
-        gl.bindBuffer(bo->gl.binding, 0);
+#endif
+        gl.bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        releasePbo(mReadPixelsPbos, pbo);
         scheduleDestroy(std::move(p));
+        delete pUserBuffer;
         CHECK_GL_ERROR(utils::slog.e)
-    }
+    });
 #endif
 }
 
@@ -3667,6 +3980,11 @@ void OpenGLDriver::setPresentationTime(int64_t monotonic_clock_ns) {
     mPlatform.setPresentationTime(monotonic_clock_ns);
 }
 
+void OpenGLDriver::setPresentationDamage(Viewport region) {
+    DEBUG_MARKER()
+    mPlatform.setPresentationDamage(region.left, region.bottom, region.width, region.height);
+}
+
 void OpenGLDriver::endFrame(UTILS_UNUSED uint32_t frameId) {
     PROFILE_MARKER(PROFILE_NAME_ENDFRAME)
 #if defined(__EMSCRIPTEN__)
@@ -3684,6 +4002,14 @@ void OpenGLDriver::endFrame(UTILS_UNUSED uint32_t frameId) {
 #endif
     //SYSTRACE_NAME("glFinish");
     //glFinish();
+
+    // report how effective the state shadowing was for this frame
+    SYSTRACE_CONTEXT();
+    auto const stats = mContext.getStateChangeStats();
+    SYSTRACE_VALUE32("GL state changes (issued)", stats.issued);
+    SYSTRACE_VALUE32("GL state changes (skipped)", stats.skipped);
+    mContext.resetStateChangeStats();
+
     mPlatform.endFrame(frameId);
     insertEventMarker("endFrame");
 }
@@ -4035,6 +4361,10 @@ void OpenGLDriver::bindPipeline(PipelineState const& state) {
     // TODO: we should validate that the pipeline layout matches the program's
 }
 
+void OpenGLDriver::bindPipelineState(Handle<HwPipelineState> psh) {
+    bindPipeline(handle_cast<HwPipelineState const*>(psh)->state);
+}
+
 void OpenGLDriver::bindRenderPrimitive(Handle<HwRenderPrimitive> rph) {
     DEBUG_MARKER()
     auto& gl = mContext;
@@ -4076,9 +4406,12 @@ void OpenGLDriver::bindDescriptorSet(
             // if the descriptor itself changed, we mark this descriptor binding
             // invalid -- it will be re-bound at the next draw.
             mInvalidDescriptorSetBindings.set(set, true);
-        } else if (!offsets.empty()) {
+        } else if (!offsets.empty() && !std::equal(offsets.data(),
+                offsets.data() + ds->getDynamicBufferCount(),
+                mBoundDescriptorSets[set].offsets.data())) {
             // if we reset offsets, we mark the offsets invalid so these descriptors only can
-            // be re-bound at the next draw.
+            // be re-bound at the next draw. Re-binding the same set with the same offsets is
+            // a no-op.
             mInvalidDescriptorSetBindingOffsets.set(set, true);
         }
 
@@ -4136,6 +4469,10 @@ void OpenGLDriver::draw2(uint32_t indexOffset, uint32_t indexCount, uint32_t ins
         updateDescriptors(invalidDescriptorSets);
     }
 
+    if (COALESCE_UNIFORM_UPDATES && UTILS_UNLIKELY(!mDirtyUniformBuffers.empty())) {
+        flushUniformUpdates();
+    }
+
 #ifndef FILAMENT_SILENCE_NOT_SUPPORTED_BY_ES2
     GLRenderPrimitive const* const rp = mBoundRenderPrimitive;
     glDrawElementsInstanced(GLenum(rp->type), (GLsizei)indexCount,
@@ -4151,6 +4488,76 @@ void OpenGLDriver::draw2(uint32_t indexOffset, uint32_t indexCount, uint32_t ins
 #endif
 }
 
+void OpenGLDriver::multiDraw2(DrawRange const* ranges, uint32_t count) {
+    DEBUG_MARKER()
+    assert_invariant(!mContext.isES2());
+    assert_invariant(mBoundRenderPrimitive);
+#if FILAMENT_ENABLE_MATDBG
+    if (UTILS_UNLIKELY(!mValidProgram)) {
+        return;
+    }
+#endif
+    assert_invariant(mBoundProgram);
+    assert_invariant(mValidProgram);
+
+    auto const invalidDescriptorSets =
+            mInvalidDescriptorSetBindings | mInvalidDescriptorSetBindingOffsets;
+    if (UTILS_UNLIKELY(invalidDescriptorSets.any())) {
+        updateDescriptors(invalidDescriptorSets);
+    }
+
+    if (COALESCE_UNIFORM_UPDATES && UTILS_UNLIKELY(!mDirtyUniformBuffers.empty())) {
+        flushUniformUpdates();
+    }
+
+#ifndef FILAMENT_SILENCE_NOT_SUPPORTED_BY_ES2
+    GLRenderPrimitive const* const rp = mBoundRenderPrimitive;
+    GLenum const type = GLenum(rp->type);
+    GLenum const indicesType = rp->gl.getIndicesType();
+#if defined(BACKEND_OPENGL_VERSION_GL) || defined(GL_EXT_multi_draw_arrays)
+    if (mContext.ext.EXT_multi_draw_arrays) {
+        // glMultiDrawElements() takes separate arrays of counts and offsets
+        constexpr uint32_t MAX_DRAW_COUNT = 64;
+        GLsizei counts[MAX_DRAW_COUNT];
+        void const* offsets[MAX_DRAW_COUNT];
+        for (uint32_t first = 0; first < count; first += MAX_DRAW_COUNT) {
+            uint32_t const drawCount = std::min(MAX_DRAW_COUNT, count - first);
+            for (uint32_t i = 0; i < drawCount; i++) {
+                counts[i] = GLsizei(ranges[first + i].indexCount);
+                offsets[i] = reinterpret_cast<const void*>(
+                        uintptr_t(ranges[first + i].indexOffset) << rp->gl.indicesShift);
+            }
+#   if defined(BACKEND_OPENGL_VERSION_GL)
+            glMultiDrawElements(type, counts, indicesType, offsets, GLsizei(drawCount));
+#   else
+            glMultiDrawElementsEXT(type, counts, indicesType, offsets, GLsizei(drawCount));
+#   endif
+        }
+    } else
+#endif
+    {
+        for (uint32_t i = 0; i < count; i++) {
+            glDrawElementsInstanced(type, GLsizei(ranges[i].indexCount), indicesType,
+                    reinterpret_cast<const void*>(
+                            uintptr_t(ranges[i].indexOffset) << rp->gl.indicesShift), 1);
+        }
+    }
+#endif
+
+#if FILAMENT_ENABLE_MATDBG
+    CHECK_GL_ERROR_NON_FATAL(utils::slog.e)
+#else
+    CHECK_GL_ERROR(utils::slog.e)
+#endif
+}
+
+// This is the ES2 version of multiDraw2().
+void OpenGLDriver::multiDraw2GLES2(DrawRange const* ranges, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        draw2GLES2(ranges[i].indexOffset, ranges[i].indexCount, 1);
+    }
+}
+
 // This is the ES2 version of draw2().
 void OpenGLDriver::draw2GLES2(uint32_t indexOffset, uint32_t indexCount, uint32_t instanceCount) {
     DEBUG_MARKER()
@@ -4217,6 +4624,10 @@ void OpenGLDriver::dispatchCompute(Handle<HwProgram> program, uint3 workGroupCou
         return;
     }
 
+    if (COALESCE_UNIFORM_UPDATES && UTILS_UNLIKELY(!mDirtyUniformBuffers.empty())) {
+        flushUniformUpdates();
+    }
+
 #if defined(BACKEND_OPENGL_LEVEL_GLES31)
 
 #if defined(__ANDROID__)
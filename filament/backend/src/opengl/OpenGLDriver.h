@@ -128,6 +128,7 @@ public:
         struct {
             GLuint buffer{};
         } gl;
+        BufferUsage usage{};
     };
 
     struct GLRenderPrimitive : public HwRenderPrimitive {
@@ -359,6 +360,7 @@ private:
     void setScissor(Viewport const& scissor) noexcept;
 
     void draw2GLES2(uint32_t indexOffset, uint32_t indexCount, uint32_t instanceCount);
+    void multiDraw2GLES2(DrawRange const* ranges, uint32_t count);
 
     // ES2 only. Uniform buffer emulation binding points
     GLuint mLastAssignedEmulatedUboId = 0;
@@ -384,8 +386,34 @@ private:
 
     void whenFrameComplete(const std::function<void()>& fn) noexcept;
     std::vector<std::function<void()>> mFrameCompleteOps;
+
+    // pixel buffers of completed readPixels() and texture uploads, reused by the next ones
+    static constexpr size_t MAX_POOLED_PBO_COUNT = 4;
+    struct Pbo {
+        GLuint id;
+        GLsizeiptr size;
+    };
+    Pbo acquirePbo(std::vector<Pbo>& pool,
+            GLenum target, GLenum usage, GLsizeiptr size) noexcept;
+    static void releasePbo(std::vector<Pbo>& pool, Pbo pbo) noexcept;
+    std::vector<Pbo> mReadPixelsPbos;
+    std::vector<Pbo> mTextureUploadPbos;
+
+    // texture uploads at least this large are staged in a pixel unpack buffer
+    static constexpr size_t TEXTURE_UPLOAD_PBO_MIN_SIZE = 64 * 1024;
+
+    // persistently mapped storage of dynamic uniform buffers (see GLStreamingStorage)
+    bool createStreamingStorage(GLBufferObject* bo) noexcept;
+    bool acquireStreamingRegion(GLBufferObject* bo) noexcept;
+    void destroyStreamingStorage(GLBufferObject* bo) noexcept;
 #endif
 
+    // WebGL only. Uniform buffers with updates not yet uploaded (see GLBufferObject::shadow)
+    void updateUniformShadow(GLBufferObject* bo,
+            void const* data, uint32_t size, uint32_t byteOffset) noexcept;
+    void flushUniformUpdates() noexcept;
+    std::vector<GLBufferObject*> mDirtyUniformBuffers;
+
     // tasks regularly executed on the main thread at until they return true
     void runEveryNowAndThen(std::function<bool()> fn) noexcept;
     void executeEveryNowAndThenOps() noexcept;
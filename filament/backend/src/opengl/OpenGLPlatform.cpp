@@ -98,6 +98,11 @@ void OpenGLPlatform::setPresentationTime(
         UTILS_UNUSED int64_t presentationTimeInNanosecond) noexcept {
 }
 
+void OpenGLPlatform::setPresentationDamage(
+        UTILS_UNUSED int32_t left, UTILS_UNUSED int32_t bottom,
+        UTILS_UNUSED uint32_t width, UTILS_UNUSED uint32_t height) noexcept {
+}
+
 
 bool OpenGLPlatform::canCreateFence() noexcept {
     return false;
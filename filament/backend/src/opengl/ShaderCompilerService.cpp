@@ -34,6 +34,7 @@
 #include <utils/Panic.h>
 #include <utils/Systrace.h>
 
+#include <algorithm>
 #include <array>
 #include <cctype>
 #include <chrono>
@@ -198,7 +199,8 @@ void ShaderCompilerService::init() noexcept {
         //   How many threads should we use?
         // - on macOS (M1 MacBook Pro/Ventura) there is global lock around all GL APIs when using
         //   a shared context, so parallel shader compilation yields no benefit.
-        // - on windows/linux we could use more threads, tbd.
+        // - on windows/linux desktop drivers compile and link in parallel across contexts, so
+        //   we use a few threads.
 
         // By default, we use one thread at the same priority as the gl thread. This is the
         // safest choice that avoids priority inversions.
@@ -219,7 +221,25 @@ void ShaderCompilerService::init() noexcept {
             // Angle shared contexts are not expensive once we have two.
             poolSize = (std::thread::hardware_concurrency() + 1) / 2;
             priority = JobSystem::Priority::BACKGROUND;
+        } else if (UTILS_UNLIKELY(strstr(renderer, "NVIDIA") ||
+                                  strstr(renderer, "Radeon") ||
+                                  strstr(renderer, "AMD"))) {
+#if (defined(__linux__) && !defined(__ANDROID__)) || defined(WIN32)
+            // Desktop drivers don't serialize linking across shared contexts.
+            poolSize = std::min(4u, (std::thread::hardware_concurrency() + 1) / 2);
+            priority = JobSystem::Priority::BACKGROUND;
+#endif
+        }
+
+        // an explicit thread count always wins over the per-driver heuristics above
+        uint32_t const requested = mDriver.getDriverConfig().shaderCompilerThreadCount;
+        if (requested) {
+            poolSize = requested;
+            if (poolSize > 1) {
+                priority = JobSystem::Priority::BACKGROUND;
+            }
         }
+        poolSize = std::max(1u, std::min(poolSize, std::thread::hardware_concurrency()));
 
         mShaderCompilerThreadCount = poolSize;
         mCompilerThreadPool.init(mShaderCompilerThreadCount,
@@ -244,6 +264,17 @@ void ShaderCompilerService::terminate() noexcept {
     // backend thread, and if we're here, we're on the backend main thread).
     mCompilerThreadPool.terminate();
 
+    // Flush the program binaries still waiting to be written. This must happen after the
+    // thread pool is stopped, since its threads can insert into the cache.
+    mBlobCache.terminate();
+
+#ifndef NDEBUG
+    OpenGLBlobCache::Stats const stats = mBlobCache.getStats();
+    slog.d << "Program cache: " << stats.hits << " hits, " << stats.misses << " misses, "
+           << stats.stale << " stale, " << stats.failures << " failures, "
+           << stats.writes << " writes" << io::endl;
+#endif
+
     mRunAtNextTickOps.clear();
 
     // We could have some pending callbacks here, we need to execute them.
@@ -354,10 +385,8 @@ ShaderCompilerService::program_token_t ShaderCompilerService::createProgram(
             mCallbackManager.put(token->handle);
 
             if (token->key) {
-                // TODO: technically we don't have to cache right now. Is it advantageous to
-                //       do this later, maybe depending on CPU usage?
                 // attempt to cache if we don't have a thread pool (otherwise it's done
-                // by the pool).
+                // by the pool). Only glGetProgramBinary runs here, the write is deferred.
                 mBlobCache.insert(mDriver.mPlatform, token->key, token->gl.program);
             }
 
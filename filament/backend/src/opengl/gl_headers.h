@@ -132,6 +132,12 @@ extern PFNGLGETDEBUGMESSAGELOGKHRPROC glGetDebugMessageLogKHR;
 #ifdef GL_EXT_clip_control
 extern PFNGLCLIPCONTROLEXTPROC glClipControlEXT;
 #endif
+#ifdef GL_EXT_buffer_storage
+extern PFNGLBUFFERSTORAGEEXTPROC glBufferStorageEXT;
+#endif
+#ifdef GL_EXT_multi_draw_arrays
+extern PFNGLMULTIDRAWELEMENTSEXTPROC glMultiDrawElementsEXT;
+#endif
 #ifdef GL_EXT_disjoint_timer_query
 extern PFNGLGENQUERIESEXTPROC glGenQueriesEXT;
 extern PFNGLDELETEQUERIESEXTPROC glDeleteQueriesEXT;
@@ -40,6 +40,7 @@
 #include <algorithm>
 #include <new>
 #include <initializer_list>
+#include <iterator>
 #include <utility>
 
 #include <stddef.h>
@@ -62,6 +63,7 @@ UTILS_PRIVATE PFNEGLDESTROYSYNCKHRPROC eglDestroySyncKHR = {};
 UTILS_PRIVATE PFNEGLCLIENTWAITSYNCKHRPROC eglClientWaitSyncKHR = {};
 UTILS_PRIVATE PFNEGLCREATEIMAGEKHRPROC eglCreateImageKHR = {};
 UTILS_PRIVATE PFNEGLDESTROYIMAGEKHRPROC eglDestroyImageKHR = {};
+UTILS_PRIVATE PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC eglSwapBuffersWithDamageKHR = {};
 }
 using namespace glext;
 
@@ -117,7 +119,11 @@ bool PlatformEGL::isOpenGL() const noexcept {
     return false;
 }
 
-PlatformEGL::ExternalImageEGL::~ExternalImageEGL() = default;
+PlatformEGL::ExternalImageEGL::~ExternalImageEGL() {
+    if (ownerDisplay != EGL_NO_DISPLAY && eglImage != EGL_NO_IMAGE) {
+        eglDestroyImageKHR(ownerDisplay, eglImage);
+    }
+}
 
 Driver* PlatformEGL::createDriver(void* sharedContext, const DriverConfig& driverConfig) noexcept {
     mEGLDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
@@ -156,7 +162,11 @@ Driver* PlatformEGL::createDriver(void* sharedContext, const DriverConfig& drive
     ext.egl.KHR_create_context = extensions.has("EGL_KHR_create_context");
     ext.egl.KHR_no_config_context = extensions.has("EGL_KHR_no_config_context");
     ext.egl.KHR_surfaceless_context = extensions.has("EGL_KHR_surfaceless_context");
+    ext.egl.KHR_swap_buffers_with_damage = extensions.has("EGL_KHR_swap_buffers_with_damage");
     ext.egl.EXT_protected_content = extensions.has("EGL_EXT_protected_content");
+    ext.egl.EXT_image_dma_buf_import = extensions.has("EGL_EXT_image_dma_buf_import");
+    ext.egl.EXT_image_dma_buf_import_modifiers =
+            extensions.has("EGL_EXT_image_dma_buf_import_modifiers");
 
     eglCreateSyncKHR = (PFNEGLCREATESYNCKHRPROC) eglGetProcAddress("eglCreateSyncKHR");
     eglDestroySyncKHR = (PFNEGLDESTROYSYNCKHRPROC) eglGetProcAddress("eglDestroySyncKHR");
@@ -164,6 +174,11 @@ Driver* PlatformEGL::createDriver(void* sharedContext, const DriverConfig& drive
 
     eglCreateImageKHR = (PFNEGLCREATEIMAGEKHRPROC) eglGetProcAddress("eglCreateImageKHR");
     eglDestroyImageKHR = (PFNEGLDESTROYIMAGEKHRPROC) eglGetProcAddress("eglDestroyImageKHR");
+    if (ext.egl.KHR_swap_buffers_with_damage) {
+        eglSwapBuffersWithDamageKHR = (PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC) eglGetProcAddress(
+                "eglSwapBuffersWithDamageKHR");
+        ext.egl.KHR_swap_buffers_with_damage = eglSwapBuffersWithDamageKHR != nullptr;
+    }
 
     EGLint const pbufferAttribs[] = {
             EGL_WIDTH,  1,
@@ -651,9 +666,25 @@ void PlatformEGL::commit(SwapChain* swapChain) noexcept {
     if (swapChain) {
         SwapChainEGL const* const sc = static_cast<SwapChainEGL const*>(swapChain);
         if (sc->sur != EGL_NO_SURFACE) {
-            eglSwapBuffers(mEGLDisplay, sc->sur);
+            if (ext.egl.KHR_swap_buffers_with_damage &&
+                    mPresentationDamage[2] > 0 && mPresentationDamage[3] > 0) {
+                eglSwapBuffersWithDamageKHR(mEGLDisplay, sc->sur, mPresentationDamage, 1);
+            } else {
+                eglSwapBuffers(mEGLDisplay, sc->sur);
+            }
         }
     }
+    std::fill(std::begin(mPresentationDamage), std::end(mPresentationDamage), 0);
+}
+
+void PlatformEGL::setPresentationDamage(int32_t const left, int32_t const bottom,
+        uint32_t const width, uint32_t const height) noexcept {
+    // EGL_KHR_swap_buffers_with_damage rectangles have their origin at the bottom-left,
+    // like ours.
+    mPresentationDamage[0] = left;
+    mPresentationDamage[1] = bottom;
+    mPresentationDamage[2] = EGLint(width);
+    mPresentationDamage[3] = EGLint(height);
 }
 
 // -----------------------------------------------------------------------------------------------
@@ -730,6 +761,74 @@ Platform::ExternalImageHandle PlatformEGL::createExternalImage(EGLImageKHR eglIm
     return ExternalImageHandle{p};
 }
 
+Platform::ExternalImageHandle PlatformEGL::createExternalImage(
+        DmaBufImage const& image) noexcept {
+#if defined(EGL_EXT_image_dma_buf_import) && defined(EGL_EXT_image_dma_buf_import_modifiers)
+    if (UTILS_UNLIKELY(!ext.egl.EXT_image_dma_buf_import || !eglCreateImageKHR ||
+            image.planeCount < 1 || image.planeCount > 3)) {
+        return {};
+    }
+
+    constexpr EGLint planeAttribs[3][5] = {
+            { EGL_DMA_BUF_PLANE0_FD_EXT, EGL_DMA_BUF_PLANE0_OFFSET_EXT,
+              EGL_DMA_BUF_PLANE0_PITCH_EXT,
+              EGL_DMA_BUF_PLANE0_MODIFIER_LO_EXT, EGL_DMA_BUF_PLANE0_MODIFIER_HI_EXT },
+            { EGL_DMA_BUF_PLANE1_FD_EXT, EGL_DMA_BUF_PLANE1_OFFSET_EXT,
+              EGL_DMA_BUF_PLANE1_PITCH_EXT,
+              EGL_DMA_BUF_PLANE1_MODIFIER_LO_EXT, EGL_DMA_BUF_PLANE1_MODIFIER_HI_EXT },
+            { EGL_DMA_BUF_PLANE2_FD_EXT, EGL_DMA_BUF_PLANE2_OFFSET_EXT,
+              EGL_DMA_BUF_PLANE2_PITCH_EXT,
+              EGL_DMA_BUF_PLANE2_MODIFIER_LO_EXT, EGL_DMA_BUF_PLANE2_MODIFIER_HI_EXT },
+    };
+
+    constexpr uint64_t DRM_FORMAT_MOD_INVALID = (uint64_t(1) << 56u) - 1u;
+    bool const hasModifier = ext.egl.EXT_image_dma_buf_import_modifiers &&
+            image.modifier != DRM_FORMAT_MOD_INVALID;
+
+    // 6 attributes, 5 per plane, and the terminator
+    EGLint attribs[6 + 3 * 10 + 1];
+    EGLint* p = attribs;
+    *p++ = EGL_WIDTH;
+    *p++ = EGLint(image.width);
+    *p++ = EGL_HEIGHT;
+    *p++ = EGLint(image.height);
+    *p++ = EGL_LINUX_DRM_FOURCC_EXT;
+    *p++ = EGLint(image.fourcc);
+    for (uint32_t i = 0; i < image.planeCount; i++) {
+        DmaBufImage::Plane const& plane = image.planes[i];
+        *p++ = planeAttribs[i][0];
+        *p++ = plane.fd;
+        *p++ = planeAttribs[i][1];
+        *p++ = EGLint(plane.offset);
+        *p++ = planeAttribs[i][2];
+        *p++ = EGLint(plane.pitch);
+        if (hasModifier) {
+            *p++ = planeAttribs[i][3];
+            *p++ = EGLint(image.modifier & 0xFFFFFFFFu);
+            *p++ = planeAttribs[i][4];
+            *p++ = EGLint(image.modifier >> 32u);
+        }
+    }
+    *p++ = EGL_NONE;
+
+    // the DMA-BUF target requires no context and no client buffer
+    EGLImageKHR const eglImage = eglCreateImageKHR(mEGLDisplay, EGL_NO_CONTEXT,
+            EGL_LINUX_DMA_BUF_EXT, nullptr, attribs);
+    if (UTILS_UNLIKELY(eglImage == EGL_NO_IMAGE_KHR)) {
+        logEglError("PlatformEGL::createExternalImage: eglCreateImageKHR");
+        return {};
+    }
+
+    auto* const externalImage = new(std::nothrow) ExternalImageEGL;
+    externalImage->eglImage = eglImage;
+    externalImage->ownerDisplay = mEGLDisplay;
+    return ExternalImageHandle{ externalImage };
+#else
+    (void)image;
+    return {};
+#endif
+}
+
 bool PlatformEGL::setExternalImage(ExternalImageHandleRef externalImage,
         UTILS_UNUSED_IN_RELEASE ExternalTexture* texture) noexcept {
     auto const* const eglExternalImage = static_cast<ExternalImageEGL const*>(externalImage.get());
@@ -15,6 +15,7 @@
  */
 
 #include "VulkanBuffer.h"
+#include "VulkanCommands.h"
 #include "VulkanMemory.h"
 
 #include <utils/Panic.h>
@@ -49,14 +50,9 @@ VulkanBuffer::~VulkanBuffer() {
     vmaDestroyBuffer(mAllocator, mGpuBuffer, mGpuMemory);
 }
 
-void VulkanBuffer::loadFromCpu(VkCommandBuffer cmdbuf, const void* cpuData, uint32_t byteOffset,
-        uint32_t numBytes) {
-    VulkanStage const* stage = mStagePool.acquireStage(numBytes);
-    void* mapped;
-    vmaMapMemory(mAllocator, stage->memory, &mapped);
-    memcpy(mapped, cpuData, numBytes);
-    vmaUnmapMemory(mAllocator, stage->memory);
-    vmaFlushAllocation(mAllocator, stage->memory, byteOffset, numBytes);
+void VulkanBuffer::loadFromCpu(VulkanCommandBuffer& commands, const void* cpuData,
+        uint32_t byteOffset, uint32_t numBytes) {
+    VkCommandBuffer const cmdbuf = commands.buffer();
 
     // If there was a previous update, then we need to make sure the following write is properly
     // synced with the previous read.
@@ -88,20 +84,79 @@ void VulkanBuffer::loadFromCpu(VkCommandBuffer cmdbuf, const void* cpuData, uint
                 &barrier, 0, nullptr);
     }
 
+    copyFromStage(commands, cpuData, byteOffset, numBytes);
+
+    // Firstly, ensure that the copy finishes before the next draw call.
+    // Secondly, in case the user decides to upload another chunk (without ever using the first one)
+    // we need to ensure that this upload completes first (hence
+    // dstStageMask=VK_PIPELINE_STAGE_TRANSFER_BIT).
+    auto const [dstAccessMask, dstStageMask] = getReadAccess();
+
+    VkBufferMemoryBarrier barrier{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = dstAccessMask,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer = mGpuBuffer,
+        .size = VK_WHOLE_SIZE,
+    };
+
+    vkCmdPipelineBarrier(cmdbuf, VK_PIPELINE_STAGE_TRANSFER_BIT, dstStageMask, 0, 0, nullptr, 1,
+            &barrier, 0, nullptr);
+}
+
+void VulkanBuffer::loadFromCpu(VulkanCommandBuffer& transferCommands,
+        uint32_t transferQueueFamily, VulkanCommandBuffer& commands, uint32_t queueFamily,
+        const void* cpuData, uint32_t byteOffset, uint32_t numBytes) {
+    assert_invariant(canLoadOnTransferQueue(numBytes));
+    VkCommandBuffer const transferCmdbuf = transferCommands.buffer();
+    VkCommandBuffer const cmdbuf = commands.buffer();
+
+    // This is the first upload, so there is no previous read to wait for.
+    copyFromStage(transferCommands, cpuData, byteOffset, numBytes);
+
+    // Queue family ownership transfer: the release half runs on the transfer queue, the acquire
+    // half on the graphics queue. Both barriers must use the same parameters, the access and
+    // stage masks that don't apply to a queue are ignored.
+    auto const [dstAccessMask, dstStageMask] = getReadAccess();
+
+    VkBufferMemoryBarrier barrier{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = 0,
+        .srcQueueFamilyIndex = transferQueueFamily,
+        .dstQueueFamilyIndex = queueFamily,
+        .buffer = mGpuBuffer,
+        .size = VK_WHOLE_SIZE,
+    };
+    vkCmdPipelineBarrier(transferCmdbuf, VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = dstAccessMask;
+    vkCmdPipelineBarrier(cmdbuf, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, dstStageMask, 0, 0, nullptr,
+            1, &barrier, 0, nullptr);
+}
+
+void VulkanBuffer::copyFromStage(VulkanCommandBuffer& commands, const void* cpuData,
+        uint32_t byteOffset, uint32_t numBytes) {
+    VulkanStageSlice const stage = mStagePool.acquireSlice(numBytes, commands);
+    memcpy(stage.mapped, cpuData, numBytes);
+    vmaFlushAllocation(mAllocator, stage.memory, stage.offset, numBytes);
+
     VkBufferCopy region {
-            .srcOffset = 0,
+            .srcOffset = stage.offset,
             .dstOffset = byteOffset,
             .size = numBytes,
     };
-    vkCmdCopyBuffer(cmdbuf, stage->buffer, mGpuBuffer, 1, &region);
+    vkCmdCopyBuffer(commands.buffer(), stage.buffer, mGpuBuffer, 1, &region);
 
 	mUpdatedOffset = byteOffset;
     mUpdatedBytes = numBytes;
+}
 
-    // Firstly, ensure that the copy finishes before the next draw call.
-    // Secondly, in case the user decides to upload another chunk (without ever using the first one)
-    // we need to ensure that this upload completes first (hence
-    // dstStageMask=VK_PIPELINE_STAGE_TRANSFER_BIT).
+std::pair<VkAccessFlags, VkPipelineStageFlags> VulkanBuffer::getReadAccess() const {
     VkAccessFlags dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
     VkPipelineStageFlags dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
 
@@ -118,19 +173,7 @@ void VulkanBuffer::loadFromCpu(VkCommandBuffer cmdbuf, const void* cpuData, uint
     } else if (mUsage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) {
         // TODO: implement me
     }
-
-    VkBufferMemoryBarrier barrier{
-        .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
-        .dstAccessMask = dstAccessMask,
-        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-        .buffer = mGpuBuffer,
-        .size = VK_WHOLE_SIZE,
-    };
-
-    vkCmdPipelineBarrier(cmdbuf, VK_PIPELINE_STAGE_TRANSFER_BIT, dstStageMask, 0, 0, nullptr, 1,
-            &barrier, 0, nullptr);
+    return { dstAccessMask, dstStageMask };
 }
 
 } // namespace filament::backend
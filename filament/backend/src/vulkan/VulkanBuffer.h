@@ -17,10 +17,13 @@
 #ifndef TNT_FILAMENT_BACKEND_VULKANBUFFER_H
 #define TNT_FILAMENT_BACKEND_VULKANBUFFER_H
 
+#include "VulkanConstants.h"
 #include "VulkanContext.h"
 #include "VulkanStagePool.h"
 #include "VulkanMemory.h"
 
+#include <utility>
+
 namespace filament::backend {
 
 // Encapsulates a Vulkan buffer, its attached DeviceMemory and a staging area.
@@ -29,13 +32,30 @@ public:
     VulkanBuffer(VmaAllocator allocator, VulkanStagePool& stagePool, VkBufferUsageFlags usage,
             uint32_t numBytes);
     ~VulkanBuffer();
-    void loadFromCpu(VkCommandBuffer cmdbuf, const void* cpuData, uint32_t byteOffset,
+    void loadFromCpu(VulkanCommandBuffer& commands, const void* cpuData, uint32_t byteOffset,
             uint32_t numBytes);
+
+    // Whether an upload of this size can be recorded on a dedicated transfer queue. This is only
+    // the case for the first upload, so that there is no previous read to synchronize with.
+    bool canLoadOnTransferQueue(uint32_t numBytes) const {
+        return mUpdatedBytes == 0 && numBytes >= FVK_TRANSFER_QUEUE_MIN_UPLOAD_SIZE;
+    }
+
+    // Records the copy in `transferCommands` and releases the buffer from `transferQueueFamily`,
+    // the matching acquire is recorded in `commands`, which must be submitted after
+    // `transferCommands` and wait on it.
+    void loadFromCpu(VulkanCommandBuffer& transferCommands, uint32_t transferQueueFamily,
+            VulkanCommandBuffer& commands, uint32_t queueFamily, const void* cpuData,
+            uint32_t byteOffset, uint32_t numBytes);
     VkBuffer getGpuBuffer() const {
         return mGpuBuffer;
     }
 
 private:
+    void copyFromStage(VulkanCommandBuffer& commands, const void* cpuData, uint32_t byteOffset,
+            uint32_t numBytes);
+    std::pair<VkAccessFlags, VkPipelineStageFlags> getReadAccess() const;
+
     VmaAllocator mAllocator;
     VulkanStagePool& mStagePool;
 
@@ -87,19 +87,22 @@ bool VulkanGroupMarkers::empty() const noexcept {
 #endif // FVK_DEBUG_GROUP_MARKERS
 
 VulkanCommandBuffer::VulkanCommandBuffer(VulkanContext* context, VkDevice device, VkQueue queue,
-        VkCommandPool pool, bool isProtected)
+        VkCommandPool pool, bool isProtected, VkSemaphore timeline)
     : mContext(context),
       mMarkerCount(0),
       isProtected(isProtected),
       mDevice(device),
       mQueue(queue),
       mBuffer(createCommandBuffer(device, pool)),
+      mTimeline(timeline),
       mFenceStatus(std::make_shared<VulkanCmdFence>(VK_INCOMPLETE)) {
     VkSemaphoreCreateInfo sci{.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
     vkCreateSemaphore(mDevice, &sci, VKALLOC, &mSubmission);
 
-    VkFenceCreateInfo fenceCreateInfo{.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
-    vkCreateFence(device, &fenceCreateInfo, VKALLOC, &mFence);
+    if (mTimeline == VK_NULL_HANDLE) {
+        VkFenceCreateInfo fenceCreateInfo{.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+        vkCreateFence(device, &fenceCreateInfo, VKALLOC, &mFence);
+    }
 }
 
 VulkanCommandBuffer::~VulkanCommandBuffer() {
@@ -116,7 +119,9 @@ void VulkanCommandBuffer::reset() noexcept {
     // gets, gets submitted, its status changes to VK_NOT_READY. Finally, when the GPU actually
     // finishes executing the command buffer, the status changes to VK_SUCCESS.
     mFenceStatus = std::make_shared<VulkanCmdFence>(VK_INCOMPLETE);
-    vkResetFences(mDevice, 1, &mFence);
+    if (mFence != VK_NULL_HANDLE) {
+        vkResetFences(mDevice, 1, &mFence);
+    }
 }
 
 void VulkanCommandBuffer::pushMarker(char const* marker) noexcept {
@@ -175,18 +180,25 @@ void VulkanCommandBuffer::begin() noexcept {
     vkBeginCommandBuffer(mBuffer, &binfo);
 }
 
-VkSemaphore VulkanCommandBuffer::submit() {
+VkSemaphore VulkanCommandBuffer::submit(uint64_t const timelineValue) {
     while (mMarkerCount > 0) {
         popMarker();
     }
 
     vkEndCommandBuffer(mBuffer);
 
-    VkPipelineStageFlags const waitDestStageMasks[2] = {
+    VkPipelineStageFlags const waitDestStageMasks[3] = {
+        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
     };
 
+    // The binary semaphore orders the submissions and the presentation, the timeline semaphore
+    // (if any) tracks completion. The value of the binary semaphore is ignored.
+    VkSemaphore const signalSemaphores[2] = { mSubmission, mTimeline };
+    uint64_t const signalValues[2] = { 0, timelineValue };
+    bool const hasTimeline = mTimeline != VK_NULL_HANDLE;
+
     VkSubmitInfo submitInfo{
         .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
         .waitSemaphoreCount = mWaitSemaphores.size(),
@@ -194,8 +206,8 @@ VkSemaphore VulkanCommandBuffer::submit() {
         .pWaitDstStageMask = waitDestStageMasks,
         .commandBufferCount = 1u,
         .pCommandBuffers = &mBuffer,
-        .signalSemaphoreCount = 1u,
-        .pSignalSemaphores = &mSubmission,
+        .signalSemaphoreCount = hasTimeline ? 2u : 1u,
+        .pSignalSemaphores = signalSemaphores,
     };
     // add submit protection if needed
     VkProtectedSubmitInfo protectedSubmitInfo{
@@ -204,9 +216,23 @@ VkSemaphore VulkanCommandBuffer::submit() {
     };
 
     if (isProtected) {
+        protectedSubmitInfo.pNext = submitInfo.pNext;
         submitInfo.pNext = &protectedSubmitInfo;
     }
 
+    // the wait semaphores are all binary, so they don't need values
+    VkTimelineSemaphoreSubmitInfoKHR timelineSubmitInfo{
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR,
+        .signalSemaphoreValueCount = 2u,
+        .pSignalSemaphoreValues = signalValues,
+    };
+
+    if (hasTimeline) {
+        timelineSubmitInfo.pNext = submitInfo.pNext;
+        submitInfo.pNext = &timelineSubmitInfo;
+        mTimelineValue = timelineValue;
+    }
+
 #if FVK_ENABLED(FVK_DEBUG_COMMAND_BUFFER)
     FVK_LOGI << "Submitting cmdbuffer=" << mBuffer
              << " wait=(";
@@ -215,7 +241,8 @@ VkSemaphore VulkanCommandBuffer::submit() {
     }
     FVK_LOGI << ") "
              << " signal=" << mSubmission
-             << " fence=" << mFence << utils::io::endl;
+             << " fence=" << mFence
+             << " timeline=" << (hasTimeline ? timelineValue : 0) << utils::io::endl;
 #endif
 
     mFenceStatus->setStatus(VK_NOT_READY);
@@ -245,9 +272,22 @@ CommandBufferPool::CommandBufferPool(VulkanContext* context, VkDevice device, Vk
     };
     vkCreateCommandPool(device, &createInfo, VKALLOC, &mPool);
 
+    if (context->isTimelineSemaphoreSupported()) {
+        VkSemaphoreTypeCreateInfoKHR typeCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR,
+            .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR,
+            .initialValue = 0,
+        };
+        VkSemaphoreCreateInfo const semaphoreCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+            .pNext = &typeCreateInfo,
+        };
+        vkCreateSemaphore(device, &semaphoreCreateInfo, VKALLOC, &mTimeline);
+    }
+
     for (size_t i = 0; i < CAPACITY; ++i) {
-        mBuffers.emplace_back(
-                std::make_unique<VulkanCommandBuffer>(context, device, queue, mPool, isProtected));
+        mBuffers.emplace_back(std::make_unique<VulkanCommandBuffer>(context, device, queue, mPool,
+                isProtected, mTimeline));
     }
 }
 
@@ -255,6 +295,9 @@ CommandBufferPool::~CommandBufferPool() {
     wait();
     gc();
     vkDestroyCommandPool(mDevice, mPool, VKALLOC);
+    if (mTimeline != VK_NULL_HANDLE) {
+        vkDestroySemaphore(mDevice, mTimeline, VKALLOC);
+    }
 }
 
 VulkanCommandBuffer& CommandBufferPool::getRecording() {
@@ -307,6 +350,17 @@ void CommandBufferPool::gc() {
 }
 
 void CommandBufferPool::update() {
+    if (mTimeline != VK_NULL_HANDLE) {
+        uint64_t completed = 0;
+        vkGetSemaphoreCounterValueKHR(mDevice, mTimeline, &completed);
+        mSubmitted.forEachSetBit([this, completed] (size_t index) {
+            auto& buffer = mBuffers[index];
+            if (buffer->getTimelineValue() <= completed) {
+                buffer->setComplete();
+            }
+        });
+        return;
+    }
     mSubmitted.forEachSetBit([this] (size_t index) {
         auto& buffer = mBuffers[index];
         VkResult status = vkGetFenceStatus(mDevice, buffer->getVkFence());
@@ -321,13 +375,25 @@ VkSemaphore CommandBufferPool::flush() {
     if (!isRecording()) {
         return VK_NULL_HANDLE;
     }
-    auto submitSemaphore = mBuffers[mRecording]->submit();
+    auto submitSemaphore = mBuffers[mRecording]->submit(++mTimelineValue);
     mSubmitted.set(mRecording, true);
     mRecording = INVALID;
     return submitSemaphore;
 }
 
 void CommandBufferPool::wait() {
+    if (mTimeline != VK_NULL_HANDLE) {
+        // the submissions complete in order, so waiting for the last one is enough
+        VkSemaphoreWaitInfoKHR const waitInfo{
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR,
+            .semaphoreCount = 1,
+            .pSemaphores = &mTimeline,
+            .pValues = &mTimelineValue,
+        };
+        vkWaitSemaphoresKHR(mDevice, &waitInfo, UINT64_MAX);
+        update();
+        return;
+    }
     uint8_t count = 0;
     VkFence fences[CAPACITY];
     mSubmitted.forEachSetBit([this, &count, &fences] (size_t index) {
@@ -379,14 +445,19 @@ void CommandBufferPool::insertEvent(char const* marker) {
 #endif // FVK_DEBUG_GROUP_MARKERS
 
 VulkanCommands::VulkanCommands(VkDevice device, VkQueue queue, uint32_t queueFamilyIndex,
-        VkQueue protectedQueue, uint32_t protectedQueueFamilyIndex, VulkanContext* context)
+        VkQueue protectedQueue, uint32_t protectedQueueFamilyIndex,
+        VkQueue transferQueue, uint32_t transferQueueFamilyIndex, VulkanContext* context)
     : mDevice(device),
+      mQueueFamilyIndex(queueFamilyIndex),
       mProtectedQueue(protectedQueue),
       mProtectedQueueFamilyIndex(protectedQueueFamilyIndex),
+      mTransferQueue(transferQueue),
+      mTransferQueueFamilyIndex(transferQueueFamilyIndex),
       mContext(context),
       mPool(std::make_unique<CommandBufferPool>(context, device, queue, queueFamilyIndex, false)) {}
 
 void VulkanCommands::terminate() {
+    mTransferPool.reset();
     mPool.reset();
     mProtectedPool.reset();
 }
@@ -407,6 +478,17 @@ VulkanCommandBuffer& VulkanCommands::getProtected() {
     return ret;
 }
 
+VulkanCommandBuffer& VulkanCommands::getTransfer() {
+    assert_invariant(mTransferQueue != VK_NULL_HANDLE);
+
+    if (!mTransferPool) {
+        mTransferPool = std::make_unique<CommandBufferPool>(mContext, mDevice, mTransferQueue,
+                mTransferQueueFamilyIndex, false);
+    }
+    auto& ret = mTransferPool->getRecording();
+    return ret;
+}
+
 bool VulkanCommands::flush() {
     // It's possible to call flush and wait at "terminate", in which case, we'll just return.
     if (!mPool && !mProtectedPool) {
@@ -417,6 +499,14 @@ bool VulkanCommands::flush() {
     VkSemaphore lastSubmit = mLastSubmit;
     bool hasFlushed = false;
 
+    // Uploads recorded on the transfer queue are submitted first, the graphics commands that use
+    // them were recorded after them and must wait for the copies to land.
+    if (mTransferPool && mTransferPool->isRecording()) {
+        VkSemaphore const transferred = mTransferPool->flush();
+        mPool->getRecording();
+        mPool->waitFor(transferred);
+    }
+
     // Note that we've ordered it so that the non-protected commands are followed by the protected
     // commands.  This assumes that the protected commands will be that one doing the rendering into
     // the protected memory (i.e. protected render target).
@@ -456,6 +546,9 @@ void VulkanCommands::wait() {
     if (mProtectedPool) {
         mProtectedPool->wait();
     }
+    if (mTransferPool) {
+        mTransferPool->wait();
+    }
     FVK_SYSTRACE_END();
 }
 
@@ -467,6 +560,9 @@ void VulkanCommands::gc() {
     if (mProtectedPool) {
         mProtectedPool->gc();
     }
+    if (mTransferPool) {
+        mTransferPool->gc();
+    }
     FVK_SYSTRACE_END();
 }
 
@@ -475,6 +571,9 @@ void VulkanCommands::updateFences() {
     if (mProtectedPool) {
         mProtectedPool->update();
     }
+    if (mTransferPool) {
+        mTransferPool->update();
+    }
 }
 
 #if FVK_ENABLED(FVK_DEBUG_GROUP_MARKERS)
@@ -63,9 +63,12 @@ private:
 // The submission fence has shared ownership semantics because it is potentially wrapped by a
 // DriverApi fence object and should not be destroyed until both the DriverApi object is freed and
 // we're done waiting on the most recent submission of the given command buffer.
+//
+// When a timeline semaphore is given, each submission signals it with its own value instead of
+// signaling a VkFence, and completion is tracked by the pool.
 struct VulkanCommandBuffer {
-    VulkanCommandBuffer(VulkanContext* mContext,
-            VkDevice device, VkQueue queue, VkCommandPool pool, bool isProtected);
+    VulkanCommandBuffer(VulkanContext* mContext, VkDevice device, VkQueue queue,
+            VkCommandPool pool, bool isProtected, VkSemaphore timeline);
 
     VulkanCommandBuffer(VulkanCommandBuffer const&) = delete;
     VulkanCommandBuffer& operator=(VulkanCommandBuffer const&) = delete;
@@ -87,7 +90,9 @@ struct VulkanCommandBuffer {
     void insertEvent(char const* marker) noexcept;
 
     void begin() noexcept;
-    VkSemaphore submit();
+
+    // timelineValue is signaled on the timeline semaphore, if there is one
+    VkSemaphore submit(uint64_t timelineValue);
 
     inline void setComplete() {
         mFenceStatus->setStatus(VK_SUCCESS);
@@ -105,6 +110,10 @@ struct VulkanCommandBuffer {
         return mFence;
     }
 
+    uint64_t getTimelineValue() const {
+        return mTimelineValue;
+    }
+
     VkCommandBuffer buffer() const {
         return mBuffer;
     }
@@ -115,10 +124,12 @@ private:
     bool const isProtected;
     VkDevice mDevice;
     VkQueue mQueue;
-    fvkutils::StaticVector<VkSemaphore, 2> mWaitSemaphores;
+    fvkutils::StaticVector<VkSemaphore, 3> mWaitSemaphores;
     VkCommandBuffer mBuffer;
     VkSemaphore mSubmission;
-    VkFence mFence;
+    VkSemaphore const mTimeline;
+    uint64_t mTimelineValue = 0;
+    VkFence mFence = VK_NULL_HANDLE;
     std::shared_ptr<VulkanCmdFence> mFenceStatus;
     std::vector<fvkmemory::resource_ptr<Resource>> mResources;
 };
@@ -160,6 +171,10 @@ private:
     using BufferList = utils::FixedCapacityVector<std::unique_ptr<VulkanCommandBuffer>>;
     VkDevice mDevice;
     VkCommandPool mPool;
+    // Signaled with an increasing value by each submission, when timeline semaphores are
+    // supported. A single query then tells which submissions have completed.
+    VkSemaphore mTimeline = VK_NULL_HANDLE;
+    uint64_t mTimelineValue = 0;
     ActiveBuffers mSubmitted;
     std::vector<std::unique_ptr<VulkanCommandBuffer>> mBuffers;
     int8_t mRecording;
@@ -187,15 +202,22 @@ private:
 // - Allows 1 user to listen to the most recent flush event using a "finished" VkSemaphore.
 //    - This is used to trigger presentation of the swap chain image.
 //
+// - Optionally records uploads on a dedicated transfer queue.
+//    - Pending transfer commands are submitted first on flush, and the next graphics submission
+//      waits for them.
+//
 // - Allows off-thread queries of command buffer status.
 //    - Exposes an "updateFences" method that transfers current fence status into atomics.
 //    - Users can examine these atomic variables (see VulkanCmdFence) to determine status.
 //    - We do this because vkGetFenceStatus must be called from the rendering thread.
+//    - With VK_KHR_timeline_semaphore, each pool signals one timeline semaphore instead of a
+//      fence per submission, and the status of all its command buffers comes from one query.
 //
 class VulkanCommands {
 public:
     VulkanCommands(VkDevice device, VkQueue queue, uint32_t queueFamilyIndex,
-            VkQueue protectedQueue, uint32_t protectedQueueFamilyIndex, VulkanContext* context);
+            VkQueue protectedQueue, uint32_t protectedQueueFamilyIndex,
+            VkQueue transferQueue, uint32_t transferQueueFamilyIndex, VulkanContext* context);
 
     void terminate();
 
@@ -206,6 +228,17 @@ public:
     // returns the current one.
     VulkanCommandBuffer& getProtected();
 
+    // Whether there is a dedicated transfer queue, i.e. whether getTransfer() can be called.
+    bool hasTransferQueue() const noexcept { return mTransferQueue != VK_NULL_HANDLE; }
+
+    // Creates a "current" command buffer on the transfer queue if none exists, otherwise returns
+    // the current one. Resources written here must be released to the graphics queue family.
+    VulkanCommandBuffer& getTransfer();
+
+    uint32_t getQueueFamilyIndex() const noexcept { return mQueueFamilyIndex; }
+
+    uint32_t getTransferQueueFamilyIndex() const noexcept { return mTransferQueueFamilyIndex; }
+
     // Submits the current command buffer if it exists, then sets "current" to null.
     // If there are no outstanding commands then nothing happens and this returns false.
     bool flush();
@@ -243,13 +276,17 @@ public:
 
 private:
     VkDevice const mDevice;
+    uint32_t const mQueueFamilyIndex;
     VkQueue const mProtectedQueue;
     // For defered initialization if/when we need protected content
     uint32_t const mProtectedQueueFamilyIndex;
+    VkQueue const mTransferQueue;
+    uint32_t const mTransferQueueFamilyIndex;
     VulkanContext* mContext;
 
     std::unique_ptr<CommandBufferPool> mPool;
     std::unique_ptr<CommandBufferPool> mProtectedPool;
+    std::unique_ptr<CommandBufferPool> mTransferPool;
 
     VkSemaphore mInjectedDependency = VK_NULL_HANDLE;
     VkSemaphore mLastSubmit = VK_NULL_HANDLE;
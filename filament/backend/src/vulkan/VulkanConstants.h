@@ -81,6 +81,9 @@
 // All other debug features must be disabled.
 #define FVK_DEBUG_PROFILING               0x00040000
 
+// Print the descriptor set allocation, update and binding statistics on shutdown.
+#define FVK_DEBUG_DESCRIPTOR_SET          0x00080000
+
 // Useful default combinations
 #define FVK_DEBUG_EVERYTHING              (0xFFFFFFFF & ~FVK_DEBUG_PROFILING)
 #define FVK_DEBUG_PERFORMANCE     \
@@ -212,4 +215,20 @@ constexpr static const int FVK_MAX_PIPELINE_AGE = FVK_MAX_COMMAND_BUFFERS;
 // destroying any unused pipeline object.
 static_assert(FVK_MAX_PIPELINE_AGE >= FVK_MAX_COMMAND_BUFFERS);
 
+// When new pipelines have been created, the content of the VkPipelineCache is written back to the
+// Platform's blob cache after this many garbage collection events (i.e. roughly frames), this
+// avoids serializing the cache every time a pipeline is created during warm-up.
+constexpr static const int FVK_PIPELINE_CACHE_SAVE_INTERVAL = 300;
+
+// Initial uploads of buffers at least this large are recorded on the dedicated transfer queue (if
+// the device has one), so that the copy can overlap with rendering. Smaller uploads aren't worth
+// the extra submission and queue family ownership transfer.
+constexpr static const uint32_t FVK_TRANSFER_QUEUE_MIN_UPLOAD_SIZE = 256 * 1024;
+
+// Size of the persistently mapped ring buffer that small buffer stages are sub-allocated from, and
+// the largest stage that is sub-allocated. Larger stages get their own VkBuffer from the pool.
+constexpr static const uint32_t FVK_STAGE_RING_SIZE = 4 * 1024 * 1024;
+constexpr static const uint32_t FVK_STAGE_RING_MAX_ALLOCATION = 64 * 1024;
+static_assert(FVK_STAGE_RING_MAX_ALLOCATION <= FVK_STAGE_RING_SIZE / 4);
+
 #endif
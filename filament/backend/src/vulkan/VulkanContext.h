@@ -124,10 +124,23 @@ public:
         return mMultiviewEnabled;
     }
 
+    inline bool isMemoryBudgetSupported() const noexcept {
+        return mMemoryBudgetSupported;
+    }
+
+    inline bool isTimelineSemaphoreSupported() const noexcept {
+        return mTimelineSemaphoreSupported;
+    }
+
     inline bool isClipDistanceSupported() const noexcept {
         return mPhysicalDeviceFeatures.features.shaderClipDistance == VK_TRUE;
     }
 
+    inline bool isSparseResidencyImage2DSupported() const noexcept {
+        return mPhysicalDeviceFeatures.features.sparseBinding == VK_TRUE &&
+               mPhysicalDeviceFeatures.features.sparseResidencyImage2D == VK_TRUE;
+    }
+
     inline bool isLazilyAllocatedMemorySupported() const noexcept {
         return mLazilyAllocatedMemorySupported;
     }
@@ -158,6 +171,8 @@ private:
     bool mDebugMarkersSupported = false;
     bool mDebugUtilsSupported = false;
     bool mMultiviewEnabled = false;
+    bool mMemoryBudgetSupported = false;
+    bool mTimelineSemaphoreSupported = false;
     bool mLazilyAllocatedMemorySupported = false;
     bool mProtectedMemorySupported = false;
 
@@ -106,6 +106,10 @@ public:
         return mCapacity;
     }
 
+    uint16_t size() const noexcept {
+        return mSize;
+    }
+
     // A convenience method for checking if this pool can allocate sets for a given layout.
     inline bool canAllocate(DescriptorCount const& count) {
         return count == mCount;
@@ -244,6 +248,14 @@ public:
         }
     }
 
+    void getStats(Stats& stats) const noexcept {
+        stats.pools = uint32_t(mPools.size());
+        stats.allocatedSets = 0;
+        for (auto const& pool: mPools) {
+            stats.allocatedSets += pool->size();
+        }
+    }
+
 private:
     VkDevice mDevice;
     std::vector<std::unique_ptr<DescriptorPool>> mPools;
@@ -259,6 +271,13 @@ VulkanDescriptorSetCache::VulkanDescriptorSetCache(VkDevice device,
 VulkanDescriptorSetCache::~VulkanDescriptorSetCache() = default;
 
 void VulkanDescriptorSetCache::terminate() noexcept{
+#if FVK_ENABLED(FVK_DEBUG_DESCRIPTOR_SET)
+    Stats const stats = getStats();
+    FVK_LOGD << "Descriptor sets: pools=" << stats.pools << " allocated=" << stats.allocatedSets
+             << " created=" << stats.createdSets << " writes=" << stats.descriptorWrites
+             << " binds=" << stats.binds << " skipped-commits=" << stats.skippedCommits
+             << utils::io::endl;
+#endif
     mDescriptorPool.reset();
     clearHistory();
 }
@@ -294,9 +313,11 @@ void VulkanDescriptorSetCache::commit(VulkanCommandBuffer* commands,
     if (curMask.none() &&
             (mLastBoundInfo.pipelineLayout == pipelineLayout && mLastBoundInfo.setMask == setMask &&
                     mLastBoundInfo.boundSets == updateSets)) {
+        mStats.skippedCommits++;
         return;
     }
 
+    mStats.binds += curMask.count();
     curMask.forEachSetBit([&updateSets, commands, pipelineLayout](size_t index) {
         // This code actually binds the descriptor sets.
         auto set = updateSets[index];
@@ -338,6 +359,7 @@ void VulkanDescriptorSetCache::updateBuffer(fvkmemory::resource_ptr<VulkanDescri
         .pBufferInfo = &info,
     };
     vkUpdateDescriptorSets(mDevice, 1, &descriptorWrite, 0, nullptr);
+    mStats.descriptorWrites++;
     set->acquire(bufferObject);
 }
 
@@ -370,6 +392,7 @@ void VulkanDescriptorSetCache::updateSampler(fvkmemory::resource_ptr<VulkanDescr
         .pImageInfo = &info,
     };
     vkUpdateDescriptorSets(mDevice, 1, &descriptorWrite, 0, nullptr);
+    mStats.descriptorWrites++;
     set->acquire(texture);
 }
 
@@ -382,6 +405,7 @@ void VulkanDescriptorSetCache::updateInputAttachment(
 fvkmemory::resource_ptr<VulkanDescriptorSet> VulkanDescriptorSetCache::createSet(
         Handle<HwDescriptorSet> handle, fvkmemory::resource_ptr<VulkanDescriptorSetLayout> layout) {
     auto const vkSet = mDescriptorPool->obtainSet(layout);
+    mStats.createdSets++;
     auto const& count = layout->count;
     auto const vklayout = layout->getVkLayout();
     return fvkmemory::resource_ptr<VulkanDescriptorSet>::make(mResourceManager, handle, vkSet,
@@ -399,4 +423,12 @@ void VulkanDescriptorSetCache::clearHistory() {
     mStashedSets = {};
 }
 
+VulkanDescriptorSetCache::Stats VulkanDescriptorSetCache::getStats() const noexcept {
+    Stats stats = mStats;
+    if (mDescriptorPool) {
+        mDescriptorPool->getStats(stats);
+    }
+    return stats;
+}
+
 } // namespace filament::backend
@@ -70,6 +70,17 @@ public:
 
     void clearHistory();
 
+    struct Stats {
+        uint32_t pools = 0;                 // VkDescriptorPools created
+        uint32_t allocatedSets = 0;         // VkDescriptorSets allocated from the pools
+        uint64_t createdSets = 0;           // sets handed out, new or recycled
+        uint64_t descriptorWrites = 0;      // descriptors written with vkUpdateDescriptorSets
+        uint64_t binds = 0;                 // sets bound with vkCmdBindDescriptorSets
+        uint64_t skippedCommits = 0;        // commits where everything was already bound
+    };
+
+    Stats getStats() const noexcept;
+
 private:
     class DescriptorInfinitePool;
 
@@ -81,6 +92,7 @@ private:
     std::unique_ptr<DescriptorInfinitePool> mDescriptorPool;
     std::pair<VulkanAttachment, VkDescriptorImageInfo> mInputAttachment;
     DescriptorSetArray mStashedSets = {};
+    Stats mStats;
 
     struct {
         VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
@@ -36,6 +36,8 @@
 #include <utils/CString.h>
 #include <utils/Panic.h>
 
+#include <vector>
+
 #ifndef NDEBUG
 #include <set>  // For VulkanDriver::debugCommandBegin
 #endif
@@ -55,7 +57,7 @@ namespace filament::backend {
 namespace {
 
 VmaAllocator createAllocator(VkInstance instance, VkPhysicalDevice physicalDevice,
-        VkDevice device) {
+        VkDevice device, bool memoryBudgetSupported) {
     VmaAllocator allocator;
     VmaVulkanFunctions const funcs {
 #if VMA_DYNAMIC_VULKAN_FUNCTIONS
@@ -84,6 +86,8 @@ VmaAllocator createAllocator(VkInstance instance, VkPhysicalDevice physicalDevic
 #endif
     };
     VmaAllocatorCreateInfo const allocatorInfo {
+        // without VK_EXT_memory_budget, VMA estimates the budget from the heap sizes
+        .flags = memoryBudgetSupported ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT : 0u,
         .physicalDevice = physicalDevice,
         .device = device,
         .pVulkanFunctions = &funcs,
@@ -203,13 +207,14 @@ VulkanDriver::VulkanDriver(VulkanPlatform* platform, VulkanContext const& contex
               driverConfig.disableHandleUseAfterFreeCheck,
               driverConfig.disableHeapHandleTags),
       mAllocator(createAllocator(mPlatform->getInstance(), mPlatform->getPhysicalDevice(),
-              mPlatform->getDevice())),
+              mPlatform->getDevice(), context.isMemoryBudgetSupported())),
       mContext(context),
       mCommands(mPlatform->getDevice(), mPlatform->getGraphicsQueue(),
               mPlatform->getGraphicsQueueFamilyIndex(), mPlatform->getProtectedGraphicsQueue(),
-              mPlatform->getProtectedGraphicsQueueFamilyIndex(), &mContext),
+              mPlatform->getProtectedGraphicsQueueFamilyIndex(), mPlatform->getTransferQueue(),
+              mPlatform->getTransferQueueFamilyIndex(), &mContext),
       mPipelineLayoutCache(mPlatform->getDevice()),
-      mPipelineCache(mPlatform->getDevice()),
+      mPipelineCache(*mPlatform, mPlatform->getPhysicalDevice(), mPlatform->getDevice()),
       mStagePool(mAllocator, &mCommands),
       mFramebufferCache(mPlatform->getDevice()),
       mSamplerCache(mPlatform->getDevice()),
@@ -365,9 +370,21 @@ void VulkanDriver::collectGarbage() {
     mCommands.gc();
     mDescriptorSetCache.clearHistory();
     mStagePool.gc();
-    mFramebufferCache.gc();
+    // Pipelines being pre-warmed reference their render pass, which must stay alive until they're
+    // created.
+    if (!mPipelineCache.isPrewarming()) {
+        mFramebufferCache.gc();
+    }
     mPipelineCache.gc();
 
+    if (!mPrewarmCallbacks.empty() && !mPipelineCache.isPrewarming()) {
+        for (auto const& prewarmCallback: mPrewarmCallbacks) {
+            scheduleCallback(prewarmCallback.handler, prewarmCallback.user,
+                    prewarmCallback.callback);
+        }
+        mPrewarmCallbacks.clear();
+    }
+
     mResourceManager.gc();
 
 #if FVK_ENABLED(FVK_DEBUG_RESOURCE_LEAK)
@@ -391,10 +408,15 @@ void VulkanDriver::setFrameCompletedCallback(Handle<HwSwapChain> sch,
 void VulkanDriver::setPresentationTime(int64_t monotonic_clock_ns) {
 }
 
+void VulkanDriver::setPresentationDamage(Viewport region) {
+}
+
 void VulkanDriver::endFrame(uint32_t frameId) {
     FVK_PROFILE_MARKER(PROFILE_NAME_ENDFRAME);
     mCommands.flush();
     collectGarbage();
+    // this also refreshes the memory budget
+    vmaSetCurrentFrameIndex(mAllocator, frameId);
 }
 
 void VulkanDriver::updateDescriptorSetBuffer(
@@ -523,6 +545,10 @@ void VulkanDriver::createTextureR(Handle<HwTexture> th, SamplerType target, uint
             mPlatform->getPhysicalDevice(), mContext, mAllocator, &mResourceManager, &mCommands,
             target, levels, format, samples, w, h, depth, usage, mStagePool);
 
+    if (texture->isSparse()) {
+        texture->initSparse(mPlatform->getGraphicsQueue());
+    }
+
     // Do transition to default layout.
     VulkanCommandBuffer& commandsBuf = mCommands.get();
     auto const& primaryViewRange = texture->getPrimaryViewRange();
@@ -636,6 +662,20 @@ void VulkanDriver::destroyProgram(Handle<HwProgram> ph) {
     vprogram.dec();
 }
 
+void VulkanDriver::createPipelineStateR(Handle<HwPipelineState> psh,
+        PipelineState const& state) {
+    auto ps = resource_ptr<VulkanPipelineState>::make(&mResourceManager, psh, state);
+    ps.inc();
+}
+
+void VulkanDriver::destroyPipelineState(Handle<HwPipelineState> psh) {
+    if (!psh) {
+        return;
+    }
+    auto ps = resource_ptr<VulkanPipelineState>::cast(&mResourceManager, psh);
+    ps.dec();
+}
+
 void VulkanDriver::createDefaultRenderTargetR(Handle<HwRenderTarget> rth, int) {
     assert_invariant(!mDefaultRenderTarget);
     auto renderTarget = resource_ptr<VulkanRenderTarget>::make(&mResourceManager, rth);
@@ -841,6 +881,10 @@ Handle<HwProgram> VulkanDriver::createProgramS() noexcept {
     return mResourceManager.allocHandle<VulkanProgram>();
 }
 
+Handle<HwPipelineState> VulkanDriver::createPipelineStateS() noexcept {
+    return mResourceManager.allocHandle<VulkanPipelineState>();
+}
+
 Handle<HwRenderTarget> VulkanDriver::createDefaultRenderTargetS() noexcept {
     return mResourceManager.allocHandle<VulkanRenderTarget>();
 }
@@ -1063,6 +1107,21 @@ bool VulkanDriver::isDepthClampSupported() {
     return mContext.isDepthClampSupported();
 }
 
+MemoryBudget VulkanDriver::getMemoryBudget() {
+    VkPhysicalDeviceMemoryProperties const* properties;
+    vmaGetMemoryProperties(mAllocator, &properties);
+    VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+    vmaGetHeapBudgets(mAllocator, budgets);
+    MemoryBudget budget;
+    for (uint32_t i = 0; i < properties->memoryHeapCount; i++) {
+        if (properties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
+            budget.usage += budgets[i].usage;
+            budget.budget += budgets[i].budget;
+        }
+    }
+    return budget;
+}
+
 bool VulkanDriver::isWorkaroundNeeded(Workaround workaround) {
     switch (workaround) {
         case Workaround::SPLIT_EASU: {
@@ -1158,6 +1217,29 @@ size_t VulkanDriver::getMaxArrayTextureLayers() {
     return mContext.getPhysicalDeviceLimits().maxImageArrayLayers;
 }
 
+math::uint3 VulkanDriver::getSparseTexturePageSize(SamplerType target, TextureFormat format) {
+    if (target != SamplerType::SAMPLER_2D || !mContext.isSparseResidencyImage2DSupported()) {
+        return {};
+    }
+    VkFormat const vkFormat = fvkutils::getVkFormat(format);
+    VkImageUsageFlags const usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    uint32_t count = 0;
+    vkGetPhysicalDeviceSparseImageFormatProperties(mPlatform->getPhysicalDevice(), vkFormat,
+            VK_IMAGE_TYPE_2D, VK_SAMPLE_COUNT_1_BIT, usage, VK_IMAGE_TILING_OPTIMAL, &count,
+            nullptr);
+    std::vector<VkSparseImageFormatProperties> properties(count);
+    vkGetPhysicalDeviceSparseImageFormatProperties(mPlatform->getPhysicalDevice(), vkFormat,
+            VK_IMAGE_TYPE_2D, VK_SAMPLE_COUNT_1_BIT, usage, VK_IMAGE_TILING_OPTIMAL, &count,
+            properties.data());
+    for (auto const& p: properties) {
+        if (p.aspectMask & VK_IMAGE_ASPECT_COLOR_BIT) {
+            VkExtent3D const granularity = p.imageGranularity;
+            return { granularity.width, granularity.height, granularity.depth };
+        }
+    }
+    return {};
+}
+
 void VulkanDriver::setVertexBufferObject(Handle<HwVertexBuffer> vbh, uint32_t index,
         Handle<HwBufferObject> boh) {
     auto vb = resource_ptr<VulkanVertexBuffer>::cast(&mResourceManager, vbh);
@@ -1166,12 +1248,28 @@ void VulkanDriver::setVertexBufferObject(Handle<HwVertexBuffer> vbh, uint32_t in
     vb->setBuffer(bo, index);
 }
 
+void VulkanDriver::loadBuffer(resource_ptr<fvkmemory::Resource> owner, VulkanBuffer& buffer,
+        void const* data, uint32_t byteOffset, uint32_t byteCount) {
+    VulkanCommandBuffer& commands = mCommands.get();
+    commands.acquire(owner);
+
+    // Large initial uploads go through the transfer queue so that they can overlap with the
+    // rendering that's already been submitted.
+    if (mCommands.hasTransferQueue() && buffer.canLoadOnTransferQueue(byteCount)) {
+        VulkanCommandBuffer& transfer = mCommands.getTransfer();
+        transfer.acquire(owner);
+        buffer.loadFromCpu(transfer, mCommands.getTransferQueueFamilyIndex(), commands,
+                mCommands.getQueueFamilyIndex(), data, byteOffset, byteCount);
+        return;
+    }
+
+    buffer.loadFromCpu(commands, data, byteOffset, byteCount);
+}
+
 void VulkanDriver::updateIndexBuffer(Handle<HwIndexBuffer> ibh, BufferDescriptor&& p,
         uint32_t byteOffset) {
-    VulkanCommandBuffer& commands = mCommands.get();
     auto ib = resource_ptr<VulkanIndexBuffer>::cast(&mResourceManager, ibh);
-    commands.acquire(ib);
-    ib->buffer.loadFromCpu(commands.buffer(), p.buffer, byteOffset, p.size);
+    loadBuffer(ib, ib->buffer, p.buffer, byteOffset, p.size);
 
     scheduleDestroy(std::move(p));
 }
@@ -1182,11 +1280,8 @@ void VulkanDriver::registerBufferObjectStreams(Handle<HwBufferObject> boh, Buffe
 
 void VulkanDriver::updateBufferObject(Handle<HwBufferObject> boh, BufferDescriptor&& bd,
         uint32_t byteOffset) {
-    VulkanCommandBuffer& commands = mCommands.get();
-
     auto bo = resource_ptr<VulkanBufferObject>::cast(&mResourceManager, boh);
-    commands.acquire(bo);
-    bo->buffer.loadFromCpu(commands.buffer(), bd.buffer, byteOffset, bd.size);
+    loadBuffer(bo, bo->buffer, bd.buffer, byteOffset, bd.size);
 
     scheduleDestroy(std::move(bd));
 }
@@ -1197,7 +1292,7 @@ void VulkanDriver::updateBufferObjectUnsynchronized(Handle<HwBufferObject> boh,
     auto bo = resource_ptr<VulkanBufferObject>::cast(&mResourceManager, boh);
     commands.acquire(bo);
     // TODO: implement unsynchronized version
-    bo->buffer.loadFromCpu(commands.buffer(), bd.buffer, byteOffset, bd.size);
+    bo->buffer.loadFromCpu(commands, bd.buffer, byteOffset, bd.size);
     scheduleDestroy(std::move(bd));
 }
 
@@ -1299,13 +1394,79 @@ void VulkanDriver::generateMipmaps(Handle<HwTexture> th) {
     } while ((srcw > 1 || srch > 1) && ++level < t->levels - 1);
 }
 
+void VulkanDriver::commitTexturePages(Handle<HwTexture> th, uint32_t level, uint32_t xoffset,
+        uint32_t yoffset, uint32_t width, uint32_t height, bool commit) {
+    FVK_SYSTRACE_SCOPE();
+    auto texture = resource_ptr<VulkanTexture>::cast(&mResourceManager, th);
+    assert_invariant(texture->isSparse());
+    if (!commit) {
+        // The memory of the released pages can't be in use by the GPU. Commits don't need to
+        // wait, the command buffers that use the new pages are submitted after the bindings.
+        mCommands.flush();
+        mCommands.wait();
+    }
+    texture->commitPages(mPlatform->getGraphicsQueue(), level, xoffset, yoffset, width, height,
+            commit);
+}
+
 void VulkanDriver::compilePrograms(CompilerPriorityQueue priority,
         CallbackHandler* handler, CallbackHandler::Callback callback, void* user) {
     if (callback) {
-        scheduleCallback(handler, user, callback);
+        // Programs are compiled synchronously, but pipelines may still be pre-warming, in which
+        // case the callback is deferred until they're all created (see collectGarbage()).
+        if (mPipelineCache.isPrewarming()) {
+            mPrewarmCallbacks.push_back({ handler, callback, user });
+        } else {
+            scheduleCallback(handler, user, callback);
+        }
     }
 }
 
+void VulkanDriver::prewarmPipeline(Handle<HwRenderTarget> rth, const RenderPassParams& params,
+        PipelineState const& pipelineState) {
+    FVK_SYSTRACE_SCOPE();
+
+    auto rt = resource_ptr<VulkanRenderTarget>::cast(&mResourceManager, rth);
+    auto program = resource_ptr<VulkanProgram>::cast(&mResourceManager, pipelineState.program);
+
+    // Pipelines are keyed by their VkRenderPass, so this must match what beginRenderPass() does
+    // for the pipeline to be found later. If it doesn't (e.g. for the first pass on a swap chain),
+    // the pipeline is still in the VkPipelineCache, which makes its creation much cheaper.
+    TargetBufferFlags clearVal = params.flags.clear;
+    TargetBufferFlags discardEndVal = params.flags.discardEnd;
+    VulkanLayout currentDepthLayout = VulkanLayout::UNDEFINED;
+    if (rt->hasDepth()) {
+        if (params.readOnlyDepthStencil & RenderPassParams::READONLY_DEPTH) {
+            discardEndVal &= ~TargetBufferFlags::DEPTH;
+            clearVal &= ~TargetBufferFlags::DEPTH;
+        }
+        currentDepthLayout = VulkanLayout::DEPTH_ATTACHMENT;
+    }
+
+    VulkanFboCache::RenderPassKey rpkey = rt->getRenderPassKey();
+    rpkey.clear = clearVal;
+    rpkey.discardStart = params.flags.discardStart;
+    rpkey.discardEnd = discardEndVal;
+    rpkey.initialDepthLayout = currentDepthLayout;
+    rpkey.subpassMask = uint8_t(params.subpassMask);
+
+    VulkanRenderPass const renderPass = {
+        .renderTarget = rt,
+        .renderPass = mFramebufferCache.getRenderPass(rpkey),
+        .params = params,
+        .currentSubpass = 0,
+    };
+
+    mPipelineCache.bindRenderPass(renderPass.renderPass, 0);
+    bindPipelineImpl(pipelineState, program, renderPass);
+    mPipelineCache.prewarmPipeline(program);
+
+    // restore the render pass of the current render pass, the other states are always set
+    // by bindPipeline().
+    mPipelineCache.bindRenderPass(mCurrentRenderPass.renderPass,
+            mCurrentRenderPass.currentSubpass);
+}
+
 void VulkanDriver::beginRenderPass(Handle<HwRenderTarget> rth, const RenderPassParams& params) {
     FVK_SYSTRACE_SCOPE();
 
@@ -1715,18 +1876,40 @@ void VulkanDriver::blitDEPRECATED(TargetBufferFlags buffers,
 void VulkanDriver::bindPipeline(PipelineState const& pipelineState) {
     FVK_SYSTRACE_SCOPE();
     auto commands = mCurrentRenderPass.commandBuffer;
+
+    auto program = resource_ptr<VulkanProgram>::cast(&mResourceManager, pipelineState.program);
+    commands->acquire(program);
+
+    auto const [pipelineLayout, layoutCount] =
+            bindPipelineImpl(pipelineState, program, mCurrentRenderPass);
+
+    constexpr uint8_t descriptorSetMaskTable[4] = {0x1, 0x3, 0x7, 0xF};
+
+    mBoundPipeline = {
+        .program = program,
+        .pipelineLayout = pipelineLayout,
+        .descriptorSetMask = fvkutils::DescriptorSetMask(descriptorSetMaskTable[layoutCount]),
+    };
+
+    mPipelineCache.bindPipeline(mCurrentRenderPass.commandBuffer);
+}
+
+void VulkanDriver::bindPipelineState(Handle<HwPipelineState> psh) {
+    auto ps = resource_ptr<VulkanPipelineState>::cast(&mResourceManager, psh);
+    bindPipeline(ps->state);
+}
+
+std::pair<VkPipelineLayout, uint8_t> VulkanDriver::bindPipelineImpl(
+        PipelineState const& pipelineState, resource_ptr<VulkanProgram> program,
+        VulkanRenderPass const& renderPass) {
     auto vbi = resource_ptr<VulkanVertexBufferInfo>::cast(&mResourceManager,
             pipelineState.vertexBufferInfo);
 
-    Handle<HwProgram> programHandle = pipelineState.program;
     RasterState const& rasterState = pipelineState.rasterState;
     PolygonOffset const& depthOffset = pipelineState.polygonOffset;
 
-    auto program = resource_ptr<VulkanProgram>::cast(&mResourceManager, programHandle);
-    commands->acquire(program);
-
     // Update the VK raster state.
-    auto rt = mCurrentRenderPass.renderTarget;
+    auto rt = renderPass.renderTarget;
 
     VulkanPipelineCache::RasterState const vulkanRasterState{
         .cullMode = fvkutils::getCullMode(rasterState.culling),
@@ -1742,7 +1925,7 @@ void VulkanDriver::bindPipeline(PipelineState const& pipelineState) {
         .colorWriteMask = (VkColorComponentFlags) (rasterState.colorWrite ? 0xf : 0x0),
         .rasterizationSamples = rt->getSamples(),
         .depthClamp = rasterState.depthClamp,
-        .colorTargetCount = rt->getColorTargetCount(mCurrentRenderPass),
+        .colorTargetCount = rt->getColorTargetCount(renderPass),
         .colorBlendOp = rasterState.blendEquationRGB,
         .alphaBlendOp = rasterState.blendEquationAlpha,
         .depthCompareOp = rasterState.depthFunc,
@@ -1779,16 +1962,8 @@ void VulkanDriver::bindPipeline(PipelineState const& pipelineState) {
             });
     auto pipelineLayout = mPipelineLayoutCache.getLayout(layoutList, program);
 
-    constexpr uint8_t descriptorSetMaskTable[4] = {0x1, 0x3, 0x7, 0xF};
-
-    mBoundPipeline = {
-        .program = program,
-        .pipelineLayout = pipelineLayout,
-        .descriptorSetMask = fvkutils::DescriptorSetMask(descriptorSetMaskTable[layoutCount]),
-    };
-
     mPipelineCache.bindLayout(pipelineLayout);
-    mPipelineCache.bindPipeline(mCurrentRenderPass.commandBuffer);
+    return { pipelineLayout, layoutCount };
 }
 
 void VulkanDriver::bindRenderPrimitive(Handle<HwRenderPrimitive> rph) {
@@ -1843,6 +2018,13 @@ void VulkanDriver::draw2(uint32_t indexOffset, uint32_t indexCount, uint32_t ins
     vkCmdDrawIndexed(cmdbuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstId);
 }
 
+void VulkanDriver::multiDraw2(DrawRange const* ranges, uint32_t count) {
+    // the descriptor sets are committed by the first draw, the following ones are cheap
+    for (uint32_t i = 0; i < count; i++) {
+        draw2(ranges[i].indexOffset, ranges[i].indexCount, 1);
+    }
+}
+
 void VulkanDriver::draw(PipelineState state, Handle<HwRenderPrimitive> rph,
         uint32_t const indexOffset, uint32_t const indexCount, uint32_t const instanceCount) {
     auto rp = resource_ptr<VulkanRenderPrimitive>::cast(&mResourceManager, rph);
@@ -42,6 +42,9 @@
 #include <utils/Allocator.h>
 #include <utils/compiler.h>
 
+#include <utility>
+#include <vector>
+
 namespace filament::backend {
 
 class VulkanPlatform;
@@ -119,6 +122,15 @@ private:
 private:
     void collectGarbage();
 
+    // Pushes the state of `pipelineState` to mPipelineCache, for a pipeline used in `renderPass`.
+    // Returns the pipeline layout and the number of descriptor set layouts it uses.
+    std::pair<VkPipelineLayout, uint8_t> bindPipelineImpl(PipelineState const& pipelineState,
+            resource_ptr<VulkanProgram> program, VulkanRenderPass const& renderPass);
+
+    // Uploads `data` into `buffer`, which belongs to `owner`, on the transfer queue if possible.
+    void loadBuffer(resource_ptr<fvkmemory::Resource> owner, VulkanBuffer& buffer,
+            void const* data, uint32_t byteOffset, uint32_t byteCount);
+
     VulkanPlatform* mPlatform = nullptr;
     fvkmemory::ResourceManager mResourceManager;
 
@@ -157,6 +169,14 @@ private:
         AttachmentArray attachments;
     } mRenderPassFboInfo = {};
 
+    // compilePrograms() callbacks waiting for the pre-warmed pipelines to be created
+    struct PrewarmCallback {
+        CallbackHandler* handler;
+        CallbackHandler::Callback callback;
+        void* user;
+    };
+    std::vector<PrewarmCallback> mPrewarmCallbacks;
+
     bool const mIsSRGBSwapChainSupported;
     backend::StereoscopicType const mStereoscopicType;
 };
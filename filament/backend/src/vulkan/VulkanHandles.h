@@ -404,6 +404,11 @@ struct VulkanBufferObject : public HwBufferObject, fvkmemory::Resource {
     const BufferObjectBinding bindingType;
 };
 
+struct VulkanPipelineState : public HwPipelineState, fvkmemory::Resource {
+    explicit VulkanPipelineState(PipelineState const& state) noexcept
+            : HwPipelineState(state) {}
+};
+
 struct VulkanRenderPrimitive : public HwRenderPrimitive, fvkmemory::Resource {
     VulkanRenderPrimitive(PrimitiveType pt, fvkmemory::resource_ptr<VulkanVertexBuffer> vb,
             fvkmemory::resource_ptr<VulkanIndexBuffer> ib);
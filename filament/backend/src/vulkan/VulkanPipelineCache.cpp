@@ -16,6 +16,7 @@
 
 #include "VulkanPipelineCache.h"
 
+#include <utils/JobSystem.h>
 #include <utils/Log.h>
 #include <utils/Panic.h>
 
@@ -23,6 +24,14 @@
 #include "VulkanHandles.h"
 #include "vulkan/utils/Conversion.h"
 
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <string.h>
+
 #if defined(__clang__)
 // Vulkan functions often immediately dereference pointers, so it's fine to pass in a pointer
 // to a stack-allocated variable.
@@ -34,8 +43,78 @@ using namespace bluevk;
 
 namespace filament::backend {
 
-VulkanPipelineCache::VulkanPipelineCache(VkDevice device)
-        : mDevice(device) {}
+VulkanPipelineCache::VulkanPipelineCache(Platform& platform, VkPhysicalDevice physicalDevice,
+        VkDevice device)
+        : mPlatform(platform),
+          mDevice(device) {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    strncpy(mBlobKey.tag, "vk-pipelines", sizeof(mBlobKey.tag));
+    mBlobKey.vendorID = properties.vendorID;
+    mBlobKey.deviceID = properties.deviceID;
+    mBlobKey.driverVersion = properties.driverVersion;
+    memcpy(mBlobKey.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+    createPipelineCache();
+}
+
+void VulkanPipelineCache::createPipelineCache() noexcept {
+    std::vector<uint8_t> data;
+    if (mPlatform.hasRetrieveBlobFunc()) {
+        // the first call gives us the size of the data
+        uint8_t dummy;
+        size_t const size = mPlatform.retrieveBlob(&mBlobKey, sizeof(mBlobKey), &dummy, 0);
+        if (size > 0) {
+            data.resize(size);
+            if (mPlatform.retrieveBlob(&mBlobKey, sizeof(mBlobKey), data.data(), size) != size) {
+                data.clear();
+            }
+        }
+    }
+
+    // The driver validates the header of the initial data against the device and ignores it
+    // if it's incompatible, in which case the cache starts empty.
+    VkPipelineCacheCreateInfo const createInfo = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+            .initialDataSize = data.size(),
+            .pInitialData = data.empty() ? nullptr : data.data(),
+    };
+    VkResult result = vkCreatePipelineCache(mDevice, &createInfo, VKALLOC, &mPipelineCache);
+    if (result != VK_SUCCESS && !data.empty()) {
+        // some drivers fail rather than ignore bad data, try again with an empty cache
+        VkPipelineCacheCreateInfo const emptyInfo = {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        };
+        result = vkCreatePipelineCache(mDevice, &emptyInfo, VKALLOC, &mPipelineCache);
+    }
+    if (result != VK_SUCCESS) {
+        FVK_LOGW << "vkCreatePipelineCache error " << result << utils::io::endl;
+        mPipelineCache = VK_NULL_HANDLE;
+    }
+}
+
+void VulkanPipelineCache::savePipelineCache() noexcept {
+    mUnsavedPipelineCount = 0;
+    if (mPipelineCache == VK_NULL_HANDLE || !mPlatform.hasInsertBlobFunc()) {
+        return;
+    }
+
+    size_t size = 0;
+    VkResult result = vkGetPipelineCacheData(mDevice, mPipelineCache, &size, nullptr);
+    if (result != VK_SUCCESS || !size) {
+        return;
+    }
+    std::vector<uint8_t> data(size);
+    result = vkGetPipelineCacheData(mDevice, mPipelineCache, &size, data.data());
+    if (result == VK_INCOMPLETE) {
+        // the cache grew in the meantime because of a pre-warmed pipeline, try again later
+        mUnsavedPipelineCount = 1;
+        return;
+    }
+    if (result != VK_SUCCESS) {
+        return;
+    }
+    mPlatform.insertBlob(&mBlobKey, sizeof(mBlobKey), data.data(), size);
+}
 
 void VulkanPipelineCache::bindLayout(VkPipelineLayout layout) noexcept {
     mPipelineRequirements.layout = layout;
@@ -43,10 +122,14 @@ void VulkanPipelineCache::bindLayout(VkPipelineLayout layout) noexcept {
 
 VulkanPipelineCache::PipelineCacheEntry* VulkanPipelineCache::getOrCreatePipeline() noexcept {
     // If a cached object exists, re-use it, otherwise create a new one.
-    if (PipelineMap::iterator pipelineIter = mPipelines.find(mPipelineRequirements);
-            pipelineIter != mPipelines.end()) {
+    PipelineMap::iterator pipelineIter = mPipelines.find(mPipelineRequirements);
+    if (UTILS_UNLIKELY(pipelineIter == mPipelines.end() && waitForPrewarmedPipeline())) {
+        pipelineIter = mPipelines.find(mPipelineRequirements);
+    }
+    if (pipelineIter != mPipelines.end()) {
         auto& pipeline = pipelineIter.value();
         pipeline.lastUsed = mCurrentTime;
+        pipeline.prewarmed = false;
         return &pipeline;
     }
     auto ret = createPipeline();
@@ -66,26 +149,43 @@ void VulkanPipelineCache::bindPipeline(VulkanCommandBuffer* commands) {
 }
 
 VulkanPipelineCache::PipelineCacheEntry* VulkanPipelineCache::createPipeline() noexcept {
-    assert_invariant(mPipelineRequirements.shaders[0] && "Vertex shader is not bound.");
-    assert_invariant(mPipelineRequirements.layout && "No pipeline layout specified");
+    VkPipeline const handle = createVkPipeline(mDevice, mPipelineCache, mPipelineRequirements);
+    if (handle == VK_NULL_HANDLE) {
+        return nullptr;
+    }
+    if (!mUnsavedPipelineCount++) {
+        mFirstUnsavedPipelineTime = mCurrentTime;
+    }
+    PipelineCacheEntry const cacheEntry = {
+        .handle = handle,
+        .lastUsed = mCurrentTime,
+        .prewarmed = false,
+    };
+    return &mPipelines.emplace(mPipelineRequirements, cacheEntry).first.value();
+}
+
+VkPipeline VulkanPipelineCache::createVkPipeline(VkDevice device, VkPipelineCache pipelineCache,
+        PipelineKey const& key) noexcept {
+    assert_invariant(key.shaders[0] && "Vertex shader is not bound.");
+    assert_invariant(key.layout && "No pipeline layout specified");
 
     VkPipelineShaderStageCreateInfo shaderStages[SHADER_MODULE_COUNT];
     shaderStages[0] = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
         .stage = VK_SHADER_STAGE_VERTEX_BIT,
-        .module = mPipelineRequirements.shaders[0],
+        .module = key.shaders[0],
         .pName = "main",
     };
     shaderStages[1] = shaderStages[0];
     shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    shaderStages[1].module = mPipelineRequirements.shaders[1];
+    shaderStages[1].module = key.shaders[1];
 
     bool const hasFragmentShader = shaderStages[1].module != VK_NULL_HANDLE;
 
     VkPipelineColorBlendAttachmentState colorBlendAttachments[MRT::MAX_SUPPORTED_RENDER_TARGET_COUNT];
     VkPipelineColorBlendStateCreateInfo colorBlendState = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
-        .attachmentCount = mPipelineRequirements.rasterState.colorTargetCount,
+        .attachmentCount = key.rasterState.colorTargetCount,
         .pAttachments = colorBlendAttachments,
     };
 
@@ -96,11 +196,11 @@ VulkanPipelineCache::PipelineCacheEntry* VulkanPipelineCache::createPipeline() n
     VkVertexInputAttributeDescription vertexAttributes[VERTEX_ATTRIBUTE_COUNT];
     VkVertexInputBindingDescription vertexBuffers[VERTEX_ATTRIBUTE_COUNT];
     for (uint32_t i = 0; i < VERTEX_ATTRIBUTE_COUNT; i++) {
-        if (mPipelineRequirements.vertexAttributes[i].format > 0) {
-            vertexAttributes[numVertexAttribs++] = mPipelineRequirements.vertexAttributes[i];
+        if (key.vertexAttributes[i].format > 0) {
+            vertexAttributes[numVertexAttribs++] = key.vertexAttributes[i];
         }
-        if (mPipelineRequirements.vertexBuffers[i].stride > 0) {
-            vertexBuffers[numVertexBuffers++] = mPipelineRequirements.vertexBuffers[i];
+        if (key.vertexBuffers[i].stride > 0) {
+            vertexBuffers[numVertexBuffers++] = key.vertexBuffers[i];
         }
     }
     VkPipelineVertexInputStateCreateInfo vertexInputState = {
@@ -112,7 +212,7 @@ VulkanPipelineCache::PipelineCacheEntry* VulkanPipelineCache::createPipeline() n
     };
     VkPipelineInputAssemblyStateCreateInfo inputAssemblyState = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
-        .topology = (VkPrimitiveTopology) mPipelineRequirements.topology,
+        .topology = (VkPrimitiveTopology) key.topology,
     };
     VkPipelineViewportStateCreateInfo viewportState = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
@@ -128,7 +228,7 @@ VulkanPipelineCache::PipelineCacheEntry* VulkanPipelineCache::createPipeline() n
         .dynamicStateCount = 2,
         .pDynamicStates = dynamicStateEnables,
     };
-    auto const& raster = mPipelineRequirements.rasterState;
+    auto const& raster = key.rasterState;
     VkPipelineRasterizationStateCreateInfo vkRaster = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
         .depthClampEnable = raster.depthClamp,
@@ -181,9 +281,9 @@ VulkanPipelineCache::PipelineCacheEntry* VulkanPipelineCache::createPipeline() n
         .pDepthStencilState = &vkDs,
         .pColorBlendState = &colorBlendState,
         .pDynamicState = &dynamicState,
-        .layout = mPipelineRequirements.layout,
-        .renderPass = mPipelineRequirements.renderPass,
-        .subpass = mPipelineRequirements.subpassIndex,
+        .layout = key.layout,
+        .renderPass = key.renderPass,
+        .subpass = key.subpassIndex,
     };
 
     // There are no color attachments if there is no bound fragment shader.  (e.g. shadow map gen)
@@ -212,17 +312,98 @@ VulkanPipelineCache::PipelineCacheEntry* VulkanPipelineCache::createPipeline() n
                  << shaderStages[0].module << ", " << shaderStages[1].module << ")"
                  << utils::io::endl;
     #endif
-    PipelineCacheEntry cacheEntry = {
-        .lastUsed = mCurrentTime,
-    };
-    VkResult error = vkCreateGraphicsPipelines(mDevice, VK_NULL_HANDLE, 1, &pipelineCreateInfo,
-            VKALLOC, &cacheEntry.handle);
+    VkPipeline handle = VK_NULL_HANDLE;
+    VkResult error = vkCreateGraphicsPipelines(device, pipelineCache, 1, &pipelineCreateInfo,
+            VKALLOC, &handle);
     assert_invariant(error == VK_SUCCESS);
     if (error != VK_SUCCESS) {
         FVK_LOGE << "vkCreateGraphicsPipelines error " << error << utils::io::endl;
-        return nullptr;
+        return VK_NULL_HANDLE;
     }
-    return &mPipelines.emplace(mPipelineRequirements, cacheEntry).first.value();
+    return handle;
+}
+
+VulkanPipelineCache::PrewarmToken::~PrewarmToken() = default;
+
+void VulkanPipelineCache::prewarmPipeline(fvkmemory::resource_ptr<VulkanProgram> program) {
+    if (mPipelines.find(mPipelineRequirements) != mPipelines.end() ||
+            mPrewarmingPipelines.find(mPipelineRequirements) != mPrewarmingPipelines.end()) {
+        return;
+    }
+
+    if (UTILS_UNLIKELY(!mCompilerThreadPoolInitialized)) {
+        // Pipeline creation is thread-safe, and so is the VkPipelineCache unless it was created
+        // with VK_PIPELINE_CACHE_CREATE_EXTERNALLY_SYNCHRONIZED_BIT.
+        uint32_t const threadCount = std::max(1u, (std::thread::hardware_concurrency() + 1) / 2);
+        mCompilerThreadPool.init(threadCount, []() {
+            utils::JobSystem::setThreadName("CompilerThreadPool");
+            utils::JobSystem::setThreadPriority(utils::JobSystem::Priority::BACKGROUND);
+        }, []() {});
+        mCompilerThreadPoolInitialized = true;
+    }
+
+    auto token = std::make_shared<PrewarmToken>();
+    mCompilerThreadPool.queue(CompilerPriorityQueue::LOW, token,
+            [this, token, key = mPipelineRequirements]() {
+                VkPipeline const handle = createVkPipeline(mDevice, mPipelineCache, key);
+                std::unique_lock const lock(mPrewarmLock);
+                token->handle = handle;
+                token->ready = true;
+                mPrewarmCondition.notify_all();
+            });
+    mPrewarmingPipelines.emplace(mPipelineRequirements, PrewarmEntry{ token, program });
+}
+
+void VulkanPipelineCache::collectPrewarmedPipelines() noexcept {
+    std::unique_lock const lock(mPrewarmLock);
+    // NOTE: Due to robin_map restrictions, we cannot use auto or range-based loops.
+    using PrewarmIterator = decltype(mPrewarmingPipelines)::const_iterator;
+    for (PrewarmIterator iter = mPrewarmingPipelines.begin();
+            iter != mPrewarmingPipelines.end();) {
+        PrewarmToken const& token = *iter->second.token;
+        if (!token.ready) {
+            ++iter;
+            continue;
+        }
+        if (token.handle != VK_NULL_HANDLE) {
+            PipelineCacheEntry const cacheEntry = {
+                .handle = token.handle,
+                .lastUsed = mCurrentTime,
+                .prewarmed = true,
+            };
+            if (!mPipelines.emplace(iter->first, cacheEntry).second) {
+                vkDestroyPipeline(mDevice, token.handle, VKALLOC);
+            } else if (!mUnsavedPipelineCount++) {
+                mFirstUnsavedPipelineTime = mCurrentTime;
+            }
+        }
+        iter = mPrewarmingPipelines.erase(iter);
+    }
+}
+
+bool VulkanPipelineCache::waitForPrewarmedPipeline() noexcept {
+    if (mPrewarmingPipelines.empty()) {
+        return false;
+    }
+    PrewarmMap::iterator const iter = mPrewarmingPipelines.find(mPipelineRequirements);
+    if (iter == mPrewarmingPipelines.end()) {
+        return false;
+    }
+
+    std::shared_ptr<PrewarmToken> const token = iter->second.token;
+
+    // if the job hasn't started yet, run it now rather than waiting for it
+    CompilerThreadPool::Job job = mCompilerThreadPool.dequeue(token);
+    if (job) {
+        job();
+    }
+
+    std::unique_lock lock(mPrewarmLock);
+    mPrewarmCondition.wait(lock, [&token]() { return token->ready; });
+    lock.unlock();
+
+    collectPrewarmedPipelines();
+    return true;
 }
 
 void VulkanPipelineCache::bindProgram(fvkmemory::resource_ptr<VulkanProgram> program) noexcept {
@@ -266,11 +447,24 @@ void VulkanPipelineCache::bindVertexArray(VkVertexInputAttributeDescription cons
 }
 
 void VulkanPipelineCache::terminate() noexcept {
+    // wait for the pipelines being created, the ones that haven't started yet are dropped
+    mCompilerThreadPool.terminate();
+    collectPrewarmedPipelines();
+    mPrewarmingPipelines.clear();
+
     for (auto& iter : mPipelines) {
         vkDestroyPipeline(mDevice, iter.second.handle, VKALLOC);
     }
     mPipelines.clear();
     mBoundPipeline = {};
+
+    if (mPipelineCache != VK_NULL_HANDLE) {
+        if (mUnsavedPipelineCount) {
+            savePipelineCache();
+        }
+        vkDestroyPipelineCache(mDevice, mPipelineCache, VKALLOC);
+        mPipelineCache = VK_NULL_HANDLE;
+    }
 }
 
 void VulkanPipelineCache::gc() noexcept {
@@ -284,6 +478,15 @@ void VulkanPipelineCache::gc() noexcept {
     // buffer is undefined." Therefore, we need to clear all bindings at this time.
     mBoundPipeline = {};
 
+    collectPrewarmedPipelines();
+
+    // Write the new pipelines back to the blob cache once they've stopped being created in bulk,
+    // or at least every FVK_PIPELINE_CACHE_SAVE_INTERVAL.
+    if (mUnsavedPipelineCount &&
+            mFirstUnsavedPipelineTime + FVK_PIPELINE_CACHE_SAVE_INTERVAL < mCurrentTime) {
+        savePipelineCache();
+    }
+
     // NOTE: Due to robin_map restrictions, we cannot use auto or range-based loops.
 
     // Evict any pipelines that have not been used in a while.
@@ -291,7 +494,7 @@ void VulkanPipelineCache::gc() noexcept {
    using ConstPipeIterator = decltype(mPipelines)::const_iterator;
    for (ConstPipeIterator iter = mPipelines.begin(); iter != mPipelines.end();) {
        const PipelineCacheEntry& cacheEntry = iter.value();
-       if (cacheEntry.lastUsed + FVK_MAX_PIPELINE_AGE < mCurrentTime) {
+       if (!cacheEntry.prewarmed && cacheEntry.lastUsed + FVK_MAX_PIPELINE_AGE < mCurrentTime) {
            vkDestroyPipeline(mDevice, iter->second.handle, VKALLOC);
            iter = mPipelines.erase(iter);
        } else {
@@ -17,10 +17,12 @@
 #ifndef TNT_FILAMENT_BACKEND_VULKANPIPELINECACHE_H
 #define TNT_FILAMENT_BACKEND_VULKANPIPELINECACHE_H
 
+#include "CompilerThreadPool.h"
 #include "VulkanCommands.h"
 #include "VulkanMemory.h"
 
 #include <backend/DriverEnums.h>
+#include <backend/Platform.h>
 #include <backend/TargetBufferInfo.h>
 
 #include "backend/Program.h"
@@ -29,9 +31,12 @@
 
 #include <utils/bitset.h>
 #include <utils/compiler.h>
+#include <utils/Condition.h>
 #include <utils/Hash.h>
+#include <utils/Mutex.h>
 
 #include <list>
+#include <memory>
 #include <tsl/robin_map.h>
 #include <type_traits>
 #include <vector>
@@ -45,6 +50,13 @@ struct VulkanTexture;
 
 // VulkanPipelineCache manages a cache of descriptor sets and pipelines.
 //
+// Pipelines are created through a VkPipelineCache, whose content is persisted with the Platform's
+// blob cache functions (see Platform::setBlobFunc()), if any, so that the driver doesn't need to
+// recompile the pipelines from one run to the next.
+//
+// Pipelines can also be pre-warmed, i.e. created ahead of time on background threads, see
+// prewarmPipeline().
+//
 // Please note the following limitations:
 // - Assumes that viewport and scissor should be dynamic. (not baked into VkPipeline)
 class VulkanPipelineCache {
@@ -92,7 +104,7 @@ public:
 
     static_assert(sizeof(RasterState) == 16, "RasterState must not have implicit padding.");
 
-    VulkanPipelineCache(VkDevice device);
+    VulkanPipelineCache(Platform& platform, VkPhysicalDevice physicalDevice, VkDevice device);
 
     void bindLayout(VkPipelineLayout layout) noexcept;
 
@@ -107,6 +119,14 @@ public:
     void bindVertexArray(VkVertexInputAttributeDescription const* attribDesc,
             VkVertexInputBindingDescription const* bufferDesc, uint8_t count);
 
+    // Queues the creation of the pipeline described by the currently bound state on a background
+    // thread, unless it already exists. `program` must be the bound program, it's kept alive
+    // until the pipeline is created. Pre-warmed pipelines are not evicted until they're used.
+    void prewarmPipeline(fvkmemory::resource_ptr<VulkanProgram> program);
+
+    // Whether pipelines queued with prewarmPipeline() are still being created.
+    bool isPrewarming() const noexcept { return !mPrewarmingPipelines.empty(); }
+
     // Destroys all managed Vulkan objects. This should be called before changing the VkDevice.
     void terminate() noexcept;
     void gc() noexcept;
@@ -189,6 +209,7 @@ private:
     struct PipelineCacheEntry {
         VkPipeline handle;
         Timestamp lastUsed;
+        bool prewarmed;     // set until the pipeline is used for the first time
     };
 
     using PipelineMap = tsl::robin_map<PipelineKey, PipelineCacheEntry,
@@ -201,8 +222,65 @@ private:
     // These helpers all return unstable pointers that should not be stored.
     PipelineCacheEntry* createPipeline() noexcept;
 
+    // Creates the VkPipeline described by `key`, this can be called from any thread.
+    static VkPipeline createVkPipeline(VkDevice device, VkPipelineCache pipelineCache,
+            PipelineKey const& key) noexcept;
+
+    // Pipelines being created on the compiler threads. The token is shared with the compiler
+    // thread, while the program reference is only ever touched on the driver thread.
+    struct PrewarmToken : public ProgramToken {
+        ~PrewarmToken() override;
+        VkPipeline handle = VK_NULL_HANDLE; // guarded by mPrewarmLock
+        bool ready = false;                 // guarded by mPrewarmLock
+    };
+
+    struct PrewarmEntry {
+        std::shared_ptr<PrewarmToken> token;
+        fvkmemory::resource_ptr<VulkanProgram> program;
+    };
+
+    using PrewarmMap = tsl::robin_map<PipelineKey, PrewarmEntry, PipelineHashFn, PipelineEqual>;
+
+    // Moves the pipelines that are ready from mPrewarmingPipelines to mPipelines.
+    void collectPrewarmedPipelines() noexcept;
+
+    // If the pipeline matching mPipelineRequirements is being pre-warmed, waits for it (or
+    // creates it on this thread if it hasn't started yet) and returns true.
+    bool waitForPrewarmedPipeline() noexcept;
+
+    PrewarmMap mPrewarmingPipelines;
+    CompilerThreadPool mCompilerThreadPool;
+    bool mCompilerThreadPoolInitialized = false;
+    utils::Mutex mPrewarmLock;
+    utils::Condition mPrewarmCondition;
+
+    // Creates the VkPipelineCache, seeded with the data from the Platform's blob cache, if any.
+    void createPipelineCache() noexcept;
+
+    // Writes the content of the VkPipelineCache to the Platform's blob cache.
+    void savePipelineCache() noexcept;
+
+    // The key of the VkPipelineCache data in the Platform's blob cache. The data is only
+    // compatible with the same driver and device, so they are part of the key.
+    struct BlobKey {
+        char tag[16];
+        uint32_t vendorID;
+        uint32_t deviceID;
+        uint32_t driverVersion;
+        uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+    };
+
     // Immutable state.
+    Platform& mPlatform;
     VkDevice mDevice = VK_NULL_HANDLE;
+    BlobKey mBlobKey = {};
+
+    VkPipelineCache mPipelineCache = VK_NULL_HANDLE;
+
+    // number of pipelines created since the VkPipelineCache was last saved, and the time
+    // at which the first of them was created.
+    uint32_t mUnsavedPipelineCount = 0;
+    Timestamp mFirstUnsavedPipelineTime = 0;
 
     // Current requirements for the pipeline layout, pipeline, and descriptor sets.
     PipelineKey mPipelineRequirements = {};
@@ -25,6 +25,8 @@
 
 #include <utils/Log.h>
 
+#include <algorithm>
+
 using namespace bluevk;
 
 namespace filament::backend {
@@ -109,10 +111,15 @@ void VulkanReadPixels::terminate() noexcept {
         return;
     }
     vkDestroyCommandPool(mDevice, mCommandPool, VKALLOC);
-    mDevice = VK_NULL_HANDLE;
 
     mTaskHandler->shutdown();
     mTaskHandler.reset();
+
+    for (StagingImage const& staging: mStagingImages) {
+        destroyStagingImage(staging);
+    }
+    mStagingImages.clear();
+    mDevice = VK_NULL_HANDLE;
 }
 
 VulkanReadPixels::VulkanReadPixels(VkDevice device)
@@ -151,59 +158,15 @@ void VulkanReadPixels::run(fvkmemory::resource_ptr<VulkanRenderTarget> srcTarget
     bool const swizzle
             = srcFormat == VK_FORMAT_B8G8R8A8_UNORM || srcFormat == VK_FORMAT_B8G8R8A8_SRGB;
 
-    // Create a host visible, linearly tiled image as a staging area.
-    VkImageCreateInfo const imageInfo{
-            .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
-            .imageType = VK_IMAGE_TYPE_2D,
-            .format = srcFormat,
-            .extent = {width, height, 1},
-            .mipLevels = 1,
-            .arrayLayers = 1,
-            .samples = VK_SAMPLE_COUNT_1_BIT,
-            .tiling = VK_IMAGE_TILING_LINEAR,
-            .usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT,
-            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-    };
-
-    VkImage stagingImage;
-    vkCreateImage(device, &imageInfo, VKALLOC, &stagingImage);
+    StagingImage const staging = acquireStagingImage(srcFormat, width, height, selectMemoryFunc);
+    VkImage const stagingImage = staging.image;
 
 #if FVK_ENABLED(FVK_DEBUG_READ_PIXELS)
-    FVK_LOGD << "readPixels created image=" << stagingImage
+    FVK_LOGD << "readPixels using image=" << stagingImage
              << " to copy from image=" << srcTexture->getVkImage()
              << " src-layout=" << srcTexture->getLayout(0, 0) << utils::io::endl;
 #endif
 
-    VkMemoryRequirements memReqs;
-    VkDeviceMemory stagingMemory;
-    vkGetImageMemoryRequirements(device, stagingImage, &memReqs);
-
-    uint32_t memoryTypeIndex = selectMemoryFunc(memReqs.memoryTypeBits,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-                    | VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
-
-    // If VK_MEMORY_PROPERTY_HOST_CACHED_BIT is not supported, we try only
-    // HOST_VISIBLE+HOST_COHERENT.  HOST_CACHED helps a lot with readpixels performance.
-    if (memoryTypeIndex >= VK_MAX_MEMORY_TYPES) {
-        memoryTypeIndex = selectMemoryFunc(memReqs.memoryTypeBits,
-                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-        FVK_LOGW
-                << "readPixels is slow because VK_MEMORY_PROPERTY_HOST_CACHED_BIT is not available"
-                << utils::io::endl;
-    }
-
-    FILAMENT_CHECK_POSTCONDITION(memoryTypeIndex < VK_MAX_MEMORY_TYPES)
-            << "VulkanReadPixels: unable to find a memory type that meets requirements.";
-
-    VkMemoryAllocateInfo const allocInfo = {
-            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-            .allocationSize = memReqs.size,
-            .memoryTypeIndex = memoryTypeIndex,
-    };
-
-    vkAllocateMemory(device, &allocInfo, VKALLOC, &stagingMemory);
-    vkBindImageMemory(device, stagingImage, stagingMemory, 0);
-
     VkCommandBuffer cmdbuffer;
     VkCommandBufferAllocateInfo const allocateInfo{
             .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
@@ -276,11 +239,6 @@ void VulkanReadPixels::run(fvkmemory::resource_ptr<VulkanRenderTarget> srcTarget
 
     VkQueue queue;
     vkGetDeviceQueue(device, graphicsQueueFamilyIndex, 0, &queue);
-    VkFence readCompleteFence;
-    VkFenceCreateInfo const fenceCreateInfo{
-            .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
-    };
-    vkCreateFence(device, &fenceCreateInfo, VKALLOC, &readCompleteFence);
     VkSubmitInfo const submitInfo{
             .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
             .waitSemaphoreCount = 0,
@@ -291,7 +249,7 @@ void VulkanReadPixels::run(fvkmemory::resource_ptr<VulkanRenderTarget> srcTarget
             .signalSemaphoreCount = 0,
             .pSignalSemaphores = VK_NULL_HANDLE,
     };
-    vkQueueSubmit(queue, 1, &submitInfo, readCompleteFence);
+    vkQueueSubmit(queue, 1, &submitInfo, staging.fence);
 
     auto* const pUserBuffer = new PixelBufferDescriptor(std::move(pbd));
     auto cleanPbdFunc = [pUserBuffer, readCompleteFunc]() {
@@ -299,10 +257,9 @@ void VulkanReadPixels::run(fvkmemory::resource_ptr<VulkanRenderTarget> srcTarget
         readCompleteFunc(std::move(p));
         delete pUserBuffer;
     };
-    auto waitFenceFunc = [device, width, height, swizzle, srcFormat, stagingImage, stagingMemory,
-                                 cmdpool, cmdbuffer, pUserBuffer,
-                                 fence = readCompleteFence]() mutable {
-        VkResult status = vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX);
+    auto waitFenceFunc = [this, device, width, height, swizzle, staging, cmdpool, cmdbuffer,
+                                 pUserBuffer]() mutable {
+        VkResult status = vkWaitForFences(device, 1, &staging.fence, VK_TRUE, UINT64_MAX);
         // Fence hasn't been reached. Try waiting again.
         if (status != VK_SUCCESS) {
             FVK_LOGE << "Failed to wait for readPixels fence" << utils::io::endl;
@@ -312,29 +269,120 @@ void VulkanReadPixels::run(fvkmemory::resource_ptr<VulkanRenderTarget> srcTarget
         PixelBufferDescriptor& p = *pUserBuffer;
         VkImageSubresource subResource{.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT};
         VkSubresourceLayout subResourceLayout;
-        vkGetImageSubresourceLayout(device, stagingImage, &subResource, &subResourceLayout);
+        vkGetImageSubresourceLayout(device, staging.image, &subResource, &subResourceLayout);
 
-        // Map image memory so that we can start copying from it.
-        uint8_t const* srcPixels;
-        vkMapMemory(device, stagingMemory, 0, VK_WHOLE_SIZE, 0, (void**) &srcPixels);
-        srcPixels += subResourceLayout.offset;
+        // The staging memory is host coherent and stays mapped.
+        uint8_t const* const srcPixels = staging.pixels + subResourceLayout.offset;
 
-        if (!DataReshaper::reshapeImage(&p, fvkutils::getComponentType(srcFormat),
-                    fvkutils::getComponentCount(srcFormat), srcPixels,
+        if (!DataReshaper::reshapeImage(&p, fvkutils::getComponentType(staging.format),
+                    fvkutils::getComponentCount(staging.format), srcPixels,
                     static_cast<int>(subResourceLayout.rowPitch), static_cast<int>(width),
                     static_cast<int>(height), swizzle)) {
             FVK_LOGE << "Unsupported PixelDataFormat or PixelDataType" << utils::io::endl;
         }
 
-        vkUnmapMemory(device, stagingMemory);
-        vkDestroyImage(device, stagingImage, VKALLOC);
-        vkFreeMemory(device, stagingMemory, VKALLOC);
-        vkDestroyFence(device, fence, VKALLOC);
+        vkResetFences(device, 1, &staging.fence);
+        releaseStagingImage(staging);
         vkFreeCommandBuffers(device, cmdpool, 1, &cmdbuffer);
     };
     mTaskHandler->post(std::move(waitFenceFunc), std::move(cleanPbdFunc));
 }
 
+VulkanReadPixels::StagingImage VulkanReadPixels::acquireStagingImage(VkFormat const format,
+        uint32_t const width, uint32_t const height,
+        SelecteMemoryFunction const& selectMemoryFunc) {
+    {
+        std::lock_guard<std::mutex> const lock(mStagingImagesMutex);
+        auto const pos = std::find_if(mStagingImages.begin(), mStagingImages.end(),
+                [=](StagingImage const& staging) {
+                    return staging.format == format && staging.width == width &&
+                           staging.height == height;
+                });
+        if (pos != mStagingImages.end()) {
+            StagingImage const staging = *pos;
+            mStagingImages.erase(pos);
+            return staging;
+        }
+    }
+
+    VkDevice const device = mDevice;
+
+    // Create a host visible, linearly tiled image as a staging area.
+    VkImageCreateInfo const imageInfo{
+            .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+            .imageType = VK_IMAGE_TYPE_2D,
+            .format = format,
+            .extent = {width, height, 1},
+            .mipLevels = 1,
+            .arrayLayers = 1,
+            .samples = VK_SAMPLE_COUNT_1_BIT,
+            .tiling = VK_IMAGE_TILING_LINEAR,
+            .usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+    };
+
+    StagingImage staging{ .format = format, .width = width, .height = height };
+    vkCreateImage(device, &imageInfo, VKALLOC, &staging.image);
+
+    VkMemoryRequirements memReqs;
+    vkGetImageMemoryRequirements(device, staging.image, &memReqs);
+
+    uint32_t memoryTypeIndex = selectMemoryFunc(memReqs.memoryTypeBits,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+                    | VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+
+    // If VK_MEMORY_PROPERTY_HOST_CACHED_BIT is not supported, we try only
+    // HOST_VISIBLE+HOST_COHERENT.  HOST_CACHED helps a lot with readpixels performance.
+    if (memoryTypeIndex >= VK_MAX_MEMORY_TYPES) {
+        memoryTypeIndex = selectMemoryFunc(memReqs.memoryTypeBits,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        FVK_LOGW
+                << "readPixels is slow because VK_MEMORY_PROPERTY_HOST_CACHED_BIT is not available"
+                << utils::io::endl;
+    }
+
+    FILAMENT_CHECK_POSTCONDITION(memoryTypeIndex < VK_MAX_MEMORY_TYPES)
+            << "VulkanReadPixels: unable to find a memory type that meets requirements.";
+
+    VkMemoryAllocateInfo const allocInfo = {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+            .allocationSize = memReqs.size,
+            .memoryTypeIndex = memoryTypeIndex,
+    };
+
+    vkAllocateMemory(device, &allocInfo, VKALLOC, &staging.memory);
+    vkBindImageMemory(device, staging.image, staging.memory, 0);
+    vkMapMemory(device, staging.memory, 0, VK_WHOLE_SIZE, 0, (void**) &staging.pixels);
+
+    VkFenceCreateInfo const fenceCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+    };
+    vkCreateFence(device, &fenceCreateInfo, VKALLOC, &staging.fence);
+
+#if FVK_ENABLED(FVK_DEBUG_READ_PIXELS)
+    FVK_LOGD << "readPixels created image=" << staging.image << utils::io::endl;
+#endif
+
+    return staging;
+}
+
+void VulkanReadPixels::releaseStagingImage(StagingImage const& staging) {
+    std::lock_guard<std::mutex> const lock(mStagingImagesMutex);
+    if (mStagingImages.size() == MAX_STAGING_IMAGE_COUNT) {
+        // the oldest image is the least likely to be reused
+        destroyStagingImage(mStagingImages.front());
+        mStagingImages.erase(mStagingImages.begin());
+    }
+    mStagingImages.push_back(staging);
+}
+
+void VulkanReadPixels::destroyStagingImage(StagingImage const& staging) const noexcept {
+    vkUnmapMemory(mDevice, staging.memory);
+    vkDestroyImage(mDevice, staging.image, VKALLOC);
+    vkFreeMemory(mDevice, staging.memory, VKALLOC);
+    vkDestroyFence(mDevice, staging.fence, VKALLOC);
+}
+
 void VulkanReadPixels::runUntilComplete() noexcept {
     if (!mTaskHandler) {
         return;
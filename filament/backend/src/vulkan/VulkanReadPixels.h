@@ -28,6 +28,7 @@
 #include <mutex>
 #include <queue>
 #include <thread>
+#include <vector>
 
 namespace filament::backend {
 
@@ -82,9 +83,34 @@ public:
     void runUntilComplete() noexcept;
 
 private:
+    // A host visible, linearly tiled image that the source is copied into, with its persistently
+    // mapped memory and the fence signaled when the copy completes.
+    struct StagingImage {
+        VkImage image;
+        VkDeviceMemory memory;
+        uint8_t const* pixels;
+        VkFence fence;
+        VkFormat format;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    // Staging images are reused across reads of the same format and size, so that reading back
+    // every frame doesn't allocate memory.
+    static constexpr size_t MAX_STAGING_IMAGE_COUNT = 4;
+
+    StagingImage acquireStagingImage(VkFormat format, uint32_t width, uint32_t height,
+            SelecteMemoryFunction const& selectMemoryFunc);
+    void releaseStagingImage(StagingImage const& staging);
+    void destroyStagingImage(StagingImage const& staging) const noexcept;
+
     VkDevice mDevice = VK_NULL_HANDLE;
     VkCommandPool mCommandPool = VK_NULL_HANDLE;
     std::unique_ptr<TaskHandler> mTaskHandler;
+
+    // accessed from the driver thread and from the task handler's thread
+    std::mutex mStagingImagesMutex;
+    std::vector<StagingImage> mStagingImages;
 };
 
 }// namespace filament::backend
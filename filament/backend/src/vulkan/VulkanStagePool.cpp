@@ -16,6 +16,7 @@
 
 #include "VulkanStagePool.h"
 
+#include "VulkanAsyncHandles.h"
 #include "VulkanCommands.h"
 #include "VulkanConstants.h"
 #include "VulkanMemory.h"
@@ -48,6 +49,7 @@ VulkanStage const* VulkanStagePool::acquireStage(uint32_t numBytes) {
         .buffer = VK_NULL_HANDLE,
         .capacity = numBytes,
         .lastAccessed = mCurrentFrame,
+        .mapped = nullptr,
     });
 
     // Create the VkBuffer.
@@ -57,9 +59,14 @@ VulkanStage const* VulkanStagePool::acquireStage(uint32_t numBytes) {
         .size = numBytes,
         .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
     };
-    VmaAllocationCreateInfo allocInfo { .usage = VMA_MEMORY_USAGE_CPU_ONLY };
+    VmaAllocationCreateInfo allocInfo {
+        .flags = VMA_ALLOCATION_CREATE_MAPPED_BIT,
+        .usage = VMA_MEMORY_USAGE_CPU_ONLY
+    };
+    VmaAllocationInfo allocationInfo{};
     UTILS_UNUSED_IN_RELEASE VkResult result = vmaCreateBuffer(mAllocator, &bufferInfo,
-            &allocInfo, &stage->buffer, &stage->memory, nullptr);
+            &allocInfo, &stage->buffer, &stage->memory, &allocationInfo);
+    stage->mapped = allocationInfo.pMappedData;
 
 #if FVK_ENABLED(FVK_DEBUG_STAGING_ALLOCATION)
     if (result != VK_SUCCESS) {
@@ -70,6 +77,98 @@ VulkanStage const* VulkanStagePool::acquireStage(uint32_t numBytes) {
     return stage;
 }
 
+VulkanStageSlice VulkanStagePool::acquireSlice(uint32_t numBytes,
+        VulkanCommandBuffer const& commands) {
+    if (numBytes <= FVK_STAGE_RING_MAX_ALLOCATION) {
+        uint32_t const offset = allocateFromRing(numBytes, commands.getFenceStatus());
+        if (offset != UINT32_MAX) {
+            mStats.ringHits++;
+            mStats.ringBytes += numBytes;
+            return {
+                .memory = mRingMemory,
+                .buffer = mRingBuffer,
+                .offset = offset,
+                .mapped = static_cast<char*>(mRingMapped) + offset,
+            };
+        }
+        mStats.ringMisses++;
+    } else {
+        mStats.largeSlices++;
+    }
+
+    VulkanStage const* stage = acquireStage(numBytes);
+    return {
+        .memory = stage->memory,
+        .buffer = stage->buffer,
+        .offset = 0,
+        .mapped = stage->mapped,
+    };
+}
+
+uint32_t VulkanStagePool::allocateFromRing(uint32_t numBytes,
+        std::shared_ptr<VulkanCmdFence> const& fence) {
+    constexpr uint64_t RING_SIZE = FVK_STAGE_RING_SIZE;
+    constexpr uint64_t ALIGNMENT = 16;
+
+    if (UTILS_UNLIKELY(mRingBuffer == VK_NULL_HANDLE)) {
+        VkBufferCreateInfo const bufferInfo {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+            .size = RING_SIZE,
+            .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        };
+        VmaAllocationCreateInfo const allocInfo {
+            .flags = VMA_ALLOCATION_CREATE_MAPPED_BIT,
+            .usage = VMA_MEMORY_USAGE_CPU_ONLY
+        };
+        VmaAllocationInfo allocationInfo{};
+        VkResult const result = vmaCreateBuffer(mAllocator, &bufferInfo, &allocInfo,
+                &mRingBuffer, &mRingMemory, &allocationInfo);
+        if (result != VK_SUCCESS) {
+#if FVK_ENABLED(FVK_DEBUG_STAGING_ALLOCATION)
+            FVK_LOGE << "Ring allocation error: " << result << utils::io::endl;
+#endif
+            mRingBuffer = VK_NULL_HANDLE;
+            mRingMemory = VK_NULL_HANDLE;
+            return UINT32_MAX;
+        }
+        mRingMapped = allocationInfo.pMappedData;
+    }
+
+    uint64_t offset = (mRingHead + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    if ((offset % RING_SIZE) + numBytes > RING_SIZE) {
+        // slices don't wrap around, skip to the start of the ring
+        offset = (offset / RING_SIZE + 1) * RING_SIZE;
+    }
+
+    if (offset + numBytes - mRingTail > RING_SIZE) {
+        reclaimRing();
+        if (offset + numBytes - mRingTail > RING_SIZE) {
+            return UINT32_MAX;
+        }
+    }
+
+    mRingHead = offset + numBytes;
+
+    // consecutive slices used by the same command buffer share the same range
+    if (!mRingRanges.empty() && mRingRanges.back().fence == fence) {
+        mRingRanges.back().end = mRingHead;
+    } else {
+        mRingRanges.push_back({ fence, mRingHead });
+    }
+    return uint32_t(offset % RING_SIZE);
+}
+
+void VulkanStagePool::reclaimRing() noexcept {
+    // command buffers complete in order, so we only need to look at the oldest ranges
+    while (!mRingRanges.empty() && mRingRanges.front().fence->getStatus() == VK_SUCCESS) {
+        mRingTail = mRingRanges.front().end;
+        mRingRanges.pop_front();
+    }
+    if (mRingRanges.empty()) {
+        mRingTail = mRingHead;
+    }
+}
+
 VulkanStageImage const* VulkanStagePool::acquireImage(PixelDataFormat format, PixelDataType type,
         uint32_t width, uint32_t height) {
     const VkFormat vkformat = fvkutils::getVkFormat(format, type);
@@ -135,6 +234,8 @@ void VulkanStagePool::gc() noexcept {
     FVK_SYSTRACE_CONTEXT();
     FVK_SYSTRACE_START("stagepool::gc");
 
+    reclaimRing();
+
     // If this is one of the first few frames, return early to avoid wrapping unsigned integers.
     if (++mCurrentFrame <= TIME_BEFORE_EVICTION) {
         return;
@@ -192,6 +293,20 @@ void VulkanStagePool::gc() noexcept {
 }
 
 void VulkanStagePool::terminate() noexcept {
+#if FVK_ENABLED(FVK_DEBUG_STAGING_ALLOCATION)
+    FVK_LOGD << "Stage ring hits=" << mStats.ringHits << " misses=" << mStats.ringMisses
+             << " large=" << mStats.largeSlices << " bytes=" << mStats.ringBytes
+             << utils::io::endl;
+#endif
+
+    if (mRingBuffer != VK_NULL_HANDLE) {
+        vmaDestroyBuffer(mAllocator, mRingBuffer, mRingMemory);
+        mRingBuffer = VK_NULL_HANDLE;
+        mRingMemory = VK_NULL_HANDLE;
+        mRingMapped = nullptr;
+    }
+    mRingRanges.clear();
+
     for (auto stage : mUsedStages) {
         vmaDestroyBuffer(mAllocator, stage->buffer, stage->memory);
         delete stage;
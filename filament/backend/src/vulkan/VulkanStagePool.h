@@ -20,12 +20,18 @@
 #include "backend/DriverEnums.h"
 #include "VulkanMemory.h"
 
+#include <deque>
 #include <map>
+#include <memory>
 #include <unordered_set>
 
+#include <stdint.h>
+
 namespace filament::backend {
 
 class VulkanCommands;
+struct VulkanCmdFence;
+struct VulkanCommandBuffer;
 
 // Immutable POD representing a shared CPU-GPU staging area.
 struct VulkanStage {
@@ -33,6 +39,16 @@ struct VulkanStage {
     VkBuffer buffer;
     uint32_t capacity;
     mutable uint64_t lastAccessed;
+    void* mapped;           // persistently mapped
+};
+
+// A host-mappable range of a staging buffer, which is either a sub-allocation of the ring buffer
+// or a whole VulkanStage.
+struct VulkanStageSlice {
+    VmaAllocation memory;
+    VkBuffer buffer;
+    uint32_t offset;        // offset of the slice in `buffer` and `memory`
+    void* mapped;           // host address of the slice
 };
 
 struct VulkanStageImage {
@@ -54,6 +70,11 @@ public:
     // The stage is automatically released back to the pool after TIME_BEFORE_EVICTION frames.
     VulkanStage const* acquireStage(uint32_t numBytes);
 
+    // Returns a slice of at least the given number of bytes, which can only be used in `commands`.
+    // Small slices are sub-allocated from a ring buffer and reclaimed when `commands` has
+    // completed, others are backed by a stage from acquireStage().
+    VulkanStageSlice acquireSlice(uint32_t numBytes, VulkanCommandBuffer const& commands);
+
     // Images have VK_IMAGE_LAYOUT_GENERAL and must not be transitioned to any other layout
     VulkanStageImage const* acquireImage(PixelDataFormat format, PixelDataType type,
             uint32_t width, uint32_t height);
@@ -65,10 +86,38 @@ public:
     // This should be called while the context's VkDevice is still alive.
     void terminate() noexcept;
 
+    struct Stats {
+        uint64_t ringHits = 0;          // slices sub-allocated from the ring buffer
+        uint64_t ringMisses = 0;        // small slices that didn't fit in the ring buffer
+        uint64_t largeSlices = 0;       // slices too large for the ring buffer
+        uint64_t ringBytes = 0;         // bytes sub-allocated from the ring buffer
+    };
+
+    Stats const& getStats() const noexcept { return mStats; }
+
 private:
+    // Returns the offset of `numBytes` sub-allocated from the ring buffer, or UINT32_MAX.
+    uint32_t allocateFromRing(uint32_t numBytes, std::shared_ptr<VulkanCmdFence> const& fence);
+
+    // Releases the ranges of the ring buffer used by command buffers which have completed.
+    void reclaimRing() noexcept;
+
     VmaAllocator mAllocator;
     VulkanCommands* mCommands;
 
+    // The ring buffer is created lazily, mRingHead and mRingTail are free-running offsets.
+    struct RingRange {
+        std::shared_ptr<VulkanCmdFence> fence;
+        uint64_t end;   // the range ends where the next one starts
+    };
+    VmaAllocation mRingMemory = VK_NULL_HANDLE;
+    VkBuffer mRingBuffer = VK_NULL_HANDLE;
+    void* mRingMapped = nullptr;
+    uint64_t mRingHead = 0;
+    uint64_t mRingTail = 0;
+    std::deque<RingRange> mRingRanges;
+    Stats mStats;
+
     // Use an ordered multimap for quick (capacity => stage) lookups using lower_bound().
     std::multimap<uint32_t, VulkanStage const*> mFreeStages;
 
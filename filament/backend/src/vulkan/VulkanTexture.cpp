@@ -26,6 +26,9 @@
 
 #include <utils/Panic.h>
 
+#include <algorithm>
+#include <vector>
+
 using namespace bluevk;
 
 namespace filament::backend {
@@ -47,6 +50,23 @@ inline uint8_t getLayerCount(SamplerType const target, uint32_t const depth) {
     }
 }
 
+// Key of a page of a sparse texture in VulkanTextureState::Sparse::pages
+inline uint64_t getSparsePageKey(uint32_t const level, uint32_t const x, uint32_t const y) {
+    return (uint64_t(level) << 56) | (uint64_t(y) << 28) | uint64_t(x);
+}
+
+// Submits sparse bindings and waits for them to complete
+void bindSparse(VkDevice device, VkQueue queue, VkBindSparseInfo const& bindInfo) {
+    VkFenceCreateInfo const fenceInfo{ .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+    VkFence fence;
+    vkCreateFence(device, &fenceInfo, VKALLOC, &fence);
+    VkResult const result = vkQueueBindSparse(queue, 1, &bindInfo, fence);
+    FILAMENT_CHECK_POSTCONDITION(result == VK_SUCCESS) << "Unable to bind sparse memory."
+                                                       << " error=" << static_cast<int32_t>(result);
+    vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX);
+    vkDestroyFence(device, fence, VKALLOC);
+}
+
 VkComponentMapping composeSwizzle(VkComponentMapping const& prev, VkComponentMapping const& next) {
     static constexpr VkComponentSwizzle IDENTITY[] = {
         VK_COMPONENT_SWIZZLE_R,
@@ -236,6 +256,13 @@ VulkanTexture::VulkanTexture(VkDevice device, VkPhysicalDevice physicalDevice,
     if (any(usage & TextureUsage::PROTECTED)) {
         imageInfo.flags |= VK_IMAGE_CREATE_PROTECTED_BIT;
     }
+    if (any(usage & TextureUsage::SPARSE)) {
+        assert_invariant(target == SamplerType::SAMPLER_2D && samples == 1);
+        assert_invariant(context.isSparseResidencyImage2DSupported());
+        imageInfo.flags |=
+                VK_IMAGE_CREATE_SPARSE_BINDING_BIT | VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT;
+        mState->mSparse = std::make_unique<VulkanTextureState::Sparse>();
+    }
 
     if (any(usage & TextureUsage::BLIT_SRC)) {
         imageInfo.usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
@@ -249,7 +276,7 @@ VulkanTexture::VulkanTexture(VkDevice device, VkPhysicalDevice physicalDevice,
             // Lazily allocated memory is available.
             context.isLazilyAllocatedMemorySupported() &&
             // Usage consists of attachment flags only.
-            none(tusage & ~TextureUsage::ALL_ATTACHMENTS) &&
+            none(tusage & ~(TextureUsage::ALL_ATTACHMENTS | TextureUsage::TRANSIENT)) &&
             // Usage contains at least one attachment flag.
             any(tusage & TextureUsage::ALL_ATTACHMENTS) &&
             // Depth resolve cannot use transient attachment because it uses a custom shader.
@@ -339,31 +366,35 @@ VulkanTexture::VulkanTexture(VkDevice device, VkPhysicalDevice physicalDevice,
                                                        << " error=" << static_cast<int32_t>(result);
 
     // Allocate memory for the VkImage and bind it.
-    VkMemoryRequirements memReqs = {};
-    vkGetImageMemoryRequirements(mState->mDevice, mState->mTextureImage, &memReqs);
-
-    const VkFlags requiredMemoryFlags =
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
-        (useTransientAttachment ? VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT : 0U) |
-        (mState->mIsProtected ? VK_MEMORY_PROPERTY_PROTECTED_BIT : 0U);
-    uint32_t memoryTypeIndex
-            = context.selectMemoryType(memReqs.memoryTypeBits, requiredMemoryFlags);
-
-    FILAMENT_CHECK_POSTCONDITION(memoryTypeIndex < VK_MAX_MEMORY_TYPES)
-            << "VulkanTexture: unable to find a memory type that meets requirements.";
-
-    VkMemoryAllocateInfo allocInfo = {
-        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .allocationSize = memReqs.size,
-        .memoryTypeIndex = memoryTypeIndex,
-    };
-    result = vkAllocateMemory(mState->mDevice, &allocInfo, nullptr, &mState->mTextureImageMemory);
-    FILAMENT_CHECK_POSTCONDITION(result == VK_SUCCESS) << "Unable to allocate image memory."
-                                                       << " error=" << static_cast<int32_t>(result);
-    result = vkBindImageMemory(mState->mDevice, mState->mTextureImage, mState->mTextureImageMemory,
-            0);
-    FILAMENT_CHECK_POSTCONDITION(result == VK_SUCCESS) << "Unable to bind image."
-                                                       << " error=" << static_cast<int32_t>(result);
+    // The memory of sparse images is bound by initSparse() and commitPages().
+    if (!mState->mSparse) {
+        VkMemoryRequirements memReqs = {};
+        vkGetImageMemoryRequirements(mState->mDevice, mState->mTextureImage, &memReqs);
+
+        const VkFlags requiredMemoryFlags =
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+            (useTransientAttachment ? VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT : 0U) |
+            (mState->mIsProtected ? VK_MEMORY_PROPERTY_PROTECTED_BIT : 0U);
+        uint32_t memoryTypeIndex
+                = context.selectMemoryType(memReqs.memoryTypeBits, requiredMemoryFlags);
+
+        FILAMENT_CHECK_POSTCONDITION(memoryTypeIndex < VK_MAX_MEMORY_TYPES)
+                << "VulkanTexture: unable to find a memory type that meets requirements.";
+
+        VkMemoryAllocateInfo allocInfo = {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+            .allocationSize = memReqs.size,
+            .memoryTypeIndex = memoryTypeIndex,
+        };
+        result = vkAllocateMemory(mState->mDevice, &allocInfo, nullptr,
+                &mState->mTextureImageMemory);
+        FILAMENT_CHECK_POSTCONDITION(result == VK_SUCCESS)
+                << "Unable to allocate image memory." << " error=" << static_cast<int32_t>(result);
+        result = vkBindImageMemory(mState->mDevice, mState->mTextureImage,
+                mState->mTextureImageMemory, 0);
+        FILAMENT_CHECK_POSTCONDITION(result == VK_SUCCESS)
+                << "Unable to bind image." << " error=" << static_cast<int32_t>(result);
+    }
 
     // Spec out the "primary" VkImageView that shaders use to sample from the image.
     mPrimaryViewRange = mState->mFullViewRange;
@@ -403,11 +434,164 @@ VulkanTextureState::~VulkanTextureState() {
         vkDestroyImage(mDevice, mTextureImage, VKALLOC);
         vkFreeMemory(mDevice, mTextureImageMemory, VKALLOC);
     }
+    if (mSparse) {
+        vkDestroyImage(mDevice, mTextureImage, VKALLOC);
+        for (auto const& [key, allocation]: mSparse->pages) {
+            vmaFreeMemory(mAllocator, allocation);
+        }
+        for (VmaAllocation allocation: mSparse->mipTailMemory) {
+            vmaFreeMemory(mAllocator, allocation);
+        }
+    }
     for (auto entry: mCachedImageViews) {
         vkDestroyImageView(mDevice, entry.second, VKALLOC);
     }
 }
 
+void VulkanTexture::initSparse(VkQueue queue) {
+    auto& state = *mState.get();
+    assert_invariant(state.mSparse);
+    auto& sparse = *state.mSparse;
+
+    VkMemoryRequirements memReqs = {};
+    vkGetImageMemoryRequirements(state.mDevice, state.mTextureImage, &memReqs);
+    // the alignment of sparse images is the size of a page
+    sparse.pageMemoryRequirements = {
+        .size = memReqs.alignment,
+        .alignment = memReqs.alignment,
+        .memoryTypeBits = memReqs.memoryTypeBits,
+    };
+
+    uint32_t count = 0;
+    vkGetImageSparseMemoryRequirements(state.mDevice, state.mTextureImage, &count, nullptr);
+    std::vector<VkSparseImageMemoryRequirements> requirements(count);
+    vkGetImageSparseMemoryRequirements(state.mDevice, state.mTextureImage, &count,
+            requirements.data());
+
+    VmaAllocationCreateInfo const allocationInfo{ .usage = VMA_MEMORY_USAGE_GPU_ONLY };
+    std::vector<VkSparseMemoryBind> binds;
+    for (auto const& r: requirements) {
+        bool const isMetadata = r.formatProperties.aspectMask & VK_IMAGE_ASPECT_METADATA_BIT;
+        if (!isMetadata) {
+            sparse.pageSize = r.formatProperties.imageGranularity;
+            sparse.mipTailFirstLod = r.imageMipTailFirstLod;
+        }
+        if (r.imageMipTailSize == 0) {
+            continue;
+        }
+        VkMemoryRequirements tailReqs = sparse.pageMemoryRequirements;
+        tailReqs.size = r.imageMipTailSize;
+        VmaAllocation allocation;
+        VmaAllocationInfo info;
+        VkResult const result = vmaAllocateMemory(state.mAllocator, &tailReqs, &allocationInfo,
+                &allocation, &info);
+        FILAMENT_CHECK_POSTCONDITION(result == VK_SUCCESS)
+                << "Unable to allocate the mip tail of a sparse image."
+                << " error=" << static_cast<int32_t>(result);
+        sparse.mipTailMemory.push_back(allocation);
+        binds.push_back({
+            .resourceOffset = r.imageMipTailOffset,
+            .size = r.imageMipTailSize,
+            .memory = info.deviceMemory,
+            .memoryOffset = info.offset,
+            .flags = isMetadata ? VkSparseMemoryBindFlags(VK_SPARSE_MEMORY_BIND_METADATA_BIT) : 0u,
+        });
+    }
+
+    if (!binds.empty()) {
+        VkSparseImageOpaqueMemoryBindInfo const opaqueBinds{
+            .image = state.mTextureImage,
+            .bindCount = uint32_t(binds.size()),
+            .pBinds = binds.data(),
+        };
+        VkBindSparseInfo const bindInfo{
+            .sType = VK_STRUCTURE_TYPE_BIND_SPARSE_INFO,
+            .imageOpaqueBindCount = 1,
+            .pImageOpaqueBinds = &opaqueBinds,
+        };
+        bindSparse(state.mDevice, queue, bindInfo);
+    }
+}
+
+void VulkanTexture::commitPages(VkQueue queue, uint32_t level, uint32_t xoffset, uint32_t yoffset,
+        uint32_t width, uint32_t height, bool commit) {
+    auto& state = *mState.get();
+    assert_invariant(state.mSparse);
+    auto& sparse = *state.mSparse;
+    if (level >= sparse.mipTailFirstLod || !width || !height) {
+        return;
+    }
+
+    VkExtent3D const page = sparse.pageSize;
+    uint32_t const levelWidth = std::max(1u, this->width >> level);
+    uint32_t const levelHeight = std::max(1u, this->height >> level);
+    uint32_t const x0 = xoffset / page.width;
+    uint32_t const y0 = yoffset / page.height;
+    uint32_t const x1 = (std::min(xoffset + width, levelWidth) + page.width - 1) / page.width;
+    uint32_t const y1 = (std::min(yoffset + height, levelHeight) + page.height - 1) / page.height;
+
+    VmaAllocationCreateInfo const allocationInfo{ .usage = VMA_MEMORY_USAGE_GPU_ONLY };
+    std::vector<VkSparseImageMemoryBind> binds;
+    std::vector<VmaAllocation> released;
+    bool outOfMemory = false;
+    for (uint32_t y = y0; y < y1 && !outOfMemory; y++) {
+        for (uint32_t x = x0; x < x1 && !outOfMemory; x++) {
+            uint64_t const key = getSparsePageKey(level, x, y);
+            auto const pos = sparse.pages.find(key);
+            if (commit == (pos != sparse.pages.end())) {
+                continue;
+            }
+            // pages on the right and bottom edges can be partial
+            VkSparseImageMemoryBind bind{
+                .subresource = { VK_IMAGE_ASPECT_COLOR_BIT, level, 0 },
+                .offset = { int32_t(x * page.width), int32_t(y * page.height), 0 },
+                .extent = {
+                        std::min(page.width, levelWidth - x * page.width),
+                        std::min(page.height, levelHeight - y * page.height),
+                        1 },
+            };
+            if (commit) {
+                VmaAllocation allocation;
+                VmaAllocationInfo info;
+                VkResult const result = vmaAllocateMemory(state.mAllocator,
+                        &sparse.pageMemoryRequirements, &allocationInfo, &allocation, &info);
+                if (result != VK_SUCCESS) {
+                    FVK_LOGW << "Unable to allocate the memory of a sparse texture page. error="
+                             << static_cast<int32_t>(result) << utils::io::endl;
+                    outOfMemory = true;
+                    continue;
+                }
+                bind.memory = info.deviceMemory;
+                bind.memoryOffset = info.offset;
+                sparse.pages[key] = allocation;
+            } else {
+                // a null memory unbinds the page
+                released.push_back(pos->second);
+                sparse.pages.erase(pos);
+            }
+            binds.push_back(bind);
+        }
+    }
+
+    if (!binds.empty()) {
+        VkSparseImageMemoryBindInfo const imageBinds{
+            .image = state.mTextureImage,
+            .bindCount = uint32_t(binds.size()),
+            .pBinds = binds.data(),
+        };
+        VkBindSparseInfo const bindInfo{
+            .sType = VK_STRUCTURE_TYPE_BIND_SPARSE_INFO,
+            .imageBindCount = 1,
+            .pImageBinds = &imageBinds,
+        };
+        bindSparse(state.mDevice, queue, bindInfo);
+    }
+
+    for (VmaAllocation allocation: released) {
+        vmaFreeMemory(state.mAllocator, allocation);
+    }
+}
+
 void VulkanTexture::updateImage(const PixelBufferDescriptor& data, uint32_t width, uint32_t height,
         uint32_t depth, uint32_t xoffset, uint32_t yoffset, uint32_t zoffset, uint32_t miplevel) {
     assert_invariant(width <= this->width && height <= this->height);
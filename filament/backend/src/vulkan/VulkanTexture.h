@@ -27,7 +27,9 @@
 #include <utils/Hash.h>
 #include <utils/RangeMap.h>
 
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace filament::backend {
 
@@ -80,6 +82,19 @@ struct VulkanTextureState : public fvkmemory::Resource {
     VmaAllocator mAllocator;
     VulkanCommands* mCommands;
     bool mIsTransientAttachment;
+
+    // Sparse textures are created without memory, which is bound page by page. This is allocated
+    // separately to keep the size of the handle small.
+    struct Sparse {
+        VkExtent3D pageSize = {};
+        uint32_t mipTailFirstLod = 0;
+        VkMemoryRequirements pageMemoryRequirements = {};
+        // The memory of the mip tail (the levels smaller than a page) is always resident.
+        std::vector<VmaAllocation> mipTailMemory;
+        // Committed pages, indexed by level and page coordinates, see getSparsePageKey().
+        std::unordered_map<uint64_t, VmaAllocation> pages;
+    };
+    std::unique_ptr<Sparse> mSparse;
 };
 
 struct VulkanTexture : public HwTexture, fvkmemory::Resource {
@@ -113,6 +128,20 @@ struct VulkanTexture : public HwTexture, fvkmemory::Resource {
     void updateImage(const PixelBufferDescriptor& data, uint32_t width, uint32_t height,
             uint32_t depth, uint32_t xoffset, uint32_t yoffset, uint32_t zoffset, uint32_t miplevel);
 
+    // For sparse textures, must be called once after creation. Binds the memory of the mip tail,
+    // which stays resident.
+    void initSparse(VkQueue queue);
+
+    // For sparse textures, makes the pages covering a region of a level resident (commit) or
+    // releases their memory. Regions of the mip tail are ignored, it is always resident. This
+    // waits for the bindings to complete, so the GPU must not be using the texture.
+    void commitPages(VkQueue queue, uint32_t level, uint32_t xoffset, uint32_t yoffset,
+            uint32_t width, uint32_t height, bool commit);
+
+    bool isSparse() const {
+        return mState->mSparse != nullptr;
+    }
+
     // Returns the primary image view, which is used for shader sampling.
     VkImageView getPrimaryImageView() {
         return getImageView(mPrimaryViewRange, mState->mViewType, mSwizzle);
@@ -101,6 +101,9 @@ void ResourceManager::destroyWithType(ResourceType type, HandleId id) {
         case ResourceType::FENCE:
             destruct<VulkanFence>(Handle<VulkanFence>(id));
             break;
+        case ResourceType::PIPELINE_STATE:
+            destruct<VulkanPipelineState>(Handle<VulkanPipelineState>(id));
+            break;
         case ResourceType::UNDEFINED_TYPE:
             break;
     }
@@ -220,6 +220,8 @@ ExtensionSet getDeviceExtensions(VkPhysicalDevice device) {
         VK_KHR_MAINTENANCE2_EXTENSION_NAME,
         VK_KHR_MAINTENANCE3_EXTENSION_NAME,
         VK_KHR_MULTIVIEW_EXTENSION_NAME,
+        VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
+        VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME,
     };
     ExtensionSet exts;
     // Identify supported physical device extensions
@@ -327,8 +329,8 @@ VkInstance createInstance(ExtensionSet const& requiredExts) {
 
 VkDevice createLogicalDevice(VkPhysicalDevice physicalDevice,
         VkPhysicalDeviceFeatures2 const& features, uint32_t graphicsQueueFamilyIndex,
-        uint32_t protectedGraphicsQueueFamilyIndex, ExtensionSet const& deviceExtensions,
-        bool requestImageView2DOn3DImage) {
+        uint32_t protectedGraphicsQueueFamilyIndex, uint32_t transferQueueFamilyIndex,
+        ExtensionSet const& deviceExtensions, bool requestImageView2DOn3DImage) {
     VkDevice device;
     float queuePriority[] = {1.0f};
     VkDeviceCreateInfo deviceCreateInfo = {
@@ -342,7 +344,7 @@ VkDevice createLogicalDevice(VkPhysicalDevice physicalDevice,
     for (auto const& ext: deviceExtensions) {
         requestExtensions.push_back(ext.data());
     }
-    VkDeviceQueueCreateInfo deviceQueueCreateInfo[2] = {};
+    VkDeviceQueueCreateInfo deviceQueueCreateInfo[3] = {};
     deviceQueueCreateInfo[0] = {
         .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
         .queueFamilyIndex = graphicsQueueFamilyIndex,
@@ -354,7 +356,19 @@ VkDevice createLogicalDevice(VkPhysicalDevice physicalDevice,
     deviceQueueCreateInfo[1].flags = VK_DEVICE_QUEUE_CREATE_PROTECTED_BIT;
 
     bool const hasProtectedQueue = protectedGraphicsQueueFamilyIndex != INVALID_VK_INDEX;
-    deviceCreateInfo.queueCreateInfoCount = hasProtectedQueue ? 2 : 1;
+    uint32_t queueCreateInfoCount = hasProtectedQueue ? 2 : 1;
+
+    // Dedicated transfer queue
+    if (transferQueueFamilyIndex != INVALID_VK_INDEX) {
+        deviceQueueCreateInfo[queueCreateInfoCount++] = {
+            .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+            .queueFamilyIndex = transferQueueFamilyIndex,
+            .queueCount = 1,
+            .pQueuePriorities = &queuePriority[0],
+        };
+    }
+
+    deviceCreateInfo.queueCreateInfoCount = queueCreateInfoCount;
     deviceCreateInfo.pQueueCreateInfos = deviceQueueCreateInfo;
 
     // We could simply enable all supported features, but since that may have performance
@@ -365,6 +379,8 @@ VkDevice createLogicalDevice(VkPhysicalDevice physicalDevice,
         .textureCompressionETC2 = features.features.textureCompressionETC2,
         .textureCompressionBC = features.features.textureCompressionBC,
         .shaderClipDistance = features.features.shaderClipDistance,
+        .sparseBinding = features.features.sparseBinding,
+        .sparseResidencyImage2D = features.features.sparseResidencyImage2D,
     };
     deviceCreateInfo.pEnabledFeatures = &enabledFeatures;
 
@@ -391,6 +407,14 @@ VkDevice createLogicalDevice(VkPhysicalDevice physicalDevice,
         chainStruct(&deviceCreateInfo, &multiview);
     }
 
+    VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineSemaphore = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR,
+        .timelineSemaphore = VK_TRUE,
+    };
+    if (setContains(deviceExtensions, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME)) {
+        chainStruct(&deviceCreateInfo, &timelineSemaphore);
+    }
+
     VkPhysicalDeviceProtectedMemoryFeatures protectedMemory = {
         .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROTECTED_MEMORY_FEATURES,
         .protectedMemory = VK_TRUE,
@@ -435,6 +459,21 @@ std::tuple<ExtensionSet, ExtensionSet> pruneExtensions(VkPhysicalDevice device,
         newDeviceExts.erase(VK_KHR_MULTIVIEW_EXTENSION_NAME);
     }
 
+    // The extension can be advertised without the feature being supported.
+    if (setContains(newDeviceExts, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME)) {
+        VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineSemaphore = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR,
+        };
+        VkPhysicalDeviceFeatures2 features = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+            .pNext = &timelineSemaphore,
+        };
+        vkGetPhysicalDeviceFeatures2(device, &features);
+        if (!timelineSemaphore.timelineSemaphore) {
+            newDeviceExts.erase(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+        }
+    }
+
     return std::tuple(newInstExts, newDeviceExts);
 }
 
@@ -464,6 +503,23 @@ uint32_t identifyGraphicsQueueFamilyIndex(VkPhysicalDevice physicalDevice, VkQue
     return graphicsQueueFamilyIndex;
 }
 
+// Returns a queue family that can do transfers but neither graphics nor compute. On most
+// discrete GPUs this maps to the copy (DMA) engines, which can run uploads concurrently with
+// rendering.
+uint32_t identifyDedicatedTransferQueueFamilyIndex(VkPhysicalDevice physicalDevice) {
+    const FixedCapacityVector<VkQueueFamilyProperties> queueFamiliesProperties
+            = getPhysicalDeviceQueueFamilyPropertiesHelper(physicalDevice);
+    constexpr VkQueueFlags excluded = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT;
+    for (uint32_t j = 0; j < queueFamiliesProperties.size(); ++j) {
+        VkQueueFamilyProperties props = queueFamiliesProperties[j];
+        if (props.queueCount != 0 && (props.queueFlags & VK_QUEUE_TRANSFER_BIT) &&
+                !(props.queueFlags & excluded)) {
+            return j;
+        }
+    }
+    return INVALID_VK_INDEX;
+}
+
 // Provide a preference ordering of device types.
 // Enum based on:
 // https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/VkPhysicalDeviceType.html
@@ -626,6 +682,8 @@ struct VulkanPlatformPrivate {
     uint32_t mProtectedGraphicsQueueFamilyIndex = INVALID_VK_INDEX;
     uint32_t mProtectedGraphicsQueueIndex = INVALID_VK_INDEX;
     VkQueue mProtectedGraphicsQueue = VK_NULL_HANDLE;
+    uint32_t mTransferQueueFamilyIndex = INVALID_VK_INDEX;
+    VkQueue mTransferQueue = VK_NULL_HANDLE;
     VulkanContext mContext = {};
 
     // We use a map to both map a handle (i.e. SwapChainPtr) to the concrete type and also to
@@ -769,11 +827,31 @@ Driver* VulkanPlatform::createDriver(void* sharedContext,
         }
     }
 
+    // We can only add queues to a device we create ourselves.
+    if (!mImpl->mSharedContext) {
+        mImpl->mTransferQueueFamilyIndex =
+                identifyDedicatedTransferQueueFamilyIndex(mImpl->mPhysicalDevice);
+    }
+
     // Only enable shaderClipDistance if we are doing instanced stereoscopic rendering.
     if (driverConfig.stereoscopicType != StereoscopicType::INSTANCED) {
         context.mPhysicalDeviceFeatures.features.shaderClipDistance = VK_FALSE;
     }
 
+    // Sparse textures are bound on the graphics queue, which must support sparse binding. A shared
+    // context may not have enabled the features, so we don't assume them.
+    {
+        const FixedCapacityVector<VkQueueFamilyProperties> queueFamiliesProperties =
+                getPhysicalDeviceQueueFamilyPropertiesHelper(mImpl->mPhysicalDevice);
+        uint32_t const family = mImpl->mGraphicsQueueFamilyIndex;
+        bool const sparseQueue = family < queueFamiliesProperties.size() &&
+                (queueFamiliesProperties[family].queueFlags & VK_QUEUE_SPARSE_BINDING_BIT);
+        if (mImpl->mSharedContext || !sparseQueue) {
+            context.mPhysicalDeviceFeatures.features.sparseBinding = VK_FALSE;
+            context.mPhysicalDeviceFeatures.features.sparseResidencyImage2D = VK_FALSE;
+        }
+    }
+
     ExtensionSet deviceExts;
     // If using a shared context, we do not assume any extensions.
     if (!mImpl->mSharedContext) {
@@ -798,7 +876,8 @@ Driver* VulkanPlatform::createDriver(void* sharedContext,
         mImpl->mDevice =
                 createLogicalDevice(mImpl->mPhysicalDevice, context.mPhysicalDeviceFeatures,
                         mImpl->mGraphicsQueueFamilyIndex, mImpl->mProtectedGraphicsQueueFamilyIndex,
-                        deviceExts, requestPortabilitySubsetImageView2DOn3DImage);
+                        mImpl->mTransferQueueFamilyIndex, deviceExts,
+                        requestPortabilitySubsetImageView2DOn3DImage);
     }
 
     assert_invariant(mImpl->mDevice != VK_NULL_HANDLE);
@@ -822,11 +901,21 @@ Driver* VulkanPlatform::createDriver(void* sharedContext,
         assert_invariant(mImpl->mProtectedGraphicsQueue != VK_NULL_HANDLE);
     }
 
+    if (mImpl->mTransferQueueFamilyIndex != INVALID_VK_INDEX) {
+        vkGetDeviceQueue(mImpl->mDevice, mImpl->mTransferQueueFamilyIndex, 0,
+                &mImpl->mTransferQueue);
+        assert_invariant(mImpl->mTransferQueue != VK_NULL_HANDLE);
+    }
+
     // Store the extension support in the context
     if (!mImpl->mSharedContext) {
         context.mDebugUtilsSupported = setContains(instExts, VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
         context.mDebugMarkersSupported = setContains(deviceExts, VK_EXT_DEBUG_MARKER_EXTENSION_NAME);
         context.mMultiviewEnabled = setContains(deviceExts, VK_KHR_MULTIVIEW_EXTENSION_NAME);
+        context.mMemoryBudgetSupported =
+                setContains(deviceExts, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        context.mTimelineSemaphoreSupported =
+                setContains(deviceExts, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
     } else {
         VulkanSharedContext const* scontext = (VulkanSharedContext const*) sharedContext;
         context.mDebugUtilsSupported = scontext->debugUtilsSupported;
@@ -977,6 +1066,14 @@ VkQueue VulkanPlatform::getProtectedGraphicsQueue() const noexcept {
     return mImpl->mProtectedGraphicsQueue;
 }
 
+uint32_t VulkanPlatform::getTransferQueueFamilyIndex() const noexcept {
+    return mImpl->mTransferQueueFamilyIndex;
+}
+
+VkQueue VulkanPlatform::getTransferQueue() const noexcept {
+    return mImpl->mTransferQueue;
+}
+
 VulkanPlatform::ExternalImageMetadata VulkanPlatform::getExternalImageMetadata(
         ExternalImageHandleRef externalImage) {
     return getExternalImageMetadataImpl(externalImage, mImpl->mDevice);
@@ -135,8 +135,16 @@ VulkanPlatformSurfaceSwapChain::VulkanPlatformSurfaceSwapChain(VulkanContext con
       mFallbackExtent(fallbackExtent),
       mUsesRGB((flags & backend::SWAP_CHAIN_CONFIG_SRGB_COLORSPACE) != 0),
       mHasStencil((flags & backend::SWAP_CHAIN_HAS_STENCIL_BUFFER) != 0),
-      mIsProtected((flags & backend::SWAP_CHAIN_CONFIG_PROTECTED_CONTENT) != 0) {
+      mIsProtected((flags & backend::SWAP_CHAIN_CONFIG_PROTECTED_CONTENT) != 0),
+      mMinimumImageCount((flags & backend::SWAP_CHAIN_CONFIG_MINIMUM_IMAGE_COUNT) != 0) {
     assert_invariant(surface);
+    if (flags & backend::SWAP_CHAIN_CONFIG_PRESENT_MODE_MAILBOX) {
+        mPresentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+    } else if (flags & backend::SWAP_CHAIN_CONFIG_PRESENT_MODE_IMMEDIATE) {
+        mPresentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+    } else if (flags & backend::SWAP_CHAIN_CONFIG_PRESENT_MODE_FIFO_RELAXED) {
+        mPresentMode = VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+    }
     create();
 }
 
@@ -152,12 +160,11 @@ VkResult VulkanPlatformSurfaceSwapChain::create() {
 
     // The general advice is to require one more than the minimum swap chain length, since the
     // absolute minimum could easily require waiting for a driver or presentation layer to release
-    // the previous frame's buffer. The only situation in which we'd ask for the minimum length is
-    // when using a MAILBOX presentation strategy for low-latency situations where tearing is
-    // acceptable.
+    // the previous frame's buffer. The minimum length is only used when explicitly requested, for
+    // low-latency situations.
     uint32_t const maxImageCount = caps.maxImageCount;
     uint32_t const minImageCount = caps.minImageCount;
-    uint32_t desiredImageCount = minImageCount + 1;
+    uint32_t desiredImageCount = mMinimumImageCount ? minImageCount : minImageCount + 1;
 
     // According to section 30.5 of VK 1.1, maxImageCount of zero means "that there is no limit on
     // the number of images, though there may be limits related to the total amount of memory used
@@ -191,19 +198,21 @@ VkResult VulkanPlatformSurfaceSwapChain::create() {
     FILAMENT_CHECK_POSTCONDITION(surfaceFormat.format != VK_FORMAT_UNDEFINED)
             << "Cannot find suitable swapchain format";
 
-    // Verify that our chosen present mode is supported. In practice all devices support the FIFO
-    // mode, but we check for it anyway for completeness.  (and to avoid validation warnings)
-    VkPresentModeKHR const desiredPresentMode = VK_PRESENT_MODE_FIFO_KHR;
+    // Verify that our chosen present mode is supported, or fall back to FIFO. In practice all
+    // devices support the FIFO mode, but we check for it anyway for completeness.  (and to avoid
+    // validation warnings)
     FixedCapacityVector<VkPresentModeKHR> presentModes = fvkutils::enumerate(
             vkGetPhysicalDeviceSurfacePresentModesKHR, mPhysicalDevice, mSurface);
-    bool foundSuitablePresentMode = false;
-    for (VkPresentModeKHR mode: presentModes) {
-        if (mode == desiredPresentMode) {
-            foundSuitablePresentMode = true;
-            break;
-        }
+    auto const isPresentModeSupported = [&presentModes](VkPresentModeKHR mode) {
+        return std::find(presentModes.begin(), presentModes.end(), mode) != presentModes.end();
+    };
+    VkPresentModeKHR desiredPresentMode = mPresentMode;
+    if (!isPresentModeSupported(desiredPresentMode)) {
+        FVK_LOGW << "Present mode " << static_cast<int32_t>(desiredPresentMode)
+                 << " is not supported, using FIFO." << utils::io::endl;
+        desiredPresentMode = VK_PRESENT_MODE_FIFO_KHR;
     }
-    FILAMENT_CHECK_POSTCONDITION(foundSuitablePresentMode)
+    FILAMENT_CHECK_POSTCONDITION(isPresentModeSupported(desiredPresentMode))
             << "Desired present mode is not supported by this device.";
 
     // Create the low-level swap chain.
@@ -126,6 +126,8 @@ private:
     bool mUsesRGB = false;
     bool mHasStencil = false;
     bool mIsProtected = false;
+    bool mMinimumImageCount = false;
+    VkPresentModeKHR mPresentMode = VK_PRESENT_MODE_FIFO_KHR;
     bool mSuboptimal;
 };
 
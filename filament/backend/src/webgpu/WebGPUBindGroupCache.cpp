@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "webgpu/WebGPUBindGroupCache.h"
+
+#include "webgpu/WebGPUConstants.h"
+
+#include <utils/compiler.h>
+#include <utils/Hash.h>
+#include <utils/Systrace.h>
+
+#include <webgpu/webgpu_cpp.h>
+
+#include <utility>
+#include <vector>
+
+#include <string.h>
+
+namespace filament::backend {
+
+WebGPUBindGroupCache::WebGPUBindGroupCache(wgpu::Device const& device) noexcept
+        : mDevice(device) {
+}
+
+WebGPUBindGroupCache::Key WebGPUBindGroupCache::makeKey(wgpu::BindGroupLayout const& layout,
+        wgpu::BindGroupEntry const* entries, size_t count) {
+    Key key{ .layout = uint64_t(uintptr_t(layout.Get())) };
+    key.entries.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        wgpu::BindGroupEntry const& in = entries[i];
+        uintptr_t resource = 0;
+        if (in.buffer) {
+            resource = uintptr_t(in.buffer.Get());
+        } else if (in.textureView) {
+            resource = uintptr_t(in.textureView.Get());
+        } else if (in.sampler) {
+            resource = uintptr_t(in.sampler.Get());
+        }
+        key.entries[i] = {
+                .resource = uint64_t(resource),
+                .offset = in.offset,
+                .size = in.size,
+                .binding = in.binding };
+    }
+    return key;
+}
+
+wgpu::BindGroup const& WebGPUBindGroupCache::getOrCreateBindGroup(
+        wgpu::BindGroupLayout const& layout,
+        wgpu::BindGroupEntry const* entries, size_t count) {
+    Key key = makeKey(layout, entries, count);
+    auto iter = mBindGroups.find(key);
+    if (UTILS_LIKELY(iter != mBindGroups.end())) {
+        auto& entry = iter.value();
+        entry.lastUsed = mCurrentTime;
+        return entry.bindGroup;
+    }
+
+    SYSTRACE_NAME("CreateBindGroup");
+    wgpu::BindGroupDescriptor descriptor{};
+    descriptor.layout = layout;
+    descriptor.entryCount = count;
+    descriptor.entries = entries;
+    auto const pos = mBindGroups.emplace(std::move(key), CacheEntry{
+            .bindGroup = mDevice.CreateBindGroup(&descriptor),
+            .lastUsed = mCurrentTime }).first;
+    return pos->second.bindGroup;
+}
+
+void WebGPUBindGroupCache::gc() noexcept {
+    ++mCurrentTime;
+
+    // NOTE: Due to robin_map restrictions, we cannot use auto or range-based loops.
+    using ConstIterator = decltype(mBindGroups)::const_iterator;
+    for (ConstIterator iter = mBindGroups.begin(); iter != mBindGroups.end();) {
+        if (iter.value().lastUsed + FWGPU_MAX_BIND_GROUP_AGE < mCurrentTime) {
+            iter = mBindGroups.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+}
+
+void WebGPUBindGroupCache::terminate() noexcept {
+    mBindGroups.clear();
+}
+
+bool WebGPUBindGroupCache::Key::operator==(Key const& rhs) const noexcept {
+    return layout == rhs.layout && entries.size() == rhs.entries.size() &&
+           0 == memcmp(entries.data(), rhs.entries.data(), entries.size() * sizeof(Entry));
+}
+
+size_t WebGPUBindGroupCache::KeyHash::operator()(Key const& key) const noexcept {
+    uint32_t const seed = utils::hash::murmur3((uint32_t const*) &key.layout, 2, 0);
+    return utils::hash::murmur3((uint32_t const*) key.entries.data(),
+            key.entries.size() * sizeof(Entry) / 4, seed);
+}
+
+} // namespace filament::backend
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef TNT_FILAMENT_BACKEND_WEBGPUBINDGROUPCACHE_H
+#define TNT_FILAMENT_BACKEND_WEBGPUBINDGROUPCACHE_H
+
+#include <tsl/robin_map.h>
+
+#include <webgpu/webgpu_cpp.h>
+
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace filament::backend {
+
+// WebGPUBindGroupCache returns a wgpu::BindGroup for a given layout and set of resources,
+// creating it only the first time that combination is seen.
+//
+// Descriptor sets are typically re-created or updated every frame with the same resources, and
+// creating a bind group each time is prohibitively expensive in the browser. Keys use the
+// resources' object pointers; this is safe because a cached bind group holds a reference to its
+// resources, so their addresses can't be reused while the entry exists.
+class WebGPUBindGroupCache {
+public:
+    explicit WebGPUBindGroupCache(wgpu::Device const& device) noexcept;
+
+    WebGPUBindGroupCache(WebGPUBindGroupCache const&) = delete;
+    WebGPUBindGroupCache& operator=(WebGPUBindGroupCache const&) = delete;
+
+    // Returns the bind group for `layout` and `entries`, creating it if needed.
+    wgpu::BindGroup const& getOrCreateBindGroup(wgpu::BindGroupLayout const& layout,
+            wgpu::BindGroupEntry const* entries, size_t count);
+
+    // Evicts the bind groups that haven't been used recently. Call once per frame.
+    void gc() noexcept;
+
+    // Releases all the cached bind groups.
+    void terminate() noexcept;
+
+private:
+    // 32 bytes on all platforms, without padding
+    struct Entry {
+        uint64_t resource;  // buffer, texture view or sampler
+        uint64_t offset;
+        uint64_t size;
+        uint32_t binding;
+        uint32_t padding;
+    };
+
+    struct Key {
+        uint64_t layout;
+        std::vector<Entry> entries;
+        bool operator==(Key const& rhs) const noexcept;
+    };
+
+    struct KeyHash {
+        size_t operator()(Key const& key) const noexcept;
+    };
+
+    struct CacheEntry {
+        wgpu::BindGroup bindGroup;
+        uint64_t lastUsed;
+    };
+
+    static Key makeKey(wgpu::BindGroupLayout const& layout,
+            wgpu::BindGroupEntry const* entries, size_t count);
+
+    wgpu::Device mDevice;
+    uint64_t mCurrentTime = 0;
+    tsl::robin_map<Key, CacheEntry, KeyHash> mBindGroups;
+};
+
+} // namespace filament::backend
+
+#endif // TNT_FILAMENT_BACKEND_WEBGPUBINDGROUPCACHE_H
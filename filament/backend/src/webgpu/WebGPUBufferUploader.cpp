@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "webgpu/WebGPUBufferUploader.h"
+
+#include <utils/compiler.h>
+#include <utils/debug.h>
+#include <utils/Systrace.h>
+
+#include <webgpu/webgpu_cpp.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <string.h>
+
+namespace filament::backend {
+
+WebGPUBufferUploader::WebGPUBufferUploader() noexcept = default;
+
+void WebGPUBufferUploader::write(wgpu::Buffer const& buffer, uint64_t offset,
+        void const* data, size_t size) {
+    assert_invariant((offset & 3u) == 0 && (size & 3u) == 0);
+    if (UTILS_UNLIKELY(!size)) {
+        return;
+    }
+    size_t const stagingOffset = mStaging.size();
+    mStaging.resize(stagingOffset + size);
+    memcpy(mStaging.data() + stagingOffset, data, size);
+    mWrites.push_back({ buffer, offset, stagingOffset, size, uint32_t(mWrites.size()) });
+}
+
+void WebGPUBufferUploader::flush(wgpu::Queue const& queue) {
+    if (mWrites.empty()) {
+        return;
+    }
+
+    SYSTRACE_CALL();
+
+    // group the writes by buffer and sort them by offset, so that mergeable writes are adjacent
+    std::sort(mWrites.begin(), mWrites.end(), [](Write const& lhs, Write const& rhs) {
+        if (lhs.buffer.Get() != rhs.buffer.Get()) {
+            return lhs.buffer.Get() < rhs.buffer.Get();
+        }
+        if (lhs.offset != rhs.offset) {
+            return lhs.offset < rhs.offset;
+        }
+        return lhs.sequence < rhs.sequence;
+    });
+
+    auto first = mWrites.begin();
+    while (first != mWrites.end()) {
+        // find the run of writes to the same buffer forming a contiguous range
+        uint64_t const start = first->offset;
+        uint64_t end = first->offset + first->size;
+        auto last = first + 1;
+        while (last != mWrites.end() &&
+                last->buffer.Get() == first->buffer.Get() && last->offset <= end) {
+            end = std::max(end, uint64_t(last->offset + last->size));
+            ++last;
+        }
+
+        if (last - first == 1) {
+            queue.WriteBuffer(first->buffer, start,
+                    mStaging.data() + first->stagingOffset, first->size);
+        } else {
+            // replay the run in submission order so that later writes win
+            std::sort(first, last, [](Write const& lhs, Write const& rhs) {
+                return lhs.sequence < rhs.sequence;
+            });
+            mScratch.resize(end - start);
+            for (auto it = first; it != last; ++it) {
+                memcpy(mScratch.data() + (it->offset - start),
+                        mStaging.data() + it->stagingOffset, it->size);
+            }
+            queue.WriteBuffer(first->buffer, start, mScratch.data(), end - start);
+        }
+        first = last;
+    }
+
+    mWrites.clear();
+    mStaging.clear();
+}
+
+void WebGPUBufferUploader::terminate() noexcept {
+    mWrites.clear();
+    mStaging.clear();
+    mScratch.clear();
+}
+
+} // namespace filament::backend
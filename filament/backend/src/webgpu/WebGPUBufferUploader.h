@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef TNT_FILAMENT_BACKEND_WEBGPUBUFFERUPLOADER_H
+#define TNT_FILAMENT_BACKEND_WEBGPUBUFFERUPLOADER_H
+
+#include <webgpu/webgpu_cpp.h>
+
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace filament::backend {
+
+// WebGPUBufferUploader records buffer updates and submits them with as few queue.WriteBuffer()
+// calls as possible: writes to the same buffer that overlap or touch are merged into a single
+// upload, the latest write winning where they overlap.
+//
+// queue.WriteBuffer() takes effect before the next queue.Submit() regardless of when it's called
+// during the frame, so deferring the writes to flush() doesn't change their semantics as long as
+// flush() is called before submitting command buffers.
+class WebGPUBufferUploader {
+public:
+    WebGPUBufferUploader() noexcept;
+
+    WebGPUBufferUploader(WebGPUBufferUploader const&) = delete;
+    WebGPUBufferUploader& operator=(WebGPUBufferUploader const&) = delete;
+
+    // Copies `data` and records a write at `offset` in `buffer`. offset and size must be
+    // multiples of 4.
+    void write(wgpu::Buffer const& buffer, uint64_t offset, void const* data, size_t size);
+
+    // Issues the recorded writes on `queue`.
+    void flush(wgpu::Queue const& queue);
+
+    // Drops the recorded writes.
+    void terminate() noexcept;
+
+private:
+    struct Write {
+        wgpu::Buffer buffer;
+        uint64_t offset;
+        size_t stagingOffset;
+        size_t size;
+        uint32_t sequence;
+    };
+
+    std::vector<Write> mWrites;
+    std::vector<uint8_t> mStaging;
+    std::vector<uint8_t> mScratch;
+};
+
+} // namespace filament::backend
+
+#endif // TNT_FILAMENT_BACKEND_WEBGPUBUFFERUPLOADER_H
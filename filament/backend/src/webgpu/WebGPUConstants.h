@@ -63,4 +63,10 @@
     #define FWGPU_LOGI (utils::slog.i)
 #endif
 
+// Pipelines and bind groups are cached and evicted when they haven't been used for this many
+// frames. wgpu objects are reference counted, so eviction never destroys an object that's still
+// referenced by an encoded command; the age only bounds the memory held by the caches.
+constexpr static const uint32_t FWGPU_MAX_PIPELINE_AGE = 60;
+constexpr static const uint32_t FWGPU_MAX_BIND_GROUP_AGE = 3;
+
 #endif// TNT_FILAMENT_BACKEND_WEBGPUCONSTANTS_H
@@ -257,7 +257,9 @@ Driver* WebGPUDriver::create(WebGPUPlatform& platform) noexcept {
 }
 
 WebGPUDriver::WebGPUDriver(WebGPUPlatform& platform) noexcept
-    : mPlatform(platform) {
+    : mPlatform(platform),
+      mPipelineCache(mDevice),
+      mBindGroupCache(mDevice) {
 #if FWGPU_ENABLED(FWGPU_PRINT_SYSTEM)
     printInstanceDetails(mPlatform.getInstance());
 #endif
@@ -286,6 +288,9 @@ template class ConcreteDispatcher<WebGPUDriver>;
 
 
 void WebGPUDriver::terminate() {
+    mBufferUploader.terminate();
+    mBindGroupCache.terminate();
+    mPipelineCache.terminate();
 }
 
 void WebGPUDriver::tick(int) {
@@ -308,10 +313,22 @@ void WebGPUDriver::setFrameCompletedCallback(Handle<HwSwapChain> sch,
 void WebGPUDriver::setPresentationTime(int64_t monotonic_clock_ns) {
 }
 
+void WebGPUDriver::setPresentationDamage(Viewport region) {
+}
+
 void WebGPUDriver::endFrame(uint32_t frameId) {
+    if (mQueue) {
+        mBufferUploader.flush(mQueue);
+    }
+    mBindGroupCache.gc();
+    mPipelineCache.gc();
 }
 
 void WebGPUDriver::flush(int) {
+    // buffer writes must be issued before any queue submission
+    if (mQueue) {
+        mBufferUploader.flush(mQueue);
+    }
 }
 
 void WebGPUDriver::finish(int) {
@@ -338,6 +355,9 @@ void WebGPUDriver::destroyTexture(Handle<HwTexture> th) {
 void WebGPUDriver::destroyProgram(Handle<HwProgram> ph) {
 }
 
+void WebGPUDriver::destroyPipelineState(Handle<HwPipelineState> psh) {
+}
+
 void WebGPUDriver::destroyRenderTarget(Handle<HwRenderTarget> rth) {
 }
 
@@ -372,6 +392,10 @@ Handle<HwTexture> WebGPUDriver::importTextureS() noexcept {
     return Handle<HwTexture>((Handle<HwTexture>::HandleId) mNextFakeHandle++);
 }
 
+Handle<HwPipelineState> WebGPUDriver::createPipelineStateS() noexcept {
+    return Handle<HwPipelineState>((Handle<HwPipelineState>::HandleId) mNextFakeHandle++);
+}
+
 Handle<HwProgram> WebGPUDriver::createProgramS() noexcept {
     return Handle<HwProgram>((Handle<HwProgram>::HandleId) mNextFakeHandle++);
 }
@@ -522,6 +546,9 @@ void WebGPUDriver::createRenderPrimitiveR(Handle<HwRenderPrimitive> rph, Handle<
 
 void WebGPUDriver::createProgramR(Handle<HwProgram> ph, Program&& program) {}
 
+void WebGPUDriver::createPipelineStateR(Handle<HwPipelineState> psh,
+        PipelineState const& state) {}
+
 void WebGPUDriver::createDefaultRenderTargetR(Handle<HwRenderTarget> rth, int) {}
 
 void WebGPUDriver::createRenderTargetR(Handle<HwRenderTarget> rth, TargetBufferFlags targets,
@@ -635,6 +662,10 @@ bool WebGPUDriver::isDepthClampSupported() {
     return false;
 }
 
+MemoryBudget WebGPUDriver::getMemoryBudget() {
+    return {};
+}
+
 bool WebGPUDriver::isWorkaroundNeeded(Workaround) {
     return false;
 }
@@ -663,6 +694,11 @@ size_t WebGPUDriver::getMaxArrayTextureLayers() {
     return 256u;
 }
 
+math::uint3 WebGPUDriver::getSparseTexturePageSize(SamplerType, TextureFormat) {
+    // WebGPU doesn't have sparse textures
+    return {};
+}
+
 void WebGPUDriver::updateIndexBuffer(Handle<HwIndexBuffer> ibh, BufferDescriptor&& p,
         uint32_t byteOffset) {
     scheduleDestroy(std::move(p));
@@ -707,6 +743,9 @@ void WebGPUDriver::setExternalStream(Handle<HwTexture> th, Handle<HwStream> sh)
 
 void WebGPUDriver::generateMipmaps(Handle<HwTexture> th) { }
 
+void WebGPUDriver::commitTexturePages(Handle<HwTexture> th, uint32_t level, uint32_t xoffset,
+        uint32_t yoffset, uint32_t width, uint32_t height, bool commit) { }
+
 void WebGPUDriver::compilePrograms(CompilerPriorityQueue priority,
         CallbackHandler* handler, CallbackHandler::Callback callback, void* user) {
     if (callback) {
@@ -714,6 +753,10 @@ void WebGPUDriver::compilePrograms(CompilerPriorityQueue priority,
     }
 }
 
+void WebGPUDriver::prewarmPipeline(Handle<HwRenderTarget> rth, const RenderPassParams& params,
+        PipelineState const& state) {
+}
+
 void WebGPUDriver::beginRenderPass(Handle<HwRenderTarget> rth, const RenderPassParams& params) {
 }
 
@@ -779,12 +822,18 @@ void WebGPUDriver::blit(
 void WebGPUDriver::bindPipeline(PipelineState const& pipelineState) {
 }
 
+void WebGPUDriver::bindPipelineState(Handle<HwPipelineState> psh) {
+}
+
 void WebGPUDriver::bindRenderPrimitive(Handle<HwRenderPrimitive> rph) {
 }
 
 void WebGPUDriver::draw2(uint32_t indexOffset, uint32_t indexCount, uint32_t instanceCount) {
 }
 
+void WebGPUDriver::multiDraw2(DrawRange const* ranges, uint32_t count) {
+}
+
 void WebGPUDriver::draw(PipelineState pipelineState, Handle<HwRenderPrimitive> rph,
         uint32_t indexOffset, uint32_t indexCount, uint32_t instanceCount) {
 }
@@ -19,6 +19,10 @@
 
 #include <backend/platforms/WebGPUPlatform.h>
 
+#include "webgpu/WebGPUBindGroupCache.h"
+#include "webgpu/WebGPUBufferUploader.h"
+#include "webgpu/WebGPUPipelineCache.h"
+
 #include "DriverBase.h"
 #include "private/backend/Dispatcher.h"
 #include "private/backend/Driver.h"
@@ -56,6 +60,12 @@ private:
     wgpu::Queue mQueue = nullptr;
     uint64_t mNextFakeHandle = 1;
 
+    // Crossing the JS/WASM boundary is expensive in the browser, so wgpu objects are never
+    // created per draw and buffer updates are batched per frame.
+    WebGPUPipelineCache mPipelineCache;
+    WebGPUBindGroupCache mBindGroupCache;
+    WebGPUBufferUploader mBufferUploader;
+
     /*
      * Driver interface
      */
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "webgpu/WebGPUPipelineCache.h"
+
+#include "webgpu/WebGPUConstants.h"
+
+#include <utils/compiler.h>
+#include <utils/Systrace.h>
+
+#include <webgpu/webgpu_cpp.h>
+
+#include <array>
+
+#include <string.h>
+
+namespace filament::backend {
+
+WebGPUPipelineCache::WebGPUPipelineCache(wgpu::Device const& device) noexcept
+        : mDevice(device) {
+}
+
+wgpu::RenderPipeline const& WebGPUPipelineCache::getOrCreatePipeline(
+        PipelineKey const& key) noexcept {
+    auto iter = mPipelines.find(key);
+    if (UTILS_LIKELY(iter != mPipelines.end())) {
+        auto& entry = iter.value();
+        entry.lastUsed = mCurrentTime;
+        return entry.pipeline;
+    }
+    auto const pos = mPipelines.emplace(key, PipelineCacheEntry{
+            .pipeline = createPipeline(key),
+            .lastUsed = mCurrentTime }).first;
+    return pos->second.pipeline;
+}
+
+wgpu::RenderPipeline WebGPUPipelineCache::createPipeline(PipelineKey const& key) const noexcept {
+    SYSTRACE_CALL();
+
+    // wgpu wants the attributes grouped by vertex buffer
+    std::array<wgpu::VertexAttribute, VERTEX_ATTRIBUTE_COUNT> attributes{};
+    std::array<wgpu::VertexBufferLayout, VERTEX_BUFFER_COUNT> buffers{};
+    size_t attributeCount = 0;
+    for (uint32_t b = 0; b < key.vertexBufferCount; b++) {
+        wgpu::VertexBufferLayout& buffer = buffers[b];
+        buffer.arrayStride = key.vertexBuffers[b].arrayStride;
+        buffer.stepMode = wgpu::VertexStepMode(key.vertexBuffers[b].stepMode);
+        buffer.attributes = attributes.data() + attributeCount;
+        for (auto const& attribute : key.vertexAttributes) {
+            if (attribute.enabled && attribute.bufferIndex == b) {
+                wgpu::VertexAttribute& a = attributes[attributeCount++];
+                a.format = wgpu::VertexFormat(attribute.format);
+                a.offset = attribute.offset;
+                a.shaderLocation = attribute.shaderLocation;
+                buffer.attributeCount++;
+            }
+        }
+    }
+
+    RasterState const& rs = key.rasterState;
+
+    wgpu::BlendState const blend{
+            .color = {
+                    .operation = wgpu::BlendOperation(rs.colorBlendOp),
+                    .srcFactor = wgpu::BlendFactor(rs.srcColorBlendFactor),
+                    .dstFactor = wgpu::BlendFactor(rs.dstColorBlendFactor) },
+            .alpha = {
+                    .operation = wgpu::BlendOperation(rs.alphaBlendOp),
+                    .srcFactor = wgpu::BlendFactor(rs.srcAlphaBlendFactor),
+                    .dstFactor = wgpu::BlendFactor(rs.dstAlphaBlendFactor) },
+    };
+
+    std::array<wgpu::ColorTargetState, COLOR_TARGET_COUNT> targets{};
+    for (size_t i = 0; i < key.colorTargetCount; i++) {
+        targets[i].format = wgpu::TextureFormat(key.colorFormats[i]);
+        targets[i].blend = rs.blendEnable ? &blend : nullptr;
+        targets[i].writeMask = wgpu::ColorWriteMask(rs.colorWriteMask);
+    }
+
+    wgpu::FragmentState fragment{};
+    fragment.module = key.fragmentModule;
+    fragment.targetCount = key.colorTargetCount;
+    fragment.targets = targets.data();
+
+    wgpu::DepthStencilState depthStencil{};
+    depthStencil.format = wgpu::TextureFormat(key.depthFormat);
+    depthStencil.depthWriteEnabled =
+            rs.depthWriteEnabled ? wgpu::OptionalBool::True : wgpu::OptionalBool::False;
+    depthStencil.depthCompare = wgpu::CompareFunction(rs.depthCompare);
+    depthStencil.depthBias = rs.depthBias;
+    depthStencil.depthBiasSlopeScale = rs.depthBiasSlopeScale;
+
+    wgpu::RenderPipelineDescriptor descriptor{};
+    descriptor.layout = key.layout;
+    descriptor.vertex.module = key.vertexModule;
+    descriptor.vertex.bufferCount = key.vertexBufferCount;
+    descriptor.vertex.buffers = buffers.data();
+    descriptor.primitive.topology = wgpu::PrimitiveTopology(key.topology);
+    descriptor.primitive.frontFace = wgpu::FrontFace(rs.frontFace);
+    descriptor.primitive.cullMode = wgpu::CullMode(rs.cullMode);
+    descriptor.depthStencil = key.hasDepth ? &depthStencil : nullptr;
+    descriptor.multisample.count = key.sampleCount;
+    descriptor.multisample.alphaToCoverageEnabled = rs.alphaToCoverageEnabled;
+    descriptor.fragment = key.fragmentModule ? &fragment : nullptr;
+
+    return mDevice.CreateRenderPipeline(&descriptor);
+}
+
+void WebGPUPipelineCache::gc() noexcept {
+    ++mCurrentTime;
+
+    // NOTE: Due to robin_map restrictions, we cannot use auto or range-based loops.
+    using ConstPipeIterator = decltype(mPipelines)::const_iterator;
+    for (ConstPipeIterator iter = mPipelines.begin(); iter != mPipelines.end();) {
+        PipelineCacheEntry const& entry = iter.value();
+        if (entry.lastUsed + FWGPU_MAX_PIPELINE_AGE < mCurrentTime) {
+            // the pipeline is reference counted, so this is safe even if it's still referenced
+            // by a command buffer that hasn't executed yet
+            iter = mPipelines.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+}
+
+void WebGPUPipelineCache::terminate() noexcept {
+    mPipelines.clear();
+}
+
+bool WebGPUPipelineCache::PipelineEqual::operator()(PipelineKey const& k1,
+        PipelineKey const& k2) const noexcept {
+    return 0 == memcmp((void const*) &k1, (void const*) &k2, sizeof(k1));
+}
+
+} // namespace filament::backend
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef TNT_FILAMENT_BACKEND_WEBGPUPIPELINECACHE_H
+#define TNT_FILAMENT_BACKEND_WEBGPUPIPELINECACHE_H
+
+#include <backend/DriverEnums.h>
+#include <backend/TargetBufferInfo.h>
+
+#include <utils/Hash.h>
+
+#include <tsl/robin_map.h>
+
+#include <webgpu/webgpu_cpp.h>
+
+#include <type_traits>
+
+#include <stdint.h>
+
+namespace filament::backend {
+
+// WebGPUPipelineCache manages a cache of render pipelines, keyed by all the state baked into a
+// wgpu::RenderPipeline, similarly to VulkanPipelineCache.
+//
+// Creating a pipeline is very expensive in the browser (it crosses the JS/WASM boundary and
+// typically compiles shaders), so the driver must never create one per draw.
+class WebGPUPipelineCache {
+public:
+    static constexpr uint32_t VERTEX_ATTRIBUTE_COUNT = MAX_VERTEX_ATTRIBUTE_COUNT;
+    static constexpr uint32_t VERTEX_BUFFER_COUNT = MAX_VERTEX_BUFFER_COUNT;
+    static constexpr uint32_t COLOR_TARGET_COUNT = MRT::MAX_SUPPORTED_RENDER_TARGET_COUNT;
+
+#if defined(__clang__)
+    #pragma clang diagnostic push
+    #pragma clang diagnostic warning "-Wpadded"
+#endif
+
+    // wgpu enums are stored as integers so that the key stays a POD without implicit padding.
+    struct VertexAttribute {
+        uint32_t format;            // wgpu::VertexFormat
+        uint32_t offset;
+        uint8_t shaderLocation;
+        uint8_t bufferIndex;
+        uint8_t enabled;
+        uint8_t padding;
+    };
+
+    struct VertexBufferLayout {
+        uint32_t arrayStride;
+        uint32_t stepMode;          // wgpu::VertexStepMode
+    };
+
+    struct RasterState {
+        uint8_t cullMode;           // wgpu::CullMode
+        uint8_t frontFace;          // wgpu::FrontFace
+        uint8_t depthWriteEnabled;
+        uint8_t alphaToCoverageEnabled;
+        uint8_t blendEnable;
+        uint8_t colorWriteMask;     // wgpu::ColorWriteMask
+        uint8_t colorBlendOp;       // wgpu::BlendOperation
+        uint8_t alphaBlendOp;       // wgpu::BlendOperation
+        uint8_t srcColorBlendFactor; // wgpu::BlendFactor
+        uint8_t dstColorBlendFactor;
+        uint8_t srcAlphaBlendFactor;
+        uint8_t dstAlphaBlendFactor;
+        uint32_t depthCompare;      // wgpu::CompareFunction
+        int32_t depthBias;
+        float depthBiasSlopeScale;
+    };
+
+    static_assert(sizeof(RasterState) == 24, "RasterState must not have implicit padding.");
+
+    // The pipeline key is a POD that represents all the states that form the immutable
+    // wgpu::RenderPipeline object. It must be zero-initialized before being filled.
+    struct PipelineKey {
+        WGPUShaderModule vertexModule;
+        WGPUShaderModule fragmentModule;
+        WGPUPipelineLayout layout;
+        VertexAttribute vertexAttributes[VERTEX_ATTRIBUTE_COUNT];
+        VertexBufferLayout vertexBuffers[VERTEX_BUFFER_COUNT];
+        RasterState rasterState;
+        uint32_t colorFormats[COLOR_TARGET_COUNT];  // wgpu::TextureFormat
+        uint32_t depthFormat;                       // wgpu::TextureFormat
+        uint8_t topology;                           // wgpu::PrimitiveTopology
+        uint8_t sampleCount;
+        uint8_t colorTargetCount;
+        uint8_t vertexBufferCount : 7;
+        uint8_t hasDepth : 1;
+    };
+
+    static_assert(sizeof(PipelineKey) == 3 * sizeof(void*) + 384,
+            "PipelineKey must not have implicit padding.");
+
+    static_assert(std::is_trivially_copyable_v<PipelineKey>,
+            "PipelineKey must be a POD for fast hashing.");
+
+#if defined(__clang__)
+    #pragma clang diagnostic pop
+#endif
+
+    explicit WebGPUPipelineCache(wgpu::Device const& device) noexcept;
+
+    WebGPUPipelineCache(WebGPUPipelineCache const&) = delete;
+    WebGPUPipelineCache& operator=(WebGPUPipelineCache const&) = delete;
+
+    // Returns the pipeline matching `key`, creating it if needed.
+    wgpu::RenderPipeline const& getOrCreatePipeline(PipelineKey const& key) noexcept;
+
+    // Evicts the pipelines that haven't been used recently. Call once per frame.
+    void gc() noexcept;
+
+    // Releases all the cached pipelines.
+    void terminate() noexcept;
+
+private:
+    using PipelineHashFn = utils::hash::MurmurHashFn<PipelineKey>;
+
+    struct PipelineEqual {
+        bool operator()(PipelineKey const& k1, PipelineKey const& k2) const noexcept;
+    };
+
+    struct PipelineCacheEntry {
+        wgpu::RenderPipeline pipeline;
+        uint64_t lastUsed;
+    };
+
+    wgpu::RenderPipeline createPipeline(PipelineKey const& key) const noexcept;
+
+    wgpu::Device mDevice;
+    uint64_t mCurrentTime = 0;
+    tsl::robin_map<PipelineKey, PipelineCacheEntry, PipelineHashFn, PipelineEqual> mPipelines;
+};
+
+} // namespace filament::backend
+
+#endif // TNT_FILAMENT_BACKEND_WEBGPUPIPELINECACHE_H
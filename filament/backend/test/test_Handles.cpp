@@ -21,6 +21,9 @@
 #include <private/backend/HandleAllocator.h>
 #include "utils/Panic.h"
 
+#include <thread>
+#include <vector>
+
 using namespace filament::backend;
 
 // FIXME: consider making this constant non-private so we can use it in tests.
@@ -113,3 +116,36 @@ TEST(HandlesTest, isValid) {
         EXPECT_FALSE(allocator.is_valid(handle));
     }
 }
+
+TEST(HandlesTest, crossThreadAllocation) {
+    HandleAllocatorTest allocator("Test Handles", POOL_SIZE_BYTES);
+
+    // handles are allocated on this thread and freed on another one, like the engine and the
+    // driver thread do.
+    constexpr size_t HANDLE_COUNT = 4096;
+    std::vector<Handle<MyHandle>> handles(HANDLE_COUNT);
+    for (auto& handle : handles) {
+        handle = allocator.allocate<Concrete>();
+        EXPECT_TRUE((handle.getId() & HANDLE_HEAP_FLAG) == 0u);
+    }
+
+    std::thread driver([&allocator, &handles]() {
+        for (auto& handle : handles) {
+            allocator.deallocate(handle);
+        }
+    });
+    driver.join();
+
+    // all the handles went back to the arena, so we can allocate them again without falling
+    // back to the heap
+    for (size_t i = 0; i < POOL_HANDLE_COUNT / 2; i++) {
+        Handle<MyHandle> handle = allocator.allocate<Concrete>();
+        EXPECT_TRUE((handle.getId() & HANDLE_HEAP_FLAG) == 0u);
+    }
+
+    auto const stats = allocator.getStats();
+    EXPECT_EQ(stats.heapAllocations, 0u);
+    EXPECT_EQ(stats.heapHandles, 0u);
+    // the thread caches take the arena lock once per batch
+    EXPECT_LT(stats.arenaLocks, (HANDLE_COUNT * 2 + POOL_HANDLE_COUNT / 2) / 8);
+}
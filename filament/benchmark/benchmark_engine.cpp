@@ -0,0 +1,451 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "ResourceAllocator.h"
+
+#include "fg/FrameGraph.h"
+#include "fg/FrameGraphResources.h"
+
+#include <filament/Camera.h>
+#include <filament/Engine.h>
+#include <filament/IndexBuffer.h>
+#include <filament/LightManager.h>
+#include <filament/Material.h>
+#include <filament/RenderableManager.h>
+#include <filament/Renderer.h>
+#include <filament/Scene.h>
+#include <filament/TransformManager.h>
+#include <filament/VertexBuffer.h>
+#include <filament/View.h>
+
+#include <backend/Platform.h>
+
+#include <private/backend/CircularBuffer.h>
+#include <private/backend/CommandStream.h>
+#include <private/backend/PlatformFactory.h>
+
+#include <utils/Entity.h>
+#include <utils/EntityManager.h>
+
+#include <math/mat4.h>
+#include <math/vec3.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+using namespace filament;
+using namespace filament::math;
+using namespace backend;
+using namespace utils;
+
+/*
+ * CPU benchmarks of the engine, running against the noop backend, so that only the work done by
+ * Filament itself is measured.
+ *
+ * The scene benchmarks are parameterized by the number of renderables, from 1k to 1M. All
+ * renderables are visible, and share their geometry and material.
+ */
+
+namespace {
+
+// Scene sizes for the scene benchmarks
+constexpr int64_t MIN_RENDERABLES = 1'000;
+constexpr int64_t MAX_RENDERABLES = 1'000'000;
+
+class FilamentEngineFixture : public benchmark::Fixture {
+protected:
+    Engine* engine = nullptr;
+    SwapChain* swapChain = nullptr;
+    Renderer* renderer = nullptr;
+    Scene* scene = nullptr;
+    View* view = nullptr;
+    Camera* camera = nullptr;
+    VertexBuffer* vertexBuffer = nullptr;
+    IndexBuffer* indexBuffer = nullptr;
+    Entity cameraEntity;
+    Entity sun;
+    std::vector<Entity> renderables;
+    std::vector<Entity> lights;
+
+public:
+    void SetUp(benchmark::State& state) override {
+        size_t const count = size_t(state.range(0));
+
+        // the per-frame arenas must hold the commands of all the renderables
+        size_t const commandsSizeMB = (count * 256) / (1024 * 1024);
+        Engine::Config config{};
+        config.minCommandBufferSizeMB = std::max(config.minCommandBufferSizeMB,
+                uint32_t(commandsSizeMB));
+        config.perFrameCommandsSizeMB = std::max(config.perFrameCommandsSizeMB,
+                uint32_t(commandsSizeMB));
+        config.perRenderPassArenaSizeMB = std::max(config.perRenderPassArenaSizeMB,
+                uint32_t(config.perFrameCommandsSizeMB + commandsSizeMB / 4 + 1));
+
+        engine = Engine::Builder()
+                .backend(Engine::Backend::NOOP)
+                .config(&config)
+                .build();
+
+        swapChain = engine->createSwapChain(1920, 1080);
+        renderer = engine->createRenderer();
+        scene = engine->createScene();
+        view = engine->createView();
+
+        cameraEntity = EntityManager::get().create();
+        camera = engine->createCamera(cameraEntity);
+
+        // a cube, the content of the buffers doesn't matter with the noop backend
+        vertexBuffer = VertexBuffer::Builder()
+                .vertexCount(8)
+                .bufferCount(1)
+                .attribute(VertexAttribute::POSITION, 0, VertexBuffer::AttributeType::FLOAT3)
+                .build(*engine);
+
+        indexBuffer = IndexBuffer::Builder()
+                .indexCount(36)
+                .bufferType(IndexBuffer::IndexType::USHORT)
+                .build(*engine);
+
+        MaterialInstance const* const mi = engine->getDefaultMaterial()->getDefaultInstance();
+
+        // renderables are laid out on a cube grid, entirely in front of the camera
+        size_t const side = size_t(std::ceil(std::cbrt(double(count))));
+        float const spacing = 2.0f;
+        float const extent = float(side) * spacing;
+
+        renderables.resize(count);
+        EntityManager::get().create(count, renderables.data());
+        auto& tcm = engine->getTransformManager();
+        for (size_t i = 0; i < count; i++) {
+            RenderableManager::Builder(1)
+                    .boundingBox({{ 0, 0, 0 }, { 0.5f, 0.5f, 0.5f }})
+                    .material(0, mi)
+                    .geometry(0, RenderableManager::PrimitiveType::TRIANGLES,
+                            vertexBuffer, indexBuffer)
+                    .culling(false)
+                    .castShadows(true)
+                    .receiveShadows(true)
+                    .build(*engine, renderables[i]);
+            tcm.create(renderables[i]);
+            float3 const position{
+                    float(i % side) * spacing - extent * 0.5f,
+                    float((i / side) % side) * spacing - extent * 0.5f,
+                    -float(i / (side * side)) * spacing - 1.0f };
+            tcm.setTransform(tcm.getInstance(renderables[i]), mat4f::translation(position));
+        }
+        scene->addEntities(renderables.data(), renderables.size());
+
+        camera->setProjection(60.0, 16.0 / 9.0, 0.1, 10.0 * extent + 10.0);
+        camera->lookAt({ 0, 0, extent }, { 0, 0, -extent * 0.5f }, { 0, 1, 0 });
+
+        view->setScene(scene);
+        view->setCamera(camera);
+        view->setViewport({ 0, 0, 1920, 1080 });
+        view->setPostProcessingEnabled(false);
+        view->setShadowingEnabled(false);
+    }
+
+    void TearDown(benchmark::State&) override {
+        for (Entity const e : renderables) {
+            engine->destroy(e);
+        }
+        EntityManager::get().destroy(renderables.size(), renderables.data());
+        renderables.clear();
+
+        for (Entity const light : lights) {
+            engine->destroy(light);
+            EntityManager::get().destroy(light);
+        }
+        lights.clear();
+        if (sun) {
+            engine->destroy(sun);
+            EntityManager::get().destroy(sun);
+            sun = {};
+        }
+
+        engine->destroy(vertexBuffer);
+        engine->destroy(indexBuffer);
+        engine->destroyCameraComponent(cameraEntity);
+        EntityManager::get().destroy(cameraEntity);
+        engine->destroy(view);
+        engine->destroy(scene);
+        engine->destroy(renderer);
+        engine->destroy(swapChain);
+        Engine::destroy(&engine);
+    }
+
+protected:
+    void addSun(bool const castShadows) {
+        sun = EntityManager::get().create();
+        LightManager::Builder(LightManager::Type::SUN)
+                .direction({ 0.3f, -1.0f, -0.5f })
+                .castShadows(castShadows)
+                .build(*engine, sun);
+        scene->addEntity(sun);
+        view->setShadowingEnabled(castShadows);
+    }
+
+    void addPointLights(size_t const count, float const extent) {
+        lights.resize(count);
+        EntityManager::get().create(count, lights.data());
+        for (size_t i = 0; i < count; i++) {
+            // a deterministic spiral through the scene
+            float const t = float(i) / float(count);
+            float const a = float(i) * 2.399963f;
+            LightManager::Builder(LightManager::Type::POINT)
+                    .position({
+                            std::cos(a) * t * extent * 0.5f,
+                            std::sin(a) * t * extent * 0.5f,
+                            -t * extent })
+                    .falloff(extent * 0.1f)
+                    .build(*engine, lights[i]);
+        }
+        scene->addEntities(lights.data(), lights.size());
+    }
+
+    float getExtent() const noexcept {
+        return std::ceil(std::cbrt(float(renderables.size()))) * 2.0f;
+    }
+
+    // Renders one frame and waits for the backend to execute it. This covers the scene
+    // preparation, culling, light and shadow setup, command generation, sorting and
+    // instancing, the frame graph and the recording and execution of the command stream.
+    void renderFrame() {
+        if (renderer->beginFrame(swapChain)) {
+            renderer->render(view);
+            renderer->endFrame();
+        }
+        engine->flushAndWait();
+    }
+};
+
+} // anonymous namespace
+
+BENCHMARK_DEFINE_F(FilamentEngineFixture, transformUpdate)(benchmark::State& state) {
+    auto& tcm = engine->getTransformManager();
+    float angle = 0.0f;
+    for (auto _ : state) {
+        angle += 0.01f;
+        mat4f const rotation = mat4f::rotation(angle, float3{ 0, 1, 0 });
+        tcm.openLocalTransformTransaction();
+        for (Entity const e : renderables) {
+            tcm.setTransform(tcm.getInstance(e), rotation);
+        }
+        tcm.commitLocalTransformTransaction();
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(renderables.size()));
+}
+
+BENCHMARK_DEFINE_F(FilamentEngineFixture, transformUpdateParallel)(benchmark::State& state) {
+    auto& tcm = engine->getTransformManager();
+    float angle = 0.0f;
+    for (auto _ : state) {
+        angle += 0.01f;
+        mat4f const rotation = mat4f::rotation(angle, float3{ 0, 1, 0 });
+        tcm.openLocalTransformTransaction();
+        for (Entity const e : renderables) {
+            tcm.setTransform(tcm.getInstance(e), rotation);
+        }
+        tcm.commitLocalTransformTransaction(engine->getJobSystem());
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(renderables.size()));
+}
+
+BENCHMARK_DEFINE_F(FilamentEngineFixture, renderFrame)(benchmark::State& state) {
+    for (auto _ : state) {
+        renderFrame();
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(renderables.size()));
+}
+
+BENCHMARK_DEFINE_F(FilamentEngineFixture, renderFrameInstanced)(benchmark::State& state) {
+    engine->setAutomaticInstancingEnabled(true);
+    for (auto _ : state) {
+        renderFrame();
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(renderables.size()));
+}
+
+BENCHMARK_DEFINE_F(FilamentEngineFixture, renderFrameShadows)(benchmark::State& state) {
+    addSun(true);
+    for (auto _ : state) {
+        renderFrame();
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(renderables.size()));
+}
+
+BENCHMARK_DEFINE_F(FilamentEngineFixture, renderFramePointLights)(benchmark::State& state) {
+    addSun(false);
+    addPointLights(256, getExtent());
+    for (auto _ : state) {
+        renderFrame();
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(renderables.size()));
+}
+
+BENCHMARK_REGISTER_F(FilamentEngineFixture, transformUpdate)
+        ->RangeMultiplier(10)->Range(MIN_RENDERABLES, MAX_RENDERABLES)
+        ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_REGISTER_F(FilamentEngineFixture, transformUpdateParallel)
+        ->RangeMultiplier(10)->Range(MIN_RENDERABLES, MAX_RENDERABLES)
+        ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_REGISTER_F(FilamentEngineFixture, renderFrame)
+        ->RangeMultiplier(10)->Range(MIN_RENDERABLES, MAX_RENDERABLES)
+        ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_REGISTER_F(FilamentEngineFixture, renderFrameInstanced)
+        ->RangeMultiplier(10)->Range(MIN_RENDERABLES, MAX_RENDERABLES)
+        ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_REGISTER_F(FilamentEngineFixture, renderFrameShadows)
+        ->RangeMultiplier(10)->Range(MIN_RENDERABLES, MAX_RENDERABLES)
+        ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_REGISTER_F(FilamentEngineFixture, renderFramePointLights)
+        ->RangeMultiplier(10)->Range(MIN_RENDERABLES, MAX_RENDERABLES)
+        ->Unit(benchmark::kMillisecond);
+
+// ------------------------------------------------------------------------------------------------
+
+namespace {
+
+class NoopResourceAllocator : public ResourceAllocatorInterface {
+    uint32_t handle = 0;
+    struct NoopDisposer : public ResourceAllocatorDisposerInterface {
+        void destroy(TextureHandle) noexcept override {}
+    } disposer;
+
+public:
+    RenderTargetHandle createRenderTarget(const char*, TargetBufferFlags, uint32_t, uint32_t,
+            uint8_t, uint8_t, MRT, TargetBufferInfo, TargetBufferInfo) noexcept override {
+        return RenderTargetHandle(++handle);
+    }
+
+    void destroyRenderTarget(RenderTargetHandle) noexcept override {
+    }
+
+    TextureHandle createTexture(const char*, SamplerType, uint8_t, TextureFormat, uint8_t,
+            uint32_t, uint32_t, uint32_t, std::array<TextureSwizzle, 4>,
+            TextureUsage) noexcept override {
+        return TextureHandle(++handle);
+    }
+
+    void destroyTexture(TextureHandle) noexcept override {
+    }
+
+    ResourceAllocatorDisposerInterface& getDisposer() noexcept override {
+        return disposer;
+    }
+};
+
+class FilamentBackendFixture : public benchmark::Fixture {
+protected:
+    static constexpr size_t BUFFER_SIZE = 64 * 1024 * 1024;
+
+    Backend backend = Backend::NOOP;
+    Platform* platform = nullptr;
+    Driver* driver = nullptr;
+    std::unique_ptr<CircularBuffer> buffer;
+    std::unique_ptr<CommandStream> driverApi;
+    NoopResourceAllocator resourceAllocator;
+
+public:
+    void SetUp(benchmark::State&) override {
+        platform = PlatformFactory::create(&backend);
+        driver = platform->createDriver(nullptr, {});
+        buffer = std::make_unique<CircularBuffer>(BUFFER_SIZE);
+        driverApi = std::make_unique<CommandStream>(*driver, *buffer);
+    }
+
+    void TearDown(benchmark::State&) override {
+        driverApi.reset();
+        buffer.reset();
+        driver->terminate();
+        delete driver;
+        PlatformFactory::destroy(&platform);
+    }
+
+protected:
+    // terminates the recorded commands and executes them
+    void execute() {
+        new(buffer->allocate(sizeof(NoopCommand))) NoopCommand(nullptr);
+        auto const [begin, end] = buffer->getBuffer();
+        driverApi->execute(begin);
+    }
+};
+
+} // anonymous namespace
+
+// A chain of passes, each one reading the output of the previous one.
+BENCHMARK_DEFINE_F(FilamentBackendFixture, frameGraphCompile)(benchmark::State& state) {
+    size_t const count = size_t(state.range(0));
+    struct PassData {
+        FrameGraphId<FrameGraphTexture> input;
+        FrameGraphId<FrameGraphTexture> output;
+    };
+    for (auto _ : state) {
+        FrameGraph fg{ resourceAllocator };
+        FrameGraphId<FrameGraphTexture> previous;
+        for (size_t i = 0; i < count; i++) {
+            auto& pass = fg.addPass<PassData>("Pass",
+                    [&](FrameGraph::Builder& builder, auto& data) {
+                        if (previous) {
+                            data.input = builder.sample(previous);
+                        }
+                        data.output = builder.createTexture("Output", {
+                                .width = 1920, .height = 1080 });
+                        data.output = builder.declareRenderPass(data.output);
+                    },
+                    [](FrameGraphResources const&, auto const&, DriverApi&) {});
+            previous = pass->output;
+        }
+        fg.present(previous);
+        fg.compile();
+        fg.execute(*driverApi);
+        execute();
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(count));
+}
+
+BENCHMARK_DEFINE_F(FilamentBackendFixture, commandStream)(benchmark::State& state) {
+    size_t const count = size_t(state.range(0));
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; i++) {
+            driverApi->scissor({ 0, 0, 1920, 1080 });
+            driverApi->draw2(0, 36, 1);
+        }
+        execute();
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(count));
+}
+
+BENCHMARK_REGISTER_F(FilamentBackendFixture, frameGraphCompile)
+        ->RangeMultiplier(4)->Range(16, 1024)
+        ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_REGISTER_F(FilamentBackendFixture, commandStream)
+        ->RangeMultiplier(10)->Range(MIN_RENDERABLES, MAX_RENDERABLES)
+        ->Unit(benchmark::kMicrosecond);
@@ -54,6 +54,7 @@ class UTILS_PUBLIC BufferObject : public FilamentAPI {
 public:
     using BufferDescriptor = backend::BufferDescriptor;
     using BindingType = backend::BufferObjectBinding;
+    using BufferUsage = backend::BufferUsage;
 
     class Builder : public BuilderBase<BuilderDetails>, public BuilderNameMixin<Builder> {
         friend struct BuilderDetails;
@@ -79,6 +80,18 @@ public:
          */
         Builder& bindingType(BindingType bindingType) noexcept;
 
+        /**
+         * How often the content of the buffer is updated. (defaults to STATIC)
+         *
+         * DYNAMIC is meant for geometry that is replaced every frame or so, e.g. a point cloud.
+         * The backend can then place the buffer in memory the CPU writes to efficiently, and a
+         * full update replaces the storage rather than waiting for the GPU to be done with it.
+         *
+         * @param usage STATIC or DYNAMIC
+         * @return A reference to this Builder for chaining calls.
+         */
+        Builder& usage(BufferUsage usage) noexcept;
+
         /**
          * Associate an optional name with this BufferObject for debugging purposes.
          *
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//! \file
+
+#ifndef TNT_FILAMENT_EDITJOURNAL_H
+#define TNT_FILAMENT_EDITJOURNAL_H
+
+#include <filament/FilamentAPI.h>
+#include <filament/Box.h>
+#include <filament/Color.h>
+
+#include <utils/compiler.h>
+#include <utils/Entity.h>
+
+#include <math/mat4.h>
+#include <math/vec3.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace filament {
+
+/**
+ * EditJournal records changes to the transform, renderable and light components of entities,
+ * from any thread, and applies them all at once on the engine's thread.
+ *
+ * Unlike the component managers, which must only be used from the thread the Engine was created
+ * on, the methods of EditJournal can be called concurrently from any number of threads, e.g. by
+ * a simulation thread producing the transforms of the next frame. Producers only hold a short
+ * internal lock while their edits are appended, so they never wait on rendering.
+ *
+ * The recorded edits are applied in bulk at the beginning of Renderer::beginFrame(), in the order
+ * they were recorded for each kind of edit. Edits made to entities that no longer have the
+ * corresponding component by then are ignored.
+ *
+ * The journal is owned by the Engine:
+ *
+ * ~~~~~~~~~~~{.cpp}
+ * // simulation thread
+ * EditJournal& journal = engine->getEditJournal();
+ * journal.setTransforms(entities, transforms, count);
+ * journal.setLightIntensity(sun, 110000.0f);
+ * ~~~~~~~~~~~
+ *
+ * @see TransformManager, RenderableManager, LightManager
+ */
+class UTILS_PUBLIC EditJournal : public FilamentAPI {
+public:
+    /**
+     * Records a new local transform for the given entity.
+     * @see TransformManager::setTransform()
+     */
+    void setTransform(utils::Entity entity, const math::mat4f& localTransform) noexcept;
+
+    /**
+     * Records the local transforms of several entities at once; this takes the internal lock
+     * only once.
+     *
+     * @param entities          Array of \p count entities.
+     * @param localTransforms   Array of \p count local transforms, one per entity.
+     * @param count             Number of transforms to record.
+     */
+    void setTransforms(utils::Entity const* UTILS_NONNULL entities,
+            math::mat4f const* UTILS_NONNULL localTransforms, size_t count) noexcept;
+
+    /** @see RenderableManager::setAxisAlignedBoundingBox() */
+    void setAxisAlignedBoundingBox(utils::Entity entity, const Box& aabb) noexcept;
+
+    /** @see RenderableManager::setLayerMask() */
+    void setLayerMask(utils::Entity entity, uint8_t select, uint8_t values) noexcept;
+
+    /** @see RenderableManager::setPriority() */
+    void setPriority(utils::Entity entity, uint8_t priority) noexcept;
+
+    /** @see RenderableManager::setCastShadows() */
+    void setCastShadows(utils::Entity entity, bool enable) noexcept;
+
+    /** @see RenderableManager::setReceiveShadows() */
+    void setReceiveShadows(utils::Entity entity, bool enable) noexcept;
+
+    /** @see LightManager::setPosition() */
+    void setLightPosition(utils::Entity entity, const math::float3& position) noexcept;
+
+    /** @see LightManager::setDirection() */
+    void setLightDirection(utils::Entity entity, const math::float3& direction) noexcept;
+
+    /** @see LightManager::setColor() */
+    void setLightColor(utils::Entity entity, const LinearColor& color) noexcept;
+
+    /** @see LightManager::setIntensity() */
+    void setLightIntensity(utils::Entity entity, float intensity) noexcept;
+
+    /** @see LightManager::setIntensityCandela() */
+    void setLightIntensityCandela(utils::Entity entity, float intensity) noexcept;
+
+    /** @see LightManager::setFalloff() */
+    void setLightFalloff(utils::Entity entity, float radius) noexcept;
+
+protected:
+    // prevent heap allocation
+    ~EditJournal() = default;
+};
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_EDITJOURNAL_H
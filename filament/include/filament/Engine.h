@@ -50,6 +50,7 @@ class BufferObject;
 class Camera;
 class ColorGrading;
 class DebugRegistry;
+class EditJournal;
 class Fence;
 class IndexBuffer;
 class SkinningBuffer;
@@ -64,6 +65,7 @@ class Skybox;
 class Stream;
 class SwapChain;
 class Texture;
+class TextureAtlas;
 class VertexBuffer;
 class View;
 class InstanceBuffer;
@@ -85,7 +87,7 @@ class TransformManager;
 #endif
 
 #ifndef FILAMENT_COMMAND_BUFFER_SIZE_IN_MB
-#    define FILAMENT_COMMAND_BUFFER_SIZE_IN_MB (FILAMENT_MIN_COMMAND_BUFFERS_SIZE_IN_MB * 3)
+#    define FILAMENT_COMMAND_BUFFER_SIZE_IN_MB (FILAMENT_MIN_COMMAND_BUFFERS_SIZE_IN_MB * 2)
 #endif
 
 /**
@@ -189,6 +191,7 @@ public:
     using DriverConfig = backend::Platform::DriverConfig;
     using FeatureLevel = backend::FeatureLevel;
     using StereoscopicType = backend::StereoscopicType;
+    using MemoryBudget = backend::MemoryBudget;
     using Driver = backend::Driver;
 
     /**
@@ -207,9 +210,7 @@ public:
      *   +--------------------------+
      *
      *
-     *      .commandBufferSizeMB (default 3MiB)
-     *   +--------------------------+
-     *   | .minCommandBufferSizeMB  |
+     *      .commandBufferSizeMB (default 2MiB)
      *   +--------------------------+
      *   | .minCommandBufferSizeMB  |
      *   +--------------------------+
@@ -226,8 +227,10 @@ public:
          * Each new command buffer is allocated from here. If this buffer is too small the program
          * might terminate or rendering errors might occur.
          *
-         * This is typically set to minCommandBufferSizeMB * 3, so that up to 3 frames can be
-         * batched-up at once.
+         * This is typically set to minCommandBufferSizeMB * 2, so that a frame can be recorded
+         * while the previous one is executed. When the backend falls further behind, additional
+         * arenas of the same size are mapped temporarily, and released once the backend has
+         * caught up. It must be at least minCommandBufferSizeMB * 2.
          *
          * This value affects the application's memory usage.
          */
@@ -295,7 +298,8 @@ public:
          * CPU and reduce performance.
          *
          * The default value is 0, which implies that the Engine will use a heuristic to determine
-         * the number of threads to use.
+         * the number of threads to use. On heterogeneous CPUs (e.g. big.LITTLE), the efficiency
+         * cores are not counted, and the threads are kept on the performance cores.
          */
         uint32_t jobSystemThreadCount = 0;
 
@@ -401,6 +405,31 @@ public:
          * @deprecated use "backend.opengl.assert_native_window_is_valid" feature flag instead
          */
         bool assertNativeWindowIsValid = false;
+
+        /**
+         * Size in MiB of each of the (three) buffers of the per-frame user arena, see
+         * Engine::frameAlloc(). The buffers are only committed as they're used.
+         *
+         * If 0, frameAlloc() always returns nullptr.
+         */
+        uint32_t perFrameUserArenaSizeMB = 1;
+
+        /**
+         * Maximum number of MiB uploaded each frame by Texture::setImageAsync(). Larger images
+         * are uploaded over several frames.
+         *
+         * If 0, all the pending images are uploaded at the beginning of the next frame.
+         */
+        uint32_t textureUploadBudgetMB = 4;
+
+        /**
+         * Number of shared contexts (and threads) used by the OpenGL backend to compile and link
+         * programs in parallel, when the platform supports extra contexts.
+         *
+         * If 0, the backend picks a value suitable for the detected driver. The value is clamped
+         * to the number of hardware threads. Ignored on other backends.
+         */
+        uint32_t shaderCompilerThreadCount = 0;
     };
 
 
@@ -424,7 +453,7 @@ public:
      */
     utils::Slice<const FeatureFlag> getFeatureFlags() const noexcept;
 
-#if UTILS_HAS_THREADING
+#if UTILS_HAS_DRIVER_THREAD
     using CreateCallback = void(void* UTILS_NULLABLE user, void* UTILS_NONNULL token);
 #endif
 
@@ -511,7 +540,7 @@ public:
          */
         Builder& features(std::initializer_list<char const *> list) noexcept;
 
-#if UTILS_HAS_THREADING
+#if UTILS_HAS_DRIVER_THREAD
         /**
          * Creates the filament Engine asynchronously.
          *
@@ -553,7 +582,7 @@ public:
     }
 
 
-#if UTILS_HAS_THREADING
+#if UTILS_HAS_DRIVER_THREAD
     /**
      * Backward compatibility helper to create an Engine asynchronously.
      * @see Builder
@@ -758,6 +787,15 @@ public:
      */
     TransformManager& getTransformManager() noexcept;
 
+    /**
+     * The EditJournal records component changes from any thread and applies them in bulk in
+     * Renderer::beginFrame().
+     *
+     * @return EditJournal reference
+     * @see EditJournal
+     */
+    EditJournal& getEditJournal() noexcept;
+
     /**
      * Helper to enable accurate translations.
      * If you need this Engine to handle a very large world space, one way to achieve this
@@ -789,6 +827,54 @@ public:
      */
     bool isAutomaticInstancingEnabled() const noexcept;
 
+    /**
+     * Post-processing effects, used with prewarmPostProcessing().
+     */
+    enum class PostProcessingEffect : uint32_t {
+        AMBIENT_OCCLUSION       = 0x01,     //!< View::setAmbientOcclusionOptions()
+        BLOOM                   = 0x02,     //!< View::setBloomOptions(), including lens flares
+        DEPTH_OF_FIELD          = 0x04,     //!< View::setDepthOfFieldOptions()
+        TEMPORAL_ANTI_ALIASING  = 0x08,     //!< View::setTemporalAntiAliasingOptions()
+        FXAA                    = 0x10,     //!< View::setAntiAliasing()
+        UPSCALING               = 0x20,     //!< View::setDynamicResolutionOptions()
+        COLOR_GRADING           = 0x40,     //!< View::setColorGrading()
+        ALL                     = 0x7F
+    };
+
+    /**
+     * Post-processing materials are loaded the first time an effect is used, which can cause a
+     * hitch when an effect is enabled. prewarmPostProcessing() loads the materials of the given
+     * effects ahead of time, and compiles their shaders at a low priority, in the background on
+     * backends that support parallel shader compilation.
+     *
+     * This has no effect at feature level 0.
+     *
+     * @param effects the effects that will be used later.
+     */
+    void prewarmPostProcessing(PostProcessingEffect effects) noexcept;
+
+    /**
+     * Time spent in the phases of the engine's initialization, in nanoseconds. The phases are
+     * measured from the creation of the Engine, and can overlap.
+     */
+    struct StartupTimings {
+        uint64_t driver = 0;            //!< creating the platform and the backend driver
+        uint64_t resources = 0;         //!< default buffers, textures and descriptor set layouts
+        uint64_t defaultMaterial = 0;   //!< parsing and creating the default material
+        uint64_t lighting = 0;          //!< default color grading, light manager and DFG LUT
+        uint64_t postProcessing = 0;    //!< post-processing initialization
+        uint64_t total = 0;             //!< until the engine was ready to use
+    };
+
+    /**
+     * Returns how long the engine took to initialize, which can be used to track the time to
+     * the first frame. With createAsync(), the total includes the time until getEngine() is
+     * called.
+     *
+     * @return the duration of the initialization phases.
+     */
+    StartupTimings getStartupTimings() const noexcept;
+
     /**
      * Creates a SwapChain from the given Operating System's native window handle.
      *
@@ -899,6 +985,7 @@ public:
     bool destroy(const RenderTarget* UTILS_NULLABLE p);     //!< Destroys a RenderTarget object.
     bool destroy(const View* UTILS_NULLABLE p);             //!< Destroys a View object.
     bool destroy(const InstanceBuffer* UTILS_NULLABLE p);   //!< Destroys an InstanceBuffer object.
+    bool destroy(const TextureAtlas* UTILS_NULLABLE p);     //!< Destroys a TextureAtlas object.
     void destroy(utils::Entity e);    //!< Destroys all filament-known components from this entity
 
     /** Tells whether a BufferObject object is valid */
@@ -946,6 +1033,8 @@ public:
     bool isValid(const View* UTILS_NULLABLE p) const;
     /** Tells whether an InstanceBuffer object is valid */
     bool isValid(const InstanceBuffer* UTILS_NULLABLE p) const;
+    /** Tells whether a TextureAtlas object is valid */
+    bool isValid(const TextureAtlas* UTILS_NULLABLE p) const;
 
     /**
      * Retrieve the count of each resource tracked by Engine.
@@ -968,6 +1057,7 @@ public:
     size_t getSkyboxeCount() const noexcept;
     size_t getColorGradingCount() const noexcept;
     size_t getRenderTargetCount() const noexcept;
+    size_t getTextureAtlasCount() const noexcept;
     /**  @} */
 
     /**
@@ -1001,6 +1091,31 @@ public:
      */
     bool flushAndWait(uint64_t timeout);
 
+    /**
+     * Releases the memory held by caches that can be repopulated on demand, such as the
+     * render targets and textures each Renderer keeps around between frames.
+     *
+     * <p>This is typically used in response to memory pressure signals, such as Android's
+     * <code>android.content.ComponentCallbacks2.onTrimMemory</code>. It must not be called
+     * between Renderer::beginFrame() and Renderer::endFrame(). The next few frames may be slower
+     * while the caches are repopulated.</p>
+     */
+    void purgeCaches() noexcept;
+
+    /**
+     * Returns the GPU memory used by this process and the amount it can use, in bytes.
+     *
+     * <p>The budget is only known on some backends (Vulkan and Metal), and is 0 otherwise.
+     * On Vulkan it comes from VK_EXT_memory_budget when the device supports it, and is
+     * estimated from the size of the memory heaps otherwise.</p>
+     *
+     * <p>When the usage gets close to the budget, each Renderer releases its cached render
+     * targets at the end of the frame, as purgeCaches() does.</p>
+     *
+     * @return the memory usage and budget of the device local memory.
+     */
+    MemoryBudget getMemoryBudget() const noexcept;
+
     /**
      * Kicks the hardware thread (e.g. the OpenGL, Vulkan or Metal thread) but does not wait
      * for commands to be either executed or the hardware finished.
@@ -1105,6 +1220,26 @@ public:
      */
     void* UTILS_NULLABLE streamAlloc(size_t size, size_t alignment = alignof(double)) noexcept;
 
+    /**
+     * Allocates memory that stays valid for the current frame and the next two, i.e. until
+     * the frame has retired from the command queue. This is meant for the per-frame
+     * allocations of user code (e.g. the data of callbacks or custom commands), and avoids
+     * the heap.
+     *
+     * A frame starts with each Renderer::beginFrame() or Renderer::renderStandaloneView().
+     *
+     * This method is thread-safe and lock-free.
+     *
+     * @param size       size to allocate in bytes
+     * @param alignment  alignment requested, a power of two, at most 64
+     * @return           a pointer to the allocated buffer or nullptr if the frame's arena is
+     *                   exhausted (see Config::perFrameUserArenaSizeMB)
+     *
+     * @note there is no need to free this buffer, it is reclaimed automatically. No destructor
+     *       is ever called on the allocated memory.
+     */
+    void* UTILS_NULLABLE frameAlloc(size_t size, size_t alignment = alignof(double)) noexcept;
+
     /**
       * Invokes one iteration of the render loop, used only on single-threaded platforms.
       *
@@ -1198,4 +1333,7 @@ public:
 
 } // namespace filament
 
+template<> struct utils::EnableBitMaskOperators<filament::Engine::PostProcessingEffect>
+        : public std::true_type {};
+
 #endif // TNT_FILAMENT_ENGINE_H
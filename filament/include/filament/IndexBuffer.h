@@ -51,6 +51,7 @@ class UTILS_PUBLIC IndexBuffer : public FilamentAPI {
 
 public:
     using BufferDescriptor = backend::BufferDescriptor;
+    using BufferUsage = backend::BufferUsage;
 
     /**
      * Type of the index buffer
@@ -84,6 +85,18 @@ public:
          */
         Builder& bufferType(IndexType indexType) noexcept;
 
+        /**
+         * How often the content of the buffer is updated. (defaults to STATIC)
+         *
+         * DYNAMIC is meant for geometry that is replaced every frame or so, e.g. a point cloud.
+         * The backend can then place the buffer in memory the CPU writes to efficiently, and a
+         * full update replaces the storage rather than waiting for the GPU to be done with it.
+         *
+         * @param usage STATIC or DYNAMIC
+         * @return A reference to this Builder for chaining calls.
+         */
+        Builder& usage(BufferUsage usage) noexcept;
+
         /**
          * Associate an optional name with this IndexBuffer for debugging purposes.
          *
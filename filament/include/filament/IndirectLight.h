@@ -285,6 +285,37 @@ public:
      */
     const math::mat3f& getRotation() const noexcept;
 
+    /**
+     * Replaces the irradiance spherical harmonics, e.g. to follow a time-of-day sky.
+     *
+     * This is equivalent to Builder::irradiance(uint8_t, math::float3 const*), but doesn't
+     * require a new IndirectLight: the coefficients are sent to the GPU with the next frame's
+     * uniforms. If this IndirectLight was built without spherical harmonics, the diffuse
+     * irradiance comes from them instead of the reflections cubemap from then on.
+     *
+     * For environments that are rendered on the GPU, prefer building the IndirectLight without
+     * spherical harmonics and updating its reflections cubemap in place, e.g. with
+     * IBLPrefilterContext::SpecularFilter, which avoids reading the environment back.
+     *
+     * @param bands Number of spherical harmonics bands. Must be 1, 2 or 3.
+     * @param sh    Array containing \p bands^2 spherical harmonics coefficients, pre-scaled
+     *              and pre-convolved, as described in Builder::irradiance().
+     *
+     * @see Builder::irradiance(uint8_t bands, math::float3 const* sh)
+     */
+    void setIrradiance(uint8_t bands, math::float3 const* UTILS_NONNULL sh) noexcept;
+
+    /**
+     * Replaces the irradiance with spherical harmonics computed from radiance spherical
+     * harmonics.
+     *
+     * @param bands Number of spherical harmonics bands. Must be 1, 2 or 3.
+     * @param sh    Array containing \p bands^2 radiance spherical harmonics coefficients.
+     *
+     * @see Builder::radiance(uint8_t bands, math::float3 const* sh), setIrradiance()
+     */
+    void setRadiance(uint8_t bands, math::float3 const* UTILS_NONNULL sh) noexcept;
+
     /**
      * Returns the associated reflection map, or null if it does not exist.
      */
@@ -17,6 +17,7 @@
 #ifndef TNT_FILAMENT_INSTANCEBUFFER_H
 #define TNT_FILAMENT_INSTANCEBUFFER_H
 
+#include <filament/Box.h>
 #include <filament/FilamentAPI.h>
 #include <filament/Engine.h>
 
@@ -71,6 +72,20 @@ public:
          */
         Builder& localTransforms(math::mat4f const* UTILS_NULLABLE localTransforms) noexcept;
 
+        /**
+         * Enables per-instance frustum culling. Each frame, the instances whose bounding box is
+         * outside of the view's frustum are skipped, and only the visible instances are drawn.
+         *
+         * The culling uses the camera of the view, so instances outside of it don't cast shadows.
+         * This is meant for large numbers of small instances, such as vegetation, where this is
+         * not noticeable. The renderable's own bounding box must still enclose all instances.
+         *
+         * @param boundingBox the bounding box of a single instance, in the space of the
+         *                    renderable's vertices, i.e. before the instance's local transform
+         *                    is applied. By default, instances are not culled.
+         */
+        Builder& instanceBoundingBox(Box const& boundingBox) noexcept;
+
         /**
          * Associate an optional name with this InstanceBuffer for debugging purposes.
          *
@@ -117,6 +132,9 @@ public:
      * of the associated renderable. This forms a parent-child relationship between the renderable
      * and its instances, so adjusting the renderable's transform will affect all instances.
      *
+     * Unless instances are culled, only the range of instances modified since the previous frame
+     * is uploaded, so moving a few instances is cheap.
+     *
      * @param localTransforms an array of math::mat4f with length count, need not outlive this call
      * @param count the number of local transforms
      * @param offset index of the first instance to set local transforms
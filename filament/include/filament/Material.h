@@ -178,6 +178,33 @@ public:
          * @exception utils::PreConditionPanic if a parameter to a builder function was invalid.
          */
         Material* UTILS_NULLABLE build(Engine& engine) const;
+
+        /**
+         * Creates the Material object and schedules the compilation of a subset of its variants,
+         * see Material::compile().
+         *
+         * Unlike Material::compile(), the variants are compiled on all backends, including the
+         * ones that don't support parallel shader compilation; there, the programs are
+         * created by the backend thread ahead of the first frame that uses them, and the calling
+         * thread doesn't wait for them. This is best used while a loading screen is displayed.
+         *
+         * @param engine        Reference to the filament::Engine to associate this Material with.
+         * @param priority      Which priority queue to use, LOW or HIGH.
+         * @param variants      Variants to compile.
+         * @param handler       Handler to dispatch the callback or nullptr for the default handler
+         * @param callback      callback called on the main thread when the compilation is done
+         *                      by the backend. It's not called if the Material can't be created.
+         *
+         * @return pointer to the newly created object or nullptr if exceptions are disabled and
+         *         an error occurred.
+         *
+         * @see build(), Material::compile()
+         */
+        Material* UTILS_NULLABLE buildAsync(Engine& engine,
+                backend::CompilerPriorityQueue priority,
+                UserVariantFilterMask variants,
+                backend::CallbackHandler* UTILS_NULLABLE handler = nullptr,
+                utils::Invocable<void(Material* UTILS_NONNULL)>&& callback = {}) const;
     private:
         friend class FMaterial;
     };
@@ -350,6 +377,27 @@ public:
     //! Indicates whether an existing parameter is a sampler or not.
     bool isSampler(const char* UTILS_NONNULL name) const noexcept;
 
+    /**
+     * Resolves a uniform parameter once, so that it can be set on any instance of this material
+     * without looking up its name, e.g.:
+     *
+     * ~~~~~~~~~~~{.cpp}
+     *  auto const baseColor = material->getParameterHandle<float4>("baseColor");
+     *  for (MaterialInstance* mi : instances) {
+     *      mi->setParameter(baseColor, color);
+     *  }
+     * ~~~~~~~~~~~
+     *
+     * @param name The name of the material parameter
+     * @return A handle to the parameter, which is invalid if the parameter doesn't exist or
+     *         doesn't have the type T.
+     *
+     * @see MaterialInstance::setParameter(ParameterHandle<T>, T const&)
+     */
+    template<typename T, typename = MaterialInstance::is_supported_parameter_t<T>>
+    MaterialInstance::ParameterHandle<T> getParameterHandle(
+            const char* UTILS_NONNULL name) const noexcept;
+
     /**
      * Sets the value of the given parameter on this material's default instance.
      *
@@ -86,6 +86,32 @@ public:
             std::is_same_v<math::mat3f, T>
     >;
 
+    /**
+     * A handle to a uniform parameter of type T, resolved once by Material::getParameterHandle().
+     * Setting a parameter through a handle avoids looking up its name on every call.
+     *
+     * A handle can be used with all the instances of the Material it was obtained from.
+     *
+     * @see Material::getParameterHandle()
+     */
+    template<typename T>
+    class ParameterHandle {
+    public:
+        ParameterHandle() noexcept = default;
+
+        //! Returns whether the parameter exists and has the type T.
+        bool isValid() const noexcept { return mOffset >= 0; }
+
+    private:
+        friend class Material;
+        friend class MaterialInstance;
+        ParameterHandle(Material const* UTILS_NONNULL material, int32_t const offset) noexcept
+                : mMaterial(material), mOffset(offset) {
+        }
+        Material const* UTILS_NULLABLE mMaterial = nullptr;
+        int32_t mOffset = -1;   // offset in bytes in the uniform buffer
+    };
+
     /**
      * Creates a new MaterialInstance using another MaterialInstance as a template for initialization.
      * The new MaterialInstance is an instance of the same Material of the template instance and
@@ -132,6 +158,18 @@ public:
     }
 
 
+    /**
+     * Set a uniform using a handle obtained from Material::getParameterHandle(). This is faster
+     * than setting it by name.
+     *
+     * @param handle        Handle of the parameter. If the handle is not valid, this is a no-op.
+     * @param value         Value of the parameter to set.
+     * @throws utils::PreConditionPanic if the handle was obtained from a different Material.
+     * @see Material::getParameterHandle()
+     */
+    template<typename T, typename = is_supported_parameter_t<T>>
+    void setParameter(ParameterHandle<T> handle, T const& value);
+
     /**
      * Set a uniform array by name
      *
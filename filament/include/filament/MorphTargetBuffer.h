@@ -139,6 +139,24 @@ public:
     void setPositionsAt(Engine& engine, size_t targetIndex,
             math::float4 const* UTILS_NONNULL positions, size_t count, size_t offset = 0);
 
+    /**
+     * Updates the positions of a sparse morph target, which only moves the listed vertices.
+     *
+     * Only the range between the smallest and the largest index is uploaded. Within that range,
+     * the vertices that are not listed are reset to a zero displacement. This is cheaper than
+     * uploading the whole target when it only affects a small region of the mesh, e.g. the
+     * targets of a facial rig.
+     *
+     * @param engine Reference to the filament::Engine associated with this MorphTargetBuffer.
+     * @param targetIndex the index of morph target to be updated.
+     * @param indices pointer to "count" vertex indices, in any order and without duplicates
+     * @param positions pointer to "count" positions, one for each index
+     * @param count number of vertices moved by this target
+     */
+    void setPositionsAt(Engine& engine, size_t targetIndex,
+            uint32_t const* UTILS_NONNULL indices,
+            math::float3 const* UTILS_NONNULL positions, size_t count);
+
     /**
      * Updates tangents for the given morph target.
      *
@@ -61,6 +61,11 @@ enum class BlendMode : uint8_t {
  * homogeneousScaling: by default the system scales the major axis first. Set this to true
  *                     to force homogeneous scaling.
  *
+ * predictive: by default the scale is driven by a PID controller fed with the measured frame
+ *             time. Set this to true to instead pick the scale predicted to meet the target
+ *             frame time, from a model of the GPU time as a function of the rendered area and
+ *             the number of renderables in the scene. This reacts faster to load changes.
+ *
  * minScale:  the minimum scale in X and Y this View should use
  *
  * maxScale:  the maximum scale in X and Y this View should use
@@ -82,6 +87,7 @@ struct DynamicResolutionOptions {
     float sharpness = 0.9f;                         //!< sharpness when QualityLevel::MEDIUM or higher is used [0 (disabled), 1 (sharpest)]
     bool enabled = false;                           //!< enable or disable dynamic resolution
     bool homogeneousScaling = false;                //!< set to true to force homogeneous scaling
+    bool predictive = false;                        //!< set to true to predict the scale from a model of the GPU frame time
 
     /**
      * Upscaling quality
@@ -167,6 +173,23 @@ struct BloomOptions {
  * Options to control large-scale fog in the scene
  */
 struct FogOptions {
+    /**
+     * Where the fog is evaluated.
+     */
+    enum class Mode : uint8_t {
+        /**
+         * Fog is computed by every material, as part of the color pass.
+         */
+        PER_MATERIAL,
+        /**
+         * Fog is computed once per pixel by a full-screen pass that runs after the color pass and
+         * reads the depth buffer. Pixels where the fog has no effect are rejected early. This is
+         * usually cheaper when the fog covers a large part of the screen, but transparent objects
+         * are fogged as if they were at the depth of the opaque objects behind them.
+         */
+        FULL_SCREEN
+    };
+
     /**
      * Distance in world units [m] from the camera to where the fog starts ( >= 0.0 )
      */
@@ -278,6 +301,11 @@ struct FogOptions {
      * Enable or disable large-scale fog
      */
     bool enabled = false;
+
+    /**
+     * How the fog is applied to the scene.
+     */
+    Mode mode = Mode::PER_MATERIAL;
 };
 
 /**
@@ -516,6 +544,16 @@ enum class Dithering : uint8_t {
     TEMPORAL    //!< Temporal dithering (default)
 };
 
+/**
+ * List of available depth prepass modes.
+ * @see View::setDepthPrepass
+ */
+enum class DepthPrepass : uint8_t {
+    DISABLED,   //!< Opaque objects are rendered once (default)
+    ENABLED,    //!< Opaque objects are first rendered in the depth buffer only
+    AUTOMATIC   //!< The prepass is used when the measured GPU frame time shows it's faster
+};
+
 /**
  * List of available shadow mapping techniques.
  * @see setShadowType
@@ -156,6 +156,12 @@ public:
          */
         static constexpr uint8_t DEFAULT_CHANNEL = 2u;
 
+        /**
+         * Maximum number of levels of detail a renderable can declare
+         * @see Builder::levelOfDetail()
+         */
+        static constexpr uint8_t MAX_LEVEL_OF_DETAIL_COUNT = 4u;
+
         /**
          * Type of geometry for a Renderable
          */
@@ -220,6 +226,9 @@ public:
          * the renderable are immutable.
          * STATIC geometry has the same restrictions as STATIC_BOUNDS, but in addition disallows
          * skinning, morphing and changing the VertexBuffer or IndexBuffer in any way.
+         * Renderables with STATIC_BOUNDS or STATIC geometry are frustum-culled using a bounding
+         * volume hierarchy maintained by the Scene, which is rebuilt only when the set of such
+         * renderables in the Scene changes.
          * @param type type of geometry.
          */
         Builder& geometryType(GeometryType type) noexcept;
@@ -497,7 +506,7 @@ public:
         /**
          * Specifies the the range of the MorphTargetBuffer to use with this primitive.
          *
-         * @param level the level of detail (lod), only 0 can be specified
+         * @param level the level of detail (lod), ignored; primitives are indexed across all levels
          * @param primitiveIndex zero-based index of the primitive, must be less than the count passed to Builder constructor
          * @param offset specifies where in the morph target buffer to start reading (expressed as a number of vertices)
          */
@@ -573,6 +582,43 @@ public:
         Builder& instances(size_t instanceCount,
                 InstanceBuffer* UTILS_NONNULL instanceBuffer) noexcept;
 
+        /**
+         * Declares a level of detail as a contiguous range of this renderable's primitives.
+         *
+         * Level 0 is the most detailed level. At each frame, filament estimates the size of the
+         * renderable's bounding sphere on screen, as a fraction of the viewport height, and
+         * renders the coarsest level whose \p screenSize is still larger than that estimate.
+         * Levels must therefore be declared with decreasing \p screenSize; the \p screenSize
+         * of level 0 is ignored.
+         *
+         * When no level of detail is declared, all primitives are always rendered. When levels
+         * are declared, they must be declared contiguously starting from level 0.
+         *
+         * Shadow maps select their level of detail from the main camera, and may use a coarser
+         * level than the one rendered to the screen.
+         *
+         * @param level         the level of detail, must be less than MAX_LEVEL_OF_DETAIL_COUNT
+         * @param first         index of the first primitive of this level
+         * @param count         number of primitives of this level
+         * @param screenSize    this level is used when the renderable covers less than
+         *                      \p screenSize of the viewport height (e.g. 0.25)
+         *
+         * @return Builder reference for chaining calls.
+         */
+        Builder& levelOfDetail(uint8_t level, size_t first, size_t count,
+                float screenSize) noexcept;
+
+        /**
+         * Sets the relative width of the band around each levelOfDetail() threshold within which
+         * the current level of detail is kept, to avoid popping back and forth when the
+         * renderable's screen size hovers around a threshold. The default is 0.1 (10%).
+         *
+         * @param hysteresis    relative hysteresis, clamped between 0 and 0.5.
+         *
+         * @return Builder reference for chaining calls.
+         */
+        Builder& levelOfDetailHysteresis(float hysteresis) noexcept;
+
         /**
          * Adds the Renderable component to an entity.
          *
@@ -593,6 +639,22 @@ public:
          */
         Result build(Engine& engine, utils::Entity entity);
 
+        /**
+         * Adds the same Renderable component to several entities.
+         *
+         * @param engine Reference to the filament::Engine to associate the Renderables with.
+         * @param count Number of entities in the array.
+         * @param entities Array of entities to add the Renderable component to.
+         * @return Success if the components were created successfully, Error otherwise.
+         *
+         * This is equivalent to calling build(Engine&, utils::Entity) for each entity, but the
+         * builder is validated only once, and the storage of the components is grown only once
+         * for the whole batch. Each entity gets its own primitives and GPU resources.
+         *
+         * @see build(Engine&, utils::Entity)
+         */
+        Result build(Engine& engine, size_t count, utils::Entity const* entities);
+
     private:
         friend class FEngine;
         friend class FRenderPrimitive;
@@ -90,6 +90,22 @@ public:
     struct FrameInfo {
         using time_point_ns = int64_t;
         using duration_ns = int64_t;
+
+        /**
+         * Breakdown of the main thread time spent in render(), summed over all the Views
+         * rendered in the frame. prepare includes scene, culling and shadows.
+         */
+        struct CpuTimings {
+            duration_ns prepare;            //!< View preparation [ns]
+            duration_ns scene;              //!< Scene preparation (transforms, bounds) [ns]
+            duration_ns culling;            //!< frustum and occlusion culling [ns]
+            duration_ns shadows;            //!< shadow maps setup and shadow casters culling [ns]
+            duration_ns frameGraphSetup;    //!< declaration of the rendering passes [ns]
+            duration_ns frameGraphCompile;  //!< frame graph compilation [ns]
+            duration_ns frameGraphExecute;  //!< generation and recording of the commands [ns]
+            duration_ns flush;              //!< flush of the command buffer [ns]
+        };
+
         uint32_t frameId;                   //!< monotonically increasing frame identifier
         duration_ns frameTime;              //!< frame duration on the GPU in nanosecond [ns]
         duration_ns denoisedFrameTime;      //!< denoised frame duration on the GPU in [ns]
@@ -97,6 +113,7 @@ public:
         time_point_ns endFrame;             //!< Renderer::endFrame() time since epoch [ns]
         time_point_ns backendBeginFrame;    //!< Backend thread time of frame start since epoch [ns]
         time_point_ns backendEndFrame;      //!< Backend thread time of frame end since epoch [ns]
+        CpuTimings cpu;                     //!< main thread time breakdown of render()
     };
 
     /**
@@ -114,6 +131,92 @@ public:
      */
     size_t getMaxFrameHistorySize() const noexcept;
 
+    /**
+     * GPU timing of a single rendering pass
+     * @see getPassTimings()
+     */
+    struct PassTiming {
+        using duration_ns = int64_t;
+        char const* name;                   //!< name of the pass, a static string
+        duration_ns gpuTime;                //!< pass duration on the GPU in nanosecond [ns]
+    };
+
+    /**
+     * Enables or disables the collection of per-pass GPU timings. This is disabled by default
+     * as it adds two timer queries per rendering pass.
+     *
+     * Pass timings are not supported with the OpenGL backend, which can't nest timer queries;
+     * in that case this call has no effect.
+     *
+     * @param enabled true to collect pass timings.
+     * @see getPassTimings()
+     */
+    void setPassTimingsEnabled(bool enabled) noexcept;
+
+    /**
+     * Retrieves the GPU timings of each rendering pass of the most recent frame for which
+     * they're available, which typically lags a few frames behind. Passes that run several
+     * times per frame (e.g. once per View) have an entry for each execution, in order.
+     *
+     * @return A vector of PassTiming, empty if pass timings are disabled or not available yet.
+     * @see setPassTimingsEnabled()
+     */
+    utils::FixedCapacityVector<PassTiming> getPassTimings() const noexcept;
+
+    /**
+     * Enables or disables frame skipping, which is enabled by default.
+     *
+     * With frame skipping, beginFrame() returns false when the GPU is more than a couple of
+     * frames behind, which keeps the latency low for interactive rendering. Disabling it is
+     * meant for throughput-oriented, offscreen rendering (e.g. batch rendering of thumbnails):
+     * beginFrame() then always returns true, and the number of frames in flight is only bounded
+     * by the backend, which blocks when the GPU is too far behind. To keep the GPU busy, avoid
+     * waiting on a Fence after each frame, and collect the results from the readPixels()
+     * callbacks instead.
+     *
+     * @param enabled true to let beginFrame() skip frames when the GPU falls behind.
+     * @see beginFrame()
+     */
+    void setFrameSkippingEnabled(bool enabled) noexcept;
+
+    /**
+     * Enables or disables the low latency mode, which is disabled by default.
+     *
+     * In low latency mode, beginFrame() skips the frame unless the GPU has completed the
+     * previous one, so at most one frame is in flight instead of two. This reduces the input
+     * to photon latency by about a frame, at the cost of throughput: the CPU and the GPU can't
+     * work on consecutive frames at the same time anymore, and frames are skipped as soon as
+     * the GPU is slightly behind.
+     *
+     * This has no effect when frame skipping is disabled. Use it together with
+     * View::setLateLatchCallback() to also reduce the latency of the camera.
+     *
+     * @param enabled true to allow a single frame in flight.
+     * @see setFrameSkippingEnabled(), View::setLateLatchCallback()
+     */
+    void setLowLatencyModeEnabled(bool enabled) noexcept;
+
+    /**
+     * Enables or disables the render-on-demand mode, which is disabled by default.
+     *
+     * In render-on-demand mode, beginFrame() returns false when nothing changed since the last
+     * presented frame, so that an idle application uses almost no CPU and GPU time. Once
+     * something changes, a few more frames are rendered after the change so that temporal
+     * effects, such as TAA, converge.
+     *
+     * Changes are: calls to the setters of View, Scene, Camera, RenderableManager,
+     * LightManager, TransformManager, IndirectLight and of the buffers and Textures, changes of
+     * MaterialInstance parameters, pending texture uploads, and the existence of a Stream.
+     * A setter counts as a change even if it sets the same value, so avoid calling them
+     * every frame. Changes the engine doesn't see, e.g. materials animated with
+     * getUserTime(), require rendering the frame anyway, which is allowed: render() and
+     * endFrame() can be called even when beginFrame() returned false.
+     *
+     * @param enabled true to skip the frames that would be identical to the last one.
+     * @see beginFrame()
+     */
+    void setRenderOnDemandEnabled(bool enabled) noexcept;
+
     /**
      * Use FrameRateOptions to set the desired frame rate and control how quickly the system
      * reacts to GPU load changes.
@@ -143,6 +246,31 @@ public:
         uint8_t interval = 1;              //!< desired frame interval in unit of 1.0 / DisplayInfo::refreshRate
     };
 
+    /**
+     * Use QualityGovernorOptions to let the Renderer lower the quality of the Views it renders
+     * when the device heats up, or when frames take longer than the target set in
+     * FrameRateOptions, and restore it once there is headroom again.
+     *
+     * Quality is lowered one level at a time, each level adding to the previous ones:
+     * 1. the dynamic resolution scale is capped to maxResolutionScale (only for Views that
+     *    use View::DynamicResolutionOptions)
+     * 2. SSAO uses its lowest quality, at half resolution
+     * 3. shadow maps are half their size, with at most 2 cascades
+     * 4. bloom uses at most 4 levels, at low quality
+     * 5. MSAA is disabled
+     *
+     * The thermal state of the device is only available on Android (API level 30 and up, 31 for
+     * the thermal headroom). Elsewhere, only the frame times are taken into account.
+     *
+     * The options set on the Views are not modified.
+     *
+     * @see getQualityLevel()
+     */
+    struct QualityGovernorOptions {
+        bool enabled = false;               //!< whether the quality is adjusted automatically
+        float maxResolutionScale = 0.75f;   //!< dynamic resolution cap, from the first level
+    };
+
     /**
      * ClearOptions are used at the beginning of a frame to clear or retain the SwapChain content.
      */
@@ -197,6 +325,18 @@ public:
      */
     void setFrameRateOptions(FrameRateOptions const& options) noexcept;
 
+    /**
+     * Set options controlling the adaptive quality of the rendered Views.
+     */
+    void setQualityGovernorOptions(QualityGovernorOptions const& options) noexcept;
+
+    /**
+     * Returns the current quality level set by the quality governor, from 0 (full quality) to
+     * 5 (all the reductions described in QualityGovernorOptions are applied). Always 0 when
+     * the governor is disabled.
+     */
+    uint8_t getQualityLevel() const noexcept;
+
     /**
      * Set ClearOptions which are used at the beginning of a frame to clear or retain the
      * SwapChain content.
@@ -313,8 +453,12 @@ public:
      * @note
      * All calls to render() must happen *after* beginFrame().
      *
+     * @note
+     * The edits recorded in the Engine's EditJournal are applied by beginFrame(), even when
+     * the frame is skipped.
+     *
      * @see
-     * endFrame()
+     * endFrame(), EditJournal
      */
     bool beginFrame(SwapChain* UTILS_NONNULL swapChain,
             uint64_t vsyncSteadyClockTimeNano = 0u);
@@ -333,6 +477,22 @@ public:
      */
     void setPresentationTime(int64_t monotonic_clock_ns);
 
+    /**
+     * Set the region of the frame that changed since the previous one, in pixels of the
+     * SwapChain with the origin at the bottom-left. The window system may then only compose and
+     * update that region, which saves power when a mostly static UI changes little per frame.
+     *
+     * The whole frame is still rendered; only its presentation is affected. The region is
+     * forgotten after the frame is presented, and an empty region (the default) means the
+     * whole frame changed.
+     *
+     * This must be called between beginFrame() and endFrame(). It is a hint, currently only
+     * used by the OpenGL backend with EGL_KHR_swap_buffers_with_damage.
+     *
+     * @param region the rectangle that changed since the last frame.
+     */
+    void setPresentationDamage(Viewport const& region);
+
     /**
      * Render a View into this renderer's window.
      *
@@ -389,6 +549,29 @@ public:
      */
     void render(View const* UTILS_NONNULL view);
 
+    /**
+     * Renders several Views, in order, within the same frame.
+     *
+     * This is equivalent to calling render() for each View, but lets the Renderer see the
+     * whole frame's work at once, which it uses to share work between Views: the objects of a
+     * Scene used by several of the Views are gathered (world transforms and bounds, lights)
+     * only once.
+     *
+     * @param views An array of \p count pointers to the views to render.
+     * @param count Number of views in \p views.
+     *
+     * @attention
+     * render() must be called *after* beginFrame() and *before* endFrame().
+     *
+     * @note
+     * Views are prepared one after the other: their preparation issues commands to the Engine's
+     * command stream, which is filled from one thread only, and Views of the same Scene share
+     * its culling data. Each View still uses the JobSystem internally.
+     *
+     * @see render(View const*)
+     */
+    void render(View const* UTILS_NONNULL const* UTILS_NONNULL views, size_t count);
+
     /**
      * Copy the currently rendered view to the indicated swap chain, using the
      * indicated source and destination rectangle.
@@ -458,6 +641,10 @@ public:
      *
      * It is also possible to use a Fence to wait for the read-back.
      *
+     * To read back every frame without allocating, keep a few buffers in a ring, and give each
+     * one back to the ring from its callback: the backends reuse their staging buffers across
+     * read-backs of the same size, so the pixels are copied once, into `buffer`.
+     *
      * @remark
      * readPixels() is intended for debugging and testing. It will impact performance significantly.
      *
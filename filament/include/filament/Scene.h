@@ -22,13 +22,14 @@
 #include <filament/FilamentAPI.h>
 
 #include <utils/compiler.h>
+#include <utils/Entity.h>
 #include <utils/Invocable.h>
 
-#include <stddef.h>
+#include <math/vec3.h>
+
+#include <limits>
 
-namespace utils {
-    class Entity;
-} // namespace utils
+#include <stddef.h>
 
 namespace filament {
 
@@ -182,6 +183,37 @@ public:
      */
     void forEach(utils::Invocable<void(utils::Entity entity)>&& functor) const noexcept;
 
+    /**
+     * Result of a ray query.
+     * @see raycast
+     */
+    struct RaycastResult {
+        //! The renderable hit first by the ray, or a null entity if none was hit.
+        utils::Entity renderable;
+        //! Distance from the ray's origin to the renderable's bounding box, 0 if it contains
+        //! the origin.
+        float distance = 0.0f;
+    };
+
+    /**
+     * Finds the renderable whose world-space bounding box is hit first by a ray.
+     *
+     * Only the bounding boxes of the renderables are tested, not their triangles, which makes
+     * this suitable for selection and gameplay queries that can then refine the result.
+     *
+     * Renderables with a dynamic geometry type are tested with their current transform.
+     * Renderables with static bounds (see RenderableManager::Builder::geometryType) are
+     * found through the hierarchy built when the scene was last rendered, and are only
+     * tested individually before then.
+     *
+     * @param origin        origin of the ray, in world space
+     * @param direction     direction of the ray, in world space, doesn't need to be normalized
+     * @param maxDistance   renderables farther than this distance from the origin are ignored
+     * @return the renderable hit first, and its distance to the origin
+     */
+    RaycastResult raycast(math::float3 const& origin, math::float3 const& direction,
+            float maxDistance = std::numeric_limits<float>::infinity()) const noexcept;
+
 protected:
     // prevent heap allocation
     ~Scene() = default;
@@ -185,6 +185,11 @@ public:
      * It is not necessary to add an additional retain call before passing the pixel buffer to
      * Filament. Filament will call CVPixelBufferRetain during Engine::createSwapChain, and
      * CVPixelBufferRelease when the swap chain is destroyed.
+     *
+     * This is how rendered frames can be given to a hardware video encoder without reading them
+     * back: create a swap chain for each pixel buffer of the encoder's pool (e.g. the pool of a
+     * VTCompressionSession), render each frame into the next one, and submit its pixel buffer to
+     * the encoder from the callback set with setFrameCompletedCallback().
      */
     static const uint64_t CONFIG_APPLE_CVPIXELBUFFER =
             backend::SWAP_CHAIN_CONFIG_APPLE_CVPIXELBUFFER;
@@ -234,6 +239,36 @@ public:
      */
     static constexpr uint64_t CONFIG_PROTECTED_CONTENT = backend::SWAP_CHAIN_CONFIG_PROTECTED_CONTENT;
 
+    /**
+     * Presents with MAILBOX instead of FIFO: the image waiting to be displayed is replaced by
+     * newer ones, so rendering isn't throttled by v-sync and doesn't tear. Falls back to FIFO
+     * when not supported. Only supported by the Vulkan backend.
+     */
+    static constexpr uint64_t CONFIG_PRESENT_MODE_MAILBOX =
+            backend::SWAP_CHAIN_CONFIG_PRESENT_MODE_MAILBOX;
+
+    /**
+     * Presents without waiting for v-sync, which can tear. Falls back to FIFO when not supported.
+     * Only supported by the Vulkan backend.
+     */
+    static constexpr uint64_t CONFIG_PRESENT_MODE_IMMEDIATE =
+            backend::SWAP_CHAIN_CONFIG_PRESENT_MODE_IMMEDIATE;
+
+    /**
+     * Presents with v-sync, but a late frame is presented immediately and can tear. Falls back
+     * to FIFO when not supported. Only supported by the Vulkan backend.
+     */
+    static constexpr uint64_t CONFIG_PRESENT_MODE_FIFO_RELAXED =
+            backend::SWAP_CHAIN_CONFIG_PRESENT_MODE_FIFO_RELAXED;
+
+    /**
+     * Uses the fewest images the surface allows, which reduces the display latency at the cost
+     * of throughput. Combine with Renderer::setLowLatencyModeEnabled() to also limit the frames
+     * in flight. Only supported by the Vulkan backend.
+     */
+    static constexpr uint64_t CONFIG_MINIMUM_IMAGE_COUNT =
+            backend::SWAP_CHAIN_CONFIG_MINIMUM_IMAGE_COUNT;
+
     /**
      * Return whether createSwapChain supports the CONFIG_PROTECTED_CONTENT flag.
      * The default implementation returns false.
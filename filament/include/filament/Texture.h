@@ -28,6 +28,8 @@
 #include <utils/compiler.h>
 #include <utils/StaticString.h>
 
+#include <math/vec2.h>
+
 #include <utility>
 
 #include <stddef.h>
@@ -114,6 +116,14 @@ public:
     /** @return the maximum number of layers supported by texture arrays. At least 256. */
     static size_t getMaxArrayTextureLayers(Engine& engine) noexcept;
 
+    /**
+     * @return the size in texels of the pages of a sparse texture of type \p type and format
+     * \p format, or zero if the backend doesn't support this combination (or sparse textures
+     * at all). Only SAMPLER_2D is supported. c.f. Texture::Usage::SPARSE.
+     */
+    static math::uint2 getSparsePageSize(Engine& engine, Sampler type,
+            InternalFormat format) noexcept;
+
     /**
      * Options for environment prefiltering into reflection map
      *
@@ -199,6 +209,11 @@ public:
          * If the texture is potentially rendered into, it may require a different memory layout,
          * which needs to be known during construction.
          *
+         * With Texture::Usage::SPARSE, the texture is created without memory, which is committed
+         * page by page with Texture::commitPages(). Sparse textures must be SAMPLER_2D, can't
+         * be protected nor used as attachments, and their format must have a non-zero
+         * Texture::getSparsePageSize().
+         *
          * @param usage Defaults to Texture::Usage::DEFAULT; c.f. Texture::Usage::COLOR_ATTACHMENT.
          * @return This Builder, for chaining calls.
          */
@@ -406,6 +421,52 @@ public:
         setImage(engine, level, xoffset, yoffset, 0, width, height, 1, std::move(buffer));
     }
 
+    /**
+     * Updates a sub-image of a texture like setImage(), but spreads the upload over several
+     * frames so that large images don't spike the frame time.
+     *
+     * The image is uploaded at the beginning of the following frames (Renderer::beginFrame()
+     * or Renderer::renderStandaloneView()), at most Engine::Config::textureUploadBudgetMB per
+     * frame, in runs of rows or of whole layers. Uploads are processed in the order they're
+     * requested. Compressed images are not split.
+     *
+     * \p buffer must stay valid until its callback is called, which is when the whole image has
+     * been uploaded. The level is sampled from that point on.
+     *
+     * @param engine    Engine this texture is associated to.
+     * @param level     Level to set the image for.
+     * @param xoffset   Left offset of the sub-region to update.
+     * @param yoffset   Bottom offset of the sub-region to update.
+     * @param zoffset   Depth offset of the sub-region to update.
+     * @param width     Width of the sub-region to update.
+     * @param height    Height of the sub-region to update.
+     * @param depth     Depth of the sub-region to update.
+     * @param buffer    Client-side buffer containing the image to set.
+     *
+     * @attention \p engine must be the instance passed to Builder::build()
+     * @attention \p level must be less than getLevels().
+     * @attention \p buffer's Texture::Format must match that of getFormat().
+     *
+     * @see setImage(), Engine::Config::textureUploadBudgetMB
+     */
+    void setImageAsync(Engine& engine, size_t level,
+            uint32_t xoffset, uint32_t yoffset, uint32_t zoffset,
+            uint32_t width, uint32_t height, uint32_t depth,
+            PixelBufferDescriptor&& buffer) const;
+
+    /**
+     * inline helper to update a 2D texture asynchronously
+     *
+     * @see setImageAsync(Engine& engine, size_t level,
+     *              uint32_t xoffset, uint32_t yoffset, uint32_t zoffset,
+     *              uint32_t width, uint32_t height, uint32_t depth,
+     *              PixelBufferDescriptor&& buffer)
+     */
+    void setImageAsync(Engine& engine, size_t level, PixelBufferDescriptor&& buffer) const {
+        setImageAsync(engine, level, 0, 0, 0,
+            uint32_t(getWidth(level)), uint32_t(getHeight(level)), 1, std::move(buffer));
+    }
+
     /**
      * Specify all six images of a cube map level.
      *
@@ -543,6 +604,71 @@ public:
      */
     void generateMipmaps(Engine& engine) const noexcept;
 
+    /**
+     * Uploads level 0 of a 2D texture and generates the other mipmap levels on the CPU, with a
+     * box filter. This doesn't require any usage bits, and works with formats that can't be
+     * mipmapped by the GPU. Textures with an sRGB format are filtered in linear space.
+     *
+     * This is a utility function that replaces calls to Texture::setImage() for all levels.
+     *
+     * The source data must obey to some constraints:
+     *   - the data format must be one of PixelDataFormat::R, RG, RGB or RGBA
+     *   - the data type must be one of PixelDataType::UBYTE, HALF or FLOAT
+     *   - the data must cover the whole level 0
+     *
+     * @warning The levels are generated synchronously, using the engine's JobSystem.
+     *
+     * @param engine        Engine this texture is associated to.
+     * @param buffer        Client-side buffer containing level 0.
+     *
+     * @attention \p engine must be the instance passed to Builder::build()
+     * @attention This Texture instance must use SamplerType::SAMPLER_2D
+     *
+     * @exception utils::PreConditionPanic If the source data constraints are not respected.
+     */
+    void generateMipmaps(Engine& engine, PixelBufferDescriptor&& buffer) const;
+
+    /**
+     * Makes the memory of the pages covering a region of a mip level of a sparse texture resident.
+     * The content of newly committed pages is undefined until it's uploaded with setImage(),
+     * reading pages that are not committed returns zero.
+     *
+     * The smallest levels, which fit in less than a page, are always resident; committing pages
+     * in these levels has no effect.
+     *
+     * @param engine    Engine this texture is associated to.
+     * @param level     Level of the region.
+     * @param xoffset   Left offset of the region, in texels.
+     * @param yoffset   Bottom offset of the region, in texels.
+     * @param width     Width of the region, in texels.
+     * @param height    Height of the region, in texels.
+     *
+     * @attention \p engine must be the instance passed to Builder::build()
+     * @attention This Texture instance must have been created with Texture::Usage::SPARSE
+     */
+    void commitPages(Engine& engine, size_t level,
+            uint32_t xoffset, uint32_t yoffset, uint32_t width, uint32_t height) const;
+
+    /**
+     * Releases the memory of the pages covering a region of a mip level of a sparse texture,
+     * c.f. commitPages().
+     *
+     * @warning On Vulkan, this waits for the GPU to be done with the frames in flight; releasing
+     * pages should be batched and done infrequently.
+     *
+     * @param engine    Engine this texture is associated to.
+     * @param level     Level of the region.
+     * @param xoffset   Left offset of the region, in texels.
+     * @param yoffset   Bottom offset of the region, in texels.
+     * @param width     Width of the region, in texels.
+     * @param height    Height of the region, in texels.
+     *
+     * @attention \p engine must be the instance passed to Builder::build()
+     * @attention This Texture instance must have been created with Texture::Usage::SPARSE
+     */
+    void decommitPages(Engine& engine, size_t level,
+            uint32_t xoffset, uint32_t yoffset, uint32_t width, uint32_t height) const;
+
     /**
      * Creates a reflection map from an environment map.
      *
@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_TEXTUREATLAS_H
+#define TNT_FILAMENT_TEXTUREATLAS_H
+
+#include <filament/FilamentAPI.h>
+#include <filament/Texture.h>
+
+#include <utils/compiler.h>
+#include <utils/StaticString.h>
+
+#include <math/mat3.h>
+#include <math/vec2.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace filament {
+
+class Engine;
+
+/**
+ * TextureAtlas packs many small images into a single Texture, so that the material instances
+ * using them all bind the same texture.
+ *
+ * Each image is placed in a square region of the atlas whose size is the power-of-two just
+ * above its largest dimension, and that is no smaller than 1/8th of the atlas' size. The
+ * returned Region tells where the image lives, as a transform from the image's own texture
+ * coordinates to the atlas', for instance to set as the `baseColorUvMatrix` parameter of a
+ * gltfio material.
+ *
+ * When the atlas has a single layer, its texture is a regular 2D texture; otherwise it's a 2D
+ * array and materials must also be given the layer of each Region.
+ *
+ * Images are sampled without mipmaps, and regions map to the centers of the image's edge texels
+ * so that bilinear filtering never reads a neighboring image. Texture coordinates outside of
+ * [0, 1] can't be wrapped or repeated.
+ *
+ * The atlas owns its texture, which is destroyed along with the atlas.
+ *
+ * Usage example:
+ *
+ * ~~~~~~~~~~~{.cpp}
+ * TextureAtlas* atlas = TextureAtlas::Builder()
+ *          .size(2048)
+ *          .build(*engine);
+ *
+ * TextureAtlas::Region const region = atlas->add(*engine, 96, 64, std::move(buffer));
+ * if (region.isValid()) {
+ *     mi->setParameter("baseColorMap", atlas->getTexture(), sampler);
+ *     mi->setParameter("baseColorUvMatrix", region.getUvMatrix());
+ * }
+ * ~~~~~~~~~~~
+ */
+class UTILS_PUBLIC TextureAtlas : public FilamentAPI {
+    struct BuilderDetails;
+
+public:
+    //! Maximum number of layers of an atlas.
+    static constexpr size_t MAX_LAYER_COUNT = 64;
+
+    //! Number of region sizes, the largest is the atlas' size, each other is half the previous.
+    static constexpr size_t REGION_SIZE_COUNT = 4;
+
+    //! Where an image lives in the atlas.
+    struct Region {
+        //! Layer of the image, or -1 if the image couldn't be added to the atlas.
+        int32_t layer = -1;
+        //! Texture coordinates of the image's (0, 0) corner in the atlas.
+        math::float2 offset{};
+        //! Extent of the image in the atlas' texture coordinates.
+        math::float2 scale{};
+
+        bool isValid() const noexcept { return layer >= 0; }
+
+        //! Transform from the image's texture coordinates to the atlas'.
+        math::mat3f getUvMatrix() const noexcept {
+            return math::mat3f{
+                    scale.x, 0.0f, 0.0f,
+                    0.0f, scale.y, 0.0f,
+                    offset.x, offset.y, 1.0f };
+        }
+    };
+
+    class Builder : public BuilderBase<BuilderDetails>, public BuilderNameMixin<Builder> {
+        friend struct BuilderDetails;
+
+    public:
+        Builder() noexcept;
+        Builder(Builder const& rhs) noexcept;
+        Builder(Builder&& rhs) noexcept;
+        ~Builder() noexcept;
+        Builder& operator=(Builder const& rhs) noexcept;
+        Builder& operator=(Builder&& rhs) noexcept;
+
+        /**
+         * Width and height of the atlas. Must be a power of two. Defaults to 1024.
+         *
+         * @param size width and height of the atlas, in texels
+         * @return This Builder, for chaining calls.
+         */
+        Builder& size(uint32_t size) noexcept;
+
+        /**
+         * Number of layers of the atlas, between 1 and MAX_LAYER_COUNT. Defaults to 1.
+         *
+         * @param layerCount number of layers
+         * @return This Builder, for chaining calls.
+         */
+        Builder& layerCount(uint8_t layerCount) noexcept;
+
+        /**
+         * Format of the atlas. All images added to the atlas must be of a compatible format.
+         * Defaults to RGBA8.
+         *
+         * @param format internal format of the atlas' texture
+         * @return This Builder, for chaining calls.
+         */
+        Builder& format(Texture::InternalFormat format) noexcept;
+
+        /**
+         * Associate an optional name with this TextureAtlas for debugging purposes.
+         *
+         * name will show in error messages and should be kept as short as possible.
+         *
+         * @param name A string literal to identify this TextureAtlas
+         * @return This Builder, for chaining calls.
+         */
+        Builder& name(utils::StaticString const& name) noexcept;
+
+        /**
+         * Creates the TextureAtlas object and returns a pointer to it.
+         */
+        TextureAtlas* UTILS_NONNULL build(Engine& engine);
+
+    private:
+        friend class FTextureAtlas;
+    };
+
+    /**
+     * Adds an image to the atlas and uploads it.
+     *
+     * @param engine  Engine this atlas is associated to.
+     * @param width   Width of the image, in texels. Must not be larger than the atlas.
+     * @param height  Height of the image, in texels. Must not be larger than the atlas.
+     * @param buffer  Client-side buffer containing the image.
+     * @return The region of the atlas holding the image, which is invalid when the atlas is
+     *         full. In that case, the buffer's callback is still called.
+     */
+    Region add(Engine& engine, uint32_t width, uint32_t height,
+            Texture::PixelBufferDescriptor&& buffer);
+
+    /**
+     * Makes the whole atlas available again. The content of the texture is left as is, until
+     * new images are added.
+     */
+    void clear() noexcept;
+
+    /**
+     * Returns the texture holding all the images. It belongs to the atlas, and must not be
+     * destroyed.
+     */
+    Texture* UTILS_NONNULL getTexture() const noexcept;
+
+    /**
+     * Returns the number of images added since the atlas was created or cleared.
+     */
+    size_t getRegionCount() const noexcept;
+
+protected:
+    // prevent heap allocation
+    ~TextureAtlas() = default;
+};
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_TEXTUREATLAS_H
@@ -30,6 +30,7 @@
 
 namespace utils {
 class Entity;
+class JobSystem;
 } // namespace utils
 
 namespace filament {
@@ -182,6 +183,23 @@ public:
     void create(utils::Entity entity, Instance parent, const math::mat4& localTransform); //!< \overload
     void create(utils::Entity entity, Instance parent = {}); //!< \overload
 
+    /**
+     * Creates transform components for several entities at once.
+     * @param count             Number of entities in the array.
+     * @param entities          Array of entities to associate a transform component to.
+     * @param parent            The Instance of the parent transform, or Instance{} if no parent.
+     * @param localTransform    The transform to initialize all the transform components with.
+     *                          This is always relative to the parent.
+     *
+     * This is equivalent to calling create() for each entity, but the storage of the
+     * components is grown only once for the whole batch.
+     *
+     * @see create(utils::Entity, Instance, const math::mat4f&)
+     */
+    void create(size_t count, utils::Entity const* entities, Instance parent,
+            const math::mat4f& localTransform);
+    void create(size_t count, utils::Entity const* entities, Instance parent = {}); //!< \overload
+
     /**
      * Destroys this component from the given entity, children are orphaned.
      * @param e An entity.
@@ -333,6 +351,23 @@ public:
      */
     void commitLocalTransformTransaction() noexcept;
 
+    /**
+     * Commits the currently open local transform transaction, like
+     * commitLocalTransformTransaction(), but the world transforms are computed in parallel on
+     * the given JobSystem, one level of the hierarchy at a time.
+     *
+     * This is useful when a transaction updates a large hierarchy, in particular a wide one
+     * (e.g. tens of thousands of transforms with few levels).
+     *
+     * @param js The JobSystem to use, typically Engine::getJobSystem(). This must be called
+     *           from a thread that can use this JobSystem, e.g. the Engine's thread.
+     *
+     * @note If the local transform transaction is not open, this is a no-op.
+     *
+     * @see openLocalTransformTransaction(), commitLocalTransformTransaction()
+     */
+    void commitLocalTransformTransaction(utils::JobSystem& js) noexcept;
+
 protected:
     // prevent heap allocation
     ~TransformManager() = default;
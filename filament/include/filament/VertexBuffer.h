@@ -61,6 +61,7 @@ class UTILS_PUBLIC VertexBuffer : public FilamentAPI {
 public:
     using AttributeType = backend::ElementType;
     using BufferDescriptor = backend::BufferDescriptor;
+    using BufferUsage = backend::BufferUsage;
 
     class Builder : public BuilderBase<BuilderDetails>, public BuilderNameMixin<Builder> {
         friend struct BuilderDetails;
@@ -102,6 +103,21 @@ public:
          */
         Builder& enableBufferObjects(bool enabled = true) noexcept;
 
+        /**
+         * How often the content of the buffers is updated. (defaults to STATIC)
+         *
+         * DYNAMIC is meant for geometry that is replaced every frame or so, e.g. a point cloud.
+         * The backend can then place the buffers in memory the CPU writes to efficiently, and a
+         * full update replaces the storage rather than waiting for the GPU to be done with it.
+         *
+         * This only applies to the buffers created by the VertexBuffer itself, i.e. when buffer
+         * objects are not enabled. Otherwise, see BufferObject::Builder::usage().
+         *
+         * @param usage STATIC or DYNAMIC
+         * @return A reference to this Builder for chaining calls.
+         */
+        Builder& usage(BufferUsage usage) noexcept;
+
         /**
          * Sets up an attribute for this vertex buffer set.
          *
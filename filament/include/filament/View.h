@@ -25,6 +25,7 @@
 #include <utils/compiler.h>
 #include <utils/Entity.h>
 #include <utils/FixedCapacityVector.h>
+#include <utils/Invocable.h>
 
 #include <math/mathfwd.h>
 
@@ -74,6 +75,7 @@ public:
     using BlendMode = filament::BlendMode;
     using AntiAliasing = filament::AntiAliasing;
     using Dithering = filament::Dithering;
+    using DepthPrepass = filament::DepthPrepass;
     using ShadowType = filament::ShadowType;
 
     using DynamicResolutionOptions = filament::DynamicResolutionOptions;
@@ -212,6 +214,30 @@ public:
         return const_cast<View*>(this)->getCamera();
     }
 
+    /**
+     * Callback used to late latch the camera. It's called with the camera's model matrix used
+     * to prepare the frame, and returns true if it updated it.
+     */
+    using LateLatchCallback = utils::Invocable<bool(math::mat4& modelMatrix)>;
+
+    /**
+     * Sets a callback which can update the camera's model matrix just before the frame is
+     * submitted to the GPU ("late latching"), e.g. with the latest head or device pose.
+     *
+     * The callback is called once per frame, on the backend thread, right before the View's
+     * uniforms are uploaded, which reduces the input latency by the time spent preparing and
+     * recording the frame. Only the viewing transform is updated: culling, shadows and the
+     * light froxelization still use the camera as it was when the frame was prepared, so the
+     * callback should only apply small adjustments. The projection can't be changed.
+     *
+     * Because it runs on the backend thread, the callback must synchronize its access to any
+     * state shared with the application, and it must not call any Filament API.
+     *
+     * @param callback The callback to use, or an empty callback to disable late latching.
+     * @see Renderer::setLowLatencyModeEnabled()
+     */
+    void setLateLatchCallback(LateLatchCallback&& callback) noexcept;
+
     /**
      * Sets the blending mode used to draw the view into the SwapChain.
      *
@@ -293,6 +319,26 @@ public:
      */
     bool isScreenSpaceRefractionEnabled() const noexcept;
 
+    /**
+     * Enables or disables order-independent blending. Disabled by default.
+     *
+     * Blended objects are normally drawn back to front. Objects using BlendingMode::ADD,
+     * BlendingMode::MULTIPLY or BlendingMode::SCREEN, that don't write depth and use
+     * TransparencyMode::DEFAULT, give the same result in any order among themselves. When
+     * enabled, these are drawn grouped by material instead, which saves state changes.
+     *
+     * Their order relative to other blended objects (e.g. BlendingMode::TRANSPARENT) isn't
+     * preserved, which can be visible when they overlap on screen.
+     *
+     * @param enabled true enables order-independent blending, false disables it.
+     */
+    void setOrderIndependentBlendingEnabled(bool enabled) noexcept;
+
+    /**
+     * @return whether order-independent blending is enabled
+     */
+    bool isOrderIndependentBlendingEnabled() const noexcept;
+
     /**
      * Sets how many samples are to be used for MSAA in the post-process stage.
      * Default is 1 and disables MSAA.
@@ -505,6 +551,31 @@ public:
      */
     Dithering getDithering() const noexcept;
 
+    /**
+     * Sets whether the color pass starts by rendering the opaque objects in the depth buffer
+     * only, so that only the visible fragments of the opaque objects are shaded. Disabled by
+     * default.
+     *
+     * This is typically a win on desktop GPUs with expensive materials and a lot of overdraw,
+     * and a loss on tile-based GPUs, which already avoid shading hidden fragments. With
+     * DepthPrepass::AUTOMATIC, the view regularly measures the GPU frame time with and without
+     * the prepass and uses the fastest. This requires the GPU frame timings, see
+     * Renderer::getFrameInfoHistory().
+     *
+     * Objects that are blended, use alpha to coverage, or use screen-space refraction are not
+     * rendered in the prepass.
+     *
+     * @param prepass DepthPrepass::DISABLED, DepthPrepass::ENABLED or DepthPrepass::AUTOMATIC
+     */
+    void setDepthPrepass(DepthPrepass prepass) noexcept;
+
+    /**
+     * Queries the depth prepass mode.
+     *
+     * @return the current depth prepass mode for this view.
+     */
+    DepthPrepass getDepthPrepass() const noexcept;
+
     /**
      * Sets the dynamic resolution options for this view. Dynamic resolution options
      * controls whether dynamic resolution is enabled, and if it is, how it behaves.
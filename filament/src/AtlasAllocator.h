@@ -73,6 +73,9 @@ class AtlasAllocator {
     using NodeId = QuadTree::NodeId;
 
 public:
+    // number of allocation sizes permitted, maxTextureSize and the smaller power-of-two.
+    static constexpr size_t SIZE_COUNT = QUAD_TREE_DEPTH;
+
     /*
      * Create allocator and specify the maximum texture size. Must be a power of two.
      * Allocations size allowed are the four power-of-two smaller or equal to this size.
@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BoundingVolumeHierarchy.h"
+
+#include "Intersections.h"
+
+#include <math/vec2.h>
+#include <math/vec3.h>
+#include <math/vec4.h>
+
+#include <utils/compiler.h>
+#include <utils/debug.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <stddef.h>
+#include <stdint.h>
+
+using namespace filament::math;
+
+namespace filament {
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy() noexcept = default;
+
+BoundingVolumeHierarchy::~BoundingVolumeHierarchy() noexcept = default;
+
+void BoundingVolumeHierarchy::clear() noexcept {
+    mNodes.clear();
+    mIndices.clear();
+    mCenters.clear();
+    mExtents.clear();
+}
+
+void BoundingVolumeHierarchy::build(
+        float3 const* centers, float3 const* extents, size_t const count) {
+    clear();
+    if (!count) {
+        return;
+    }
+
+    assert_invariant(count <= std::numeric_limits<uint32_t>::max());
+
+    mIndices.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        mIndices[i] = i;
+    }
+
+    // a balanced tree with leaves of at least LEAF_SIZE / 2 boxes has less than this many nodes
+    mNodes.reserve(4 * (count + LEAF_SIZE - 1) / LEAF_SIZE);
+
+    buildRecursive(centers, extents, 0, uint32_t(count));
+
+    // store the boxes in leaf order, so that leaves are tested with linear memory accesses
+    mCenters.resize(count);
+    mExtents.resize(count);
+    for (size_t k = 0; k < count; k++) {
+        mCenters[k] = centers[mIndices[k]];
+        mExtents[k] = extents[mIndices[k]];
+    }
+}
+
+void BoundingVolumeHierarchy::buildRecursive(float3 const* centers, float3 const* extents,
+        uint32_t const first, uint32_t const count) {
+    assert_invariant(count > 0);
+
+    uint32_t const index = uint32_t(mNodes.size());
+    mNodes.emplace_back();
+
+    constexpr float inf = std::numeric_limits<float>::infinity();
+    float3 boxMin{ inf }, boxMax{ -inf };
+    float3 centroidMin{ inf }, centroidMax{ -inf };
+    for (uint32_t k = first; k < first + count; k++) {
+        float3 const c = centers[mIndices[k]];
+        float3 const e = extents[mIndices[k]];
+        boxMin = min(boxMin, c - e);
+        boxMax = max(boxMax, c + e);
+        centroidMin = min(centroidMin, c);
+        centroidMax = max(centroidMax, c);
+    }
+
+    if (count > LEAF_SIZE) {
+        // split at the median along the axis of largest spread of the centroids
+        float3 const spread = centroidMax - centroidMin;
+        size_t const axis = (spread.x >= spread.y && spread.x >= spread.z) ? 0 :
+                            (spread.y >= spread.z ? 1 : 2);
+        uint32_t* const begin = mIndices.data() + first;
+        uint32_t* const middle = begin + count / 2;
+        std::nth_element(begin, middle, begin + count,
+                [centers, axis](uint32_t const lhs, uint32_t const rhs) {
+                    return centers[lhs][axis] < centers[rhs][axis];
+                });
+        buildRecursive(centers, extents, first, count / 2);
+        buildRecursive(centers, extents, first + count / 2, count - count / 2);
+    }
+
+    // Inflate the node's bounds very slightly, so that rounding errors never cause a node to be
+    // rejected while one of its boxes would have been accepted.
+    Node& node = mNodes[index];
+    node.center = (boxMax + boxMin) * 0.5f;
+    node.halfExtent = (boxMax - boxMin) * (0.5f * (1.0f + 1.0f / 1024.0f));
+    node.first = first;
+    node.count = count;
+    node.skip = uint32_t(mNodes.size());
+}
+
+void BoundingVolumeHierarchy::cull(result_type* const UTILS_RESTRICT results,
+        float4 const planes[6], size_t const bit) const noexcept {
+
+    Node const* UTILS_RESTRICT const nodes = mNodes.data();
+    uint32_t const* UTILS_RESTRICT const indices = mIndices.data();
+    float3 const* UTILS_RESTRICT const centers = mCenters.data();
+    float3 const* UTILS_RESTRICT const extents = mExtents.data();
+    result_type const visibleBit = result_type(1u << bit);
+
+    float3 absPlanes[6];
+    for (size_t j = 0; j < 6; j++) {
+        absPlanes[j] = abs(planes[j].xyz);
+    }
+
+    for (size_t n = 0, c = mNodes.size(); n < c;) {
+        Node const& node = nodes[n];
+
+        // a node is outside if it's entirely in front of any plane, and entirely inside if
+        // it's behind all planes.
+        bool outside = false;
+        bool inside = true;
+        for (size_t j = 0; j < 6; j++) {
+            float const d = dot(planes[j].xyz, node.center) + planes[j].w;
+            float const r = dot(absPlanes[j], node.halfExtent);
+            outside |= (d - r) >= 0.0f;
+            inside  &= (d + r) <  0.0f;
+        }
+
+        if (outside) {
+            n = node.skip;
+            continue;
+        }
+
+        if (inside) {
+            // the whole subtree is visible, no need to go further
+            for (uint32_t k = node.first, e = node.first + node.count; k < e; k++) {
+                results[indices[k]] |= visibleBit;
+            }
+            n = node.skip;
+            continue;
+        }
+
+        if (node.count <= LEAF_SIZE) {
+            // this is the same test as Culler::intersects()
+            for (uint32_t k = node.first, e = node.first + node.count; k < e; k++) {
+                bool visible = true;
+                for (size_t j = 0; j < 6; j++) {
+                    float const d = dot(planes[j].xyz, centers[k]) -
+                            dot(absPlanes[j], extents[k]) + planes[j].w;
+                    visible &= std::signbit(d);
+                }
+                results[indices[k]] |= result_type(unsigned(visible) << bit);
+            }
+            n = node.skip;
+            continue;
+        }
+
+        // visit the children, the first one immediately follows its parent
+        n = n + 1;
+    }
+}
+
+BoundingVolumeHierarchy::RaycastResult BoundingVolumeHierarchy::raycast(
+        float3 const origin, float3 const direction, float const maxDistance) const noexcept {
+
+    Node const* UTILS_RESTRICT const nodes = mNodes.data();
+    uint32_t const* UTILS_RESTRICT const indices = mIndices.data();
+    float3 const* UTILS_RESTRICT const centers = mCenters.data();
+    float3 const* UTILS_RESTRICT const extents = mExtents.data();
+    float3 const invDirection = 1.0f / direction;
+
+    RaycastResult result{ NO_HIT, maxDistance };
+    for (size_t n = 0, c = mNodes.size(); n < c;) {
+        Node const& node = nodes[n];
+
+        // skip the subtrees that are missed, behind the origin, or farther than the closest hit
+        float2 const t = rayBoxIntersection(origin, invDirection, node.center, node.halfExtent);
+        if (t.x > t.y || t.y < 0.0f || t.x > result.distance) {
+            n = node.skip;
+            continue;
+        }
+
+        if (node.count <= LEAF_SIZE) {
+            for (uint32_t k = node.first, e = node.first + node.count; k < e; k++) {
+                float2 const tk = rayBoxIntersection(origin, invDirection, centers[k], extents[k]);
+                float const distance = std::max(tk.x, 0.0f);
+                if (tk.x <= tk.y && tk.y >= 0.0f && distance <= result.distance) {
+                    result = { indices[k], distance };
+                }
+            }
+            n = node.skip;
+            continue;
+        }
+
+        // visit the children, the first one immediately follows its parent
+        n = n + 1;
+    }
+    return result;
+}
+
+} // namespace filament
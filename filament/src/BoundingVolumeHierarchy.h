@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_BOUNDINGVOLUMEHIERARCHY_H
+#define TNT_FILAMENT_BOUNDINGVOLUMEHIERARCHY_H
+
+#include "Culler.h"
+
+#include <math/vec3.h>
+#include <math/vec4.h>
+
+#include <limits>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace filament {
+
+/*
+ * A bounding volume hierarchy of axis-aligned boxes, used to cull renderables with static bounds.
+ *
+ * The hierarchy is built top-down with a median split along the largest axis of the centroids'
+ * bounds, and is stored as a flat depth-first array of nodes where each node knows the index
+ * of the node following its subtree. This allows a stack-less traversal that can skip
+ * whole subtrees that are outside (or entirely inside) the frustum.
+ */
+class BoundingVolumeHierarchy {
+public:
+    using result_type = Culler::result_type;
+
+    // maximum number of boxes stored in a leaf
+    static constexpr size_t LEAF_SIZE = 8;
+
+    BoundingVolumeHierarchy() noexcept;
+    ~BoundingVolumeHierarchy() noexcept;
+
+    BoundingVolumeHierarchy(BoundingVolumeHierarchy const& rhs) = delete;
+    BoundingVolumeHierarchy& operator=(BoundingVolumeHierarchy const& rhs) = delete;
+
+    // (re)builds the hierarchy over `count` boxes, previous content is discarded
+    void build(math::float3 const* centers, math::float3 const* extents, size_t count);
+
+    void clear() noexcept;
+
+    size_t size() const noexcept { return mIndices.size(); }
+    bool empty() const noexcept { return mIndices.empty(); }
+
+    /*
+     * Sets `bit` of results[i] for each box intersecting the frustum defined by `planes`, where
+     * `i` is the box index given to build(). The planes must be in the space the hierarchy
+     * was built in.
+     *
+     * Results of boxes that don't intersect the frustum are NOT modified, they must be cleared
+     * by the caller beforehand.
+     */
+    void cull(result_type* results, math::float4 const planes[6], size_t bit) const noexcept;
+
+    static constexpr uint32_t NO_HIT = std::numeric_limits<uint32_t>::max();
+
+    struct RaycastResult {
+        uint32_t index;     // index of the box given to build(), or NO_HIT
+        float distance;     // distance along the ray to the box, 0 if the box contains the origin
+    };
+
+    /*
+     * Returns the box closest to the ray's origin, along the ray, that is hit within
+     * maxDistance. Distances are in units of `direction`.
+     */
+    RaycastResult raycast(math::float3 origin, math::float3 direction,
+            float maxDistance) const noexcept;
+
+private:
+    struct Node {
+        math::float3 center;
+        uint32_t first;         // first box of this subtree in mIndices
+        math::float3 halfExtent;
+        uint32_t count;         // number of boxes in this subtree, the node is a leaf if <= LEAF_SIZE
+        uint32_t skip;          // index of the node following this subtree
+    };
+
+    void buildRecursive(math::float3 const* centers, math::float3 const* extents,
+            uint32_t first, uint32_t count);
+
+    std::vector<Node> mNodes;
+    std::vector<uint32_t> mIndices;         // box indices, in leaf order
+    std::vector<math::float3> mCenters;     // box centers, in leaf order
+    std::vector<math::float3> mExtents;     // box half-extents, in leaf order
+};
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_BOUNDINGVOLUMEHIERARCHY_H
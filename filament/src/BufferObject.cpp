@@ -24,6 +24,7 @@ namespace filament {
 
 void BufferObject::setBuffer(Engine& engine,
         BufferDescriptor&& buffer, uint32_t const byteOffset) {
+    downcast(engine).markContentChanged();
     downcast(this)->setBuffer(downcast(engine), std::move(buffer), byteOffset);
 }
 
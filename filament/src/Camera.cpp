@@ -15,6 +15,7 @@
  */
 
 #include "details/Camera.h"
+#include "details/Engine.h"
 
 #include <math/mat4.h>
 
@@ -24,6 +25,7 @@ using namespace math;
 
 void Camera::setProjection(double const fovInDegrees, double const aspect, double const near, double const far,
         Fov const direction) {
+    downcast(this)->getEngine().markContentChanged();
     setCustomProjection(
             projection(direction, fovInDegrees, aspect, near),
             projection(direction, fovInDegrees, aspect, near, far),
@@ -32,6 +34,7 @@ void Camera::setProjection(double const fovInDegrees, double const aspect, doubl
 
 void Camera::setLensProjection(double const focalLengthInMillimeters,
         double const aspect, double const near, double const far) {
+    downcast(this)->getEngine().markContentChanged();
     setCustomProjection(
             projection(focalLengthInMillimeters, aspect, near),
             projection(focalLengthInMillimeters, aspect, near, far),
@@ -47,33 +50,40 @@ mat4 Camera::inverseProjection(const mat4& p) noexcept {
 }
 
 void Camera::setEyeModelMatrix(uint8_t const eyeId, mat4 const& model) {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setEyeModelMatrix(eyeId, model);
 }
 
 void Camera::setCustomEyeProjection(mat4 const* projection, size_t const count,
         mat4 const& projectionForCulling, double const near, double const far) {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setCustomEyeProjection(projection, count, projectionForCulling, near, far);
 }
 
 void Camera::setProjection(Projection const projection, double const left, double const right, double const bottom,
         double const top, double const near, double const far) {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setProjection(projection, left, right, bottom, top, near, far);
 }
 
 void Camera::setCustomProjection(mat4 const& projection, double const near, double const far) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setCustomProjection(projection, near, far);
 }
 
 void Camera::setCustomProjection(mat4 const& projection, mat4 const& projectionForCulling,
         double const near, double const far) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setCustomProjection(projection, projectionForCulling, near, far);
 }
 
 void Camera::setScaling(double2 const scaling) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setScaling(scaling);
 }
 
 void Camera::setShift(double2 const shift) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setShift(shift);
 }
 
@@ -102,14 +112,17 @@ double Camera::getCullingFar() const noexcept {
 }
 
 void Camera::setModelMatrix(const mat4& modelMatrix) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setModelMatrix(modelMatrix);
 }
 
 void Camera::setModelMatrix(const mat4f& modelMatrix) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setModelMatrix(modelMatrix);
 }
 
 void Camera::lookAt(double3 const& eye, double3 const& center, double3 const& up) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->lookAt(eye, center, up);
 }
 
@@ -150,6 +163,7 @@ utils::Entity Camera::getEntity() const noexcept {
 }
 
 void Camera::setExposure(float const aperture, float const shutterSpeed, float const ISO) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setExposure(aperture, shutterSpeed, ISO);
 }
 
@@ -166,6 +180,7 @@ float Camera::getSensitivity() const noexcept {
 }
 
 void Camera::setFocusDistance(float const distance) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setFocusDistance(distance);
 }
 
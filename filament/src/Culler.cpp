@@ -20,18 +20,298 @@
 
 #include <math/fast.h>
 
+#include <algorithm>
+
+#include <stdint.h>
+
+// SSE2 is part of the x86-64 baseline and NEON is mandatory on all the ARM ABIs we support,
+// so the SIMD kernels below are selected at compile time and no runtime dispatch is needed.
+#if defined(__ARM_NEON)
+#   include <arm_neon.h>
+#   define FILAMENT_CULLER_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define FILAMENT_CULLER_SSE2 1
+#endif
+
 using namespace filament::math;
 
 // use 8 if Culler::result_type is 8-bits, on ARMv8 it allows the compiler to write eight
 // results in one go.
 #define FILAMENT_CULLER_VECTORIZE_HINT 4
 
+// number of elements processed by one iteration of the SIMD kernels
+#define FILAMENT_CULLER_SIMD_WIDTH 4
+
 namespace filament {
 
 static_assert(Culler::MODULO % FILAMENT_CULLER_VECTORIZE_HINT == 0,
         "MODULO m=must be a multiple of FILAMENT_CULLER_VECTORIZE_HINT");
 
+static_assert(Culler::MODULO % FILAMENT_CULLER_SIMD_WIDTH == 0,
+        "MODULO m=must be a multiple of FILAMENT_CULLER_SIMD_WIDTH");
+
+static_assert(sizeof(float3) == 3 * sizeof(float) && sizeof(float4) == 4 * sizeof(float),
+        "SIMD kernels assume tightly packed float3 and float4");
+
+namespace {
+
+// Sets bit 'bit' of results[i..i+3] from the 4 lowest bits of 'mask', leaving other bits intact.
+UTILS_ALWAYS_INLINE
+inline void storeResults(Culler::result_type* UTILS_RESTRICT results,
+        uint32_t const mask, size_t const bit) noexcept {
+    for (size_t k = 0; k < FILAMENT_CULLER_SIMD_WIDTH; k++) {
+        auto r = results[k];
+        r &= ~Culler::result_type(1u << bit);
+        r |= Culler::result_type(((mask >> k) & 1u) << bit);
+        results[k] = r;
+    }
+}
+
+#if defined(FILAMENT_CULLER_SSE2)
+
+// Converts 4 packed float3 (12 floats) into x, y and z vectors
+UTILS_ALWAYS_INLINE
+inline void loadTransposed(float3 const* UTILS_RESTRICT p,
+        __m128& x, __m128& y, __m128& z) noexcept {
+    float const* const f = &p->x;
+    __m128 const a = _mm_loadu_ps(f + 0);  // x0 y0 z0 x1
+    __m128 const b = _mm_loadu_ps(f + 4);  // y1 z1 x2 y2
+    __m128 const c = _mm_loadu_ps(f + 8);  // z2 x3 y3 z3
+    x = _mm_shuffle_ps(
+            _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 0, 0)),
+            _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+    y = _mm_shuffle_ps(
+            _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+            _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+    z = _mm_shuffle_ps(
+            _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)),
+            _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+// Tests 4 AABBs against the 6 planes of a frustum, the sign bit of each lane is the result
+UTILS_ALWAYS_INLINE
+inline __m128 intersectsBoxes(float4 const* UTILS_RESTRICT planes,
+        __m128 const cx, __m128 const cy, __m128 const cz,
+        __m128 const ex, __m128 const ey, __m128 const ez) noexcept {
+    // the result is the AND of the sign bits of each plane distance
+    __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (size_t j = 0; j < 6; j++) {
+        __m128 const px = _mm_set1_ps(planes[j].x);
+        __m128 const py = _mm_set1_ps(planes[j].y);
+        __m128 const pz = _mm_set1_ps(planes[j].z);
+        __m128 const pw = _mm_set1_ps(planes[j].w);
+        __m128 const ax = _mm_set1_ps(std::abs(planes[j].x));
+        __m128 const ay = _mm_set1_ps(std::abs(planes[j].y));
+        __m128 const az = _mm_set1_ps(std::abs(planes[j].z));
+        __m128 const d = _mm_sub_ps(
+                _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, cx), _mm_mul_ps(py, cy)),
+                        _mm_add_ps(_mm_mul_ps(pz, cz), pw)),
+                _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, ex), _mm_mul_ps(ay, ey)),
+                        _mm_mul_ps(az, ez)));
+        visible = _mm_and_ps(visible, d);
+    }
+    return visible;
+}
+
+void intersectsSimd(
+        Culler::result_type* UTILS_RESTRICT results,
+        float4 const* UTILS_RESTRICT planes,
+        float3 const* UTILS_RESTRICT center,
+        float3 const* UTILS_RESTRICT extent,
+        size_t const count, size_t const bit) noexcept {
+    for (size_t i = 0; i < count; i += FILAMENT_CULLER_SIMD_WIDTH) {
+        __m128 cx, cy, cz, ex, ey, ez;
+        loadTransposed(center + i, cx, cy, cz);
+        loadTransposed(extent + i, ex, ey, ez);
+        __m128 const visible = intersectsBoxes(planes, cx, cy, cz, ex, ey, ez);
+        storeResults(results + i, uint32_t(_mm_movemask_ps(visible)), bit);
+    }
+}
+
+void intersectsCubeFacesSimd(
+        Culler::result_type* UTILS_RESTRICT results,
+        float4 const* UTILS_RESTRICT planes,
+        float3 const* UTILS_RESTRICT center,
+        float3 const* UTILS_RESTRICT extent,
+        size_t const count) noexcept {
+    for (size_t i = 0; i < count; i += FILAMENT_CULLER_SIMD_WIDTH) {
+        __m128 cx, cy, cz, ex, ey, ez;
+        loadTransposed(center + i, cx, cy, cz);
+        loadTransposed(extent + i, ex, ey, ez);
+        // the boxes are loaded once and tested against all the faces
+        __m128i faces = _mm_setzero_si128();
+        for (size_t f = 0; f < Culler::CUBE_FACE_COUNT; f++) {
+            __m128 const visible = intersectsBoxes(planes + f * 6, cx, cy, cz, ex, ey, ez);
+            faces = _mm_or_si128(faces, _mm_and_si128(
+                    _mm_srai_epi32(_mm_castps_si128(visible), 31), _mm_set1_epi32(1 << f)));
+        }
+        alignas(16) uint32_t r[FILAMENT_CULLER_SIMD_WIDTH];
+        _mm_store_si128(reinterpret_cast<__m128i*>(r), faces);
+        for (size_t k = 0; k < FILAMENT_CULLER_SIMD_WIDTH; k++) {
+            results[i + k] = Culler::result_type(r[k]);
+        }
+    }
+}
+
+void intersectsSimd(
+        Culler::result_type* UTILS_RESTRICT results,
+        float4 const* UTILS_RESTRICT planes,
+        float4 const* UTILS_RESTRICT b,
+        size_t const count) noexcept {
+    for (size_t i = 0; i < count; i += FILAMENT_CULLER_SIMD_WIDTH) {
+        __m128 x = _mm_loadu_ps(&b[i + 0].x);
+        __m128 y = _mm_loadu_ps(&b[i + 1].x);
+        __m128 z = _mm_loadu_ps(&b[i + 2].x);
+        __m128 r = _mm_loadu_ps(&b[i + 3].x);
+        _MM_TRANSPOSE4_PS(x, y, z, r);
+        __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (size_t j = 0; j < 6; j++) {
+            __m128 const d = _mm_sub_ps(
+                    _mm_add_ps(
+                            _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes[j].x), x),
+                                    _mm_mul_ps(_mm_set1_ps(planes[j].y), y)),
+                            _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes[j].z), z),
+                                    _mm_set1_ps(planes[j].w))), r);
+            visible = _mm_and_ps(visible, d);
+        }
+        storeResults(results + i, uint32_t(_mm_movemask_ps(visible)), 0);
+    }
+}
+
+#elif defined(FILAMENT_CULLER_NEON)
+
+UTILS_ALWAYS_INLINE
+inline uint32_t movemask(uint32x4_t const v) noexcept {
+    uint32x4_t const s = vshrq_n_u32(v, 31);
+    return  (vgetq_lane_u32(s, 0) << 0) | (vgetq_lane_u32(s, 1) << 1) |
+            (vgetq_lane_u32(s, 2) << 2) | (vgetq_lane_u32(s, 3) << 3);
+}
+
+// Tests 4 AABBs against the 6 planes of a frustum, the sign bit of each lane is the result
+UTILS_ALWAYS_INLINE
+inline uint32x4_t intersectsBoxes(float4 const* UTILS_RESTRICT planes,
+        float32x4x3_t const& c, float32x4x3_t const& e) noexcept {
+    // the result is the AND of the sign bits of each plane distance
+    uint32x4_t visible = vdupq_n_u32(~0u);
+    for (size_t j = 0; j < 6; j++) {
+        float32x4_t d = vdupq_n_f32(planes[j].w);
+        d = vmlaq_n_f32(d, c.val[0], planes[j].x);
+        d = vmlaq_n_f32(d, c.val[1], planes[j].y);
+        d = vmlaq_n_f32(d, c.val[2], planes[j].z);
+        d = vmlsq_n_f32(d, e.val[0], std::abs(planes[j].x));
+        d = vmlsq_n_f32(d, e.val[1], std::abs(planes[j].y));
+        d = vmlsq_n_f32(d, e.val[2], std::abs(planes[j].z));
+        visible = vandq_u32(visible, vreinterpretq_u32_f32(d));
+    }
+    return visible;
+}
+
+void intersectsSimd(
+        Culler::result_type* UTILS_RESTRICT results,
+        float4 const* UTILS_RESTRICT planes,
+        float3 const* UTILS_RESTRICT center,
+        float3 const* UTILS_RESTRICT extent,
+        size_t const count, size_t const bit) noexcept {
+    for (size_t i = 0; i < count; i += FILAMENT_CULLER_SIMD_WIDTH) {
+        // vld3q de-interleaves 4 float3 into x, y and z vectors
+        float32x4x3_t const c = vld3q_f32(&center[i].x);
+        float32x4x3_t const e = vld3q_f32(&extent[i].x);
+        storeResults(results + i, movemask(intersectsBoxes(planes, c, e)), bit);
+    }
+}
+
+void intersectsCubeFacesSimd(
+        Culler::result_type* UTILS_RESTRICT results,
+        float4 const* UTILS_RESTRICT planes,
+        float3 const* UTILS_RESTRICT center,
+        float3 const* UTILS_RESTRICT extent,
+        size_t const count) noexcept {
+    for (size_t i = 0; i < count; i += FILAMENT_CULLER_SIMD_WIDTH) {
+        float32x4x3_t const c = vld3q_f32(&center[i].x);
+        float32x4x3_t const e = vld3q_f32(&extent[i].x);
+        // the boxes are loaded once and tested against all the faces
+        uint32x4_t faces = vdupq_n_u32(0);
+        for (size_t f = 0; f < Culler::CUBE_FACE_COUNT; f++) {
+            uint32x4_t const visible = intersectsBoxes(planes + f * 6, c, e);
+            int32x4_t const m = vshrq_n_s32(vreinterpretq_s32_u32(visible), 31);
+            faces = vorrq_u32(faces, vandq_u32(vreinterpretq_u32_s32(m), vdupq_n_u32(1u << f)));
+        }
+        uint32_t r[FILAMENT_CULLER_SIMD_WIDTH];
+        vst1q_u32(r, faces);
+        for (size_t k = 0; k < FILAMENT_CULLER_SIMD_WIDTH; k++) {
+            results[i + k] = Culler::result_type(r[k]);
+        }
+    }
+}
+
+void intersectsSimd(
+        Culler::result_type* UTILS_RESTRICT results,
+        float4 const* UTILS_RESTRICT planes,
+        float4 const* UTILS_RESTRICT b,
+        size_t const count) noexcept {
+    for (size_t i = 0; i < count; i += FILAMENT_CULLER_SIMD_WIDTH) {
+        // vld4q de-interleaves 4 float4 into x, y, z and radius vectors
+        float32x4x4_t const s = vld4q_f32(&b[i].x);
+        uint32x4_t visible = vdupq_n_u32(~0u);
+        for (size_t j = 0; j < 6; j++) {
+            float32x4_t d = vsubq_f32(vdupq_n_f32(planes[j].w), s.val[3]);
+            d = vmlaq_n_f32(d, s.val[0], planes[j].x);
+            d = vmlaq_n_f32(d, s.val[1], planes[j].y);
+            d = vmlaq_n_f32(d, s.val[2], planes[j].z);
+            visible = vandq_u32(visible, vreinterpretq_u32_f32(d));
+        }
+        storeResults(results + i, movemask(visible), 0);
+    }
+}
+
+#endif
+
+} // anonymous namespace
+
+void Culler::intersects(
+        result_type* UTILS_RESTRICT results,
+        Frustum const& UTILS_RESTRICT frustum,
+        float4 const* UTILS_RESTRICT b,
+        size_t count) noexcept {
+#if defined(FILAMENT_CULLER_SSE2) || defined(FILAMENT_CULLER_NEON)
+    intersectsSimd(results, frustum.mPlanes, b, round(count));
+#else
+    intersectsScalar(results, frustum, b, count);
+#endif
+}
+
 void Culler::intersects(
+        result_type* UTILS_RESTRICT results,
+        Frustum const& UTILS_RESTRICT frustum,
+        float3 const* UTILS_RESTRICT center,
+        float3 const* UTILS_RESTRICT extent,
+        size_t count, size_t const bit) noexcept {
+#if defined(FILAMENT_CULLER_SSE2) || defined(FILAMENT_CULLER_NEON)
+    intersectsSimd(results, frustum.mPlanes, center, extent, round(count), bit);
+#else
+    intersectsScalar(results, frustum, center, extent, count, bit);
+#endif
+}
+
+void Culler::intersectsCubeFaces(
+        result_type* UTILS_RESTRICT results,
+        CubeFrustums const& UTILS_RESTRICT frustums,
+        float3 const* UTILS_RESTRICT center,
+        float3 const* UTILS_RESTRICT extent,
+        size_t count) noexcept {
+#if defined(FILAMENT_CULLER_SSE2) || defined(FILAMENT_CULLER_NEON)
+    float4 planes[CUBE_FACE_COUNT * 6];
+    for (size_t f = 0; f < CUBE_FACE_COUNT; f++) {
+        std::copy_n(frustums[f].mPlanes, 6, planes + f * 6);
+    }
+    intersectsCubeFacesSimd(results, planes, center, extent, round(count));
+#else
+    intersectsCubeFacesScalar(results, frustums, center, extent, count);
+#endif
+}
+
+void Culler::intersectsScalar(
         result_type* UTILS_RESTRICT results,
         Frustum const& UTILS_RESTRICT frustum,
         float4 const* UTILS_RESTRICT b,
@@ -63,7 +343,7 @@ void Culler::intersects(
     }
 }
 
-void Culler::intersects(
+void Culler::intersectsScalar(
         result_type* UTILS_RESTRICT results,
         Frustum const& UTILS_RESTRICT frustum,
         float3 const* UTILS_RESTRICT center,
@@ -101,6 +381,33 @@ void Culler::intersects(
     }
 }
 
+void Culler::intersectsCubeFacesScalar(
+        result_type* UTILS_RESTRICT results,
+        CubeFrustums const& UTILS_RESTRICT frustums,
+        float3 const* UTILS_RESTRICT center,
+        float3 const* UTILS_RESTRICT extent,
+        size_t count) noexcept {
+
+    count = round(count);
+    for (size_t i = 0; i < count; i++) {
+        result_type faces = 0;
+        for (size_t f = 0; f < CUBE_FACE_COUNT; f++) {
+            float4 const* UTILS_RESTRICT const planes = frustums[f].mPlanes;
+            int visible = ~0;
+            for (size_t j = 0; j < 6; j++) {
+                const float dot =
+                        planes[j].x * center[i].x - std::abs(planes[j].x) * extent[i].x +
+                        planes[j].y * center[i].y - std::abs(planes[j].y) * extent[i].y +
+                        planes[j].z * center[i].z - std::abs(planes[j].z) * extent[i].z +
+                        planes[j].w;
+                visible &= fast::signbit(dot);
+            }
+            faces |= result_type((visible ? 1u : 0u) << f);
+        }
+        results[i] = faces;
+    }
+}
+
 /*
  * returns whether a box intersects with the frustum
  */
@@ -130,6 +437,24 @@ bool Culler::intersects(Frustum const& frustum, float4 const& sphere) noexcept {
 
 // For testing...
 
+void Culler::Test::intersectsCubeFaces(
+        result_type* UTILS_RESTRICT results,
+        CubeFrustums const& UTILS_RESTRICT frustums,
+        float3 const* UTILS_RESTRICT c,
+        float3 const* UTILS_RESTRICT e,
+        size_t const count) noexcept {
+    Culler::intersectsCubeFaces(results, frustums, c, e, count);
+}
+
+void Culler::Test::intersectsCubeFacesScalar(
+        result_type* UTILS_RESTRICT results,
+        CubeFrustums const& UTILS_RESTRICT frustums,
+        float3 const* UTILS_RESTRICT c,
+        float3 const* UTILS_RESTRICT e,
+        size_t const count) noexcept {
+    Culler::intersectsCubeFacesScalar(results, frustums, c, e, count);
+}
+
 void Culler::Test::intersects(
         result_type* UTILS_RESTRICT results,
         Frustum const& UTILS_RESTRICT frustum,
@@ -146,4 +471,20 @@ void Culler::Test::intersects(
     Culler::intersects(results, frustum, b, count);
 }
 
+void Culler::Test::intersectsScalar(
+        result_type* UTILS_RESTRICT results,
+        Frustum const& UTILS_RESTRICT frustum,
+        float3 const* UTILS_RESTRICT c,
+        float3 const* UTILS_RESTRICT e,
+        size_t const count) noexcept {
+    Culler::intersectsScalar(results, frustum, c, e, count, 0);
+}
+
+void Culler::Test::intersectsScalar(
+        result_type* UTILS_RESTRICT results,
+        Frustum const& UTILS_RESTRICT frustum,
+        float4 const* UTILS_RESTRICT b, size_t const count) noexcept {
+    Culler::intersectsScalar(results, frustum, b, count);
+}
+
 } // namespace filament
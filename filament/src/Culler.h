@@ -25,6 +25,10 @@
 #include <math/vec4.h>
 #include <math/vec2.h>
 
+#include <array>
+
+#include <stddef.h>
+
 namespace filament {
 
 /*
@@ -44,6 +48,10 @@ public:
 
     using result_type = uint8_t;
 
+    // number of frustums processed by intersectsCubeFaces()
+    static constexpr size_t CUBE_FACE_COUNT = 6;
+    using CubeFrustums = std::array<Frustum, CUBE_FACE_COUNT>;
+
     /*
      * returns whether each AABB in an array intersects with the frustum
      */
@@ -62,6 +70,17 @@ public:
             math::float4 const* b,
             size_t count) noexcept;
 
+    /*
+     * Classifies each AABB in an array against the 6 frustums of a cubemap (e.g. the faces of a
+     * point-light shadow map), bit i of the result is set if the AABB intersects frustums[i].
+     * This is the same as calling intersects() for each face, with a single pass over the AABBs.
+     */
+    static void intersectsCubeFaces(result_type* results,
+            CubeFrustums const& frustums,
+            math::float3 const* center,
+            math::float3 const* extent,
+            size_t count) noexcept;
+
     /*
      * returns whether an AABB intersects with the frustum
      */
@@ -88,7 +107,53 @@ public:
                 Frustum const& frustum,
                 math::float4 const* b,
                 size_t count) noexcept;
+
+        static void intersectsCubeFaces(result_type* results,
+                CubeFrustums const& frustums,
+                math::float3 const* c,
+                math::float3 const* e,
+                size_t count) noexcept;
+
+        // reference implementations, not using the SIMD kernels
+        static void intersectsScalar(result_type* results,
+                Frustum const& frustum,
+                math::float3 const* c,
+                math::float3 const* e,
+                size_t count) noexcept;
+
+        static void intersectsScalar(result_type* results,
+                Frustum const& frustum,
+                math::float4 const* b,
+                size_t count) noexcept;
+
+        static void intersectsCubeFacesScalar(result_type* results,
+                CubeFrustums const& frustums,
+                math::float3 const* c,
+                math::float3 const* e,
+                size_t count) noexcept;
     };
+
+private:
+    // portable implementations, which rely on the compiler to auto-vectorize them. These are used
+    // when no hand-written SIMD kernel is available for the target architecture.
+    static void intersectsScalar(result_type* results,
+            Frustum const& frustum,
+            math::float3 const* center,
+            math::float3 const* extent,
+            size_t count, size_t bit) noexcept;
+
+    static void intersectsScalar(
+            result_type* results,
+            Frustum const& frustum,
+            math::float4 const* b,
+            size_t count) noexcept;
+
+    static void intersectsCubeFacesScalar(
+            result_type* results,
+            CubeFrustums const& frustums,
+            math::float3 const* center,
+            math::float3 const* extent,
+            size_t count) noexcept;
 };
 
 } // namespace filament
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_DEPTHPREPASSCONTROLLER_H
+#define TNT_FILAMENT_DEPTHPREPASSCONTROLLER_H
+
+#include <array>
+
+#include <stdint.h>
+
+namespace filament {
+
+/*
+ * Decides whether a view's color pass should start with a depth prepass, from the measured GPU
+ * frame times.
+ *
+ * Whether the prepass pays off depends on the GPU (tile-based GPUs already reject hidden
+ * fragments), the overdraw and the cost of the materials, so it's simply measured: the view
+ * keeps rendering with the fastest choice, and regularly renders a few frames with the other
+ * one to keep both estimates current.
+ *
+ * Frame times are only known a few frames later, so each frame's choice is remembered until
+ * its timing arrives.
+ */
+class DepthPrepassController {
+public:
+    // frames rendered with the current choice, before measuring the other one again
+    static constexpr uint32_t PROBE_INTERVAL = 240;
+
+    // frames rendered with the other choice when measuring it
+    static constexpr uint32_t PROBE_LENGTH = 16;
+
+    // the other choice must be this much faster to be adopted
+    static constexpr float HYSTERESIS = 0.03f;
+
+    void reset() noexcept {
+        *this = {};
+    }
+
+    // Adds the GPU time of frame `measuredFrameId` (in ms), if it was rendered by this
+    // controller. Invalid or already seen timings are ignored.
+    void addMeasurement(uint32_t const measuredFrameId, float const time) noexcept {
+        Entry const& entry = mHistory[measuredFrameId % mHistory.size()];
+        if (entry.frameId != measuredFrameId || measuredFrameId == mLastMeasuredFrameId ||
+                !(time > 0.0f)) {
+            return;
+        }
+        mLastMeasuredFrameId = measuredFrameId;
+        Estimate& estimate = mEstimates[entry.prepass];
+        estimate.time = estimate.count ? estimate.time + ALPHA * (time - estimate.time) : time;
+        estimate.count++;
+    }
+
+    // returns whether frame `frameId` is rendered with a depth prepass
+    bool update(uint32_t const frameId) noexcept {
+        bool prepass = mBest;
+        if (mProbeFramesLeft) {
+            prepass = !mBest;
+            if (--mProbeFramesLeft == 0) {
+                mFramesSinceProbe = 0;
+                mDecisionPending = true;
+            }
+        } else if (mDecisionPending) {
+            // wait until the timings of the last probed frame have arrived, or are lost
+            if (mLastMeasuredFrameId >= mLastProbedFrameId ||
+                    frameId >= mLastProbedFrameId + LATENCY) {
+                mDecisionPending = false;
+                decide();
+                prepass = mBest;
+            }
+        } else if (++mFramesSinceProbe >= PROBE_INTERVAL) {
+            prepass = !mBest;
+            mProbeFramesLeft = PROBE_LENGTH - 1;
+            mEstimates[prepass].count = 0;
+        }
+
+        if (prepass != mBest) {
+            mLastProbedFrameId = frameId;
+        }
+        mHistory[frameId % mHistory.size()] = { frameId, prepass };
+        return prepass;
+    }
+
+    // the choice the controller has settled on
+    bool isPrepassPreferred() const noexcept {
+        return mBest;
+    }
+
+private:
+    // weight of a new measurement in the running estimates
+    static constexpr float ALPHA = 0.25f;
+
+    // maximum delay, in frames, before a frame's timing is considered lost
+    static constexpr uint32_t LATENCY = 8;
+
+    struct Entry {
+        uint32_t frameId = 0;
+        bool prepass = false;
+    };
+
+    struct Estimate {
+        float time = 0.0f;          // running average of the GPU frame time in ms
+        uint32_t count = 0;         // number of measurements since the last probe
+    };
+
+    void decide() noexcept {
+        Estimate const& current = mEstimates[mBest];
+        Estimate const& other = mEstimates[!mBest];
+        if (current.count && other.count && other.time < current.time * (1.0f - HYSTERESIS)) {
+            mBest = !mBest;
+        }
+    }
+
+    std::array<Entry, 16> mHistory{};
+    std::array<Estimate, 2> mEstimates{};   // indexed by `prepass`
+    uint32_t mLastMeasuredFrameId = 0;
+    uint32_t mLastProbedFrameId = 0;
+    // start measuring the prepass shortly after starting up
+    uint32_t mFramesSinceProbe = PROBE_INTERVAL - PROBE_LENGTH;
+    uint32_t mProbeFramesLeft = 0;
+    bool mDecisionPending = false;
+    bool mBest = false;
+};
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_DEPTHPREPASSCONTROLLER_H
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "details/EditJournal.h"
+
+#include <filament/EditJournal.h>
+
+#include <utils/Entity.h>
+
+#include <math/mat4.h>
+#include <math/vec3.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace filament {
+
+using namespace math;
+using namespace utils;
+
+using RenderableEditType = FEditJournal::RenderableEditType;
+using LightEditType = FEditJournal::LightEditType;
+
+void EditJournal::setTransform(Entity const entity, const mat4f& localTransform) noexcept {
+    downcast(this)->setTransform(entity, localTransform);
+}
+
+void EditJournal::setTransforms(Entity const* entities, mat4f const* localTransforms,
+        size_t const count) noexcept {
+    downcast(this)->setTransforms(entities, localTransforms, count);
+}
+
+void EditJournal::setAxisAlignedBoundingBox(Entity const entity, const Box& aabb) noexcept {
+    downcast(this)->setAxisAlignedBoundingBox(entity, aabb);
+}
+
+void EditJournal::setLayerMask(Entity const entity, uint8_t const select,
+        uint8_t const values) noexcept {
+    downcast(this)->editRenderable(entity, RenderableEditType::LAYER_MASK, select, values);
+}
+
+void EditJournal::setPriority(Entity const entity, uint8_t const priority) noexcept {
+    downcast(this)->editRenderable(entity, RenderableEditType::PRIORITY, priority);
+}
+
+void EditJournal::setCastShadows(Entity const entity, bool const enable) noexcept {
+    downcast(this)->editRenderable(entity, RenderableEditType::CAST_SHADOWS, enable);
+}
+
+void EditJournal::setReceiveShadows(Entity const entity, bool const enable) noexcept {
+    downcast(this)->editRenderable(entity, RenderableEditType::RECEIVE_SHADOWS, enable);
+}
+
+void EditJournal::setLightPosition(Entity const entity, const float3& position) noexcept {
+    downcast(this)->editLight(entity, LightEditType::POSITION, position);
+}
+
+void EditJournal::setLightDirection(Entity const entity, const float3& direction) noexcept {
+    downcast(this)->editLight(entity, LightEditType::DIRECTION, direction);
+}
+
+void EditJournal::setLightColor(Entity const entity, const LinearColor& color) noexcept {
+    downcast(this)->editLight(entity, LightEditType::COLOR, color);
+}
+
+void EditJournal::setLightIntensity(Entity const entity, float const intensity) noexcept {
+    downcast(this)->editLight(entity, LightEditType::INTENSITY, { intensity, 0, 0 });
+}
+
+void EditJournal::setLightIntensityCandela(Entity const entity, float const intensity) noexcept {
+    downcast(this)->editLight(entity, LightEditType::INTENSITY_CANDELA, { intensity, 0, 0 });
+}
+
+void EditJournal::setLightFalloff(Entity const entity, float const radius) noexcept {
+    downcast(this)->editLight(entity, LightEditType::FALLOFF, { radius, 0, 0 });
+}
+
+} // namespace filament
@@ -20,6 +20,7 @@
 
 #include "details/BufferObject.h"
 #include "details/Camera.h"
+#include "details/EditJournal.h"
 #include "details/Fence.h"
 #include "details/IndexBuffer.h"
 #include "details/IndirectLight.h"
@@ -31,6 +32,7 @@
 #include "details/Stream.h"
 #include "details/SwapChain.h"
 #include "details/Texture.h"
+#include "details/TextureAtlas.h"
 #include "details/VertexBuffer.h"
 #include "details/View.h"
 
@@ -62,7 +64,7 @@ void Engine::destroy(Engine* engine) {
     FEngine::destroy(downcast(engine));
 }
 
-#if UTILS_HAS_THREADING
+#if UTILS_HAS_DRIVER_THREAD
 Engine* Engine::getEngine(void* token) {
     return FEngine::getEngine(token);
 }
@@ -208,6 +210,10 @@ bool Engine::destroy(const InstanceBuffer* p) {
     return downcast(this)->destroy(downcast(p));
 }
 
+bool Engine::destroy(const TextureAtlas* p) {
+    return downcast(this)->destroy(downcast(p));
+}
+
 void Engine::destroy(Entity const e) {
     downcast(this)->destroy(e);
 }
@@ -272,6 +278,9 @@ bool Engine::isValid(const View* p) const {
 bool Engine::isValid(const InstanceBuffer* p) const {
     return downcast(this)->isValid(downcast(p));
 }
+bool Engine::isValid(const TextureAtlas* p) const {
+    return downcast(this)->isValid(downcast(p));
+}
 
 size_t Engine::getBufferObjectCount() const noexcept {
     return downcast(this)->getBufferObjectCount();
@@ -337,6 +346,10 @@ size_t Engine::getRenderTargetCount() const noexcept {
     return downcast(this)->getRenderTargetCount();
 }
 
+size_t Engine::getTextureAtlasCount() const noexcept {
+    return downcast(this)->getTextureAtlasCount();
+}
+
 
 void Engine::flushAndWait() {
     downcast(this)->flushAndWait();
@@ -346,6 +359,14 @@ bool Engine::flushAndWait(uint64_t timeout) {
     return downcast(this)->flushAndWait(timeout);
 }
 
+void Engine::purgeCaches() noexcept {
+    downcast(this)->purgeCaches();
+}
+
+Engine::MemoryBudget Engine::getMemoryBudget() const noexcept {
+    return downcast(this)->getMemoryBudget();
+}
+
 void Engine::flush() {
     downcast(this)->flush();
 }
@@ -366,6 +387,10 @@ TransformManager& Engine::getTransformManager() noexcept {
     return downcast(this)->getTransformManager();
 }
 
+EditJournal& Engine::getEditJournal() noexcept {
+    return downcast(this)->getEditJournal();
+}
+
 void Engine::enableAccurateTranslations() noexcept  {
     getTransformManager().setAccurateTranslationsEnabled(true);
 }
@@ -374,10 +399,14 @@ void* Engine::streamAlloc(size_t const size, size_t const alignment) noexcept {
     return downcast(this)->streamAlloc(size, alignment);
 }
 
+void* Engine::frameAlloc(size_t const size, size_t const alignment) noexcept {
+    return downcast(this)->frameAlloc(size, alignment);
+}
+
 // The external-facing execute does a flush, and is meant only for single-threaded environments.
 // It also discards the boolean return value, which would otherwise indicate a thread exit.
 void Engine::execute() {
-    FILAMENT_CHECK_PRECONDITION(!UTILS_HAS_THREADING)
+    FILAMENT_CHECK_PRECONDITION(!UTILS_HAS_DRIVER_THREAD)
             << "Execute is meant for single-threaded platforms.";
     downcast(this)->flush();
     downcast(this)->execute();
@@ -388,13 +417,13 @@ JobSystem& Engine::getJobSystem() noexcept {
 }
 
 bool Engine::isPaused() const noexcept {
-    FILAMENT_CHECK_PRECONDITION(UTILS_HAS_THREADING)
+    FILAMENT_CHECK_PRECONDITION(UTILS_HAS_DRIVER_THREAD)
             << "Pause is meant for multi-threaded platforms.";
     return downcast(this)->isPaused();
 }
 
 void Engine::setPaused(bool const paused) {
-    FILAMENT_CHECK_PRECONDITION(UTILS_HAS_THREADING)
+    FILAMENT_CHECK_PRECONDITION(UTILS_HAS_DRIVER_THREAD)
             << "Pause is meant for multi-threaded platforms.";
     downcast(this)->setPaused(paused);
 }
@@ -419,6 +448,14 @@ bool Engine::isAutomaticInstancingEnabled() const noexcept {
     return downcast(this)->isAutomaticInstancingEnabled();
 }
 
+void Engine::prewarmPostProcessing(PostProcessingEffect const effects) noexcept {
+    downcast(this)->getPostProcessManager().prewarm(effects);
+}
+
+Engine::StartupTimings Engine::getStartupTimings() const noexcept {
+    return downcast(this)->getStartupTimings();
+}
+
 FeatureLevel Engine::getSupportedFeatureLevel() const noexcept {
     return downcast(this)->getSupportedFeatureLevel();
 }
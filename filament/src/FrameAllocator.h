@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_FRAMEALLOCATOR_H
+#define TNT_FILAMENT_FRAMEALLOCATOR_H
+
+#include <utils/compiler.h>
+#include <utils/memalign.h>
+
+#include <array>
+#include <atomic>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace filament {
+
+/*
+ * A lock-free linear allocator whose allocations are all reclaimed at once, FRAME_COUNT frames
+ * after they're made. It's a ring of FRAME_COUNT fixed-size buffers: allocations only bump
+ * the head of the current one, and nextFrame() starts the oldest over.
+ *
+ * allocate() can be called from any thread, nextFrame() must be called from a single thread.
+ */
+class FrameAllocator {
+public:
+    // this matches the number of frames the command buffer queue can hold
+    static constexpr size_t FRAME_COUNT = 3;
+
+    explicit FrameAllocator(size_t const size) noexcept : mSize(size) {
+        for (auto& frame : mFrames) {
+            frame.buffer = size ? static_cast<char*>(utils::aligned_alloc(size, BUFFER_ALIGNMENT))
+                                : nullptr;
+        }
+    }
+
+    ~FrameAllocator() noexcept {
+        for (auto& frame : mFrames) {
+            utils::aligned_free(frame.buffer);
+        }
+    }
+
+    FrameAllocator(FrameAllocator const&) = delete;
+    FrameAllocator& operator=(FrameAllocator const&) = delete;
+
+    // returns nullptr if the current frame's buffer is exhausted
+    void* allocate(size_t const size, size_t const alignment) noexcept {
+        Frame& frame = mFrames[mCurrent.load(std::memory_order_acquire)];
+        if (UTILS_UNLIKELY(!frame.buffer || alignment > BUFFER_ALIGNMENT)) {
+            return nullptr;
+        }
+        // reserve enough for the worst case padding, so the head doesn't need to be re-read
+        size_t const reserved = size + alignment - 1;
+        size_t const offset = frame.head.fetch_add(reserved, std::memory_order_relaxed);
+        if (UTILS_UNLIKELY(offset + reserved > mSize)) {
+            return nullptr;
+        }
+        uintptr_t const p = uintptr_t(frame.buffer + offset);
+        return reinterpret_cast<void*>((p + alignment - 1) & ~uintptr_t(alignment - 1));
+    }
+
+    // reclaims the allocations made FRAME_COUNT frames ago
+    void nextFrame() noexcept {
+        size_t const next = (mCurrent.load(std::memory_order_relaxed) + 1) % FRAME_COUNT;
+        mFrames[next].head.store(0, std::memory_order_relaxed);
+        mCurrent.store(next, std::memory_order_release);
+    }
+
+private:
+    static constexpr size_t BUFFER_ALIGNMENT = 64;
+
+    struct Frame {
+        char* buffer = nullptr;
+        std::atomic<size_t> head = { 0 };
+    };
+
+    size_t const mSize;
+    std::array<Frame, FRAME_COUNT> mFrames;
+    std::atomic<size_t> mCurrent = { 0 };
+};
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_FRAMEALLOCATOR_H
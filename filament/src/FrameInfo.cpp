@@ -122,8 +122,10 @@ void FrameInfoManager::beginFrame(DriverApi& driver, Config const& config, uint3
     }
 }
 
-void FrameInfoManager::endFrame(DriverApi& driver) noexcept {
+void FrameInfoManager::endFrame(DriverApi& driver,
+        Renderer::FrameInfo::CpuTimings const& cpu) noexcept {
     auto& front = mFrameTimeHistory.front();
+    front.cpu = cpu;
     // close the timer query
     driver.endTimerQuery(mQueries[mIndex].handle);
     // queue custom backend command to query the current time
@@ -196,7 +198,8 @@ FixedCapacityVector<Renderer::FrameInfo> FrameInfoManager::getFrameInfoHistory(
                 duration_cast<nanoseconds>(entry.beginFrame.time_since_epoch()).count(),
                 duration_cast<nanoseconds>(entry.endFrame.time_since_epoch()).count(),
                 duration_cast<nanoseconds>(entry.backendBeginFrame.time_since_epoch()).count(),
-                duration_cast<nanoseconds>(entry.backendEndFrame.time_since_epoch()).count()
+                duration_cast<nanoseconds>(entry.backendEndFrame.time_since_epoch()).count(),
+                entry.cpu
         });
     }
     return result;
@@ -44,6 +44,7 @@ struct FrameInfo {
     using duration = std::chrono::duration<float, std::milli>;
     duration frameTime{};            // frame period
     duration denoisedFrameTime{};    // frame period (median filter)
+    uint32_t frameId = 0;            // frame these timings are for
     bool valid = false;              // true if the data of the structure is valid
 };
 } // namespace details
@@ -51,14 +52,14 @@ struct FrameInfo {
 struct FrameInfoImpl : public details::FrameInfo {
     using clock = std::chrono::steady_clock;
     using time_point = clock::time_point;
-    uint32_t const frameId;
     time_point beginFrame;           // main thread beginFrame time
     time_point endFrame;             // main thread endFrame time
     time_point backendBeginFrame;    // backend thread beginFrame time (makeCurrent time)
     time_point backendEndFrame;      // backend thread endFrame time (present time)
+    Renderer::FrameInfo::CpuTimings cpu{}; // main thread render() breakdown
     std::atomic_bool ready{};        // true once backend thread has populated its data
-    explicit FrameInfoImpl(uint32_t const frameId) noexcept
-        : frameId(frameId) {
+    explicit FrameInfoImpl(uint32_t const frameId) noexcept {
+        this->frameId = frameId;
     }
 };
 
@@ -161,7 +162,8 @@ public:
     void beginFrame(backend::DriverApi& driver, Config const& config, uint32_t frameId) noexcept;
 
     // call this immediately before "swap buffers"
-    void endFrame(backend::DriverApi& driver) noexcept;
+    void endFrame(backend::DriverApi& driver,
+            Renderer::FrameInfo::CpuTimings const& cpu) noexcept;
 
     details::FrameInfo getLastFrameInfo() const noexcept {
         // if pFront is not set yet, return FrameInfo(). But the `valid` field will be false in this case.
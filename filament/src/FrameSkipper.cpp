@@ -44,6 +44,12 @@ void FrameSkipper::terminate(DriverApi& driver) noexcept {
     }
 }
 
+void FrameSkipper::setLatency(DriverApi& driver, size_t const latency) noexcept {
+    terminate(driver);
+    mDelayedFences = {};
+    mLast = std::clamp(latency, size_t(1), MAX_FRAME_LATENCY) - 1;
+}
+
 bool FrameSkipper::beginFrame(DriverApi& driver) noexcept {
     auto& fences = mDelayedFences;
     if (fences.front()) {
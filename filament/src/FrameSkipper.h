@@ -64,6 +64,9 @@ public:
 
     void terminate(backend::DriverApi& driver) noexcept;
 
+    // Changes the latency, the frames in flight are forgotten.
+    void setLatency(backend::DriverApi& driver, size_t latency) noexcept;
+
     // Returns false if we need to skip this frame, because the GPU is running behind the CPU;
     // In that case, don't call render endFrame()
     // Returns true if rendering can proceed. Always call endFrame() when done.
@@ -74,7 +77,7 @@ public:
 private:
     using Container = std::array<backend::Handle<backend::HwFence>, MAX_FRAME_LATENCY>;
     mutable Container mDelayedFences{};
-    uint8_t const mLast;
+    uint8_t mLast;
 };
 
 } // namespace filament
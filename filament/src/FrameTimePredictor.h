@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_FRAMETIMEPREDICTOR_H
+#define TNT_FILAMENT_FRAMETIMEPREDICTOR_H
+
+#include <math/vec2.h>
+
+#include <algorithm>
+#include <limits>
+
+#include <stdint.h>
+
+namespace filament {
+
+/*
+ * Predicts the GPU frame time from the rendered area and the scene's workload.
+ *
+ * The frame time is modeled as: time = c0 * load + c1 * area
+ *   - load is the geometry workload (e.g. the number of renderables) relative to a reference
+ *   - area is the rendered area relative to the viewport (i.e. scale.x * scale.y)
+ *
+ * c0 and c1 are estimated with recursive least squares, older measurements are forgotten
+ * exponentially. The model starts with the assumption that the frame time is entirely
+ * proportional to the area, which is refined as the area and load vary.
+ */
+class FrameTimePredictor {
+public:
+    // number of measurements needed before predicting
+    static constexpr uint32_t MIN_SAMPLE_COUNT = 4;
+
+    // forgetting: weight of the previous measurements at each update, in (0, 1]
+    explicit FrameTimePredictor(float const forgetting = 0.95f) noexcept
+            : mForgetting(forgetting) {
+    }
+
+    void reset() noexcept {
+        mSampleCount = 0;
+    }
+
+    // adds the measured frame time of a frame rendered with the given load and area
+    void update(float const load, float const area, float const time) noexcept {
+        if (!(load >= 0.0f && area > 0.0f && time > 0.0f)) {
+            return;
+        }
+
+        if (mSampleCount++ == 0) {
+            mTheta = { 0.0f, time / area };
+            mP[0] = INITIAL_COVARIANCE;
+            mP[1] = 0.0f;
+            mP[2] = INITIAL_COVARIANCE;
+            return;
+        }
+
+        // P is symmetric, it's stored as { xx, xy, yy }
+        math::float2 const x{ load, area };
+        math::float2 const Px{ mP[0] * x[0] + mP[1] * x[1], mP[1] * x[0] + mP[2] * x[1] };
+        float const denominator = mForgetting + dot(x, Px);
+        math::float2 const K = Px / denominator;
+        float const error = time - dot(mTheta, x);
+
+        // the costs can't be negative
+        mTheta = max(mTheta + K * error, math::float2{ 0.0f });
+
+        float const invForgetting = 1.0f / mForgetting;
+        mP[0] = (mP[0] - K[0] * Px[0]) * invForgetting;
+        mP[1] = (mP[1] - K[0] * Px[1]) * invForgetting;
+        mP[2] = (mP[2] - K[1] * Px[1]) * invForgetting;
+
+        // The covariance grows without bounds in the directions the measurements don't vary in
+        // (e.g. when the area is constant), this keeps the model from over-reacting later.
+        float const trace = mP[0] + mP[2];
+        if (trace > MAX_COVARIANCE) {
+            float const s = MAX_COVARIANCE / trace;
+            mP[0] *= s;
+            mP[1] *= s;
+            mP[2] *= s;
+        }
+    }
+
+    bool isValid() const noexcept {
+        return mSampleCount >= MIN_SAMPLE_COUNT;
+    }
+
+    float predict(float const load, float const area) const noexcept {
+        return dot(mTheta, math::float2{ load, area });
+    }
+
+    // returns the area for which the predicted frame time is `time`, which could be larger
+    // than 1, infinity if the frame time doesn't depend on the area.
+    float solve(float const load, float const time) const noexcept {
+        if (mTheta[1] <= std::numeric_limits<float>::epsilon()) {
+            return std::numeric_limits<float>::infinity();
+        }
+        return std::max(0.0f, (time - mTheta[0] * load) / mTheta[1]);
+    }
+
+    math::float2 getCoefficients() const noexcept {
+        return mTheta;
+    }
+
+private:
+    static constexpr float INITIAL_COVARIANCE = 1.0f;
+    static constexpr float MAX_COVARIANCE = 100.0f;
+
+    float const mForgetting;
+    math::float2 mTheta{};
+    float mP[3] = {};
+    uint32_t mSampleCount = 0;
+};
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_FRAMETIMEPREDICTOR_H
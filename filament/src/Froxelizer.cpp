@@ -116,6 +116,22 @@ static bool fuzzyEqual(mat4f const& UTILS_RESTRICT l, mat4f const& UTILS_RESTRIC
     return result == 0;
 }
 
+// Returns a bounding sphere {center, radius} of the volume lit by a spot light, i.e. the
+// spherical sector of the light's radius and outer angle, which is much smaller than the
+// light's radius for narrow spots. See "Cull that cone!", Bartlomiej Wronski, 2017.
+static float4 computeSpotLightBoundingSphere(float3 const& position, float3 const& axis,
+        float const radius, float const cosSqr) noexcept {
+    float const cosAngle = std::sqrt(cosSqr);
+    if (cosSqr < 0.5f) {
+        // wider than 45 degrees: the sphere around the cone's base contains both the apex
+        // and the spherical cap
+        return { position + (radius * cosAngle) * axis, radius * std::sqrt(1.0f - cosSqr) };
+    }
+    // the sphere passing through the apex and the base's circle, which contains the cap
+    float const r = radius / (2.0f * cosAngle);
+    return { position + r * axis, r };
+}
+
 size_t Froxelizer::getFroxelBufferByteCount(FEngine::DriverApi& driverApi) noexcept {
     // Make sure that targetSize is 16-byte aligned so that it'll fit properly into an array of
     // uvec4.
@@ -531,12 +547,19 @@ std::pair<size_t, size_t> Froxelizer::clipToIndices(float2 const& clip) const no
 
 
 void Froxelizer::commit(DriverApi& driverApi) {
-    // send data to GPU
-    driverApi.updateBufferObject(mFroxelsBuffer,
-            { mFroxelBufferUser.data(), getFroxelBufferEntryCount() * sizeof(FroxelEntry) }, 0);
-
-    driverApi.updateBufferObject(mRecordsBuffer,
-            { mRecordBufferUser.data(), RECORD_BUFFER_ENTRY_COUNT }, 0);
+    // send data to GPU, unless it hasn't changed since the last time
+    if (mBuffersChanged) {
+        driverApi.updateBufferObject(mFroxelsBuffer,
+                { mFroxelBufferUser.data(), getFroxelBufferEntryCount() * sizeof(FroxelEntry) }, 0);
+
+        driverApi.updateBufferObject(mRecordsBuffer,
+                { mRecordBufferUser.data(), RECORD_BUFFER_ENTRY_COUNT }, 0);
+
+        mCommittedFroxels.assign(
+                mFroxelBufferUser.begin(), mFroxelBufferUser.begin() + mFroxelCount);
+        mCommittedRecords.assign(
+                mRecordBufferUser.begin(), mRecordBufferUser.begin() + mRecordBufferUsedCount);
+    }
 
 #ifndef NDEBUG
     mFroxelBufferUser.clear();
@@ -550,7 +573,10 @@ void Froxelizer::froxelizeLights(FEngine& engine,
         const FScene::LightSoa& UTILS_RESTRICT lightData) noexcept {
     // note: this is called asynchronously
     froxelizeLoop(engine, viewMatrix, lightData);
-    froxelizeAssignRecordsCompress();
+    froxelizeAssignRecordsCompress(engine.getJobSystem());
+
+    // this is done here rather than in commit(), because this is called asynchronously
+    mBuffersChanged = haveBuffersChanged();
 
 #ifndef NDEBUG
     if (lightData.size()) {
@@ -645,46 +671,45 @@ void Froxelizer::froxelizeLoop(FEngine& engine,
     }
 }
 
-void Froxelizer::froxelizeAssignRecordsCompress() noexcept {
+void Froxelizer::froxelizeAssignRecordsCompress(JobSystem& js) noexcept {
 
     SYSTRACE_CALL();
 
-    Slice<FroxelThreadData> const froxelThreadData = mFroxelShardedData;
+    // Froxels are compressed one z-slice per job, in two passes. The first pass converts the
+    // froxel data of each slice and counts how many record entries it needs. A prefix sum of
+    // these counts gives each slice its offset in the record buffer, and the second pass
+    // writes the records and froxels. Records can only be reused within a slice.
 
-    // convert froxel data from N groups of M bits to LightRecord::bitset, so we can
-    // easily compare adjacent froxels, for compaction. The conversion loops below get
-    // inlined and vectorized in release builds.
+    size_t const sliceCount = mFroxelCountZ;
+    size_t const sliceSize = size_t(mFroxelCountX) * mFroxelCountY;
+    assert_invariant(sliceCount <= FROXEL_SLICE_COUNT);
 
-    // this gets very well vectorized...
+    LightRecord::bitset sliceLights[FROXEL_SLICE_COUNT];
+    uint32_t sliceOffsets[FROXEL_SLICE_COUNT];
 
-    Slice<LightRecord> records(mLightRecords);
-    for (size_t j = 0, jc = getFroxelBufferEntryCount(); j < jc; j++) {
-        for (size_t i = 0; i < LightRecord::bitset::WORLD_COUNT; i++) {
-            using container_type = LightRecord::bitset::container_type;
-            constexpr size_t r = sizeof(container_type) / sizeof(LightGroupType);
-            container_type b = froxelThreadData[i * r][j];
-            for (size_t k = 0; k < r; k++) {
-                b |= (container_type(froxelThreadData[i * r + k][j]) << (LIGHT_PER_GROUP * k));
-            }
-            records[j].lights.getBitsAt(i) = b;
-        }
+    auto count = [this, &sliceLights, &sliceOffsets, sliceSize](size_t const slice) {
+        SYSTRACE_NAME("FroxelizeCount Job");
+        size_t const begin = slice * sliceSize;
+        sliceLights[slice] = convertLightRecords(begin, begin + sliceSize);
+        sliceOffsets[slice] = compressLightRecords<false>(begin, begin + sliceSize, 0, 0);
+    };
+
+    auto* parent = js.createJob();
+    for (size_t i = 0; i < sliceCount; i++) {
+        js.run(jobs::createJob(js, parent, std::cref(count), i));
     }
+    js.runAndWait(parent);
 
     LightRecord::bitset allLights{};
-    for (size_t j = 0, jc = getFroxelBufferEntryCount(); j < jc; j++) {
-        allLights |= records[j].lights;
+    for (size_t i = 0; i < sliceCount; i++) {
+        allLights |= sliceLights[i];
     }
 
-    uint16_t offset = 0;
-    FroxelEntry* const UTILS_RESTRICT froxels = mFroxelBufferUser.data();
-
-    const size_t froxelCountX = mFroxelCountX;
     RecordBufferType* const UTILS_RESTRICT froxelRecords = mRecordBufferUser.data();
 
     // initialize the first record with all lights in the scene -- this will be used only if
     // we run out of record space.
     const uint8_t allLightsCount = (uint8_t)std::min(size_t(255), allLights.count());
-    offset += allLightsCount;
     allLights.forEachSetBit([point = froxelRecords, froxelRecords](size_t l) mutable {
         // make sure to keep this code branch-less
         const size_t word = l / LIGHT_PER_GROUP;
@@ -696,73 +721,151 @@ void Froxelizer::froxelizeAssignRecordsCompress() noexcept {
         point += (point - froxelRecords < 255) ? 1 : 0;
     });
 
-    // how many froxel record entries were reused (for debugging)
-    UTILS_UNUSED size_t reused = 0;
+    // exclusive prefix sum of the record counts, this can go past the end of the record buffer,
+    // in which case the corresponding froxels will use the first record.
+    uint32_t offset = allLightsCount;
+    for (size_t i = 0; i < sliceCount; i++) {
+        uint32_t const sliceRecordCount = sliceOffsets[i];
+        sliceOffsets[i] = offset;
+        offset += sliceRecordCount;
+    }
+
+    auto compress = [this, &sliceOffsets, sliceSize, allLightsCount](size_t const slice) {
+        SYSTRACE_NAME("FroxelizeCompress Job");
+        size_t const begin = slice * sliceSize;
+        compressLightRecords<true>(begin, begin + sliceSize, sliceOffsets[slice], allLightsCount);
+    };
+
+    parent = js.createJob();
+    for (size_t i = 0; i < sliceCount; i++) {
+        js.run(jobs::createJob(js, parent, std::cref(compress), i));
+    }
+    js.runAndWait(parent);
+
+    mRecordBufferUsedCount = std::min(offset, uint32_t(RECORD_BUFFER_ENTRY_COUNT));
+
+    // FIXME: on big-endian systems we need to change the endianness of the record buffer
+}
+
+bool Froxelizer::haveBuffersChanged() const noexcept {
+    // only the froxels and records in use are compared, the rest of the buffers is never read
+    return mCommittedFroxels.size() != mFroxelCount ||
+           mCommittedRecords.size() != mRecordBufferUsedCount ||
+           memcmp(mCommittedFroxels.data(), mFroxelBufferUser.data(),
+                   mFroxelCount * sizeof(FroxelEntry)) != 0 ||
+           memcmp(mCommittedRecords.data(), mRecordBufferUser.data(),
+                   mRecordBufferUsedCount * sizeof(RecordBufferType)) != 0;
+}
+
+Froxelizer::LightRecord::bitset Froxelizer::convertLightRecords(
+        size_t const begin, size_t const end) noexcept {
+    Slice<FroxelThreadData> const froxelThreadData = mFroxelShardedData;
+
+    // convert froxel data from N groups of M bits to LightRecord::bitset, so we can
+    // easily compare adjacent froxels, for compaction. The conversion loops below get
+    // inlined and vectorized in release builds.
+
+    // this gets very well vectorized...
 
-    for (size_t i = 0, c = mFroxelCount; i < c;) {
+    Slice<LightRecord> records(mLightRecords);
+    for (size_t j = begin; j < end; j++) {
+        for (size_t i = 0; i < LightRecord::bitset::WORLD_COUNT; i++) {
+            using container_type = LightRecord::bitset::container_type;
+            constexpr size_t r = sizeof(container_type) / sizeof(LightGroupType);
+            container_type b = froxelThreadData[i * r][j];
+            for (size_t k = 0; k < r; k++) {
+                b |= (container_type(froxelThreadData[i * r + k][j]) << (LIGHT_PER_GROUP * k));
+            }
+            records[j].lights.getBitsAt(i) = b;
+        }
+    }
+
+    LightRecord::bitset lights{};
+    for (size_t j = begin; j < end; j++) {
+        lights |= records[j].lights;
+    }
+    return lights;
+}
+
+template<bool WRITE>
+uint32_t Froxelizer::compressLightRecords(size_t const begin, size_t const end,
+        uint32_t offset, uint8_t const allLightsCount) noexcept {
+
+    Slice<LightRecord> const records(mLightRecords);
+    FroxelEntry* const UTILS_RESTRICT froxels = mFroxelBufferUser.data();
+    RecordBufferType* const UTILS_RESTRICT froxelRecords = mRecordBufferUser.data();
+    const size_t froxelCountX = mFroxelCountX;
+    uint32_t const firstOffset = offset;
+
+    for (size_t i = begin; i < end;) {
         LightRecord b = records[i];
         if (b.lights.none()) {
-            froxels[i++].u32 = 0;
+            if constexpr (WRITE) {
+                froxels[i].u32 = 0;
+            }
+            i++;
             continue;
         }
 
         // We have a limitation of 255 spot + 255 point lights per froxel.
+        const size_t lightCount = std::min(size_t(255), b.lights.count());
+
         // note: initializer list for union cannot have more than one element
-        FroxelEntry entry{ offset, uint8_t(std::min(size_t(255), b.lights.count())) };
-        const size_t lightCount = entry.count();
+        // note: the offset is only meaningful when writing
+        FroxelEntry entry{ uint16_t(offset), uint8_t(lightCount) };
 
-        if (UTILS_UNLIKELY(offset + lightCount >= RECORD_BUFFER_ENTRY_COUNT)) {
+        if constexpr (WRITE) {
+            if (UTILS_UNLIKELY(offset + lightCount >= RECORD_BUFFER_ENTRY_COUNT)) {
 #ifndef NDEBUG
-            slog.d << "out of space: " << i << ", at " << offset << io::endl;
+                slog.d << "out of space: " << i << ", at " << offset << io::endl;
 #endif
-            // note: instead of dropping froxels we could look for similar records we've already
-            // filed up.
-            do {
-                froxels[i] = { 0u, allLightsCount };
-                if (records[i].lights.none()) {
-                    froxels[i].u32 = 0;
-                }
-            } while(++i < c);
-            goto out_of_memory;
-        }
+                // note: instead of dropping froxels we could look for similar records we've
+                // already filed up.
+                do {
+                    froxels[i] = { 0u, allLightsCount };
+                    if (records[i].lights.none()) {
+                        froxels[i].u32 = 0;
+                    }
+                } while (++i < end);
+                break;
+            }
 
-        // iterate the bitfield
-        auto * const beginPoint = froxelRecords + offset;
-        b.lights.forEachSetBit([point = beginPoint, beginPoint](size_t l) mutable {
-            // make sure to keep this code branch-less
-            const size_t word = l / LIGHT_PER_GROUP;
-            const size_t bit  = l % LIGHT_PER_GROUP;
-            l = (bit * GROUP_COUNT) | (word % GROUP_COUNT);
-            *point = (RecordBufferType)l;
-            // we need to "cancel" the write operation if we have more than 255 spot or point lights
-            // (this is a limitation of the data type used to store the light counts per froxel)
-            point += (point - beginPoint < 255) ? 1 : 0;
-        });
+            // iterate the bitfield
+            auto * const beginPoint = froxelRecords + offset;
+            b.lights.forEachSetBit([point = beginPoint, beginPoint](size_t l) mutable {
+                // make sure to keep this code branch-less
+                const size_t word = l / LIGHT_PER_GROUP;
+                const size_t bit  = l % LIGHT_PER_GROUP;
+                l = (bit * GROUP_COUNT) | (word % GROUP_COUNT);
+                *point = (RecordBufferType)l;
+                // we need to "cancel" the write operation if we have more than 255 spot or
+                // point lights (this is a limitation of the data type used to store the light
+                // counts per froxel)
+                point += (point - beginPoint < 255) ? 1 : 0;
+            });
+        }
 
         offset += lightCount;
 
-#ifndef NDEBUG
-        if (lightCount) { reused--; }
-#endif
         do {
-#ifndef NDEBUG
-            if (lightCount) { reused++; }
-#endif
-            froxels[i++].u32 = entry.u32;
-            if (i >= c) break;
+            if constexpr (WRITE) {
+                froxels[i].u32 = entry.u32;
+            }
+            if (++i >= end) break;
 
-            if (records[i].lights != b.lights && i >= froxelCountX) {
+            if (records[i].lights != b.lights && i >= begin + froxelCountX) {
                 // if this froxel record doesn't match the previous one on its left,
                 // we re-try with the record above it, which saves many froxel records
                 // (north of 10% in practice).
                 b = records[i - froxelCountX];
-                entry.u32 = froxels[i - froxelCountX].u32;
+                if constexpr (WRITE) {
+                    entry.u32 = froxels[i - froxelCountX].u32;
+                }
             }
-        } while(records[i].lights == b.lights);
+        } while (records[i].lights == b.lights);
     }
-out_of_memory:
-    // FIXME: on big-endian systems we need to change the endianness of the record buffer
-    ;
+
+    return offset - firstOffset;
 }
 
 static float2 project(mat4f const& p, float3 const& v) noexcept {
@@ -775,12 +878,46 @@ static float2 project(mat4f const& p, float3 const& v) noexcept {
     return float2{ x, y } * (1.0f / w);
 }
 
+// Returns the first and last froxel of [x0, x1] intersecting the sphere `s` (radius squared),
+// the froxel `xcenter` always intersects. first > last when there is no intersection.
+// This loop is branch-less and fetches the left and right planes of every froxel, so that it
+// gets vectorized.
+UTILS_ALWAYS_INLINE
+static std::pair<uint32_t, uint32_t> findIntersectingFroxelsX(float4 const& s,
+        float4 const* UTILS_RESTRICT planesX,
+        uint32_t const x0, uint32_t const x1, uint32_t const xcenter) noexcept {
+    uint32_t bx = std::numeric_limits<uint32_t>::max(); // horizontal begin index
+    uint32_t ex = 0;                                    // horizontal end index
+    for (uint32_t ix = x0; ix <= x1; ++ix) {
+        // froxels left of the center are tested against their right plane, and froxels right
+        // of the center against their left plane.
+        float4 const l = planesX[ix];
+        float4 const r = planesX[ix + 1];
+        float const dl = l.x * s.x + l.y * s.y + l.z * s.z + l.w;
+        float const dr = r.x * s.x + r.y * s.y + r.z * s.z + r.w;
+        float const d = ix < xcenter ? dr : dl;
+        // The froxel that contains the center of the sphere is special, we don't even need
+        // to do the intersection check, it's always true.
+        bool const intersect = (ix == xcenter) | (s.w - d * d > 0.0f);
+        bx = std::min(bx, intersect ? ix : std::numeric_limits<uint32_t>::max());
+        ex = std::max(ex, intersect ? ix : 0u);
+    }
+    return { bx, ex };
+}
+
 void Froxelizer::froxelizePointAndSpotLight(
         FroxelThreadData& froxelThread, size_t bit,
         mat4f const& UTILS_RESTRICT p,
         const LightParams& UTILS_RESTRICT light) const noexcept {
 
-    if (UTILS_UNLIKELY(light.position.z + light.radius < -mZLightFar)) { // z values are negative
+    const bool isSpotLight = light.invSin != std::numeric_limits<float>::infinity();
+
+    // spot lights are bounded by their cone, rather than by their radius
+    const float4 bounds = isSpotLight ?
+            computeSpotLightBoundingSphere(light.position, light.axis, light.radius, light.cosSqr) :
+            float4{ light.position, light.radius };
+
+    if (UTILS_UNLIKELY(bounds.z + bounds.w < -mZLightFar)) { // z values are negative
         // This light is fully behind LightFar, it doesn't light anything
         // (we could avoid this check if we culled lights using LightFar instead of the
         // culling camera's far plane)
@@ -788,7 +925,7 @@ void Froxelizer::froxelizePointAndSpotLight(
     }
 
     // the code below works with radius^2
-    const float4 s = { light.position, light.radius * light.radius };
+    const float4 s = { bounds.xyz, bounds.w * bounds.w };
 
 #ifdef DEBUG_FROXEL
     const size_t x0 = 0;
@@ -800,7 +937,7 @@ void Froxelizer::froxelizePointAndSpotLight(
 #else
     // find a reasonable bounding-box in froxel space for the sphere by projecting
     // its (clipped) bounding-box to clip-space and converting to froxel indices.
-    Box const aabb = { light.position, light.radius };
+    Box const aabb = { bounds.xyz, bounds.w };
     const float znear = std::min(-mNear, aabb.center.z + aabb.halfExtent.z); // z values are negative
     const float zfar  =                  aabb.center.z - aabb.halfExtent.z;
 
@@ -868,28 +1005,8 @@ void Froxelizer::froxelizePointAndSpotLight(
                 if (cy.w > 0) {
                     // The reduced sphere from the previous stage intersects this horizontal plane,
                     // and we now have new smaller sphere centered on these two previous planes
-                    size_t bx = std::numeric_limits<size_t>::max(); // horizontal begin index
-                    size_t ex = 0; // horizontal end index
-
-                    // find the "begin" index (left side)
-                    for (size_t ix = x0; ix < x1 + 1; ++ix) {
-                        // The froxel that contains the center of the sphere is special,
-                        // we don't even need to do the intersection check, it's always true.
-                        if (UTILS_LIKELY(ix != xcenter)) {
-                            float4 const& plane = ix < xcenter ? planesX[ix + 1] : planesX[ix];
-                            if (spherePlaneIntersection(cy, plane).w > 0) {
-                                // The reduced sphere from the previous stage intersects this
-                                // vertical plane, we record the min/max froxel indices
-                                bx = std::min(bx, ix);
-                                ex = std::max(ex, ix);
-                            }
-                        } else {
-                            // this is the froxel containing the center of the sphere, it is
-                            // definitely participating
-                            bx = std::min(bx, ix);
-                            ex = std::max(ex, ix);
-                        }
-                    }
+                    auto [bx, ex] = findIntersectingFroxelsX(cy, planesX,
+                            uint32_t(x0), uint32_t(x1), uint32_t(xcenter));
 
                     if (UTILS_UNLIKELY(bx > ex)) {
                         continue;
@@ -900,7 +1017,7 @@ void Froxelizer::froxelizePointAndSpotLight(
                     assert_invariant(bx <= mFroxelCountX && ex <= mFroxelCountX);
 
                     size_t fi = getFroxelIndex(bx, iy, iz);
-                    if (light.invSin != std::numeric_limits<float>::infinity()) {
+                    if (isSpotLight) {
                         // This is a spotlight (common case)
                         // this loops gets vectorized (on arm64) w/ clang
                         while (bx++ != ex) {
@@ -33,6 +33,8 @@
 #include <math/mat4.h>
 #include <math/vec4.h>
 
+#include <vector>
+
 namespace filament {
 
 // The number of froxel buffer entries is determined by max UBO size (see
@@ -202,7 +204,19 @@ private:
     void froxelizeLoop(FEngine& engine,
             math::mat4f const& viewMatrix, const FScene::LightSoa& lightData) noexcept;
 
-    void froxelizeAssignRecordsCompress() noexcept;
+    void froxelizeAssignRecordsCompress(utils::JobSystem& js) noexcept;
+
+    // returns whether the froxel or record buffers differ from the ones last sent to the GPU
+    bool haveBuffersChanged() const noexcept;
+
+    // converts the froxel data of froxels [begin, end) to light records, returns all their lights
+    LightRecord::bitset convertLightRecords(size_t begin, size_t end) noexcept;
+
+    // compresses the light records of froxels [begin, end) starting at `offset` in the record
+    // buffer, returns the number of record entries used. Nothing is written if WRITE is false.
+    template<bool WRITE>
+    uint32_t compressLightRecords(size_t begin, size_t end,
+            uint32_t offset, uint8_t allLightsCount) noexcept;
 
     void froxelizePointAndSpotLight(FroxelThreadData& froxelThread, size_t bit,
             math::mat4f const& projection, const LightParams& light) const noexcept;
@@ -276,6 +290,12 @@ private:
     float mZLightNear;
     float mZLightFar;
 
+    // copy of the buffers last sent to the GPU, so we can skip the upload when they don't change
+    std::vector<FroxelEntry> mCommittedFroxels;
+    std::vector<RecordBufferType> mCommittedRecords;
+    uint32_t mRecordBufferUsedCount = 0;    // number of record buffer entries used this frame
+    bool mBuffersChanged = true;            // whether the buffers need to be uploaded
+
     // track if we need to update our internal state before froxelizing
     uint8_t mDirtyFlags = 0;
     enum {
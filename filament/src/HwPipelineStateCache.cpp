@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "HwPipelineStateCache.h"
+
+#include <backend/DriverApiForward.h>
+#include <backend/Handle.h>
+#include <backend/PipelineState.h>
+
+#include <private/backend/DriverApi.h>
+
+#include <utils/compiler.h>
+#include <utils/Hash.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace filament {
+
+using namespace utils;
+using namespace backend;
+
+size_t HwPipelineStateCache::Hasher::operator()(PipelineState const& state) const noexcept {
+    static_assert((sizeof(PipelineState) % sizeof(uint32_t)) == 0);
+    return hash::murmur3(reinterpret_cast<uint32_t const*>(&state),
+            sizeof(PipelineState) / sizeof(uint32_t), 0);
+}
+
+bool HwPipelineStateCache::EqualTo::operator()(PipelineState const& lhs,
+        PipelineState const& rhs) const noexcept {
+    return !memcmp(&lhs, &rhs, sizeof(PipelineState));
+}
+
+// ------------------------------------------------------------------------------------------------
+
+HwPipelineStateCache::HwPipelineStateCache() noexcept {
+    mStates.reserve(256);
+}
+
+HwPipelineStateCache::~HwPipelineStateCache() noexcept = default;
+
+void HwPipelineStateCache::terminate(DriverApi& driver) noexcept {
+    clear(driver);
+}
+
+auto HwPipelineStateCache::get(DriverApi& driver, PipelineState const& state) noexcept -> Handle {
+    auto pos = mStates.find(state);
+    if (UTILS_LIKELY(pos != mStates.end())) {
+        return pos->second;
+    }
+    Handle const handle = driver.createPipelineState(state);
+    mStates.insert({ state, handle });
+    return handle;
+}
+
+void HwPipelineStateCache::gc(DriverApi& driver) noexcept {
+    if (UTILS_UNLIKELY(mStates.size() > MAX_STATE_COUNT)) {
+        clear(driver);
+    }
+}
+
+void HwPipelineStateCache::clear(DriverApi& driver) noexcept {
+    for (auto const& [state, handle] : mStates) {
+        driver.destroyPipelineState(handle);
+    }
+    mStates.clear();
+}
+
+} // namespace filament
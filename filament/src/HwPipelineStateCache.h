@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_HWPIPELINESTATECACHE_H
+#define TNT_FILAMENT_HWPIPELINESTATECACHE_H
+
+#include <backend/DriverApiForward.h>
+#include <backend/Handle.h>
+#include <backend/PipelineState.h>
+
+#include <tsl/robin_map.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace filament {
+
+/*
+ * Interns the PipelineStates used by the render passes.
+ *
+ * Each unique PipelineState is copied once into a backend object, and then bound by handle with
+ * bindPipelineState(), so the CommandStream only carries a handle per bind instead of the whole
+ * state. Equal states always map to the same handle, so comparing two bound states is a single
+ * integer compare.
+ *
+ * States are never destroyed individually; they stay valid until gc() finds the cache too large,
+ * in which case all of them are destroyed. This happens when many programs come and go, because
+ * the states hold the program handles.
+ */
+class HwPipelineStateCache {
+public:
+    using Handle = backend::PipelineStateHandle;
+
+    // Above this many states, the cache is cleared by gc().
+    static constexpr size_t MAX_STATE_COUNT = 4096;
+
+    HwPipelineStateCache() noexcept;
+    ~HwPipelineStateCache() noexcept;
+
+    HwPipelineStateCache(HwPipelineStateCache const& rhs) = delete;
+    HwPipelineStateCache(HwPipelineStateCache&& rhs) noexcept = delete;
+    HwPipelineStateCache& operator=(HwPipelineStateCache const& rhs) = delete;
+    HwPipelineStateCache& operator=(HwPipelineStateCache&& rhs) noexcept = delete;
+
+    void terminate(backend::DriverApi& driver) noexcept;
+
+    // Returns the handle of the given state, which is created the first time it's seen.
+    Handle get(backend::DriverApi& driver, backend::PipelineState const& state) noexcept;
+
+    // Clears the cache if it's grown too large. This invalidates all the handles returned so far,
+    // so this must only be called between frames.
+    void gc(backend::DriverApi& driver) noexcept;
+
+    size_t getStateCount() const noexcept { return mStates.size(); }
+
+private:
+    struct Hasher {
+        size_t operator()(backend::PipelineState const& state) const noexcept;
+    };
+
+    struct EqualTo {
+        bool operator()(backend::PipelineState const& lhs,
+                backend::PipelineState const& rhs) const noexcept;
+    };
+
+    void clear(backend::DriverApi& driver) noexcept;
+
+    tsl::robin_map<backend::PipelineState, Handle, Hasher, EqualTo> mStates;
+};
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_HWPIPELINESTATECACHE_H
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "HwProgramFactory.h"
+
+#include <backend/DriverApiForward.h>
+#include <backend/DriverEnums.h>
+#include <backend/Handle.h>
+#include <backend/Program.h>
+
+#include <private/backend/DriverApi.h>
+
+#include <utils/compiler.h>
+#include <utils/CString.h>
+#include <utils/debug.h>
+#include <utils/Hash.h>
+
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace filament {
+
+using namespace utils;
+using namespace backend;
+
+namespace {
+
+// Accumulates the data identifying a program. Large blobs (i.e. shaders) are hashed directly
+// instead of being copied.
+class KeyBuilder {
+public:
+    template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+    KeyBuilder& add(T const value) noexcept {
+        mData.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        return *this;
+    }
+
+    KeyBuilder& add(CString const& str) noexcept {
+        add(str.size());
+        mData.append(str.c_str_safe(), str.size());
+        return *this;
+    }
+
+    KeyBuilder& addBlob(uint8_t const* data, size_t const size) noexcept {
+        add(size);
+        add(hash64(data, size));
+        mSize += size;
+        return *this;
+    }
+
+    std::pair<uint64_t, uint64_t> get() const noexcept {
+        auto const* const data = reinterpret_cast<uint8_t const*>(mData.data());
+        return { hash64(data, mData.size()), mSize + mData.size() };
+    }
+
+private:
+    static uint64_t hash64(uint8_t const* data, size_t const size) noexcept {
+        if (!size) {
+            return 0;
+        }
+        return uint64_t(hash::murmurSlow(data, size, 0)) << 32 |
+               hash::murmurSlow(data, size, 0x9e3779b9u);
+    }
+
+    std::string mData;
+    uint64_t mSize = 0;
+};
+
+} // anonymous namespace
+
+HwProgramFactory::HwProgramFactory() noexcept = default;
+
+HwProgramFactory::~HwProgramFactory() noexcept = default;
+
+void HwProgramFactory::terminate(DriverApi&) noexcept {
+    assert_invariant(mPrograms.empty());
+    assert_invariant(mAliases.empty());
+}
+
+auto HwProgramFactory::getKey(Program const& program) noexcept -> Key {
+    KeyBuilder key;
+    for (auto const& shader : program.getShadersSource()) {
+        key.addBlob(shader.data(), shader.size());
+    }
+    key.add(uint8_t(program.getShaderLanguage()));
+    key.add(program.isMultiview());
+
+    for (auto const& bindings : program.getDescriptorBindings()) {
+        key.add(bindings.size());
+        for (auto const& descriptor : bindings) {
+            key.add(descriptor.name);
+            key.add(uint8_t(descriptor.type));
+            key.add(descriptor.binding);
+        }
+    }
+
+    auto const& constants = program.getSpecializationConstants();
+    key.add(constants.size());
+    for (auto const& constant : constants) {
+        key.add(constant.id);
+        key.add(uint8_t(constant.value.index()));
+        std::visit([&key](auto const value) { key.add(value); }, constant.value);
+    }
+
+    for (size_t i = 0; i < Program::SHADER_TYPE_COUNT; i++) {
+        auto const& pushConstants = program.getPushConstants(ShaderStage(i));
+        key.add(pushConstants.size());
+        for (auto const& constant : pushConstants) {
+            key.add(constant.name);
+            key.add(uint8_t(constant.type));
+        }
+    }
+
+    // ESSL 1.0 only
+    auto const& bindingUniforms = program.getBindingUniformInfo();
+    key.add(bindingUniforms.size());
+    for (auto const& [index, name, uniforms] : bindingUniforms) {
+        key.add(index);
+        key.add(name);
+        key.add(uniforms.size());
+        for (auto const& uniform : uniforms) {
+            key.add(uniform.name);
+            key.add(uniform.offset);
+            key.add(uniform.size);
+            key.add(uint8_t(uniform.type));
+        }
+    }
+    auto const& attributes = program.getAttributes();
+    key.add(attributes.size());
+    for (auto const& [name, location] : attributes) {
+        key.add(name);
+        key.add(location);
+    }
+
+    auto const [hash, size] = key.get();
+    return { hash, size };
+}
+
+auto HwProgramFactory::create(DriverApi& driver, Program&& program,
+        CString const& tag) noexcept -> Handle {
+    Key const key = getKey(program);
+    auto pos = mPrograms.find(key);
+    if (pos != mPrograms.end()) {
+        pos.value().refs++;
+        return pos->second.handle;
+    }
+
+    Handle const handle = driver.createProgram(std::move(program));
+    driver.setDebugTag(handle.getId(), tag);
+    mPrograms.insert({ key, { handle, 1, {} } });
+    mKeys.insert({ handle.getId(), key });
+    return handle;
+}
+
+auto HwProgramFactory::create(DriverApi& driver, Program&& program,
+        CString const& tag, Key const& alias) noexcept -> Handle {
+    Handle const handle = create(driver, std::move(program), tag);
+    Key const& key = mKeys[handle.getId()];
+    if (mAliases.insert({ alias, key }).second) {
+        mPrograms.find(key).value().aliases.push_back(alias);
+    }
+    return handle;
+}
+
+auto HwProgramFactory::find(Key const& alias) noexcept -> Handle {
+    auto const aliasPos = mAliases.find(alias);
+    if (aliasPos == mAliases.end()) {
+        return {};
+    }
+    auto pos = mPrograms.find(aliasPos->second);
+    assert_invariant(pos != mPrograms.end());
+    pos.value().refs++;
+    return pos->second.handle;
+}
+
+void HwProgramFactory::destroy(DriverApi& driver, Handle handle) noexcept {
+    auto const keyPos = mKeys.find(handle.getId());
+    assert_invariant(keyPos != mKeys.end());
+    if (UTILS_UNLIKELY(keyPos == mKeys.end())) {
+        return;
+    }
+    auto pos = mPrograms.find(keyPos->second);
+    assert_invariant(pos != mPrograms.end() && pos->second.refs > 0);
+    if (--pos.value().refs == 0) {
+        for (Key const& alias : pos->second.aliases) {
+            mAliases.erase(alias);
+        }
+        mPrograms.erase(pos);
+        mKeys.erase(keyPos);
+        driver.destroyProgram(std::move(handle));
+    }
+}
+
+} // namespace filament
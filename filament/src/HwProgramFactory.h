@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_HWPROGRAMFACTORY_H
+#define TNT_FILAMENT_HWPROGRAMFACTORY_H
+
+#include <backend/DriverApiForward.h>
+#include <backend/Handle.h>
+#include <backend/Program.h>
+
+#include <tsl/robin_map.h>
+
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace filament {
+
+/*
+ * Shares backend programs across all the materials of an engine.
+ *
+ * Programs are identified by a hash of everything that goes into them: the shader sources,
+ * language, descriptor bindings, specialization and push constants (and uniforms and attributes
+ * for ESSL 1.0). Materials that produce identical programs, e.g. the same package loaded twice,
+ * or depth variants common to many materials, then get the same handle, which is reference
+ * counted; only the first one is compiled and linked.
+ *
+ * A program can also be registered under an alias, a key that's cheaper to compute than the
+ * program itself (e.g. the package and variant it comes from), so that it can be found without
+ * loading its shaders.
+ */
+class HwProgramFactory {
+public:
+    using Handle = backend::ProgramHandle;
+
+    struct Key {
+        uint64_t hash;
+        uint64_t size;  // total size of the data hashed, makes collisions even less likely
+        bool operator==(Key const& rhs) const noexcept {
+            return hash == rhs.hash && size == rhs.size;
+        }
+    };
+
+    HwProgramFactory() noexcept;
+    ~HwProgramFactory() noexcept;
+
+    HwProgramFactory(HwProgramFactory const& rhs) = delete;
+    HwProgramFactory(HwProgramFactory&& rhs) noexcept = delete;
+    HwProgramFactory& operator=(HwProgramFactory const& rhs) = delete;
+    HwProgramFactory& operator=(HwProgramFactory&& rhs) noexcept = delete;
+
+    void terminate(backend::DriverApi& driver) noexcept;
+
+    // Returns a program equivalent to the given one, the program is created only if there isn't
+    // one already. Each call must be balanced by a call to destroy().
+    Handle create(backend::DriverApi& driver, backend::Program&& program,
+            utils::CString const& tag) noexcept;
+
+    // Same as above, and registers the program under the given alias.
+    Handle create(backend::DriverApi& driver, backend::Program&& program,
+            utils::CString const& tag, Key const& alias) noexcept;
+
+    // Returns the program registered under the given alias, or a null handle. If found, the call
+    // must be balanced by a call to destroy().
+    Handle find(Key const& alias) noexcept;
+
+    void destroy(backend::DriverApi& driver, Handle handle) noexcept;
+
+    size_t getProgramCount() const noexcept { return mPrograms.size(); }
+
+private:
+    struct KeyHasher {
+        size_t operator()(Key const& key) const noexcept {
+            return size_t(key.hash);
+        }
+    };
+
+    struct Entry {
+        Handle handle;
+        uint32_t refs;
+        std::vector<Key> aliases;
+    };
+
+    static Key getKey(backend::Program const& program) noexcept;
+
+    tsl::robin_map<Key, Entry, KeyHasher> mPrograms;
+    tsl::robin_map<Handle::HandleId, Key> mKeys;
+    tsl::robin_map<Key, Key, KeyHasher> mAliases;   // alias -> program key
+};
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_HWPROGRAMFACTORY_H
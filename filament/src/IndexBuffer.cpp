@@ -22,6 +22,7 @@ namespace filament {
 
 void IndexBuffer::setBuffer(Engine& engine,
         BufferDescriptor&& buffer, uint32_t const byteOffset) {
+    downcast(engine).markContentChanged();
     downcast(this)->setBuffer(downcast(engine), std::move(buffer), byteOffset);
 }
 
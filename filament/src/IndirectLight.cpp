@@ -16,6 +16,8 @@
 
 #include "details/IndirectLight.h"
 
+#include "details/Engine.h"
+
 #include "details/Texture.h"
 
 namespace filament {
@@ -23,6 +25,7 @@ namespace filament {
 using namespace math;
 
 void IndirectLight::setIntensity(float const intensity) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setIntensity(intensity);
 }
 
@@ -31,6 +34,7 @@ float IndirectLight::getIntensity() const noexcept {
 }
 
 void IndirectLight::setRotation(mat3f const& rotation) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setRotation(rotation);
 }
 
@@ -38,6 +42,16 @@ const mat3f& IndirectLight::getRotation() const noexcept {
     return downcast(this)->getRotation();
 }
 
+void IndirectLight::setIrradiance(uint8_t const bands, float3 const* sh) noexcept {
+    downcast(this)->getEngine().markContentChanged();
+    downcast(this)->setIrradiance(bands, sh);
+}
+
+void IndirectLight::setRadiance(uint8_t const bands, float3 const* sh) noexcept {
+    downcast(this)->getEngine().markContentChanged();
+    downcast(this)->setRadiance(bands, sh);
+}
+
 Texture const* IndirectLight::getReflectionsTexture() const noexcept {
     return downcast(this)->getReflectionsTexture();
 }
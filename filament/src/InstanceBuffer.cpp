@@ -16,6 +16,8 @@
 
 #include "details/InstanceBuffer.h"
 
+#include "details/Engine.h"
+
 namespace filament {
 
 size_t InstanceBuffer::getInstanceCount() const noexcept {
@@ -24,6 +26,7 @@ size_t InstanceBuffer::getInstanceCount() const noexcept {
 
 void InstanceBuffer::setLocalTransforms(
         math::mat4f const* localTransforms, size_t const count, size_t const offset) {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setLocalTransforms(localTransforms, count, offset);
 }
 
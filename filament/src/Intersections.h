@@ -20,8 +20,12 @@
 #include <utils/compiler.h>
 
 #include <math/mat4.h>
+#include <math/vec2.h>
+#include <math/vec3.h>
 #include <math/vec4.h>
 
+#include <algorithm>
+
 namespace filament {
 
 // sphere radius must be squared
@@ -80,6 +84,21 @@ inline constexpr bool sphereConeIntersection(
     return false;
 }
 
+// Returns the distances {near, far} along a ray, given by its origin and the inverse of its
+// direction, where it enters and exits an axis-aligned box. The ray misses the box if near > far.
+inline math::float2 rayBoxIntersection(
+        math::float3 const& origin,
+        math::float3 const& invDirection,
+        math::float3 const& center,
+        math::float3 const& halfExtent) noexcept {
+    math::float3 const t0 = (center - halfExtent - origin) * invDirection;
+    math::float3 const t1 = (center + halfExtent - origin) * invDirection;
+    math::float3 const tmin = min(t0, t1);
+    math::float3 const tmax = max(t0, t1);
+    return { std::max(std::max(tmin.x, tmin.y), tmin.z),
+             std::min(std::min(tmax.x, tmax.y), tmax.z) };
+}
+
 // returns the intersection of 3 planes.
 // Assumes all planes are intersecting.
 //
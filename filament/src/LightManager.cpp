@@ -16,6 +16,8 @@
 
 #include "components/LightManager.h"
 
+#include "details/Engine.h"
+
 using namespace utils;
 
 namespace filament {
@@ -51,6 +53,7 @@ void LightManager::destroy(Entity const e) noexcept {
 }
 
 void LightManager::setLightChannel(Instance const i, unsigned int const channel, bool const enable) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setLightChannel(i, channel, enable);
 }
 
@@ -59,6 +62,7 @@ bool LightManager::getLightChannel(Instance const i, unsigned int const channel)
 }
 
 void LightManager::setPosition(Instance const i, const float3& position) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setLocalPosition(i, position);
 }
 
@@ -67,6 +71,7 @@ const float3& LightManager::getPosition(Instance const i) const noexcept {
 }
 
 void LightManager::setDirection(Instance const i, const float3& direction) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setLocalDirection(i, direction);
 }
 
@@ -75,6 +80,7 @@ const float3& LightManager::getDirection(Instance const i) const noexcept {
 }
 
 void LightManager::setColor(Instance const i, const LinearColor& color) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setColor(i, color);
 }
 
@@ -83,10 +89,12 @@ const float3& LightManager::getColor(Instance const i) const noexcept {
 }
 
 void LightManager::setIntensity(Instance const i, float const intensity) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setIntensity(i, intensity, FLightManager::IntensityUnit::LUMEN_LUX);
 }
 
 void LightManager::setIntensityCandela(Instance const i, float const intensity) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setIntensity(i, intensity, FLightManager::IntensityUnit::CANDELA);
 }
 
@@ -95,6 +103,7 @@ float LightManager::getIntensity(Instance const i) const noexcept {
 }
 
 void LightManager::setFalloff(Instance const i, float const radius) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setFalloff(i, radius);
 }
 
@@ -103,6 +112,7 @@ float LightManager::getFalloff(Instance const i) const noexcept {
 }
 
 void LightManager::setSpotLightCone(Instance const i, float const inner, float const outer) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setSpotLightCone(i, inner, outer);
 }
 
@@ -115,6 +125,7 @@ float LightManager::getSpotLightInnerCone(Instance const i) const noexcept {
 }
 
 void LightManager::setSunAngularRadius(Instance const i, float const angularRadius) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setSunAngularRadius(i, angularRadius);
 }
 
@@ -124,6 +135,7 @@ float LightManager::getSunAngularRadius(Instance const i) const noexcept {
 }
 
 void LightManager::setSunHaloSize(Instance const i, float const haloSize) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setSunHaloSize(i, haloSize);
 }
 
@@ -132,6 +144,7 @@ float LightManager::getSunHaloSize(Instance const i) const noexcept {
 }
 
 void LightManager::setSunHaloFalloff(Instance const i, float const haloFalloff) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setSunHaloFalloff(i, haloFalloff);
 }
 
@@ -148,6 +161,7 @@ const LightManager::ShadowOptions& LightManager::getShadowOptions(Instance const
 }
 
 void LightManager::setShadowOptions(Instance const i, ShadowOptions const& options) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setShadowOptions(i, options);
 }
 
@@ -156,6 +170,7 @@ bool LightManager::isShadowCaster(Instance const i) const noexcept {
 }
 
 void LightManager::setShadowCaster(Instance const i, bool const castShadows) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setShadowCaster(i, castShadows);
 }
 
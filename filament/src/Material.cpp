@@ -24,15 +24,24 @@
 
 #include <utils/Invocable.h>
 
+#include <math/mat3.h>
+#include <math/mat4.h>
+#include <math/vec2.h>
+#include <math/vec3.h>
+#include <math/vec4.h>
+
+#include <type_traits>
 #include <utility>
 
 #include <stddef.h>
+#include <stdint.h>
 
 namespace filament {
 
 class MaterialInstance;
 
 using namespace backend;
+using namespace math;
 
 MaterialInstance* Material::createInstance(const char* name) const noexcept {
     return downcast(this)->createInstance(name);
@@ -146,6 +155,59 @@ bool Material::isSampler(const char* name) const noexcept {
     return downcast(this)->isSampler(name);
 }
 
+template<typename T>
+static constexpr UniformType getUniformType() noexcept {
+    if constexpr (std::is_same_v<T, bool>)     return UniformType::BOOL;
+    if constexpr (std::is_same_v<T, bool2>)    return UniformType::BOOL2;
+    if constexpr (std::is_same_v<T, bool3>)    return UniformType::BOOL3;
+    if constexpr (std::is_same_v<T, bool4>)    return UniformType::BOOL4;
+    if constexpr (std::is_same_v<T, float>)    return UniformType::FLOAT;
+    if constexpr (std::is_same_v<T, float2>)   return UniformType::FLOAT2;
+    if constexpr (std::is_same_v<T, float3>)   return UniformType::FLOAT3;
+    if constexpr (std::is_same_v<T, float4>)   return UniformType::FLOAT4;
+    if constexpr (std::is_same_v<T, int32_t>)  return UniformType::INT;
+    if constexpr (std::is_same_v<T, int2>)     return UniformType::INT2;
+    if constexpr (std::is_same_v<T, int3>)     return UniformType::INT3;
+    if constexpr (std::is_same_v<T, int4>)     return UniformType::INT4;
+    if constexpr (std::is_same_v<T, uint32_t>) return UniformType::UINT;
+    if constexpr (std::is_same_v<T, uint2>)    return UniformType::UINT2;
+    if constexpr (std::is_same_v<T, uint3>)    return UniformType::UINT3;
+    if constexpr (std::is_same_v<T, uint4>)    return UniformType::UINT4;
+    if constexpr (std::is_same_v<T, mat3f>)    return UniformType::MAT3;
+    if constexpr (std::is_same_v<T, mat4f>)    return UniformType::MAT4;
+    return UniformType::STRUCT;
+}
+
+template<typename T, typename>
+MaterialInstance::ParameterHandle<T> Material::getParameterHandle(
+        const char* name) const noexcept {
+    auto const* const info = downcast(this)->reflect(name);
+    if (!info || info->type != getUniformType<T>()) {
+        return {};
+    }
+    return { this, int32_t(info->getBufferOffset()) };
+}
+
+// explicit template instantiation of our supported types
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<bool>     Material::getParameterHandle<bool>    (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<bool2>    Material::getParameterHandle<bool2>   (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<bool3>    Material::getParameterHandle<bool3>   (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<bool4>    Material::getParameterHandle<bool4>   (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<float>    Material::getParameterHandle<float>   (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<int32_t>  Material::getParameterHandle<int32_t> (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<uint32_t> Material::getParameterHandle<uint32_t>(const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<int2>     Material::getParameterHandle<int2>    (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<int3>     Material::getParameterHandle<int3>    (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<int4>     Material::getParameterHandle<int4>    (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<uint2>    Material::getParameterHandle<uint2>   (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<uint3>    Material::getParameterHandle<uint3>   (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<uint4>    Material::getParameterHandle<uint4>   (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<float2>   Material::getParameterHandle<float2>  (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<float3>   Material::getParameterHandle<float3>  (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<float4>   Material::getParameterHandle<float4>  (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<mat3f>    Material::getParameterHandle<mat3f>   (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<mat4f>    Material::getParameterHandle<mat4f>   (const char* name) const noexcept;
+
 MaterialInstance* Material::getDefaultInstance() noexcept {
     return downcast(this)->getDefaultInstance();
 }
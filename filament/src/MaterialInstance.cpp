@@ -26,6 +26,7 @@
 
 #include <utils/compiler.h>
 #include <utils/debug.h>
+#include <utils/Panic.h>
 
 #include <math/vec2.h>
 #include <math/vec3.h>
@@ -34,6 +35,7 @@
 
 #include <algorithm>
 #include <string_view>
+#include <type_traits>
 
 #include <stddef.h>
 #include <stdint.h>
@@ -144,6 +146,51 @@ template UTILS_PUBLIC void MaterialInstance::setParameter<mat4f>   (const char*
 
 // ------------------------------------------------------------------------------------------------
 
+template<typename T, typename>
+void MaterialInstance::setParameter(ParameterHandle<T> const handle, T const& value) {
+    if (UTILS_UNLIKELY(!handle.isValid())) {
+        return;
+    }
+    FMaterialInstance* const mi = downcast(this);
+    FILAMENT_CHECK_PRECONDITION(handle.mMaterial == mi->getMaterial())
+            << "parameter handle used with an instance of another material";
+    size_t const offset = size_t(handle.mOffset);
+    if constexpr (std::is_same_v<T, mat3f>) {
+        mi->mUniforms.setUniform(offset, value);
+    } else if constexpr (std::is_same_v<T, bool>) {
+        mi->mUniforms.setUniform(offset, uint32_t(value));
+    } else if constexpr (std::is_same_v<T, bool2>) {
+        mi->mUniforms.setUniform(offset, uint2(value));
+    } else if constexpr (std::is_same_v<T, bool3>) {
+        mi->mUniforms.setUniform(offset, uint3(value));
+    } else if constexpr (std::is_same_v<T, bool4>) {
+        mi->mUniforms.setUniform(offset, uint4(value));
+    } else {
+        mi->mUniforms.template setUniformUntyped<sizeof(T)>(offset, &value);
+    }
+}
+
+template UTILS_PUBLIC void MaterialInstance::setParameter<bool>    (ParameterHandle<bool>     h, bool const&     v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<bool2>   (ParameterHandle<bool2>    h, bool2 const&    v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<bool3>   (ParameterHandle<bool3>    h, bool3 const&    v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<bool4>   (ParameterHandle<bool4>    h, bool4 const&    v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<float>   (ParameterHandle<float>    h, float const&    v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<int32_t> (ParameterHandle<int32_t>  h, int32_t const&  v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<uint32_t>(ParameterHandle<uint32_t> h, uint32_t const& v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<int2>    (ParameterHandle<int2>     h, int2 const&     v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<int3>    (ParameterHandle<int3>     h, int3 const&     v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<int4>    (ParameterHandle<int4>     h, int4 const&     v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<uint2>   (ParameterHandle<uint2>    h, uint2 const&    v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<uint3>   (ParameterHandle<uint3>    h, uint3 const&    v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<uint4>   (ParameterHandle<uint4>    h, uint4 const&    v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<float2>  (ParameterHandle<float2>   h, float2 const&   v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<float3>  (ParameterHandle<float3>   h, float3 const&   v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<float4>  (ParameterHandle<float4>   h, float4 const&   v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<mat3f>   (ParameterHandle<mat3f>    h, mat3f const&    v);
+template UTILS_PUBLIC void MaterialInstance::setParameter<mat4f>   (ParameterHandle<mat4f>    h, mat4f const&    v);
+
+// ------------------------------------------------------------------------------------------------
+
 template <typename T, typename>
 void MaterialInstance::setParameter(const char* name, size_t nameLength, const T* values, size_t count) {
     downcast(this)->setParameterImpl({ name, nameLength }, values, count);
@@ -40,11 +40,17 @@
 #include <utils/FixedCapacityVector.h>
 
 #include <array>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <string_view>
 #include <tuple>
+#include <unordered_map>
 #include <utility>
 
 #include <stdlib.h>
+#include <string.h>
 #include <stdint.h>
 
 using namespace utils;
@@ -95,15 +101,52 @@ bool MaterialParser::MaterialParserDetails::getFromSimpleChunk(
     return false;
 }
 
+namespace {
+
+// All the material packages alive in the process, by hash. Engines loading the same material
+// share its package instead of each keeping a copy.
+struct PackageCache {
+    struct Entry {
+        std::weak_ptr<void const> storage;
+        size_t size;
+    };
+    std::mutex lock;
+    std::unordered_multimap<uint64_t, Entry> packages;
+
+    static PackageCache& get() noexcept {
+        static PackageCache* const sCache = new PackageCache;   // never destroyed on purpose
+        return *sCache;
+    }
+};
+
+} // anonymous namespace
+
 MaterialParser::MaterialParserDetails::ManagedBuffer::ManagedBuffer(const void* start, size_t const size)
-        : mStart(malloc(size)), mSize(size) {
-    memcpy(mStart, start, size);
-}
+        : mSize(size),
+          mHash(std::hash<std::string_view>{}({ static_cast<const char*>(start), size })) {
+    PackageCache& cache = PackageCache::get();
+    std::lock_guard const guard(cache.lock);
+    auto [first, last] = cache.packages.equal_range(mHash);
+    while (first != last) {
+        if (auto storage = first->second.storage.lock()) {
+            if (first->second.size == size && !memcmp(storage.get(), start, size)) {
+                mStorage = std::move(storage);
+                return;
+            }
+            ++first;
+        } else {
+            first = cache.packages.erase(first);
+        }
+    }
 
-MaterialParser::MaterialParserDetails::ManagedBuffer::~ManagedBuffer() noexcept {
-    free(mStart);
+    void* const data = malloc(size);
+    memcpy(data, start, size);
+    mStorage = std::shared_ptr<void const>(data, [](void const* p) { free(const_cast<void*>(p)); });
+    cache.packages.emplace(mHash, PackageCache::Entry{ mStorage, size });
 }
 
+MaterialParser::MaterialParserDetails::ManagedBuffer::~ManagedBuffer() noexcept = default;
+
 // ------------------------------------------------------------------------------------------------
 
 template<typename T>
@@ -138,7 +181,7 @@ MaterialParser::ParseResult MaterialParser::parse() noexcept {
     auto chooseLanguage = [this, &cc]() -> MaybeShaderLanguageAndChunks {
         for (auto language : mImpl.mPreferredLanguages) {
             const auto [matTag, dictTag] = shaderLanguageToTags(language);
-            if (cc.hasChunk(matTag) && cc.hasChunk(dictTag)) {
+            if (cc.hasChunk(matTag) && DictionaryReader::hasDictionary(cc, dictTag)) {
                 return std::make_tuple(language, matTag, dictTag);
             }
         }
@@ -151,14 +194,13 @@ MaterialParser::ParseResult MaterialParser::parse() noexcept {
     }
 
     const auto [chosenLanguage, matTag, dictTag] = result.value();
-    if (UTILS_UNLIKELY(!DictionaryReader::unflatten(cc, dictTag, mImpl.mBlobDictionary))) {
-        return ParseResult::ERROR_OTHER;
-    }
+    mImpl.mBlobDictionary.initialize(cc, dictTag);
     if (UTILS_UNLIKELY(!mImpl.mMaterialChunk.initialize(matTag))) {
         return ParseResult::ERROR_OTHER;
     }
 
     mImpl.mChosenLanguage = chosenLanguage;
+    mImpl.mPackageHash = mImpl.mManagedBuffer.hash();
     return ParseResult::SUCCESS;
 }
 
@@ -18,6 +18,7 @@
 #define TNT_FILAMENT_MATERIALPARSER_H
 
 #include <filaflat/ChunkContainer.h>
+#include <filaflat/DictionaryReader.h>
 #include <filaflat/MaterialChunk.h>
 
 #include <filament/MaterialEnums.h>
@@ -32,6 +33,7 @@
 #include <utils/FixedCapacityVector.h>
 
 #include <array>
+#include <memory>
 #include <tuple>
 #include <utility>
 
@@ -73,6 +75,10 @@ public:
     bool getFeatureLevel(uint8_t* value) const noexcept;
     bool getName(utils::CString*) const noexcept;
     bool getCacheId(uint64_t* cacheId) const noexcept;
+
+    // hash of the whole package, identifies the material's shaders and settings
+    uint64_t getPackageHash() const noexcept { return mImpl.mPackageHash; }
+    size_t getPackageSize() const noexcept { return mImpl.mManagedBuffer.size(); }
     bool getUIB(BufferInterfaceBlock* uib) const noexcept;
     bool getSIB(SamplerInterfaceBlock* sib) const noexcept;
     bool getSubpasses(SubpassInfo* subpass) const noexcept;
@@ -155,28 +161,32 @@ private:
     private:
         friend class MaterialParser;
 
+        // Immutable copy of the material package. Identical packages share a single copy across
+        // all the parsers of the process, including those of different Engines.
         class ManagedBuffer {
-            void* mStart = nullptr;
+            std::shared_ptr<void const> mStorage;
             size_t mSize = 0;
+            uint64_t mHash = 0;
         public:
             explicit ManagedBuffer(const void* start, size_t size);
             ~ManagedBuffer() noexcept;
             ManagedBuffer(ManagedBuffer const& rhs) = delete;
             ManagedBuffer& operator=(ManagedBuffer const& rhs) = delete;
-            void* data() const noexcept { return mStart; }
-            void* begin() const noexcept { return mStart; }
-            void* end() const noexcept { return (uint8_t*)mStart + mSize; }
+            void const* data() const noexcept { return mStorage.get(); }
             size_t size() const noexcept { return mSize; }
+            uint64_t hash() const noexcept { return mHash; }
         };
 
         ManagedBuffer mManagedBuffer;
         filaflat::ChunkContainer mChunkContainer;
         utils::FixedCapacityVector<backend::ShaderLanguage> mPreferredLanguages;
         backend::ShaderLanguage mChosenLanguage;
+        uint64_t mPackageHash = 0;
 
         // Keep MaterialChunk alive between calls to getShader to avoid reload the shader index.
         filaflat::MaterialChunk mMaterialChunk;
-        filaflat::BlobDictionary mBlobDictionary;
+        // The dictionary is read from mManagedBuffer only when the first shader is requested.
+        filaflat::LazyBlobDictionary mBlobDictionary;
     };
 
     filaflat::ChunkContainer& getChunkContainer() noexcept;
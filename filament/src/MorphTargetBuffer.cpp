@@ -22,16 +22,25 @@ namespace filament {
 
 void MorphTargetBuffer::setPositionsAt(Engine& engine, size_t const targetIndex,
         math::float3 const* positions, size_t const count, size_t const offset) {
+    downcast(engine).markContentChanged();
     downcast(this)->setPositionsAt(downcast(engine), targetIndex, positions, count, offset);
 }
 
 void MorphTargetBuffer::setPositionsAt(Engine& engine, size_t const targetIndex,
         math::float4 const* positions, size_t const count, size_t const offset) {
+    downcast(engine).markContentChanged();
     downcast(this)->setPositionsAt(downcast(engine), targetIndex, positions, count, offset);
 }
 
+void MorphTargetBuffer::setPositionsAt(Engine& engine, size_t const targetIndex,
+        uint32_t const* indices, math::float3 const* positions, size_t const count) {
+    downcast(engine).markContentChanged();
+    downcast(this)->setPositionsAt(downcast(engine), targetIndex, indices, positions, count);
+}
+
 void MorphTargetBuffer::setTangentsAt(Engine& engine, size_t const targetIndex,
         math::short4 const* tangents, size_t const count, size_t const offset) {
+    downcast(engine).markContentChanged();
     downcast(this)->setTangentsAt(downcast(engine), targetIndex, tangents, count, offset);
 }
 
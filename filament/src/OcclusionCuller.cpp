@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "OcclusionCuller.h"
+
+#include <math/mat4.h>
+#include <math/vec2.h>
+#include <math/vec3.h>
+#include <math/vec4.h>
+
+#include <utils/compiler.h>
+#include <utils/debug.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <stddef.h>
+#include <stdint.h>
+
+using namespace filament::math;
+
+namespace filament {
+
+OcclusionCuller::OcclusionCuller() noexcept = default;
+
+OcclusionCuller::~OcclusionCuller() noexcept = default;
+
+uint2 OcclusionCuller::getBufferSize(uint32_t const width, uint32_t const height) noexcept {
+    float const scale = std::min(1.0f,
+            float(MAX_BUFFER_SIZE) / float(std::max({ width, height, 1u })));
+    return {
+            std::max(1u, uint32_t(std::round(float(width) * scale))),
+            std::max(1u, uint32_t(std::round(float(height) * scale))) };
+}
+
+void OcclusionCuller::invalidate() noexcept {
+    mLevels.clear();
+    mDepth.clear();
+}
+
+void OcclusionCuller::update(float const* depth, size_t const stride,
+        uint32_t width, uint32_t height, mat4 const& clipFromWorld) {
+    invalidate();
+    if (!width || !height) {
+        return;
+    }
+
+    mClipFromWorld = clipFromWorld;
+
+    size_t texelCount = 0;
+    for (uint32_t w = width, h = height;; w = (w + 1) / 2, h = (h + 1) / 2) {
+        mLevels.push_back({ uint32_t(texelCount), w, h });
+        texelCount += w * h;
+        if (w == 1 && h == 1) {
+            break;
+        }
+    }
+    mDepth.resize(texelCount);
+
+    float* const UTILS_RESTRICT base = mDepth.data();
+    for (size_t i = 0, c = size_t(width) * height; i < c; i++) {
+        base[i] = depth[i * stride];
+    }
+
+    // each texel keeps the farthest (i.e. smallest) depth of the texels it covers, odd sizes are
+    // handled by clamping, so that the last texel of a row or column is accounted for.
+    for (size_t l = 1; l < mLevels.size(); l++) {
+        Level const& src = mLevels[l - 1];
+        Level const& dst = mLevels[l];
+        float const* UTILS_RESTRICT const in = base + src.offset;
+        float* UTILS_RESTRICT const out = base + dst.offset;
+        for (uint32_t y = 0; y < dst.height; y++) {
+            uint32_t const y0 = 2 * y;
+            uint32_t const y1 = std::min(y0 + 1, src.height - 1);
+            for (uint32_t x = 0; x < dst.width; x++) {
+                uint32_t const x0 = 2 * x;
+                uint32_t const x1 = std::min(x0 + 1, src.width - 1);
+                out[y * dst.width + x] = std::min(
+                        std::min(in[y0 * src.width + x0], in[y0 * src.width + x1]),
+                        std::min(in[y1 * src.width + x0], in[y1 * src.width + x1]));
+            }
+        }
+    }
+}
+
+bool OcclusionCuller::isOccluded(mat4f const& clipFromBox,
+        float3 const& center, float3 const& halfExtent) const noexcept {
+    if (UTILS_UNLIKELY(!isValid())) {
+        return false;
+    }
+
+    float2 ndcMin{ std::numeric_limits<float>::max() };
+    float2 ndcMax{ std::numeric_limits<float>::lowest() };
+    float nearest = 0.0f;
+    for (size_t i = 0; i < 8; i++) {
+        float3 const sign{
+                (i & 1u) ? 1.0f : -1.0f,
+                (i & 2u) ? 1.0f : -1.0f,
+                (i & 4u) ? 1.0f : -1.0f };
+        float4 const clip = clipFromBox * float4{ center + sign * halfExtent, 1.0f };
+        if (clip.w <= 0.0f) {
+            // the box crosses the camera plane, it can't be behind anything
+            return false;
+        }
+        float3 const ndc = clip.xyz / clip.w;
+        ndcMin = min(ndcMin, ndc.xy);
+        ndcMax = max(ndcMax, ndc.xy);
+        // converts the clip-space z in [-1, 1] to a reversed-z depth
+        nearest = std::max(nearest, 0.5f - 0.5f * ndc.z);
+    }
+
+    if (ndcMax.x < -1.0f || ndcMax.y < -1.0f || ndcMin.x > 1.0f || ndcMin.y > 1.0f) {
+        // the box is outside the depth buffer, we don't know anything about it
+        return false;
+    }
+
+    Level const& base = mLevels[0];
+    float2 const size{ base.width, base.height };
+    float2 const minTexel = (clamp(ndcMin, -1.0f, 1.0f) * 0.5f + 0.5f) * size;
+    float2 const maxTexel = (clamp(ndcMax, -1.0f, 1.0f) * 0.5f + 0.5f) * size;
+    uint32_t const x0 = std::min(uint32_t(minTexel.x), base.width - 1);
+    uint32_t const y0 = std::min(uint32_t(minTexel.y), base.height - 1);
+    uint32_t const x1 = std::min(uint32_t(maxTexel.x), base.width - 1);
+    uint32_t const y1 = std::min(uint32_t(maxTexel.y), base.height - 1);
+
+    // pick the finest level where the rectangle spans at most 2x2 texels
+    size_t l = 0;
+    while (l + 1 < mLevels.size() &&
+            (((x1 >> l) - (x0 >> l)) > 1 || ((y1 >> l) - (y0 >> l)) > 1)) {
+        l++;
+    }
+
+    Level const& level = mLevels[l];
+    float const* const depth = mDepth.data() + level.offset;
+    float farthest = 1.0f;
+    for (uint32_t y = y0 >> l; y <= (y1 >> l); y++) {
+        for (uint32_t x = x0 >> l; x <= (x1 >> l); x++) {
+            farthest = std::min(farthest, depth[y * level.width + x]);
+        }
+    }
+
+    return nearest < farthest;
+}
+
+void OcclusionCuller::cull(result_type* const UTILS_RESTRICT results, mat4f const& clipFromBox,
+        float3 const* const UTILS_RESTRICT centers, float3 const* const UTILS_RESTRICT extents,
+        size_t const count, size_t const bit) const noexcept {
+    result_type const mask = result_type(1u << bit);
+    for (size_t i = 0; i < count; i++) {
+        if ((results[i] & mask) && isOccluded(clipFromBox, centers[i], extents[i])) {
+            results[i] &= ~mask;
+        }
+    }
+}
+
+} // namespace filament
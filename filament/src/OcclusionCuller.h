@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_OCCLUSIONCULLER_H
+#define TNT_FILAMENT_OCCLUSIONCULLER_H
+
+#include "Culler.h"
+
+#include <math/mat4.h>
+#include <math/vec2.h>
+#include <math/vec3.h>
+
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace filament {
+
+/*
+ * A CPU occlusion culler working on a hierarchical-Z (Hi-Z) pyramid.
+ *
+ * The pyramid is built from a low resolution depth buffer read back from the GPU, typically
+ * a frame or two late. Each level stores the farthest depth of the four texels below it, so
+ * that a single lookup gives a conservative occluder depth for a whole screen-space rectangle.
+ *
+ * Depth values use filament's reversed-z convention: 1 on the near plane, 0 at infinity.
+ *
+ * Boxes are tested in the space of the camera the depth buffer was rendered with, the caller
+ * is responsible for providing the transform from the current world space to that camera's
+ * clip space.
+ */
+class OcclusionCuller {
+public:
+    using result_type = Culler::result_type;
+
+    // maximum dimension of the depth buffer the pyramid is built from
+    static constexpr uint32_t MAX_BUFFER_SIZE = 256;
+
+    OcclusionCuller() noexcept;
+    ~OcclusionCuller() noexcept;
+
+    OcclusionCuller(OcclusionCuller const& rhs) = delete;
+    OcclusionCuller& operator=(OcclusionCuller const& rhs) = delete;
+
+    // size of the depth buffer to render for a viewport of the given size
+    static math::uint2 getBufferSize(uint32_t width, uint32_t height) noexcept;
+
+    /*
+     * (Re)builds the pyramid from a `width` x `height` depth buffer, with its origin at the
+     * bottom-left. Consecutive depth values are `stride` floats apart.
+     * `clipFromWorld` is the transform that was used to render the depth buffer.
+     */
+    void update(float const* depth, size_t stride, uint32_t width, uint32_t height,
+            math::mat4 const& clipFromWorld);
+
+    // discards the pyramid, after this isValid() returns false until the next update()
+    void invalidate() noexcept;
+
+    bool isValid() const noexcept { return !mLevels.empty(); }
+
+    math::mat4 const& getClipFromWorld() const noexcept { return mClipFromWorld; }
+
+    // whether a readback is in flight, used to throttle the number of readbacks
+    bool isReadbackPending() const noexcept { return mReadbackPending; }
+    void setReadbackPending(bool const pending) noexcept { mReadbackPending = pending; }
+
+    /*
+     * Returns true if the box is entirely hidden behind the depth buffer.
+     * `clipFromBox` transforms the box to the clip space of the depth buffer.
+     */
+    bool isOccluded(math::mat4f const& clipFromBox,
+            math::float3 const& center, math::float3 const& halfExtent) const noexcept;
+
+    /*
+     * Clears `bit` of results[i] for each box that is occluded. Boxes whose `bit` is not set
+     * are not tested.
+     */
+    void cull(result_type* results, math::mat4f const& clipFromBox,
+            math::float3 const* centers, math::float3 const* extents,
+            size_t count, size_t bit) const noexcept;
+
+private:
+    struct Level {
+        uint32_t offset;        // offset of the level in mDepth
+        uint32_t width;
+        uint32_t height;
+    };
+
+    std::vector<Level> mLevels;
+    std::vector<float> mDepth;  // all levels, each level stores the farthest depth of its texels
+    math::mat4 mClipFromWorld;
+    bool mReadbackPending = false;
+};
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_OCCLUSIONCULLER_H
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PassTimingManager.h"
+
+#include <filament/Renderer.h>
+
+#include <backend/DriverEnums.h>
+
+#include <utils/compiler.h>
+#include <utils/debug.h>
+#include <utils/FixedCapacityVector.h>
+
+#include <utility>
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace filament {
+
+using namespace utils;
+using namespace backend;
+
+PassTimingManager::PassTimingManager() noexcept = default;
+
+PassTimingManager::~PassTimingManager() noexcept = default;
+
+void PassTimingManager::setEnabled(DriverApi& driver, bool const enabled) noexcept {
+    if (enabled == mEnabled) {
+        return;
+    }
+    if (enabled) {
+        for (auto& frame : mFrames) {
+            for (auto& query : frame.queries) {
+                query = driver.createTimerQuery();
+            }
+        }
+    } else {
+        terminate(driver);
+        mResults.clear();
+    }
+    mEnabled = enabled;
+}
+
+void PassTimingManager::terminate(DriverApi& driver) noexcept {
+    if (!mEnabled) {
+        return;
+    }
+    for (auto& frame : mFrames) {
+        for (auto& query : frame.queries) {
+            driver.destroyTimerQuery(query);
+            query.clear();
+        }
+        frame.count = 0;
+        frame.pending = false;
+    }
+    mCurrent = nullptr;
+    mIndex = 0;
+    mLast = 0;
+    mInPass = false;
+    mEnabled = false;
+}
+
+bool PassTimingManager::collect(DriverApi& driver, Frame& frame) noexcept {
+    auto results = FixedCapacityVector<Renderer::PassTiming>::with_capacity(frame.count);
+    for (uint32_t i = 0; i < frame.count; i++) {
+        uint64_t elapsed = 0;
+        TimerQueryResult const result = driver.getTimerQueryValue(frame.queries[i], &elapsed);
+        if (result == TimerQueryResult::NOT_READY) {
+            return false;
+        }
+        if (result == TimerQueryResult::ERROR) {
+            // drop the whole frame, partial results would be misleading
+            frame.pending = false;
+            return true;
+        }
+        results.push_back({ frame.names[i], Renderer::PassTiming::duration_ns(elapsed) });
+    }
+    mResults = std::move(results);
+    frame.pending = false;
+    return true;
+}
+
+void PassTimingManager::beginFrame(DriverApi& driver) noexcept {
+    if (!mEnabled) {
+        return;
+    }
+
+    // pending frames are always contiguous, starting at mLast
+    while (mFrames[mLast].pending) {
+        if (!collect(driver, mFrames[mLast])) {
+            break;
+        }
+        mLast = (mLast + 1) % POOL_COUNT;
+    }
+
+    // if all frames are still in flight, this frame is not timed
+    Frame& frame = mFrames[mIndex];
+    mCurrent = frame.pending ? nullptr : &frame;
+    if (mCurrent) {
+        mCurrent->count = 0;
+    }
+}
+
+void PassTimingManager::endFrame() noexcept {
+    assert_invariant(!mInPass);
+    if (mCurrent && mCurrent->count) {
+        mCurrent->pending = true;
+        mIndex = (mIndex + 1) % POOL_COUNT;
+    }
+    mCurrent = nullptr;
+}
+
+void PassTimingManager::beginPass(DriverApi& driver, const char* name) noexcept {
+    assert_invariant(!mInPass);
+    if (mCurrent && mCurrent->count < MAX_PASS_COUNT) {
+        mCurrent->names[mCurrent->count] = name;
+        driver.beginTimerQuery(mCurrent->queries[mCurrent->count]);
+        mInPass = true;
+    }
+}
+
+void PassTimingManager::endPass(DriverApi& driver) noexcept {
+    if (mInPass) {
+        driver.endTimerQuery(mCurrent->queries[mCurrent->count]);
+        mCurrent->count++;
+        mInPass = false;
+    }
+}
+
+FixedCapacityVector<Renderer::PassTiming> PassTimingManager::getPassTimings() const noexcept {
+    return mResults;
+}
+
+} // namespace filament
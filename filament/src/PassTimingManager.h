@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_PASSTIMINGMANAGER_H
+#define TNT_FILAMENT_PASSTIMINGMANAGER_H
+
+#include "fg/FrameGraph.h"
+
+#include <filament/Renderer.h>
+
+#include <backend/Handle.h>
+
+#include <private/backend/DriverApi.h>
+
+#include <utils/FixedCapacityVector.h>
+
+#include <array>
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace filament {
+
+/*
+ * Measures the GPU time of each FrameGraph pass with a pair of timer queries.
+ *
+ * Queries are grouped per frame, and a few frames are kept in flight; results are collected
+ * in beginFrame() once all the queries of the oldest frame are available. When the GPU is
+ * too far behind, or a frame has more than MAX_PASS_COUNT passes, the extra passes are simply
+ * not timed.
+ */
+class PassTimingManager final : public FrameGraph::PassObserver {
+    static constexpr size_t POOL_COUNT = 4;
+    static constexpr size_t MAX_PASS_COUNT = 64;
+
+public:
+    PassTimingManager() noexcept;
+    ~PassTimingManager() noexcept;
+
+    PassTimingManager(PassTimingManager const& rhs) = delete;
+    PassTimingManager& operator=(PassTimingManager const& rhs) = delete;
+
+    // creates or destroys the timer queries
+    void setEnabled(backend::DriverApi& driver, bool enabled) noexcept;
+
+    bool isEnabled() const noexcept { return mEnabled; }
+
+    void terminate(backend::DriverApi& driver) noexcept;
+
+    // collects the results of completed frames and starts a new frame
+    void beginFrame(backend::DriverApi& driver) noexcept;
+
+    void endFrame() noexcept;
+
+    // FrameGraph::PassObserver
+    void beginPass(backend::DriverApi& driver, const char* name) noexcept override;
+    void endPass(backend::DriverApi& driver) noexcept override;
+
+    utils::FixedCapacityVector<Renderer::PassTiming> getPassTimings() const noexcept;
+
+private:
+    struct Frame {
+        std::array<backend::Handle<backend::HwTimerQuery>, MAX_PASS_COUNT> queries{};
+        std::array<const char*, MAX_PASS_COUNT> names{};
+        uint32_t count = 0;         // number of passes timed
+        bool pending = false;       // queries were issued and their results not collected
+    };
+
+    // returns false if the oldest frame is still in flight
+    bool collect(backend::DriverApi& driver, Frame& frame) noexcept;
+
+    std::array<Frame, POOL_COUNT> mFrames;
+    Frame* mCurrent = nullptr;      // frame being recorded, null if it isn't timed
+    uint32_t mIndex = 0;            // index of the current frame
+    uint32_t mLast = 0;             // index of the oldest pending frame
+    bool mEnabled = false;
+    bool mInPass = false;
+    utils::FixedCapacityVector<Renderer::PassTiming> mResults;
+};
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_PASSTIMINGMANAGER_H
@@ -166,6 +166,14 @@ void PostProcessManager::PostProcessMaterial::loadMaterial(FEngine& engine) cons
     mSize = 0; // material loaded
 }
 
+void PostProcessManager::PostProcessMaterial::prewarm(FEngine& engine,
+        PostProcessVariant const variant) const noexcept {
+    if (mSize) {
+        loadMaterial(engine);
+    }
+    mMaterial->prepareProgram(Variant{ Variant::type_t(variant) }, CompilerPriorityQueue::LOW);
+}
+
 UTILS_NOINLINE
 FMaterial* PostProcessManager::PostProcessMaterial::getMaterial(FEngine& engine,
         PostProcessVariant variant) const noexcept {
@@ -285,6 +293,7 @@ static const PostProcessManager::StaticMaterialInfo sMaterialList[] = {
         { "dofTiles",                   MATERIAL(DOFTILES) },
         { "dofTilesSwizzle",            MATERIAL(DOFTILESSWIZZLE) },
         { "flare",                      MATERIAL(FLARE) },
+        { "fog",                        MATERIAL(FOG) },
         { "fxaa",                       MATERIAL(FXAA) },
         { "mipmapDepth",                MATERIAL(MIPMAPDEPTH) },
         { "sao",                        MATERIAL(SAO) },
@@ -317,6 +326,46 @@ static const PostProcessManager::StaticMaterialInfo sMaterialList[] = {
         { "shadowmap",                  MATERIAL(SHADOWMAP) },
 };
 
+void PostProcessManager::prewarm(Engine::PostProcessingEffect const effects) noexcept {
+    using Effect = Engine::PostProcessingEffect;
+    struct EffectMaterials {
+        Effect effect;
+        std::initializer_list<std::string_view> materials;
+    };
+    static const EffectMaterials sEffectMaterials[] = {
+            { Effect::AMBIENT_OCCLUSION,
+                    { "mipmapDepth", "sao", "saoBentNormals",
+                      "bilateralBlur", "bilateralBlurBentNormals" }},
+            { Effect::BLOOM,
+                    { "bloomDownsample", "bloomDownsample2x", "bloomDownsample9",
+                      "bloomUpsample", "flare" }},
+            { Effect::DEPTH_OF_FIELD,
+                    { "dofDownsample", "dofCoc", "dofMipmap", "dofTilesSwizzle", "dofTiles",
+                      "dofDilate", "dof", "dofMedian", "dofCombine" }},
+            { Effect::TEMPORAL_ANTI_ALIASING,
+                    { "taa" }},
+            { Effect::FXAA,
+                    { "fxaa" }},
+            { Effect::UPSCALING,
+                    { "fsr_easu", "fsr_easu_mobile", "fsr_easu_mobileF", "fsr_rcas", "sgsr1" }},
+            { Effect::COLOR_GRADING,
+                    { "colorGrading" }},
+    };
+
+    for (auto const& [effect, materials] : sEffectMaterials) {
+        if (!any(effects & effect)) {
+            continue;
+        }
+        for (std::string_view const name : materials) {
+            // the registry is empty at feature level 0
+            auto const pos = mMaterialRegistry.find(name);
+            if (pos != mMaterialRegistry.end()) {
+                pos->second.prewarm(mEngine);
+            }
+        }
+    }
+}
+
 void PostProcessManager::init() noexcept {
     auto& engine = mEngine;
     DriverApi& driver = engine.getDriverApi();
@@ -1463,6 +1512,75 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::generateMipmapSSR(
             true, config.kernelSize, config.sigma0);
 }
 
+FrameGraphId<FrameGraphTexture> PostProcessManager::fog(FrameGraph& fg,
+        FrameGraphId<FrameGraphTexture> const input,
+        FrameGraphId<FrameGraphTexture> const depth,
+        Handle<HwTexture> const fogTexture) noexcept {
+
+    struct FogPassData {
+        FrameGraphId<FrameGraphTexture> inout;
+        FrameGraphId<FrameGraphTexture> depth;
+    };
+
+    auto const& fogPass = fg.addPass<FogPassData>("Fog",
+            [&](FrameGraph::Builder& builder, auto& data) {
+                data.depth = builder.sample(depth);
+                // the fog is blended over the color buffer, so its content must be preserved
+                data.inout = builder.read(input, FrameGraphTexture::Usage::COLOR_ATTACHMENT);
+                data.inout = builder.write(data.inout, FrameGraphTexture::Usage::COLOR_ATTACHMENT);
+                builder.declareRenderPass("Fog Target", {
+                        .attachments = { .color = { data.inout }}
+                });
+            },
+            [=](FrameGraphResources const& resources, auto const& data, DriverApi& driver) {
+                bindPostProcessDescriptorSet(driver);
+                auto out = resources.getRenderPassInfo();
+                out.params.flags.discardStart = TargetBufferFlags::NONE; // b/c we'll blend
+
+                auto const& material = getPostProcessMaterial("fog");
+                FMaterial const* const ma = material.getMaterial(mEngine);
+                FMaterialInstance* const mi = PostProcessMaterial::getMaterialInstance(ma);
+                mi->setParameter("depth", resources.getTexture(data.depth), {});  // nearest
+                mi->setParameter("fogColor", fogTexture, {
+                        .filterMag = SamplerMagFilter::LINEAR,
+                        .filterMin = SamplerMinFilter::LINEAR_MIPMAP_LINEAR });
+
+                // the material outputs the in-scattered light premultiplied by the fog's opacity,
+                // and leaves the destination alpha untouched.
+                auto pipeline = getPipelineState(ma);
+                pipeline.rasterState.blendFunctionSrcRGB = BlendFunction::ONE;
+                pipeline.rasterState.blendFunctionDstRGB = BlendFunction::ONE_MINUS_SRC_ALPHA;
+                pipeline.rasterState.blendFunctionSrcAlpha = BlendFunction::ZERO;
+                pipeline.rasterState.blendFunctionDstAlpha = BlendFunction::ONE;
+
+                mi->commit(driver);
+                mi->use(driver);
+                renderFullScreenQuad(out, pipeline, driver);
+            });
+
+    return fogPass->inout;
+}
+
+float PostProcessManager::getCircleOfConfusionScale(const CameraInfo& cameraInfo,
+        const DepthOfFieldOptions& dofOptions, uint32_t const height) noexcept {
+    // Kc . Ks . cocScale, see dof() below
+    const float Kc = (cameraInfo.A * cameraInfo.f) / (cameraInfo.d - cameraInfo.f);
+    const float Ks = float(height) / FCamera::SENSOR_SIZE;
+    return dofOptions.cocScale * Ks * Kc;
+}
+
+float PostProcessManager::getMaxCircleOfConfusion(const CameraInfo& cameraInfo,
+        const DepthOfFieldOptions& dofOptions, uint32_t const height,
+        float const nearDistance) noexcept {
+    // coc(d) = K . (1 - S / d) is monotonic in d, so its extremes over [nearDistance, inf)
+    // are at nearDistance and at infinity, where it tends to K.
+    const float K = getCircleOfConfusionScale(cameraInfo, dofOptions, height);
+    if (!(nearDistance > 0.0f)) {
+        return std::numeric_limits<float>::infinity();
+    }
+    return std::abs(K) * std::max(1.0f, std::abs(1.0f - cameraInfo.d / nearDistance));
+}
+
 FrameGraphId<FrameGraphTexture> PostProcessManager::dof(FrameGraph& fg,
         FrameGraphId<FrameGraphTexture> const input,
         FrameGraphId<FrameGraphTexture> const depth,
@@ -1559,9 +1677,7 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::dof(FrameGraph& fg,
      */
     const float focusDistance = cameraInfo.d;
     auto const& desc = fg.getDescriptor<FrameGraphTexture>(input);
-    const float Kc = (cameraInfo.A * cameraInfo.f) / (focusDistance - cameraInfo.f);
-    const float Ks = float(desc.height) / FCamera::SENSOR_SIZE;
-    const float K  = dofOptions.cocScale * Ks * Kc;
+    const float K  = getCircleOfConfusionScale(cameraInfo, dofOptions, desc.height);
 
     auto const& p = cameraInfo.projection;
     const float2 cocParams = {
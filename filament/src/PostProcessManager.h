@@ -31,6 +31,7 @@
 #include <fg/FrameGraphResources.h>
 #include <fg/FrameGraphTexture.h>
 
+#include <filament/Engine.h>
 #include <filament/Options.h>
 #include <filament/Viewport.h>
 
@@ -105,6 +106,9 @@ public:
     void init() noexcept;
     void terminate(backend::DriverApi& driver) noexcept;
 
+    // loads the materials of the given effects ahead of their first use
+    void prewarm(Engine::PostProcessingEffect effects) noexcept;
+
     void configureTemporalAntiAliasingMaterial(
             TemporalAntiAliasingOptions const& taaOptions) noexcept;
 
@@ -173,6 +177,13 @@ public:
             FrameGraphId<FrameGraphTexture> output,
             bool needInputDuplication, ScreenSpaceRefConfig const& config) noexcept;
 
+    // Full-screen fog, blended over the color buffer in place (FogOptions::Mode::FULL_SCREEN).
+    // The fog parameters come from the per-view uniforms, fogTexture is the fog color cubemap.
+    FrameGraphId<FrameGraphTexture> fog(FrameGraph& fg,
+            FrameGraphId<FrameGraphTexture> input,
+            FrameGraphId<FrameGraphTexture> depth,
+            backend::Handle<backend::HwTexture> fogTexture) noexcept;
+
     // Depth-of-field
     FrameGraphId<FrameGraphTexture> dof(FrameGraph& fg,
             FrameGraphId<FrameGraphTexture> input,
@@ -182,6 +193,11 @@ public:
             math::float2 bokehScale,
             const DepthOfFieldOptions& dofOptions) noexcept;
 
+    // Returns the largest circle-of-confusion, in pixels of a buffer of the given height, of the
+    // points at or beyond nearDistance from the camera.
+    static float getMaxCircleOfConfusion(const CameraInfo& cameraInfo,
+            const DepthOfFieldOptions& dofOptions, uint32_t height, float nearDistance) noexcept;
+
     // Bloom
     struct BloomPassOutput {
         FrameGraphId<FrameGraphTexture> bloom;
@@ -347,6 +363,10 @@ public:
 
         void terminate(FEngine& engine) noexcept;
 
+        // loads the material if needed and compiles its program at a low priority
+        void prewarm(FEngine& engine,
+                PostProcessVariant variant = PostProcessVariant::OPAQUE) const noexcept;
+
         FMaterial* getMaterial(FEngine& engine,
                 PostProcessVariant variant = PostProcessVariant::OPAQUE) const noexcept;
 
@@ -436,6 +456,10 @@ private:
             FrameGraphTexture::Descriptor const& outDesc,
             bool threshold, float highlight, bool fireflies) noexcept;
 
+    // circle-of-confusion in pixels is: scale * (1 - focusDistance / distance)
+    static float getCircleOfConfusionScale(const CameraInfo& cameraInfo,
+            const DepthOfFieldOptions& dofOptions, uint32_t height) noexcept;
+
     using MaterialRegistryMap = tsl::robin_map<
             std::string_view,
             PostProcessMaterial>;
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_QUALITYGOVERNOR_H
+#define TNT_FILAMENT_QUALITYGOVERNOR_H
+
+#include "FrameInfo.h"
+
+#include <utils/ThermalManager.h>
+
+#include <algorithm>
+#include <chrono>
+
+#include <stdint.h>
+
+namespace filament {
+
+/*
+ * Picks the quality level of the rendered views from the thermal state of the device and from
+ * the measured GPU frame times.
+ *
+ * The thermal state sets a minimum level, so that quality is lowered before the device starts
+ * throttling. On top of that, the level goes up one step when frames stay over the target frame
+ * time, and down one step when frames stay well under it. Quality is only ever restored one
+ * level at a time, after a long stretch of frames with headroom, so that the governor doesn't
+ * oscillate between two levels.
+ */
+class QualityGovernor {
+public:
+    using clock = std::chrono::steady_clock;
+    using ThermalStatus = utils::ThermalManager::ThermalStatus;
+
+    // Each level lowers the quality of one feature, on top of the previous levels.
+    enum Level : uint8_t {
+        FULL_QUALITY = 0,
+        REDUCED_RESOLUTION,     // dynamic resolution is capped
+        REDUCED_SSAO,           // SSAO uses its lowest quality, at half resolution
+        REDUCED_SHADOWS,        // shadow maps are half their size, with at most 2 cascades
+        REDUCED_BLOOM,          // bloom uses fewer levels, at low quality
+        NO_MSAA,                // MSAA is disabled
+        MAX_LEVEL = NO_MSAA
+    };
+
+    // consecutive frames over the target before lowering the quality
+    static constexpr uint32_t DEGRADE_FRAMES = 30;
+
+    // consecutive frames under RECOVERY_RATIO times the target before raising the quality
+    static constexpr uint32_t RECOVERY_FRAMES = 300;
+    static constexpr float RECOVERY_RATIO = 0.75f;
+
+    // The thermal state changes slowly, and Android rate-limits the headroom query.
+    static constexpr std::chrono::seconds THERMAL_POLL_INTERVAL{ 1 };
+    static constexpr int THERMAL_FORECAST_SECONDS = 10;
+
+    void setEnabled(bool const enabled) noexcept {
+        if (mEnabled != enabled) {
+            mEnabled = enabled;
+            reset();
+        }
+    }
+
+    bool isEnabled() const noexcept {
+        return mEnabled;
+    }
+
+    void reset() noexcept {
+        mLevel = FULL_QUALITY;
+        mThermalLevel = FULL_QUALITY;
+        mOverBudgetCount = 0;
+        mUnderBudgetCount = 0;
+        mLastMeasuredFrameId = 0;
+        mLastThermalPoll = {};
+    }
+
+    // Updates the level from the latest frame timings; targetFrameTime is in ms.
+    void update(clock::time_point const now, details::FrameInfo const& info,
+            float const targetFrameTime) noexcept {
+        if (!mEnabled) {
+            return;
+        }
+
+        if (now - mLastThermalPoll >= THERMAL_POLL_INTERVAL) {
+            mLastThermalPoll = now;
+            mThermalLevel = getThermalLevel(mThermalManager.getCurrentThermalStatus(),
+                    mThermalManager.getThermalHeadroom(THERMAL_FORECAST_SECONDS));
+        }
+
+        // the same timings are reported until the next frame's arrive
+        bool const hasNewTimings = info.valid && info.frameId != mLastMeasuredFrameId;
+        if (hasNewTimings) {
+            mLastMeasuredFrameId = info.frameId;
+            float const measured = info.denoisedFrameTime.count();
+            if (measured > targetFrameTime) {
+                mUnderBudgetCount = 0;
+                if (++mOverBudgetCount >= DEGRADE_FRAMES && mLevel < MAX_LEVEL) {
+                    mLevel++;
+                    mOverBudgetCount = 0;
+                }
+            } else {
+                mOverBudgetCount = 0;
+                if (measured < targetFrameTime * RECOVERY_RATIO) {
+                    mUnderBudgetCount++;
+                } else {
+                    mUnderBudgetCount = 0;
+                }
+            }
+        } else if (!info.valid) {
+            // without timings, only the thermal state can hold the quality down
+            mUnderBudgetCount++;
+        }
+
+        if (mLevel < mThermalLevel) {
+            mLevel = mThermalLevel;
+            mUnderBudgetCount = 0;
+        } else if (mLevel > mThermalLevel && mUnderBudgetCount >= RECOVERY_FRAMES) {
+            mLevel--;
+            mUnderBudgetCount = 0;
+        }
+    }
+
+    uint8_t getLevel() const noexcept {
+        return mEnabled ? mLevel : uint8_t(FULL_QUALITY);
+    }
+
+private:
+    // The headroom reaches 1.0 when the device gets to the SEVERE status, where it throttles
+    // heavily, so quality starts being lowered well before that.
+    static uint8_t getThermalLevel(ThermalStatus const status, float const headroom) noexcept {
+        uint8_t level = FULL_QUALITY;
+        switch (status) {
+            case ThermalStatus::ERROR:
+            case ThermalStatus::NONE:       level = FULL_QUALITY;       break;
+            case ThermalStatus::LIGHT:      level = REDUCED_SSAO;       break;
+            case ThermalStatus::MODERATE:   level = REDUCED_SHADOWS;    break;
+            case ThermalStatus::SEVERE:     level = REDUCED_BLOOM;      break;
+            default:                        level = MAX_LEVEL;          break;
+        }
+        // NaN compares false, when the headroom isn't available
+        if (headroom >= 0.95f) {
+            level = std::max(level, uint8_t(REDUCED_SHADOWS));
+        } else if (headroom >= 0.85f) {
+            level = std::max(level, uint8_t(REDUCED_SSAO));
+        } else if (headroom >= 0.75f) {
+            level = std::max(level, uint8_t(REDUCED_RESOLUTION));
+        }
+        return level;
+    }
+
+    utils::ThermalManager mThermalManager;
+    clock::time_point mLastThermalPoll{};
+    uint32_t mOverBudgetCount = 0;
+    uint32_t mUnderBudgetCount = 0;
+    uint32_t mLastMeasuredFrameId = 0;
+    uint8_t mLevel = FULL_QUALITY;
+    uint8_t mThermalLevel = FULL_QUALITY;
+    bool mEnabled = false;
+};
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_QUALITYGOVERNOR_H
@@ -16,6 +16,7 @@
 
 #include "RenderPass.h"
 
+#include "HwPipelineStateCache.h"
 #include "RenderPrimitive.h"
 #include "ShadowMap.h"
 #include "SharedHandle.h"
@@ -52,6 +53,7 @@
 #include <functional>
 #include <limits>
 #include <utility>
+#include <vector>
 
 #include <stddef.h>
 #include <stdint.h>
@@ -116,7 +118,8 @@ RenderPass::RenderPass(FEngine const& engine, DriverApi& driver,
     uint32_t commandCount =
             FScene::getPrimitiveCount(mRenderableSoa, builder.mVisibleRenderables.last);
     const bool colorPass  = bool(builder.mCommandTypeFlags & CommandTypeFlags::COLOR);
-    const bool depthPass  = bool(builder.mCommandTypeFlags & CommandTypeFlags::DEPTH);
+    const bool depthPass  = bool(builder.mCommandTypeFlags &
+            (CommandTypeFlags::DEPTH | CommandTypeFlags::DEPTH_PREPASS));
     commandCount *= uint32_t(colorPass * 2 + depthPass);
     commandCount += 1; // for the sentinel
 
@@ -147,6 +150,36 @@ RenderPass::RenderPass(FEngine const& engine, DriverApi& driver,
             builder.mCameraPosition,
             builder.mCameraForwardVector);
 
+    int32_t stereoscopicEyeCount = 1;
+    if (builder.mFlags & IS_INSTANCED_STEREOSCOPIC) {
+        stereoscopicEyeCount *= engine.getConfig().stereoscopicEyeCount;
+    }
+
+    if (builder.mCommandCache) {
+        // the custom commands are not cached, so they're merged with the commands afterward
+        commandEnd = sortAndInstanceifyCached(engine, driver, builder.mArena,
+                *builder.mCommandCache, commandBegin, commandBegin + commandCount,
+                stereoscopicEyeCount);
+
+        if (builder.mCustomCommands.has_value()) {
+            mCustomCommands.reserve(customCommandCount);
+            for (auto const& [channel, passId, command, order, fn]:
+                    builder.mCustomCommands.value()) {
+                Command custom;
+                appendCustomCommand(&custom, channel, passId, command, order, fn);
+                Command* const pos = std::upper_bound(commandBegin, commandEnd, custom);
+                std::copy_backward(pos, commandEnd, commandEnd + 1);
+                *pos = custom;
+                ++commandEnd;
+            }
+        }
+
+        // these are `const` from this point on...
+        mCommandBegin = commandBegin;
+        mCommandEnd = resize(builder.mArena, commandEnd);
+        return;
+    }
+
     if (builder.mCustomCommands.has_value()) {
         mCustomCommands.reserve(customCommandCount);
         Command* p = commandBegin + commandCount;
@@ -156,14 +189,16 @@ RenderPass::RenderPass(FEngine const& engine, DriverApi& driver,
     }
 
     // sort commands once we're done adding commands
-    commandEnd = resize(builder.mArena,
-            sortCommands(commandBegin, commandEnd));
+    if (engine.features.engine.render_pass.parallel_sort_commands) {
+        commandEnd = resize(builder.mArena,
+                sortCommandsParallel(engine.getJobSystem(), builder.mArena,
+                        commandBegin, commandEnd));
+    } else {
+        commandEnd = resize(builder.mArena,
+                sortCommands(commandBegin, commandEnd));
+    }
 
     if (engine.isAutomaticInstancingEnabled()) {
-        int32_t stereoscopicEyeCount = 1;
-        if (builder.mFlags & IS_INSTANCED_STEREOSCOPIC) {
-            stereoscopicEyeCount *= engine.getConfig().stereoscopicEyeCount;
-        }
         commandEnd = resize(builder.mArena,
                 instanceify(driver,
                         engine.getPerRenderableDescriptorSetLayout().getHandle(),
@@ -178,6 +213,138 @@ RenderPass::RenderPass(FEngine const& engine, DriverApi& driver,
 // this destructor is actually heavy because it inlines ~vector<>
 RenderPass::~RenderPass() noexcept = default;
 
+// ------------------------------------------------------------------------------------------------
+
+RenderPass::CommandCache::CommandCache() noexcept = default;
+
+RenderPass::CommandCache::~CommandCache() noexcept = default;
+
+void RenderPass::CommandCache::clear() noexcept {
+    mGeneratedCommands.clear();
+    mCommands.clear();
+    mInstancedIndices.clear();
+    mInstancedData.clear();
+    mInstancedUboHandle.clear();
+    mInstancedDescriptorSetHandle.clear();
+    mEyeCount = 0;
+    mInstancing = false;
+}
+
+bool RenderPass::CommandCache::matches(Command const* const begin, Command const* const end,
+        FScene::RenderableSoa const& soa, int32_t const eyeCount,
+        bool const instancing) const noexcept {
+    SYSTRACE_CALL();
+
+    if (empty() || eyeCount != mEyeCount || instancing != mInstancing ||
+            size_t(end - begin) != mGeneratedCommands.size()) {
+        return false;
+    }
+
+    // The generated commands capture everything that sorting and instancing depend on, except
+    // the per-renderable data copied into the instanced UBO, which is checked separately.
+    if (!std::equal(begin, end, mGeneratedCommands.begin(), &RenderPass::isSameCommand)) {
+        return false;
+    }
+
+    PerRenderableData const* const uboData = soa.data<FScene::UBO>();
+    for (size_t i = 0, c = mInstancedIndices.size(); i < c; i++) {
+        if (memcmp(&uboData[mInstancedIndices[i]], &mInstancedData[i],
+                sizeof(PerRenderableData)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+RenderPass::Command* RenderPass::sortAndInstanceifyCached(FEngine const& engine, DriverApi& driver,
+        Arena& arena, CommandCache& cache, Command* const begin, Command* const end,
+        int32_t const eyeCount) noexcept {
+    bool const instancing = engine.isAutomaticInstancingEnabled();
+
+    if (cache.matches(begin, end, mRenderableSoa, eyeCount, instancing)) {
+        SYSTRACE_NAME("reuse cached commands");
+        // the cached commands never outnumber the generated ones, since sorting and
+        // instancing only ever remove commands.
+        assert_invariant(cache.mCommands.size() <= size_t(end - begin));
+        mInstancedUboHandle = cache.mInstancedUboHandle;
+        mInstancedDescriptorSetHandle = cache.mInstancedDescriptorSetHandle;
+        return std::copy(cache.mCommands.begin(), cache.mCommands.end(), begin);
+    }
+
+    cache.clear();
+    cache.mGeneratedCommands.assign(begin, end);
+    cache.mEyeCount = eyeCount;
+    cache.mInstancing = instancing;
+
+    Command* last = engine.features.engine.render_pass.parallel_sort_commands ?
+            sortCommandsParallel(engine.getJobSystem(), arena, begin, end) :
+            sortCommands(begin, end);
+
+    if (instancing) {
+        last = instanceify(driver, engine.getPerRenderableDescriptorSetLayout().getHandle(),
+                begin, last, eyeCount, &cache.mInstancedIndices);
+        PerRenderableData const* const uboData = mRenderableSoa.data<FScene::UBO>();
+        cache.mInstancedData.reserve(cache.mInstancedIndices.size());
+        for (uint32_t const index : cache.mInstancedIndices) {
+            cache.mInstancedData.push_back(uboData[index]);
+        }
+        cache.mInstancedUboHandle = mInstancedUboHandle;
+        cache.mInstancedDescriptorSetHandle = mInstancedDescriptorSetHandle;
+    }
+
+    cache.mCommands.assign(begin, last);
+    return last;
+}
+
+bool RenderPass::isSameCommand(Command const& lhs, Command const& rhs) noexcept {
+    if (lhs.key != rhs.key) {
+        return false;
+    }
+    if (lhs.key == uint64_t(Pass::SENTINEL)) {
+        // the content of canceled commands is undefined and irrelevant
+        return true;
+    }
+    PrimitiveInfo const& l = lhs.info;
+    PrimitiveInfo const& r = rhs.info;
+    return l.mi == r.mi &&
+           l.rph == r.rph &&
+           l.vbih == r.vbih &&
+           l.dsh == r.dsh &&
+           l.indexOffset == r.indexOffset &&
+           l.indexCount == r.indexCount &&
+           l.index == r.index &&
+           l.skinningOffset == r.skinningOffset &&
+           l.morphingOffset == r.morphingOffset &&
+           l.rasterState == r.rasterState &&
+           l.instanceCount == r.instanceCount &&
+           l.materialVariant == r.materialVariant &&
+           l.type == r.type &&
+           l.hasSkinning == r.hasSkinning &&
+           l.hasMorphing == r.hasMorphing &&
+           l.hasHybridInstancing == r.hasHybridInstancing;
+}
+
+bool RenderPass::isSameDrawState(PrimitiveInfo const& l, Command const& rhs) noexcept {
+    if ((rhs.key & CUSTOM_MASK) != uint64_t(CustomCommand::PASS)) {
+        return false;
+    }
+    PrimitiveInfo const& r = rhs.info;
+    // same render primitive implies same vertex and index buffers
+    return l.mi == r.mi &&
+           l.rph == r.rph &&
+           l.vbih == r.vbih &&
+           l.dsh == r.dsh &&
+           l.index == r.index &&
+           l.skinningOffset == r.skinningOffset &&
+           l.rasterState == r.rasterState &&
+           l.instanceCount == r.instanceCount &&
+           l.materialVariant == r.materialVariant &&
+           l.type == r.type &&
+           l.hasSkinning == r.hasSkinning &&
+           l.hasMorphing == r.hasMorphing &&
+           l.hasHybridInstancing == r.hasHybridInstancing;
+}
+
 RenderPass::Command* RenderPass::resize(Arena& arena, Command* const last) noexcept {
     arena.rewind(last);
     return last;
@@ -232,6 +399,7 @@ void RenderPass::appendCommands(FEngine const& engine,
         auto* jobCommandsParallel = parallel_for(js, nullptr,
                 visibleRenderables.first, uint32_t(visibleRenderables.size()),
                 std::cref(work), jobs::CountSplitter<JOBS_PARALLEL_FOR_COMMANDS_COUNT>());
+        js.setLabel(jobCommandsParallel, "RenderPass::generateCommands");
         js.runAndWait(jobCommandsParallel);
     }
 
@@ -285,10 +453,75 @@ RenderPass::Command* RenderPass::sortCommands(
     return last;
 }
 
+RenderPass::Command* RenderPass::sortCommandsParallel(JobSystem& js, Arena& arena,
+        Command* const begin, Command* const end) noexcept {
+
+    size_t const count = end - begin;
+
+    // we use a power-of-two number of chunks so that the merge tree is balanced
+    size_t chunkCount = 1;
+    while (chunkCount * 2 <= js.getThreadCount() &&
+           count / (chunkCount * 2) >= JOBS_PARALLEL_SORT_COMMANDS_COUNT) {
+        chunkCount *= 2;
+    }
+
+    if (chunkCount == 1) {
+        return sortCommands(begin, end);
+    }
+
+    SYSTRACE_NAME("sort commands (parallel)");
+
+    size_t const chunkSize = (count + chunkCount - 1) / chunkCount;
+
+    // sort each chunk independently
+    JobSystem::Job* parent = js.createJob();
+    for (size_t i = 0; i < chunkCount; i++) {
+        Command* const first = begin + std::min(count, i * chunkSize);
+        Command* const last = begin + std::min(count, (i + 1) * chunkSize);
+        js.run(js.createJob(parent, [first, last](JobSystem&, JobSystem::Job*) {
+            std::sort(first, last);
+        }));
+    }
+    js.runAndWait(parent);
+
+    // then merge sorted runs pairwise, ping-ponging between the commands and a scratch buffer
+    Command* const scratch = arena.alloc<Command>(count);
+    assert_invariant(scratch);
+
+    Command* src = begin;
+    Command* dst = scratch;
+    for (size_t width = chunkSize; width < count; width *= 2) {
+        parent = js.createJob();
+        for (size_t first = 0; first < count; first += 2 * width) {
+            size_t const middle = std::min(count, first + width);
+            size_t const last = std::min(count, first + 2 * width);
+            js.run(js.createJob(parent,
+                    [src, dst, first, middle, last](JobSystem&, JobSystem::Job*) {
+                        std::merge(src + first, src + middle, src + middle, src + last,
+                                dst + first);
+                    }));
+        }
+        js.runAndWait(parent);
+        std::swap(src, dst);
+    }
+
+    if (src != begin) {
+        std::copy(src, src + count, begin);
+    }
+
+    // find the last command
+    Command* const last = std::partition_point(begin, end,
+            [](Command const& c) {
+                return c.key != uint64_t(Pass::SENTINEL);
+            });
+
+    return last;
+}
+
 RenderPass::Command* RenderPass::instanceify(DriverApi& driver,
         DescriptorSetLayoutHandle perRenderableDescriptorSetLayoutHandle,
         Command* curr, Command* const last,
-        int32_t const eyeCount) const noexcept {
+        int32_t const eyeCount, std::vector<uint32_t>* const instancedIndices) const noexcept {
     SYSTRACE_NAME("instanceify");
 
     // instanceify works by scanning the **sorted** command stream, looking for repeat draw
@@ -387,6 +620,11 @@ RenderPass::Command* RenderPass::instanceify(DriverApi& driver,
             for (uint32_t i = 0; i < instanceCount; i++) {
                 stagingBuffer[instancedPrimitiveOffset + i] = uboData[curr[i].info.index];
             }
+            if (instancedIndices) {
+                for (uint32_t i = 0; i < instanceCount; i++) {
+                    instancedIndices->push_back(curr[i].info.index);
+                }
+            }
 
             // make the first command instanced
             curr[0].info.instanceCount = instanceCount * eyeCount;
@@ -502,7 +740,8 @@ void RenderPass::generateCommands(CommandTypeFlags commandTypeFlags, Command* co
     // compute how much maximum storage we need
     // double the color pass for transparent objects that need to render twice
     const bool colorPass  = bool(commandTypeFlags & CommandTypeFlags::COLOR);
-    const bool depthPass  = bool(commandTypeFlags & CommandTypeFlags::DEPTH);
+    const bool depthPass  = bool(commandTypeFlags &
+            (CommandTypeFlags::DEPTH | CommandTypeFlags::DEPTH_PREPASS));
     const size_t commandsPerPrimitive = uint32_t(colorPass * 2 + depthPass);
     const size_t offsetBegin = FScene::getPrimitiveCount(soa, range.first) * commandsPerPrimitive;
     const size_t offsetEnd   = FScene::getPrimitiveCount(soa, range.last) * commandsPerPrimitive;
@@ -518,6 +757,18 @@ void RenderPass::generateCommands(CommandTypeFlags commandTypeFlags, Command* co
      *  easier to debug and doesn't impact performance (it's just a predicted jump).
      */
 
+    if (UTILS_UNLIKELY(colorPass && bool(commandTypeFlags & CommandTypeFlags::DEPTH_PREPASS))) {
+        // The prepass only has the opaque objects, rendered with the depth variant. Shadowing
+        // only matters for the culling mode of shadow maps, so it's turned off here.
+        curr = generateCommandsImpl<CommandTypeFlags::DEPTH>(commandTypeFlags |
+                        CommandTypeFlags::FILTER_TRANSLUCENT_OBJECTS |
+                        CommandTypeFlags::DEPTH_FILTER_ALPHA_MASKED_OBJECTS, curr,
+                soa, range,
+                Variant{ Variant::DEPTH_VARIANT }, RenderFlags(renderFlags & ~HAS_SHADOWING),
+                visibilityMask, cameraPosition, cameraForward,
+                instancedStereoEyeCount);
+    }
+
     switch (commandTypeFlags & (CommandTypeFlags::COLOR | CommandTypeFlags::DEPTH)) {
         case CommandTypeFlags::COLOR:
             curr = generateCommandsImpl<CommandTypeFlags::COLOR>(commandTypeFlags, curr,
@@ -567,6 +818,12 @@ RenderPass::Command* RenderPass::generateCommandsImpl(CommandTypeFlags extraFlag
     bool const filterTranslucentObjects =
             bool(extraFlags & CommandTypeFlags::FILTER_TRANSLUCENT_OBJECTS);
 
+    bool const isDepthPrepass =
+            bool(extraFlags & CommandTypeFlags::DEPTH_PREPASS);
+
+    bool const orderIndependentBlending =
+            bool(extraFlags & CommandTypeFlags::ORDER_INDEPENDENT_BLENDING);
+
     bool const hasShadowing =
             renderFlags & HAS_SHADOWING;
 
@@ -740,10 +997,25 @@ RenderPass::Command* RenderPass::generateCommandsImpl(CommandTypeFlags extraFlag
                     // blend pass:
                     //   This will sort back-to-front for blended, and honor explicit ordering
                     //   for a given Z value, or globally.
+                    const TransparencyMode mode = mi->getTransparencyMode();
+
+                    // ADD, MULTIPLY and SCREEN blending are commutative, so when these objects
+                    // don't write depth, the draw order doesn't change the result. If allowed,
+                    // they're sorted by material instead of distance, which batches their draws.
+                    const BlendingMode blendingMode = mi->getMaterial()->getBlendingMode();
+                    const bool orderIndependent = orderIndependentBlending &
+                            (blendingMode == BlendingMode::ADD ||
+                             blendingMode == BlendingMode::MULTIPLY ||
+                             blendingMode == BlendingMode::SCREEN) &
+                            !cmd.info.rasterState.depthWrite &
+                            (mode == TransparencyMode::DEFAULT);
+                    const uint32_t blendSortingBits = orderIndependent ?
+                            uint32_t(mi->getSortingKey()) : ~distanceBits;
+
                     cmd.key &= ~BLEND_ORDER_MASK;
                     cmd.key &= ~BLEND_DISTANCE_MASK;
-                    // write the distance
-                    cmd.key |= makeField(~distanceBits,
+                    // write the distance (or the material)
+                    cmd.key |= makeField(blendSortingBits,
                             BLEND_DISTANCE_MASK, BLEND_DISTANCE_SHIFT);
                     // clear the distance if global ordering is enabled
                     cmd.key &= ~select(primitive.isGlobalBlendOrderEnabled(),
@@ -753,8 +1025,6 @@ RenderPass::Command* RenderPass::generateCommandsImpl(CommandTypeFlags extraFlag
                             BLEND_ORDER_MASK, BLEND_ORDER_SHIFT);
 
 
-                    const TransparencyMode mode = mi->getTransparencyMode();
-
                     // handle transparent objects, two techniques:
                     //
                     //   - TWO_PASSES_ONE_SIDE: draw the front faces in the depth buffer then
@@ -835,6 +1105,11 @@ RenderPass::Command* RenderPass::generateCommandsImpl(CommandTypeFlags extraFlag
                 *curr = cmd;
                 // cancel command if both front and back faces are culled
                 curr->key |= select(cullingMode == CullingMode::FRONT_AND_BACK);
+
+                // cancel prepass commands that don't write depth, and those of objects using
+                // screen-space refraction, which must not hide what's behind them.
+                curr->key |= select(isDepthPrepass & (!cmd.info.rasterState.depthWrite |
+                        (ma->getRefractionMode() == RefractionMode::SCREEN_SPACE)));
             }
 
             ++curr;
@@ -954,20 +1229,26 @@ void RenderPass::Executor::execute(FEngine const& engine, DriverApi& driver,
         PipelineState currentPipeline{};
         Handle<HwRenderPrimitive> currentPrimitiveHandle{};
 
+        // pipelines are bound by handle, which keeps the CommandStream small
+        HwPipelineStateCache& pipelineStateCache =
+                const_cast<FEngine&>(engine).getPipelineStateCache();
+
         FMaterialInstance const* UTILS_RESTRICT mi = nullptr;
         FMaterial const* UTILS_RESTRICT ma = nullptr;
+        bool isDepthCommand = false;
         auto const* UTILS_RESTRICT pCustomCommands = mCustomCommands.data();
 
         // Maximum space occupied in the CircularBuffer by a single `Command`. This must be
         // reevaluated when the inner loop below adds DriverApi commands or when we change the
-        // CommandStream protocol. Currently, the maximum is 248 bytes.
+        // CommandStream protocol. Currently, the maximum is 264 bytes.
         // The batch size is calculated by adding the size of all commands that can possibly be
         // emitted per draw call:
         constexpr size_t maxCommandSizeInBytes =
                 sizeof(COMMAND_TYPE(scissor)) +
                 sizeof(COMMAND_TYPE(bindDescriptorSet)) +
                 sizeof(COMMAND_TYPE(bindDescriptorSet)) +
-                sizeof(COMMAND_TYPE(bindPipeline)) +
+                sizeof(COMMAND_TYPE(createPipelineStateR)) +
+                sizeof(COMMAND_TYPE(bindPipelineState)) +
                 sizeof(COMMAND_TYPE(bindRenderPrimitive)) +
                 sizeof(COMMAND_TYPE(bindDescriptorSet)) + backend::CustomCommand::align(sizeof(NoopCommand) + 8) +
                 sizeof(COMMAND_TYPE(setPushConstant)) +
@@ -1022,12 +1303,16 @@ void RenderPass::Executor::execute(FEngine const& engine, DriverApi& driver,
                 pipeline.primitiveType = info.type;
                 assert_invariant(pipeline.vertexBufferInfo);
 
-                if (UTILS_UNLIKELY(mi != info.mi)) {
+                // the depth prepass of a color pass uses a different per-view descriptor-set
+                bool const depthCommand = (first->key & PASS_MASK) == uint64_t(Pass::DEPTH);
+
+                if (UTILS_UNLIKELY(mi != info.mi || isDepthCommand != depthCommand)) {
                     // this is always taken the first time
                     assert_invariant(info.mi);
 
                     mi = info.mi;
                     ma = mi->getMaterial();
+                    isDepthCommand = depthCommand;
 
                     // if we have the scissor override, the material instance and scissor-viewport
                     // are ignored (typically used for shadow maps).
@@ -1073,10 +1358,16 @@ void RenderPass::Executor::execute(FEngine const& engine, DriverApi& driver,
                         // have a known per-view descriptor-set layout, e.g.: shadow-maps, ssr and
                         // structure passes.
                         if (mColorPassDescriptorSet) {
-                            // We have a ColorPassDescriptorSet, we need to go through it for binding
-                            // the per-view descriptor-set because its layout can change based on the
-                            // material.
-                            mColorPassDescriptorSet->bind(driver, ma->getPerViewLayoutIndex());
+                            if (UTILS_UNLIKELY(depthCommand)) {
+                                // The depth prepass uses the depth variant, whose per-view
+                                // layout is the same as for the structure pass.
+                                engine.getPostProcessManager().bindPostProcessDescriptorSet(driver);
+                            } else {
+                                // We have a ColorPassDescriptorSet, we need to go through it for
+                                // binding the per-view descriptor-set because its layout can
+                                // change based on the material.
+                                mColorPassDescriptorSet->bind(driver, ma->getPerViewLayoutIndex());
+                            }
                         }
                     }
 
@@ -1089,7 +1380,7 @@ void RenderPass::Executor::execute(FEngine const& engine, DriverApi& driver,
 
                 if (UTILS_UNLIKELY(memcmp(&pipeline, &currentPipeline, sizeof(PipelineState)) != 0)) {
                     currentPipeline = pipeline;
-                    driver.bindPipeline(pipeline);
+                    driver.bindPipelineState(pipelineStateCache.get(driver, pipeline));
                 }
 
                 if (UTILS_UNLIKELY(info.rph != currentPrimitiveHandle)) {
@@ -1112,7 +1403,26 @@ void RenderPass::Executor::execute(FEngine const& engine, DriverApi& driver,
                             +PushConstantIds::MORPHING_BUFFER_OFFSET, int32_t(info.morphingOffset));
                 }
 
-                driver.draw2(info.indexOffset, info.indexCount, info.instanceCount);
+                // Consecutive commands that only differ by their index range (e.g. parts of a
+                // mesh sharing its buffers and material instance) don't need anything to be
+                // rebound, so they're submitted as a single multi-draw.
+                Command const* runLast = first + 1;
+                if (info.instanceCount == 1 && !info.hasMorphing) {
+                    while (runLast != batchLast && isSameDrawState(info, *runLast)) {
+                        ++runLast;
+                    }
+                }
+                if (UTILS_UNLIKELY(runLast - first > 1)) {
+                    uint32_t const drawCount = uint32_t(runLast - first);
+                    auto* const ranges = driver.allocatePod<DrawRange>(drawCount);
+                    for (uint32_t i = 0; i < drawCount; i++) {
+                        ranges[i] = { first[i].info.indexOffset, first[i].info.indexCount };
+                    }
+                    driver.multiDraw2(ranges, drawCount);
+                    first = runLast - 1;
+                } else {
+                    driver.draw2(info.indexOffset, info.indexCount, info.instanceCount);
+                }
             }
         }
 
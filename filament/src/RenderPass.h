@@ -24,6 +24,7 @@
 #include "details/Camera.h"
 #include "details/Scene.h"
 
+#include "private/filament/UibStructs.h"
 #include "private/filament/Variant.h"
 
 #include <backend/DriverApiForward.h>
@@ -33,6 +34,7 @@
 #include <utils/Allocator.h>
 #include <utils/BitmaskEnum.h>
 #include <utils/FixedCapacityVector.h>
+#include <utils/JobSystem.h>
 #include <utils/Range.h>
 #include <utils/Slice.h>
 #include <utils/architecture.h>
@@ -201,6 +203,12 @@ public:
         // alpha-blended objects are not rendered in the depth buffer
         FILTER_TRANSLUCENT_OBJECTS = 0x10,
 
+        // the color pass starts with a depth-only pass of its opaque objects
+        DEPTH_PREPASS = 0x20,
+
+        // blended objects whose result doesn't depend on the draw order are sorted by material
+        ORDER_INDEPENDENT_BLENDING = 0x40,
+
         // generate commands for shadow map
         SHADOW = DEPTH | DEPTH_CONTAINS_SHADOW_CASTERS,
         // generate commands for SSAO
@@ -330,6 +338,45 @@ public:
     using DescriptorSetSharedHandle = SharedHandle<
             backend::HwDescriptorSet, DescriptorSetHandleDeleter>;
 
+    /*
+     * CommandCache keeps the sorted and instanced commands of a pass from one frame to the next.
+     * When the commands generated for a frame are identical to the previous frame's, and so is
+     * the per-renderable data of the instanced primitives, the previous result is reused as-is,
+     * which skips sorting, instancing and the upload of the instanced UBO.
+     *
+     * Custom commands are not cached, they're merged with the cached commands every frame.
+     */
+    class CommandCache {
+    public:
+        CommandCache() noexcept;
+        ~CommandCache() noexcept;
+
+        CommandCache(CommandCache const& rhs) = delete;
+        CommandCache& operator=(CommandCache const& rhs) = delete;
+
+        // discards the cached commands and releases the instanced UBO and its descriptor-set
+        void clear() noexcept;
+
+        bool empty() const noexcept { return mGeneratedCommands.empty(); }
+
+    private:
+        friend class RenderPass;
+
+        // whether the commands in [begin, end) would produce the cached commands
+        bool matches(Command const* begin, Command const* end,
+                FScene::RenderableSoa const& soa, int32_t eyeCount,
+                bool instancing) const noexcept;
+
+        std::vector<Command> mGeneratedCommands;    // commands as generated, before sorting
+        std::vector<Command> mCommands;             // sorted and instanced commands
+        std::vector<uint32_t> mInstancedIndices;    // renderables stored in the instanced UBO
+        std::vector<PerRenderableData> mInstancedData; // and their data at the time of caching
+        BufferObjectSharedHandle mInstancedUboHandle;
+        DescriptorSetSharedHandle mInstancedDescriptorSetHandle;
+        int32_t mEyeCount = 0;
+        bool mInstancing = false;
+    };
+
     /*
      * Executor holds the range of commands to execute for a given pass
      */
@@ -425,11 +472,30 @@ private:
     static Command* sortCommands(
             Command* begin, Command* end) noexcept;
 
-    // instanceify commands then trims sentinels
+    // same as sortCommands, but chunks are sorted concurrently on the JobSystem and then
+    // merged pairwise in parallel. The arena is used for the merge scratch buffer, which is
+    // reclaimed by the following resize().
+    static Command* sortCommandsParallel(utils::JobSystem& js, Arena& arena,
+            Command* begin, Command* end) noexcept;
+
+    // Reuses the commands from the cache if they're still valid, otherwise sorts and instanceifies
+    // the commands and stores the result in the cache.
+    Command* sortAndInstanceifyCached(FEngine const& engine, backend::DriverApi& driver,
+            Arena& arena, CommandCache& cache, Command* begin, Command* end,
+            int32_t eyeCount) noexcept;
+
+    // instanceify commands then trims sentinels.
+    // If instancedIndices is not null, it receives the index of each renderable stored in the
+    // instanced UBO.
     Command* instanceify(backend::DriverApi& driver,
             backend::DescriptorSetLayoutHandle perRenderableDescriptorSetLayoutHandle,
             Command* begin, Command* end,
-            int32_t eyeCount) const noexcept;
+            int32_t eyeCount, std::vector<uint32_t>* instancedIndices = nullptr) const noexcept;
+
+    static bool isSameCommand(Command const& lhs, Command const& rhs) noexcept;
+
+    // whether rhs can be drawn with the state bound for lhs, i.e. only its index range differs
+    static bool isSameDrawState(PrimitiveInfo const& lhs, Command const& rhs) noexcept;
 
     // We choose the command count per job to minimize JobSystem overhead.
     static constexpr size_t JOBS_PARALLEL_FOR_COMMANDS_COUNT = 128;
@@ -439,6 +505,9 @@ private:
     static_assert(JOBS_PARALLEL_FOR_COMMANDS_SIZE % utils::CACHELINE_SIZE == 0,
             "Size of Commands jobs must be multiple of a cache-line size");
 
+    // Below this many commands per chunk, the parallel sort isn't worth the JobSystem overhead.
+    static constexpr size_t JOBS_PARALLEL_SORT_COMMANDS_COUNT = 4096;
+
     static inline void generateCommands(CommandTypeFlags commandTypeFlags, Command* commands,
             FScene::RenderableSoa const& soa, utils::Range<uint32_t> range,
             Variant variant, RenderFlags renderFlags,
@@ -485,6 +554,7 @@ class RenderPassBuilder {
     Variant mVariant{};
     ColorPassDescriptorSet const* mColorPassDescriptorSet = nullptr;
     FScene::VisibleMaskType mVisibilityMask = std::numeric_limits<FScene::VisibleMaskType>::max();
+    RenderPass::CommandCache* mCommandCache = nullptr;
 
     using CustomCommandRecord = std::tuple<
             uint8_t,
@@ -564,6 +634,13 @@ public:
         return *this;
     }
 
+    // Sets a cache that persists the commands across frames. The cache must outlive the
+    // RenderPass and must only be used with a single pass at a time.
+    RenderPassBuilder& commandCache(RenderPass::CommandCache* cache) noexcept {
+        mCommandCache = cache;
+        return *this;
+    }
+
     RenderPassBuilder& customCommand(
             uint8_t channel,
             RenderPass::Pass pass,
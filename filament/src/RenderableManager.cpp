@@ -57,34 +57,42 @@ void RenderableManager::destroy(Entity const e) noexcept {
 }
 
 void RenderableManager::setAxisAlignedBoundingBox(Instance const instance, const Box& aabb) {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setAxisAlignedBoundingBox(instance, aabb);
 }
 
 void RenderableManager::setLayerMask(Instance const instance, uint8_t const select, uint8_t const values) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setLayerMask(instance, select, values);
 }
 
 void RenderableManager::setPriority(Instance const instance, uint8_t const priority) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setPriority(instance, priority);
 }
 
 void RenderableManager::setChannel(Instance const instance, uint8_t const channel) noexcept{
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setChannel(instance, channel);
 }
 
 void RenderableManager::setCulling(Instance const instance, bool const enable) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setCulling(instance, enable);
 }
 
 void RenderableManager::setCastShadows(Instance const instance, bool const enable) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setCastShadows(instance, enable);
 }
 
 void RenderableManager::setReceiveShadows(Instance const instance, bool const enable) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setReceiveShadows(instance, enable);
 }
 
 void RenderableManager::setScreenSpaceContactShadows(Instance const instance, bool const enable) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setScreenSpaceContactShadows(instance, enable);
 }
 
@@ -110,6 +118,7 @@ size_t RenderableManager::getPrimitiveCount(Instance const instance) const noexc
 
 void RenderableManager::setMaterialInstanceAt(Instance const instance,
         size_t const primitiveIndex, MaterialInstance const* materialInstance) {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setMaterialInstanceAt(instance, 0, primitiveIndex, downcast(materialInstance));
 }
 
@@ -123,11 +132,13 @@ MaterialInstance* RenderableManager::getMaterialInstanceAt(
 }
 
 void RenderableManager::setBlendOrderAt(Instance const instance, size_t const primitiveIndex, uint16_t const order) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setBlendOrderAt(instance, 0, primitiveIndex, order);
 }
 
 void RenderableManager::setGlobalBlendOrderEnabledAt(Instance const instance,
         size_t const primitiveIndex, bool const enabled) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setGlobalBlendOrderEnabledAt(instance, 0, primitiveIndex, enabled);
 }
 
@@ -138,33 +149,39 @@ AttributeBitset RenderableManager::getEnabledAttributesAt(Instance const instanc
 void RenderableManager::setGeometryAt(Instance const instance, size_t const primitiveIndex,
         PrimitiveType const type, VertexBuffer* vertices, IndexBuffer* indices,
         size_t const offset, size_t const count) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setGeometryAt(instance, 0, primitiveIndex,
             type, downcast(vertices), downcast(indices), offset, count);
 }
 
 void RenderableManager::setBones(Instance const instance,
         Bone const* transforms, size_t const boneCount, size_t const offset) {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setBones(instance, transforms, boneCount, offset);
 }
 
 void RenderableManager::setBones(Instance const instance,
         mat4f const* transforms, size_t const boneCount, size_t const offset) {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setBones(instance, transforms, boneCount, offset);
 }
 
 void RenderableManager::setSkinningBuffer(Instance const instance,
         SkinningBuffer* skinningBuffer, size_t const count, size_t const offset) {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setSkinningBuffer(instance, downcast(skinningBuffer), count, offset);
 }
 
 void RenderableManager::setMorphWeights(Instance const instance, float const* weights,
         size_t const count, size_t const offset) {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setMorphWeights(instance, weights, count, offset);
 }
 
 void RenderableManager::setMorphTargetBufferOffsetAt(Instance const instance, uint8_t const level,
         size_t const primitiveIndex,
         size_t const offset) {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setMorphTargetBufferOffsetAt(instance, level, primitiveIndex, offset);
 }
 
@@ -177,6 +194,7 @@ size_t RenderableManager::getMorphTargetCount(Instance const instance) const noe
 }
 
 void RenderableManager::setLightChannel(Instance const instance, unsigned int const channel, bool const enable) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setLightChannel(instance, channel, enable);
 }
 
@@ -185,6 +203,7 @@ bool RenderableManager::getLightChannel(Instance const instance, unsigned int co
 }
 
 void RenderableManager::setFogEnabled(Instance const instance, bool const enable) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setFogEnabled(instance, enable);
 }
 
@@ -42,10 +42,18 @@ void Renderer::render(View const* view) {
     downcast(this)->render(downcast(view));
 }
 
+void Renderer::render(View const* const* views, size_t const count) {
+    downcast(this)->render(reinterpret_cast<FView const* const*>(views), count);
+}
+
 void Renderer::setPresentationTime(int64_t const monotonic_clock_ns) {
     downcast(this)->setPresentationTime(monotonic_clock_ns);
 }
 
+void Renderer::setPresentationDamage(filament::Viewport const& region) {
+    downcast(this)->setPresentationDamage(region);
+}
+
 void Renderer::skipFrame(uint64_t const vsyncSteadyClockTimeNano) {
     downcast(this)->skipFrame(vsyncSteadyClockTimeNano);
 }
@@ -91,7 +99,16 @@ void Renderer::setFrameRateOptions(FrameRateOptions const& options) noexcept {
     downcast(this)->setFrameRateOptions(options);
 }
 
+void Renderer::setQualityGovernorOptions(QualityGovernorOptions const& options) noexcept {
+    downcast(this)->setQualityGovernorOptions(options);
+}
+
+uint8_t Renderer::getQualityLevel() const noexcept {
+    return downcast(this)->getQualityLevel();
+}
+
 void Renderer::setClearOptions(const ClearOptions& options) {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setClearOptions(options);
 }
 
@@ -115,4 +132,24 @@ size_t Renderer::getMaxFrameHistorySize() const noexcept {
     return downcast(this)->getMaxFrameHistorySize();
 }
 
+void Renderer::setPassTimingsEnabled(bool const enabled) noexcept {
+    downcast(this)->setPassTimingsEnabled(enabled);
+}
+
+utils::FixedCapacityVector<Renderer::PassTiming> Renderer::getPassTimings() const noexcept {
+    return downcast(this)->getPassTimings();
+}
+
+void Renderer::setFrameSkippingEnabled(bool const enabled) noexcept {
+    downcast(this)->setFrameSkippingEnabled(enabled);
+}
+
+void Renderer::setLowLatencyModeEnabled(bool const enabled) noexcept {
+    downcast(this)->setLowLatencyModeEnabled(enabled);
+}
+
+void Renderer::setRenderOnDemandEnabled(bool const enabled) noexcept {
+    downcast(this)->setRenderOnDemandEnabled(enabled);
+}
+
 } // namespace filament
@@ -33,6 +33,7 @@
 #include <utils/debug.h>
 #include <utils/Log.h>
 #include <utils/ostream.h>
+#include <utils/Systrace.h>
 
 #include <array>
 #include <algorithm>
@@ -181,8 +182,10 @@ TextureHandle ResourceAllocator::createTexture(const char* name,
             handle = it->second.handle;
             mCacheSize -= it->second.size;
             textureCache.erase(it);
+            mStats.hits++;
         } else {
             // we don't, allocate a new texture and populate the in-use list
+            mStats.misses++;
             handle = mBackend.createTexture(
                     target, levels, format, samples, width, height, depth, usage);
             if (swizzle != defaultSwizzle) {
@@ -286,6 +289,24 @@ void ResourceAllocator::gc(bool const skippedFrame) noexcept {
             }
         }
     }
+
+    mStats.entries = uint32_t(textureCache.size());
+    mStats.cacheSize = mCacheSize;
+    mLastFrameStats = mStats;
+    mStats = {};
+
+    SYSTRACE_CONTEXT();
+    SYSTRACE_VALUE32("ResourceAllocator::hits", mLastFrameStats.hits);
+    SYSTRACE_VALUE32("ResourceAllocator::misses", mLastFrameStats.misses);
+    SYSTRACE_VALUE32("ResourceAllocator::evictions", mLastFrameStats.evictions);
+    SYSTRACE_VALUE32("ResourceAllocator::cacheSize", mLastFrameStats.cacheSize);
+}
+
+void ResourceAllocator::purgeCache() noexcept {
+    auto& textureCache = mTextureCache;
+    for (auto it = textureCache.begin(); it != textureCache.end();) {
+        it = purge(it);
+    }
 }
 
 UTILS_NOINLINE
@@ -312,6 +333,7 @@ ResourceAllocator::purge(
     //slog.d << "purging " << pos->second.handle.getId() << ", age=" << pos->second.age << io::endl;
     mBackend.destroyTexture(pos->second.handle);
     mCacheSize -= pos->second.size;
+    mStats.evictions++;
     return mTextureCache.erase(pos);
 }
 
@@ -115,6 +115,20 @@ public:
 
     void gc(bool skippedFrame = false) noexcept;
 
+    // destroys all the textures in the cache, e.g. in response to memory pressure
+    void purgeCache() noexcept;
+
+    struct Stats {
+        uint32_t hits = 0;          // textures found in the cache
+        uint32_t misses = 0;        // textures that had to be created
+        uint32_t evictions = 0;     // textures evicted from the cache
+        uint32_t entries = 0;       // textures in the cache at the end of the frame
+        uint32_t cacheSize = 0;     // estimated size of those textures in bytes
+    };
+
+    // statistics of the last frame, updated by gc()
+    Stats const& getStats() const noexcept { return mLastFrameStats; }
+
 private:
     size_t const mCacheMaxAge;
 
@@ -224,6 +238,8 @@ private:
     size_t mAge = 0;
     uint32_t mCacheSize = 0;
     uint32_t mCacheSizeHiWaterMark = 0;
+    Stats mStats;
+    Stats mLastFrameStats;
     static constexpr bool mEnabled = true;
 
     friend class ResourceAllocatorDisposer;
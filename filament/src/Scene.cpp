@@ -16,6 +16,7 @@
 
 #include "details/Scene.h"
 
+#include "details/Engine.h"
 #include "details/IndirectLight.h"
 #include "details/Skybox.h"
 
@@ -24,6 +25,7 @@ using namespace utils;
 namespace filament {
 
 void Scene::setSkybox(Skybox* skybox) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setSkybox(downcast(skybox));
 }
 
@@ -32,6 +34,7 @@ Skybox* Scene::getSkybox() const noexcept {
 }
 
 void Scene::setIndirectLight(IndirectLight* ibl) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setIndirectLight(downcast(ibl));
 }
 
@@ -40,22 +43,27 @@ IndirectLight* Scene::getIndirectLight() const noexcept {
 }
 
 void Scene::addEntity(Entity const entity) {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->addEntity(entity);
 }
 
 void Scene::addEntities(const Entity* entities, size_t const count) {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->addEntities(entities, count);
 }
 
 void Scene::remove(Entity const entity) {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->remove(entity);
 }
 
 void Scene::removeEntities(const Entity* entities, size_t const count) {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->removeEntities(entities, count);
 }
 
 void Scene::removeAllEntities() noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->removeAllEntities();
 }
 
@@ -79,4 +87,9 @@ void Scene::forEach(Invocable<void(Entity)>&& functor) const noexcept {
     downcast(this)->forEach(std::move(functor));
 }
 
+Scene::RaycastResult Scene::raycast(math::float3 const& origin, math::float3 const& direction,
+        float const maxDistance) const noexcept {
+    return downcast(this)->raycast(origin, direction, maxDistance);
+}
+
 } // namespace filament
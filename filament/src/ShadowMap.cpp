@@ -271,7 +271,7 @@ ShadowMap::ShaderParameters ShadowMap::updatePunctual(
     const mat4f Mp = mat4f::perspective(
             outerConeAngle * f::RAD_TO_DEG * 2.0f, 1.0f, nearPlane, farPlane);
 
-    assert_invariant(shadowMapInfo.textureDimension == mOptions->mapSize);
+    assert_invariant(shadowMapInfo.textureDimension == mDimension);
 
     // Final shadow transform
     const mat4f S = highPrecisionMultiply(Mp, Mv);
@@ -1296,9 +1296,11 @@ void ShadowMap::updateSceneInfoSpot(mat4f const& Mv, FScene const& scene,
             }
     );
 }
-void ShadowMap::setAllocation(uint8_t const layer, backend::Viewport viewport) noexcept {
+void ShadowMap::setAllocation(uint8_t const layer, backend::Viewport viewport,
+        uint16_t const dimension) noexcept {
     mLayer = layer;
     mOffset = { viewport.left, viewport.bottom };
+    mDimension = dimension;
 }
 
 backend::Viewport ShadowMap::getViewport() const noexcept {
@@ -1307,7 +1309,7 @@ backend::Viewport ShadowMap::getViewport() const noexcept {
     // or when shadowFar is smaller than the camera far.
     // For spot- and point-lights we also use a 1-texel border, so that bilinear filtering
     // can work properly if the shadowmap is in an atlas (and we can't rely on h/w clamp).
-    const uint32_t dim = mOptions->mapSize;
+    const uint32_t dim = mDimension;
     const uint16_t border = 1u;
     return { mOffset.x + border, mOffset.y + border, dim - 2u * border, dim - 2u * border };
 }
@@ -1319,7 +1321,7 @@ backend::Viewport ShadowMap::getScissor() const noexcept {
     // For spot- and point-lights we also use a 1-texel border, so that bilinear filtering
     // can work properly if the shadowmap is in an atlas (and we can't rely on h/w clamp), so we
     // don't scissor the border, so it gets filled with correct neighboring texels.
-    const uint32_t dim = mOptions->mapSize;
+    const uint32_t dim = mDimension;
     const uint16_t border = 1u;
     switch (mShadowType) {
         case ShadowType::DIRECTIONAL:
@@ -1348,7 +1350,7 @@ float4 ShadowMap::getClampToEdgeCoords(ShadowMapInfo const& shadowMapInfo) const
     }
 
     float const texel = 1.0f / float(shadowMapInfo.atlasDimension);
-    float const dim = float(mOptions->mapSize);
+    float const dim = float(mDimension);
     float const l = float(mOffset.x) + border;
     float const b = float(mOffset.y) + border;
     float const w = dim - 2.0f * border;
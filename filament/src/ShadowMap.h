@@ -179,9 +179,11 @@ public:
     LightManager::ShadowOptions const* getShadowOptions() const noexcept { return mOptions; }
     size_t getLightIndex() const { return mLightIndex; }
     uint16_t getShadowIndex() const { return mShadowIndex; }
-    void setAllocation(uint8_t layer, backend::Viewport viewport) noexcept;
+    void setAllocation(uint8_t layer, backend::Viewport viewport, uint16_t dimension) noexcept;
 
     uint8_t getLayer() const noexcept { return mLayer; }
+    // size of the shadow map in the texture, which can be smaller than ShadowOptions::mapSize
+    uint16_t getDimension() const noexcept { return mDimension; }
     backend::Viewport getViewport() const noexcept;
     backend::Viewport getScissor() const noexcept;
 
@@ -355,7 +357,8 @@ private:
     bool mHasVisibleShadows : 1;                                            // :1
     uint8_t mFace           : 3;                                            // :3
     math::ushort2 mOffset{};                                                // 4
-    UTILS_UNUSED uint8_t reserved[4];                                       // 4
+    uint16_t mDimension = 0;    // our size in the shadowMap texture        // 2
+    UTILS_UNUSED uint8_t reserved[2];                                       // 2
 };
 
 } // namespace filament
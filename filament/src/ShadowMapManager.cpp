@@ -69,6 +69,11 @@ namespace filament {
 using namespace backend;
 using namespace math;
 
+// Shadow maps render renderables one level of detail coarser than the main pass. Their level is
+// selected from the main camera, as the shadow camera's projection says nothing about how large
+// the renderable appears on screen.
+static constexpr uint8_t SHADOW_LOD_BIAS = 1;
+
 ShadowMapManager::ShadowMapManager(FEngine& engine)
     : mIsDepthClampSupported(engine.getDriverApi().isDepthClampSupported()) {
     FDebugRegistry& debugRegistry = engine.getDebugRegistry();
@@ -80,6 +85,7 @@ ShadowMapManager::ShadowMapManager(FEngine& engine)
             &engine.debug.shadowmap.depth_clamp);
 
     mFeatureShadowAllocator = engine.features.engine.shadows.use_shadow_atlas;
+    mFeatureCoverageBasedSize = engine.features.engine.shadows.use_coverage_based_size;
 }
 
 ShadowMapManager::~ShadowMapManager() {
@@ -159,7 +165,7 @@ ShadowMapManager::ShadowTechnique ShadowMapManager::update(
 
     ShadowTechnique shadowTechnique = {};
 
-    calculateTextureRequirements(engine, view, lightData);
+    calculateTextureRequirements(engine, view, cameraInfo, lightData);
 
     // Compute scene-dependent values shared across all shadow maps
     ShadowMap::SceneInfo const info{ *view.getScene(), view.getVisibleLayers() };
@@ -345,6 +351,9 @@ FrameGraphId<FrameGraphTexture> ShadowMapManager::render(FEngine& engine, FrameG
                 // pieces of state are needed only until shadowMap.render() returns.
                 // Conceptually, we could store this out-of-band.
 
+                // light positions may have changed since the last frame
+                mPointShadowFacesLightIndex = INVALID_LIGHT_INDEX;
+
                 // Generate a RenderPass for each shadow map
                 for (auto const& entry : data.passList) {
                     ShadowMap const& shadowMap = *entry.shadowMap;
@@ -394,7 +403,7 @@ FrameGraphId<FrameGraphTexture> ShadowMapManager::render(FEngine& engine, FrameG
 
                     // updatePrimitivesLod must be run before RenderPass::appendCommands.
                     FView::updatePrimitivesLod(scene->getRenderableData(),
-                            engine, cameraInfo, entry.range);
+                            engine, mainCameraInfo, entry.range, SHADOW_LOD_BIAS);
 
                     // generate and sort the commands for rendering the shadow map
 
@@ -615,9 +624,13 @@ ShadowMapManager::ShadowTechnique ShadowMapManager::updateCascadeShadowMaps(FEng
     auto& lcm = engine.getLightManager();
 
     FLightManager::Instance const directionalLight = lightData.elementAt<FScene::LIGHT_INSTANCE>(0);
-    FLightManager::ShadowOptions const& options = lcm.getShadowOptions(directionalLight);
     FLightManager::ShadowParams const& params = lcm.getShadowParams(directionalLight);
 
+    // The view may have given the cascades a reduced copy of the light's options.
+    utils::Slice<ShadowMap> cascadedShadowMaps = getCascadedShadowMap();
+    FLightManager::ShadowOptions const& options = cascadedShadowMaps.empty() ?
+            lcm.getShadowOptions(directionalLight) : *cascadedShadowMaps[0].getShadowOptions();
+
     // Adjust the camera's projection for the light's shadowFar
     if (UTILS_UNLIKELY(params.options.shadowFar > 0.0f)) {
         cameraInfo.zf = params.options.shadowFar;
@@ -634,7 +647,6 @@ ShadowMapManager::ShadowTechnique ShadowMapManager::updateCascadeShadowMaps(FEng
     };
 
     bool hasVisibleShadows = false;
-    utils::Slice<ShadowMap> cascadedShadowMaps = getCascadedShadowMap();
     if (!cascadedShadowMaps.empty()) {
         // Even if we have more than one cascade, we cull directional shadow casters against the
         // entire camera frustum, as if we only had a single cascade.
@@ -660,7 +672,7 @@ ShadowMapManager::ShadowTechnique ShadowMapManager::updateCascadeShadowMaps(FEng
 
         if (hasVisibleShadows) {
             Frustum const& frustum = shadowMap.getCamera().getCullingFrustum();
-            FView::cullRenderables(engine.getJobSystem(), renderableData, frustum,
+            FView::cullRenderables(engine.getJobSystem(), *scene, frustum,
                     VISIBLE_DIR_SHADOW_RENDERABLE_BIT);
         }
     }
@@ -803,8 +815,8 @@ void ShadowMapManager::prepareSpotShadowMap(ShadowMap& shadowMap, FEngine& engin
     // update the shadow map frustum/camera
     const ShadowMap::ShadowMapInfo shadowMapInfo{
             .atlasDimension      = mTextureAtlasRequirements.size,
-            .textureDimension    = uint16_t(options->mapSize),
-            .shadowDimension     = uint16_t(options->mapSize - 2u),
+            .textureDimension    = shadowMap.getDimension(),
+            .shadowDimension     = uint16_t(shadowMap.getDimension() - 2u),
             .textureSpaceFlipped = engine.getBackend() == Backend::METAL ||
                                    engine.getBackend() == Backend::VULKAN,
             .vsm                 = view.hasVSM()
@@ -895,8 +907,8 @@ void ShadowMapManager::preparePointShadowMap(ShadowMap& shadowMap,
     // update the shadow map frustum/camera
     const ShadowMap::ShadowMapInfo shadowMapInfo{
             .atlasDimension      = mTextureAtlasRequirements.size,
-            .textureDimension    = uint16_t(options->mapSize),
-            .shadowDimension     = uint16_t(options->mapSize), // point-lights don't have a border
+            .textureDimension    = shadowMap.getDimension(),
+            .shadowDimension     = shadowMap.getDimension(), // point-lights don't have a border
             .textureSpaceFlipped = engine.getBackend() == Backend::METAL ||
                                    engine.getBackend() == Backend::VULKAN,
             .vsm                 = view.hasVSM()
@@ -936,28 +948,43 @@ void ShadowMapManager::cullPointShadowMap(ShadowMap const& shadowMap, FView cons
     uint8_t const face = shadowMap.getFace();
     size_t const lightIndex = shadowMap.getLightIndex();
 
-    // compute the frustum for this light
-    // for spotlights, we cull shadow casters first because we already know the frustum,
-    // this will help us find better near/far plane later
-    auto const position = lightData.elementAt<FScene::POSITION_RADIUS>(lightIndex).xyz;
-    auto const radius = lightData.elementAt<FScene::POSITION_RADIUS>(lightIndex).w;
-
-    // compute shadow map frustum for culling
-    mat4f const Mv = ShadowMap::getPointLightViewMatrix(TextureCubemapFace(face), position);
-    mat4f const Mp = mat4f::perspective(90.0f, 1.0f, 0.01f, radius);
-    Frustum const frustum{ highPrecisionMultiply(Mp, Mv) };
-
-    // Cull shadow casters
     float3 const* worldAABBCenter = renderableData.data<FScene::WORLD_AABB_CENTER>();
     float3 const* worldAABBExtent = renderableData.data<FScene::WORLD_AABB_EXTENT>();
     FScene::VisibleMaskType* visibleArray = renderableData.data<FScene::VISIBLE_MASK>();
-    Culler::intersects(
-            visibleArray + range.first,
-            frustum,
-            worldAABBCenter + range.first,
-            worldAABBExtent + range.first,
-            range.size(),
-            VISIBLE_DYN_SHADOW_RENDERABLE_BIT);
+
+    // Shadow casters are culled against all the faces of the light in a single pass, the
+    // result is kept until a face of another light is culled.
+    if (mPointShadowFacesLightIndex != lightIndex) {
+        mPointShadowFacesLightIndex = lightIndex;
+
+        auto const position = lightData.elementAt<FScene::POSITION_RADIUS>(lightIndex).xyz;
+        auto const radius = lightData.elementAt<FScene::POSITION_RADIUS>(lightIndex).w;
+
+        // compute shadow map frustums for culling
+        mat4f const Mp = mat4f::perspective(90.0f, 1.0f, 0.01f, radius);
+        Culler::CubeFrustums frustums;
+        for (size_t f = 0; f < Culler::CUBE_FACE_COUNT; f++) {
+            mat4f const Mv = ShadowMap::getPointLightViewMatrix(TextureCubemapFace(f), position);
+            frustums[f] = Frustum{ highPrecisionMultiply(Mp, Mv) };
+        }
+
+        mPointShadowFaces.resize(Culler::round(range.size()));
+        Culler::intersectsCubeFaces(
+                mPointShadowFaces.data(),
+                frustums,
+                worldAABBCenter + range.first,
+                worldAABBExtent + range.first,
+                range.size());
+    }
+
+    // extract the visibility of this face
+    using Type = Culler::result_type;
+    for (size_t i = 0, c = range.size(); i < c; i++) {
+        Type const visible = (mPointShadowFaces[i] >> face) & 1u;
+        Type& mask = visibleArray[range.first + i];
+        mask &= ~Type(VISIBLE_DYN_SHADOW_RENDERABLE);
+        mask |= Type(visible << VISIBLE_DYN_SHADOW_RENDERABLE_BIT);
+    }
 
     // update their visibility mask
     uint8_t const* layers = renderableData.data<FScene::LAYERS>();
@@ -1011,8 +1038,36 @@ ShadowMapManager::ShadowTechnique ShadowMapManager::updateSpotShadowMaps(FEngine
     return shadowTechnique;
 }
 
+uint16_t ShadowMapManager::computeCoverageBasedSize(CameraInfo const& cameraInfo,
+        filament::Viewport const& viewport, float4 const& sphere,
+        uint16_t const mapSize, uint16_t const minDimension) noexcept {
+    // orthographic projections are not handled, the light gets its full resolution
+    mat4f const& projection = cameraInfo.projection;
+    if (projection[2][3] == 0.0f) {
+        return mapSize;
+    }
+
+    // the camera is inside the light's influence, the light gets its full resolution
+    float const r = sphere.w;
+    float const d2 = length2(sphere.xyz - cameraInfo.getPosition());
+    if (d2 <= r * r) {
+        return mapSize;
+    }
+
+    // diameter in pixels of the light's bounding sphere, projected on the screen. We don't take
+    // the frustum into account, a light partially outside the viewport keeps its full size.
+    float const coverage = r * projection[1][1] * float(viewport.height) / std::sqrt(d2 - r * r);
+
+    // halve the size as long as the shadow map stays larger than the light on screen
+    uint16_t size = mapSize;
+    while (size / 2u >= minDimension && float(size / 2u) >= coverage) {
+        size /= 2u;
+    }
+    return size;
+}
+
 void ShadowMapManager::calculateTextureRequirements(FEngine& engine, FView& view,
-        FScene::LightSoa const&) noexcept {
+        CameraInfo const& cameraInfo, FScene::LightSoa const& lightData) noexcept {
 
     uint32_t maxDimension = 0;
     bool elvsm = false;
@@ -1034,22 +1089,21 @@ void ShadowMapManager::calculateTextureRequirements(FEngine& engine, FView& view
 
     std::function const allocateFromAtlas =
             [&layersNeeded, allocator = AtlasAllocator{ maxDimension }](
-        ShadowMap* pShadowMap) mutable {
+        ShadowMap* pShadowMap, uint16_t const dimension) mutable {
         // Allocate shadowmap from our Atlas Allocator
-        auto const& options = pShadowMap->getShadowOptions();
-        auto [layer, pos] = allocator.allocate(options->mapSize);
+        auto [layer, pos] = allocator.allocate(dimension);
         assert_invariant(layer >= 0);
         assert_invariant(!pos.empty());
-        pShadowMap->setAllocation(layer, pos);
+        pShadowMap->setAllocation(layer, pos, dimension);
         layersNeeded = std::max(uint8_t(layer + 1), layersNeeded);
     };
 
     std::function const allocateFromTextureArray =
-            [&layersNeeded, layer = 0](ShadowMap* pShadowMap) mutable {
+            [&layersNeeded, layer = 0](ShadowMap* pShadowMap, uint16_t const dimension) mutable {
         // Layout the shadow maps. For now, we take the largest requested dimension and allocate a
         // texture of that size. Each cascade / shadow map gets its own layer in the array texture.
         // The directional shadow cascades start on layer 0, followed by spotlights.
-        pShadowMap->setAllocation(layer, {});
+        pShadowMap->setAllocation(layer, {}, dimension);
         layersNeeded = ++layer;
     };
 
@@ -1057,10 +1111,39 @@ void ShadowMapManager::calculateTextureRequirements(FEngine& engine, FView& view
         allocateFromAtlas : allocateFromTextureArray;
 
     for (ShadowMap& shadowMap : getCascadedShadowMap()) {
-        allocateShadowmapTexture(&shadowMap);
+        allocateShadowmapTexture(&shadowMap, uint16_t(shadowMap.getShadowOptions()->mapSize));
+    }
+
+    // With the atlas, spot and point lights that cover a small part of the screen get a smaller
+    // shadow map. All the faces of a point light get the same size.
+    struct SpotAllocation {
+        ShadowMap* shadowMap;
+        uint16_t dimension;
+    };
+    std::array<SpotAllocation, CONFIG_MAX_SHADOWMAPS> spotAllocations;
+    size_t const spotCount = getSpotShadowMaps().size();
+    uint16_t const minDimension = uint16_t(maxDimension >> (AtlasAllocator::SIZE_COUNT - 1u));
+    for (size_t i = 0; i < spotCount; i++) {
+        ShadowMap& shadowMap = getSpotShadowMaps()[i];
+        uint16_t dimension = uint16_t(shadowMap.getShadowOptions()->mapSize);
+        if (mFeatureShadowAllocator && mFeatureCoverageBasedSize) {
+            dimension = computeCoverageBasedSize(cameraInfo, view.getViewport(),
+                    lightData.elementAt<FScene::POSITION_RADIUS>(shadowMap.getLightIndex()),
+                    dimension, std::max(minDimension, uint16_t(16u)));
+        }
+        spotAllocations[i] = { &shadowMap, dimension };
     }
-    for (ShadowMap& shadowMap : getSpotShadowMaps()) {
-        allocateShadowmapTexture(&shadowMap);
+
+    if (mFeatureShadowAllocator) {
+        // The quadtree packs best when the largest shadow maps are allocated first.
+        std::stable_sort(spotAllocations.begin(), spotAllocations.begin() + spotCount,
+                [](SpotAllocation const& lhs, SpotAllocation const& rhs) {
+                    return lhs.dimension > rhs.dimension;
+                });
+    }
+
+    for (size_t i = 0; i < spotCount; i++) {
+        allocateShadowmapTexture(spotAllocations[i].shadowMap, spotAllocations[i].dimension);
     }
 
     // Generate mipmaps for VSM when anisotropy is enabled or when requested
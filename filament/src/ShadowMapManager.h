@@ -50,6 +50,7 @@
 #include <math/vec4.h>
 
 #include <array>
+#include <limits>
 #include <memory>
 #include <new>
 #include <type_traits>
@@ -160,8 +161,14 @@ private:
     ShadowTechnique updateSpotShadowMaps(FEngine& engine,
             FScene::LightSoa const& lightData) const noexcept;
 
-    void calculateTextureRequirements(FEngine&, FView& view,
-            FScene::LightSoa const&) noexcept;
+    void calculateTextureRequirements(FEngine&, FView& view, CameraInfo const& cameraInfo,
+            FScene::LightSoa const& lightData) noexcept;
+
+    // Returns the shadow map size of a spot or point light, based on its screen coverage.
+    // minDimension is the smallest size the atlas can allocate.
+    static uint16_t computeCoverageBasedSize(CameraInfo const& cameraInfo,
+            Viewport const& viewport, math::float4 const& sphere,
+            uint16_t mapSize, uint16_t minDimension) noexcept;
 
     void prepareSpotShadowMap(ShadowMap& shadowMap,
             FEngine& engine, FView& view, CameraInfo const& mainCameraInfo,
@@ -176,7 +183,7 @@ private:
             FEngine& engine, FView& view, CameraInfo const& mainCameraInfo,
             FScene::LightSoa const& lightData) const noexcept;
 
-    static void cullPointShadowMap(ShadowMap const& shadowMap, FView const& view,
+    void cullPointShadowMap(ShadowMap const& shadowMap, FView const& view,
             FScene::RenderableSoa& renderableData, utils::Range<uint32_t> range,
             FScene::LightSoa const& lightData) noexcept;
 
@@ -238,6 +245,12 @@ private:
     bool const mIsDepthClampSupported;
     bool mInitialized = false;
     bool mFeatureShadowAllocator = false;
+    bool mFeatureCoverageBasedSize = false;
+
+    // visibility of each shadow caster in the faces of the last point light culled
+    static constexpr size_t INVALID_LIGHT_INDEX = std::numeric_limits<size_t>::max();
+    std::vector<Culler::result_type> mPointShadowFaces;
+    size_t mPointShadowFacesLightIndex = INVALID_LIGHT_INDEX;
 
     ShadowMap& getShadowMap(size_t const index) noexcept {
         assert_invariant(index < mShadowMapCache.size());
@@ -25,11 +25,13 @@ using namespace math;
 
 void SkinningBuffer::setBones(Engine& engine,
         RenderableManager::Bone const* transforms, size_t const count, size_t const offset) {
+    downcast(engine).markContentChanged();
     downcast(this)->setBones(downcast(engine), transforms, count, offset);
 }
 
 void SkinningBuffer::setBones(Engine& engine,
         mat4f const* transforms, size_t const count, size_t const offset) {
+    downcast(engine).markContentChanged();
     downcast(this)->setBones(downcast(engine), transforms, count, offset);
 }
 
@@ -49,32 +49,48 @@ void Texture::setImage(Engine& engine, size_t const level,
         uint32_t const xoffset, uint32_t const yoffset, uint32_t const zoffset,
         uint32_t const width, uint32_t const height, uint32_t const depth,
         PixelBufferDescriptor&& buffer) const {
+    downcast(engine).markContentChanged();
     downcast(this)->setImage(downcast(engine),
             level, xoffset, yoffset, zoffset, width, height, depth, std::move(buffer));
 }
 
+void Texture::setImageAsync(Engine& engine, size_t const level,
+        uint32_t const xoffset, uint32_t const yoffset, uint32_t const zoffset,
+        uint32_t const width, uint32_t const height, uint32_t const depth,
+        PixelBufferDescriptor&& buffer) const {
+    downcast(engine).markContentChanged();
+    downcast(this)->setImageAsync(downcast(engine),
+            level, xoffset, yoffset, zoffset, width, height, depth, std::move(buffer));
+}
+
 void Texture::setImage(Engine& engine, size_t const level,
         PixelBufferDescriptor&& buffer, const FaceOffsets& faceOffsets) const {
+    downcast(engine).markContentChanged();
     downcast(this)->setImage(downcast(engine), level, std::move(buffer), faceOffsets);
 }
 
 void Texture::setExternalImage(Engine& engine, ExternalImageHandleRef image) noexcept {
+    downcast(engine).markContentChanged();
     downcast(this)->setExternalImage(downcast(engine), image);
 }
 
 void Texture::setExternalImage(Engine& engine, void* image) noexcept {
+    downcast(engine).markContentChanged();
     downcast(this)->setExternalImage(downcast(engine), image);
 }
 
 void Texture::setExternalImage(Engine& engine, void* image, size_t const plane) noexcept {
+    downcast(engine).markContentChanged();
     downcast(this)->setExternalImage(downcast(engine), image, plane);
 }
 
 void Texture::setExternalStream(Engine& engine, Stream* stream) noexcept {
+    downcast(engine).markContentChanged();
     downcast(this)->setExternalStream(downcast(engine), downcast(stream));
 }
 
 void Texture::generateMipmaps(Engine& engine) const noexcept {
+    downcast(engine).markContentChanged();
     downcast(this)->generateMipmaps(downcast(engine));
 }
 
@@ -99,8 +115,24 @@ size_t Texture::computeTextureDataSize(Format const format, Type const type, siz
     return FTexture::computeTextureDataSize(format, type, stride, height, alignment);
 }
 
+void Texture::generateMipmaps(Engine& engine, PixelBufferDescriptor&& buffer) const {
+    downcast(engine).markContentChanged();
+    downcast(this)->generateMipmaps(downcast(engine), std::move(buffer));
+}
+
+void Texture::commitPages(Engine& engine, size_t const level, uint32_t const xoffset,
+        uint32_t const yoffset, uint32_t const width, uint32_t const height) const {
+    downcast(this)->commitPages(downcast(engine), level, xoffset, yoffset, width, height, true);
+}
+
+void Texture::decommitPages(Engine& engine, size_t const level, uint32_t const xoffset,
+        uint32_t const yoffset, uint32_t const width, uint32_t const height) const {
+    downcast(this)->commitPages(downcast(engine), level, xoffset, yoffset, width, height, false);
+}
+
 void Texture::generatePrefilterMipmap(Engine& engine, PixelBufferDescriptor&& buffer,
         const FaceOffsets& faceOffsets, PrefilterOptions const* options) {
+    downcast(engine).markContentChanged();
     downcast(this)->generatePrefilterMipmap(downcast(engine), std::move(buffer), faceOffsets, options);
 }
 
@@ -116,4 +148,9 @@ size_t Texture::getMaxArrayTextureLayers(Engine& engine) noexcept {
     return FTexture::getMaxArrayTextureLayers(downcast(engine));
 }
 
+math::uint2 Texture::getSparsePageSize(Engine& engine, Sampler const type,
+        InternalFormat const format) noexcept {
+    return FTexture::getSparsePageSize(downcast(engine), type, format);
+}
+
 } // namespace filament
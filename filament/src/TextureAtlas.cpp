@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "details/TextureAtlas.h"
+
+#include "details/Engine.h"
+#include "details/Texture.h"
+
+#include <utility>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace filament {
+
+TextureAtlas::Region TextureAtlas::add(Engine& engine, uint32_t const width,
+        uint32_t const height, Texture::PixelBufferDescriptor&& buffer) {
+    return downcast(this)->add(downcast(engine), width, height, std::move(buffer));
+}
+
+void TextureAtlas::clear() noexcept {
+    downcast(this)->clear();
+}
+
+Texture* TextureAtlas::getTexture() const noexcept {
+    return downcast(this)->getTexture();
+}
+
+size_t TextureAtlas::getRegionCount() const noexcept {
+    return downcast(this)->getRegionCount();
+}
+
+} // namespace filament
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TextureUploadQueue.h"
+
+#include "details/Texture.h"
+
+#include <private/backend/CommandStream.h>
+
+#include <backend/DriverEnums.h>
+
+#include <utils/debug.h>
+#include <utils/Systrace.h>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace filament {
+
+using namespace backend;
+
+void TextureUploadQueue::push(FTexture const* texture, uint8_t const level,
+        uint32_t const xoffset, uint32_t const yoffset, uint32_t const zoffset,
+        uint32_t const width, uint32_t const height, uint32_t const depth,
+        PixelBufferDescriptor&& buffer) {
+    // compressed images are uploaded in a single chunk, bytesPerRow is 0
+    size_t const bytesPerRow = buffer.type == PixelDataType::COMPRESSED ? 0 :
+            PixelBufferDescriptor::computeDataSize(buffer.format, buffer.type,
+                    buffer.stride ? buffer.stride : width, 1, buffer.alignment);
+    mPendingSize += bytesPerRow ? bytesPerRow * height * depth : buffer.size;
+    mQueue.push_back({
+            .texture = texture, .level = level,
+            .xoffset = xoffset, .yoffset = yoffset, .zoffset = zoffset,
+            .width = width, .height = height, .depth = depth,
+            .buffer = std::move(buffer),
+            .bytesPerRow = bytesPerRow });
+}
+
+void TextureUploadQueue::process(DriverApi& driver) {
+    if (mQueue.empty()) {
+        return;
+    }
+
+    SYSTRACE_CALL();
+
+    size_t remaining = mBudget ? mBudget : std::numeric_limits<size_t>::max();
+    bool issued = false;
+
+    while (!mQueue.empty()) {
+        Upload& u = mQueue.front();
+        PixelBufferDescriptor& p = u.buffer;
+        size_t const bytesPerLayer = u.bytesPerRow * u.height;
+
+        // the chunk to upload, in rows and layers of the image
+        size_t offset, size;
+        uint32_t rows, layers;
+        if (!u.bytesPerRow) {
+            if (issued && p.size > remaining) {
+                break;
+            }
+            offset = 0;
+            size = p.size;
+            rows = u.height;
+            layers = u.depth;
+        } else if (u.row == 0 && bytesPerLayer <= remaining) {
+            // as many whole layers as the budget allows
+            rows = u.height;
+            layers = uint32_t(std::min(size_t(u.depth - u.layer), remaining / bytesPerLayer));
+            offset = p.top * u.bytesPerRow + u.layer * bytesPerLayer;
+            size = bytesPerLayer * layers;
+        } else {
+            // a run of rows of the current layer, at least one to guarantee progress
+            if (issued && u.bytesPerRow > remaining) {
+                break;
+            }
+            rows = uint32_t(std::clamp(remaining / u.bytesPerRow,
+                    size_t(1), size_t(u.height - u.row)));
+            layers = 1;
+            offset = (p.top + u.row) * u.bytesPerRow + u.layer * bytesPerLayer;
+            size = u.bytesPerRow * rows;
+        }
+
+        PixelBufferDescriptor chunk = u.bytesPerRow ?
+                PixelBufferDescriptor{ (char const*)p.buffer + offset, size,
+                        p.format, p.type, p.alignment, p.left, 0, p.stride } :
+                PixelBufferDescriptor{ p.buffer, p.size, p.compressedFormat, p.imageSize, nullptr };
+
+        uint32_t const y = u.row;
+        uint32_t const z = u.layer;
+        u.row += rows;
+        if (u.row == u.height) {
+            u.row = 0;
+            u.layer += layers;
+        }
+        bool const last = u.layer == u.depth;
+        if (last) {
+            // the client buffer is released with the last chunk, through its own handler
+            auto* const buffer = new PixelBufferDescriptor(std::move(p));
+            chunk.setCallback(buffer->getHandler(), [](void*, size_t, void* user) {
+                delete static_cast<PixelBufferDescriptor*>(user);
+            }, buffer);
+        }
+
+        driver.update3DImage(u.texture->getHwHandle(), u.level,
+                u.xoffset, u.yoffset + y, u.zoffset + z,
+                u.width, rows, layers, std::move(chunk));
+
+        issued = true;
+        remaining -= std::min(remaining, size);
+        mPendingSize -= std::min(mPendingSize, size);
+
+        if (last) {
+            // the level can be sampled now
+            const_cast<FTexture*>(u.texture)->updateLodRange(u.level);
+            mQueue.pop_front();
+        }
+        if (!remaining) {
+            break;
+        }
+    }
+}
+
+void TextureUploadQueue::cancel(DriverApi& driver, FTexture const* texture) {
+    for (auto it = mQueue.begin(); it != mQueue.end();) {
+        if (it->texture != texture) {
+            ++it;
+            continue;
+        }
+        Upload& u = *it;
+        size_t const size = u.bytesPerRow ? u.bytesPerRow * u.height * u.depth : u.buffer.size;
+        size_t const uploaded = u.bytesPerRow * (u.height * u.layer + u.row);
+        mPendingSize -= std::min(mPendingSize, size - uploaded);
+
+        // The chunks already issued reference the buffer, so it must be released after them.
+        // Commands execute in order, so a command queued now runs after all of them.
+        auto* const buffer = new PixelBufferDescriptor(std::move(u.buffer));
+        driver.queueCommand([buffer]() {
+            delete buffer;
+        });
+        it = mQueue.erase(it);
+    }
+}
+
+} // namespace filament
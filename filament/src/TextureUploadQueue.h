@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_TEXTUREUPLOADQUEUE_H
+#define TNT_FILAMENT_TEXTUREUPLOADQUEUE_H
+
+#include <backend/DriverApiForward.h>
+#include <backend/PixelBufferDescriptor.h>
+
+#include <deque>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace filament {
+
+class FTexture;
+
+/*
+ * Spreads texture uploads over several frames. Each frame, process() issues at most `budget`
+ * bytes worth of update3DImage() commands, so that large images don't spike the CPU (copies
+ * into staging memory) and GPU cost of a single frame.
+ *
+ * Images are split in runs of rows, or of whole layers when they fit. The chunks reference the
+ * client buffer, which is only released after its last chunk, so its callback signals that the
+ * whole image has been uploaded.
+ *
+ * Must be used from the engine's thread only.
+ */
+class TextureUploadQueue {
+public:
+    using PixelBufferDescriptor = backend::PixelBufferDescriptor;
+
+    // A budget of 0 means that everything is uploaded in the next process().
+    explicit TextureUploadQueue(size_t budget) noexcept : mBudget(budget) {}
+
+    TextureUploadQueue(TextureUploadQueue const&) = delete;
+    TextureUploadQueue& operator=(TextureUploadQueue const&) = delete;
+
+    // The region must have been validated already.
+    void push(FTexture const* texture, uint8_t level,
+            uint32_t xoffset, uint32_t yoffset, uint32_t zoffset,
+            uint32_t width, uint32_t height, uint32_t depth,
+            PixelBufferDescriptor&& buffer);
+
+    // Issues the upload commands for this frame.
+    void process(backend::DriverApi& driver);
+
+    // Drops the uploads of a texture that's being destroyed.
+    void cancel(backend::DriverApi& driver, FTexture const* texture);
+
+    bool empty() const noexcept { return mQueue.empty(); }
+
+    // Number of bytes not uploaded yet.
+    size_t getPendingSize() const noexcept { return mPendingSize; }
+
+private:
+    struct Upload {
+        FTexture const* texture;
+        uint8_t level;
+        uint32_t xoffset, yoffset, zoffset;
+        uint32_t width, height, depth;
+        PixelBufferDescriptor buffer;
+        size_t bytesPerRow;
+        // progress, in rows of the current layer and in layers
+        uint32_t row = 0;
+        uint32_t layer = 0;
+    };
+
+    std::deque<Upload> mQueue;
+    size_t const mBudget;
+    size_t mPendingSize = 0;
+};
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_TEXTUREUPLOADQUEUE_H
@@ -58,6 +58,15 @@ void TransformManager::create(Entity const entity, Instance const parent) {
     downcast(this)->create(entity, parent, mat4f{});
 }
 
+void TransformManager::create(size_t const count, Entity const* entities,
+        Instance const parent, const mat4f& localTransform) {
+    downcast(this)->create(count, entities, parent, localTransform);
+}
+
+void TransformManager::create(size_t const count, Entity const* entities, Instance const parent) {
+    downcast(this)->create(count, entities, parent, mat4f{});
+}
+
 void TransformManager::destroy(Entity const e) noexcept {
     downcast(this)->destroy(e);
 }
@@ -111,6 +120,10 @@ void TransformManager::commitLocalTransformTransaction() noexcept {
     downcast(this)->commitLocalTransformTransaction();
 }
 
+void TransformManager::commitLocalTransformTransaction(JobSystem& js) noexcept {
+    downcast(this)->commitLocalTransformTransaction(js);
+}
+
 TransformManager::children_iterator TransformManager::getChildrenBegin(
         Instance const parent) const noexcept {
     return downcast(this)->getChildrenBegin(parent);
@@ -26,7 +26,8 @@ namespace filament {
 UniformBuffer::UniformBuffer(size_t const size) noexcept
         : mBuffer(mStorage),
           mSize(uint32_t(size)),
-          mSomethingDirty(true) {
+          mDirtyBegin(0),
+          mDirtyEnd(uint32_t(size)) {
     if (UTILS_LIKELY(size > sizeof(mStorage))) {
         mBuffer = alloc(size);
     }
@@ -36,7 +37,8 @@ UniformBuffer::UniformBuffer(size_t const size) noexcept
 UniformBuffer::UniformBuffer(UniformBuffer&& rhs) noexcept
         : mBuffer(rhs.mBuffer),
           mSize(rhs.mSize),
-          mSomethingDirty(rhs.mSomethingDirty) {
+          mDirtyBegin(rhs.mDirtyBegin),
+          mDirtyEnd(rhs.mDirtyEnd) {
     if (UTILS_LIKELY(rhs.isLocalStorage())) {
         mBuffer = mStorage;
         memcpy(mBuffer, rhs.mBuffer, mSize);
@@ -47,7 +49,8 @@ UniformBuffer::UniformBuffer(UniformBuffer&& rhs) noexcept
 
 UniformBuffer& UniformBuffer::operator=(UniformBuffer&& rhs) noexcept {
     if (this != &rhs) {
-        mSomethingDirty = rhs.mSomethingDirty;
+        mDirtyBegin = rhs.mDirtyBegin;
+        mDirtyEnd = rhs.mDirtyEnd;
         if (UTILS_LIKELY(rhs.isLocalStorage())) {
             mBuffer = mStorage;
             mSize = rhs.mSize;
@@ -158,7 +161,8 @@ void UniformBuffer::setUniform(void* addr, size_t const offset, const mat3f& v)
 
 template<>
 void UniformBuffer::setUniform(size_t const offset, const mat3f& v) noexcept {
-    setUniform(invalidateUniforms(offset, sizeof(v)), 0, v);
+    // a mat3 spans three float4 columns, without the last float of the last column
+    setUniform(invalidateUniforms(offset, sizeof(float4) * 2 + sizeof(float3)), 0, v);
 }
 
 #if !defined(NDEBUG)
@@ -26,11 +26,13 @@ size_t VertexBuffer::getVertexCount() const noexcept {
 
 void VertexBuffer::setBufferAt(Engine& engine, uint8_t const bufferIndex,
         backend::BufferDescriptor&& buffer, uint32_t const byteOffset) {
+    downcast(engine).markContentChanged();
     downcast(this)->setBufferAt(downcast(engine), bufferIndex, std::move(buffer), byteOffset);
 }
 
 void VertexBuffer::setBufferObjectAt(Engine& engine, uint8_t const bufferIndex,
         BufferObject const* bufferObject) {
+    downcast(engine).markContentChanged();
     downcast(this)->setBufferObjectAt(downcast(engine), bufferIndex, downcast(bufferObject));
 }
 
@@ -17,10 +17,12 @@
 #include "details/View.h"
 #include "filament/View.h"
 
+#include <utility>
 
 namespace filament {
 
 void View::setScene(Scene* scene) {
+    downcast(this)->getEngine().markContentChanged();
     return downcast(this)->setScene(downcast(scene));
 }
 
@@ -30,6 +32,7 @@ Scene* View::getScene() noexcept {
 
 
 void View::setCamera(Camera* camera) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setCameraUser(downcast(camera));
 }
 
@@ -41,7 +44,12 @@ Camera& View::getCamera() noexcept {
     return downcast(this)->getCameraUser();
 }
 
+void View::setLateLatchCallback(LateLatchCallback&& callback) noexcept {
+    downcast(this)->setLateLatchCallback(std::move(callback));
+}
+
 void View::setViewport(Viewport const& viewport) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setViewport(viewport);
 }
 
@@ -50,6 +58,7 @@ Viewport const& View::getViewport() const noexcept {
 }
 
 void View::setFrustumCullingEnabled(bool const culling) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setFrustumCullingEnabled(culling);
 }
 
@@ -58,10 +67,12 @@ bool View::isFrustumCullingEnabled() const noexcept {
 }
 
 void View::setDebugCamera(Camera* camera) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setViewingCamera(downcast(camera));
 }
 
 void View::setVisibleLayers(uint8_t const select, uint8_t const values) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setVisibleLayers(select, values);
 }
 
@@ -78,10 +89,12 @@ utils::FixedCapacityVector<Camera const*> View::getDirectionalShadowCameras() co
 }
 
 void View::setShadowingEnabled(bool const enabled) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setShadowingEnabled(enabled);
 }
 
 void View::setRenderTarget(RenderTarget* renderTarget) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setRenderTarget(downcast(renderTarget));
 }
 
@@ -90,6 +103,7 @@ RenderTarget* View::getRenderTarget() const noexcept {
 }
 
 void View::setSampleCount(uint8_t const count) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setSampleCount(count);
 }
 
@@ -98,6 +112,7 @@ uint8_t View::getSampleCount() const noexcept {
 }
 
 void View::setAntiAliasing(AntiAliasing const type) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setAntiAliasing(type);
 }
 
@@ -106,6 +121,7 @@ View::AntiAliasing View::getAntiAliasing() const noexcept {
 }
 
 void View::setTemporalAntiAliasingOptions(TemporalAntiAliasingOptions options) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setTemporalAntiAliasingOptions(options);
 }
 
@@ -114,6 +130,7 @@ const View::TemporalAntiAliasingOptions& View::getTemporalAntiAliasingOptions()
 }
 
 void View::setMultiSampleAntiAliasingOptions(MultiSampleAntiAliasingOptions const options) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setMultiSampleAntiAliasingOptions(options);
 }
 
@@ -122,6 +139,7 @@ const View::MultiSampleAntiAliasingOptions& View::getMultiSampleAntiAliasingOpti
 }
 
 void View::setScreenSpaceReflectionsOptions(ScreenSpaceReflectionsOptions options) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setScreenSpaceReflectionsOptions(options);
 }
 
@@ -130,6 +148,7 @@ const View::ScreenSpaceReflectionsOptions& View::getScreenSpaceReflectionsOption
 }
 
 void View::setGuardBandOptions(GuardBandOptions const options) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setGuardBandOptions(options);
 }
 
@@ -138,6 +157,7 @@ GuardBandOptions const& View::getGuardBandOptions() const noexcept {
 }
 
 void View::setColorGrading(ColorGrading* colorGrading) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     return downcast(this)->setColorGrading(downcast(colorGrading));
 }
 
@@ -146,6 +166,7 @@ const ColorGrading* View::getColorGrading() const noexcept {
 }
 
 void View::setDithering(Dithering const dithering) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setDithering(dithering);
 }
 
@@ -153,7 +174,17 @@ View::Dithering View::getDithering() const noexcept {
     return downcast(this)->getDithering();
 }
 
+void View::setDepthPrepass(DepthPrepass const prepass) noexcept {
+    downcast(this)->getEngine().markContentChanged();
+    downcast(this)->setDepthPrepass(prepass);
+}
+
+View::DepthPrepass View::getDepthPrepass() const noexcept {
+    return downcast(this)->getDepthPrepass();
+}
+
 void View::setDynamicResolutionOptions(const DynamicResolutionOptions& options) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setDynamicResolutionOptions(options);
 }
 
@@ -162,6 +193,7 @@ View::DynamicResolutionOptions View::getDynamicResolutionOptions() const noexcep
 }
 
 void View::setRenderQuality(const RenderQuality& renderQuality) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setRenderQuality(renderQuality);
 }
 
@@ -170,6 +202,7 @@ View::RenderQuality View::getRenderQuality() const noexcept {
 }
 
 void View::setPostProcessingEnabled(bool const enabled) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setPostProcessingEnabled(enabled);
 }
 
@@ -178,6 +211,7 @@ bool View::isPostProcessingEnabled() const noexcept {
 }
 
 void View::setFrontFaceWindingInverted(bool const inverted) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setFrontFaceWindingInverted(inverted);
 }
 
@@ -186,6 +220,7 @@ bool View::isFrontFaceWindingInverted() const noexcept {
 }
 
 void View::setTransparentPickingEnabled(bool const enabled) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setTransparentPickingEnabled(enabled);
 }
 
@@ -194,10 +229,12 @@ bool View::isTransparentPickingEnabled() const noexcept {
 }
 
 void View::setDynamicLightingOptions(float const zLightNear, float const zLightFar) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setDynamicLightingOptions(zLightNear, zLightFar);
 }
 
 void View::setShadowType(ShadowType const shadow) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setShadowType(shadow);
 }
 
@@ -206,6 +243,7 @@ View::ShadowType View::getShadowType() const noexcept {
 }
 
 void View::setVsmShadowOptions(VsmShadowOptions const& options) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setVsmShadowOptions(options);
 }
 
@@ -214,6 +252,7 @@ View::VsmShadowOptions View::getVsmShadowOptions() const noexcept {
 }
 
 void View::setSoftShadowOptions(SoftShadowOptions const& options) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setSoftShadowOptions(options);
 }
 
@@ -222,6 +261,7 @@ SoftShadowOptions View::getSoftShadowOptions() const noexcept {
 }
 
 void View::setAmbientOcclusion(AmbientOcclusion const ambientOcclusion) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setAmbientOcclusion(ambientOcclusion);
 }
 
@@ -230,6 +270,7 @@ View::AmbientOcclusion View::getAmbientOcclusion() const noexcept {
 }
 
 void View::setAmbientOcclusionOptions(AmbientOcclusionOptions const& options) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setAmbientOcclusionOptions(options);
 }
 
@@ -238,6 +279,7 @@ View::AmbientOcclusionOptions const& View::getAmbientOcclusionOptions() const no
 }
 
 void View::setBloomOptions(BloomOptions options) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setBloomOptions(options);
 }
 
@@ -246,6 +288,7 @@ View::BloomOptions View::getBloomOptions() const noexcept {
 }
 
 void View::setFogOptions(FogOptions options) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setFogOptions(options);
 }
 
@@ -254,6 +297,7 @@ View::FogOptions View::getFogOptions() const noexcept {
 }
 
 void View::setDepthOfFieldOptions(DepthOfFieldOptions options) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setDepthOfFieldOptions(options);
 }
 
@@ -262,6 +306,7 @@ View::DepthOfFieldOptions View::getDepthOfFieldOptions() const noexcept {
 }
 
 void View::setVignetteOptions(VignetteOptions options) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setVignetteOptions(options);
 }
 
@@ -270,6 +315,7 @@ View::VignetteOptions View::getVignetteOptions() const noexcept {
 }
 
 void View::setBlendMode(BlendMode const blendMode) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setBlendMode(blendMode);
 }
 
@@ -286,6 +332,7 @@ bool View::isShadowingEnabled() const noexcept {
 }
 
 void View::setScreenSpaceRefractionEnabled(bool const enabled) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setScreenSpaceRefractionEnabled(enabled);
 }
 
@@ -293,7 +340,17 @@ bool View::isScreenSpaceRefractionEnabled() const noexcept {
     return downcast(this)->isScreenSpaceRefractionEnabled();
 }
 
+void View::setOrderIndependentBlendingEnabled(bool const enabled) noexcept {
+    downcast(this)->getEngine().markContentChanged();
+    downcast(this)->setOrderIndependentBlendingEnabled(enabled);
+}
+
+bool View::isOrderIndependentBlendingEnabled() const noexcept {
+    return downcast(this)->isOrderIndependentBlendingEnabled();
+}
+
 void View::setStencilBufferEnabled(bool const enabled) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setStencilBufferEnabled(enabled);
 }
 
@@ -302,6 +359,7 @@ bool View::isStencilBufferEnabled() const noexcept {
 }
 
 void View::setStereoscopicOptions(const StereoscopicOptions& options) noexcept {
+    downcast(this)->getEngine().markContentChanged();
     return downcast(this)->setStereoscopicOptions(options);
 }
 
@@ -315,6 +373,7 @@ View::PickingQuery& View::pick(uint32_t const x, uint32_t const y, backend::Call
 }
 
 void View::setMaterialGlobal(uint32_t const index, math::float4 const& value) {
+    downcast(this)->getEngine().markContentChanged();
     downcast(this)->setMaterialGlobal(index, value);
 }
 
@@ -42,6 +42,8 @@ public:
 
     void init(FEngine& engine) noexcept;
 
+    FEngine& getEngine() const noexcept { return mEngine; }
+
     void terminate() noexcept;
 
     void gc(utils::EntityManager& em) noexcept;
@@ -62,6 +64,11 @@ public:
         return mManager.getComponentCount();
     }
 
+    // changes whenever the instance of an entity may have changed
+    uint32_t getVersion() const noexcept {
+        return mManager.getVersion();
+    }
+
     bool empty() const noexcept {
         return mManager.empty();
     }
@@ -39,6 +39,7 @@
 #include <backend/DriverEnums.h>
 #include <backend/Handle.h>
 
+#include <utils/algorithm.h>
 #include <utils/compiler.h>
 #include <utils/debug.h>
 #include <utils/EntityManager.h>
@@ -54,6 +55,7 @@
 #include <math/vec4.h>
 
 #include <algorithm>
+#include <array>
 #include <memory>
 #include <unordered_map>
 #include <utility>
@@ -96,6 +98,14 @@ struct RenderableManager::BuilderDetails {
     uint32_t mSkinningBufferOffset = 0;
     FixedCapacityVector<float2> mBoneIndicesAndWeights;
     size_t mBoneIndicesAndWeightsCount = 0;
+    struct Level {
+        size_t first = 0;
+        size_t count = 0;
+        float screenSize = 0.0f;
+    };
+    std::array<Level, Builder::MAX_LEVEL_OF_DETAIL_COUNT> mLevels{};
+    uint8_t mLevelDeclaredMask = 0;
+    float mLevelOfDetailHysteresis = 0.1f;
 
     // bone indices and weights defined for primitive index
     std::unordered_map<size_t, FixedCapacityVector<
@@ -271,6 +281,21 @@ RenderableManager::Builder& RenderableManager::Builder::fog(bool const enabled)
     return *this;
 }
 
+RenderableManager::Builder& RenderableManager::Builder::levelOfDetail(uint8_t const level,
+        size_t const first, size_t const count, float const screenSize) noexcept {
+    if (level < MAX_LEVEL_OF_DETAIL_COUNT) {
+        mImpl->mLevels[level] = { first, count, screenSize };
+        mImpl->mLevelDeclaredMask |= uint8_t(1u << level);
+    }
+    return *this;
+}
+
+RenderableManager::Builder& RenderableManager::Builder::levelOfDetailHysteresis(
+        float const hysteresis) noexcept {
+    mImpl->mLevelOfDetailHysteresis = clamp(hysteresis, 0.0f, 0.5f);
+    return *this;
+}
+
 RenderableManager::Builder& RenderableManager::Builder::morphing(size_t const targetCount) noexcept {
     mImpl->mMorphTargetCount = targetCount;
     return *this;
@@ -433,6 +458,17 @@ void RenderableManager::BuilderDetails::processBoneIndicesAndWights(Engine& engi
 }
 
 RenderableManager::Builder::Result RenderableManager::Builder::build(Engine& engine, Entity const entity) {
+    return build(engine, 1, &entity);
+}
+
+RenderableManager::Builder::Result RenderableManager::Builder::build(Engine& engine,
+        size_t const count, Entity const* entities) {
+    if (UTILS_UNLIKELY(!count)) {
+        return Success;
+    }
+
+    // the builder is validated once, the first entity is only used in the error messages
+    Entity const entity = entities[0];
     bool isEmpty = true;
 
     FILAMENT_CHECK_PRECONDITION(mImpl->mSkinningBoneCount <= CONFIG_MAX_BONE_COUNT)
@@ -464,6 +500,25 @@ RenderableManager::Builder::Result RenderableManager::Builder::build(Engine& eng
         mImpl->processBoneIndicesAndWights(engine, entity);
     }
 
+    if (uint8_t const mask = mImpl->mLevelDeclaredMask) {
+        FILAMENT_CHECK_PRECONDITION((mask & (mask + 1u)) == 0)
+                << "[entity=" << entity.getId() << "] levels of detail must be declared "
+                   "contiguously starting from level 0";
+
+        for (size_t i = 0, c = utils::popcount(unsigned(mask)); i < c; i++) {
+            auto const& level = mImpl->mLevels[i];
+            FILAMENT_CHECK_PRECONDITION(level.first + level.count <= mImpl->mEntries.size())
+                    << "[entity=" << entity.getId() << ", lod @ " << i << "] first ("
+                    << level.first << ") + count (" << level.count << ") > primitive count ("
+                    << mImpl->mEntries.size() << ")";
+
+            FILAMENT_CHECK_PRECONDITION(i < 2 ||
+                    level.screenSize < mImpl->mLevels[i - 1].screenSize)
+                    << "[entity=" << entity.getId() << ", lod @ " << i
+                    << "] screenSize must decrease with each level of detail";
+        }
+    }
+
     for (size_t i = 0, c = mImpl->mEntries.size(); i < c; i++) {
         auto& entry = mImpl->mEntries[i];
 
@@ -513,7 +568,7 @@ RenderableManager::Builder::Result RenderableManager::Builder::build(Engine& eng
             << "] AABB can't be empty, unless culling is disabled and "
                "the object is not a shadow caster/receiver";
 
-    downcast(engine).createRenderable(*this, entity);
+    downcast(engine).createRenderables(*this, count, entities);
     return Success;
 }
 
@@ -565,6 +620,21 @@ void FRenderableManager::create(
         }
         setPrimitives(ci, { rp, size_type(entryCount) });
 
+        LevelOfDetail lod{ .hysteresis = builder->mLevelOfDetailHysteresis };
+        if (uint8_t const mask = builder->mLevelDeclaredMask) {
+            lod.levelCount = uint8_t(utils::popcount(unsigned(mask)));
+            for (size_t i = 0; i < lod.levelCount; i++) {
+                auto const& level = builder->mLevels[i];
+                lod.screenSize[i] = level.screenSize;
+                lod.first[i] = uint16_t(level.first);
+                lod.count[i] = uint16_t(level.count);
+            }
+        } else {
+            lod.levelCount = 1;
+            lod.count[0] = uint16_t(entryCount);
+        }
+        manager[ci].levelOfDetail = lod;
+
         setAxisAlignedBoundingBox(ci, builder->mAABB);
         setLayerMask(ci, builder->mLayerMask);
         setPriority(ci, builder->mPriority);
@@ -690,7 +760,8 @@ void FRenderableManager::create(
                         sizeof(PerRenderableMorphingUib),
                         BufferObjectBinding::UNIFORM,
                         BufferUsage::DYNAMIC),
-                .count = targetCount };
+                .count = targetCount,
+                .activeTargets = new bitset256() };
 
             Slice<FRenderPrimitive>& primitives = mManager[ci].primitives;
             mManager[ci].morphTargetBuffer = morphTargetBuffer;
@@ -713,6 +784,15 @@ void FRenderableManager::create(
     engine.flushIfNeeded();
 }
 
+void FRenderableManager::create(const Builder& UTILS_RESTRICT builder,
+        size_t const count, Entity const* entities) {
+    // grow the storage once for the whole batch
+    mManager.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        create(builder, entities[i]);
+    }
+}
+
 // this destroys a single component from an entity
 void FRenderableManager::destroy(Entity const e) noexcept {
     Instance const ci = getInstance(e);
@@ -774,6 +854,7 @@ void FRenderableManager::destroyComponent(Instance const ci) noexcept {
     if (morphWeights.handle) {
         driver.destroyBufferObject(morphWeights.handle);
     }
+    delete morphWeights.activeTargets;
 
     InstancesInfo const& instances = manager[ci].instances;
     if (instances.handle) {
@@ -968,6 +1049,11 @@ void FRenderableManager::setMorphWeights(Instance const instance, float const* w
         if (morphWeights.handle) {
             updateMorphWeights(mEngine, morphWeights.handle, weights, count, offset);
         }
+        if (morphWeights.activeTargets) {
+            for (size_t i = 0; i < count; i++) {
+                morphWeights.activeTargets->set(offset + i, weights[i] != 0.0f);
+            }
+        }
     }
 }
 
@@ -1018,6 +1104,14 @@ bool FRenderableManager::getLightChannel(Instance const ci, unsigned int const c
     return false;
 }
 
+Slice<FRenderPrimitive> FRenderableManager::getLevelOfDetailPrimitives(
+        Instance const instance, uint8_t const level) const noexcept {
+    LevelOfDetail const& lod = mManager[instance].levelOfDetail;
+    Slice<FRenderPrimitive> const& primitives = mManager[instance].primitives;
+    assert_invariant(level < lod.levelCount);
+    return { primitives.data() + lod.first[level], lod.count[level] };
+}
+
 size_t FRenderableManager::getPrimitiveCount(Instance const instance, uint8_t const level) const noexcept {
     return getRenderPrimitives(instance, level).size();
 }
@@ -32,6 +32,8 @@
 #include <backend/DriverApiForward.h>
 #include <backend/Handle.h>
 
+#include <utils/algorithm.h>
+#include <utils/bitset.h>
 #include <utils/compiler.h>
 #include <utils/Entity.h>
 #include <utils/EntityInstance.h>
@@ -85,6 +87,8 @@ public:
     explicit FRenderableManager(FEngine& engine) noexcept;
     ~FRenderableManager();
 
+    FEngine& getEngine() const noexcept { return mEngine; }
+
     // free-up all resources
     void terminate() noexcept;
 
@@ -106,6 +110,11 @@ public:
         return mManager.getComponentCount();
     }
 
+    // changes whenever the instance of an entity may have changed
+    uint32_t getVersion() const noexcept {
+        return mManager.getVersion();
+    }
+
     bool empty() const noexcept {
         return mManager.empty();
     }
@@ -120,6 +129,8 @@ public:
 
     void create(const Builder& builder, utils::Entity entity);
 
+    void create(const Builder& builder, size_t count, utils::Entity const* entities);
+
     void destroy(utils::Entity e) noexcept;
 
     inline void setAxisAlignedBoundingBox(Instance instance, const Box& aabb);
@@ -200,7 +211,26 @@ public:
     static_assert(sizeof(InstancesInfo) == 16);
     inline InstancesInfo getInstancesInfo(Instance instance) const noexcept;
 
-    inline size_t getLevelCount(Instance) const noexcept { return 1u; }
+    // Levels of detail are contiguous ranges of the renderable's primitives. A renderable
+    // without declared levels has a single level spanning all its primitives.
+    struct LevelOfDetail {
+        static constexpr size_t MAX_COUNT = Builder::MAX_LEVEL_OF_DETAIL_COUNT;
+        float screenSize[MAX_COUNT];    // level i is used below screenSize[i], [0] is unused
+        float hysteresis;               // relative width of the band kept around thresholds
+        uint16_t first[MAX_COUNT];      // first primitive of each level
+        uint16_t count[MAX_COUNT];      // primitive count of each level
+        uint8_t levelCount;             // 1 when no levels were declared
+        uint8_t currentLevel;           // level selected for the previous main camera pass
+        char padding0[2];
+    };
+    static_assert(sizeof(LevelOfDetail) == 40);
+
+    inline size_t getLevelCount(Instance instance) const noexcept;
+    inline LevelOfDetail const& getLevelOfDetail(Instance instance) const noexcept;
+    inline void setCurrentLevelOfDetail(Instance instance, uint8_t level) noexcept;
+    // primitives of the given level of detail, this is a subset of getRenderPrimitives()
+    utils::Slice<FRenderPrimitive> getLevelOfDetailPrimitives(
+            Instance instance, uint8_t level) const noexcept;
     size_t getPrimitiveCount(Instance instance, uint8_t level) const noexcept;
     void setMaterialInstanceAt(Instance instance, uint8_t level,
             size_t primitiveIndex, FMaterialInstance const* materialInstance);
@@ -247,8 +277,16 @@ private:
     struct MorphWeights {
         backend::Handle<backend::HwBufferObject> handle;
         uint32_t count = 0;
+        union {
+            // targets whose weight is nonzero, the shader stops after the last one
+            utils::bitset256* activeTargets = nullptr;
+            uint64_t padding;          // ensures the pointer is 64 bits on all archs
+        };
     };
-    static_assert(sizeof(MorphWeights) == 8);
+    static_assert(sizeof(MorphWeights) == 16);
+
+    // Number of morph targets up to the last one with a nonzero weight.
+    static inline uint32_t getActiveMorphTargetCount(MorphWeights const& morphWeights) noexcept;
 
     enum {
         AABB,                   // user data
@@ -260,7 +298,8 @@ private:
         PRIMITIVES,             // user data
         BONES,                  // filament data, UBO storing a pointer to the bones information
         MORPHTARGET_BUFFER,     // morphtarget buffer for the component
-        DESCRIPTOR_SET          // per-renderable descriptor set
+        DESCRIPTOR_SET,         // per-renderable descriptor set
+        LEVEL_OF_DETAIL         // user data, primitive ranges and thresholds of each lod
     };
 
     using Base = utils::SingleInstanceComponentManager<
@@ -273,7 +312,8 @@ private:
             utils::Slice<FRenderPrimitive>,  // PRIMITIVES
             Bones,                           // BONES
             FMorphTargetBuffer*,            // MORPHTARGET_BUFFER
-            DescriptorSet          // DESCRIPTOR_SET
+            DescriptorSet,                   // DESCRIPTOR_SET
+            LevelOfDetail                    // LEVEL_OF_DETAIL
     >;
 
     struct Sim : public Base {
@@ -298,6 +338,7 @@ private:
                 Field<BONES>                bones;
                 Field<MORPHTARGET_BUFFER>   morphTargetBuffer;
                 Field<DESCRIPTOR_SET>       descriptorSet;
+                Field<LEVEL_OF_DETAIL>      levelOfDetail;
             };
         };
 
@@ -470,7 +511,24 @@ FRenderableManager::MorphingBindingInfo
 FRenderableManager::getMorphingBufferInfo(Instance const instance) const noexcept {
     MorphWeights const& morphWeights = mManager[instance].morphWeights;
     FMorphTargetBuffer const* const buffer = mManager[instance].morphTargetBuffer;
-    return { morphWeights.handle, morphWeights.count, buffer  };
+    return { morphWeights.handle, getActiveMorphTargetCount(morphWeights), buffer  };
+}
+
+uint32_t FRenderableManager::getActiveMorphTargetCount(
+        MorphWeights const& morphWeights) noexcept {
+    utils::bitset256 const* const activeTargets = morphWeights.activeTargets;
+    if (!activeTargets) {
+        return morphWeights.count;
+    }
+    constexpr size_t BITS_PER_WORD = utils::bitset256::BITS_PER_WORD;
+    for (size_t i = activeTargets->size() / BITS_PER_WORD; i-- > 0;) {
+        uint64_t const bits = activeTargets->getBitsAt(i);
+        if (bits) {
+            size_t const last = i * BITS_PER_WORD + BITS_PER_WORD - 1 - utils::clz(bits);
+            return std::min(morphWeights.count, uint32_t(last + 1));
+        }
+    }
+    return 0;
 }
 
 FRenderableManager::InstancesInfo
@@ -488,6 +546,20 @@ utils::Slice<FRenderPrimitive>& FRenderableManager::getRenderPrimitives(
     return mManager[instance].primitives;
 }
 
+size_t FRenderableManager::getLevelCount(Instance const instance) const noexcept {
+    return static_cast<LevelOfDetail const&>(mManager[instance].levelOfDetail).levelCount;
+}
+
+FRenderableManager::LevelOfDetail const& FRenderableManager::getLevelOfDetail(
+        Instance const instance) const noexcept {
+    return mManager[instance].levelOfDetail;
+}
+
+void FRenderableManager::setCurrentLevelOfDetail(
+        Instance const instance, uint8_t const level) noexcept {
+    static_cast<LevelOfDetail&>(mManager[instance].levelOfDetail).currentLevel = level;
+}
+
 DescriptorSet& FRenderableManager::getDescriptorSet(Instance const instance) noexcept {
     return mManager[instance].descriptorSet;
 }
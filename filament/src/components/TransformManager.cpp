@@ -19,8 +19,14 @@
 #include <math/mat4.h>
 
 #include <utils/debug.h>
+#include <utils/JobSystem.h>
 #include <filament/TransformManager.h>
 
+#include <functional>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
 
 using namespace utils;
 using namespace filament::math;
@@ -35,6 +41,7 @@ void FTransformManager::terminate() noexcept {
 }
 
 void FTransformManager::setAccurateTranslationsEnabled(bool const enable) noexcept {
+    mGeneration++;
     if (enable != mAccurateTranslations) {
         mAccurateTranslations = enable;
         // when enabling accurate translations, we have to recompute all world transforms
@@ -49,6 +56,7 @@ void FTransformManager::create(Entity const entity) {
 }
 
 void FTransformManager::create(Entity const entity, Instance const parent, const mat4f& localTransform) {
+    mGeneration++;
     // this always adds at the end, so all existing instances stay valid
     auto& manager = mManager;
 
@@ -71,6 +79,7 @@ void FTransformManager::create(Entity const entity, Instance const parent, const
 }
 
 void FTransformManager::create(Entity const entity, Instance const parent, const mat4& localTransform) {
+    mGeneration++;
     // this always adds at the end, so all existing instances stay valid
     auto& manager = mManager;
 
@@ -92,7 +101,17 @@ void FTransformManager::create(Entity const entity, Instance const parent, const
     }
 }
 
+void FTransformManager::create(size_t const count, Entity const* entities,
+        Instance const parent, const mat4f& localTransform) {
+    // grow the storage once for the whole batch
+    mManager.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        create(entities[i], parent, localTransform);
+    }
+}
+
 void FTransformManager::setParent(Instance const i, Instance const parent) noexcept {
+    mGeneration++;
     validateNode(i);
     if (i) {
         auto& manager = mManager;
@@ -142,6 +161,7 @@ TransformManager::children_iterator FTransformManager::getChildrenEnd(Instance)
 }
 
 void FTransformManager::destroy(Entity const e) noexcept {
+    mGeneration++;
     // update the reference of the element we're removing
     auto& manager = mManager;
     Instance const i = manager.getInstance(e);
@@ -168,6 +188,7 @@ void FTransformManager::destroy(Entity const e) noexcept {
 }
 
 void FTransformManager::setTransform(Instance const ci, const mat4f& model) noexcept {
+    mGeneration++;
     validateNode(ci);
     if (ci) {
         auto& manager = mManager;
@@ -179,6 +200,7 @@ void FTransformManager::setTransform(Instance const ci, const mat4f& model) noex
 }
 
 void FTransformManager::setTransform(Instance const ci, const mat4& model) noexcept {
+    mGeneration++;
     validateNode(ci);
     if (ci) {
         auto& manager = mManager;
@@ -219,12 +241,21 @@ void FTransformManager::openLocalTransformTransaction() noexcept {
 }
 
 void FTransformManager::commitLocalTransformTransaction() noexcept {
+    mGeneration++;
     if (mLocalTransformTransactionOpen) {
         mLocalTransformTransactionOpen = false;
         computeAllWorldTransforms();
     }
 }
 
+void FTransformManager::commitLocalTransformTransaction(JobSystem& js) noexcept {
+    mGeneration++;
+    if (mLocalTransformTransactionOpen) {
+        mLocalTransformTransactionOpen = false;
+        computeAllWorldTransforms(js);
+    }
+}
+
 void FTransformManager::computeAllWorldTransforms() noexcept {
     auto& manager = mManager;
 
@@ -249,6 +280,77 @@ void FTransformManager::computeAllWorldTransforms() noexcept {
     }
 }
 
+void FTransformManager::computeAllWorldTransforms(JobSystem& js) noexcept {
+    auto& manager = mManager;
+
+    // swapNode() below needs some temporary storage which we provide here
+    const bool accurate = mAccurateTranslations;
+    auto& soa = manager.getSoA();
+    soa.ensureCapacity(soa.size() + 1);
+
+    // First, sort children after their parent and compute the depth of each node. This pass
+    // can't be parallelized, but it's cheap compared to computing the transforms.
+    std::vector<uint32_t> depths(size_t(manager.end()), 0);
+    std::vector<uint32_t> levelOffsets;
+    for (Instance i = manager.begin(), e = manager.end(); i != e; ++i) {
+        while (UTILS_UNLIKELY(Instance(manager[i].parent) > i)) {
+            swapNode(i, manager[i].parent);
+        }
+        Instance const parent = manager[i].parent;
+        assert_invariant(parent < i);
+
+        // the depth of the parent is known because it's sorted before us
+        uint32_t const depth = parent ? depths[parent] + 1 : 0;
+        depths[i] = depth;
+        if (UTILS_UNLIKELY(depth + 1 >= levelOffsets.size())) {
+            levelOffsets.resize(depth + 2, 0);
+        }
+        levelOffsets[depth + 1]++;
+    }
+
+    if (levelOffsets.empty()) {
+        return;
+    }
+
+    // then bucket the nodes by depth, levelOffsets[d] is the offset of level d in `nodes`
+    for (size_t d = 1; d < levelOffsets.size(); d++) {
+        levelOffsets[d] += levelOffsets[d - 1];
+    }
+    std::vector<uint32_t> nodes(levelOffsets.back());
+    {
+        std::vector<uint32_t> offsets(levelOffsets.begin(), levelOffsets.end() - 1);
+        for (Instance i = manager.begin(), e = manager.end(); i != e; ++i) {
+            nodes[offsets[depths[i]]++] = i;
+        }
+    }
+
+    // Finally, compute the world transforms one level at a time: all the nodes of a level
+    // only depend on the previous level, so they can be processed concurrently.
+    auto work = [&manager, accurate](uint32_t const* const first, uint32_t const count) {
+        for (uint32_t const* p = first, *const last = first + count; p != last; ++p) {
+            Instance const i = *p;
+            Instance const parent = manager[i].parent;
+            computeWorldTransform(
+                    manager[i].world, manager[i].worldTranslationLo,
+                    manager[parent].world, manager[i].local,
+                    manager[parent].worldTranslationLo, manager[i].localTranslationLo,
+                    accurate);
+        }
+    };
+
+    for (size_t d = 0; d + 1 < levelOffsets.size(); d++) {
+        uint32_t* const first = nodes.data() + levelOffsets[d];
+        uint32_t const count = levelOffsets[d + 1] - levelOffsets[d];
+        if (count <= JOBS_PARALLEL_FOR_TRANSFORMS_COUNT) {
+            work(first, count);
+        } else {
+            auto* job = jobs::parallel_for(js, nullptr, first, count, std::cref(work),
+                    jobs::CountSplitter<JOBS_PARALLEL_FOR_TRANSFORMS_COUNT>());
+            js.runAndWait(job);
+        }
+    }
+}
+
 // Inserts a parentless node in the hierarchy
 void FTransformManager::insertNode(Instance const i, Instance const parent) noexcept {
     auto& manager = mManager;
@@ -28,6 +28,12 @@
 
 #include <math/mat4.h>
 
+#include <stdint.h>
+
+namespace utils {
+class JobSystem;
+} // namespace utils
+
 namespace filament {
 
 class UTILS_PRIVATE FTransformManager : public TransformManager {
@@ -57,6 +63,11 @@ public:
         return mManager.getComponentCount();
     }
 
+    // changes whenever the instance of an entity may have changed
+    uint32_t getVersion() const noexcept {
+        return mManager.getVersion();
+    }
+
     bool empty() const noexcept {
         return mManager.empty();
     }
@@ -75,12 +86,20 @@ public:
         return mAccurateTranslations;
     }
 
+    // makes room for `count` more components
+    void reserve(size_t const count) {
+        mManager.reserve(count);
+    }
+
     void create(utils::Entity entity);
 
     void create(utils::Entity entity, Instance parent, const math::mat4f& localTransform);
 
     void create(utils::Entity entity, Instance parent, const math::mat4& localTransform);
 
+    void create(size_t count, utils::Entity const* entities, Instance parent,
+            const math::mat4f& localTransform);
+
     void destroy(utils::Entity e) noexcept;
 
     void setParent(Instance i, Instance newParent) noexcept;
@@ -97,10 +116,21 @@ public:
 
     void openLocalTransformTransaction() noexcept;
 
+    bool isLocalTransformTransactionOpen() const noexcept {
+        return mLocalTransformTransactionOpen;
+    }
+
     void commitLocalTransformTransaction() noexcept;
 
+    void commitLocalTransformTransaction(utils::JobSystem& js) noexcept;
+
     void gc(utils::EntityManager& em) noexcept;
 
+    // incremented by every change of the transforms, for Renderer's render-on-demand mode
+    uint64_t getGeneration() const noexcept {
+        return mGeneration;
+    }
+
     utils::Slice<const math::mat4f> getWorldTransforms() const noexcept {
         return mManager.slice<WORLD>();
     }
@@ -146,6 +176,12 @@ private:
 
     void computeAllWorldTransforms() noexcept;
 
+    // same as above, but computes the world transforms in parallel, one level at a time
+    void computeAllWorldTransforms(utils::JobSystem& js) noexcept;
+
+    // Below this many nodes in a level, the world transforms are computed on the calling thread.
+    static constexpr uint32_t JOBS_PARALLEL_FOR_TRANSFORMS_COUNT = 1024;
+
     static void computeWorldTransform(math::mat4f& outWorld, math::float3& inoutWorldTranslationLo,
             math::mat4f const& pt, math::mat4f const& local,
             math::float3 const& ptTranslationLo, math::float3 const& localTranslationLo,
@@ -209,6 +245,7 @@ private:
     };
 
     Sim mManager;
+    uint64_t mGeneration = 0;
     bool mLocalTransformTransactionOpen = false;
     bool mAccurateTranslations = false;
 };
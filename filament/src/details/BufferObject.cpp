@@ -28,6 +28,7 @@ namespace filament {
 struct BufferObject::BuilderDetails {
     BindingType mBindingType = BindingType::VERTEX;
     uint32_t mByteCount = 0;
+    BufferUsage mUsage = BufferUsage::STATIC;
 };
 
 using BuilderType = BufferObject;
@@ -48,6 +49,11 @@ BufferObject::Builder& BufferObject::Builder::bindingType(BindingType const bind
     return *this;
 }
 
+BufferObject::Builder& BufferObject::Builder::usage(BufferUsage const usage) noexcept {
+    mImpl->mUsage = usage;
+    return *this;
+}
+
 BufferObject::Builder& BufferObject::Builder::name(const char* name, size_t const len) noexcept {
     return BuilderNameMixin::name(name, len);
 }
@@ -66,7 +72,7 @@ FBufferObject::FBufferObject(FEngine& engine, const Builder& builder)
         : mByteCount(builder->mByteCount), mBindingType(builder->mBindingType) {
     FEngine::DriverApi& driver = engine.getDriverApi();
     mHandle = driver.createBufferObject(builder->mByteCount, builder->mBindingType,
-            backend::BufferUsage::STATIC);
+            builder->mUsage);
     if (auto name = builder.getName(); !name.empty()) {
         driver.setDebugTag(mHandle.getId(), std::move(name));
     }
@@ -48,6 +48,8 @@ public:
 
     void terminate(FEngine&) noexcept { }
 
+    FEngine& getEngine() const noexcept { return mEngine; }
+
 
     // Sets the projection matrices (viewing and culling). The viewing matrice has infinite far.
     void setProjection(Projection projection,
@@ -29,12 +29,14 @@
 #include <math/vec3.h>
 #include <math/vec4.h>
 
+#include <utils/FixedCapacityVector.h>
 #include <utils/JobSystem.h>
 #include <utils/Mutex.h>
 #include <utils/Systrace.h>
 
 #include <cmath>
 #include <cstdlib>
+#include <memory>
 #include <tuple>
 
 namespace filament {
@@ -61,6 +63,8 @@ struct ColorGrading::BuilderDetails {
 #endif
 
     bool hasAdjustments = false;
+    // True if exposure is the only adjustment, it doesn't prevent the use of a 1D LUT
+    bool hasExposureOnly = false;
 
     // Everything below must be part of the == comparison operator
     LutFormat format = LutFormat::INTEGER;
@@ -282,6 +286,10 @@ ColorGrading* ColorGrading::Builder::build(Engine& engine) {
     bool hasAdjustments = defaults != *mImpl;
     mImpl->hasAdjustments = hasAdjustments;
 
+    BuilderDetails withoutExposure = *mImpl;
+    withoutExposure.exposure = defaults.exposure;
+    mImpl->hasExposureOnly = hasAdjustments && defaults == withoutExposure;
+
     // Fallback for clients that still use the deprecated ToneMapping API
     bool needToneMapper = mImpl->toneMapper == nullptr;
     if (needToneMapper) {
@@ -663,7 +671,9 @@ FColorGrading::FColorGrading(FEngine& engine, const Builder& builder) {
     // XXX: The following two conditions also only hold true as long as the input and output color
     // spaces are the same, but we currently don't check that. We must revise these conditions if we
     // ever handle this case.
-    mIsOneDimensional = !builder->hasAdjustments && !builder->luminanceScaling
+    // Exposure is a scale applied before the tone mapper, so it doesn't mix the color channels.
+    mIsOneDimensional = (!builder->hasAdjustments || builder->hasExposureOnly)
+            && !builder->luminanceScaling
             && builder->toneMapper->isOneDimensional()
             && engine.features.engine.color_grading.use_1d_lut;
     mIsLDR = mIsOneDimensional && builder->toneMapper->isLDR();
@@ -707,7 +717,8 @@ FColorGrading::FColorGrading(FEngine& engine, const Builder& builder) {
         converted = malloc(lutElementCount * sizeof(uint32_t));
     }
 
-    auto hdrColorAt = [builder, config](size_t r, size_t g, size_t b) {
+    // Everything up to the tone mapper only depends on the adjustments, see hasSameGrading()
+    auto gradedColorAt = [builder, config](size_t r, size_t g, size_t b) {
         float3 v = float3{r, g, b} * (1.0f / float(config.lutDimension - 1u));
 
         // LogC encoding
@@ -768,6 +779,10 @@ FColorGrading::FColorGrading(FEngine& engine, const Builder& builder) {
                     builder->shadowGamma, builder->midPoint, builder->highlightScale);
         }
 
+        return v;
+    };
+
+    auto outputColor = [builder, config](float3 v) {
         // Tone mapping
         if (builder->luminanceScaling) {
             v = luminanceScaling(v, *builder->toneMapper, config.colorGradingLuminance);
@@ -797,6 +812,36 @@ FColorGrading::FColorGrading(FEngine& engine, const Builder& builder) {
         return v;
     };
 
+    auto hdrColorAt = [&gradedColorAt, &outputColor](size_t r, size_t g, size_t b) {
+        return outputColor(gradedColorAt(r, g, b));
+    };
+
+    // In incremental mode, the graded values are stored in the engine's cache, and reused by
+    // the next 3D LUT if its adjustments are the same.
+    float3* graded = nullptr;
+    bool reuseGraded = false;
+    if (!mIsOneDimensional && engine.features.engine.color_grading.incremental) {
+        FColorGrading::Cache& cache = engine.getColorGradingCache();
+        reuseGraded = cache.key && hasSameGrading(*cache.key, builder);
+        if (!reuseGraded) {
+            cache.key = std::make_unique<Builder>(builder);
+            cache.values = FixedCapacityVector<float3>(lutElementCount);
+        }
+        graded = cache.values.data();
+    }
+
+    // same as hdrColorAt(), but stores the graded value in s or reuses it
+    auto cachedColorAt = [&gradedColorAt, &outputColor, reuseGraded](
+            size_t r, size_t g, size_t b, float3* s) {
+        if (!s) {
+            return outputColor(gradedColorAt(r, g, b));
+        }
+        if (!reuseGraded) {
+            *s = gradedColorAt(r, g, b);
+        }
+        return outputColor(*s);
+    };
+
     //auto now = std::chrono::steady_clock::now();
 
     if (mIsOneDimensional) {
@@ -805,6 +850,10 @@ FColorGrading::FColorGrading(FEngine& engine, const Builder& builder) {
             for (size_t rgb = 0; rgb < config.lutDimension; rgb++) {
                 float3 v = float3(rgb) * (1.0f / float(config.lutDimension - 1u));
 
+                if (builder->hasExposureOnly) {
+                    v = adjustExposure(v, builder->exposure);
+                }
+
                 v = (*builder->toneMapper)(float3(v));
 
                 // We need to clamp for the output transfer function
@@ -828,13 +877,18 @@ FColorGrading::FColorGrading(FEngine& engine, const Builder& builder) {
         auto *slices = js.createJob();
         for (size_t b = 0; b < config.lutDimension; b++) {
             auto* job = js.createJob(slices,
-                    [data, converted, b, &config, builder, &hdrColorAt](
+                    [data, converted, b, &config, graded, &cachedColorAt](
                             JobSystem&, JobSystem::Job*) {
                 half4* UTILS_RESTRICT p =
                         (half4*) data + b * config.lutDimension * config.lutDimension;
+                float3* UTILS_RESTRICT s =
+                        graded ? graded + b * config.lutDimension * config.lutDimension : nullptr;
                 for (size_t g = 0; g < config.lutDimension; g++) {
                     for (size_t r = 0; r < config.lutDimension; r++) {
-                        *p++ = half4{hdrColorAt(r, g, b), 0.0f};
+                        *p++ = half4{cachedColorAt(r, g, b, s), 0.0f};
+                        if (s) {
+                            s++;
+                        }
                     }
                 }
 
@@ -890,6 +944,33 @@ FColorGrading::FColorGrading(FEngine& engine, const Builder& builder) {
 
 FColorGrading::~FColorGrading() noexcept = default;
 
+bool FColorGrading::hasSameGrading(const Builder& lhs, const Builder& rhs) noexcept {
+    // The tone mapper, luminance scaling, gamut mapping, output color space and format are
+    // applied after the graded values, they're not compared.
+    return lhs->dimension == rhs->dimension &&
+           lhs->toneMapping == rhs->toneMapping &&
+           lhs->hasAdjustments == rhs->hasAdjustments &&
+           lhs->exposure == rhs->exposure &&
+           lhs->nightAdaptation == rhs->nightAdaptation &&
+           lhs->whiteBalance == rhs->whiteBalance &&
+           lhs->outRed == rhs->outRed &&
+           lhs->outGreen == rhs->outGreen &&
+           lhs->outBlue == rhs->outBlue &&
+           lhs->shadows == rhs->shadows &&
+           lhs->midtones == rhs->midtones &&
+           lhs->highlights == rhs->highlights &&
+           lhs->tonalRanges == rhs->tonalRanges &&
+           lhs->slope == rhs->slope &&
+           lhs->offset == rhs->offset &&
+           lhs->power == rhs->power &&
+           lhs->contrast == rhs->contrast &&
+           lhs->vibrance == rhs->vibrance &&
+           lhs->saturation == rhs->saturation &&
+           lhs->shadowGamma == rhs->shadowGamma &&
+           lhs->midPoint == rhs->midPoint &&
+           lhs->highlightScale == rhs->highlightScale;
+}
+
 void FColorGrading::terminate(FEngine& engine) {
     DriverApi& driver = engine.getDriverApi();
     driver.destroyTexture(mLutHandle);
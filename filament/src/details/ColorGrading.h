@@ -24,7 +24,11 @@
 
 #include <filament/ColorGrading.h>
 
-#include <math/mathfwd.h>
+#include <utils/FixedCapacityVector.h>
+
+#include <math/vec3.h>
+
+#include <memory>
 
 namespace filament {
 
@@ -32,6 +36,15 @@ class FEngine;
 
 class FColorGrading : public ColorGrading {
 public:
+    // The graded values of the last 3D LUT, i.e. before tone mapping. With the
+    // engine.color_grading.incremental feature flag, the engine keeps one so that a ColorGrading
+    // built with the same adjustments only re-evaluates the tone mapping and output stages.
+    struct Cache {
+        // only used with hasSameGrading(), its tone mapper may have been destroyed
+        std::unique_ptr<Builder> key;
+        utils::FixedCapacityVector<math::float3> values;
+    };
+
     FColorGrading(FEngine& engine, const Builder& builder);
     FColorGrading(const FColorGrading& rhs) = delete;
     FColorGrading& operator=(const FColorGrading& rhs) = delete;
@@ -47,6 +60,8 @@ public:
     bool isLDR() const noexcept { return mIsLDR; }
 
 private:
+    static bool hasSameGrading(const Builder& lhs, const Builder& rhs) noexcept;
+
     backend::TextureHandle mLutHandle;
     uint32_t mDimension;
     bool mIsOneDimensional;
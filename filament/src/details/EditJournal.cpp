@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "details/EditJournal.h"
+
+#include "components/LightManager.h"
+#include "components/RenderableManager.h"
+#include "components/TransformManager.h"
+
+#include "details/Engine.h"
+
+#include <utils/Entity.h>
+
+#include <math/mat4.h>
+#include <math/vec3.h>
+
+#include <mutex>
+#include <utility>
+
+#include <stddef.h>
+#include <stdint.h>
+
+using namespace filament::math;
+using namespace utils;
+
+namespace filament {
+
+void FEditJournal::setTransform(Entity const entity, const mat4f& localTransform) noexcept {
+    std::lock_guard const lock(mLock);
+    mRecording.transforms.push_back({ entity, localTransform });
+}
+
+void FEditJournal::setTransforms(Entity const* entities, mat4f const* localTransforms,
+        size_t const count) noexcept {
+    std::lock_guard const lock(mLock);
+    auto& transforms = mRecording.transforms;
+    transforms.reserve(transforms.size() + count);
+    for (size_t i = 0; i < count; i++) {
+        transforms.push_back({ entities[i], localTransforms[i] });
+    }
+}
+
+void FEditJournal::setAxisAlignedBoundingBox(Entity const entity, const Box& aabb) noexcept {
+    std::lock_guard const lock(mLock);
+    mRecording.bounds.push_back({ entity, aabb });
+}
+
+void FEditJournal::editRenderable(Entity const entity, RenderableEditType const type,
+        uint8_t const value0, uint8_t const value1) noexcept {
+    std::lock_guard const lock(mLock);
+    mRecording.renderables.push_back({ entity, type, { value0, value1 }});
+}
+
+void FEditJournal::editLight(Entity const entity, LightEditType const type,
+        float3 const value) noexcept {
+    std::lock_guard const lock(mLock);
+    mRecording.lights.push_back({ entity, type, value });
+}
+
+void FEditJournal::apply(FEngine& engine) noexcept {
+    {
+        std::lock_guard const lock(mLock);
+        if (mRecording.empty()) {
+            return;
+        }
+        std::swap(mRecording, mApplying);
+    }
+
+    engine.markContentChanged();
+    applyTransforms(engine);
+    applyRenderables(engine);
+    applyLights(engine);
+    mApplying.clear();
+}
+
+void FEditJournal::applyTransforms(FEngine& engine) noexcept {
+    FTransformManager& tcm = engine.getTransformManager();
+    auto const& transforms = mApplying.transforms;
+
+    // Updating the world transforms of each node's subtree for every edit gets expensive with
+    // many edits, so large batches update the whole hierarchy once, in parallel. We don't do
+    // this if the application already has a transaction open, since we'd be closing it.
+    bool const useTransaction = transforms.size() >= TRANSFORM_TRANSACTION_THRESHOLD &&
+            !tcm.isLocalTransformTransactionOpen();
+    if (useTransaction) {
+        tcm.openLocalTransformTransaction();
+    }
+    for (TransformEdit const& edit : transforms) {
+        FTransformManager::Instance const ti = tcm.getInstance(edit.entity);
+        if (ti) {
+            tcm.setTransform(ti, edit.transform);
+        }
+    }
+    if (useTransaction) {
+        tcm.commitLocalTransformTransaction(engine.getJobSystem());
+    }
+}
+
+void FEditJournal::applyRenderables(FEngine& engine) noexcept {
+    FRenderableManager& rcm = engine.getRenderableManager();
+
+    for (BoundsEdit const& edit : mApplying.bounds) {
+        FRenderableManager::Instance const ri = rcm.getInstance(edit.entity);
+        if (ri) {
+            rcm.setAxisAlignedBoundingBox(ri, edit.aabb);
+        }
+    }
+
+    for (RenderableEdit const& edit : mApplying.renderables) {
+        FRenderableManager::Instance const ri = rcm.getInstance(edit.entity);
+        if (!ri) {
+            continue;
+        }
+        switch (edit.type) {
+            case RenderableEditType::LAYER_MASK:
+                rcm.setLayerMask(ri, edit.value[0], edit.value[1]);
+                break;
+            case RenderableEditType::PRIORITY:
+                rcm.setPriority(ri, edit.value[0]);
+                break;
+            case RenderableEditType::CAST_SHADOWS:
+                rcm.setCastShadows(ri, edit.value[0]);
+                break;
+            case RenderableEditType::RECEIVE_SHADOWS:
+                rcm.setReceiveShadows(ri, edit.value[0]);
+                break;
+        }
+    }
+}
+
+void FEditJournal::applyLights(FEngine& engine) noexcept {
+    FLightManager& lcm = engine.getLightManager();
+
+    for (LightEdit const& edit : mApplying.lights) {
+        FLightManager::Instance const li = lcm.getInstance(edit.entity);
+        if (!li) {
+            continue;
+        }
+        switch (edit.type) {
+            case LightEditType::POSITION:
+                lcm.setLocalPosition(li, edit.value);
+                break;
+            case LightEditType::DIRECTION:
+                lcm.setLocalDirection(li, edit.value);
+                break;
+            case LightEditType::COLOR:
+                lcm.setColor(li, edit.value);
+                break;
+            case LightEditType::INTENSITY:
+                lcm.setIntensity(li, edit.value.x, FLightManager::IntensityUnit::LUMEN_LUX);
+                break;
+            case LightEditType::INTENSITY_CANDELA:
+                lcm.setIntensity(li, edit.value.x, FLightManager::IntensityUnit::CANDELA);
+                break;
+            case LightEditType::FALLOFF:
+                lcm.setFalloff(li, edit.value.x);
+                break;
+        }
+    }
+}
+
+} // namespace filament
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_DETAILS_EDITJOURNAL_H
+#define TNT_FILAMENT_DETAILS_EDITJOURNAL_H
+
+#include "downcast.h"
+
+#include <filament/Box.h>
+#include <filament/EditJournal.h>
+
+#include <utils/Entity.h>
+#include <utils/Mutex.h>
+
+#include <math/mat4.h>
+#include <math/vec3.h>
+
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace filament {
+
+class FEngine;
+
+class FEditJournal : public EditJournal {
+public:
+    // Above this many transforms, world transforms are computed once for the whole hierarchy
+    // rather than once per edit.
+    static constexpr size_t TRANSFORM_TRANSACTION_THRESHOLD = 64;
+
+    enum class RenderableEditType : uint8_t {
+        LAYER_MASK, PRIORITY, CAST_SHADOWS, RECEIVE_SHADOWS
+    };
+
+    enum class LightEditType : uint8_t {
+        POSITION, DIRECTION, COLOR, INTENSITY, INTENSITY_CANDELA, FALLOFF
+    };
+
+    void setTransform(utils::Entity entity, const math::mat4f& localTransform) noexcept;
+    void setTransforms(utils::Entity const* entities, math::mat4f const* localTransforms,
+            size_t count) noexcept;
+    void setAxisAlignedBoundingBox(utils::Entity entity, const Box& aabb) noexcept;
+    void editRenderable(utils::Entity entity, RenderableEditType type,
+            uint8_t value0, uint8_t value1 = 0) noexcept;
+    void editLight(utils::Entity entity, LightEditType type, math::float3 value) noexcept;
+
+    // Applies and clears all the recorded edits. Must be called on the engine's thread.
+    void apply(FEngine& engine) noexcept;
+
+private:
+    struct TransformEdit {
+        utils::Entity entity;
+        math::mat4f transform;
+    };
+
+    struct BoundsEdit {
+        utils::Entity entity;
+        Box aabb;
+    };
+
+    struct RenderableEdit {
+        utils::Entity entity;
+        RenderableEditType type;
+        uint8_t value[2];
+    };
+
+    struct LightEdit {
+        utils::Entity entity;
+        LightEditType type;
+        math::float3 value;
+    };
+
+    // One array per kind of edit, so that each is applied in a tight loop over one manager.
+    struct Edits {
+        std::vector<TransformEdit> transforms;
+        std::vector<BoundsEdit> bounds;
+        std::vector<RenderableEdit> renderables;
+        std::vector<LightEdit> lights;
+
+        bool empty() const noexcept {
+            return transforms.empty() && bounds.empty() && renderables.empty() && lights.empty();
+        }
+
+        // keeps the capacity, so that a steady stream of edits doesn't allocate
+        void clear() noexcept {
+            transforms.clear();
+            bounds.clear();
+            renderables.clear();
+            lights.clear();
+        }
+    };
+
+    void applyTransforms(FEngine& engine) noexcept;
+    void applyRenderables(FEngine& engine) noexcept;
+    void applyLights(FEngine& engine) noexcept;
+
+    // Producers append to mRecording under mLock; apply() swaps it with mApplying, which only
+    // the engine's thread touches, so the lock is never held while edits are applied.
+    utils::Mutex mLock;
+    Edits mRecording;
+    Edits mApplying;
+};
+
+FILAMENT_DOWNCAST(EditJournal)
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_DETAILS_EDITJOURNAL_H
@@ -35,6 +35,7 @@
 #include "details/Stream.h"
 #include "details/SwapChain.h"
 #include "details/Texture.h"
+#include "details/TextureAtlas.h"
 #include "details/VertexBuffer.h"
 #include "details/View.h"
 
@@ -115,7 +116,7 @@ Engine* FEngine::create(Builder const& builder) {
 
     // Normally we launch a thread and create the context and Driver from there (see FEngine::loop).
     // In the single-threaded case, we do so in the here and now.
-    if constexpr (!UTILS_HAS_THREADING) {
+    if constexpr (!UTILS_HAS_DRIVER_THREAD) {
         Platform* platform = builder->mPlatform;
         void* const sharedContext = builder->mSharedContext;
 
@@ -138,8 +139,10 @@ Engine* FEngine::create(Builder const& builder) {
                 .forceGLES2Context = instance->getConfig().forceGLES2Context,
                 .stereoscopicType = instance->getConfig().stereoscopicType,
                 .assertNativeWindowIsValid = instance->features.backend.opengl.assert_native_window_is_valid,
+                .shaderCompilerThreadCount = instance->getConfig().shaderCompilerThreadCount,
         };
         instance->mDriver = platform->createDriver(sharedContext, driverConfig);
+        instance->mStartupTimings.driver = instance->getEngineTime().count();
 
     } else {
         // start the driver thread
@@ -159,14 +162,14 @@ Engine* FEngine::create(Builder const& builder) {
     // now we can initialize the largest part of the engine
     instance->init();
 
-    if constexpr (!UTILS_HAS_THREADING) {
+    if constexpr (!UTILS_HAS_DRIVER_THREAD) {
         instance->execute();
     }
 
     return instance;
 }
 
-#if UTILS_HAS_THREADING
+#if UTILS_HAS_DRIVER_THREAD
 
 void FEngine::create(Builder const& builder, Invocable<void(void*)>&& callback) {
     SYSTRACE_ENABLE();
@@ -241,6 +244,8 @@ FEngine::FEngine(Builder const& builder) :
                 "FEngine::mPerRenderPassAllocator",
                 builder->mConfig.perRenderPassArenaSizeMB * MiB),
         mHeapAllocator("FEngine::mHeapAllocator", AreaPolicy::NullArea{}),
+        mFrameAllocator(builder->mConfig.perFrameUserArenaSizeMB * MiB),
+        mTextureUploadQueue(builder->mConfig.textureUploadBudgetMB * MiB),
         mJobSystem(getJobSystemThreadPoolSize(builder->mConfig)),
         mEngineEpoch(std::chrono::steady_clock::now()),
         mDriverBarrier(1),
@@ -274,6 +279,10 @@ FEngine::FEngine(Builder const& builder) :
     featureFlagsBackwardCompatibility("backend.opengl.assert_native_window_is_valid",
             mConfig.assertNativeWindowIsValid);
 
+    if (features.backend.command_buffer_queue.spin_wait) {
+        mCommandBufferQueue.setSpinCount(COMMAND_BUFFER_QUEUE_SPIN_COUNT);
+    }
+
     // We're assuming we're on the main thread here.
     // (it may not be the case)
     mJobSystem.adopt();
@@ -287,8 +296,9 @@ uint32_t FEngine::getJobSystemThreadPoolSize(Config const& config) noexcept {
         return config.jobSystemThreadCount;
     }
 
-    // 1 thread for the user, 1 thread for the backend
-    int threadCount = int(std::thread::hardware_concurrency()) - 2;
+    // 1 thread for the user, 1 thread for the backend, and leave the efficiency cores alone
+    // (if any), so that the frame's jobs only run on the performance cores.
+    int threadCount = int(JobSystem::getPerformanceCoreCount()) - 2;
     // make sure we have at least 1 thread though
     threadCount = std::max(1, threadCount);
     return threadCount;
@@ -317,6 +327,48 @@ void FEngine::init() {
     slog.i << "Backend feature level: " << int(driverApi.getFeatureLevel()) << io::endl;
     slog.i << "FEngine feature level: " << int(mActiveFeatureLevel) << io::endl;
 
+    auto phaseEnd = [this, start = getEngineTime()]() mutable {
+        duration const now = getEngineTime();
+        uint64_t const elapsed = (now - start).count();
+        start = now;
+        return elapsed;
+    };
+
+    // Parsing the default material package doesn't need the driver API, so it runs on the
+    // JobSystem while the resources below are created.
+    FMaterial::DefaultMaterialBuilder defaultMaterialBuilder;
+#ifdef FILAMENT_ENABLE_FEATURE_LEVEL_0
+    if (UTILS_UNLIKELY(mActiveFeatureLevel == FeatureLevel::FEATURE_LEVEL_0)) {
+        defaultMaterialBuilder.package(
+                MATERIALS_DEFAULTMATERIAL_FL0_DATA, MATERIALS_DEFAULTMATERIAL_FL0_SIZE);
+    } else
+#endif
+    {
+        switch (mConfig.stereoscopicType) {
+            case StereoscopicType::NONE:
+            case StereoscopicType::INSTANCED:
+                defaultMaterialBuilder.package(
+                    MATERIALS_DEFAULTMATERIAL_DATA, MATERIALS_DEFAULTMATERIAL_SIZE);
+                break;
+            case StereoscopicType::MULTIVIEW:
+#ifdef FILAMENT_ENABLE_MULTIVIEW
+                defaultMaterialBuilder.package(
+                    MATERIALS_DEFAULTMATERIAL_MULTIVIEW_DATA, MATERIALS_DEFAULTMATERIAL_MULTIVIEW_SIZE);
+#else
+                assert_invariant(false);
+#endif
+                break;
+        }
+    }
+
+    uint64_t defaultMaterialParseTime = 0;
+    JobSystem& js = mJobSystem;
+    JobSystem::Job* parseJob = js.runAndRetain(jobs::createJob(js, nullptr,
+            [this, &defaultMaterialBuilder, &defaultMaterialParseTime] {
+                duration const start = getEngineTime();
+                defaultMaterialBuilder.parse(*this);
+                defaultMaterialParseTime = (getEngineTime() - start).count();
+            }));
 
     mResourceAllocatorDisposer = std::make_shared<ResourceAllocatorDisposer>(driverApi);
 
@@ -414,34 +466,23 @@ void FEngine::init() {
             driverApi,
             descriptor_sets::getPerRenderableLayout() };
 
+    mStartupTimings.resources = phaseEnd();
+
 #ifdef FILAMENT_ENABLE_FEATURE_LEVEL_0
     if (UTILS_UNLIKELY(mActiveFeatureLevel == FeatureLevel::FEATURE_LEVEL_0)) {
-        FMaterial::DefaultMaterialBuilder defaultMaterialBuilder;
-        defaultMaterialBuilder.package(
-                MATERIALS_DEFAULTMATERIAL_FL0_DATA, MATERIALS_DEFAULTMATERIAL_FL0_SIZE);
-        mDefaultMaterial = downcast(defaultMaterialBuilder.build(*const_cast<FEngine*>(this)));
+        js.waitAndRelease(parseJob);
+        mDefaultMaterial = defaultMaterialBuilder.build(*this);
+        mStartupTimings.defaultMaterial = defaultMaterialParseTime + phaseEnd();
     } else
 #endif
     {
+        // the color grading LUT is generated while the default material is being parsed
         mDefaultColorGrading = downcast(ColorGrading::Builder().build(*this));
+        mStartupTimings.lighting = phaseEnd();
 
-        FMaterial::DefaultMaterialBuilder defaultMaterialBuilder;
-        switch (mConfig.stereoscopicType) {
-            case StereoscopicType::NONE:
-            case StereoscopicType::INSTANCED:
-                defaultMaterialBuilder.package(
-                    MATERIALS_DEFAULTMATERIAL_DATA, MATERIALS_DEFAULTMATERIAL_SIZE);
-                break;
-            case StereoscopicType::MULTIVIEW:
-#ifdef FILAMENT_ENABLE_MULTIVIEW
-                defaultMaterialBuilder.package(
-                    MATERIALS_DEFAULTMATERIAL_MULTIVIEW_DATA, MATERIALS_DEFAULTMATERIAL_MULTIVIEW_SIZE);
-#else
-                assert_invariant(false);
-#endif
-                break;
-        }
-        mDefaultMaterial = downcast(defaultMaterialBuilder.build(*this));
+        js.waitAndRelease(parseJob);
+        mDefaultMaterial = defaultMaterialBuilder.build(*this);
+        mStartupTimings.defaultMaterial = defaultMaterialParseTime + phaseEnd();
 
         constexpr float3 dummyPositions[1] = {};
         constexpr short4 dummyTangents[1] = {};
@@ -459,12 +500,15 @@ void FEngine::init() {
 
         driverApi.update3DImage(mDummyZeroTextureArray, 0, 0, 0, 0, 1, 1, 1,
                 { zeroes, 4, Texture::Format::RGBA, Texture::Type::UBYTE });
+        mStartupTimings.resources += phaseEnd();
 
         mLightManager.init(*this);
         mDFG.init(*this);
+        mStartupTimings.lighting += phaseEnd();
     }
 
     mPostProcessManager.init();
+    mStartupTimings.postProcessing = phaseEnd();
 
     mDebugRegistry.registerProperty("d.shadowmap.debug_directional_shadowmap",
             &debug.shadowmap.debug_directional_shadowmap, [this] {
@@ -498,9 +542,38 @@ void FEngine::init() {
                 });
             });
 
+#if FILAMENT_ENABLE_COMMAND_PROFILING
+    mDebugRegistry.registerProperty("d.backend.log_command_profile",
+            &debug.backend.log_command_profile, [this] {
+                if (debug.backend.log_command_profile) {
+                    debug.backend.log_command_profile = false;
+                    logCommandProfile();
+                }
+            });
+#endif
+
+    mStartupTimings.total = getEngineTime().count();
     mInitialized = true;
 }
 
+#if FILAMENT_ENABLE_COMMAND_PROFILING
+void FEngine::logCommandProfile() {
+    auto const profile = getDriverApi().getCommandProfile();
+    uint64_t total = 0;
+    for (auto const& p : profile) {
+        total += p.duration;
+    }
+    slog.d << "Driver commands of the last frame, total " << double(total) * 1e-6 << " ms:"
+           << io::endl;
+    for (auto const& p : profile) {
+        slog.d << "  " << p.name << ": " << p.count << " calls, "
+               << double(p.duration) * 1e-6 << " ms ("
+               << (total ? double(p.duration) * 100.0 / double(total) : 0.0) << "%)"
+               << io::endl;
+    }
+}
+#endif
+
 FEngine::~FEngine() noexcept {
     SYSTRACE_CALL();
     assert_invariant(!mResourceAllocatorDisposer);
@@ -593,7 +666,10 @@ void FEngine::shutdown() {
     cleanupResourceList(std::move(mMorphTargetBuffers));
     cleanupResourceList(std::move(mSkinningBuffers));
     cleanupResourceList(std::move(mVertexBuffers));
+    // atlases own a texture
+    cleanupResourceList(std::move(mTextureAtlases));
     cleanupResourceList(std::move(mTextures));
+    assert_invariant(mTextureUploadQueue.empty());
     cleanupResourceList(std::move(mRenderTargets));
     cleanupResourceList(std::move(mMaterials));
     cleanupResourceList(std::move(mInstanceBuffers));
@@ -601,6 +677,10 @@ void FEngine::shutdown() {
         cleanupResourceList(std::move(item.second));
     }
 
+    // all the programs are owned by materials
+    mHwProgramFactory.terminate(driver);
+    mHwPipelineStateCache.terminate(driver);
+
     cleanupResourceListLocked(mFenceListLock, std::move(mFences));
 
     driver.destroyTexture(std::move(mDummyOneTexture));
@@ -621,7 +701,7 @@ void FEngine::shutdown() {
 
     // now wait for all pending commands to be executed and the thread to exit
     mCommandBufferQueue.requestExit();
-    if constexpr (!UTILS_HAS_THREADING) {
+    if constexpr (!UTILS_HAS_DRIVER_THREAD) {
         execute();
         getDriverApi().terminate();
     } else {
@@ -651,6 +731,15 @@ void FEngine::prepare() {
     // skipped if the UBO hasn't changed. Still we could have a lot of these.
     DriverApi& driver = getDriverApi();
 
+    // a new frame starts, reclaim the user allocations of the oldest frame
+    mFrameAllocator.nextFrame();
+
+    // upload this frame's share of the pending Texture::setImageAsync() calls
+    mTextureUploadQueue.process(driver);
+
+    // no pass is recording at this point, so it's safe to drop the interned pipeline states
+    mHwPipelineStateCache.gc(driver);
+
     for (auto& materialInstanceList: mMaterialInstances) {
         materialInstanceList.second.forEach([&driver](FMaterialInstance* item) {
             item->commitStreamUniformAssociations(driver);
@@ -665,6 +754,19 @@ void FEngine::prepare() {
     });
 }
 
+uint64_t FEngine::getContentGeneration() noexcept {
+    bool pending = !mTextureUploadQueue.empty() || !mStreams.empty();
+    for (auto const& materialInstanceList: mMaterialInstances) {
+        materialInstanceList.second.forEach([&pending](FMaterialInstance const* item) {
+            pending = pending || item->isDirty();
+        });
+    }
+    if (pending) {
+        markContentChanged();
+    }
+    return mContentGeneration + mTransformManager.getGeneration();
+}
+
 void FEngine::gc() {
     // Note: this runs in a Job
     auto& em = mEntityManager;
@@ -704,6 +806,13 @@ bool FEngine::flushAndWait(uint64_t const timeout) {
     return status == FenceStatus::CONDITION_SATISFIED;
 }
 
+void FEngine::purgeCaches() noexcept {
+    mRenderers.forEach([](FRenderer* renderer) {
+        renderer->purgeCaches();
+    });
+    mColorGradingCache = {};
+}
+
 // -----------------------------------------------------------------------------------------------
 // Render thread / command queue
 // -----------------------------------------------------------------------------------------------
@@ -733,8 +842,11 @@ int FEngine::loop() {
             .forceGLES2Context = mConfig.forceGLES2Context,
             .stereoscopicType =  mConfig.stereoscopicType,
             .assertNativeWindowIsValid = features.backend.opengl.assert_native_window_is_valid,
+            .shaderCompilerThreadCount = mConfig.shaderCompilerThreadCount,
     };
     mDriver = mPlatform->createDriver(mSharedGLContext, driverConfig);
+    // this is read after the barrier below
+    mStartupTimings.driver = getEngineTime().count();
 
     mDriverBarrier.latch();
     if (UTILS_UNLIKELY(!mDriver)) {
@@ -881,6 +993,10 @@ FRenderTarget* FEngine::createRenderTarget(const RenderTarget::Builder& builder)
     return create(mRenderTargets, builder);
 }
 
+FTextureAtlas* FEngine::createTextureAtlas(const TextureAtlas::Builder& builder) noexcept {
+    return create(mTextureAtlases, builder);
+}
+
 /*
  * Special cases
  */
@@ -993,6 +1109,19 @@ void FEngine::createRenderable(const RenderableManager::Builder& builder, Entity
     }
 }
 
+void FEngine::createRenderables(const RenderableManager::Builder& builder,
+        size_t const count, Entity const* entities) {
+    mRenderableManager.create(builder, count, entities);
+    auto& tcm = mTransformManager;
+    // add a transform component to the entities that don't have one
+    tcm.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        if (!tcm.hasComponent(entities[i])) {
+            tcm.create(entities[i], 0, mat4f());
+        }
+    }
+}
+
 void FEngine::createLight(const LightManager::Builder& builder, Entity const entity) {
     mLightManager.create(builder, entity);
 }
@@ -1134,6 +1263,10 @@ bool FEngine::destroy(const FRenderTarget* p) {
     return terminateAndDestroy(p, mRenderTargets);
 }
 
+bool FEngine::destroy(const FTextureAtlas* p) {
+    return terminateAndDestroy(p, mTextureAtlases);
+}
+
 UTILS_NOINLINE
 bool FEngine::destroy(const FView* p) {
     return terminateAndDestroy(p, mViews);
@@ -1319,6 +1452,10 @@ bool FEngine::isValid(const FRenderTarget* p) const {
     return isValid(p, mRenderTargets);
 }
 
+bool FEngine::isValid(const FTextureAtlas* p) const {
+    return isValid(p, mTextureAtlases);
+}
+
 bool FEngine::isValid(const FView* p) const {
     return isValid(p, mViews);
 }
@@ -1343,6 +1480,7 @@ size_t FEngine::getTextureCount() const noexcept { return mTextures.size(); }
 size_t FEngine::getSkyboxeCount() const noexcept { return mSkyboxes.size(); }
 size_t FEngine::getColorGradingCount() const noexcept { return mColorGradings.size(); }
 size_t FEngine::getRenderTargetCount() const noexcept { return mRenderTargets.size(); }
+size_t FEngine::getTextureAtlasCount() const noexcept { return mTextureAtlases.size(); }
 
 size_t FEngine::getMaxShadowMapCount() const noexcept {
     return features.engine.shadows.use_shadow_atlas ?
@@ -1496,7 +1634,7 @@ Engine::Builder& Engine::Builder::features(std::initializer_list<char const *> c
     return *this;
 }
 
-#if UTILS_HAS_THREADING
+#if UTILS_HAS_DRIVER_THREAD
 
 void Engine::Builder::build(Invocable<void(void*)>&& callback) const {
     FEngine::create(*this, std::move(callback));
@@ -1512,7 +1650,8 @@ Engine* Engine::Builder::build() const {
 Engine::Config Engine::BuilderDetails::validateConfig(Config config) noexcept {
     // Rule of thumb: perRenderPassArenaMB must be roughly 1 MB larger than perFrameCommandsMB
     constexpr uint32_t COMMAND_ARENA_OVERHEAD = 1;
-    constexpr uint32_t CONCURRENT_FRAME_COUNT = 3;
+    // the command buffer grows when the backend falls further behind, see CommandBufferQueue
+    constexpr uint32_t CONCURRENT_FRAME_COUNT = 2;
 
     // Use at least the defaults set by the build system
     config.minCommandBufferSizeMB = std::max(
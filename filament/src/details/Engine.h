@@ -21,9 +21,13 @@
 
 #include "Allocators.h"
 #include "DFG.h"
+#include "FrameAllocator.h"
 #include "PostProcessManager.h"
 #include "ResourceList.h"
+#include "TextureUploadQueue.h"
 #include "HwDescriptorSetLayoutFactory.h"
+#include "HwPipelineStateCache.h"
+#include "HwProgramFactory.h"
 #include "HwVertexBufferInfoFactory.h"
 
 #include "components/CameraManager.h"
@@ -37,6 +41,7 @@
 #include "details/Camera.h"
 #include "details/ColorGrading.h"
 #include "details/DebugRegistry.h"
+#include "details/EditJournal.h"
 #include "details/Fence.h"
 #include "details/IndexBuffer.h"
 #include "details/InstanceBuffer.h"
@@ -44,6 +49,7 @@
 #include "details/SkinningBuffer.h"
 #include "details/MorphTargetBuffer.h"
 #include "details/Skybox.h"
+#include "details/TextureAtlas.h"
 
 #include "private/backend/CommandBufferQueue.h"
 #include "private/backend/CommandStream.h"
@@ -140,7 +146,7 @@ public:
 public:
     static Engine* create(Builder const& builder);
 
-#if UTILS_HAS_THREADING
+#if UTILS_HAS_DRIVER_THREAD
     static void create(Builder const& builder, utils::Invocable<void(void* token)>&& callback);
     static FEngine* getEngine(void* token);
 #endif
@@ -170,6 +176,8 @@ public:
     const FIndirectLight* getDefaultIndirectLight() const noexcept { return mDefaultIbl; }
     const FTexture* getDummyCubemap() const noexcept { return mDefaultIblTexture; }
     const FColorGrading* getDefaultColorGrading() const noexcept { return mDefaultColorGrading; }
+
+    FColorGrading::Cache& getColorGradingCache() noexcept { return mColorGradingCache; }
     FMorphTargetBuffer* getDummyMorphTargetBuffer() const { return mDummyMorphTargetBuffer; }
 
     backend::Handle<backend::HwRenderPrimitive> getFullScreenRenderPrimitive() const noexcept {
@@ -204,6 +212,16 @@ public:
         return getDriver().isStereoSupported();
     }
 
+    backend::MemoryBudget getMemoryBudget() const noexcept {
+        return getDriver().getMemoryBudget();
+    }
+
+    // whether the GPU memory usage is close enough to the budget that caches should be released
+    bool isMemoryBudgetExhausted() const noexcept {
+        backend::MemoryBudget const budget = getMemoryBudget();
+        return budget.budget && budget.usage >= budget.budget - budget.budget / 10;
+    }
+
     static size_t getMaxStereoscopicEyes() noexcept {
         return CONFIG_MAX_STEREOSCOPIC_EYES;
     }
@@ -240,6 +258,10 @@ public:
         return mTransformManager;
     }
 
+    FEditJournal& getEditJournal() noexcept {
+        return mEditJournal;
+    }
+
     utils::EntityManager& getEntityManager() noexcept {
         return mEntityManager;
     }
@@ -283,11 +305,19 @@ public:
 
     void* streamAlloc(size_t size, size_t alignment) noexcept;
 
+    void* frameAlloc(size_t const size, size_t const alignment) noexcept {
+        return mFrameAllocator.allocate(size, alignment);
+    }
+
+    TextureUploadQueue& getTextureUploadQueue() noexcept { return mTextureUploadQueue; }
+
     Epoch getEngineEpoch() const { return mEngineEpoch; }
     duration getEngineTime() const noexcept {
         return clock::now() - getEngineEpoch();
     }
 
+    StartupTimings getStartupTimings() const noexcept { return mStartupTimings; }
+
     backend::Handle<backend::HwRenderTarget> getDefaultRenderTarget() const noexcept {
         return mDefaultRenderTarget;
     }
@@ -308,8 +338,11 @@ public:
     FColorGrading* createColorGrading(const ColorGrading::Builder& builder) noexcept;
     FStream* createStream(const Stream::Builder& builder) noexcept;
     FRenderTarget* createRenderTarget(const RenderTarget::Builder& builder) noexcept;
+    FTextureAtlas* createTextureAtlas(const TextureAtlas::Builder& builder) noexcept;
 
     void createRenderable(const RenderableManager::Builder& builder, utils::Entity entity);
+    void createRenderables(const RenderableManager::Builder& builder,
+            size_t count, utils::Entity const* entities);
     void createLight(const LightManager::Builder& builder, utils::Entity entity);
 
     FRenderer* createRenderer() noexcept;
@@ -350,6 +383,7 @@ public:
     bool destroy(const FSwapChain* p);
     bool destroy(const FView* p);
     bool destroy(const FInstanceBuffer* p);
+    bool destroy(const FTextureAtlas* p);
 
     bool isValid(const FBufferObject* p) const;
     bool isValid(const FVertexBuffer* p) const;
@@ -371,6 +405,7 @@ public:
     bool isValid(const FRenderTarget* p) const;
     bool isValid(const FView* p) const;
     bool isValid(const FInstanceBuffer* p) const;
+    bool isValid(const FTextureAtlas* p) const;
 
     size_t getBufferObjectCount() const noexcept;
     size_t getViewCount() const noexcept;
@@ -388,6 +423,7 @@ public:
     size_t getSkyboxeCount() const noexcept;
     size_t getColorGradingCount() const noexcept;
     size_t getRenderTargetCount() const noexcept;
+    size_t getTextureAtlasCount() const noexcept;
 
     void destroy(utils::Entity e);
 
@@ -397,6 +433,8 @@ public:
     void flushAndWait();
     bool flushAndWait(uint64_t timeout);
 
+    void purgeCaches() noexcept;
+
     // flush the current buffer
     void flush();
 
@@ -422,6 +460,12 @@ public:
     void prepare();
     void gc();
 
+    // Render-on-demand support. markContentChanged() is called by the public API calls that can
+    // change the rendered images, getContentGeneration() changes whenever one was made, or when
+    // pending work (texture uploads, streams, material instance updates) will change them.
+    void markContentChanged() noexcept { mContentGeneration++; }
+    uint64_t getContentGeneration() noexcept;
+
     using ShaderContent = utils::FixedCapacityVector<uint8_t>;
 
     ShaderContent& getVertexShaderContent() const noexcept {
@@ -474,6 +518,14 @@ public:
         return mHwDescriptorSetLayoutFactory;
     }
 
+    HwProgramFactory& getProgramFactory() noexcept {
+        return mHwProgramFactory;
+    }
+
+    HwPipelineStateCache& getPipelineStateCache() noexcept {
+        return mHwPipelineStateCache;
+    }
+
     DescriptorSetLayout const& getPerViewDescriptorSetLayoutDepthVariant() const noexcept {
         return mPerViewDescriptorSetLayoutDepthVariant;
     }
@@ -491,6 +543,10 @@ public:
     backend::Handle<backend::HwTexture> getOneTextureArray() const { return mDummyOneTextureArray; }
     backend::Handle<backend::HwTexture> getZeroTextureArray() const { return mDummyZeroTextureArray; }
 
+    // number of polls of the command buffer queue before sleeping, with
+    // backend.command_buffer_queue.spin_wait. That's a few tens of microseconds.
+    static constexpr uint32_t COMMAND_BUFFER_QUEUE_SPIN_COUNT = 1000;
+
     static constexpr size_t MiB = 1024u * 1024u;
     size_t getMinCommandBufferSize() const noexcept { return mConfig.minCommandBufferSizeMB * MiB; }
     size_t getCommandBufferSize() const noexcept { return mConfig.commandBufferSizeMB * MiB; }
@@ -521,6 +577,10 @@ private:
     int loop();
     void flushCommandBuffer(backend::CommandBufferQueue& commandBufferQueue) const;
 
+#if FILAMENT_ENABLE_COMMAND_PROFILING
+    void logCommandProfile();
+#endif
+
     template<typename T>
     bool isValid(const T* ptr, ResourceList<T> const& list) const;
 
@@ -557,9 +617,12 @@ private:
     FTransformManager mTransformManager;
     FLightManager mLightManager;
     FCameraManager mCameraManager;
+    FEditJournal mEditJournal;
     std::shared_ptr<ResourceAllocatorDisposer> mResourceAllocatorDisposer;
     HwVertexBufferInfoFactory mHwVertexBufferInfoFactory;
     HwDescriptorSetLayoutFactory mHwDescriptorSetLayoutFactory;
+    HwProgramFactory mHwProgramFactory;
+    HwPipelineStateCache mHwPipelineStateCache;
     DescriptorSetLayout mPerViewDescriptorSetLayoutDepthVariant;
     DescriptorSetLayout mPerViewDescriptorSetLayoutSsrVariant;
     DescriptorSetLayout mPerRenderableDescriptorSetLayout;
@@ -578,6 +641,7 @@ private:
     ResourceList<FIndirectLight> mIndirectLights{ "IndirectLight" };
     ResourceList<FMaterial> mMaterials{ "Material" };
     ResourceList<FTexture> mTextures{ "Texture" };
+    ResourceList<FTextureAtlas> mTextureAtlases{ "TextureAtlas" };
     ResourceList<FSkybox> mSkyboxes{ "Skybox" };
     ResourceList<FColorGrading> mColorGradings{ "ColorGrading" };
     ResourceList<FRenderTarget> mRenderTargets{ "RenderTarget" };
@@ -599,9 +663,12 @@ private:
     static_assert( sizeof(mDriverApiStorage) >= sizeof(DriverApi) );
 
     uint32_t mFlushCounter = 0;
+    uint64_t mContentGeneration = 0;
 
     RootArenaScope::Arena mPerRenderPassArena;
     HeapAllocatorArena mHeapAllocator;
+    FrameAllocator mFrameAllocator;
+    TextureUploadQueue mTextureUploadQueue;
 
     utils::JobSystem mJobSystem;
     static uint32_t getJobSystemThreadPoolSize(Config const& config) noexcept;
@@ -609,6 +676,7 @@ private:
     std::default_random_engine mRandomEngine;
 
     Epoch mEngineEpoch;
+    StartupTimings mStartupTimings;
 
     mutable FMaterial const* mDefaultMaterial = nullptr;
     mutable FMaterial const* mSkyboxMaterial = nullptr;
@@ -618,6 +686,7 @@ private:
     mutable FIndirectLight* mDefaultIbl = nullptr;
 
     mutable FColorGrading* mDefaultColorGrading = nullptr;
+    FColorGrading::Cache mColorGradingCache;
     FMorphTargetBuffer* mDummyMorphTargetBuffer = nullptr;
 
     mutable utils::CountDownLatch mDriverBarrier;
@@ -681,6 +750,11 @@ public:
         struct {
             bool combine_multiview_images = false;
         } stereo;
+        struct {
+            // When set to true, the per-command profile of the last frame is logged. This
+            // requires the FILAMENT_ENABLE_COMMAND_PROFILING cmake option.
+            bool log_command_profile = false;
+        } backend;
         matdbg::DebugServer* server = nullptr;
         fgviewer::DebugServer* fgviewerServer = nullptr;
     } debug;
@@ -689,10 +763,25 @@ public:
         struct {
             struct {
                 bool use_1d_lut = false;
+                bool incremental = false;
             } color_grading;
             struct {
                 bool use_shadow_atlas = false;
+                bool use_coverage_based_size = false;
             } shadows;
+            struct {
+                bool parallel_sort_commands = false;
+                bool cache_commands = false;
+            } render_pass;
+            struct {
+                bool occlusion_culling = false;
+            } culling;
+            struct {
+                bool floating_origin = false;
+            } view;
+            struct {
+                bool incremental_ubo_updates = false;
+            } scene;
             struct {
                 // TODO: default the following two flags to true.
                 bool assert_material_instance_in_use = false;
@@ -703,6 +792,9 @@ public:
             struct {
                 bool assert_native_window_is_valid = false;
             } opengl;
+            struct {
+                bool spin_wait = false;
+            } command_buffer_queue;
             bool disable_parallel_shader_compile = false;
             bool disable_handle_use_after_free_check = false;
             bool disable_heap_handle_tags = true; // FIXME: this should be false
@@ -722,12 +814,36 @@ public:
             { "backend.opengl.assert_native_window_is_valid",
               "Asserts that the ANativeWindow is valid when rendering starts.",
               &features.backend.opengl.assert_native_window_is_valid, true },
+            { "backend.command_buffer_queue.spin_wait",
+              "The main and driver threads spin for a while before sleeping, when waiting for each other.",
+              &features.backend.command_buffer_queue.spin_wait, true },
             { "engine.color_grading.use_1d_lut",
               "Uses a 1D LUT for color grading.",
               &features.engine.color_grading.use_1d_lut, false },
+            { "engine.color_grading.incremental",
+              "Only re-evaluates the tone mapping and output stages of a 3D LUT when the adjustments don't change.",
+              &features.engine.color_grading.incremental, false },
             { "engine.shadows.use_shadow_atlas",
               "Uses an array of atlases to store shadow maps.",
               &features.engine.shadows.use_shadow_atlas, false },
+            { "engine.shadows.use_coverage_based_size",
+              "Sizes spot and point light shadow maps from their screen coverage (atlas only).",
+              &features.engine.shadows.use_coverage_based_size, false },
+            { "engine.render_pass.parallel_sort_commands",
+              "Sorts RenderPass commands in parallel chunks followed by a parallel merge.",
+              &features.engine.render_pass.parallel_sort_commands, false },
+            { "engine.render_pass.cache_commands",
+              "Reuses the color pass commands of the previous frame when they haven't changed.",
+              &features.engine.render_pass.cache_commands, false },
+            { "engine.culling.occlusion_culling",
+              "Culls renderables hidden behind the depth buffer read back from a previous frame.",
+              &features.engine.culling.occlusion_culling, false },
+            { "engine.view.floating_origin",
+              "Moves the world origin to the camera only when the camera gets far from it.",
+              &features.engine.view.floating_origin, false },
+            { "engine.scene.incremental_ubo_updates",
+              "Only uploads the per-renderable data that changed since the previous frame.",
+              &features.engine.scene.incremental_ubo_updates, false },
             { "features.engine.debug.assert_material_instance_in_use",
               "Assert when a MaterialInstance is destroyed while it is in use by RenderableManager.",
               &features.engine.debug.assert_material_instance_in_use, false },
@@ -28,6 +28,7 @@ namespace filament {
 struct IndexBuffer::BuilderDetails {
     uint32_t mIndexCount = 0;
     IndexType mIndexType = IndexType::UINT;
+    BufferUsage mUsage = BufferUsage::STATIC;
 };
 
 using BuilderType = IndexBuffer;
@@ -48,6 +49,11 @@ IndexBuffer::Builder& IndexBuffer::Builder::bufferType(IndexType const indexType
     return *this;
 }
 
+IndexBuffer::Builder& IndexBuffer::Builder::usage(BufferUsage const usage) noexcept {
+    mImpl->mUsage = usage;
+    return *this;
+}
+
 IndexBuffer::Builder& IndexBuffer::Builder::name(const char* name, size_t const len) noexcept {
     return BuilderNameMixin::name(name, len);
 }
@@ -73,7 +79,7 @@ FIndexBuffer::FIndexBuffer(FEngine& engine, const Builder& builder)
     mHandle = driver.createIndexBuffer(
             (backend::ElementType)builder->mIndexType,
             uint32_t(builder->mIndexCount),
-            backend::BufferUsage::STATIC);
+            builder->mUsage);
     if (auto name = builder.getName(); !name.empty()) {
         driver.setDebugTag(mHandle.getId(), std::move(name));
     }
@@ -41,37 +41,8 @@ static constexpr bool CONFIG_IBL_USE_IRRADIANCE_MAP = false;
 
 // ------------------------------------------------------------------------------------------------
 
-struct IndirectLight::BuilderDetails {
-    Texture const* mReflectionsMap = nullptr;
-    Texture const* mIrradianceMap = nullptr;
-    float3 mIrradianceCoefs[9] = { 65504.0f }; // magic value (max fp16) to indicate sh are not set
-    mat3f mRotation = {};
-    float mIntensity = FIndirectLight::DEFAULT_INTENSITY;
-};
-
-using BuilderType = IndirectLight;
-BuilderType::Builder::Builder() noexcept = default;
-BuilderType::Builder::~Builder() noexcept = default;
-BuilderType::Builder::Builder(Builder const& rhs) noexcept = default;
-BuilderType::Builder::Builder(Builder&& rhs) noexcept = default;
-BuilderType::Builder& BuilderType::Builder::operator=(Builder const& rhs) noexcept = default;
-BuilderType::Builder& BuilderType::Builder::operator=(Builder&& rhs) noexcept = default;
-
-IndirectLight::Builder& IndirectLight::Builder::reflections(Texture const* cubemap) noexcept {
-    mImpl->mReflectionsMap = cubemap;
-    return *this;
-}
-
-IndirectLight::Builder& IndirectLight::Builder::irradiance(uint8_t bands, float3 const* sh) noexcept {
-    // clamp to 3 bands for now
-    bands = std::min(bands, uint8_t(3));
-    size_t numCoefs = bands * bands;
-    std::fill(std::begin(mImpl->mIrradianceCoefs), std::end(mImpl->mIrradianceCoefs), 0.0f);
-    std::copy_n(sh, numCoefs, std::begin(mImpl->mIrradianceCoefs));
-    return *this;
-}
-
-IndirectLight::Builder& IndirectLight::Builder::radiance(uint8_t bands, float3 const* sh) noexcept {
+// Converts radiance SH to the pre-scaled irradiance SH the shaders use.
+static void radianceToIrradiance(uint8_t const bands, float3 const* sh, float3* irradiance) noexcept {
     // Coefficient for the polynomial form of the SH functions -- these were taken from
     // "Stupid Spherical Harmonics (SH)" by Peter-Pike Sloan
     // They simply come for expanding the computation of each SH function.
@@ -125,11 +96,47 @@ IndirectLight::Builder& IndirectLight::Builder::radiance(uint8_t bands, float3 c
     static_assert(Debug::almost(A[7], -0.273137f), "coefficient mismatch");
     static_assert(Debug::almost(A[8],  0.136569f), "coefficient mismatch");
 
-    float3 irradiance[9];
-    bands = std::min(bands, uint8_t(3));
     for (size_t i = 0, c = bands * bands; i<c; ++i) {
         irradiance[i] = sh[i] * A[i];
     }
+}
+
+// ------------------------------------------------------------------------------------------------
+
+struct IndirectLight::BuilderDetails {
+    Texture const* mReflectionsMap = nullptr;
+    Texture const* mIrradianceMap = nullptr;
+    float3 mIrradianceCoefs[9] = { 65504.0f }; // magic value (max fp16) to indicate sh are not set
+    mat3f mRotation = {};
+    float mIntensity = FIndirectLight::DEFAULT_INTENSITY;
+};
+
+using BuilderType = IndirectLight;
+BuilderType::Builder::Builder() noexcept = default;
+BuilderType::Builder::~Builder() noexcept = default;
+BuilderType::Builder::Builder(Builder const& rhs) noexcept = default;
+BuilderType::Builder::Builder(Builder&& rhs) noexcept = default;
+BuilderType::Builder& BuilderType::Builder::operator=(Builder const& rhs) noexcept = default;
+BuilderType::Builder& BuilderType::Builder::operator=(Builder&& rhs) noexcept = default;
+
+IndirectLight::Builder& IndirectLight::Builder::reflections(Texture const* cubemap) noexcept {
+    mImpl->mReflectionsMap = cubemap;
+    return *this;
+}
+
+IndirectLight::Builder& IndirectLight::Builder::irradiance(uint8_t bands, float3 const* sh) noexcept {
+    // clamp to 3 bands for now
+    bands = std::min(bands, uint8_t(3));
+    size_t numCoefs = bands * bands;
+    std::fill(std::begin(mImpl->mIrradianceCoefs), std::end(mImpl->mIrradianceCoefs), 0.0f);
+    std::copy_n(sh, numCoefs, std::begin(mImpl->mIrradianceCoefs));
+    return *this;
+}
+
+IndirectLight::Builder& IndirectLight::Builder::radiance(uint8_t bands, float3 const* sh) noexcept {
+    float3 irradiance[9];
+    bands = std::min(bands, uint8_t(3));
+    radianceToIrradiance(bands, sh, irradiance);
     return this->irradiance(bands, irradiance);
 }
 
@@ -170,7 +177,8 @@ IndirectLight* IndirectLight::Builder::build(Engine& engine) {
 
 // ------------------------------------------------------------------------------------------------
 
-FIndirectLight::FIndirectLight(FEngine& engine, const Builder& builder) noexcept {
+FIndirectLight::FIndirectLight(FEngine& engine, const Builder& builder) noexcept
+        : mEngine(engine) {
     if (builder->mReflectionsMap) {
         mReflectionsTexture = downcast(builder->mReflectionsMap);
         mLevelCount = builder->mReflectionsMap->getLevels();
@@ -199,6 +207,20 @@ void FIndirectLight::terminate(FEngine& engine) {
     }
 }
 
+void FIndirectLight::setIrradiance(uint8_t bands, float3 const* sh) noexcept {
+    // clamp to 3 bands for now
+    bands = std::min(bands, uint8_t(3));
+    std::fill(mIrradianceCoefs.begin(), mIrradianceCoefs.end(), 0.0f);
+    std::copy_n(sh, bands * bands, mIrradianceCoefs.begin());
+}
+
+void FIndirectLight::setRadiance(uint8_t bands, float3 const* sh) noexcept {
+    float3 irradiance[9];
+    bands = std::min(bands, uint8_t(3));
+    radianceToIrradiance(bands, sh, irradiance);
+    setIrradiance(bands, irradiance);
+}
+
 backend::Handle<backend::HwTexture> FIndirectLight::getReflectionHwHandle() const noexcept {
     return mReflectionsTexture ? mReflectionsTexture->getHwHandleForSampling()
                                : backend::Handle<backend::HwTexture>{};
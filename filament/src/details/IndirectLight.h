@@ -40,6 +40,8 @@ public:
 
     FIndirectLight(FEngine& engine, const Builder& builder) noexcept;
 
+    FEngine& getEngine() const noexcept { return mEngine; }
+
     void terminate(FEngine& engine);
 
     backend::Handle<backend::HwTexture> getReflectionHwHandle() const noexcept;
@@ -48,6 +50,8 @@ public:
     float getIntensity() const noexcept { return mIntensity; }
     void setIntensity(float const intensity) noexcept { mIntensity = intensity; }
     void setRotation(math::mat3f const& rotation) noexcept { mRotation = rotation; }
+    void setIrradiance(uint8_t bands, math::float3 const* sh) noexcept;
+    void setRadiance(uint8_t bands, math::float3 const* sh) noexcept;
     const math::mat3f& getRotation() const noexcept { return mRotation; }
     FTexture const* getReflectionsTexture() const noexcept { return mReflectionsTexture; }
     FTexture const* getIrradianceTexture() const noexcept { return mIrradianceTexture; }
@@ -58,6 +62,7 @@ public:
     static math::float4 getColorEstimate(const math::float3 sh[9], math::float3 direction) noexcept;
 
 private:
+    FEngine& mEngine;
     FTexture const* mReflectionsTexture = nullptr;
     FTexture const* mIrradianceTexture = nullptr;
     std::array<math::float3, 9> mIrradianceCoefs;
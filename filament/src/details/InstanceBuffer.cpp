@@ -16,6 +16,8 @@
 
 #include "details/InstanceBuffer.h"
 
+#include "Culler.h"
+
 #include <details/Engine.h>
 #include <private/filament/UibStructs.h>
 
@@ -26,13 +28,28 @@
 #include <math/mat3.h>
 #include <math/vec3.h>
 
+#include <algorithm>
+
+#include <string.h>
+
 namespace filament {
 
 using namespace backend;
 
+static void setInstanceData(PerRenderableData& data, PerRenderableData const& ubo,
+        math::mat4f const& model) noexcept {
+    data = ubo;
+    data.worldFromModelMatrix = model;
+
+    math::mat3f m = math::mat3f::getTransformForNormals(model.upperLeft());
+    data.worldFromModelNormalMatrix = math::prescaleForNormals(m);
+}
+
 struct InstanceBuffer::BuilderDetails {
     size_t mInstanceCount = 0;
     math::mat4f const* mLocalTransforms = nullptr;
+    Box mInstanceBoundingBox = {};
+    bool mCulling = false;
 };
 
 using BuilderType = InstanceBuffer;
@@ -52,6 +69,13 @@ InstanceBuffer::Builder& InstanceBuffer::Builder::localTransforms(
     return *this;
 }
 
+InstanceBuffer::Builder& InstanceBuffer::Builder::instanceBoundingBox(
+        Box const& boundingBox) noexcept {
+    mImpl->mInstanceBoundingBox = boundingBox;
+    mImpl->mCulling = true;
+    return *this;
+}
+
 InstanceBuffer::Builder& InstanceBuffer::Builder::name(const char* name, size_t const len) noexcept {
     return BuilderNameMixin::name(name, len);
 }
@@ -72,7 +96,8 @@ InstanceBuffer* InstanceBuffer::Builder::build(Engine& engine) {
 // ------------------------------------------------------------------------------------------------
 
 FInstanceBuffer::FInstanceBuffer(FEngine& engine, const Builder& builder)
-    : mName(builder.getName()) {
+    : mEngine(engine), mName(builder.getName()),
+      mInstanceBoundingBox(builder->mInstanceBoundingBox), mCulling(builder->mCulling) {
     mInstanceCount = builder->mInstanceCount;
 
     mLocalTransforms.reserve(mInstanceCount);
@@ -91,23 +116,59 @@ void FInstanceBuffer::setLocalTransforms(
             << " instances, but trying to set " << count 
             << " transforms at offset " << offset << ".";
     memcpy(mLocalTransforms.data() + offset, localTransforms, sizeof(math::mat4f) * count);
+    mDirtyBegin = std::min(mDirtyBegin, offset);
+    mDirtyEnd = std::max(mDirtyEnd, offset + count);
 }
 
-void FInstanceBuffer::prepare(FEngine& engine, math::mat4f rootTransform,
-        const PerRenderableData& ubo, Handle<HwBufferObject> handle) {
+size_t FInstanceBuffer::prepare(FEngine& engine, math::mat4f rootTransform,
+        const PerRenderableData& ubo, Handle<HwBufferObject> handle,
+        Frustum const& cullingFrustum) {
     DriverApi& driver = engine.getDriverApi();
 
+    // When the buffer already holds this renderable's instances, only upload the ones that moved.
+    // Culled instances are compacted, so their position in the buffer changes from view to view.
+    bool const upToDate = !mCulling && handle == mUploadedHandle &&
+            !memcmp(&rootTransform, &mUploadedRootTransform, sizeof(math::mat4f)) &&
+            !memcmp(&ubo, &mUploadedUbo, sizeof(PerRenderableData));
+    mUploadedHandle = handle;
+    mUploadedRootTransform = rootTransform;
+    mUploadedUbo = ubo;
+    if (upToDate) {
+        if (mDirtyBegin < mDirtyEnd) {
+            size_t const count = mDirtyEnd - mDirtyBegin;
+            PerRenderableData* const stagingBuffer =
+                    (PerRenderableData*)malloc(count * sizeof(PerRenderableData));
+            for (size_t i = 0; i < count; i++) {
+                setInstanceData(stagingBuffer[i], ubo,
+                        rootTransform * mLocalTransforms[mDirtyBegin + i]);
+            }
+            driver.updateBufferObject(handle, {
+                    stagingBuffer, count * sizeof(PerRenderableData),
+                    +[](void* buffer, size_t, void*) {
+                        free(buffer);
+                    }
+            }, uint32_t(mDirtyBegin * sizeof(PerRenderableData)));
+        }
+        mDirtyBegin = mInstanceCount;
+        mDirtyEnd = 0;
+        return mInstanceCount;
+    }
+    mDirtyBegin = mInstanceCount;
+    mDirtyEnd = 0;
+
     // TODO: allocate this staging buffer from a pool.
     uint32_t stagingBufferSize = sizeof(PerRenderableUib);
     PerRenderableData* stagingBuffer = (PerRenderableData*)malloc(stagingBufferSize);
     // TODO: consider using JobSystem to parallelize this.
+    // Visible instances are compacted at the front of the buffer.
+    size_t visibleCount = 0;
     for (size_t i = 0, c = mInstanceCount; i < c; i++) {
-        stagingBuffer[i] = ubo;
         math::mat4f model = rootTransform * mLocalTransforms[i];
-        stagingBuffer[i].worldFromModelMatrix = model;
-
-        math::mat3f m = math::mat3f::getTransformForNormals(model.upperLeft());
-        stagingBuffer[i].worldFromModelNormalMatrix = math::prescaleForNormals(m);
+        if (mCulling && !Culler::intersects(cullingFrustum,
+                Box::transform(model.upperLeft(), model[3].xyz, mInstanceBoundingBox))) {
+            continue;
+        }
+        setInstanceData(stagingBuffer[visibleCount++], ubo, model);
     }
     driver.updateBufferObject(handle, {
             stagingBuffer, stagingBufferSize,
@@ -115,6 +176,7 @@ void FInstanceBuffer::prepare(FEngine& engine, math::mat4f rootTransform,
                 free(buffer);
             }
     }, 0);
+    return visibleCount;
 }
 
 void FInstanceBuffer::terminate(FEngine& engine) {
@@ -19,8 +19,11 @@
 
 #include "downcast.h"
 
+#include <filament/Box.h>
 #include <filament/InstanceBuffer.h>
 
+#include <private/filament/UibStructs.h>
+
 #include <backend/Handle.h>
 
 #include <math/mat4.h>
@@ -31,30 +34,46 @@
 namespace filament {
 
 class FEngine;
-
-struct PerRenderableData;
+class Frustum;
 
 class FInstanceBuffer : public InstanceBuffer {
 public:
     FInstanceBuffer(FEngine& engine, const Builder& builder);
 
+    FEngine& getEngine() const noexcept { return mEngine; }
+
     void terminate(FEngine& engine);
 
     inline size_t getInstanceCount() const noexcept { return mInstanceCount; }
 
     void setLocalTransforms(math::mat4f const* localTransforms, size_t count, size_t offset);
 
-    void prepare(FEngine& engine, math::mat4f rootTransform, const PerRenderableData& ubo,
-            backend::Handle<backend::HwBufferObject> handle);
+    // Uploads the per-instance data and returns the number of instances to draw, which is less
+    // than getInstanceCount() when instances are culled.
+    size_t prepare(FEngine& engine, math::mat4f rootTransform, const PerRenderableData& ubo,
+            backend::Handle<backend::HwBufferObject> handle, Frustum const& cullingFrustum);
+
+    bool hasInstanceCulling() const noexcept { return mCulling; }
 
     utils::CString const& getName() const noexcept { return mName; }
 
 private:
     friend class RenderableManager;
 
+    FEngine& mEngine;
     utils::FixedCapacityVector<math::mat4f> mLocalTransforms;
     utils::CString mName;
     size_t mInstanceCount;
+    Box mInstanceBoundingBox;
+    bool mCulling;
+
+    // What the last prepare() uploaded, so that only the instances changed since then by
+    // setLocalTransforms() need to be uploaded again.
+    backend::Handle<backend::HwBufferObject> mUploadedHandle;
+    math::mat4f mUploadedRootTransform;
+    PerRenderableData mUploadedUbo{};
+    size_t mDirtyBegin = 0;
+    size_t mDirtyEnd = 0;
 };
 
 FILAMENT_DOWNCAST(InstanceBuffer)
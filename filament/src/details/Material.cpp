@@ -78,6 +78,14 @@ using namespace backend;
 using namespace filaflat;
 using namespace utils;
 
+static void checkMaterialVersion(MaterialParser const& materialParser) {
+    uint32_t version = 0;
+    materialParser.getMaterialVersion(&version);
+    FILAMENT_CHECK_PRECONDITION(version == MATERIAL_VERSION)
+            << "Material version mismatch. Expected " << MATERIAL_VERSION << " but received "
+            << version << ".";
+}
+
 static std::unique_ptr<MaterialParser> createParser(Backend const backend,
         FixedCapacityVector<ShaderLanguage> languages, const void* data, size_t size) {
     // unique_ptr so we don't leak MaterialParser on failures below
@@ -107,11 +115,7 @@ static std::unique_ptr<MaterialParser> createParser(Backend const backend,
     FILAMENT_CHECK_PRECONDITION(materialResult == MaterialParser::ParseResult::SUCCESS)
             << "could not parse the material package";
 
-    uint32_t version = 0;
-    materialParser->getMaterialVersion(&version);
-    FILAMENT_CHECK_PRECONDITION(version == MATERIAL_VERSION)
-            << "Material version mismatch. Expected " << MATERIAL_VERSION << " but received "
-            << version << ".";
+    checkMaterialVersion(*materialParser);
 
     assert_invariant(backend != Backend::DEFAULT && "Default backend has not been resolved.");
 
@@ -134,6 +138,8 @@ FMaterial::DefaultMaterialBuilder::DefaultMaterialBuilder() {
     mImpl->mDefaultMaterial = true;
 }
 
+FMaterial::DefaultMaterialBuilder::~DefaultMaterialBuilder() noexcept = default;
+
 using BuilderType = Material;
 BuilderType::Builder::Builder() noexcept = default;
 BuilderType::Builder::~Builder() noexcept = default;
@@ -169,11 +175,8 @@ template Material::Builder& Material::Builder::constant<int32_t>(const char*, si
 template Material::Builder& Material::Builder::constant<float>(const char*, size_t, float);
 template Material::Builder& Material::Builder::constant<bool>(const char*, size_t, bool);
 
-Material* Material::Builder::build(Engine& engine) const {
-    std::unique_ptr<MaterialParser> materialParser = createParser(
-        downcast(engine).getBackend(), downcast(engine).getShaderLanguage(),
-        mImpl->mPayload, mImpl->mSize);
-
+static FMaterial* buildMaterial(Material::Builder const& builder, FEngine& engine,
+        std::unique_ptr<MaterialParser> materialParser) {
     if (!materialParser) {
         return nullptr;
     }
@@ -183,7 +186,7 @@ Material* Material::Builder::build(Engine& engine) const {
     bitset32 shaderModels;
     shaderModels.setValue(v);
 
-    ShaderModel const shaderModel = downcast(engine).getShaderModel();
+    ShaderModel const shaderModel = engine.getShaderModel();
     if (!shaderModels.test(static_cast<uint32_t>(shaderModel))) {
         CString name;
         materialParser->getName(&name);
@@ -225,7 +228,44 @@ Material* Material::Builder::build(Engine& engine) const {
         }
     }
 
-    return downcast(engine).createMaterial(*this, std::move(materialParser));
+    return engine.createMaterial(builder, std::move(materialParser));
+}
+
+Material* Material::Builder::build(Engine& engine) const {
+    std::unique_ptr<MaterialParser> materialParser = createParser(
+        downcast(engine).getBackend(), downcast(engine).getShaderLanguage(),
+        mImpl->mPayload, mImpl->mSize);
+
+    return buildMaterial(*this, downcast(engine), std::move(materialParser));
+}
+
+void FMaterial::DefaultMaterialBuilder::parse(FEngine const& engine) noexcept {
+    auto materialParser = std::make_unique<MaterialParser>(
+            engine.getShaderLanguage(), mImpl->mPayload, mImpl->mSize);
+    // errors are reported by build(), which parses the package again in that case
+    if (materialParser->parse() == MaterialParser::ParseResult::SUCCESS) {
+        mMaterialParser = std::move(materialParser);
+    }
+}
+
+FMaterial* FMaterial::DefaultMaterialBuilder::build(FEngine& engine) {
+    if (!mMaterialParser) {
+        return downcast(Builder::build(engine));
+    }
+    if (engine.getBackend() != Backend::NOOP) {
+        checkMaterialVersion(*mMaterialParser);
+    }
+    return buildMaterial(*this, engine, std::move(mMaterialParser));
+}
+
+Material* Material::Builder::buildAsync(Engine& engine, CompilerPriorityQueue const priority,
+        UserVariantFilterMask const variants, CallbackHandler* handler,
+        Invocable<void(Material*)>&& callback) const {
+    FMaterial* const material = downcast(build(engine));
+    if (material) {
+        material->compile(priority, variants, handler, std::move(callback), true);
+    }
+    return material;
 }
 
 FMaterial::FMaterial(FEngine& engine, const Builder& builder,
@@ -413,7 +453,8 @@ void FMaterial::terminate(FEngine& engine) {
 void FMaterial::compile(CompilerPriorityQueue const priority,
         UserVariantFilterMask variantSpec,
         CallbackHandler* handler,
-        Invocable<void(Material*)>&& callback) noexcept {
+        Invocable<void(Material*)>&& callback,
+        bool const allBackends) noexcept {
 
     // Turn off the STE variant if stereo is not supported.
     if (!mEngine.getDriverApi().isStereoSupported()) {
@@ -423,7 +464,7 @@ void FMaterial::compile(CompilerPriorityQueue const priority,
     UserVariantFilterMask const variantFilter =
             ~variantSpec & UserVariantFilterMask(UserVariantFilterBit::ALL);
 
-    if (UTILS_LIKELY(mEngine.getDriverApi().isParallelShaderCompileSupported())) {
+    if (UTILS_LIKELY(allBackends || mEngine.getDriverApi().isParallelShaderCompileSupported())) {
         auto const& variants = isVariantLit() ?
                 VariantUtils::getLitVariants() : VariantUtils::getUnlitVariants();
         for (auto const variant: variants) {
@@ -536,19 +577,25 @@ void FMaterial::getSurfaceProgramSlow(Variant const variant,
     Variant const vertexVariant   = Variant::filterVariantVertex(variant);
     Variant const fragmentVariant = Variant::filterVariantFragment(variant);
 
-    Program pb{ getProgramWithVariants(variant, vertexVariant, fragmentVariant) };
-    pb.priorityQueue(priorityQueue);
-    pb.multiview(
+    bool const multiview =
             mEngine.getConfig().stereoscopicType == StereoscopicType::MULTIVIEW &&
-            Variant::isStereoVariant(variant));
-    createAndCacheProgram(std::move(pb), variant);
+            Variant::isStereoVariant(variant);
+
+    createAndCacheProgram(variant, multiview, [&]() {
+        Program pb{ getProgramWithVariants(variant, vertexVariant, fragmentVariant) };
+        pb.priorityQueue(priorityQueue);
+        pb.multiview(multiview);
+        return pb;
+    });
 }
 
 void FMaterial::getPostProcessProgramSlow(Variant const variant,
         CompilerPriorityQueue const priorityQueue) const noexcept {
-    Program pb{ getProgramWithVariants(variant, variant, variant) };
-    pb.priorityQueue(priorityQueue);
-    createAndCacheProgram(std::move(pb), variant);
+    createAndCacheProgram(variant, false, [&]() {
+        Program pb{ getProgramWithVariants(variant, variant, variant) };
+        pb.priorityQueue(priorityQueue);
+        return pb;
+    });
 }
 
 Program FMaterial::getProgramWithVariants(
@@ -622,7 +669,22 @@ Program FMaterial::getProgramWithVariants(
     return program;
 }
 
-void FMaterial::createAndCacheProgram(Program&& p, Variant const variant) const noexcept {
+HwProgramFactory::Key FMaterial::getProgramAlias(Variant const variant,
+        bool const multiview) const noexcept {
+    // The package determines the shaders, bindings and push constants of a variant, the rest
+    // comes from the specialization constants set by the Builder.
+    size_t seed = size_t(mMaterialParser->getPackageHash());
+    hash::combine(seed, variant.key);
+    hash::combine(seed, multiview);
+    for (auto const& constant : mSpecializationConstants) {
+        hash::combine(seed, constant.id);
+        std::visit([&seed](auto const value) { hash::combine(seed, value); }, constant.value);
+    }
+    return { uint64_t(seed), uint64_t(mMaterialParser->getPackageSize()) };
+}
+
+void FMaterial::createAndCacheProgram(Variant const variant, bool const multiview,
+        Invocable<Program()>&& makeProgram) const noexcept {
     FEngine const& engine = mEngine;
     DriverApi& driverApi = mEngine.getDriverApi();
 
@@ -640,8 +702,14 @@ void FMaterial::createAndCacheProgram(Program&& p, Variant const variant) const
         }
     }
 
-    auto const program = driverApi.createProgram(std::move(p));
-    driverApi.setDebugTag(program.getId(), mName);
+    // identical programs of other materials are shared; programs coming from the same package
+    // are found without loading their shaders
+    HwProgramFactory& programFactory = mEngine.getProgramFactory();
+    HwProgramFactory::Key const alias = getProgramAlias(variant, multiview);
+    auto program = programFactory.find(alias);
+    if (!program) {
+        program = programFactory.create(driverApi, makeProgram(), mName, alias);
+    }
     assert_invariant(program);
     mCachedPrograms[variant.key] = program;
 
@@ -764,8 +832,15 @@ void FMaterial::destroyPrograms(FEngine& engine,
         Variant::type_t const variantMask, Variant::type_t const variantValue) {
 
     DriverApi& driverApi = engine.getDriverApi();
+    HwProgramFactory& programFactory = engine.getProgramFactory();
     auto& cachedPrograms = mCachedPrograms;
 
+    // programs can be shared with other materials, they're only destroyed with their last user
+    auto destroyProgram = [&](Handle<HwProgram>& program) {
+        programFactory.destroy(driverApi, program);
+        program.clear();
+    };
+
     switch (mMaterialDomain) {
         case MaterialDomain::SURFACE: {
             if (mIsDefaultMaterial || mHasCustomDepthShader) {
@@ -775,7 +850,7 @@ void FMaterial::destroyPrograms(FEngine& engine,
                         // Only destroy if the handle is valid. Not strictly needed, but we have a lot
                         // of variants, and this generates traffic in the command queue.
                         if (cachedPrograms[k]) {
-                            driverApi.destroyProgram(std::move(cachedPrograms[k]));
+                            destroyProgram(cachedPrograms[k]);
                         }
                     }
                 }
@@ -806,7 +881,7 @@ void FMaterial::destroyPrograms(FEngine& engine,
                                 continue;
                             }
 
-                            driverApi.destroyProgram(std::move(cachedPrograms[k]));
+                            destroyProgram(cachedPrograms[k]);
                         }
                     }
                 }
@@ -819,7 +894,7 @@ void FMaterial::destroyPrograms(FEngine& engine,
                     // Only destroy if the handle is valid. Not strictly needed, but we have a lot
                     // of variant, and this generates traffic in the command queue.
                     if (cachedPrograms[k]) {
-                        driverApi.destroyProgram(std::move(cachedPrograms[k]));
+                        destroyProgram(cachedPrograms[k]);
                     }
                 }
             }
@@ -827,7 +902,9 @@ void FMaterial::destroyPrograms(FEngine& engine,
         }
         case MaterialDomain::COMPUTE: {
             // Compute programs don't have variants
-            driverApi.destroyProgram(std::move(cachedPrograms[0]));
+            if (cachedPrograms[0]) {
+                destroyProgram(cachedPrograms[0]);
+            }
             break;
         }
     }
@@ -18,6 +18,7 @@
 #define TNT_FILAMENT_DETAILS_MATERIAL_H
 
 #include "downcast.h"
+#include "HwProgramFactory.h"
 
 #include "details/MaterialInstance.h"
 
@@ -78,6 +79,17 @@ public:
     class DefaultMaterialBuilder : public Builder {
     public:
         DefaultMaterialBuilder();
+        ~DefaultMaterialBuilder() noexcept;
+
+        // Parses the package ahead of build(). This doesn't use the driver API, so it can run
+        // on a JobSystem thread while the engine initializes.
+        void parse(FEngine const& engine) noexcept;
+
+        // Builds the material, from the package parsed by parse() if it succeeded.
+        FMaterial* build(FEngine& engine);
+
+    private:
+        std::unique_ptr<MaterialParser> mMaterialParser;
     };
 
 
@@ -109,10 +121,12 @@ public:
         return mDescriptorSetLayout;
     }
 
+    // allBackends: also prepare the programs on backends that don't compile them in parallel
     void compile(CompilerPriorityQueue priority,
             UserVariantFilterMask variantSpec,
             backend::CallbackHandler* handler,
-            utils::Invocable<void(Material*)>&& callback) noexcept;
+            utils::Invocable<void(Material*)>&& callback,
+            bool allBackends = false) noexcept;
 
     // Create an instance of this material
     FMaterialInstance* createInstance(const char* name) const noexcept;
@@ -302,7 +316,10 @@ private:
 
     void processDescriptorSets(FEngine& engine, MaterialParser const* parser);
 
-    void createAndCacheProgram(backend::Program&& p, Variant variant) const noexcept;
+    HwProgramFactory::Key getProgramAlias(Variant variant, bool multiview) const noexcept;
+
+    void createAndCacheProgram(Variant variant, bool multiview,
+            utils::Invocable<backend::Program()>&& makeProgram) const noexcept;
 
     inline bool isSharedVariant(Variant const variant) const {
         return (mMaterialDomain == MaterialDomain::SURFACE) && !mIsDefaultMaterial &&
@@ -211,8 +211,14 @@ void FMaterialInstance::commitStreamUniformAssociations(FEngine::DriverApi& driv
 
 void FMaterialInstance::commit(DriverApi& driver) const {
     // update uniforms if needed
-    if (mUniforms.isDirty() || mHasStreamUniformAssociations) {
+    if (UTILS_UNLIKELY(mHasStreamUniformAssociations)) {
         driver.updateBufferObject(mUbHandle, mUniforms.toBufferDescriptor(driver), 0);
+    } else if (mUniforms.isDirty()) {
+        // only upload the range of uniforms that changed since the last commit
+        size_t const offset = mUniforms.getDirtyOffset();
+        size_t const size = mUniforms.getDirtySize();
+        driver.updateBufferObject(mUbHandle,
+                mUniforms.toBufferDescriptor(driver, offset, size), uint32_t(offset));
     }
     if (!mTextureParameters.empty()) {
         for (auto const& [binding, p]: mTextureParameters) {
@@ -69,6 +69,11 @@ public:
     
     void commit(FEngine::DriverApi& driver) const;
 
+    // whether commit() has changes to upload
+    bool isDirty() const noexcept {
+        return mUniforms.isDirty() || mDescriptorSet.isDirty() || mHasStreamUniformAssociations;
+    }
+
     void use(FEngine::DriverApi& driver) const;
 
     FMaterial const* getMaterial() const noexcept { return mMaterial; }
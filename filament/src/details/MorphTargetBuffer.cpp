@@ -26,8 +26,11 @@
 #include <math/norm.h>
 
 #include <utils/CString.h>
+#include <utils/FixedCapacityVector.h>
 #include <utils/StaticString.h>
 
+#include <algorithm>
+
 namespace filament {
 
 using namespace backend;
@@ -196,6 +199,27 @@ void FMorphTargetBuffer::setPositionsAt(FEngine& engine, size_t const targetInde
             count, offset);
 }
 
+void FMorphTargetBuffer::setPositionsAt(FEngine& engine, size_t const targetIndex,
+        uint32_t const* indices, float3 const* positions, size_t const count) {
+    if (count == 0) {
+        return;
+    }
+
+    auto const [first, last] = std::minmax_element(indices, indices + count);
+    FILAMENT_CHECK_PRECONDITION(*last < mVertexCount)
+            << "MorphTargetBuffer (size=" << (unsigned)mVertexCount
+            << ") overflow (index=" << (unsigned)*last << ")";
+
+    // Expand the sparse target over the range it covers, the other vertices don't move.
+    size_t const offset = *first;
+    size_t const range = *last - *first + 1;
+    utils::FixedCapacityVector<float3> dense(range, float3{ 0.0f });
+    for (size_t i = 0; i < count; i++) {
+        dense[indices[i] - offset] = positions[i];
+    }
+    setPositionsAt(engine, targetIndex, dense.data(), range, offset);
+}
+
 void FMorphTargetBuffer::setTangentsAt(FEngine& engine, size_t const targetIndex,
         short4 const* tangents, size_t const count, size_t const offset) {
     FILAMENT_CHECK_PRECONDITION(offset + count <= mVertexCount)
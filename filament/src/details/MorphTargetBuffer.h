@@ -53,6 +53,9 @@ public:
     void setPositionsAt(FEngine& engine, size_t targetIndex,
             math::float4 const* positions, size_t count, size_t offset);
 
+    void setPositionsAt(FEngine& engine, size_t targetIndex,
+            uint32_t const* indices, math::float3 const* positions, size_t count);
+
     void setTangentsAt(FEngine& engine, size_t targetIndex,
             math::short4 const* tangents, size_t count, size_t offset);
 
@@ -172,7 +172,7 @@ void FRenderer::terminate(FEngine& engine) {
     // Before we can destroy this Renderer's resources, we must make sure
     // that all pending commands have been executed (as they could reference data in this
     // instance, e.g. Fences, Callbacks, etc...)
-    if (UTILS_HAS_THREADING) {
+    if (UTILS_HAS_DRIVER_THREAD) {
         Fence::waitAndDestroy(engine.createFence());
     } else {
         // In single threaded mode, allow recently-created objects (e.g. no-op fences in Skipper)
@@ -180,6 +180,7 @@ void FRenderer::terminate(FEngine& engine) {
         engine.execute();
     }
     mFrameInfoManager.terminate(driver);
+    mPassTimingManager.terminate(driver);
     mFrameSkipper.terminate(driver);
     mResourceAllocator->terminate();
 }
@@ -238,10 +239,27 @@ void FRenderer::setPresentationTime(int64_t const monotonic_clock_ns) {
     driver.setPresentationTime(monotonic_clock_ns);
 }
 
+void FRenderer::setPresentationDamage(filament::Viewport const& region) {
+    FEngine::DriverApi& driver = mEngine.getDriverApi();
+    driver.setPresentationDamage(region);
+}
+
 void FRenderer::setVsyncTime(uint64_t const steadyClockTimeNano) noexcept {
     mVsyncSteadyClockTimeNano = steadyClockTimeNano;
 }
 
+void FRenderer::setPassTimingsEnabled(bool const enabled) noexcept {
+    // OpenGL timer queries can't nest, and the whole frame is already being timed
+    if (mEngine.getBackend() == Backend::OPENGL) {
+        return;
+    }
+    mPassTimingManager.setEnabled(mEngine.getDriverApi(), enabled);
+}
+
+void FRenderer::purgeCaches() noexcept {
+    mResourceAllocator->purgeCache();
+}
+
 void FRenderer::skipFrame(uint64_t vsyncSteadyClockTimeNano) {
     SYSTRACE_CALL();
 
@@ -314,6 +332,10 @@ bool FRenderer::beginFrame(FSwapChain* swapChain, uint64_t vsyncSteadyClockTimeN
     FEngine& engine = mEngine;
     FEngine::DriverApi& driver = engine.getDriverApi();
 
+    // Apply the edits recorded by other threads since the last frame, before the render-on-demand
+    // check below, which they can affect.
+    engine.getEditJournal().apply(engine);
+
     // start a frame capture, if requested.
     if (UTILS_UNLIKELY(engine.debug.renderer.doFrameCapture)) {
         driver.startCapture();
@@ -364,12 +386,23 @@ bool FRenderer::beginFrame(FSwapChain* swapChain, uint64_t vsyncSteadyClockTimeN
         mFrameInfoManager.beginFrame(driver, {
                 .historySize = mFrameRateOptions.history
         }, mFrameId);
+        mCpuTimings = {};
+
+        if (mQualityGovernor.isEnabled() && mDisplayInfo.refreshRate > 0.0f) {
+            float const target = (1000.0f * float(mFrameRateOptions.interval)) /
+                    mDisplayInfo.refreshRate;
+            mQualityGovernor.update(std::chrono::steady_clock::now(),
+                    mFrameInfoManager.getLastFrameInfo(),
+                    target * (1.0f - mFrameRateOptions.headRoomRatio));
+        }
+
+        mPassTimingManager.beginFrame(driver);
 
         // ask the engine to do what it needs to (e.g. updates light buffer, materials...)
         engine.prepare();
     };
 
-    if (mFrameSkipper.beginFrame(driver)) {
+    if (needsFrame(swapChain) && (!mFrameSkippingEnabled || mFrameSkipper.beginFrame(driver))) {
         // if beginFrame() returns true, we are expecting a call to endFrame(),
         // so do the beginFrame work right now, instead of requiring a call to render()
         beginFrameInternal();
@@ -401,7 +434,7 @@ void FRenderer::endFrame() {
     FEngine& engine = mEngine;
     FEngine::DriverApi& driver = engine.getDriverApi();
 
-    if (UTILS_HAS_THREADING) {
+    if (UTILS_HAS_DRIVER_THREAD) {
         // on debug builds this helps to catch cases where we're writing to
         // the buffer form another thread, which is currently not allowed.
         driver.debugThreading();
@@ -410,13 +443,25 @@ void FRenderer::endFrame() {
     FILAMENT_CHECK_PRECONDITION(engine.isValid(mSwapChain))
             << "SwapChain must remain valid until endFrame is called.";
 
+    if (mRenderOnDemandEnabled) {
+        // changes made while rendering (e.g. the shadow map cameras) are part of this frame
+        mPresentedContentGeneration = engine.getContentGeneration();
+        mPresentedSwapChain = mSwapChain;
+        if (mSettlingFrameCount) {
+            mSettlingFrameCount--;
+        }
+    }
+
     if (mSwapChain) {
         mSwapChain->commit(driver);
         mSwapChain = nullptr;
     }
 
-    mFrameInfoManager.endFrame(driver);
-    mFrameSkipper.endFrame(driver);
+    mPassTimingManager.endFrame();
+    mFrameInfoManager.endFrame(driver, mCpuTimings);
+    if (mFrameSkippingEnabled) {
+        mFrameSkipper.endFrame(driver);
+    }
 
     driver.endFrame(mFrameId);
 
@@ -430,6 +475,11 @@ void FRenderer::endFrame() {
     }
 
     // do this before engine.flush()
+    if (UTILS_UNLIKELY(engine.isMemoryBudgetExhausted())) {
+        // release the cached textures before allocations start failing or spilling to system
+        // memory
+        mResourceAllocator->purgeCache();
+    }
     mResourceAllocator->gc();
 
     // Run the component managers' GC in parallel
@@ -557,6 +607,28 @@ void FRenderer::renderStandaloneView(FView const* view) {
     }
 }
 
+bool FRenderer::needsFrame(FSwapChain const* swapChain) noexcept {
+    if (!mRenderOnDemandEnabled) {
+        return true;
+    }
+    // render a few more frames after a change, so that temporal effects (TAA, dynamic
+    // resolution, etc...) converge before we stop
+    if (swapChain != mPresentedSwapChain ||
+            mEngine.getContentGeneration() != mPresentedContentGeneration) {
+        mSettlingFrameCount = RENDER_ON_DEMAND_SETTLING_FRAME_COUNT;
+    }
+    return mSettlingFrameCount > 0;
+}
+
+void FRenderer::setRenderOnDemandEnabled(bool const enabled) noexcept {
+    mRenderOnDemandEnabled = enabled;
+    mPresentedSwapChain = nullptr;
+}
+
+void FRenderer::setLowLatencyModeEnabled(bool const enabled) noexcept {
+    mFrameSkipper.setLatency(mEngine.getDriverApi(), enabled ? 1 : 2);
+}
+
 void FRenderer::render(FView const* view) {
     SYSTRACE_CALL();
 
@@ -574,13 +646,44 @@ void FRenderer::render(FView const* view) {
         if (mViewRenderedCount) {
             // This is a good place to kick the GPU, since we've rendered a View before,
             // and we're about to render another one.
+            Epoch const flushStart = clock::now();
             mEngine.getDriverApi().flush();
+            mCpuTimings.flush += elapsedNs(flushStart);
         }
         renderInternal(view);
         mViewRenderedCount++;
     }
 }
 
+void FRenderer::render(FView const* const* views, size_t const count) {
+    SYSTRACE_CALL();
+
+    // Nothing can change the scenes between these views, so the views of the same scene can
+    // share its preparation.
+    auto getScene = [views](size_t const i) {
+        return views[i] ? const_cast<FScene*>(views[i]->getScene()) : nullptr;
+    };
+    for (size_t i = 1; i < count; i++) {
+        FScene* const scene = getScene(i);
+        for (size_t j = 0; scene && j < i; j++) {
+            if (getScene(j) == scene) {
+                scene->setSharedPreparationEnabled(true);
+                break;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        render(views[i]);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (FScene* const scene = getScene(i)) {
+            scene->setSharedPreparationEnabled(false);
+        }
+    }
+}
+
 void FRenderer::renderInternal(FView const* view) {
     FEngine& engine = mEngine;
 
@@ -598,8 +701,14 @@ void FRenderer::renderInternal(FView const* view) {
     // execute the render pass
     renderJob(rootArenaScope, const_cast<FView&>(*view));
 
+    SYSTRACE_CONTEXT();
+    SYSTRACE_VALUE32("perRenderPassArena",
+            engine.getPerRenderPassArena().getAllocator().allocated());
+
     // make sure to flush the command buffer
+    Epoch const flushStart = clock::now();
     engine.flush();
+    mCpuTimings.flush += elapsedNs(flushStart);
 
     // and wait for all jobs to finish as a safety (this should be a no-op)
     js.runAndWait(rootJob);
@@ -620,7 +729,13 @@ void FRenderer::renderJob(RootArenaScope& rootArenaScope, FView& view) {
     bool hasColorGrading = hasPostProcess;
     bool hasDithering = view.getDithering() == Dithering::TEMPORAL;
     bool hasFXAA = view.getAntiAliasing() == AntiAliasing::FXAA;
-    float2 scale = view.updateScale(engine, mFrameInfoManager.getLastFrameInfo(), mFrameRateOptions, mDisplayInfo);
+    uint8_t const qualityLevel = mQualityGovernor.getLevel();
+    float2 scale = view.updateScale(engine, mFrameId,
+            mFrameInfoManager.getLastFrameInfo(), mFrameRateOptions, mDisplayInfo,
+            qualityLevel >= QualityGovernor::REDUCED_RESOLUTION ?
+                    mQualityGovernorOptions.maxResolutionScale : 1.0f);
+    bool const hasDepthPrepass = view.updateDepthPrepass(mFrameId,
+            mFrameInfoManager.getLastFrameInfo());
     auto msaaOptions = view.getMultiSampleAntiAliasingOptions();
     auto dsrOptions = view.getDynamicResolutionOptions();
     auto bloomOptions = view.getBloomOptions();
@@ -631,6 +746,23 @@ void FRenderer::renderJob(RootArenaScope& rootArenaScope, FView& view) {
     auto colorGrading = view.getColorGrading();
     auto ssReflectionsOptions = view.getScreenSpaceReflectionsOptions();
     auto guardBandOptions = view.getGuardBandOptions();
+
+    // lower the quality when the device heats up or can't keep up, see QualityGovernor
+    if (qualityLevel >= QualityGovernor::REDUCED_SSAO) {
+        aoOptions.quality = QualityLevel::LOW;
+        aoOptions.lowPassFilter = QualityLevel::LOW;
+        aoOptions.upsampling = QualityLevel::LOW;
+        aoOptions.resolution = 0.5f;
+    }
+    if (qualityLevel >= QualityGovernor::REDUCED_BLOOM) {
+        bloomOptions.levels = std::min(bloomOptions.levels, uint8_t(4));
+        bloomOptions.quality = QualityLevel::LOW;
+    }
+    if (qualityLevel >= QualityGovernor::NO_MSAA) {
+        msaaOptions.enabled = false;
+    }
+    view.setShadowQualityReduced(qualityLevel >= QualityGovernor::REDUCED_SHADOWS);
+
     const bool isRenderingMultiview = view.hasStereo() &&
             engine.getConfig().stereoscopicType == StereoscopicType::MULTIVIEW;
     // FIXME: This is to override some settings that are not supported for multiview at the moment.
@@ -677,12 +809,18 @@ void FRenderer::renderJob(RootArenaScope& rootArenaScope, FView& view) {
 
     const bool isProtectedContent =  mSwapChain && mSwapChain->isProtected();
 
+    // The full-screen fog pass blends over the linear color buffer after the color pass, so color
+    // grading can't be done as a subpass of the color pass. It's not supported with multiview,
+    // where we revert to per-material fog.
+    const bool hasFullScreenFog = view.hasFullScreenFog() && !isRenderingMultiview;
+
     // Conditions to meet to be able to use the sub-pass rendering path. This is regardless of
     // whether the backend supports subpasses (or if they are disabled in the debugRegistry).
     const bool isSubpassPossible =
              msaaSampleCount <= 1 &&
              hasColorGrading &&
-             !bloomOptions.enabled && !dofOptions.enabled && !taaOptions.enabled;
+             !bloomOptions.enabled && !dofOptions.enabled && !taaOptions.enabled &&
+             !hasFullScreenFog;
 
     // whether we're scaled at all
     bool scaled = any(notEqual(scale, float2(1.0f)));
@@ -699,6 +837,7 @@ void FRenderer::renderJob(RootArenaScope& rootArenaScope, FView& view) {
                     driver.isFrameBufferFetchMultiSampleSupported() &&
                     msaaOptions.customResolve &&
                     hasColorGrading &&
+                    !hasFullScreenFog &&
                     !engine.debug.renderer.disable_subpasses,
             .translucent = needsAlphaChannel,
             .outputLuminance = hasFXAA || scaled, // ignored by translucent variants (false)
@@ -796,6 +935,13 @@ void FRenderer::renderJob(RootArenaScope& rootArenaScope, FView& view) {
 
     view.prepare(engine, driver, rootArenaScope, svp, cameraInfo, getShaderUserTime(), needsAlphaChannel);
 
+    FrameInfo::CpuTimings const& prepareTimings = view.getPrepareTimings();
+    mCpuTimings.prepare += prepareTimings.prepare;
+    mCpuTimings.scene += prepareTimings.scene;
+    mCpuTimings.culling += prepareTimings.culling;
+    mCpuTimings.shadows += prepareTimings.shadows;
+    Epoch const frameGraphSetupStart = clock::now();
+
     view.prepareUpscaler(scale, taaOptions, dsrOptions);
 
     /*
@@ -823,7 +969,7 @@ void FRenderer::renderJob(RootArenaScope& rootArenaScope, FView& view) {
     Variant variant;
     variant.setDirectionalLighting(view.hasDirectionalLighting());
     variant.setDynamicLighting(view.hasDynamicLighting());
-    variant.setFog(view.hasFog());
+    variant.setFog(view.hasFog() && !hasFullScreenFog);
     variant.setVsm(view.hasShadowing() && view.getShadowType() != ShadowType::PCF);
     variant.setStereo(view.hasStereo());
 
@@ -1068,6 +1214,67 @@ void FRenderer::renderJob(RootArenaScope& rootArenaScope, FView& view) {
                 });
     }
 
+    // --------------------------------------------------------------------------------------------
+    // Occlusion buffer pass -- only used when occlusion culling is enabled.
+    // The opaque geometry is rendered into a small picking buffer, which is read back and used
+    // by FView::prepare() to cull renderables in a later frame.
+
+    if (view.hasOcclusionCulling()) {
+        struct OcclusionPassData {
+            FrameGraphId<FrameGraphTexture> depth;
+            FrameGraphId<FrameGraphTexture> occlusion;
+        };
+        uint2 const occlusionSize = OcclusionCuller::getBufferSize(svp.width, svp.height);
+        // the depth buffer is rendered at the user's world origin, because the world origin
+        // will likely be different by the time it's used
+        mat4 const clipFromWorld = mat4{ cameraInfo.projection } * cameraInfo.getUserViewMatrix();
+        fg.addPass<OcclusionPassData>("Occlusion Pass",
+                [&](FrameGraph::Builder& builder, auto& data) {
+                    data.depth = builder.createTexture("Occlusion Depth Buffer", {
+                            .width = occlusionSize.x, .height = occlusionSize.y,
+                            .format = TextureFormat::DEPTH32F });
+
+                    data.depth = builder.write(data.depth,
+                            FrameGraphTexture::Usage::DEPTH_ATTACHMENT);
+
+                    // Note that BLIT_SRC is needed because this texture will be read later (via
+                    // readPixels()).
+                    data.occlusion = builder.createTexture("Occlusion Buffer", {
+                            .width = occlusionSize.x, .height = occlusionSize.y,
+                            .format = TextureFormat::RG32F });
+
+                    data.occlusion = builder.write(data.occlusion,
+                            FrameGraphTexture::Usage::COLOR_ATTACHMENT |
+                            FrameGraphTexture::Usage::BLIT_SRC);
+
+                    builder.declareRenderPass("Occlusion Target", {
+                            .attachments = { .color = { data.occlusion }, .depth = data.depth },
+                            .clearFlags = TargetBufferFlags::COLOR0 | TargetBufferFlags::DEPTH
+                    });
+                    builder.sideEffect();
+                },
+                [=, &view, passBuilder = passBuilder](FrameGraphResources const& resources,
+                        auto const&, DriverApi& driver) mutable {
+                    Variant occlusionVariant(Variant::DEPTH_VARIANT);
+                    occlusionVariant.setPicking(true);
+
+                    // only opaque geometry can occlude
+                    passBuilder.renderFlags(renderFlags);
+                    passBuilder.variant(occlusionVariant);
+                    passBuilder.commandTypeFlags(RenderPass::CommandTypeFlags::SSAO |
+                            RenderPass::CommandTypeFlags::DEPTH_FILTER_ALPHA_MASKED_OBJECTS);
+
+                    RenderPass const pass{ passBuilder.build(mEngine, driver) };
+                    auto const out = resources.getRenderPassInfo();
+                    driver.beginRenderPass(out.target, out.params);
+                    pass.getExecutor().execute(mEngine, driver);
+                    driver.endRenderPass();
+
+                    view.readOcclusionBuffer(driver, out.target,
+                            occlusionSize.x, occlusionSize.y, clipFromWorld);
+                });
+    }
+
     // Store this frame's camera projection in the frame history.
     if (UTILS_UNLIKELY(taaOptions.enabled)) {
         // Apply the TAA jitter to everything after the structure pass, starting with the color pass.
@@ -1160,7 +1367,14 @@ void FRenderer::renderJob(RootArenaScope& rootArenaScope, FView& view) {
                 });
     }
 
-    passBuilder.commandTypeFlags(RenderPass::CommandTypeFlags::COLOR);
+    RenderPass::CommandTypeFlags colorPassFlags = RenderPass::CommandTypeFlags::COLOR;
+    if (hasDepthPrepass) {
+        colorPassFlags |= RenderPass::CommandTypeFlags::DEPTH_PREPASS;
+    }
+    if (view.isOrderIndependentBlendingEnabled()) {
+        colorPassFlags |= RenderPass::CommandTypeFlags::ORDER_INDEPENDENT_BLENDING;
+    }
+    passBuilder.commandTypeFlags(colorPassFlags);
 
 
     // RenderPass::IS_INSTANCED_STEREOSCOPIC only applies to the color pass
@@ -1170,6 +1384,13 @@ void FRenderer::renderJob(RootArenaScope& rootArenaScope, FView& view) {
         passBuilder.renderFlags(renderFlags);
     }
 
+    // the commands of the color pass can be reused across frames when nothing changed
+    if (engine.features.engine.render_pass.cache_commands) {
+        passBuilder.commandCache(&view.getColorPassCommandCache());
+    } else {
+        view.getColorPassCommandCache().clear();
+    }
+
     RenderPass const pass{ passBuilder.build(engine, driver) };
 
     FrameGraphTexture::Descriptor colorBufferDesc = {
@@ -1243,6 +1464,19 @@ void FRenderer::renderJob(RootArenaScope& rootArenaScope, FView& view) {
                 ppm.customResolveUncompressPass(fg, colorPassOutput.linearColor);
     }
 
+    // Resolve depth -- which might be needed because of the fog, TAA or DoF. This pass will be
+    // culled if the depth is not used below or if the depth is not MS (e.g. it could have been
+    // auto-resolved).
+    // In practice, this is used on Vulkan and older Metal devices.
+    auto depth = ppm.resolve(fg, "Resolved Depth Buffer", colorPassOutput.depth, { .levels = 1 });
+
+    // full-screen fog, which is part of the color pass output as far as post-processing goes
+    if (hasFullScreenFog) {
+        assert_invariant(!colorGradingConfig.asSubpass);
+        colorPassOutput.linearColor = ppm.fog(fg, colorPassOutput.linearColor, depth,
+                view.getColorPassDescriptorSet().getFogTexture());
+    }
+
     // export the color buffer if screen-space reflections are enabled
     if (ssReflectionsOptions.enabled) {
         struct ExportSSRHistoryData {
@@ -1277,12 +1511,6 @@ void FRenderer::renderJob(RootArenaScope& rootArenaScope, FView& view) {
     // input can change below
     FrameGraphId<FrameGraphTexture> input = postProcessInput;
 
-    // Resolve depth -- which might be needed because of TAA or DoF. This pass will be culled
-    // if the depth is not used below or if the depth is not MS (e.g. it could have been
-    // auto-resolved).
-    // In practice, this is used on Vulkan and older Metal devices.
-    auto depth = ppm.resolve(fg, "Resolved Depth Buffer", colorPassOutput.depth, { .levels = 1 });
-
     // Debug: CSM visualisation
     if (UTILS_UNLIKELY(engine.debug.shadowmap.visualize_cascades &&
                        view.hasShadowing() && view.hasDirectionalLighting())) {
@@ -1327,8 +1555,15 @@ void FRenderer::renderJob(RootArenaScope& rootArenaScope, FView& view) {
                 aspect < 1.0f ? aspect : 1.0f,
                 aspect > 1.0f ? 1.0f / aspect : 1.0f
             };
-            input = ppm.dof(fg, input, depth, cameraInfo, needsAlphaChannel,
-                    bokehScale, dofOptions);
+            // Skip the DoF when nothing would be blurred, i.e. when the circle-of-confusion stays
+            // under half a pixel from the nearest visible object to infinity.
+            float const nearestDistance = view.computeNearestVisibleDistance(
+                    cameraInfo.getPosition(), cameraInfo.getForwardVector());
+            if (PostProcessManager::getMaxCircleOfConfusion(cameraInfo, dofOptions,
+                    fg.getDescriptor(input).height, nearestDistance) >= 0.5f) {
+                input = ppm.dof(fg, input, depth, cameraInfo, needsAlphaChannel,
+                        bokehScale, dofOptions);
+            }
         }
 
         FrameGraphId<FrameGraphTexture> bloom, flare;
@@ -1444,19 +1679,28 @@ void FRenderer::renderJob(RootArenaScope& rootArenaScope, FView& view) {
 
     fg.present(fgViewRenderTarget);
 
+    mCpuTimings.frameGraphSetup += elapsedNs(frameGraphSetupStart);
+
+    Epoch const frameGraphCompileStart = clock::now();
     fg.compile();
+    mCpuTimings.frameGraphCompile += elapsedNs(frameGraphCompileStart);
+
+    //fg.export_graphviz(slog.d, view.getName());
+
+    Epoch const frameGraphExecuteStart = clock::now();
+    fg.execute(driver,
+            mPassTimingManager.isEnabled() ? &mPassTimingManager : nullptr);
+    mCpuTimings.frameGraphExecute += elapsedNs(frameGraphExecuteStart);
 
 #if FILAMENT_ENABLE_FGVIEWER
+    // after execute(), so that the passes' CPU timings and concrete resources are known
     fgviewer::DebugServer* fgviewerServer = engine.debug.fgviewerServer;
     if (UTILS_LIKELY(fgviewerServer)) {
-        fgviewerServer->update(view.getViewHandle(), fg.getFrameGraphInfo(view.getName()));
+        fgviewerServer->update(view.getViewHandle(),
+                fg.getFrameGraphInfo(view.getName(), mPassTimingManager.getPassTimings()));
     }
 #endif
 
-    //fg.export_graphviz(slog.d, view.getName());
-
-    fg.execute(driver);
-
     // save the current history entry and destroy the oldest entry
     view.commitFrameHistory(engine);
 
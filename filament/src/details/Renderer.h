@@ -22,7 +22,9 @@
 #include "Allocators.h"
 #include "FrameInfo.h"
 #include "FrameSkipper.h"
+#include "PassTimingManager.h"
 #include "PostProcessManager.h"
+#include "QualityGovernor.h"
 #include "RenderPass.h"
 
 #include "details/SwapChain.h"
@@ -70,6 +72,9 @@ class FView;
 class FRenderer : public Renderer {
     static constexpr unsigned MAX_FRAMETIME_HISTORY = 32u;
 
+    // number of frames rendered after the last change in render-on-demand mode
+    static constexpr uint32_t RENDER_ON_DEMAND_SETTLING_FRAME_COUNT = 16u;
+
 public:
     explicit FRenderer(FEngine& engine);
 
@@ -89,6 +94,8 @@ public:
 
     void setPresentationTime(int64_t monotonic_clock_ns);
 
+    void setPresentationDamage(Viewport const& region);
+
     void setVsyncTime(uint64_t steadyClockTimeNano) noexcept;
 
     // skip a frame
@@ -103,6 +110,9 @@ public:
     // render a view. must be called between beginFrame/enfFrame.
     void render(FView const* view);
 
+    // render several views, in order. must be called between beginFrame/enfFrame.
+    void render(FView const* const* views, size_t count);
+
     // read pixel from the current swapchain. must be called between beginFrame/enfFrame.
     void readPixels(uint32_t xoffset, uint32_t yoffset, uint32_t width, uint32_t height,
             backend::PixelBufferDescriptor&& buffer);
@@ -139,6 +149,17 @@ public:
         frameRateOptions.headRoomRatio = std::max(frameRateOptions.headRoomRatio, 0.0f);
     }
 
+    void setQualityGovernorOptions(QualityGovernorOptions const& options) noexcept {
+        mQualityGovernorOptions = options;
+        mQualityGovernorOptions.maxResolutionScale =
+                std::clamp(options.maxResolutionScale, 0.125f, 1.0f);
+        mQualityGovernor.setEnabled(options.enabled);
+    }
+
+    uint8_t getQualityLevel() const noexcept {
+        return mQualityGovernor.getLevel();
+    }
+
     void setClearOptions(const ClearOptions& options) {
         mClearOptions = options;
     }
@@ -155,6 +176,22 @@ public:
         return MAX_FRAMETIME_HISTORY;
     }
 
+    void setPassTimingsEnabled(bool enabled) noexcept;
+
+    void purgeCaches() noexcept;
+
+    utils::FixedCapacityVector<PassTiming> getPassTimings() const noexcept {
+        return mPassTimingManager.getPassTimings();
+    }
+
+    void setFrameSkippingEnabled(bool const enabled) noexcept {
+        mFrameSkippingEnabled = enabled;
+    }
+
+    void setLowLatencyModeEnabled(bool enabled) noexcept;
+
+    void setRenderOnDemandEnabled(bool enabled) noexcept;
+
 private:
     friend class Renderer;
     using Command = RenderPass::Command;
@@ -186,9 +223,16 @@ private:
         return mCommandsHighWatermark;
     }
 
+    // with render-on-demand, whether something changed since the last presented frame
+    bool needsFrame(FSwapChain const* swapChain) noexcept;
+
     void renderInternal(FView const* view);
     void renderJob(RootArenaScope& rootArenaScope, FView& view);
 
+    static int64_t elapsedNs(Epoch const since) noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - since).count();
+    }
+
     // keep a reference to our engine
     FEngine& mEngine;
     FrameSkipper mFrameSkipper;
@@ -197,7 +241,14 @@ private:
     size_t mCommandsHighWatermark = 0;
     uint32_t mFrameId = 0;
     uint32_t mViewRenderedCount = 0;
+    bool mFrameSkippingEnabled = true;
+    bool mRenderOnDemandEnabled = false;
+    uint32_t mSettlingFrameCount = 0;
+    uint64_t mPresentedContentGeneration = 0;
+    FSwapChain const* mPresentedSwapChain = nullptr;
     FrameInfoManager mFrameInfoManager;
+    FrameInfo::CpuTimings mCpuTimings{};
+    PassTimingManager mPassTimingManager;
     backend::TextureFormat mHdrTranslucent;
     backend::TextureFormat mHdrQualityMedium;
     backend::TextureFormat mHdrQualityHigh;
@@ -206,6 +257,8 @@ private:
     math::float4 mShaderUserTime{};
     DisplayInfo mDisplayInfo;
     FrameRateOptions mFrameRateOptions;
+    QualityGovernorOptions mQualityGovernorOptions;
+    QualityGovernor mQualityGovernor;
     ClearOptions mClearOptions;
     backend::TargetBufferFlags mDiscardStartFlags{};
     backend::TargetBufferFlags mClearFlags{};
@@ -27,15 +27,25 @@
 #include "details/Skybox.h"
 
 #include "BufferPoolAllocator.h"
+#include "Intersections.h"
+
+#include <filament/Frustum.h>
 
 #include <utils/compiler.h>
 #include <utils/EntityManager.h>
+#include <utils/Hash.h>
 #include <utils/Range.h>
 #include <utils/Systrace.h>
 
 #include <math/quat.h>
 
 #include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
 
 using namespace filament::backend;
 using namespace filament::math;
@@ -45,6 +55,24 @@ namespace filament {
 
 // ------------------------------------------------------------------------------------------------
 
+namespace {
+
+// copies the given elements of `src` to `dst`, which is resized to the size of `src`
+template<size_t ... Is, typename Soa>
+void copyElements(Soa& dst, Soa const& src) noexcept {
+    size_t const size = src.size();
+    dst.resize(size);
+    ( std::copy_n(src.template data<Is>(), size, dst.template data<Is>()), ... );
+}
+
+bool isEqual(mat4 const& lhs, mat4 const& rhs) noexcept {
+    return lhs[0] == rhs[0] && lhs[1] == rhs[1] && lhs[2] == rhs[2] && lhs[3] == rhs[3];
+}
+
+} // anonymous namespace
+
+// ------------------------------------------------------------------------------------------------
+
 FScene::FScene(FEngine& engine) :
         mEngine(engine), mSharedState(std::make_shared<SharedState>()) {
 }
@@ -53,7 +81,6 @@ FScene::~FScene() noexcept = default;
 
 
 void FScene::prepare(JobSystem& js,
-        RootArenaScope& rootArenaScope,
         mat4 const& worldTransform,
         bool shadowReceiversAreCasters) noexcept {
     // TODO: can we skip this in most cases? Since we rely on indices staying the same,
@@ -63,84 +90,53 @@ void FScene::prepare(JobSystem& js,
 
     SYSTRACE_CONTEXT();
 
-    // This will reset the allocator upon exiting
-    ArenaScope<RootArenaScope::Arena> localArenaScope(rootArenaScope.getArena());
+    if (mSharedPreparation && mHasPreparedData &&
+            mPreparedShadowReceiversAreCasters == shadowReceiversAreCasters &&
+            isEqual(mPreparedWorldTransform, worldTransform)) {
+        // Nothing changed since the data was gathered for a previous view, we only need to
+        // undo the reordering and culling done by that view.
+        restorePreparedData();
+        mWorldTransform = worldTransform;
+        return;
+    }
 
     FEngine& engine = mEngine;
-    EntityManager const& em = engine.getEntityManager();
     FRenderableManager const& rcm = engine.getRenderableManager();
     FTransformManager const& tcm = engine.getTransformManager();
     FLightManager const& lcm = engine.getLightManager();
-    // go through the list of entities, and gather the data of those that are renderables
     auto& sceneData = mRenderableData;
     auto& lightData = mLightData;
     auto const& entities = mEntities;
 
-    using RenderableContainerData = std::pair<RenderableManager::Instance, TransformManager::Instance>;
-    using RenderableInstanceContainer = FixedCapacityVector<RenderableContainerData,
-            STLAllocator< RenderableContainerData, LinearAllocatorArena >, false>;
+    // find the renderables and lights of the scene, this is only done when they changed
+    gatherInstances();
+    auto const& renderableInstances = mRenderableInstances;
+    auto const& lightInstances = mLightInstances;
 
-    using LightContainerData = std::pair<LightManager::Instance, TransformManager::Instance>;
-    using LightInstanceContainer = FixedCapacityVector<LightContainerData,
-            STLAllocator< LightContainerData, LinearAllocatorArena >, false>;
-
-    RenderableInstanceContainer renderableInstances{
-            RenderableInstanceContainer::with_capacity(entities.size(), localArenaScope.getArena()) };
-
-    LightInstanceContainer lightInstances{
-            LightInstanceContainer::with_capacity(entities.size(), localArenaScope.getArena()) };
-
-    SYSTRACE_NAME_BEGIN("InstanceLoop");
-
-    // find the max intensity directional light index in our local array
+    // find the max intensity directional light
     float maxIntensity = 0.0f;
-    std::pair<LightManager::Instance, TransformManager::Instance> directionalLightInstances{};
-
-    /*
-     * First compute the exact number of renderables and lights in the scene.
-     * Also find the main directional light.
-     */
-
-    for (Entity const e: entities) {
-        if (UTILS_LIKELY(em.isAlive(e))) {
-            auto ti = tcm.getInstance(e);
-            auto li = lcm.getInstance(e);
-            auto ri = rcm.getInstance(e);
-            if (li) {
-                // we handle the directional light here because it'd prevent multithreading below
-                if (UTILS_UNLIKELY(lcm.isDirectionalLight(li))) {
-                    // we don't store the directional lights, because we only have a single one
-                    if (lcm.getIntensity(li) >= maxIntensity) {
-                        maxIntensity = lcm.getIntensity(li);
-                        directionalLightInstances = { li, ti };
-                    }
-                } else {
-                    lightInstances.emplace_back(li, ti);
-                }
-            }
-            if (ri) {
-                renderableInstances.emplace_back(ri, ti);
-            }
+    InstancePair<LightManager::Instance> directionalLightInstances{};
+    for (auto const& [li, ti] : mDirectionalLightInstances) {
+        if (lcm.getIntensity(li) >= maxIntensity) {
+            maxIntensity = lcm.getIntensity(li);
+            directionalLightInstances = { li, ti };
         }
     }
 
-    SYSTRACE_NAME_END();
-
     /*
      * Evaluate the capacity needed for the renderable and light SoAs
      */
 
-    // we need the capacity to be multiple of 16 for SIMD loops
+    // we need the capacity to be multiple of 16 for SIMD loops, which the SoAs guarantee
+    static_assert(RenderableSoa::getChunkSize() % 16 == 0);
+    static_assert(LightSoa::getChunkSize() % 16 == 0);
+
     // we need 1 extra entry at the end for the summed primitive count
-    size_t renderableDataCapacity = entities.size();
-    renderableDataCapacity = (renderableDataCapacity + 0xFu) & ~0xFu;
-    renderableDataCapacity = renderableDataCapacity + 1;
+    size_t const renderableDataCapacity = entities.size() + 1;
 
     // The light data list will always contain at least one entry for the
     // dominating directional light, even if there are no entities.
-    // we need the capacity to be multiple of 16 for SIMD loops
-    size_t lightDataCapacity = std::max<size_t>(DIRECTIONAL_LIGHTS_COUNT, entities.size());
-    lightDataCapacity = (lightDataCapacity + 0xFu) & ~0xFu;
+    size_t const lightDataCapacity = std::max<size_t>(DIRECTIONAL_LIGHTS_COUNT, entities.size());
 
     /*
      * Now resize the SoAs if needed
@@ -249,10 +245,12 @@ void FScene::prepare(JobSystem& js,
     auto* renderableJob = parallel_for(js, rootJob,
             renderableInstances.data(), renderableInstances.size(),
             std::cref(renderableWork), jobs::CountSplitter<64>());
+    js.setLabel(renderableJob, "FScene::prepare renderables");
 
     auto* lightJob = parallel_for(js, rootJob,
             lightInstances.data(), lightInstances.size(),
             std::cref(lightWork), jobs::CountSplitter<32, 5>());
+    js.setLabel(lightJob, "FScene::prepare lights");
 
     js.run(renderableJob);
     js.run(lightJob);
@@ -324,6 +322,218 @@ void FScene::prepare(JobSystem& js,
     js.runAndWait(rootJob);
 
     SYSTRACE_NAME_END();
+
+    updateStaticBvh(worldTransform);
+
+    if (mSharedPreparation) {
+        savePreparedData();
+        mPreparedWorldTransform = worldTransform;
+        mPreparedShadowReceiversAreCasters = shadowReceiversAreCasters;
+        mHasPreparedData = true;
+    }
+}
+
+void FScene::gatherInstances() noexcept {
+    FEngine& engine = mEngine;
+    EntityManager const& em = engine.getEntityManager();
+    FRenderableManager const& rcm = engine.getRenderableManager();
+    FTransformManager const& tcm = engine.getTransformManager();
+    FLightManager const& lcm = engine.getLightManager();
+    auto const& entities = mEntities;
+
+    // Entities never come back to life, so if as many are alive as when we gathered the
+    // instances, none of them died since. This loop only reads dense arrays.
+    size_t aliveCount = 0;
+    for (Entity const e : entities) {
+        aliveCount += em.isAlive(e) ? 1 : 0;
+    }
+
+    InstanceCacheKey const key{
+            mEntitiesVersion, rcm.getVersion(), lcm.getVersion(), tcm.getVersion(), aliveCount };
+    if (mInstanceCacheValid && key == mInstanceCacheKey) {
+        return;
+    }
+
+    SYSTRACE_NAME("gatherInstances");
+
+    mRenderableInstances.clear();
+    mLightInstances.clear();
+    mDirectionalLightInstances.clear();
+
+    for (Entity const e: entities) {
+        if (UTILS_LIKELY(em.isAlive(e))) {
+            auto ti = tcm.getInstance(e);
+            auto li = lcm.getInstance(e);
+            auto ri = rcm.getInstance(e);
+            if (li) {
+                // we only use the directional light with the highest intensity, which is
+                // chosen by prepare() since intensities can change at any time
+                if (UTILS_UNLIKELY(lcm.isDirectionalLight(li))) {
+                    mDirectionalLightInstances.emplace_back(li, ti);
+                } else {
+                    mLightInstances.emplace_back(li, ti);
+                }
+            }
+            if (ri) {
+                mRenderableInstances.emplace_back(ri, ti);
+            }
+        }
+    }
+
+    /*
+     * Renderables with static bounds are stored at the end of the SoA, where they are culled
+     * using a bounding volume hierarchy instead of being tested individually.
+     */
+
+    auto const firstStaticRenderable = std::partition(
+            mRenderableInstances.begin(), mRenderableInstances.end(),
+            [&rcm](InstancePair<RenderableManager::Instance> const& data) {
+                return rcm.getVisibility(data.first).geometryType ==
+                       RenderableManager::Builder::GeometryType::DYNAMIC;
+            });
+    mStaticRenderableCount = uint32_t(mRenderableInstances.end() - firstStaticRenderable);
+
+    mInstanceCacheKey = key;
+    mInstanceCacheValid = true;
+}
+
+void FScene::setSharedPreparationEnabled(bool const enabled) noexcept {
+    mSharedPreparation = enabled;
+    mHasPreparedData = false;
+}
+
+void FScene::savePreparedData() noexcept {
+    SYSTRACE_CALL();
+    // only the elements written by prepare() are needed, the others are computed for each view
+    copyElements<RENDERABLE_INSTANCE, WORLD_TRANSFORM, VISIBILITY_STATE, SKINNING_BUFFER,
+            MORPHING_BUFFER, INSTANCES, WORLD_AABB_CENTER, VISIBLE_MASK, CHANNELS, LAYERS,
+            WORLD_AABB_EXTENT, SUMMED_PRIMITIVE_COUNT, USER_DATA>(
+            mPreparedRenderableData, mRenderableData);
+    copyElements<POSITION_RADIUS, DIRECTION, SHADOW_DIRECTION, SHADOW_REF, LIGHT_INSTANCE>(
+            mPreparedLightData, mLightData);
+}
+
+void FScene::restorePreparedData() noexcept {
+    SYSTRACE_CALL();
+    // the sizes can only have shrunk since prepare(), so the capacities are large enough
+    assert_invariant(mPreparedRenderableData.size() <= mRenderableData.capacity());
+    assert_invariant(mPreparedLightData.size() <= mLightData.capacity());
+    copyElements<RENDERABLE_INSTANCE, WORLD_TRANSFORM, VISIBILITY_STATE, SKINNING_BUFFER,
+            MORPHING_BUFFER, INSTANCES, WORLD_AABB_CENTER, VISIBLE_MASK, CHANNELS, LAYERS,
+            WORLD_AABB_EXTENT, SUMMED_PRIMITIVE_COUNT, USER_DATA>(
+            mRenderableData, mPreparedRenderableData);
+    copyElements<POSITION_RADIUS, DIRECTION, SHADOW_DIRECTION, SHADOW_REF, LIGHT_INSTANCE>(
+            mLightData, mPreparedLightData);
+}
+
+void FScene::updateStaticBvh(mat4 const& worldTransform) noexcept {
+    mWorldTransform = worldTransform;
+
+    size_t const staticCount = mStaticRenderableCount;
+    if (!staticCount) {
+        mStaticBvh.clear();
+        mStaticBvhEntities.clear();
+        return;
+    }
+
+    // The set of static renderables is identified by the hash of their instances in SoA order,
+    // since this is the order the hierarchy refers to.
+    static_assert(sizeof(RenderableManager::Instance) == sizeof(uint32_t));
+    size_t const first = mRenderableData.size() - staticCount;
+    uint32_t const key = hash::murmur3(
+            reinterpret_cast<uint32_t const*>(mRenderableData.data<RENDERABLE_INSTANCE>() + first),
+            staticCount, 0);
+
+    if (mStaticBvh.size() != staticCount || mStaticBvhKey != key) {
+        SYSTRACE_NAME("build static BVH");
+        // Bounds and world transforms of static renderables are immutable, so we only need to
+        // rebuild the hierarchy when the set of static renderables changes.
+        mStaticBvh.build(
+                mRenderableData.data<WORLD_AABB_CENTER>() + first,
+                mRenderableData.data<WORLD_AABB_EXTENT>() + first, staticCount);
+        mStaticBvhKey = key;
+        mStaticBvhWorldTransform = worldTransform;
+
+        FRenderableManager const& rcm = mEngine.getRenderableManager();
+        auto const* const instances = mRenderableData.data<RENDERABLE_INSTANCE>() + first;
+        mStaticBvhEntities.resize(staticCount);
+        for (size_t i = 0; i < staticCount; i++) {
+            mStaticBvhEntities[i] = rcm.getEntity(instances[i]);
+        }
+    }
+}
+
+Scene::RaycastResult FScene::raycast(float3 const& origin, float3 const& direction,
+        float const maxDistance) const noexcept {
+    EntityManager const& em = mEngine.getEntityManager();
+    FRenderableManager const& rcm = mEngine.getRenderableManager();
+    FTransformManager const& tcm = mEngine.getTransformManager();
+
+    float3 const dir = normalize(direction);
+    RaycastResult result{ {}, maxDistance };
+
+    // Static renderables are found through the hierarchy, which is expressed in the world space
+    // used when it was built (see cullStaticRenderables()). That space only differs by a rigid
+    // transform, so distances are the same in both spaces.
+    bool const hasStaticBvh = !mStaticBvhEntities.empty();
+    if (hasStaticBvh) {
+        mat4 const& m = mStaticBvhWorldTransform;
+        float3 const bvhOrigin{ (m * double4{ origin, 1.0 }).xyz };
+        float3 const bvhDirection{ m.upperLeft() * double3{ dir } };
+        auto const hit = mStaticBvh.raycast(bvhOrigin, bvhDirection, maxDistance);
+        if (hit.index != BoundingVolumeHierarchy::NO_HIT) {
+            Entity const entity = mStaticBvhEntities[hit.index];
+            if (em.isAlive(entity) && rcm.hasComponent(entity)) {
+                result = { entity, hit.distance };
+            }
+        }
+    }
+
+    // the other renderables are tested individually, with their current bounds
+    float3 const invDirection = 1.0f / dir;
+    for (Entity const entity : mEntities) {
+        auto const ri = rcm.getInstance(entity);
+        if (!ri || !em.isAlive(entity)) {
+            continue;
+        }
+        if (hasStaticBvh && rcm.getVisibility(ri).geometryType !=
+                RenderableManager::Builder::GeometryType::DYNAMIC) {
+            continue;
+        }
+        mat4f const worldTransform{ tcm.getWorldTransformAccurate(tcm.getInstance(entity)) };
+        Box const box = rigidTransform(rcm.getAABB(ri), worldTransform);
+        float2 const t = rayBoxIntersection(origin, invDirection, box.center, box.halfExtent);
+        float const distance = std::max(t.x, 0.0f);
+        if (t.x <= t.y && t.y >= 0.0f && distance < result.distance) {
+            result = { entity, distance };
+        }
+    }
+
+    if (!result.renderable) {
+        result.distance = 0.0f;
+    }
+    return result;
+}
+
+void FScene::cullStaticRenderables(Frustum const& frustum, size_t const bit) noexcept {
+    if (mStaticBvh.empty()) {
+        return;
+    }
+
+    assert_invariant(mStaticBvh.size() <= mRenderableData.size());
+
+    // The hierarchy is expressed in the world space used when it was built, which can differ
+    // from the current one (e.g. when the world origin follows the camera). Rather than
+    // rebuilding it, we bring the culling planes into the hierarchy's space.
+    mat4 const planeTransform = transpose(mWorldTransform * inverse(mStaticBvhWorldTransform));
+    float4 const* const frustumPlanes = frustum.getNormalizedPlanes();
+    float4 planes[6];
+    for (size_t i = 0; i < 6; i++) {
+        planes[i] = float4{ planeTransform * double4{ frustumPlanes[i] }};
+    }
+
+    size_t const first = mRenderableData.size() - mStaticBvh.size();
+    mStaticBvh.cull(mRenderableData.data<VISIBLE_MASK>() + first, planes, bit);
 }
 
 void FScene::prepareVisibleRenderables(Range<uint32_t> visibleRenderables) noexcept {
@@ -382,63 +592,149 @@ void FScene::prepareVisibleRenderables(Range<uint32_t> visibleRenderables) noexc
     }
 }
 
+PerRenderableData* FScene::allocateRenderableData(size_t const count) noexcept {
+    if (count >= MAX_STREAM_ALLOCATION_COUNT) {
+        // use the heap allocator
+        auto& bufferPoolAllocator = mSharedState->mBufferPoolAllocator;
+        return (PerRenderableData*)bufferPoolAllocator.get(count * sizeof(PerRenderableData));
+    }
+    // allocate space into the command stream directly
+    return mEngine.getDriverApi().allocatePod<PerRenderableData>(count);
+}
+
+BufferDescriptor FScene::createRenderableDataDescriptor(
+        PerRenderableData* const buffer, size_t const count) const noexcept {
+    // We capture state shared between Scene and the update buffer callback, because the Scene could
+    // be destroyed before the callback executes.
+    std::weak_ptr<SharedState>* const weakShared = new std::weak_ptr<SharedState>(mSharedState);
+    return {
+            buffer, count * sizeof(PerRenderableData),
+            +[](void* p, size_t const s, void* user) {
+                std::weak_ptr<SharedState>* const weakShared =
+                        static_cast<std::weak_ptr<SharedState>*>(user);
+                if (s >= MAX_STREAM_ALLOCATION_COUNT * sizeof(PerRenderableData)) {
+                    if (auto state = weakShared->lock()) {
+                        state->mBufferPoolAllocator.put(p);
+                    }
+                }
+                delete weakShared;
+            }, weakShared
+    };
+}
+
 void FScene::updateUBOs(
         Range<uint32_t> visibleRenderables,
-        Handle<HwBufferObject> renderableUbh) noexcept {
+        Handle<HwBufferObject> renderableUbh,
+        Frustum const& cullingFrustum,
+        std::vector<PerRenderableData>* committed) noexcept {
     SYSTRACE_CALL();
     FEngine::DriverApi& driver = mEngine.getDriverApi();
 
-    // don't allocate more than 16 KiB directly into the render stream
-    static constexpr size_t MAX_STREAM_ALLOCATION_COUNT = 64;   // 16 KiB
-    const size_t count = visibleRenderables.size();
-    PerRenderableData* buffer = [&]{
-        if (count >= MAX_STREAM_ALLOCATION_COUNT) {
-            // use the heap allocator
-            auto& bufferPoolAllocator = mSharedState->mBufferPoolAllocator;
-            return (PerRenderableData*)bufferPoolAllocator.get(count * sizeof(PerRenderableData));
-        } else {
-            // allocate space into the command stream directly
-            return driver.allocatePod<PerRenderableData>(count);
-        }
-    }();
-
     PerRenderableData const* const uboData = mRenderableData.data<UBO>();
     mat4f const* const worldTransformData = mRenderableData.data<WORLD_TRANSFORM>();
 
-    // prepare each InstanceBuffer.
-    FRenderableManager::InstancesInfo const* instancesData = mRenderableData.data<INSTANCES>();
+    // prepare each InstanceBuffer, the instance count of this view is the number of instances
+    // that survived culling.
+    FRenderableManager::InstancesInfo* instancesData = mRenderableData.data<INSTANCES>();
+    Culler::result_type* visibleMask = mRenderableData.data<VISIBLE_MASK>();
     for (uint32_t const i : visibleRenderables) {
         auto& instancesInfo = instancesData[i];
         if (UTILS_UNLIKELY(instancesInfo.buffer)) {
-            instancesInfo.buffer->prepare(
-                    mEngine, worldTransformData[i], uboData[i], instancesInfo.handle);
+            size_t const visibleCount = instancesInfo.buffer->prepare(mEngine,
+                    worldTransformData[i], uboData[i], instancesInfo.handle, cullingFrustum);
+            instancesInfo.count = uint16_t(visibleCount);
+            if (UTILS_UNLIKELY(!visibleCount)) {
+                visibleMask[i] = 0;
+            }
         }
     }
 
+    if (committed && updateUBOsIncremental(visibleRenderables, renderableUbh, *committed)) {
+        return;
+    }
+
+    const size_t count = visibleRenderables.size();
+    PerRenderableData* const buffer = allocateRenderableData(count);
+
     // copy our data into the UBO for each visible renderable
     for (uint32_t const i : visibleRenderables) {
         buffer[i] = uboData[i];
     }
 
-    // We capture state shared between Scene and the update buffer callback, because the Scene could
-    // be destroyed before the callback executes.
-    std::weak_ptr<SharedState>* const weakShared = new std::weak_ptr<SharedState>(mSharedState);
+    if (committed) {
+        committed->assign(uboData + visibleRenderables.first, uboData + visibleRenderables.last);
+    }
 
     // update the UBO
     driver.resetBufferObject(renderableUbh);
-    driver.updateBufferObjectUnsynchronized(renderableUbh, {
-            buffer, count * sizeof(PerRenderableData),
-            +[](void* p, size_t const s, void* user) {
-                std::weak_ptr<SharedState>* const weakShared =
-                        static_cast<std::weak_ptr<SharedState>*>(user);
-                if (s >= MAX_STREAM_ALLOCATION_COUNT * sizeof(PerRenderableData)) {
-                    if (auto state = weakShared->lock()) {
-                        state->mBufferPoolAllocator.put(p);
-                    }
-                }
-                delete weakShared;
-            }, weakShared
-    }, 0);
+    driver.updateBufferObjectUnsynchronized(renderableUbh,
+            createRenderableDataDescriptor(buffer, count), 0);
+}
+
+bool FScene::updateUBOsIncremental(
+        Range<uint32_t> const visibleRenderables,
+        Handle<HwBufferObject> renderableUbh,
+        std::vector<PerRenderableData>& committed) noexcept {
+    SYSTRACE_CALL();
+    SYSTRACE_CONTEXT();
+
+    if (committed.empty() || visibleRenderables.first != 0) {
+        // we don't know the content of the UBO
+        return false;
+    }
+
+    // the reserved fields are not used by the shaders, and are not always initialized
+    constexpr size_t significantSize = offsetof(PerRenderableData, reserved);
+    PerRenderableData const* const uboData = mRenderableData.data<UBO>();
+    size_t const committedCount = committed.size();
+
+    // find the ranges of renderables whose data changed since it was uploaded, close ranges are
+    // merged to limit the number of updates.
+    struct DirtyRange {
+        uint32_t first;
+        uint32_t last;
+    };
+    DirtyRange ranges[MAX_UBO_DIRTY_RANGES];
+    size_t rangeCount = 0;
+    size_t dirtyCount = 0;
+    for (uint32_t const i : visibleRenderables) {
+        bool const dirty = i >= committedCount ||
+                memcmp(&uboData[i], &committed[i], significantSize) != 0;
+        if (UTILS_LIKELY(!dirty)) {
+            continue;
+        }
+        if (rangeCount && i <= ranges[rangeCount - 1].last + MAX_UBO_DIRTY_RANGE_GAP) {
+            dirtyCount += i + 1 - ranges[rangeCount - 1].last;
+            ranges[rangeCount - 1].last = i + 1;
+        } else {
+            if (UTILS_UNLIKELY(rangeCount == MAX_UBO_DIRTY_RANGES)) {
+                return false;
+            }
+            ranges[rangeCount++] = { i, i + 1 };
+            dirtyCount++;
+        }
+    }
+
+    if (dirtyCount * 2 > visibleRenderables.size()) {
+        // most of the data changed, updating the whole buffer is cheaper
+        return false;
+    }
+
+    SYSTRACE_VALUE32("dirtyRenderables", dirtyCount);
+
+    FEngine::DriverApi& driver = mEngine.getDriverApi();
+    committed.resize(std::max(committedCount, size_t(visibleRenderables.last)));
+    for (size_t r = 0; r < rangeCount; r++) {
+        DirtyRange const range = ranges[r];
+        size_t const count = range.last - range.first;
+        PerRenderableData* const buffer = allocateRenderableData(count);
+        std::copy(uboData + range.first, uboData + range.last, buffer);
+        std::copy(uboData + range.first, uboData + range.last, committed.data() + range.first);
+        // the previous content is still needed, so this can't use the unsynchronized version
+        driver.updateBufferObject(renderableUbh, createRenderableDataDescriptor(buffer, count),
+                uint32_t(range.first * sizeof(PerRenderableData)));
+    }
+    return true;
 }
 
 void FScene::terminate(FEngine&) {
@@ -526,17 +822,36 @@ inline void FScene::computeLightRanges(
 
 UTILS_NOINLINE
 void FScene::addEntity(Entity const entity) {
-    mEntities.insert(entity);
+    auto const [pos, inserted] = mEntityIndices.try_emplace(entity, uint32_t(mEntities.size()));
+    if (inserted) {
+        mEntities.push_back(entity);
+        mEntitiesVersion++;
+    }
 }
 
 UTILS_NOINLINE
 void FScene::addEntities(const Entity* entities, size_t const count) {
-    mEntities.insert(entities, entities + count);
+    for (size_t i = 0; i < count; ++i, ++entities) {
+        addEntity(*entities);
+    }
 }
 
 UTILS_NOINLINE
 void FScene::remove(Entity const entity) {
-    mEntities.erase(entity);
+    auto const pos = mEntityIndices.find(entity);
+    if (pos == mEntityIndices.end()) {
+        return;
+    }
+    // move the last entity where the removed one was, to keep the list dense
+    uint32_t const index = pos->second;
+    mEntityIndices.erase(pos);
+    Entity const last = mEntities.back();
+    mEntities.pop_back();
+    if (last != entity) {
+        mEntities[index] = last;
+        mEntityIndices[last] = index;
+    }
+    mEntitiesVersion++;
 }
 
 UTILS_NOINLINE
@@ -549,6 +864,8 @@ void FScene::removeEntities(const Entity* entities, size_t const count) {
 UTILS_NOINLINE
 void FScene::removeAllEntities() noexcept {
     mEntities.clear();
+    mEntityIndices.clear();
+    mEntitiesVersion++;
 }
 
 UTILS_NOINLINE
@@ -579,7 +896,7 @@ size_t FScene::getLightCount() const noexcept {
 
 UTILS_NOINLINE
 bool FScene::hasEntity(Entity const entity) const noexcept {
-    return mEntities.find(entity) != mEntities.end();
+    return mEntityIndices.find(entity) != mEntityIndices.end();
 }
 
 UTILS_NOINLINE
@@ -20,6 +20,7 @@
 #include "downcast.h"
 
 #include "Allocators.h"
+#include "BoundingVolumeHierarchy.h"
 #include "Culler.h"
 
 #include "ds/DescriptorSet.h"
@@ -33,6 +34,9 @@
 #include <filament/Box.h>
 #include <filament/Scene.h>
 
+#include <backend/BufferDescriptor.h>
+
+#include <math/mat4.h>
 #include <math/mathfwd.h>
 
 #include <utils/compiler.h>
@@ -44,9 +48,10 @@
 
 #include <stddef.h>
 
-#include <tsl/robin_set.h>
+#include <tsl/robin_map.h>
 
 #include <memory>
+#include <vector>
 
 namespace filament {
 
@@ -55,6 +60,7 @@ class FEngine;
 class FIndirectLight;
 class FRenderer;
 class FSkybox;
+class Frustum;
 
 class FScene : public Scene {
 public:
@@ -70,13 +76,25 @@ public:
     // for that in a few places.
     static constexpr size_t DIRECTIONAL_LIGHTS_COUNT = 1;
 
+    // alignment of the SoA arrays, their capacity is a multiple of the number of elements
+    // that span this many bytes in each array, so SIMD loops don't need a scalar tail.
+    static constexpr size_t SIMD_ALIGNMENT = 32;
+
     explicit FScene(FEngine& engine);
     ~FScene() noexcept;
     void terminate(FEngine& engine);
 
-    void prepare(utils::JobSystem& js, RootArenaScope& rootArenaScope,
+    FEngine& getEngine() const noexcept { return mEngine; }
+
+    void prepare(utils::JobSystem& js,
             math::mat4 const& worldTransform, bool shadowReceiversAreCasters) noexcept;
 
+    // While shared preparation is enabled, the result of prepare() is kept, and the following
+    // calls with the same parameters restore it instead of gathering the scene again. This is
+    // only valid as long as the scene and its components don't change, i.e. between the views
+    // rendered by a single Renderer::render() call.
+    void setSharedPreparationEnabled(bool enabled) noexcept;
+
     void prepareVisibleRenderables(utils::Range<uint32_t> visibleRenderables) noexcept;
 
     void prepareDynamicLights(const CameraInfo& camera,
@@ -113,7 +131,7 @@ public:
         USER_DATA,              //   4 | user data currently used to store the scale
     };
 
-    using RenderableSoa = utils::StructureOfArrays<
+    using RenderableSoa = utils::AlignedStructureOfArrays<SIMD_ALIGNMENT,
             utils::EntityInstance<RenderableManager>,   // RENDERABLE_INSTANCE
             math::mat4f,                                // WORLD_TRANSFORM
             FRenderableManager::Visibility,             // VISIBILITY_STATE
@@ -172,7 +190,7 @@ public:
         SHADOW_INFO
     };
 
-    using LightSoa = utils::StructureOfArrays<
+    using LightSoa = utils::AlignedStructureOfArrays<SIMD_ALIGNMENT,
             math::float4,
             math::float3,
             math::float3,
@@ -183,11 +201,24 @@ public:
             ShadowInfo
     >;
 
+    // Renderables with static bounds (GeometryType other than DYNAMIC) are stored at the end
+    // of the RenderableSoa after prepare(), and must be culled with cullStaticRenderables().
+    size_t getStaticRenderableCount() const noexcept { return mStaticRenderableCount; }
+
+    // Sets `bit` of VISIBLE_MASK for the static renderables intersecting the frustum. The bit
+    // must have been cleared beforehand.
+    void cullStaticRenderables(Frustum const& frustum, size_t bit) noexcept;
+
     LightSoa const& getLightData() const noexcept { return mLightData; }
     LightSoa& getLightData() noexcept { return mLightData; }
 
+    // Uploads the per-renderable data of the visible renderables to `renderableUbh`.
+    // If `committed` is not null, it holds the data previously uploaded to `renderableUbh` (or is
+    // empty if unknown), and only the data that changed since is uploaded.
     void updateUBOs(utils::Range<uint32_t> visibleRenderables,
-            backend::Handle<backend::HwBufferObject> renderableUbh) noexcept;
+            backend::Handle<backend::HwBufferObject> renderableUbh,
+            Frustum const& cullingFrustum,
+            std::vector<PerRenderableData>* committed = nullptr) noexcept;
 
     bool hasContactShadows() const noexcept;
 
@@ -205,6 +236,35 @@ private:
     size_t getLightCount() const noexcept;
     bool hasEntity(utils::Entity entity) const noexcept;
     void forEach(utils::Invocable<void(utils::Entity)>&& functor) const noexcept;
+    RaycastResult raycast(math::float3 const& origin, math::float3 const& direction,
+            float maxDistance) const noexcept;
+
+    // updates mRenderableInstances, mLightInstances and mDirectionalLightInstances if the
+    // entities of the scene or their components changed
+    void gatherInstances() noexcept;
+
+    void updateStaticBvh(math::mat4 const& worldTransform) noexcept;
+
+    void savePreparedData() noexcept;
+    void restorePreparedData() noexcept;
+
+    // returns false if the whole UBO needs to be updated instead
+    bool updateUBOsIncremental(utils::Range<uint32_t> visibleRenderables,
+            backend::Handle<backend::HwBufferObject> renderableUbh,
+            std::vector<PerRenderableData>& committed) noexcept;
+
+    PerRenderableData* allocateRenderableData(size_t count) noexcept;
+
+    backend::BufferDescriptor createRenderableDataDescriptor(
+            PerRenderableData* buffer, size_t count) const noexcept;
+
+    // don't allocate more than 16 KiB directly into the render stream
+    static constexpr size_t MAX_STREAM_ALLOCATION_COUNT = 64;   // 16 KiB
+
+    // incremental updates use at most this many buffer updates...
+    static constexpr size_t MAX_UBO_DIRTY_RANGES = 16;
+    // ...and merge dirty ranges separated by at most this many renderables
+    static constexpr uint32_t MAX_UBO_DIRTY_RANGE_GAP = 8;
 
     static inline void computeLightRanges(math::float2* zrange,
             CameraInfo const& camera, const math::float4* spheres, size_t count) noexcept;
@@ -214,11 +274,39 @@ private:
     FIndirectLight* mIndirectLight = nullptr;
 
     /*
-     * list of Entities in the scene. We use a robin_set<> so we can do efficient removes
-     * (a vector<> could work, but removes would be O(n)). robin_set<> iterates almost as
-     * nicely as vector<>, which is a good compromise.
+     * list of Entities in the scene, kept dense so that it iterates like a vector<>.
+     * mEntityIndices gives the index of each entity in mEntities, so that removes are O(1):
+     * the last entity takes the place of the removed one.
      */
-    tsl::robin_set<utils::Entity, utils::Entity::Hasher> mEntities;
+    std::vector<utils::Entity> mEntities;
+    tsl::robin_map<utils::Entity, uint32_t, utils::Entity::Hasher> mEntityIndices;
+    uint32_t mEntitiesVersion = 0;      // incremented when mEntities changes
+
+    /*
+     * Instances of the renderables and lights of the scene, in the order used by prepare().
+     * They're gathered again only when the scene's entities or the instances of their
+     * components may have changed, since this requires a hash-map lookup per entity and
+     * component.
+     */
+    template<typename Instance>
+    using InstancePair = std::pair<Instance, TransformManager::Instance>;
+    struct InstanceCacheKey {
+        uint32_t entities;      // mEntitiesVersion
+        uint32_t renderables;   // FRenderableManager::getVersion()
+        uint32_t lights;        // FLightManager::getVersion()
+        uint32_t transforms;    // FTransformManager::getVersion()
+        size_t aliveCount;      // number of live entities in mEntities
+        bool operator==(InstanceCacheKey const& rhs) const noexcept {
+            return entities == rhs.entities && renderables == rhs.renderables &&
+                   lights == rhs.lights && transforms == rhs.transforms &&
+                   aliveCount == rhs.aliveCount;
+        }
+    };
+    std::vector<InstancePair<RenderableManager::Instance>> mRenderableInstances;
+    std::vector<InstancePair<LightManager::Instance>> mLightInstances;
+    std::vector<InstancePair<LightManager::Instance>> mDirectionalLightInstances;
+    InstanceCacheKey mInstanceCacheKey{};
+    bool mInstanceCacheValid = false;
 
 
     /*
@@ -231,6 +319,22 @@ private:
     LightSoa mLightData;
     bool mHasContactShadows = false;
 
+    // hierarchy of the static renderables, stored at the end of mRenderableData
+    BoundingVolumeHierarchy mStaticBvh;
+    std::vector<utils::Entity> mStaticBvhEntities;  // renderable of each box of mStaticBvh
+    math::mat4 mStaticBvhWorldTransform;    // world transform used to build mStaticBvh
+    math::mat4 mWorldTransform;             // world transform of the last prepare()
+    uint32_t mStaticBvhKey = 0;
+    uint32_t mStaticRenderableCount = 0;
+
+    // result of the last prepare() in its original order, reused by shared preparation
+    RenderableSoa mPreparedRenderableData;
+    LightSoa mPreparedLightData;
+    math::mat4 mPreparedWorldTransform;
+    bool mPreparedShadowReceiversAreCasters = false;
+    bool mHasPreparedData = false;
+    bool mSharedPreparation = false;
+
     // State shared between Scene and driver callbacks.
     struct SharedState {
         BufferPoolAllocator<3> mBufferPoolAllocator = {};
@@ -45,15 +45,18 @@
 #include <utils/StaticString.h>
 #include <utils/debug.h>
 #include <utils/FixedCapacityVector.h>
+#include <utils/JobSystem.h>
 #include <utils/Panic.h>
 
 #include <algorithm>
+#include <cmath>
 #include <array>
 #include <type_traits>
 #include <utility>
 
 #include <stddef.h>
 #include <stdint.h>
+#include <stdlib.h>
 
 using namespace utils;
 
@@ -171,6 +174,17 @@ Texture* Texture::Builder::build(Engine& engine) {
             (isProtectedTexturesSupported && useProtectedMemory) || !useProtectedMemory)
             << "Texture is PROTECTED but protected textures are not supported";
 
+    if (any(mImpl->mUsage & TextureUsage::SPARSE)) {
+        FILAMENT_CHECK_PRECONDITION(mImpl->mTarget == SamplerType::SAMPLER_2D &&
+                !mImpl->mExternal && !mImpl->mImportedId &&
+                none(mImpl->mUsage & (TextureUsage::ALL_ATTACHMENTS | TextureUsage::PROTECTED)))
+                << "SPARSE textures must be non-protected 2D textures that are not attachments";
+        FILAMENT_CHECK_PRECONDITION(
+                getSparsePageSize(engine, mImpl->mTarget, mImpl->mFormat) != math::uint2{})
+                << "SPARSE textures of format " << uint16_t(mImpl->mFormat)
+                << " are not supported on this platform";
+    }
+
     size_t const maxTextureDimension = getMaxTextureSize(engine, mImpl->mTarget);
     size_t const maxTextureDepth = (mImpl->mTarget == Sampler::SAMPLER_2D_ARRAY ||
                                     mImpl->mTarget == Sampler::SAMPLER_CUBEMAP_ARRAY)
@@ -317,6 +331,7 @@ FTexture::FTexture(FEngine& engine, const Builder& builder) {
 
 // frees driver resources, object becomes invalid
 void FTexture::terminate(FEngine& engine) {
+    engine.getTextureUploadQueue().cancel(engine.getDriverApi(), this);
     setHandles({});
 }
 
@@ -332,10 +347,10 @@ size_t FTexture::getDepth(size_t const level) const noexcept {
     return valueForLevel(level, mDepth);
 }
 
-void FTexture::setImage(FEngine& engine, size_t const level,
+void FTexture::validateImage(FEngine& engine, size_t const level,
         uint32_t const xoffset, uint32_t const yoffset, uint32_t const zoffset,
         uint32_t const width, uint32_t const height, uint32_t const depth,
-        PixelBufferDescriptor&& p) const {
+        PixelBufferDescriptor const& p) const {
 
     if (UTILS_UNLIKELY(!engine.hasFeatureLevel(FeatureLevel::FEATURE_LEVEL_1))) {
         FILAMENT_CHECK_PRECONDITION(p.stride == 0 || p.stride == width)
@@ -415,6 +430,13 @@ void FTexture::setImage(FEngine& engine, size_t const level,
                "{{"
             << unsigned(xoffset) << "," << unsigned(yoffset) << "," << unsigned(zoffset) << "},{"
             << unsigned(width) << "," << unsigned(height) << "," << unsigned(depth) << ")}}";
+}
+
+void FTexture::setImage(FEngine& engine, size_t const level,
+        uint32_t const xoffset, uint32_t const yoffset, uint32_t const zoffset,
+        uint32_t const width, uint32_t const height, uint32_t const depth,
+        PixelBufferDescriptor&& p) const {
+    validateImage(engine, level, xoffset, yoffset, zoffset, width, height, depth, p);
 
     engine.getDriverApi().update3DImage(mHandle,
             uint8_t(level), xoffset, yoffset, zoffset, width, height, depth, std::move(p));
@@ -423,6 +445,17 @@ void FTexture::setImage(FEngine& engine, size_t const level,
     const_cast<FTexture*>(this)->updateLodRange(level);
 }
 
+void FTexture::setImageAsync(FEngine& engine, size_t const level,
+        uint32_t const xoffset, uint32_t const yoffset, uint32_t const zoffset,
+        uint32_t const width, uint32_t const height, uint32_t const depth,
+        PixelBufferDescriptor&& p) const {
+    validateImage(engine, level, xoffset, yoffset, zoffset, width, height, depth, p);
+
+    // the lod range is updated once the last chunk is uploaded
+    engine.getTextureUploadQueue().push(this, uint8_t(level),
+            xoffset, yoffset, zoffset, width, height, depth, std::move(p));
+}
+
 // deprecated
 void FTexture::setImage(FEngine& engine, size_t const level,
         PixelBufferDescriptor&& buffer, const FaceOffsets& faceOffsets) const {
@@ -598,6 +631,194 @@ void FTexture::generateMipmaps(FEngine& engine) const noexcept {
     const_cast<FTexture*>(this)->updateLodRange(0, mLevelCount);
 }
 
+void FTexture::commitPages(FEngine& engine, size_t const level, uint32_t const xoffset,
+        uint32_t const yoffset, uint32_t const width, uint32_t const height,
+        bool const commit) const {
+    FILAMENT_CHECK_PRECONDITION(any(mUsage & Usage::SPARSE))
+            << "Texture::commitPages() called on a texture without Texture::Usage::SPARSE";
+
+    FILAMENT_CHECK_PRECONDITION(level < mLevelCount)
+            << "level=" << unsigned(level) << " is >= to levelCount=" << unsigned(mLevelCount) << ".";
+
+    FILAMENT_CHECK_PRECONDITION(xoffset + width <= valueForLevel(level, mWidth))
+            << "xoffset (" << unsigned(xoffset) << ") + width (" << unsigned(width)
+            << ") > texture width (" << valueForLevel(level, mWidth) << ") at level ("
+            << unsigned(level) << ")";
+
+    FILAMENT_CHECK_PRECONDITION(yoffset + height <= valueForLevel(level, mHeight))
+            << "yoffset (" << unsigned(yoffset) << ") + height (" << unsigned(height)
+            << ") > texture height (" << valueForLevel(level, mHeight) << ") at level ("
+            << unsigned(level) << ")";
+
+    engine.getDriverApi().commitTexturePages(mHandle, uint32_t(level),
+            xoffset, yoffset, width, height, commit);
+}
+
+namespace {
+
+float sRGBToLinear(float const c) noexcept {
+    return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+float linearToSRGB(float const c) noexcept {
+    return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+}
+
+// Converts the components of a texel row to and from float, for the CPU mipmap filter
+template<typename T>
+struct MipmapComponent;
+
+template<>
+struct MipmapComponent<uint8_t> {
+    static float toFloat(uint8_t const v, float const* decode) noexcept {
+        return decode ? decode[v] : float(v) * (1.0f / 255.0f);
+    }
+    static uint8_t fromFloat(float v, bool const encode) noexcept {
+        v = encode ? linearToSRGB(saturate(v)) : saturate(v);
+        return uint8_t(v * 255.0f + 0.5f);
+    }
+};
+
+template<>
+struct MipmapComponent<half> {
+    static float toFloat(half const v, float const*) noexcept { return float(v); }
+    static half fromFloat(float const v, bool) noexcept { return half(v); }
+};
+
+template<>
+struct MipmapComponent<float> {
+    static float toFloat(float const v, float const*) noexcept { return v; }
+    static float fromFloat(float const v, bool) noexcept { return v; }
+};
+
+// 2x2 box filter of rows [first, first + count) of dst, src is clamped to its edges
+template<typename T>
+void downsampleRows(uint8_t const* src, size_t const srcBpr, uint32_t const srcWidth,
+        uint32_t const srcHeight, uint8_t* dst, size_t const dstBpr, uint32_t const dstWidth,
+        size_t const channels, float const* decode, uint32_t const first, uint32_t const count) {
+    using C = MipmapComponent<T>;
+    // the alpha channel is never sRGB encoded
+    size_t const encodedChannels = decode ? std::min(channels, size_t(3)) : 0;
+    for (uint32_t y = first; y < first + count; y++) {
+        T const* const r0 = (T const*)(src + std::min(2 * y, srcHeight - 1) * srcBpr);
+        T const* const r1 = (T const*)(src + std::min(2 * y + 1, srcHeight - 1) * srcBpr);
+        T* const out = (T*)(dst + y * dstBpr);
+        for (uint32_t x = 0; x < dstWidth; x++) {
+            size_t const x0 = std::min(2 * x, srcWidth - 1) * channels;
+            size_t const x1 = std::min(2 * x + 1, srcWidth - 1) * channels;
+            for (size_t c = 0; c < channels; c++) {
+                float const* const d = c < encodedChannels ? decode : nullptr;
+                float const v = C::toFloat(r0[x0 + c], d) + C::toFloat(r0[x1 + c], d) +
+                                C::toFloat(r1[x0 + c], d) + C::toFloat(r1[x1 + c], d);
+                out[x * channels + c] = C::fromFloat(v * 0.25f, d != nullptr);
+            }
+        }
+    }
+}
+
+} // anonymous namespace
+
+void FTexture::generateMipmaps(FEngine& engine, PixelBufferDescriptor&& buffer) const {
+    FILAMENT_CHECK_PRECONDITION(mTarget == SamplerType::SAMPLER_2D)
+            << "generateMipmaps() with a buffer requires a 2D texture.";
+
+    FILAMENT_CHECK_PRECONDITION(!isCompressed() && buffer.type != PixelDataType::COMPRESSED)
+            << "generateMipmaps() with a buffer doesn't support compressed textures.";
+
+    size_t channels = 0;
+    switch (buffer.format) {
+        case PixelDataFormat::R:    channels = 1; break;
+        case PixelDataFormat::RG:   channels = 2; break;
+        case PixelDataFormat::RGB:  channels = 3; break;
+        case PixelDataFormat::RGBA: channels = 4; break;
+        default: break;
+    }
+    FILAMENT_CHECK_PRECONDITION(channels)
+            << "generateMipmaps() with a buffer requires an R, RG, RGB or RGBA format.";
+
+    FILAMENT_CHECK_PRECONDITION(buffer.type == PixelDataType::UBYTE ||
+            buffer.type == PixelDataType::HALF || buffer.type == PixelDataType::FLOAT)
+            << "generateMipmaps() with a buffer requires a UBYTE, HALF or FLOAT type.";
+
+    FILAMENT_CHECK_PRECONDITION(validatePixelFormatAndType(mFormat, buffer.format, buffer.type))
+            << "The combination of internal format=" << unsigned(mFormat)
+            << " and {format=" << unsigned(buffer.format) << ", type=" << unsigned(buffer.type)
+            << "} is not supported.";
+
+    size_t const stride = buffer.stride ? buffer.stride : mWidth;
+    FILAMENT_CHECK_PRECONDITION(buffer.left + mWidth <= stride)
+            << "buffer is too small for level 0.";
+
+    size_t const bpp = PixelBufferDescriptor::computeDataSize(
+            buffer.format, buffer.type, 1, 1, 1);
+    size_t const srcBpr = PixelBufferDescriptor::computeDataSize(
+            buffer.format, buffer.type, stride, 1, buffer.alignment);
+    FILAMENT_CHECK_PRECONDITION(buffer.size >= PixelBufferDescriptor::computeDataSize(
+            buffer.format, buffer.type, stride, buffer.top + mHeight, buffer.alignment))
+            << "buffer is too small for level 0.";
+
+    // sRGB textures are filtered in linear space
+    bool const sRGB = buffer.type == PixelDataType::UBYTE &&
+            (mFormat == InternalFormat::SRGB8 || mFormat == InternalFormat::SRGB8_A8);
+    float decode[256];
+    if (sRGB) {
+        for (size_t i = 0; i < 256; i++) {
+            decode[i] = sRGBToLinear(float(i) * (1.0f / 255.0f));
+        }
+    }
+
+    auto downsample = [type = buffer.type](auto&&... args) {
+        switch (type) {
+            case PixelDataType::UBYTE: downsampleRows<uint8_t>(args...); break;
+            case PixelDataType::HALF:  downsampleRows<half>(args...);    break;
+            default:                   downsampleRows<float>(args...);   break;
+        }
+    };
+
+    // All the levels are generated before level 0 is handed over to the driver, which may
+    // release it as soon as it's uploaded.
+    JobSystem& js = engine.getJobSystem();
+    PixelDataFormat const format = buffer.format;
+    PixelDataType const type = buffer.type;
+    uint8_t const* src = static_cast<uint8_t const*>(buffer.buffer) +
+            buffer.top * srcBpr + buffer.left * bpp;
+    size_t bpr = srcBpr;
+    uint32_t width = mWidth;
+    uint32_t height = mHeight;
+    FixedCapacityVector<PixelBufferDescriptor> levels =
+            FixedCapacityVector<PixelBufferDescriptor>::with_capacity(mLevelCount);
+    for (size_t level = 1; level < mLevelCount; level++) {
+        uint32_t const w = std::max(1u, width >> 1);
+        uint32_t const h = std::max(1u, height >> 1);
+        size_t const dstBpr = w * bpp;
+        size_t const size = dstBpr * h;
+        uint8_t* const dst = static_cast<uint8_t*>(malloc(size));
+
+        auto work = [=, &decode, &downsample](uint32_t const first, uint32_t const count) {
+            downsample(src, bpr, width, height, dst, dstBpr, w, channels,
+                    sRGB ? decode : nullptr, first, count);
+        };
+        js.runAndWait(jobs::parallel_for(js, nullptr, 0, h, std::cref(work),
+                jobs::CountSplitter<16>()));
+
+        levels.emplace_back(dst, size, format, type,
+                [](void* buffer, size_t, void*) { free(buffer); });
+        src = dst;
+        bpr = dstBpr;
+        width = w;
+        height = h;
+    }
+
+    setImage(engine, 0, 0, 0, 0, mWidth, mHeight, 1, std::move(buffer));
+    width = mWidth;
+    height = mHeight;
+    for (size_t level = 1; level < mLevelCount; level++) {
+        width = std::max(1u, width >> 1);
+        height = std::max(1u, height >> 1);
+        setImage(engine, level, 0, 0, 0, width, height, 1, std::move(levels[level - 1]));
+    }
+}
+
 bool FTexture::textureHandleCanMutate() const noexcept {
     return (any(mUsage & Usage::SAMPLEABLE) && mLevelCount > 1) || mExternal;
 }
@@ -701,6 +922,11 @@ size_t FTexture::getMaxArrayTextureLayers(FEngine& engine) noexcept {
     return engine.getDriverApi().getMaxArrayTextureLayers();
 }
 
+math::uint2 FTexture::getSparsePageSize(FEngine& engine, Sampler const type,
+        InternalFormat const format) noexcept {
+    return engine.getDriverApi().getSparseTexturePageSize(type, format).xy;
+}
+
 size_t FTexture::computeTextureDataSize(Format const format, Type const type,
         size_t const stride, size_t const height, size_t const alignment) noexcept {
     return PixelBufferDescriptor::computeDataSize(format, type, stride, height, alignment);
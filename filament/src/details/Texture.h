@@ -58,6 +58,11 @@ public:
             uint32_t width, uint32_t height, uint32_t depth,
             PixelBufferDescriptor&& buffer) const;
 
+    void setImageAsync(FEngine& engine, size_t level,
+            uint32_t xoffset, uint32_t yoffset, uint32_t zoffset,
+            uint32_t width, uint32_t height, uint32_t depth,
+            PixelBufferDescriptor&& buffer) const;
+
     UTILS_DEPRECATED
     void setImage(FEngine& engine, size_t level,
             PixelBufferDescriptor&& buffer, const FaceOffsets& faceOffsets) const;
@@ -73,6 +78,11 @@ public:
 
     void generateMipmaps(FEngine& engine) const noexcept;
 
+    void generateMipmaps(FEngine& engine, PixelBufferDescriptor&& buffer) const;
+
+    void commitPages(FEngine& engine, size_t level, uint32_t xoffset, uint32_t yoffset,
+            uint32_t width, uint32_t height, bool commit) const;
+
     void setSampleCount(size_t const sampleCount) noexcept { mSampleCount = uint8_t(sampleCount); }
     size_t getSampleCount() const noexcept { return mSampleCount; }
     bool isMultisample() const noexcept { return mSampleCount > 1; }
@@ -128,6 +138,10 @@ public:
 
     static size_t getMaxArrayTextureLayers(FEngine& engine) noexcept;
 
+    // Synchronous call to the backend. Returns the page size of sparse textures, or zero.
+    static math::uint2 getSparsePageSize(FEngine& engine, Sampler type,
+            InternalFormat format) noexcept;
+
     bool textureHandleCanMutate() const noexcept;
     void updateLodRange(uint8_t level) noexcept;
 
@@ -151,6 +165,10 @@ private:
     }
 
     void updateLodRange(uint8_t baseLevel, uint8_t levelCount) noexcept;
+    void validateImage(FEngine& engine, size_t level,
+            uint32_t xoffset, uint32_t yoffset, uint32_t zoffset,
+            uint32_t width, uint32_t height, uint32_t depth,
+            PixelBufferDescriptor const& buffer) const;
     void setHandles(backend::Handle<backend::HwTexture> handle) noexcept;
     backend::Handle<backend::HwTexture> setHandleForSampling(
             backend::Handle<backend::HwTexture> handle) const noexcept;
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "details/TextureAtlas.h"
+
+#include "details/Engine.h"
+#include "details/Texture.h"
+
+#include "FilamentAPI-impl.h"
+
+#include <utils/CString.h>
+#include <utils/Panic.h>
+#include <utils/StaticString.h>
+
+#include <math/vec2.h>
+
+#include <algorithm>
+#include <utility>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace filament {
+
+using namespace math;
+
+struct TextureAtlas::BuilderDetails {
+    uint32_t mSize = 1024;
+    uint8_t mLayerCount = 1;
+    Texture::InternalFormat mFormat = Texture::InternalFormat::RGBA8;
+};
+
+using BuilderType = TextureAtlas;
+BuilderType::Builder::Builder() noexcept = default;
+BuilderType::Builder::~Builder() noexcept = default;
+BuilderType::Builder::Builder(Builder const& rhs) noexcept = default;
+BuilderType::Builder::Builder(Builder&& rhs) noexcept = default;
+BuilderType::Builder& BuilderType::Builder::operator=(Builder const& rhs) noexcept = default;
+BuilderType::Builder& BuilderType::Builder::operator=(Builder&& rhs) noexcept = default;
+
+TextureAtlas::Builder& TextureAtlas::Builder::size(uint32_t const size) noexcept {
+    mImpl->mSize = size;
+    return *this;
+}
+
+TextureAtlas::Builder& TextureAtlas::Builder::layerCount(uint8_t const layerCount) noexcept {
+    mImpl->mLayerCount = layerCount;
+    return *this;
+}
+
+TextureAtlas::Builder& TextureAtlas::Builder::format(Texture::InternalFormat const format) noexcept {
+    mImpl->mFormat = format;
+    return *this;
+}
+
+TextureAtlas::Builder& TextureAtlas::Builder::name(utils::StaticString const& name) noexcept {
+    return BuilderNameMixin::name(name);
+}
+
+TextureAtlas* TextureAtlas::Builder::build(Engine& engine) {
+    uint32_t const size = mImpl->mSize;
+    FILAMENT_CHECK_PRECONDITION(size >= (1u << (REGION_SIZE_COUNT - 1)) && !(size & (size - 1)))
+            << "TextureAtlas size must be a power of two, and at least "
+            << (1u << (REGION_SIZE_COUNT - 1)) << ", but is " << size << ".";
+    FILAMENT_CHECK_PRECONDITION(
+            mImpl->mLayerCount >= 1 && mImpl->mLayerCount <= MAX_LAYER_COUNT)
+            << "TextureAtlas layerCount must be between 1 and " << MAX_LAYER_COUNT
+            << ", but is " << +mImpl->mLayerCount << ".";
+    return downcast(engine).createTextureAtlas(*this);
+}
+
+// ------------------------------------------------------------------------------------------------
+
+FTextureAtlas::FTextureAtlas(FEngine& engine, const Builder& builder)
+    : mAllocator(builder->mSize), mName(builder.getName()),
+      mSize(builder->mSize), mLayerCount(builder->mLayerCount) {
+    // With a single layer, the atlas can be bound to regular 2D samplers, e.g. gltfio's.
+    mTexture = downcast(Texture::Builder()
+            .width(mSize)
+            .height(mSize)
+            .depth(mLayerCount)
+            .levels(1)
+            .sampler(mLayerCount > 1 ? Texture::Sampler::SAMPLER_2D_ARRAY :
+                    Texture::Sampler::SAMPLER_2D)
+            .format(builder->mFormat)
+            .build(engine));
+}
+
+void FTextureAtlas::terminate(FEngine& engine) {
+    engine.destroy(mTexture);
+    mTexture = nullptr;
+}
+
+TextureAtlas::Region FTextureAtlas::add(FEngine& engine, uint32_t const width,
+        uint32_t const height, Texture::PixelBufferDescriptor&& buffer) {
+    FILAMENT_CHECK_PRECONDITION(width && height && width <= mSize && height <= mSize)
+            << "Image of " << width << "x" << height << " doesn't fit in TextureAtlas \""
+            << mName.c_str_safe() << "\" of size " << mSize << ".";
+
+    // the smallest power-of-two square holding the image, among the sizes AtlasAllocator handles
+    uint32_t const extent = std::max(width, height);
+    uint32_t regionSize = mSize;
+    for (size_t i = 1; i < REGION_SIZE_COUNT && (regionSize >> 1u) >= extent; i++) {
+        regionSize >>= 1u;
+    }
+
+    // AtlasAllocator fills the layers in order, so once it returns a layer past the ones we
+    // have, all of ours are full for this size.
+    AtlasAllocator::Allocation const allocation = mAllocator.allocate(regionSize);
+    if (allocation.layer < 0 || allocation.layer >= int32_t(mLayerCount)) {
+        return {};
+    }
+
+    Viewport const& viewport = allocation.viewport;
+    mTexture->setImage(engine, 0,
+            uint32_t(viewport.left), uint32_t(viewport.bottom), uint32_t(allocation.layer),
+            width, height, 1, std::move(buffer));
+    mRegionCount++;
+
+    // Map [0, 1] to the centers of the image's edge texels, so that bilinear filtering never
+    // reads the neighboring images.
+    float const texelSize = 1.0f / float(mSize);
+    Region region;
+    region.layer = allocation.layer;
+    region.offset = (float2{ float(viewport.left), float(viewport.bottom) } + 0.5f) * texelSize;
+    region.scale = float2{ float(width - 1), float(height - 1) } * texelSize;
+    return region;
+}
+
+void FTextureAtlas::clear() noexcept {
+    mAllocator.clear(mSize);
+    mRegionCount = 0;
+}
+
+} // namespace filament
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_DETAILS_TEXTUREATLAS_H
+#define TNT_FILAMENT_DETAILS_TEXTUREATLAS_H
+
+#include "downcast.h"
+
+#include "AtlasAllocator.h"
+
+#include <filament/Texture.h>
+#include <filament/TextureAtlas.h>
+
+#include <utils/CString.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace filament {
+
+class FEngine;
+class FTexture;
+
+class FTextureAtlas : public TextureAtlas {
+public:
+    FTextureAtlas(FEngine& engine, const Builder& builder);
+
+    void terminate(FEngine& engine);
+
+    Region add(FEngine& engine, uint32_t width, uint32_t height,
+            Texture::PixelBufferDescriptor&& buffer);
+
+    void clear() noexcept;
+
+    FTexture* getTexture() const noexcept { return mTexture; }
+
+    size_t getRegionCount() const noexcept { return mRegionCount; }
+
+    utils::CString const& getName() const noexcept { return mName; }
+
+private:
+    AtlasAllocator mAllocator;
+    FTexture* mTexture = nullptr;
+    utils::CString mName;
+    size_t mRegionCount = 0;
+    uint32_t mSize;
+    uint8_t mLayerCount;
+};
+
+FILAMENT_DOWNCAST(TextureAtlas)
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_DETAILS_TEXTUREATLAS_H
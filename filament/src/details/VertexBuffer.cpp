@@ -61,6 +61,7 @@ struct VertexBuffer::BuilderDetails {
     AttributeBitset mDeclaredAttributes;
     uint32_t mVertexCount = 0;
     uint8_t mBufferCount = 0;
+    BufferUsage mUsage = BufferUsage::STATIC;
     bool mBufferObjectsEnabled = false;
     bool mAdvancedSkinningEnabled = false; // TODO: use bits to save memory
 };
@@ -83,6 +84,11 @@ VertexBuffer::Builder& VertexBuffer::Builder::enableBufferObjects(bool const ena
     return *this;
 }
 
+VertexBuffer::Builder& VertexBuffer::Builder::usage(BufferUsage const usage) noexcept {
+    mImpl->mUsage = usage;
+    return *this;
+}
+
 VertexBuffer::Builder& VertexBuffer::Builder::bufferCount(uint8_t const bufferCount) noexcept {
     mImpl->mBufferCount = bufferCount;
     return *this;
@@ -298,7 +304,7 @@ FVertexBuffer::FVertexBuffer(FEngine& engine, const Builder& builder)
                 assert_invariant(bufferSizes[i] > 0);
                 if (!mBufferObjects[i]) {
                     BufferObjectHandle bo = driver.createBufferObject(bufferSizes[i],
-                            BufferObjectBinding::VERTEX, BufferUsage::STATIC);
+                            BufferObjectBinding::VERTEX, builder->mUsage);
                     if (auto name = builder.getName(); !name.empty()) {
                         driver.setDebugTag(bo.getId(), name);
                     }
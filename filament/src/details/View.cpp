@@ -19,6 +19,7 @@
 #include "Culler.h"
 #include "FrameHistory.h"
 #include "Froxelizer.h"
+#include "OcclusionCuller.h"
 #include "RenderPrimitive.h"
 #include "ResourceAllocator.h"
 #include "ShadowMapManager.h"
@@ -48,10 +49,15 @@
 #include <math/scalar.h>
 #include <math/fast.h>
 
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <limits>
 #include <memory>
 #include <tuple>
 
+#include <string.h>
+
 using namespace utils;
 
 namespace filament {
@@ -62,8 +68,19 @@ using namespace math;
 static constexpr float PID_CONTROLLER_Ki = 0.002f;
 static constexpr float PID_CONTROLLER_Kd = 0.0f;
 
+// When there are more lights (or shadow-casting lights) than the budget allows, the importance of
+// the lights that were kept in the previous frame is boosted by this factor, so that lights of
+// similar importance don't pop in and out from one frame to the next.
+static constexpr float LIGHT_SELECTION_HYSTERESIS = 1.25f;
+
+static bool wasSelected(std::vector<FLightManager::Instance> const& selected,
+        FLightManager::Instance const li) noexcept {
+    return std::binary_search(selected.begin(), selected.end(), li);
+}
+
 FView::FView(FEngine& engine)
-        : mCommonRenderableDescriptorSet(engine.getPerRenderableDescriptorSetLayout()),
+        : mEngine(engine),
+          mCommonRenderableDescriptorSet(engine.getPerRenderableDescriptorSetLayout()),
           mFroxelizer(engine),
           mFogEntity(engine.getEntityManager().create()),
           mIsStereoSupported(engine.getDriverApi().isStereoSupported()),
@@ -83,6 +100,9 @@ FView::FView(FEngine& engine)
     // Dead-band, 1% for scaling down, 5% for scaling up. This stabilizes all the jitters.
     mPidController.setOutputDeadBand(-0.01f, 0.05f);
 
+    // the directional light and every spot or point light that can cast shadows
+    mReducedShadowOptions.reserve(CONFIG_MAX_SHADOWMAPS + 1);
+
 #ifndef NDEBUG
     // This can fail if another view has already registered this data source
     mDebugState->owner = debugRegistry.registerDataSource("d.view.frame_info",
@@ -143,6 +163,7 @@ void FView::terminate(FEngine& engine) {
     driver.destroyBufferObject(mLightUbh);
     driver.destroyBufferObject(mRenderableUbh);
     clearFrameHistory(engine);
+    mColorPassCommandCache.clear();
 
     ShadowMapManager::terminate(engine, mShadowMapManager);
     mUniforms.terminate(driver);
@@ -175,6 +196,12 @@ void FView::setViewport(filament::Viewport const& viewport) noexcept {
 
 void FView::setDynamicResolutionOptions(DynamicResolutionOptions const& options) noexcept {
     DynamicResolutionOptions& dynamicResolution = mDynamicResolution;
+    if (options.predictive != dynamicResolution.predictive) {
+        // start learning from scratch
+        mFrameTimePredictor.reset();
+        mScaleHistory = {};
+        mReferenceLoad = 0.0f;
+    }
     dynamicResolution = options;
 
     // only enable if dynamic resolution is supported
@@ -200,10 +227,28 @@ void FView::setDynamicLightingOptions(float const zLightNear, float const zLight
     mFroxelizer.setOptions(zLightNear, zLightFar);
 }
 
-float2 FView::updateScale(FEngine& engine,
+bool FView::updateDepthPrepass(uint32_t const frameId,
+        filament::details::FrameInfo const& info) noexcept {
+    switch (mDepthPrepass) {
+        case DepthPrepass::DISABLED:
+            return false;
+        case DepthPrepass::ENABLED:
+            return true;
+        case DepthPrepass::AUTOMATIC:
+            if (info.valid) {
+                using std::chrono::duration;
+                mDepthPrepassController.addMeasurement(info.frameId,
+                        duration<float, std::milli>{ info.frameTime }.count());
+            }
+            return mDepthPrepassController.update(frameId);
+    }
+    return false;
+}
+
+float2 FView::updateScale(FEngine& engine, uint32_t const frameId,
         filament::details::FrameInfo const& info,
         Renderer::FrameRateOptions const& frameRateOptions,
-        Renderer::DisplayInfo const& displayInfo) noexcept {
+        Renderer::DisplayInfo const& displayInfo, float const maxScale) noexcept {
 
 #ifndef NDEBUG
     if (UTILS_LIKELY(!mDebugState->active)) {
@@ -215,11 +260,34 @@ float2 FView::updateScale(FEngine& engine,
     }
 #endif
 
-    DynamicResolutionOptions const& options = mDynamicResolution;
+    // the quality governor can cap the scale, it then lowers the minimum scale too if needed
+    DynamicResolutionOptions options = mDynamicResolution;
+    options.maxScale = min(options.maxScale, float2(maxScale));
+    options.minScale = min(options.minScale, options.maxScale);
     if (options.enabled) {
+        // geometry workload of this frame, relative to when the predictor started
+        float load = 0.0f;
+        if (options.predictive) {
+            float const renderableCount =
+                    mScene ? float(mScene->getRenderableData().size()) : 0.0f;
+            if (mReferenceLoad == 0.0f) {
+                mReferenceLoad = std::max(1.0f, renderableCount);
+            }
+            load = renderableCount / mReferenceLoad;
+        }
+
+        // remember how this frame is rendered, to match it with its timings later
+        auto const recordScale = [&]() {
+            if (options.predictive) {
+                mScaleHistory[frameId % mScaleHistory.size()] = {
+                        frameId, mScale.x * mScale.y, load };
+            }
+        };
+
         if (!UTILS_UNLIKELY(info.valid)) {
             // always clamp to the min/max scale range
             mScale = clamp(1.0f, options.minScale, options.maxScale);
+            recordScale();
             return mScale;
         }
 
@@ -255,7 +323,28 @@ float2 FView::updateScale(FEngine& engine,
         // direct scaling ("position" control)
         //const float scale = command;
         // relative scaling ("velocity" control)
-        const float scale = mScale.x * mScale.y * command;
+        float scale = mScale.x * mScale.y * command;
+
+        if (options.predictive) {
+            // learn from the frame these timings are for, if we still know how it was rendered
+            ScaleHistoryEntry const& entry = mScaleHistory[info.frameId % mScaleHistory.size()];
+            if (entry.frameId == info.frameId && info.frameId != mLastPredictedFrameId) {
+                mLastPredictedFrameId = info.frameId;
+                mFrameTimePredictor.update(entry.load, entry.area,
+                        duration<float, std::milli>{ info.frameTime }.count());
+            }
+
+            // Pick the area predicted to meet the target. We drop to it right away so that this
+            // frame doesn't miss its deadline, but only move up gradually, at the PID's rate.
+            if (mFrameTimePredictor.isValid()) {
+                float const current = mScale.x * mScale.y;
+                float const predicted = clamp(
+                        mFrameTimePredictor.solve(load, targetWithHeadroom),
+                        options.minScale.x * options.minScale.y,
+                        options.maxScale.x * options.maxScale.y);
+                scale = predicted < current ? predicted : current + Kp * (predicted - current);
+            }
+        }
 
         const float w = float(mViewport.width);
         const float h = float(mViewport.height);
@@ -292,6 +381,8 @@ float2 FView::updateScale(FEngine& engine,
         // (i.e. we clamped). This help not to have to wait too long for the Integral term
         // to kick in after a clamping event.
         mPidController.setIntegralInhibitionEnabled(mScale != s);
+
+        recordScale();
     } else {
         mScale = 1.0f;
     }
@@ -345,22 +436,53 @@ void FView::prepareShadowing(FEngine& engine, FScene::RenderableSoa& renderableD
 
     ShadowMapManager::Builder builder;
 
+    // When the quality governor reduces the shadow quality, the shadow maps are given a copy of
+    // the light's options, with a smaller shadow map and fewer cascades.
+    mReducedShadowOptions.clear();
+    auto const getShadowOptions = [this, &lcm](FLightManager::Instance const li) {
+        FLightManager::ShadowOptions const* options = &lcm.getShadowOptions(li);
+        if (UTILS_UNLIKELY(mShadowQualityReduced)) {
+            assert_invariant(mReducedShadowOptions.size() < mReducedShadowOptions.capacity());
+            FLightManager::ShadowOptions& reduced = mReducedShadowOptions.emplace_back(*options);
+            if (reduced.mapSize >= 512u) {
+                reduced.mapSize /= 2u;
+            }
+            if (reduced.shadowCascades > 2u) {
+                // keep the split that divides the original cascades in two halves
+                reduced.cascadeSplitPositions[0] =
+                        options->cascadeSplitPositions[options->shadowCascades / 2u - 1u];
+                reduced.shadowCascades = 2u;
+            }
+            options = &reduced;
+        }
+        return options;
+    };
+
     // dominant directional light is always as index 0
     FLightManager::Instance const directionalLight = lightData.elementAt<FScene::LIGHT_INSTANCE>(0);
     const bool hasDirectionalShadows = directionalLight && lcm.isShadowCaster(directionalLight);
     if (UTILS_UNLIKELY(hasDirectionalShadows)) {
-        const auto& shadowOptions = lcm.getShadowOptions(directionalLight);
-        assert_invariant(shadowOptions.shadowCascades >= 1 &&
-                shadowOptions.shadowCascades <= CONFIG_MAX_SHADOW_CASCADES);
-        builder.directionalShadowMap(0, &shadowOptions);
+        FLightManager::ShadowOptions const* const shadowOptions =
+                getShadowOptions(directionalLight);
+        assert_invariant(shadowOptions->shadowCascades >= 1 &&
+                shadowOptions->shadowCascades <= CONFIG_MAX_SHADOW_CASCADES);
+        builder.directionalShadowMap(0, shadowOptions);
     }
 
     // Find all shadow-casting spotlights.
     size_t shadowMapCount = CONFIG_MAX_SHADOW_CASCADES;
 
-    // We allow a max of CONFIG_MAX_SHADOWMAPS point/spotlight shadows. Any additional
-    // shadow-casting spotlights are ignored.
+    // We allow a max of CONFIG_MAX_SHADOWMAPS point/spotlight shadows. When there are more
+    // shadow-casting lights, the ones with the most impact on the image are chosen, based on the
+    // area of the screen they cover and their intensity. Any additional shadow-casting lights are
+    // ignored.
     // Note that pointlight shadows cost 6 shadowmaps, reducing the total count.
+    struct ShadowCaster {
+        float importance;
+        uint32_t index;
+    };
+    std::vector<ShadowCaster> casters;
+    mat4f const& viewMatrix = cameraInfo.view;
     for (size_t l = FScene::DIRECTIONAL_LIGHTS_COUNT; l < lightData.size(); l++) {
 
         // when we get here all the lights should be visible
@@ -372,29 +494,52 @@ void FView::prepareShadowing(FEngine& engine, FScene::RenderableSoa& renderableD
             continue; // invalid instance
         }
 
+        // Because we skip lights here, we need to make sure we mark them as non-casting.
+        // See `ShadowMapManager::updateSpotShadowMaps` for const_cast<> justification.
+        auto& shadowInfo = const_cast<FScene::ShadowInfo&>(
+            lightData.elementAt<FScene::SHADOW_INFO>(l));
+        shadowInfo.castsShadows = false;
+
         if (UTILS_LIKELY(!lcm.isShadowCaster(li))) {
-            // Because we early exit here, we need to make sure we mark the light as non-casting.
-            // See `ShadowMapManager::updateSpotShadowMaps` for const_cast<> justification.
-            auto& shadowInfo = const_cast<FScene::ShadowInfo&>(
-                lightData.elementAt<FScene::SHADOW_INFO>(l));
-            shadowInfo.castsShadows = false;
             continue; // doesn't cast shadows
         }
 
-        const bool spotLight = lcm.isSpotLight(li);
+        // The importance is spread over the shadowmaps that the light needs, so that a
+        // pointlight doesn't take the place of six spotlights unless it matters more than them.
+        float4 const sphere = lightData.elementAt<FScene::POSITION_RADIUS>(l);
+        float const distance = length(viewMatrix * sphere.xyz);
+        float importance = computeLightImportance(lcm, li, sphere.w, distance) /
+                (lcm.isSpotLight(li) ? 1.0f : 6.0f);
+        if (wasSelected(mShadowedLights, li)) {
+            importance *= LIGHT_SELECTION_HYSTERESIS;
+        }
+        casters.push_back({ importance, uint32_t(l) });
+    }
+
+    // Lights are sorted by distance, which we keep as a tie-breaker.
+    std::stable_sort(casters.begin(), casters.end(),
+            [](ShadowCaster const& lhs, ShadowCaster const& rhs) {
+                return lhs.importance > rhs.importance;
+            });
 
-        const size_t maxShadowMapCount = engine.getMaxShadowMapCount();
+    mShadowedLights.clear();
+    const size_t maxShadowMapCount = engine.getMaxShadowMapCount();
+    for (ShadowCaster const& caster : casters) {
+        FLightManager::Instance const li =
+                lightData.elementAt<FScene::LIGHT_INSTANCE>(caster.index);
+        const bool spotLight = lcm.isSpotLight(li);
         const size_t shadowMapCountNeeded = spotLight ? 1 : 6;
         if (shadowMapCount + shadowMapCountNeeded <= maxShadowMapCount) {
             shadowMapCount += shadowMapCountNeeded;
-            const auto& shadowOptions = lcm.getShadowOptions(li);
-            builder.shadowMap(l, spotLight, &shadowOptions);
+            builder.shadowMap(caster.index, spotLight, getShadowOptions(li));
+            mShadowedLights.push_back(li);
         }
 
         if (shadowMapCount >= maxShadowMapCount) {
             break; // we ran out of spotlight shadow casting
         }
     }
+    std::sort(mShadowedLights.begin(), mShadowedLights.end());
 
     if (builder.hasShadowMaps()) {
         ShadowMapManager::createIfNeeded(engine, mShadowMapManager);
@@ -457,7 +602,7 @@ void FView::prepareLighting(FEngine& engine, CameraInfo const& cameraInfo) noexc
     mColorPassDescriptorSet.prepareDirectionalLight(engine, exposure, sceneSpaceDirection, directionalLight);
 }
 
-CameraInfo FView::computeCameraInfo(FEngine& engine) const noexcept {
+CameraInfo FView::computeCameraInfo(FEngine& engine) noexcept {
     FScene const* const scene = getScene();
 
     /*
@@ -478,6 +623,20 @@ CameraInfo FView::computeCameraInfo(FEngine& engine) const noexcept {
         // zero, where fp precision is highest. This also ensures that when the camera is placed
         // very far from the origin, objects are still rendered and lit properly.
         translation = -camera->getPosition();
+        if (engine.features.engine.view.floating_origin) {
+            // Rebase the world origin only when the camera gets too far from it, so that the
+            // world transforms stay the same from frame to frame in the meantime. The offset of
+            // the camera from the origin is carried by the camera's model and view matrices.
+            double3 const position = camera->getPosition();
+            if (!mHasWorldOrigin || any(greaterThan(abs(position - mWorldOrigin),
+                    double3{ WORLD_ORIGIN_REBASE_DISTANCE }))) {
+                mWorldOrigin = position;
+                mHasWorldOrigin = true;
+            }
+            translation = -mWorldOrigin;
+        } else {
+            mHasWorldOrigin = false;
+        }
     }
 
     FIndirectLight const* const ibl = scene->getIndirectLight();
@@ -500,6 +659,13 @@ void FView::prepare(FEngine& engine, DriverApi& driver, RootArenaScope& rootAren
 
     JobSystem& js = engine.getJobSystem();
 
+    using clock = std::chrono::steady_clock;
+    auto elapsed = [](clock::time_point const since) -> int64_t {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - since).count();
+    };
+    clock::time_point const prepareStart = clock::now();
+    mPrepareTimings = {};
+
     /*
      * Prepare the scene -- this is where we gather all the objects added to the scene,
      * and in particular their world-space AABB.
@@ -523,15 +689,24 @@ void FView::prepare(FEngine& engine, DriverApi& driver, RootArenaScope& rootAren
 
     const Frustum cullingFrustum = getFrustum();
 
+    if (UTILS_UNLIKELY(mLateLatch)) {
+        mLateLatchFrame.generation++;
+        mLateLatchFrame.worldTransform = cameraInfo.worldTransform;
+        mLateLatchFrame.model = mCullingCamera->getModelMatrix();
+        mLateLatchFrame.eyeCount = mCullingCamera->getStereoscopicEyeCount();
+    }
+
     FScene* const scene = getScene();
 
     /*
      * Gather all information needed to render this scene. Apply the world origin to all
      * objects in the scene.
      */
-    scene->prepare(js, rootArenaScope,
+    clock::time_point const sceneStart = clock::now();
+    scene->prepare(js,
             cameraInfo.worldTransform,
             hasVSM());
+    mPrepareTimings.scene = elapsed(sceneStart);
 
     /*
      * Light culling: runs in parallel with Renderable culling (below)
@@ -549,14 +724,16 @@ void FView::prepare(FEngine& engine, DriverApi& driver, RootArenaScope& rootAren
         float* const distances = rootArenaScope.allocate<float>(
                 (positionalLightCount + 3u) & ~3u, CACHELINE_SIZE);
 
-        prepareVisibleLightsJob = js.runAndRetain(js.createJob(nullptr,
-                [&engine, distances, positionalLightCount, &viewMatrix = cameraInfo.view, &cullingFrustum,
+        JobSystem::Job* const job = js.createJob(nullptr,
+                [this, distances, positionalLightCount, &viewMatrix = cameraInfo.view, &cullingFrustum,
                  &lightData = scene->getLightData()]
                         (JobSystem&, JobSystem::Job*) {
-                    prepareVisibleLights(engine.getLightManager(),
+                    prepareVisibleLights(mEngine.getLightManager(),
                             { distances, distances + positionalLightCount },
-                            viewMatrix, cullingFrustum, lightData);
-                }));
+                            viewMatrix, cullingFrustum, lightData, mSelectedLights);
+                });
+        js.setLabel(job, "FView::prepareVisibleLights");
+        prepareVisibleLightsJob = js.runAndRetain(job);
     }
 
     // this is used later (in Renderer.cpp) to wait for froxelization to finishes
@@ -567,6 +744,7 @@ void FView::prepare(FEngine& engine, DriverApi& driver, RootArenaScope& rootAren
 
     { // all the operations in this scope must happen sequentially
 
+        clock::time_point const cullingStart = clock::now();
         Slice<Culler::result_type> cullingMask = renderableData.slice<FScene::VISIBLE_MASK>();
         std::uninitialized_fill(cullingMask.begin(), cullingMask.end(), 0);
 
@@ -575,7 +753,35 @@ void FView::prepare(FEngine& engine, DriverApi& driver, RootArenaScope& rootAren
          * (this will set the VISIBLE_RENDERABLE bit)
          */
 
-        prepareVisibleRenderables(js, cullingFrustum, renderableData);
+        prepareVisibleRenderables(js, cullingFrustum, *scene);
+
+        /*
+         * Occlusion culling: clear the VISIBLE_RENDERABLE bit of renderables hidden behind the
+         * occlusion buffer of a previous frame. Shadow casters are not affected.
+         */
+
+        mHasOcclusionCulling = engine.features.engine.culling.occlusion_culling &&
+                !mViewingCamera && !hasStereo() &&
+                driver.getFeatureLevel() > FeatureLevel::FEATURE_LEVEL_0;
+        if (mHasOcclusionCulling) {
+            if (UTILS_UNLIKELY(!mOcclusionCuller)) {
+                mOcclusionCuller = std::make_shared<OcclusionCuller>();
+            }
+            if (mOcclusionCuller->isValid()) {
+                SYSTRACE_NAME("occlusion culling");
+                // the occlusion buffer was rendered with a previous frame's world origin
+                mat4f const clipFromWorld{ mOcclusionCuller->getClipFromWorld() *
+                        inverse(cameraInfo.worldTransform) };
+                mOcclusionCuller->cull(cullingMask.begin(), clipFromWorld,
+                        renderableData.data<FScene::WORLD_AABB_CENTER>(),
+                        renderableData.data<FScene::WORLD_AABB_EXTENT>(),
+                        renderableData.size(), VISIBLE_RENDERABLE_BIT);
+            }
+        } else if (UTILS_UNLIKELY(mOcclusionCuller)) {
+            // don't keep a stale buffer around, it could be reused much later otherwise
+            mOcclusionCuller->invalidate();
+        }
+        mPrepareTimings.culling = elapsed(cullingStart);
 
 
         /*
@@ -615,12 +821,16 @@ void FView::prepare(FEngine& engine, DriverApi& driver, RootArenaScope& rootAren
                             (JobSystem&, JobSystem::Job*) {
                         froxelizer.froxelizeLights(engine, viewMatrix, lightData);
                     };
-            froxelizeLightsJob = js.runAndRetain(js.createJob(nullptr, std::move(froxelizerWork)));
+            JobSystem::Job* const job = js.createJob(nullptr, std::move(froxelizerWork));
+            js.setLabel(job, "Froxelizer::froxelizeLights");
+            froxelizeLightsJob = js.runAndRetain(job);
         }
 
         setFroxelizerSync(froxelizeLightsJob);
 
+        clock::time_point const shadowsStart = clock::now();
         prepareShadowing(engine, renderableData, lightData, cameraInfo);
+        mPrepareTimings.shadows = elapsed(shadowsStart);
 
         /*
          * Partition the SoA so that renderables are partitioned w.r.t their visibility into the
@@ -637,8 +847,9 @@ void FView::prepare(FEngine& engine, DriverApi& driver, RootArenaScope& rootAren
          * contain punctual light shadow casters as well. The fourth group contains *only* punctual
          * shadow casters.
          *
-         * This operation is somewhat heavy as it sorts the whole SoA. We use std::partition instead
-         * of sort(), which gives us O(4.N) instead of O(N.log(N)) application of swap().
+         * This operation is somewhat heavy as it sorts the whole SoA. We count the size of each
+         * group first, so that each renderable is then swapped at most once, directly into its
+         * group; this is O(N) application of swap(), instead of O(4.N) with std::partition.
          */
 
         // TODO: we need to compare performance of doing this partitioning vs not doing it.
@@ -652,36 +863,18 @@ void FView::prepare(FEngine& engine, DriverApi& driver, RootArenaScope& rootAren
         computeVisibilityMasks(getVisibleLayers(), layers, visibility, cullingMask.begin(),
                 renderableData.size());
 
-        auto const beginRenderables = renderableData.begin();
-
-        auto beginDirCasters = partition(beginRenderables, renderableData.end(),
-                VISIBLE_RENDERABLE | VISIBLE_DIR_SHADOW_RENDERABLE,
-                VISIBLE_RENDERABLE);
-
-        auto beginDirCastersOnly = partition(beginDirCasters, renderableData.end(),
-                VISIBLE_RENDERABLE | VISIBLE_DIR_SHADOW_RENDERABLE,
-                VISIBLE_RENDERABLE | VISIBLE_DIR_SHADOW_RENDERABLE);
+        auto const [beginDirCasters, beginDirCastersOnly, endDirCastersOnly,
+                endPotentialSpotCastersOnly] = partition(renderableData);
 
-        auto endDirCastersOnly = partition(beginDirCastersOnly, renderableData.end(),
-                VISIBLE_RENDERABLE | VISIBLE_DIR_SHADOW_RENDERABLE,
-                VISIBLE_DIR_SHADOW_RENDERABLE);
+        mVisibleRenderables = { 0, beginDirCastersOnly };
 
-        auto endPotentialSpotCastersOnly = partition(endDirCastersOnly, renderableData.end(),
-                VISIBLE_DYN_SHADOW_RENDERABLE,
-                VISIBLE_DYN_SHADOW_RENDERABLE);
+        mVisibleDirectionalShadowCasters = { beginDirCasters, endDirCastersOnly };
 
-        // convert to indices
-        mVisibleRenderables = { 0, uint32_t(beginDirCastersOnly - beginRenderables) };
-
-        mVisibleDirectionalShadowCasters = {
-                uint32_t(beginDirCasters - beginRenderables),
-                uint32_t(endDirCastersOnly - beginRenderables)};
-
-        merged = { 0, uint32_t(endPotentialSpotCastersOnly - beginRenderables) };
+        merged = { 0, endPotentialSpotCastersOnly };
         if (!needsShadowMap() || !mShadowMapManager->hasSpotShadows()) {
             // we know we don't have spot shadows, we can reduce the range to not even include
             // the potential spot casters
-            merged = { 0, uint32_t(endDirCastersOnly - beginRenderables) };
+            merged = { 0, endDirCastersOnly };
         }
 
         mSpotLightShadowCasters = merged;
@@ -704,11 +897,18 @@ void FView::prepare(FEngine& engine, DriverApi& driver, RootArenaScope& rootAren
                 mRenderableUbh = driver.createBufferObject(
                         mRenderableUBOSize + sizeof(PerRenderableUib),
                         BufferObjectBinding::UNIFORM, BufferUsage::DYNAMIC);
+                mCommittedRenderableData.clear();
             } else {
                 // TODO: should we shrink the underlying UBO at some point?
             }
             assert_invariant(mRenderableUbh);
-            scene->updateUBOs(merged, mRenderableUbh);
+            if (engine.features.engine.scene.incremental_ubo_updates) {
+                scene->updateUBOs(merged, mRenderableUbh, cullingFrustum,
+                        &mCommittedRenderableData);
+            } else {
+                mCommittedRenderableData.clear();
+                scene->updateUBOs(merged, mRenderableUbh, cullingFrustum);
+            }
 
             mCommonRenderableDescriptorSet.setBuffer(
                     +PerRenderableBindingPoints::OBJECT_UNIFORMS, mRenderableUbh,
@@ -794,6 +994,8 @@ void FView::prepare(FEngine& engine, DriverApi& driver, RootArenaScope& rootAren
     mColorPassDescriptorSet.prepareTemporalNoise(engine, mTemporalAntiAliasingOptions);
     mColorPassDescriptorSet.prepareBlending(needsAlphaChannel);
     mColorPassDescriptorSet.prepareMaterialGlobals(mMaterialGlobals);
+
+    mPrepareTimings.prepare = elapsed(prepareStart);
 }
 
 void FView::computeVisibilityMasks(
@@ -828,15 +1030,46 @@ void FView::computeVisibilityMasks(
 }
 
 UTILS_NOINLINE
-/* static */ FScene::RenderableSoa::iterator FView::partition(
-        FScene::RenderableSoa::iterator const begin,
-        FScene::RenderableSoa::iterator const end,
-        Culler::result_type mask, Culler::result_type value) noexcept {
-    return std::partition(begin, end, [mask, value](auto it) {
-        // Mask VISIBLE_MASK to ignore higher bits related to spot shadows. We only partition based
-        // on renderable and directional shadow visibility.
-        return (it.template get<FScene::VISIBLE_MASK>() & mask) == value;
-    });
+/* static */ std::array<uint32_t, 4> FView::partition(
+        FScene::RenderableSoa& renderableData) noexcept {
+    // Group of each combination of the VISIBLE_RENDERABLE, VISIBLE_DIR_SHADOW_RENDERABLE and
+    // VISIBLE_DYN_SHADOW_RENDERABLE bits. Higher bits, related to spot shadows, are ignored.
+    // The punctual shadow caster bit only matters when the other two are clear.
+    constexpr uint8_t groups[8] = { 4, 0, 2, 1, 3, 0, 2, 1 };
+
+    // the masks move with their renderable as we swap
+    Culler::result_type const* const masks = renderableData.data<FScene::VISIBLE_MASK>();
+    uint32_t const count = uint32_t(renderableData.size());
+
+    uint32_t sizes[5] = {};
+    for (uint32_t i = 0; i < count; i++) {
+        sizes[groups[masks[i] & 0x7u]]++;
+    }
+
+    // next[g] is the first slot of group g not yet known to hold one of its renderables
+    uint32_t next[5];
+    uint32_t end[5];
+    for (uint32_t g = 0, offset = 0; g < 5; g++) {
+        next[g] = offset;
+        offset += sizes[g];
+        end[g] = offset;
+    }
+
+    // Fill each group in turn; whatever doesn't belong is swapped straight into its own group.
+    // Only the first four groups need filling, the last one ends up with what's left.
+    for (uint32_t g = 0; g < 4; g++) {
+        while (next[g] < end[g]) {
+            uint32_t const i = next[g];
+            uint8_t const group = groups[masks[i] & 0x7u];
+            if (group == g) {
+                next[g]++;
+            } else {
+                renderableData.swap(i, next[group]++);
+            }
+        }
+    }
+
+    return { end[0], end[1], end[2], end[3] };
 }
 
 void FView::prepareUpscaler(float2 const scale,
@@ -922,7 +1155,35 @@ void FView::prepareShadowMapping(bool const highPrecision) const noexcept {
 }
 
 void FView::commitUniformsAndSamplers(DriverApi& driver) const noexcept {
-    mColorPassDescriptorSet.commit(driver);
+    if (UTILS_LIKELY(!mLateLatch || mViewingCamera)) {
+        mColorPassDescriptorSet.commit(driver);
+        return;
+    }
+    mColorPassDescriptorSet.commit(driver,
+            [lateLatch = mLateLatch, frame = mLateLatchFrame](PerViewUib& uniforms) {
+                // the uniforms can be uploaded several times per frame, they must all see the
+                // same camera
+                LateLatch& state = *lateLatch;
+                if (state.generation != frame.generation) {
+                    state.generation = frame.generation;
+                    mat4 model = frame.model;
+                    state.hasWorldFromView = state.callback(model);
+                    state.worldFromView = mat4f{ frame.worldTransform * model };
+                }
+                if (state.hasWorldFromView) {
+                    ColorPassDescriptorSet::lateLatchCamera(uniforms,
+                            state.worldFromView, frame.eyeCount);
+                }
+            });
+}
+
+void FView::setLateLatchCallback(LateLatchCallback&& callback) noexcept {
+    // frames in flight keep using the previous callback
+    mLateLatch.reset();
+    if (callback) {
+        mLateLatch = std::make_shared<LateLatch>();
+        mLateLatch->callback = std::move(callback);
+    }
 }
 
 void FView::unbindSamplers(DriverApi& driver) noexcept {
@@ -937,20 +1198,38 @@ void FView::commitFroxels(DriverApi& driverApi) const noexcept {
 
 UTILS_NOINLINE
 void FView::prepareVisibleRenderables(JobSystem& js,
-        Frustum const& frustum, FScene::RenderableSoa& renderableData) const noexcept {
+        Frustum const& frustum, FScene& scene) const noexcept {
     SYSTRACE_CALL();
     if (UTILS_LIKELY(isFrustumCullingEnabled())) {
-        cullRenderables(js, renderableData, frustum, VISIBLE_RENDERABLE_BIT);
+        cullRenderables(js, scene, frustum, VISIBLE_RENDERABLE_BIT);
     } else {
+        FScene::RenderableSoa& renderableData = scene.getRenderableData();
         std::uninitialized_fill(renderableData.begin<FScene::VISIBLE_MASK>(),
                   renderableData.end<FScene::VISIBLE_MASK>(), VISIBLE_RENDERABLE);
     }
 }
 
+float FView::computeNearestVisibleDistance(
+        float3 const position, float3 const forward) const noexcept {
+    FScene::RenderableSoa const& renderableData = mScene->getRenderableData();
+    float3 const* const worldAABBCenter = renderableData.data<FScene::WORLD_AABB_CENTER>();
+    float3 const* const worldAABBExtent = renderableData.data<FScene::WORLD_AABB_EXTENT>();
+    float3 const absForward = abs(forward);
+    float nearest = std::numeric_limits<float>::infinity();
+    for (uint32_t const i : mVisibleRenderables) {
+        float const d = dot(forward, worldAABBCenter[i] - position) -
+                dot(absForward, worldAABBExtent[i]);
+        nearest = std::min(nearest, d);
+    }
+    return nearest;
+}
+
 void FView::cullRenderables(JobSystem&,
-        FScene::RenderableSoa& renderableData, Frustum const& frustum, size_t bit) noexcept {
+        FScene& scene, Frustum const& frustum, size_t bit) noexcept {
     SYSTRACE_CALL();
 
+    FScene::RenderableSoa& renderableData = scene.getRenderableData();
+
     float3 const* worldAABBCenter = renderableData.data<FScene::WORLD_AABB_CENTER>();
     float3 const* worldAABBExtent = renderableData.data<FScene::WORLD_AABB_EXTENT>();
     FScene::VisibleMaskType* visibleArray = renderableData.data<FScene::VISIBLE_MASK>();
@@ -970,13 +1249,38 @@ void FView::cullRenderables(JobSystem&,
     // Moreover, even with a large number of primitives, the overhead of the JobSystem is too
     // large compared to the run time of Culler::intersects, e.g.: ~100us for 4000 primitives
     // on Pixel4.
-    functor(0, renderableData.size());
+
+    size_t const staticCount = scene.getStaticRenderableCount();
+    if (UTILS_LIKELY(!staticCount)) {
+        functor(0, renderableData.size());
+        return;
+    }
+
+    // Static renderables are stored last and are culled using the scene's hierarchy. Because
+    // Culler::intersects() rounds its count up, we must make sure it doesn't write into them.
+    uint32_t const dynamicCount = uint32_t(renderableData.size() - staticCount);
+    uint32_t const bulkCount = dynamicCount & ~uint32_t(Culler::MODULO - 1);
+    functor(0, bulkCount);
+
+    if (uint32_t const remainder = dynamicCount - bulkCount) {
+        float3 centers[Culler::MODULO]{};
+        float3 extents[Culler::MODULO]{};
+        Culler::result_type results[Culler::MODULO]{};
+        std::copy_n(worldAABBCenter + bulkCount, remainder, centers);
+        std::copy_n(worldAABBExtent + bulkCount, remainder, extents);
+        std::copy_n(visibleArray + bulkCount, remainder, results);
+        Culler::intersects(results, frustum, centers, extents, Culler::MODULO, bit);
+        std::copy_n(results, remainder, visibleArray + bulkCount);
+    }
+
+    scene.cullStaticRenderables(frustum, bit);
 }
 
 void FView::prepareVisibleLights(FLightManager const& lcm,
         Slice<float> scratch,
         mat4f const& viewMatrix, Frustum const& frustum,
-        FScene::LightSoa& lightData) noexcept {
+        FScene::LightSoa& lightData,
+        std::vector<FLightManager::Instance>& selectedLights) noexcept {
     SYSTRACE_CALL();
     assert_invariant(lightData.size() > FScene::DIRECTIONAL_LIGHTS_COUNT);
 
@@ -1033,12 +1337,13 @@ void FView::prepareVisibleLights(FLightManager const& lcm,
 
     /*
      * Some lights might be left out if there are more than the GPU buffer allows (i.e. 256).
+     * In that case we keep the lights with the most impact on the image, i.e. the ones that are
+     * the brightest and cover the most of the screen, rather than the closest ones; a distant
+     * search-light can matter more than a small light nearby. The lights kept in the previous
+     * frame are favored, so that lights don't pop in and out when their importances are close.
      *
-     * We always sort lights by distance to the camera so that:
+     * We then sort lights by distance to the camera so that:
      * - we can build light trees later
-     * - lights farther from the camera are dropped when in excess
-     *   Note this doesn't always work well, e.g. for search-lights, we might need to also
-     *   take the radius into account.
      * - This helps our limited numbers of spot-shadow as well.
      */
 
@@ -1054,13 +1359,45 @@ void FView::prepareVisibleLights(FLightManager const& lcm,
 
         // skip directional light
         Zip2Iterator<FScene::LightSoa::iterator, float*> b = { lightData.begin(), distances };
+
+        if (UTILS_UNLIKELY(positionalLightCount > CONFIG_MAX_LIGHT_COUNT)) {
+            // the scratch buffer temporarily holds the (negated) importance of each light
+            for (size_t i = FScene::DIRECTIONAL_LIGHTS_COUNT; i < visibleLightCount; i++) {
+                FLightManager::Instance const li = instanceArray[i];
+                float importance = computeLightImportance(lcm, li, spheres[i].w, distances[i]);
+                if (wasSelected(selectedLights, li)) {
+                    importance *= LIGHT_SELECTION_HYSTERESIS;
+                }
+                distances[i] = -importance;
+            }
+            std::nth_element(b + FScene::DIRECTIONAL_LIGHTS_COUNT,
+                    b + FScene::DIRECTIONAL_LIGHTS_COUNT + CONFIG_MAX_LIGHT_COUNT,
+                    b + visibleLightCount,
+                    [](auto const& lhs, auto const& rhs) { return lhs.second < rhs.second; });
+            visibleLightCount = CONFIG_MAX_LIGHT_COUNT + FScene::DIRECTIONAL_LIGHTS_COUNT;
+            computeLightCameraDistances(distances, viewMatrix, spheres, visibleLightCount);
+        }
+
         std::sort(b + FScene::DIRECTIONAL_LIGHTS_COUNT, b + visibleLightCount,
                 [](auto const& lhs, auto const& rhs) { return lhs.second < rhs.second; });
     }
 
+    // remember which lights were kept, for the hysteresis
+    selectedLights.assign(instanceArray + FScene::DIRECTIONAL_LIGHTS_COUNT,
+            instanceArray + visibleLightCount);
+    std::sort(selectedLights.begin(), selectedLights.end());
+
     // drop excess lights
-    lightData.resize(std::min(visibleLightCount,
-            CONFIG_MAX_LIGHT_COUNT + FScene::DIRECTIONAL_LIGHTS_COUNT));
+    lightData.resize(visibleLightCount);
+}
+
+// Estimates how much a positional light contributes to the image: its intensity, scaled by its
+// projected radius, i.e. by how much of the screen its sphere of influence covers.
+float FView::computeLightImportance(FLightManager const& lcm, FLightManager::Instance const li,
+        float const radius, float const distance) noexcept {
+    // the projected radius is 1 when the camera is within the light's range
+    float const projectedRadius = radius / std::max(distance, radius);
+    return lcm.getIntensity(li) * max(lcm.getColor(li)) * projectedRadius;
 }
 
 // These methods need to exist so clang honors the __restrict__ keyword, which in turn
@@ -1082,13 +1419,48 @@ inline void FView::computeLightCameraDistances(
     }
 }
 
+static uint8_t selectLevelOfDetail(
+        FRenderableManager::LevelOfDetail const& lod, float const screenSize) noexcept {
+    // Thresholds at or below the current level are pushed up, and the ones above it are pushed
+    // down, which makes it harder to leave the current level in either direction.
+    float const keep = 1.0f + lod.hysteresis;
+    float const leave = 1.0f - lod.hysteresis;
+    uint8_t level = 0;
+    for (uint8_t i = 1; i < lod.levelCount; i++) {
+        float const threshold = lod.screenSize[i] * (i <= lod.currentLevel ? keep : leave);
+        if (screenSize < threshold) {
+            level = i;
+        }
+    }
+    return level;
+}
+
 void FView::updatePrimitivesLod(FScene::RenderableSoa& renderableData,
-        FEngine const& engine, CameraInfo const&, Range visible) noexcept {
-    FRenderableManager const& rcm = engine.getRenderableManager();
+        FEngine& engine, CameraInfo const& camera, Range visible,
+        uint8_t const lodBias) noexcept {
+    FRenderableManager& rcm = engine.getRenderableManager();
+
+    // The screen size of a renderable is the size of its bounding sphere as a fraction of the
+    // viewport height: r * p11 / d with a perspective projection, r * p11 with an orthographic one.
+    float const p11 = camera.projection[1][1];
+    bool const isPerspective = camera.projection[2][3] != 0.0f;
+    float3 const eye = camera.getPosition();
+
     for (uint32_t const index : visible) {
-        uint8_t const level = 0; // TODO: pick the proper level of detail
-        auto ri = renderableData.elementAt<FScene::RENDERABLE_INSTANCE>(index);
-        renderableData.elementAt<FScene::PRIMITIVES>(index) = rcm.getRenderPrimitives(ri, level);
+        auto const ri = renderableData.elementAt<FScene::RENDERABLE_INSTANCE>(index);
+        auto const& lod = rcm.getLevelOfDetail(ri);
+        uint8_t level = 0;
+        if (UTILS_UNLIKELY(lod.levelCount > 1)) {
+            float3 const center = renderableData.elementAt<FScene::WORLD_AABB_CENTER>(index);
+            float3 const extent = renderableData.elementAt<FScene::WORLD_AABB_EXTENT>(index);
+            float const distance = isPerspective ? std::max(length(center - eye), camera.zn) : 1.0f;
+            level = selectLevelOfDetail(lod, length(extent) * p11 / distance);
+            // only the unbiased level feeds the hysteresis
+            rcm.setCurrentLevelOfDetail(ri, level);
+            level = uint8_t(std::min(level + lodBias, lod.levelCount - 1));
+        }
+        renderableData.elementAt<FScene::PRIMITIVES>(index) =
+                rcm.getLevelOfDetailPrimitives(ri, level);
     }
 }
 
@@ -1126,51 +1498,154 @@ void FView::clearFrameHistory(FEngine& engine) noexcept {
 void FView::executePickingQueries(DriverApi& driver,
         RenderTargetHandle handle, float2 const scale) noexcept {
 
+    // Queries close to each other are read back together: each readback covers the
+    // bounding rectangle of its queries, which is at most PICKING_BATCH_SIZE pixels wide.
+    constexpr uint32_t PICKING_BATCH_SIZE = 32;
+
+    struct Readback {
+        FPickingQuery* queries;
+        float2 scale;
+        uint32_t x;
+        uint32_t y;
+        uint32_t width;
+        bool isFeatureLevel0;
+        std::unique_ptr<uint32_t[]> pixels;
+    };
+
+    // adjust for dynamic resolution and structure buffer scale
+    auto const position = [scale](FPickingQuery const* const pQuery) -> uint2 {
+        return { uint32_t(float(pQuery->x) * scale.x), uint32_t(float(pQuery->y) * scale.y) };
+    };
+
+    // FL0 reads RGBA8, otherwise the picking buffer has the entity in its red channel and the
+    // depth in its green channel
+    bool const isFeatureLevel0 = driver.getFeatureLevel() == FeatureLevel::FEATURE_LEVEL_0;
+    uint32_t const wordsPerPixel = isFeatureLevel0 ? 1u : 2u;
+
     while (mActivePickingQueriesList) {
-        FPickingQuery* const pQuery = mActivePickingQueriesList;
-        mActivePickingQueriesList = pQuery->next;
+        FPickingQuery* queries = mActivePickingQueriesList;
+        mActivePickingQueriesList = queries->next;
+        queries->next = nullptr;
+
+        // move the queries that fit in this batch out of the active list
+        uint2 pmin = position(queries);
+        uint2 pmax = pmin;
+        for (FPickingQuery** link = &mActivePickingQueriesList; *link;) {
+            FPickingQuery* const pQuery = *link;
+            uint2 const p = position(pQuery);
+            uint2 const qmin = min(pmin, p);
+            uint2 const qmax = max(pmax, p);
+            if (pQuery->handler == queries->handler &&
+                    all(lessThan(qmax - qmin, uint2(PICKING_BATCH_SIZE)))) {
+                *link = pQuery->next;
+                pQuery->next = queries;
+                queries = pQuery;
+                pmin = qmin;
+                pmax = qmax;
+            } else {
+                link = &pQuery->next;
+            }
+        }
 
-        // adjust for dynamic resolution and structure buffer scale
-        const uint32_t x = uint32_t(float(pQuery->x) * scale.x);
-        const uint32_t y = uint32_t(float(pQuery->y) * scale.y);
-
-        if (UTILS_UNLIKELY(driver.getFeatureLevel() == FeatureLevel::FEATURE_LEVEL_0)) {
-            driver.readPixels(handle, x, y, 1, 1, {
-                    &pQuery->result.reserved1, 4u, // 4
-                    PixelDataFormat::RGBA, PixelDataType::UBYTE,
-                    pQuery->handler, [](void*, size_t, void* user) {
-                        FPickingQuery* pQuery = static_cast<FPickingQuery*>(user);
-                        uint8_t const* const p =
-                                reinterpret_cast<uint8_t const *>(&pQuery->result.reserved1);
-                        uint32_t const r = p[0];
-                        uint32_t const g = p[1];
-                        uint32_t const b = p[2];
-                        uint32_t const a = p[3];
-                        int32_t const identity = int32_t(a << 16u | (b << 8u) | g);
-                        float const depth = float(r) / 255.0f;
-                        pQuery->result.renderable = Entity::import(identity);
-                        pQuery->result.depth = depth;
-                        pQuery->result.fragCoords = {
-                                pQuery->x, pQuery->y, float(1.0 - depth) };
-                        pQuery->callback(pQuery->result, pQuery);
-                        FPickingQuery::put(pQuery);
-                    }, pQuery
-            });
-        } else {
-            driver.readPixels(handle, x, y, 1, 1, {
-                    &pQuery->result.renderable, 4u * 4u, // 4*float
-                    PixelDataFormat::RG, PixelDataType::FLOAT,
-                    pQuery->handler, [](void*, size_t, void* user) {
-                        FPickingQuery* const pQuery = static_cast<FPickingQuery*>(user);
-                        // pQuery->result.renderable already contains the right value!
+        uint32_t const width = pmax.x - pmin.x + 1;
+        uint32_t const height = pmax.y - pmin.y + 1;
+        size_t const wordCount = size_t(width) * height * wordsPerPixel;
+
+        Readback* const readback = new(std::nothrow) Readback{
+                queries, scale, pmin.x, pmin.y, width, isFeatureLevel0,
+                std::unique_ptr<uint32_t[]>(new(std::nothrow) uint32_t[wordCount]) };
+        if (UTILS_UNLIKELY(!readback || !readback->pixels)) {
+            delete readback;
+            // we can't read these back, complete them with an empty result
+            while (queries) {
+                FPickingQuery* const pQuery = queries;
+                queries = pQuery->next;
+                pQuery->callback(pQuery->result, pQuery);
+                FPickingQuery::put(pQuery);
+            }
+            continue;
+        }
+
+        driver.readPixels(handle, pmin.x, pmin.y, width, height, {
+                readback->pixels.get(), wordCount * sizeof(uint32_t),
+                isFeatureLevel0 ? PixelDataFormat::RGBA : PixelDataFormat::RG,
+                isFeatureLevel0 ? PixelDataType::UBYTE : PixelDataType::FLOAT,
+                queries->handler, [](void*, size_t, void* user) {
+                    Readback* const readback = static_cast<Readback*>(user);
+                    while (FPickingQuery* const pQuery = readback->queries) {
+                        readback->queries = pQuery->next;
+                        uint2 const p = uint2{ float2{ pQuery->x, pQuery->y } * readback->scale };
+                        size_t const i = size_t(p.y - readback->y) * readback->width +
+                                (p.x - readback->x);
+                        if (UTILS_UNLIKELY(readback->isFeatureLevel0)) {
+                            uint8_t const* const rgba =
+                                    reinterpret_cast<uint8_t const*>(&readback->pixels[i]);
+                            uint32_t const r = rgba[0];
+                            uint32_t const g = rgba[1];
+                            uint32_t const b = rgba[2];
+                            uint32_t const a = rgba[3];
+                            int32_t const identity = int32_t(a << 16u | (b << 8u) | g);
+                            pQuery->result.renderable = Entity::import(identity);
+                            pQuery->result.depth = float(r) / 255.0f;
+                        } else {
+                            // the entity's bits are in the red channel, the depth in the green
+                            memcpy(&pQuery->result.renderable, &readback->pixels[i * 2],
+                                    sizeof(uint32_t));
+                            memcpy(&pQuery->result.depth, &readback->pixels[i * 2 + 1],
+                                    sizeof(float));
+                        }
                         pQuery->result.fragCoords = {
                                 pQuery->x, pQuery->y, float(1.0 - pQuery->result.depth) };
                         pQuery->callback(pQuery->result, pQuery);
                         FPickingQuery::put(pQuery);
-                    }, pQuery
-            });
-        }
+                    }
+                    delete readback;
+                }, readback
+        });
+    }
+}
+
+void FView::readOcclusionBuffer(DriverApi& driver, RenderTargetHandle handle,
+        uint32_t const width, uint32_t const height, mat4 const& clipFromWorld) noexcept {
+    assert_invariant(mOcclusionCuller);
+
+    // only one readback in flight at a time, this bounds both the latency and the memory used
+    if (mOcclusionCuller->isReadbackPending()) {
+        return;
     }
+
+    struct Readback {
+        std::weak_ptr<OcclusionCuller> culler;
+        mat4 clipFromWorld;
+        uint32_t width;
+        uint32_t height;
+        std::unique_ptr<float2[]> pixels;
+    };
+
+    Readback* const readback = new(std::nothrow) Readback{
+            mOcclusionCuller, clipFromWorld, width, height,
+            std::unique_ptr<float2[]>(new(std::nothrow) float2[size_t(width) * height]) };
+    if (UTILS_UNLIKELY(!readback || !readback->pixels)) {
+        delete readback;
+        return;
+    }
+
+    mOcclusionCuller->setReadbackPending(true);
+
+    // the picking buffer has the entity in its red channel, and the depth in its green channel
+    driver.readPixels(handle, 0, 0, width, height, {
+            readback->pixels.get(), size_t(width) * height * sizeof(float2),
+            PixelDataFormat::RG, PixelDataType::FLOAT,
+            nullptr, [](void*, size_t, void* user) {
+                Readback* const readback = static_cast<Readback*>(user);
+                if (auto const culler = readback->culler.lock()) {
+                    culler->update(&readback->pixels[0].y, 2,
+                            readback->width, readback->height, readback->clipFromWorld);
+                    culler->setReadbackPending(false);
+                }
+                delete readback;
+            }, readback
+    });
 }
 
 void FView::clearPickingQueries() noexcept {
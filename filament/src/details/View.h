@@ -24,7 +24,11 @@
 #include "FrameHistory.h"
 #include "FrameInfo.h"
 #include "Froxelizer.h"
+#include "OcclusionCuller.h"
+#include "DepthPrepassController.h"
+#include "FrameTimePredictor.h"
 #include "PIDController.h"
+#include "RenderPass.h"
 #include "ShadowMapManager.h"
 
 #include "ds/ColorPassDescriptorSet.h"
@@ -74,6 +78,7 @@ namespace filament::fgviewer {
 #include <array>
 #include <memory>
 #include <new>
+#include <vector>
 
 #include <stddef.h>
 #include <stdint.h>
@@ -109,7 +114,15 @@ public:
 
     void terminate(FEngine& engine);
 
-    CameraInfo computeCameraInfo(FEngine& engine) const noexcept;
+    FEngine& getEngine() const noexcept { return mEngine; }
+
+    // Note: this may rebase the view's world origin (see WORLD_ORIGIN_REBASE_DISTANCE).
+    CameraInfo computeCameraInfo(FEngine& engine) noexcept;
+
+    // With `engine.view.floating_origin`, the world origin follows the camera only once it
+    // has moved this far (in world units, along any axis) from the current origin. In between,
+    // the per-renderable transforms don't change when the camera moves.
+    static constexpr double WORLD_ORIGIN_REBASE_DISTANCE = 1024.0;
 
     // note: viewport/cameraInfo are passed by value to make it clear that prepare cannot
     // keep references on them that would outlive the scope of prepare() (e.g. with JobSystem).
@@ -187,6 +200,12 @@ public:
     utils::JobSystem::Job* getFroxelizerSync() const noexcept { return mFroxelizerSync; }
     void setFroxelizerSync(utils::JobSystem::Job* sync) noexcept { mFroxelizerSync = sync; }
 
+    // main thread time spent in the last prepare(), only the prepare, scene, culling and
+    // shadows fields are set.
+    Renderer::FrameInfo::CpuTimings const& getPrepareTimings() const noexcept {
+        return mPrepareTimings;
+    }
+
     // ultimately decides to use the DIR variant
     bool hasDirectionalLighting() const noexcept { return mHasDirectionalLighting; }
 
@@ -200,10 +219,20 @@ public:
     bool needsPointShadowMaps() const noexcept { return mHasShadowing && mHasDynamicLighting; }
     bool needsShadowMap() const noexcept { return mNeedsShadowMap; }
     bool hasFog() const noexcept { return mFogOptions.enabled && mFogOptions.density > 0.0f; }
+    bool hasFullScreenFog() const noexcept {
+        return hasFog() && mFogOptions.mode == FogOptions::Mode::FULL_SCREEN;
+    }
     bool hasVSM() const noexcept { return mShadowType == ShadowType::VSM; }
     bool hasDPCF() const noexcept { return mShadowType == ShadowType::DPCF; }
     bool hasPCSS() const noexcept { return mShadowType == ShadowType::PCSS; }
     bool hasPicking() const noexcept { return mActivePickingQueriesList != nullptr; }
+    bool hasOcclusionCulling() const noexcept { return mHasOcclusionCulling; }
+
+    // commands of the color pass, persisted across frames
+    RenderPass::CommandCache& getColorPassCommandCache() noexcept {
+        return mColorPassCommandCache;
+    }
+
     bool hasStereo() const noexcept {
         return mIsStereoSupported && mStereoscopicOptions.enabled;
     }
@@ -212,18 +241,27 @@ public:
             CameraInfo const& cameraInfo, math::float4 const& userTime,
             RenderPassBuilder const& passBuilder) noexcept;
 
+    // Selects the level of detail of each visible renderable from its screen size as seen by
+    // camera. lodBias selects coarser levels, e.g. for shadow passes.
     static void updatePrimitivesLod(FScene::RenderableSoa& renderableData,
-            FEngine const& engine, CameraInfo const& camera,
-            Range visible) noexcept;
+            FEngine& engine, CameraInfo const& camera,
+            Range visible, uint8_t lodBias = 0) noexcept;
 
     void setShadowingEnabled(bool const enabled) noexcept { mShadowingEnabled = enabled; }
 
     bool isShadowingEnabled() const noexcept { return mShadowingEnabled; }
 
+    // Set by the quality governor: shadow maps are half their size, with at most 2 cascades.
+    void setShadowQualityReduced(bool const reduced) noexcept { mShadowQualityReduced = reduced; }
+
     void setScreenSpaceRefractionEnabled(bool const enabled) noexcept { mScreenSpaceRefractionEnabled = enabled; }
 
     bool isScreenSpaceRefractionEnabled() const noexcept { return mScreenSpaceRefractionEnabled; }
 
+    void setOrderIndependentBlendingEnabled(bool const enabled) noexcept { mOrderIndependentBlendingEnabled = enabled; }
+
+    bool isOrderIndependentBlendingEnabled() const noexcept { return mOrderIndependentBlendingEnabled; }
+
     bool isScreenSpaceReflectionEnabled() const noexcept { return mScreenSpaceReflectionsOptions.enabled; }
 
     void setStencilBufferEnabled(bool const enabled) noexcept { mStencilBufferEnabled = enabled; }
@@ -313,10 +351,24 @@ public:
         return mHasPostProcessPass;
     }
 
-    math::float2 updateScale(FEngine& engine,
+    void setDepthPrepass(DepthPrepass const prepass) noexcept {
+        if (mDepthPrepass != prepass) {
+            mDepthPrepass = prepass;
+            mDepthPrepassController.reset();
+        }
+    }
+
+    DepthPrepass getDepthPrepass() const noexcept {
+        return mDepthPrepass;
+    }
+
+    // returns whether the color pass of frame `frameId` starts with a depth prepass
+    bool updateDepthPrepass(uint32_t frameId, details::FrameInfo const& info) noexcept;
+
+    math::float2 updateScale(FEngine& engine, uint32_t frameId,
             details::FrameInfo const& info,
             Renderer::FrameRateOptions const& frameRateOptions,
-            Renderer::DisplayInfo const& displayInfo) noexcept;
+            Renderer::DisplayInfo const& displayInfo, float maxScale) noexcept;
 
     void setDynamicResolutionOptions(DynamicResolutionOptions const& options) noexcept;
 
@@ -408,6 +460,11 @@ public:
         return mVisibleRenderables;
     }
 
+    // Returns the distance along `forward`, from `position`, to the nearest bounding box of the
+    // visible renderables, or infinity if there are none.
+    float computeNearestVisibleDistance(
+            math::float3 position, math::float3 forward) const noexcept;
+
     Range const& getVisibleDirectionalShadowCasters() const noexcept {
         return mVisibleDirectionalShadowCasters;
     }
@@ -424,6 +481,8 @@ public:
         return mCullingCamera != nullptr;
     }
 
+    void setLateLatchCallback(LateLatchCallback&& callback) noexcept;
+
     backend::Handle<backend::HwRenderTarget> getRenderTargetHandle() const noexcept {
         backend::Handle<backend::HwRenderTarget> const kEmptyHandle;
         return mRenderTarget == nullptr ? kEmptyHandle : mRenderTarget->getHwHandle();
@@ -437,7 +496,7 @@ public:
         }
     }
 
-    static void cullRenderables(utils::JobSystem& js, FScene::RenderableSoa& renderableData,
+    static void cullRenderables(utils::JobSystem& js, FScene& scene,
             Frustum const& frustum, size_t bit) noexcept;
 
     ColorPassDescriptorSet& getColorPassDescriptorSet() noexcept { return mColorPassDescriptorSet; }
@@ -465,6 +524,11 @@ public:
 
     void clearPickingQueries() noexcept;
 
+    // reads back the occlusion buffer rendered with `clipFromWorld`, which is used to cull
+    // renderables in a later frame
+    void readOcclusionBuffer(backend::DriverApi& driver, backend::RenderTargetHandle handle,
+            uint32_t width, uint32_t height, math::mat4 const& clipFromWorld) noexcept;
+
     void setMaterialGlobal(uint32_t index, math::float4 const& value);
 
     math::float4 getMaterialGlobal(uint32_t index) const;
@@ -509,12 +573,16 @@ private:
     };
 
     void prepareVisibleRenderables(utils::JobSystem& js,
-            Frustum const& frustum, FScene::RenderableSoa& renderableData) const noexcept;
+            Frustum const& frustum, FScene& scene) const noexcept;
 
     static void prepareVisibleLights(FLightManager const& lcm,
             utils::Slice<float> scratch,
             math::mat4f const& viewMatrix, Frustum const& frustum,
-            FScene::LightSoa& lightData) noexcept;
+            FScene::LightSoa& lightData,
+            std::vector<FLightManager::Instance>& selectedLights) noexcept;
+
+    static float computeLightImportance(FLightManager const& lcm, FLightManager::Instance li,
+            float radius, float distance) noexcept;
 
     static inline void computeLightCameraDistances(float* distances,
             math::mat4f const& viewMatrix, const math::float4* spheres, size_t count) noexcept;
@@ -525,16 +593,20 @@ private:
             Culler::result_type* visibleMask,
             size_t count);
 
+    // Groups the renderables by visibility class, in the order documented in prepare(), and
+    // returns the end of each of the first four groups. Each misplaced renderable is swapped
+    // only once, directly into its group.
     // we don't inline this one, because the function is quite large and there is not much to
     // gain from inlining.
-    static FScene::RenderableSoa::iterator partition(
-            FScene::RenderableSoa::iterator begin,
-            FScene::RenderableSoa::iterator end,
-            Culler::result_type mask, Culler::result_type value) noexcept;
+    static std::array<uint32_t, 4> partition(FScene::RenderableSoa& renderableData) noexcept;
+
+    FEngine& mEngine;
 
     // these are accessed in the render loop, keep together
     backend::Handle<backend::HwBufferObject> mLightUbh;
     backend::Handle<backend::HwBufferObject> mRenderableUbh;
+    // per-renderable data last uploaded to mRenderableUbh, for incremental updates
+    std::vector<PerRenderableData> mCommittedRenderableData;
     DescriptorSet mCommonRenderableDescriptorSet;
 
     FScene* mScene = nullptr;
@@ -542,10 +614,41 @@ private:
     FCamera* /* UTILS_NONNULL */ mCullingCamera = nullptr; // FIXME: should always be non-null
     // The optional (debug) camera, used only for viewing
     FCamera* mViewingCamera = nullptr;
+    // The current world origin, when `engine.view.floating_origin` is enabled
+    math::double3 mWorldOrigin{};
+    bool mHasWorldOrigin = false;
+
+    // Late latching of the camera. The callback is called at most once per preparation of the
+    // view (identified by its generation), on the backend thread which owns the other fields.
+    struct LateLatch {
+        LateLatchCallback callback;
+        uint32_t generation = 0;
+        bool hasWorldFromView = false;
+        math::mat4f worldFromView;
+    };
+    struct LateLatchFrame {
+        uint32_t generation = 0;
+        math::mat4 worldTransform;      // world transform of the prepared camera
+        math::mat4 model;               // model matrix of the prepared camera
+        size_t eyeCount = 1;
+    };
+    std::shared_ptr<LateLatch> mLateLatch;
+    LateLatchFrame mLateLatchFrame;
 
     mutable Froxelizer mFroxelizer;
     utils::JobSystem::Job* mFroxelizerSync = nullptr;
 
+    // Positional lights, and shadow-casting lights, that were kept in the previous frame when
+    // there were more than the budget allows. Sorted, used for hysteresis.
+    std::vector<FLightManager::Instance> mSelectedLights;
+    std::vector<FLightManager::Instance> mShadowedLights;
+
+    // Reduced copies of the shadow options of the shadow-casting lights, when the shadow quality
+    // is reduced. Never reallocated, the shadow maps point into it.
+    std::vector<FLightManager::ShadowOptions> mReducedShadowOptions;
+
+    Renderer::FrameInfo::CpuTimings mPrepareTimings{};
+
     Viewport mViewport;
     bool mCulling = true;
     bool mFrontFaceWindingInverted = false;
@@ -556,8 +659,12 @@ private:
     uint8_t mVisibleLayers = 0x1;
     AntiAliasing mAntiAliasing = AntiAliasing::FXAA;
     Dithering mDithering = Dithering::TEMPORAL;
+    DepthPrepass mDepthPrepass = DepthPrepass::DISABLED;
+    DepthPrepassController mDepthPrepassController;
     bool mShadowingEnabled = true;
+    bool mShadowQualityReduced = false;
     bool mScreenSpaceRefractionEnabled = true;
+    bool mOrderIndependentBlendingEnabled = false;
     bool mHasPostProcessPass = true;
     bool mStencilBufferEnabled = false;
     AmbientOcclusionOptions mAmbientOcclusionOptions{};
@@ -582,6 +689,18 @@ private:
     PIDController mPidController;
     DynamicResolutionOptions mDynamicResolution;
     math::float2 mScale = 1.0f;
+
+    // used by the predictive dynamic resolution, remembers how the last few frames were rendered
+    // so that their timings can be matched with their scale once they're available.
+    struct ScaleHistoryEntry {
+        uint32_t frameId = 0;
+        float area = 0.0f;
+        float load = 0.0f;
+    };
+    FrameTimePredictor mFrameTimePredictor;
+    std::array<ScaleHistoryEntry, 8> mScaleHistory{};
+    uint32_t mLastPredictedFrameId = 0;
+    float mReferenceLoad = 0.0f;
     bool mIsDynamicResolutionSupported = false;
 
     RenderQuality mRenderQuality;
@@ -593,6 +712,11 @@ private:
 
     FPickingQuery* mActivePickingQueriesList = nullptr;
 
+    // shared with in-flight readbacks, which can complete after the view is destroyed
+    std::shared_ptr<OcclusionCuller> mOcclusionCuller;
+    bool mHasOcclusionCulling = false;
+    RenderPass::CommandCache mColorPassCommandCache;
+
     utils::CString mName;
 
     // the following values are set by prepare()
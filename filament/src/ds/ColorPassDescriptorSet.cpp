@@ -55,6 +55,7 @@
 #include <array>
 #include <cmath>
 #include <random>
+#include <utility>
 
 #include <stddef.h>
 #include <stdint.h>
@@ -184,6 +185,21 @@ void ColorPassDescriptorSet::prepareCamera(FEngine& engine, const CameraInfo& ca
     s.clipControl = engine.getDriverApi().getClipSpaceParams();
 }
 
+void ColorPassDescriptorSet::lateLatchCamera(PerViewUib& s, mat4f const& worldFromView,
+        size_t const eyeCount) noexcept {
+    mat4f const viewFromWorld{ inverse(mat4{ worldFromView }) };
+    // clipFromWorld is clipFromEye * eyeFromHead * headFromWorld, where only headFromWorld
+    // changes, so we replace it by undoing the old one.
+    for (size_t i = 0; i < eyeCount; i++) {
+        s.clipFromWorldMatrix[i] = highPrecisionMultiply(
+                highPrecisionMultiply(s.clipFromWorldMatrix[i], s.worldFromViewMatrix),
+                viewFromWorld);
+    }
+    s.viewFromWorldMatrix = viewFromWorld;
+    s.worldFromViewMatrix = worldFromView;
+    s.worldFromClipMatrix = highPrecisionMultiply(worldFromView, s.viewFromClipMatrix);
+}
+
 void ColorPassDescriptorSet::prepareLodBias(float const bias, float2 const derivativesScale) noexcept {
     auto& s = mUniforms.edit();
     s.lodBias = bias;
@@ -284,12 +300,13 @@ void ColorPassDescriptorSet::prepareFog(FEngine& engine, const CameraInfo& camer
         }
     }
 
-    setSampler(+PerViewBindingPoints::FOG,
-            fogColorTextureHandle ?
-                    fogColorTextureHandle : engine.getDummyCubemap()->getHwHandleForSampling(), {
-                    .filterMag = SamplerMagFilter::LINEAR,
-                    .filterMin = SamplerMinFilter::LINEAR_MIPMAP_LINEAR
-            });
+    mFogTexture = fogColorTextureHandle ?
+            fogColorTextureHandle : engine.getDummyCubemap()->getHwHandleForSampling();
+
+    setSampler(+PerViewBindingPoints::FOG, mFogTexture, {
+            .filterMag = SamplerMagFilter::LINEAR,
+            .filterMin = SamplerMinFilter::LINEAR_MIPMAP_LINEAR
+    });
 
     s.fogStart             = options.distance;
     s.fogMaxOpacity        = options.maximumOpacity;
@@ -532,10 +549,18 @@ void ColorPassDescriptorSet::prepareShadowPCFDebug(Handle<HwTexture> texture,
     prepareShadowSampling(s, shadowMappingUniforms);
 }
 
-void ColorPassDescriptorSet::commit(DriverApi& driver) noexcept {
+void ColorPassDescriptorSet::commit(DriverApi& driver, UniformsPatch const& patch) noexcept {
     if (mUniforms.isDirty()) {
-        driver.updateBufferObject(mUniforms.getUboHandle(),
-                mUniforms.toBufferDescriptor(driver), 0);
+        BufferDescriptor data{ mUniforms.toBufferDescriptor(driver) };
+        if (patch) {
+            // The data lives in the command stream, and is only read when the update below
+            // executes, so a command queued before it can still modify it.
+            auto* const uniforms = static_cast<PerViewUib*>(data.buffer);
+            driver.queueCommand([patch, uniforms]() {
+                patch(*uniforms);
+            });
+        }
+        driver.updateBufferObject(mUniforms.getUboHandle(), std::move(data), 0);
     }
     for (size_t i = 0; i < DESCRIPTOR_LAYOUT_COUNT; i++) {
         mDescriptorSet[i].commit(mDescriptorSetLayout[i], driver);
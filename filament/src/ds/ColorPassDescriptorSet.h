@@ -36,6 +36,7 @@
 #include <math/mat4.h>
 
 #include <array>
+#include <functional>
 
 #include <stddef.h>
 #include <stdint.h>
@@ -106,6 +107,9 @@ public:
     void prepareFog(FEngine& engine, const CameraInfo& cameraInfo,
             math::mat4 const& fogTransform, FogOptions const& options,
             FIndirectLight const* ibl) noexcept;
+
+    // the fog color cubemap set by prepareFog(), for the full-screen fog pass
+    TextureHandle getFogTexture() const noexcept { return mFogTexture; }
     void prepareStructure(TextureHandle structure) noexcept;
     void prepareSSAO(TextureHandle ssao, AmbientOcclusionOptions const& options) noexcept;
     void prepareBlending(bool needsAlphaChannel) noexcept;
@@ -150,8 +154,15 @@ public:
     void prepareShadowPCFDebug(TextureHandle texture,
             ShadowMappingUniforms const& shadowMappingUniforms) noexcept;
 
-    // update local data into GPU UBO
-    void commit(backend::DriverApi& driver) noexcept;
+    // called on the backend thread with the uniforms about to be uploaded by commit()
+    using UniformsPatch = std::function<void(PerViewUib& uniforms)>;
+
+    // update local data into GPU UBO. If set, `patch` can modify the data before it's uploaded.
+    void commit(backend::DriverApi& driver, UniformsPatch const& patch = {}) noexcept;
+
+    // replaces the camera model matrix of `uniforms`, keeping its projection
+    static void lateLatchCamera(PerViewUib& uniforms, math::mat4f const& worldFromView,
+            size_t eyeCount) noexcept;
 
     void unbindSamplers(backend::DriverApi& driver) noexcept;
 
@@ -172,6 +183,7 @@ private:
     TypedUniformBuffer<PerViewUib>& mUniforms;
     std::array<DescriptorSetLayout, DESCRIPTOR_LAYOUT_COUNT> mDescriptorSetLayout;
     std::array<DescriptorSet, DESCRIPTOR_LAYOUT_COUNT> mDescriptorSet;
+    TextureHandle mFogTexture;
     static void prepareShadowSampling(PerViewUib& uniforms,
             ShadowMappingUniforms const& shadowMappingUniforms) noexcept;
 };
@@ -55,6 +55,9 @@ public:
 
     void commitSlow(DescriptorSetLayout const& layout, backend::DriverApi& driver) noexcept;
 
+    // whether some descriptors changed since the last commit()
+    bool isDirty() const noexcept { return mDirty.any(); }
+
     // bind the descriptor set
     void bind(backend::DriverApi& driver, DescriptorSetBindingPoints set) const noexcept;
 
@@ -28,6 +28,8 @@
 
 #include "details/Engine.h"
 
+#include <private/backend/BackendUtils.h>
+
 #include <backend/DriverEnums.h>
 #include <backend/Handle.h>
 
@@ -39,9 +41,14 @@
 #include <utils/Systrace.h>
 
 #include <algorithm>
+#include <chrono>
 #include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <stdint.h>
+#include <string.h>
 
 namespace filament {
 
@@ -191,10 +198,20 @@ FrameGraph& FrameGraph::compile() noexcept {
         pNode->resolveResourceUsage(dependencyGraph);
     }
 
+    /*
+     * Now that resource lifetimes and usages are known, refine the attachments' discard flags
+     */
+    first = mPassNodes.begin();
+    while (first != activePassNodesEnd) {
+        PassNode* const passNode = *first;
+        first++;
+        passNode->resolveAttachmentLifetimes();
+    }
+
     return *this;
 }
 
-void FrameGraph::execute(backend::DriverApi& driver) noexcept {
+void FrameGraph::execute(backend::DriverApi& driver, PassObserver* const observer) noexcept {
 
     bool const useProtectedMemory = mMode == Mode::PROTECTED;
     auto const& passNodes = mPassNodes;
@@ -213,21 +230,41 @@ void FrameGraph::execute(backend::DriverApi& driver) noexcept {
         SYSTRACE_NAME(node->getName());
         driver.pushGroupMarker(node->getName());
 
+#if FILAMENT_ENABLE_FGVIEWER
+        auto const executeStart = std::chrono::steady_clock::now();
+#endif
+
         // devirtualize resourcesList
         for (VirtualResource* resource : node->devirtualize) {
             assert_invariant(resource->first == node);
             resource->devirtualize(resourceAllocator, useProtectedMemory);
+#if FILAMENT_ENABLE_FGVIEWER
+            // there is only one resource type for now, see getFrameGraphInfo()
+            resource->concreteId = static_cast<Resource<FrameGraphTexture> const*>(
+                    resource)->resource.handle.getId();
+#endif
         }
 
         // call execute
+        if (UTILS_UNLIKELY(observer)) {
+            observer->beginPass(driver, node->getName());
+        }
         FrameGraphResources const resources(*this, *node);
         node->execute(resources, driver);
+        if (UTILS_UNLIKELY(observer)) {
+            observer->endPass(driver);
+        }
 
         // destroy concrete resources
         for (VirtualResource* resource : node->destroy) {
             assert_invariant(resource->last == node);
             resource->destroy(resourceAllocator);
         }
+
+#if FILAMENT_ENABLE_FGVIEWER
+        node->executeTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - executeStart).count();
+#endif
         driver.popGroupMarker();
     }
     driver.popGroupMarker();
@@ -249,6 +286,12 @@ FrameGraph::Builder FrameGraph::addPassInternal(char const* name, FrameGraphPass
     return { *this, node };
 }
 
+#if FILAMENT_ENABLE_FGVIEWER
+void FrameGraph::setSetupTime(PassNode* node, int64_t const duration) noexcept {
+    node->setupTime = duration;
+}
+#endif
+
 FrameGraphHandle FrameGraph::createNewVersion(FrameGraphHandle handle) noexcept {
     assert_invariant(handle);
     ResourceNode* const node = getActiveResourceNode(handle);
@@ -480,11 +523,25 @@ void FrameGraph::export_graphviz(utils::io::ostream& out, char const* name) {
     mGraph.export_graphviz(out, name);
 }
 
-fgviewer::FrameGraphInfo FrameGraph::getFrameGraphInfo(const char *viewName) const {
 #if FILAMENT_ENABLE_FGVIEWER
+fgviewer::FrameGraphInfo FrameGraph::getFrameGraphInfo(const char *viewName,
+        utils::FixedCapacityVector<Renderer::PassTiming> const& gpuTimings) const {
     fgviewer::FrameGraphInfo info{utils::CString(viewName)};
     std::vector<fgviewer::FrameGraphInfo::Pass> passes;
 
+    // Passes are timed in execution order, and the same pass can appear several times (e.g. once
+    // per view), so each timing is only matched once.
+    std::vector<bool> gpuTimingUsed(gpuTimings.size());
+    auto findGpuTime = [&](char const* name) -> int64_t {
+        for (size_t i = 0; i < gpuTimings.size(); i++) {
+            if (!gpuTimingUsed[i] && gpuTimings[i].name && !strcmp(gpuTimings[i].name, name)) {
+                gpuTimingUsed[i] = true;
+                return gpuTimings[i].gpuTime;
+            }
+        }
+        return -1;
+    };
+
     auto first = mPassNodes.begin();
     const auto activePassNodesEnd = mActivePassNodesEnd;
     while (first != activePassNodesEnd) {
@@ -519,8 +576,24 @@ fgviewer::FrameGraphInfo FrameGraph::getFrameGraphInfo(const char *viewName) con
                 continue;
             writes.push_back(resourceNode->resourceHandle.index);
         }
-        passes.emplace_back(utils::CString(pass->getName()),
-            std::move(reads), std::move(writes));
+        fgviewer::FrameGraphInfo::Pass& passInfo = passes.emplace_back(
+                utils::CString(pass->getName()), std::move(reads), std::move(writes));
+        passInfo.cpuSetupTime = pass->setupTime;
+        passInfo.cpuExecuteTime = pass->executeTime;
+        passInfo.gpuTime = findGpuTime(pass->getName());
+    }
+
+    // resources sharing the same concrete texture, i.e. aliased by the ResourceAllocator
+    std::unordered_map<backend::HandleBase::HandleId, std::vector<fgviewer::ResourceId>> aliases;
+    for (const auto &resourceNode: mResourceNodes) {
+        VirtualResource const* const resource = getResource(resourceNode->resourceHandle);
+        if (resourceNode->getRefCount() && !resource->isSubResource() &&
+                resource->concreteId != backend::HandleBase::nullid) {
+            auto& ids = aliases[resource->concreteId];
+            if (std::find(ids.begin(), ids.end(), resourceNode->resourceHandle.index) == ids.end()) {
+                ids.push_back(resourceNode->resourceHandle.index);
+            }
+        }
     }
 
     std::unordered_map<fgviewer::ResourceId, fgviewer::FrameGraphInfo::Resource> resources;
@@ -554,7 +627,36 @@ fgviewer::FrameGraphInfo FrameGraph::getFrameGraphInfo(const char *viewName) con
                 utils::CString(std::to_string(descriptor.depth).data()));
             emplace_resource_property("format",
                 utils::to_string(descriptor.format));
+            emplace_resource_property("samples",
+                utils::CString(std::to_string(descriptor.samples).data()));
+            emplace_resource_property("levels",
+                utils::CString(std::to_string(descriptor.levels).data()));
+        };
 
+        // Size of the memory backing the resource, which subresources share with their parent.
+        // This is the size of the texels only, the driver's allocation can be larger.
+        auto emplace_resource_memory = [this, &emplace_resource_property](
+            const FrameGraphHandle& resourceHandle) {
+            auto const* resource = static_cast<Resource<FrameGraphTexture> const*>(
+                getResource(resourceHandle));
+            auto const& descriptor = resource->descriptor;
+            size_t const texelSize = backend::getFormatSize(descriptor.format);
+            size_t texelCount = 0;
+            for (uint8_t level = 0; level < descriptor.levels; level++) {
+                texelCount += size_t(std::max(1u, descriptor.width >> level)) *
+                        std::max(1u, descriptor.height >> level) * descriptor.depth;
+            }
+            if (!resource->isSubResource()) {
+                emplace_resource_property("size_bytes", utils::CString(std::to_string(
+                        texelCount * texelSize * std::max(uint8_t(1), descriptor.samples)).data()));
+            }
+            if (resource->isImported()) {
+                emplace_resource_property("imported", "true");
+            }
+            if (resource->first && resource->last) {
+                emplace_resource_property("first_pass", utils::CString(resource->first->getName()));
+                emplace_resource_property("last_pass", utils::CString(resource->last->getName()));
+            }
         };
 
         if (resourceNode->getParentNode() != nullptr) {
@@ -563,6 +665,19 @@ fgviewer::FrameGraphInfo FrameGraph::getFrameGraphInfo(const char *viewName) con
                         resourceNode->getParentHandle().index).data()));
         }
         emplace_resource_descriptor(resourceHandle);
+        emplace_resource_memory(resourceHandle);
+
+        VirtualResource const* const resource = getResource(resourceHandle);
+        if (auto const pos = aliases.find(resource->concreteId);
+                !resource->isSubResource() && pos != aliases.end() && pos->second.size() > 1) {
+            std::string others;
+            for (fgviewer::ResourceId const id : pos->second) {
+                if (id != resourceHandle.index) {
+                    others += (others.empty() ? "" : ", ") + std::to_string(id);
+                }
+            }
+            emplace_resource_property("aliased_with", utils::CString(others.data()));
+        }
         resources.emplace(resourceHandle.index, fgviewer::FrameGraphInfo::Resource(
                               resourceHandle.index,
                               utils::CString(resourceNode->getName()),
@@ -574,10 +689,8 @@ fgviewer::FrameGraphInfo FrameGraph::getFrameGraphInfo(const char *viewName) con
     info.setPasses(std::move(passes));
 
     return info;
-#else
-    return fgviewer::FrameGraphInfo();
-#endif
 }
+#endif
 
 
 // ------------------------------------------------------------------------------------------------
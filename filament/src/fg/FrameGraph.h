@@ -37,7 +37,13 @@
 #include <functional>
 
 #if FILAMENT_ENABLE_FGVIEWER
+#include <filament/Renderer.h>
+
 #include <fgviewer/FrameGraphInfo.h>
+
+#include <utils/FixedCapacityVector.h>
+
+#include <chrono>
 #else
 namespace filament::fgviewer {
     class FrameGraphInfo{};
@@ -299,12 +305,24 @@ public:
      */
     FrameGraph& compile() noexcept;
 
+    /**
+     * Notified around the execution of each pass, e.g. to time them.
+     */
+    class PassObserver {
+    public:
+        virtual void beginPass(backend::DriverApi& driver, const char* name) noexcept = 0;
+        virtual void endPass(backend::DriverApi& driver) noexcept = 0;
+    protected:
+        ~PassObserver() noexcept = default;
+    };
+
     /**
      * Execute all referenced passes
      *
      * @param driver a reference to the backend to execute the commands
+     * @param observer optional observer notified around the execution of each pass
      */
-    void execute(backend::DriverApi& driver) noexcept;
+    void execute(backend::DriverApi& driver, PassObserver* observer = nullptr) noexcept;
 
     /**
      * Forwards a resource to another one which gets replaced.
@@ -442,11 +460,18 @@ public:
     //! export a graphviz view of the graph
     void export_graphviz(utils::io::ostream& out, const char* name = nullptr);
 
+#if FILAMENT_ENABLE_FGVIEWER
     /**
      * Export a fgviewer::FrameGraphInfo for current graph.
-     * Note that this function should be called after FrameGraph::compile().
+     * Note that this function should be called after FrameGraph::execute(), so that the CPU
+     * timings of the passes and the aliasing of the resources are known.
+     *
+     * @param viewName name of the view this graph renders
+     * @param gpuTimings most recent GPU timings of the passes, matched to the passes by name
      */
-    fgviewer::FrameGraphInfo getFrameGraphInfo(const char *viewName) const;
+    fgviewer::FrameGraphInfo getFrameGraphInfo(const char *viewName,
+            utils::FixedCapacityVector<Renderer::PassTiming> const& gpuTimings) const;
+#endif
 
 private:
     friend class FrameGraphResources;
@@ -469,6 +494,9 @@ private:
     void reset() noexcept;
     void addPresentPass(const std::function<void(Builder&)>& setup) noexcept;
     Builder addPassInternal(const char* name, FrameGraphPassBase* base) noexcept;
+#if FILAMENT_ENABLE_FGVIEWER
+    static void setSetupTime(PassNode* node, int64_t duration) noexcept;
+#endif
     FrameGraphHandle createNewVersion(FrameGraphHandle handle) noexcept;
     ResourceNode* createNewVersionForSubresourceIfNeeded(ResourceNode* node) noexcept;
     FrameGraphHandle addResourceInternal(VirtualResource* resource) noexcept;
@@ -554,7 +582,14 @@ FrameGraphPass<Data>& FrameGraph::addPass(char const* name, Setup setup, Execute
     auto* const pass = mArena.make<FrameGraphPassConcrete<Data, Execute>>(std::forward<Execute>(execute));
 
     Builder builder(addPassInternal(name, pass));
+#if FILAMENT_ENABLE_FGVIEWER
+    auto const setupStart = std::chrono::steady_clock::now();
+#endif
     setup(builder, const_cast<Data&>(pass->getData()));
+#if FILAMENT_ENABLE_FGVIEWER
+    setSetupTime(pass->mNode, std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - setupStart).count());
+#endif
 
     // return a reference to the pass to the user
     return *pass;
@@ -566,7 +601,14 @@ FrameGraphPass<Data>& FrameGraph::addPass(char const* name, Setup setup) {
     auto* const pass = mArena.make<FrameGraphPass<Data>>();
 
     Builder builder(addPassInternal(name, pass));
+#if FILAMENT_ENABLE_FGVIEWER
+    auto const setupStart = std::chrono::steady_clock::now();
+#endif
     setup(builder, const_cast<Data&>(pass->getData()));
+#if FILAMENT_ENABLE_FGVIEWER
+    setSetupTime(pass->mNode, std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - setupStart).count());
+#endif
 
     // return a reference to the pass to the user
     return *pass;
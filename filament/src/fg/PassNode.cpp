@@ -151,11 +151,9 @@ void RenderPassNode::resolve() noexcept {
 
                 rt.targetBufferFlags |= target;
 
-                // Discard at the end only if we are writing to this attachment AND later reading
-                // from it. (in particular, don't discard if we're not writing at all, because this
-                // attachment might have other readers after us).
-                // TODO: we could set the discard flag if we are the last reader, i.e.
-                //       if rt->incoming[i] last reader is us.
+                // Discard at the end if we are writing to this attachment and nobody reads it
+                // later. Attachments we only read are handled in resolveAttachmentLifetimes(),
+                // once we know whether we're their last user.
                 if (rt.outgoing[i] && !rt.outgoing[i]->hasActiveReaders()) {
                     rt.backend.params.flags.discardEnd |= target;
                 }
@@ -245,6 +243,51 @@ void RenderPassNode::resolve() noexcept {
     }
 }
 
+void RenderPassNode::resolveAttachmentLifetimes() noexcept {
+    using namespace backend;
+
+    // With several render targets in this pass, an attachment could be shared between them, and
+    // its content would need to survive from one to the next.
+    if (mRenderTargetData.size() != 1) {
+        return;
+    }
+
+    auto& rt = mRenderTargetData.front();
+    if (rt.imported) {
+        return;
+    }
+
+    for (size_t i = 0; i < MRT::MAX_SUPPORTED_RENDER_TARGET_COUNT + 2; i++) {
+        if (!rt.descriptor.attachments.array[i]) {
+            continue;
+        }
+        const TargetBufferFlags target = getTargetBufferFlagsAt(i);
+        VirtualResource* pResource = mFrameGraph.getResource(rt.descriptor.attachments.array[i]);
+        auto* const pTexture = static_cast<Resource<FrameGraphTexture>*>(pResource->getResource());
+
+        // Only consider textures we own and that are never sampled, blitted or read back, since
+        // these could be accessed after the render pass, within this pass's execute().
+        if (pTexture->isImported() ||
+                any(pTexture->usage & ~(TextureUsage::ALL_ATTACHMENTS | TextureUsage::TRANSIENT))) {
+            continue;
+        }
+
+        // If we're the last pass using this attachment, nobody will ever read it again.
+        if (pTexture->last == this) {
+            rt.backend.params.flags.discardEnd |= target;
+        }
+
+        // If we're also the first pass using it, its content never leaves this render pass, so
+        // it doesn't need to be backed by memory on tiled GPUs.
+        if (pTexture->first == this && pResource == pTexture &&
+                pTexture->descriptor.levels == 1 &&
+                any(rt.backend.params.flags.discardStart & target) &&
+                any(rt.backend.params.flags.discardEnd & target)) {
+            pTexture->usage |= TextureUsage::TRANSIENT;
+        }
+    }
+}
+
 void RenderPassNode::RenderPassData::devirtualize(FrameGraph& fg,
         ResourceAllocatorInterface& resourceAllocator) noexcept {
     assert_invariant(any(targetBufferFlags));
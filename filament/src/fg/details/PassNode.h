@@ -56,10 +56,18 @@ public:
 
     virtual void execute(FrameGraphResources const& resources, backend::DriverApi& driver) noexcept = 0;
     virtual void resolve() noexcept = 0;
+    // called once the first/last users and the usage of every resource are known
+    virtual void resolveAttachmentLifetimes() noexcept { }
     utils::CString graphvizifyEdgeColor() const noexcept override;
 
     Vector<VirtualResource*> devirtualize;         // resources we need to create before executing
     Vector<VirtualResource*> destroy;              // resources we need to destroy after executing
+
+#if FILAMENT_ENABLE_FGVIEWER
+    // CPU time of the pass' setup and execute stages, for fgviewer [ns]
+    int64_t setupTime = 0;
+    int64_t executeTime = 0;
+#endif
 };
 
 class RenderPassNode : public PassNode {
@@ -98,6 +106,7 @@ private:
     utils::CString graphvizify() const noexcept override;
     void execute(FrameGraphResources const& resources, backend::DriverApi& driver) noexcept override;
     void resolve() noexcept override;
+    void resolveAttachmentLifetimes() noexcept override;
 
     // constants
     const char* const mName = nullptr;
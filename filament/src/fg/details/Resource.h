@@ -56,6 +56,12 @@ public:
     PassNode* first = nullptr;  // pass that needs to instantiate the resource
     PassNode* last = nullptr;   // pass that can destroy the resource
 
+#if FILAMENT_ENABLE_FGVIEWER
+    // id of the concrete resource, recorded by execute() for fgviewer. Resources sharing an id
+    // were aliased by the ResourceAllocator.
+    backend::HandleBase::HandleId concreteId = backend::HandleBase::nullid;
+#endif
+
     explicit VirtualResource(const char* name) noexcept : parent(this), name(name) { }
     VirtualResource(VirtualResource* parent, const char* name) noexcept : parent(parent), name(name) { }
     VirtualResource(VirtualResource const& rhs) noexcept = delete;
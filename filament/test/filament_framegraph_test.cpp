@@ -951,3 +951,58 @@ TEST_F(FrameGraphTest, WriteResourceReadAsAttachment) {
 
     fg.execute(driverApi);
 }
+
+TEST_F(FrameGraphTest, AttachmentLifetimes) {
+
+    // checks that attachments are discarded by their last user, and that attachments that
+    // never leave their render pass are flagged as transient.
+
+    struct DepthPassData {
+        FrameGraphId<FrameGraphTexture> color;
+        FrameGraphId<FrameGraphTexture> depth;
+    };
+    auto& depthPass = fg.addPass<DepthPassData>("Depth Pass",
+            [&](FrameGraph::Builder& builder, auto& data) {
+                data.color = builder.create<FrameGraphTexture>("Scratch buffer", {.width=16, .height=32});
+                data.depth = builder.create<FrameGraphTexture>("Depth buffer", {.width=16, .height=32});
+                data.color = builder.write(data.color, FrameGraphTexture::Usage::COLOR_ATTACHMENT);
+                data.depth = builder.write(data.depth, FrameGraphTexture::Usage::DEPTH_ATTACHMENT);
+                builder.declareRenderPass("Depth target", { .attachments = {
+                        .color = { data.color }, .depth = data.depth }});
+            },
+            [=](FrameGraphResources const& resources, auto const& data, backend::DriverApi&) {
+                auto rt = resources.getRenderPassInfo();
+                EXPECT_EQ(rt.params.flags.discardStart, TargetBufferFlags::COLOR0 | TargetBufferFlags::DEPTH);
+                EXPECT_EQ(rt.params.flags.discardEnd, TargetBufferFlags::COLOR0);
+                EXPECT_TRUE(any(resources.getUsage(data.color) & FrameGraphTexture::Usage::TRANSIENT));
+                EXPECT_TRUE(none(resources.getUsage(data.depth) & FrameGraphTexture::Usage::TRANSIENT));
+            });
+
+    struct ColorPassData {
+        FrameGraphId<FrameGraphTexture> color;
+        FrameGraphId<FrameGraphTexture> depth;
+    };
+    auto& colorPass = fg.addPass<ColorPassData>("Color Pass",
+            [&](FrameGraph::Builder& builder, auto& data) {
+                data.color = builder.create<FrameGraphTexture>("Color buffer", {.width=16, .height=32});
+                data.color = builder.write(data.color, FrameGraphTexture::Usage::COLOR_ATTACHMENT);
+                data.depth = builder.read(depthPass->depth, FrameGraphTexture::Usage::DEPTH_ATTACHMENT);
+                builder.declareRenderPass("Color target", { .attachments = {
+                        .color = { data.color }, .depth = data.depth }});
+            },
+            [=](FrameGraphResources const& resources, auto const& data, backend::DriverApi&) {
+                auto rt = resources.getRenderPassInfo();
+                EXPECT_EQ(rt.params.flags.discardStart, TargetBufferFlags::COLOR0);
+                // we're the last user of the depth buffer
+                EXPECT_EQ(rt.params.flags.discardEnd, TargetBufferFlags::DEPTH);
+                EXPECT_TRUE(none(resources.getUsage(data.color) & FrameGraphTexture::Usage::TRANSIENT));
+            });
+
+    fg.present(colorPass->color);
+
+    EXPECT_TRUE(fg.isAcyclic());
+
+    fg.compile();
+
+    fg.execute(driverApi);
+}
@@ -15,7 +15,9 @@
  */
 
 #include <iostream>
+#include <iterator>
 #include <random>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -31,16 +33,34 @@
 #include <filament/Frustum.h>
 #include <filament/Material.h>
 #include <filament/Engine.h>
+#include <filament/IndexBuffer.h>
+#include <filament/IndirectLight.h>
+#include <filament/LightManager.h>
+#include <filament/RenderableManager.h>
+#include <filament/Scene.h>
+#include <filament/Texture.h>
+#include <filament/TransformManager.h>
+#include <filament/VertexBuffer.h>
 
 #include <private/filament/BufferInterfaceBlock.h>
 #include <private/filament/UibStructs.h>
 #include <private/backend/BackendUtils.h>
 
 #include "Allocators.h"
+#include "BoundingVolumeHierarchy.h"
+#include "Culler.h"
 #include "details/Material.h"
 #include "details/Camera.h"
 #include "Froxelizer.h"
+#include "FrameAllocator.h"
+#include "FrameTimePredictor.h"
+#include "Intersections.h"
+#include "OcclusionCuller.h"
 #include "details/Engine.h"
+#include "details/IndirectLight.h"
+#include "details/Scene.h"
+#include "details/Texture.h"
+#include "ds/ColorPassDescriptorSet.h"
 #include "components/RenderableManager.h"
 #include "components/TransformManager.h"
 #include "UniformBuffer.h"
@@ -196,6 +216,28 @@ TEST(FilamentTest, TransformManagerSimple) {
     EXPECT_EQ(updated, t);
 }
 
+TEST(FilamentTest, TransformManagerBatch) {
+    filament::FTransformManager tcm;
+    EntityManager& em = EntityManager::get();
+    Entity root = em.create();
+    tcm.create(root, 0, mat4f::translation(float3{ 1, 0, 0 }));
+
+    Entity children[64];
+    em.create(64, children);
+    tcm.create(64, children, tcm.getInstance(root), mat4f::translation(float3{ 0, 1, 0 }));
+    EXPECT_EQ(65, tcm.getComponentCount());
+
+    for (Entity const e : children) {
+        auto const ti = tcm.getInstance(e);
+        ASSERT_TRUE(ti);
+        EXPECT_EQ(root, tcm.getParent(ti));
+        EXPECT_EQ(mat4f::translation(float3{ 1, 1, 0 }), tcm.getWorldTransform(ti));
+    }
+
+    em.destroy(64, children);
+    em.destroy(root);
+}
+
 TEST(FilamentTest, TransformManager) {
     filament::FTransformManager tcm;
     tcm.setAccurateTranslationsEnabled(true);
@@ -300,6 +342,65 @@ TEST(FilamentTest, TransformManager) {
     EXPECT_EQ(c, tcm.getChildCount(newParent));
 }
 
+TEST(FilamentTest, TransformManagerParallelCommit) {
+    JobSystem js;
+    js.adopt();
+
+    filament::FTransformManager serial;
+    filament::FTransformManager parallel;
+    EntityManager& em = EntityManager::get();
+
+    // a wide and shallow hierarchy, with some parents created after their children
+    constexpr size_t rootCount = 4096;
+    std::vector<Entity> entities(rootCount * 4);
+    em.create(entities.size(), entities.data());
+    std::default_random_engine generator(82828); // NOLINT
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    for (auto* tcm : { &serial, &parallel }) {
+        for (size_t i = 0; i < entities.size(); i++) {
+            tcm->create(entities[i]);
+        }
+        for (size_t i = 0; i < rootCount; i++) {
+            // entity i has 3 children, the first one has a child of its own
+            Entity const root = entities[i];
+            tcm->setParent(tcm->getInstance(entities[rootCount + i]), tcm->getInstance(root));
+            tcm->setParent(tcm->getInstance(entities[2 * rootCount + i]), tcm->getInstance(root));
+            tcm->setParent(tcm->getInstance(entities[3 * rootCount + i]),
+                    tcm->getInstance(entities[rootCount + i]));
+            if (i % 64) {
+                // parent some of the roots to a grandchild of a previous root, which is
+                // created after them
+                tcm->setParent(tcm->getInstance(root),
+                        tcm->getInstance(entities[3 * rootCount + i / 64]));
+            }
+        }
+    }
+
+    generator.seed(82828);
+    serial.openLocalTransformTransaction();
+    for (Entity const e : entities) {
+        serial.setTransform(serial.getInstance(e), mat4f::translation(float3{
+                distribution(generator), distribution(generator), distribution(generator) }));
+    }
+    serial.commitLocalTransformTransaction();
+
+    generator.seed(82828);
+    parallel.openLocalTransformTransaction();
+    for (Entity const e : entities) {
+        parallel.setTransform(parallel.getInstance(e), mat4f::translation(float3{
+                distribution(generator), distribution(generator), distribution(generator) }));
+    }
+    parallel.commitLocalTransformTransaction(js);
+
+    for (Entity const e : entities) {
+        EXPECT_EQ(serial.getWorldTransform(serial.getInstance(e)),
+                parallel.getWorldTransform(parallel.getInstance(e)));
+    }
+
+    em.destroy(entities.size(), entities.data());
+    js.emancipate();
+}
+
 TEST(FilamentTest, UniformInterfaceBlock) {
 
     BufferInterfaceBlock::Builder b;
@@ -532,6 +633,40 @@ TEST(FilamentTest, UniformBufferSize2) {
     buffer.invalidate();
 }
 
+TEST(FilamentTest, UniformBufferDirtyRange) {
+    UniformBuffer buffer(256);
+
+    // a new buffer is entirely dirty
+    EXPECT_TRUE(buffer.isDirty());
+    EXPECT_EQ(0, buffer.getDirtyOffset());
+    EXPECT_EQ(256, buffer.getDirtySize());
+
+    buffer.clean();
+    EXPECT_FALSE(buffer.isDirty());
+
+    buffer.setUniform(64, float4(1.0f));
+    EXPECT_TRUE(buffer.isDirty());
+    EXPECT_EQ(64, buffer.getDirtyOffset());
+    EXPECT_EQ(16, buffer.getDirtySize());
+
+    // the range covers all the changes
+    buffer.setUniform(32, 1.0f);
+    EXPECT_EQ(32, buffer.getDirtyOffset());
+    EXPECT_EQ(48, buffer.getDirtySize());
+
+    // a mat3 is stored as 3 float4, without the last float
+    buffer.clean();
+    buffer.setUniform(128, mat3f{});
+    EXPECT_EQ(128, buffer.getDirtyOffset());
+    EXPECT_EQ(44, buffer.getDirtySize());
+
+    buffer.clean();
+    float3 const array[3] = {};
+    buffer.setUniformArray(160, array, 3);
+    EXPECT_EQ(160, buffer.getDirtyOffset());
+    EXPECT_EQ(44, buffer.getDirtySize());
+}
+
 TEST(FilamentTest, BoxCulling) {
     Frustum frustum(mat4f::frustum(-1, 1, -1, 1, 1, 100));
 
@@ -612,6 +747,496 @@ TEST(FilamentTest, SphereCulling) {
     EXPECT_TRUE(frustum.intersects({ 0, 200 }));
 }
 
+TEST(FilamentTest, BatchCullingMatchesScalar) {
+    Frustum frustum(mat4f::perspective(45.0f, 1.0f, 0.1f, 100.0f));
+
+    constexpr size_t count = Culler::MODULO * 64;
+    std::default_random_engine gen; // NOLINT
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> size(0.0f, 10.0f);
+
+    std::vector<float3> centers(count);
+    std::vector<float3> extents(count);
+    std::vector<float4> spheres(count);
+    for (size_t i = 0; i < count; i++) {
+        centers[i] = { position(gen), position(gen), position(gen) };
+        extents[i] = { size(gen), size(gen), size(gen) };
+        spheres[i] = { centers[i], extents[i].x };
+    }
+
+    std::vector<Culler::result_type> expected(count);
+    std::vector<Culler::result_type> actual(count);
+
+    Culler::Test::intersectsScalar(expected.data(), frustum,
+            centers.data(), extents.data(), count);
+    Culler::Test::intersects(actual.data(), frustum,
+            centers.data(), extents.data(), count);
+    for (size_t i = 0; i < count; i++) {
+        EXPECT_EQ(expected[i] & 1, actual[i] & 1) << "box " << i;
+    }
+
+    Culler::Test::intersectsScalar(expected.data(), frustum, spheres.data(), count);
+    Culler::Test::intersects(actual.data(), frustum, spheres.data(), count);
+    for (size_t i = 0; i < count; i++) {
+        EXPECT_EQ(expected[i] & 1, actual[i] & 1) << "sphere " << i;
+    }
+}
+
+TEST(FilamentTest, CubeFaceCullingMatchesFrustums) {
+    float3 const eye{ 1, 2, 3 };
+    float3 const directions[Culler::CUBE_FACE_COUNT] = {
+            { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+    float3 const ups[Culler::CUBE_FACE_COUNT] = {
+            { 0, 1, 0 }, { 0, 1, 0 }, { 0, 0, 1 }, { 0, 0, 1 }, { 0, 1, 0 }, { 0, 1, 0 } };
+    Culler::CubeFrustums frustums;
+    mat4f const Mp = mat4f::perspective(90.0f, 1.0f, 0.01f, 50.0f);
+    for (size_t f = 0; f < Culler::CUBE_FACE_COUNT; f++) {
+        frustums[f] = Frustum(Mp * inverse(mat4f::lookAt(eye, eye + directions[f], ups[f])));
+    }
+
+    constexpr size_t count = Culler::MODULO * 64;
+    std::default_random_engine gen; // NOLINT
+    std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+    std::uniform_real_distribution<float> size(0.0f, 10.0f);
+
+    std::vector<float3> centers(count);
+    std::vector<float3> extents(count);
+    for (size_t i = 0; i < count; i++) {
+        centers[i] = { position(gen), position(gen), position(gen) };
+        extents[i] = { size(gen), size(gen), size(gen) };
+    }
+
+    std::vector<Culler::result_type> faces(count);
+    std::vector<Culler::result_type> facesScalar(count);
+    Culler::Test::intersectsCubeFaces(faces.data(), frustums,
+            centers.data(), extents.data(), count);
+    Culler::Test::intersectsCubeFacesScalar(facesScalar.data(), frustums,
+            centers.data(), extents.data(), count);
+
+    std::vector<Culler::result_type> expected(count);
+    for (size_t f = 0; f < Culler::CUBE_FACE_COUNT; f++) {
+        Culler::Test::intersects(expected.data(), frustums[f],
+                centers.data(), extents.data(), count);
+        for (size_t i = 0; i < count; i++) {
+            EXPECT_EQ(expected[i] & 1, (faces[i] >> f) & 1) << "box " << i << " face " << f;
+            EXPECT_EQ(expected[i] & 1, (facesScalar[i] >> f) & 1) << "box " << i << " face " << f;
+        }
+    }
+}
+
+TEST(FilamentTest, BoundingVolumeHierarchyCulling) {
+    Frustum frustum(mat4f::perspective(45.0f, 1.0f, 0.1f, 100.0f));
+
+    constexpr size_t count = 1000; // not a multiple of Culler::MODULO on purpose
+    std::default_random_engine gen; // NOLINT
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> size(0.0f, 5.0f);
+
+    std::vector<float3> centers(Culler::round(count));
+    std::vector<float3> extents(Culler::round(count));
+    for (size_t i = 0; i < count; i++) {
+        centers[i] = { position(gen), position(gen), position(gen) };
+        extents[i] = { size(gen), size(gen), size(gen) };
+    }
+
+    std::vector<Culler::result_type> expected(Culler::round(count));
+    Culler::Test::intersectsScalar(expected.data(), frustum,
+            centers.data(), extents.data(), count);
+
+    BoundingVolumeHierarchy bvh;
+    bvh.build(centers.data(), extents.data(), count);
+    EXPECT_EQ(bvh.size(), count);
+
+    // results of culled boxes must be left untouched
+    std::vector<Culler::result_type> actual(count, 0x4);
+    bvh.cull(actual.data(), frustum.getNormalizedPlanes(), 1);
+    for (size_t i = 0; i < count; i++) {
+        EXPECT_EQ(actual[i] & 0x4, 0x4);
+        EXPECT_EQ((actual[i] >> 1) & 1, expected[i] & 1) << "box " << i;
+    }
+
+    bvh.clear();
+    EXPECT_TRUE(bvh.empty());
+}
+
+TEST(FilamentTest, BoundingVolumeHierarchyRaycast) {
+    constexpr size_t count = 1000;
+    std::default_random_engine gen; // NOLINT
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> size(0.0f, 5.0f);
+
+    std::vector<float3> centers(count);
+    std::vector<float3> extents(count);
+    for (size_t i = 0; i < count; i++) {
+        centers[i] = { position(gen), position(gen), position(gen) };
+        extents[i] = { size(gen), size(gen), size(gen) };
+    }
+
+    BoundingVolumeHierarchy bvh;
+    bvh.build(centers.data(), extents.data(), count);
+
+    for (size_t r = 0; r < 100; r++) {
+        float3 const origin{ position(gen), position(gen), position(gen) };
+        float3 const direction = normalize(float3{ position(gen), position(gen), position(gen) });
+        float const maxDistance = r % 2 ? 50.0f : std::numeric_limits<float>::infinity();
+
+        // brute force
+        uint32_t expectedIndex = BoundingVolumeHierarchy::NO_HIT;
+        float expectedDistance = maxDistance;
+        for (uint32_t i = 0; i < count; i++) {
+            float2 const t = rayBoxIntersection(origin, 1.0f / direction, centers[i], extents[i]);
+            float const distance = std::max(t.x, 0.0f);
+            if (t.x <= t.y && t.y >= 0.0f && distance <= expectedDistance) {
+                expectedIndex = i;
+                expectedDistance = distance;
+            }
+        }
+
+        auto const hit = bvh.raycast(origin, direction, maxDistance);
+        if (expectedIndex == BoundingVolumeHierarchy::NO_HIT) {
+            EXPECT_EQ(hit.index, BoundingVolumeHierarchy::NO_HIT) << "ray " << r;
+        } else {
+            EXPECT_NE(hit.index, BoundingVolumeHierarchy::NO_HIT) << "ray " << r;
+            EXPECT_FLOAT_EQ(hit.distance, expectedDistance) << "ray " << r;
+        }
+    }
+}
+
+TEST(FilamentTest, OcclusionCulling) {
+    mat4 const projection = mat4::perspective(45.0, 1.0, 0.1, 100.0);
+
+    // a wall at z = -10 covering the left half of the screen
+    float4 const wall = mat4f{ projection } * float4{ 0, 0, -10, 1 };
+    float const wallDepth = 0.5f - 0.5f * wall.z / wall.w;
+    constexpr uint32_t width = 37; // not a power of two on purpose
+    constexpr uint32_t height = 21;
+    std::vector<float2> buffer(width * height);
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            buffer[y * width + x] = { 0.0f, x < width / 2 ? wallDepth : 0.0f };
+        }
+    }
+
+    OcclusionCuller culler;
+    EXPECT_FALSE(culler.isValid());
+    culler.update(&buffer[0].y, 2, width, height, projection);
+    EXPECT_TRUE(culler.isValid());
+
+    mat4f const clipFromBox{ projection };
+    // behind the wall
+    EXPECT_TRUE(culler.isOccluded(clipFromBox, { -5, 0, -20 }, { 1, 1, 1 }));
+    // in front of the wall
+    EXPECT_FALSE(culler.isOccluded(clipFromBox, { -2, 0, -5 }, { 1, 1, 1 }));
+    // behind the wall, but partially visible on the right side of the screen
+    EXPECT_FALSE(culler.isOccluded(clipFromBox, { 0, 0, -20 }, { 2, 1, 1 }));
+    // on the right side of the screen
+    EXPECT_FALSE(culler.isOccluded(clipFromBox, { 5, 0, -20 }, { 1, 1, 1 }));
+    // crossing the camera plane
+    EXPECT_FALSE(culler.isOccluded(clipFromBox, { -5, 0, 0 }, { 1, 1, 50 }));
+
+    float3 const centers[] = {{ -5, 0, -20 }, { 5, 0, -20 }, { -5, 0, -30 }};
+    float3 const extents[] = {{  1, 1,   1 }, { 1, 1,   1 }, {  1, 1,   1 }};
+    Culler::result_type results[] = { 0x3, 0x3, 0x2 };
+    culler.cull(results, clipFromBox, centers, extents, 3, 0);
+    EXPECT_EQ(results[0], 0x2);
+    EXPECT_EQ(results[1], 0x3);
+    EXPECT_EQ(results[2], 0x2);
+
+    culler.invalidate();
+    EXPECT_FALSE(culler.isValid());
+    EXPECT_FALSE(culler.isOccluded(clipFromBox, { -5, 0, -20 }, { 1, 1, 1 }));
+}
+
+TEST(FilamentTest, FrameTimePredictor) {
+    FrameTimePredictor predictor;
+    EXPECT_FALSE(predictor.isValid());
+
+    // frames that take 4ms per unit of load plus 12ms for the full area
+    constexpr float areas[] = { 1.0f, 0.8f, 0.6f, 0.7f, 0.9f, 0.5f };
+    for (size_t i = 0; i < 60; i++) {
+        float const load = i < 30 ? 1.0f : 1.5f;
+        float const area = areas[i % std::size(areas)];
+        predictor.update(load, area, 4.0f * load + 12.0f * area);
+    }
+    EXPECT_TRUE(predictor.isValid());
+    EXPECT_NEAR(predictor.predict(1.5f, 1.0f), 18.0f, 0.5f);
+
+    // the area meeting a 16ms target
+    EXPECT_NEAR(predictor.solve(1.5f, 16.0f), 10.0f / 12.0f, 0.05f);
+
+    // without variations, the whole frame time is assumed to be proportional to the area
+    predictor.reset();
+    for (size_t i = 0; i < 10; i++) {
+        predictor.update(1.0f, 1.0f, 20.0f);
+    }
+    EXPECT_NEAR(predictor.solve(1.0f, 16.0f), 0.8f, 1e-3f);
+}
+
+TEST(FilamentTest, FrameAllocator) {
+    FrameAllocator allocator(1024);
+
+    void* const a = allocator.allocate(100, 8);
+    void* const b = allocator.allocate(100, 64);
+    ASSERT_NE(nullptr, a);
+    ASSERT_NE(nullptr, b);
+    EXPECT_EQ(0, uintptr_t(b) % 64);
+    EXPECT_GE(uintptr_t(b), uintptr_t(a) + 100);
+
+    // the buffer is exhausted
+    EXPECT_EQ(nullptr, allocator.allocate(1024, 8));
+
+    // allocations are reclaimed FRAME_COUNT frames later
+    for (size_t i = 0; i < FrameAllocator::FRAME_COUNT - 1; i++) {
+        allocator.nextFrame();
+        EXPECT_NE(nullptr, allocator.allocate(1000, 8));
+    }
+    allocator.nextFrame();
+    EXPECT_EQ(a, allocator.allocate(100, 8));
+
+    FrameAllocator disabled(0);
+    EXPECT_EQ(nullptr, disabled.allocate(16, 8));
+}
+
+TEST(FilamentTest, TextureUploadQueue) {
+    using namespace filament;
+
+    Engine::Config config;
+    config.textureUploadBudgetMB = 1;
+    FEngine* engine = downcast(Engine::Builder()
+            .backend(Engine::Backend::NOOP)
+            .config(&config)
+            .build());
+
+    // 4 MiB, uploaded over 4 frames
+    Texture* texture = Texture::Builder()
+            .width(1024)
+            .height(1024)
+            .format(Texture::InternalFormat::RGBA8)
+            .build(*engine);
+
+    size_t const size = 1024 * 1024 * 4;
+    bool released = false;
+    texture->setImageAsync(*engine, 0, Texture::PixelBufferDescriptor::make(
+            malloc(size), size, Texture::Format::RGBA, Texture::Type::UBYTE,
+            [&released](void* buffer, size_t) {
+                free(buffer);
+                released = true;
+            }));
+
+    TextureUploadQueue const& queue = engine->getTextureUploadQueue();
+    EXPECT_EQ(size, queue.getPendingSize());
+    for (size_t i = 1; i <= 4; i++) {
+        engine->prepare();
+        EXPECT_EQ(size - i * 1024 * 1024, queue.getPendingSize());
+    }
+    EXPECT_TRUE(queue.empty());
+
+    engine->flushAndWait();
+    engine->pumpMessageQueues();
+    EXPECT_TRUE(released);
+
+    // pending uploads are dropped with the texture
+    released = false;
+    texture->setImageAsync(*engine, 0, Texture::PixelBufferDescriptor::make(
+            malloc(size), size, Texture::Format::RGBA, Texture::Type::UBYTE,
+            [&released](void* buffer, size_t) {
+                free(buffer);
+                released = true;
+            }));
+    engine->prepare();
+    engine->destroy(texture);
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(0, queue.getPendingSize());
+
+    engine->flushAndWait();
+    engine->pumpMessageQueues();
+    EXPECT_TRUE(released);
+
+    Engine* e = engine;
+    Engine::destroy(&e);
+}
+
+TEST(FilamentTest, IndirectLightSetIrradiance) {
+    using namespace filament;
+
+    Engine* engine = Engine::create(Engine::Backend::NOOP);
+
+    IndirectLight* ibl = IndirectLight::Builder().build(*engine);
+    FIndirectLight const* fibl = downcast(ibl);
+    EXPECT_EQ(65504.0f, fibl->getSH()[0].x);
+
+    float3 const sh[4] = { { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 }, { 10, 11, 12 } };
+    ibl->setIrradiance(2, sh);
+    for (size_t i = 0; i < 9; i++) {
+        EXPECT_PRED2(vec3eq, i < 4 ? sh[i] : float3{ 0 }, fibl->getSH()[i]);
+    }
+
+    // the same conversion as the builder's
+    float3 const radiance[9] = { { 1, 1, 1 }, { 0.5f, 0.5f, 0.5f } };
+    IndirectLight* reference = IndirectLight::Builder().radiance(3, radiance).build(*engine);
+    ibl->setRadiance(3, radiance);
+    for (size_t i = 0; i < 9; i++) {
+        EXPECT_PRED2(vec3eq, downcast(reference)->getSH()[i], fibl->getSH()[i]);
+    }
+
+    engine->destroy(reference);
+    engine->destroy(ibl);
+    Engine::destroy(&engine);
+}
+
+TEST(FilamentTest, MaterialParameterHandle) {
+    using namespace filament;
+
+    Engine* engine = Engine::create(Engine::Backend::NOOP);
+    Material const* material = engine->getDefaultMaterial();
+    MaterialInstance* mi = material->createInstance();
+
+    auto const missing = material->getParameterHandle<float4>("__missing__");
+    EXPECT_FALSE(missing.isValid());
+    mi->setParameter(missing, float4{ 1.0f });
+
+    // a handle is only valid for the type of its parameter
+    std::vector<Material::ParameterInfo> parameters(material->getParameterCount());
+    material->getParameters(parameters.data(), parameters.size());
+    for (auto const& info : parameters) {
+        if (info.isSampler || info.isSubpass || info.count > 1 ||
+                info.type != Material::ParameterType::FLOAT4) {
+            continue;
+        }
+        auto const handle = material->getParameterHandle<float4>(info.name);
+        EXPECT_TRUE(handle.isValid());
+        EXPECT_FALSE(material->getParameterHandle<float3>(info.name).isValid());
+
+        float4 const value{ 0.25f, 0.5f, 0.75f, 1.0f };
+        mi->setParameter(handle, value);
+        EXPECT_TRUE(value == mi->getParameter<float4>(info.name));
+    }
+
+    engine->destroy(mi);
+    Engine::destroy(&engine);
+}
+
+TEST(FilamentTest, SceneSharedPreparation) {
+    using namespace filament;
+
+    Engine* engine = Engine::create(Engine::Backend::NOOP);
+    utils::EntityManager& em = utils::EntityManager::get();
+    TransformManager& tcm = engine->getTransformManager();
+
+    VertexBuffer* vb = VertexBuffer::Builder()
+            .vertexCount(3).bufferCount(1)
+            .attribute(VertexAttribute::POSITION, 0, VertexBuffer::AttributeType::FLOAT3)
+            .build(*engine);
+    IndexBuffer* ib = IndexBuffer::Builder()
+            .indexCount(3).bufferType(IndexBuffer::IndexType::USHORT)
+            .build(*engine);
+
+    FScene* scene = downcast(engine->createScene());
+    std::vector<utils::Entity> entities(12);
+    em.create(entities.size(), entities.data());
+    for (size_t i = 0; i < entities.size(); i++) {
+        utils::Entity const e = entities[i];
+        tcm.create(e, {}, mat4f::translation(float3{ float(i), 0, -float(i) }));
+        if (i % 4 == 3) {
+            LightManager::Builder(LightManager::Type::POINT).falloff(2).build(*engine, e);
+        } else {
+            RenderableManager::Builder(1)
+                    .boundingBox({{ 0, 0, 0 }, { 1, 1, 1 }})
+                    .geometry(0, RenderableManager::PrimitiveType::TRIANGLES, vb, ib)
+                    .geometryType(i % 2 ?
+                            RenderableManager::Builder::GeometryType::STATIC_BOUNDS :
+                            RenderableManager::Builder::GeometryType::DYNAMIC)
+                    .build(*engine, e);
+        }
+        scene->addEntity(e);
+    }
+
+    LinearAllocatorArena arena("FRenderer: per-frame allocator", 3 * 1024 * 1024);
+    RootArenaScope scope(arena);
+    JobSystem& js = engine->getJobSystem();
+
+    // reference, without shared preparation
+    scene->prepare(js, scope, mat4{}, false);
+    FScene::RenderableSoa const& renderables = scene->getRenderableData();
+    FScene::LightSoa& lights = scene->getLightData();
+    std::vector<RenderableManager::Instance> const instances(
+            renderables.data<FScene::RENDERABLE_INSTANCE>(),
+            renderables.data<FScene::RENDERABLE_INSTANCE>() + renderables.size());
+    std::vector<float3> const centers(
+            renderables.data<FScene::WORLD_AABB_CENTER>(),
+            renderables.data<FScene::WORLD_AABB_CENTER>() + renderables.size());
+    std::vector<LightManager::Instance> const lightInstances(
+            lights.data<FScene::LIGHT_INSTANCE>(),
+            lights.data<FScene::LIGHT_INSTANCE>() + lights.size());
+    size_t const staticCount = scene->getStaticRenderableCount();
+    EXPECT_EQ(9u, instances.size());
+    EXPECT_EQ(3u, staticCount);
+    EXPECT_EQ(FScene::DIRECTIONAL_LIGHTS_COUNT + 3, lightInstances.size());
+
+    scene->setSharedPreparationEnabled(true);
+    for (size_t pass = 0; pass < 3; pass++) {
+        scene->prepare(js, scope, mat4{}, false);
+        EXPECT_EQ(staticCount, scene->getStaticRenderableCount());
+        ASSERT_EQ(instances.size(), renderables.size());
+        ASSERT_EQ(lightInstances.size(), lights.size());
+        for (size_t i = 0; i < instances.size(); i++) {
+            EXPECT_EQ(instances[i], renderables.elementAt<FScene::RENDERABLE_INSTANCE>(i));
+            EXPECT_PRED2(vec3eq, centers[i], renderables.elementAt<FScene::WORLD_AABB_CENTER>(i));
+        }
+        for (size_t i = 0; i < lightInstances.size(); i++) {
+            EXPECT_EQ(lightInstances[i], lights.elementAt<FScene::LIGHT_INSTANCE>(i));
+        }
+
+        // reorder and cull the data like a view does
+        FScene::RenderableSoa& data = scene->getRenderableData();
+        std::reverse(data.begin(), data.end());
+        lights.resize(FScene::DIRECTIONAL_LIGHTS_COUNT + 1);
+    }
+    scene->setSharedPreparationEnabled(false);
+
+    for (utils::Entity const e : entities) {
+        engine->destroy(e);
+    }
+    em.destroy(entities.size(), entities.data());
+    engine->destroy(scene);
+    engine->destroy(vb);
+    engine->destroy(ib);
+    Engine::destroy(&engine);
+}
+
+TEST(FilamentTest, LateLatchCamera) {
+    mat4f const projection = mat4f::perspective(60, 1.5f, 0.1f, 100.0f);
+    mat4f const model = mat4f::translation(float3{ 1, 2, 3 });
+    mat4f const latched = mat4f::translation(float3{ 1, 2, 3 }) *
+            mat4f::rotation(0.1f, float3{ 0, 1, 0 });
+
+    PerViewUib uniforms{};
+    uniforms.clipFromViewMatrix = projection;
+    uniforms.viewFromClipMatrix = inverse(projection);
+    uniforms.worldFromViewMatrix = model;
+    uniforms.viewFromWorldMatrix = inverse(model);
+    uniforms.clipFromWorldMatrix[0] = projection * inverse(model);
+    uniforms.worldFromClipMatrix = model * inverse(projection);
+
+    ColorPassDescriptorSet::lateLatchCamera(uniforms, latched, 1);
+
+    auto mat4eq = [](mat4f const& lhs, mat4f const& rhs) {
+        for (size_t i = 0; i < 4; i++) {
+            for (size_t j = 0; j < 4; j++) {
+                if (std::abs(lhs[i][j] - rhs[i][j]) > 1e-4f) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+    EXPECT_PRED2(mat4eq, latched, uniforms.worldFromViewMatrix);
+    EXPECT_PRED2(mat4eq, inverse(latched), uniforms.viewFromWorldMatrix);
+    EXPECT_PRED2(mat4eq, projection * inverse(latched), uniforms.clipFromWorldMatrix[0]);
+    EXPECT_PRED2(mat4eq, latched * inverse(projection), uniforms.worldFromClipMatrix);
+    EXPECT_PRED2(mat4eq, projection, uniforms.clipFromViewMatrix);
+}
+
 TEST(FilamentTest, ColorConversion) {
     // Linear to Gamma
     // 0.0 stays 0.0
@@ -47,6 +47,12 @@ public:
         utils::CString name;
         std::vector<ResourceId> reads;
         std::vector<ResourceId> writes;
+
+        // Timings of the pass in nanoseconds, or -1 when unknown. These change every frame and
+        // are not compared by operator==. The GPU time is from a few frames ago.
+        int64_t cpuSetupTime = -1;
+        int64_t cpuExecuteTime = -1;
+        int64_t gpuTime = -1;
     };
 
     struct Resource {
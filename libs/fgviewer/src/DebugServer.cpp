@@ -180,13 +180,15 @@ void DebugServer::update(ViewHandle h, FrameGraphInfo info) {
         return;
     }
 
+    // The timings are always kept up to date, but clients are only notified when the graph
+    // itself changed.
     bool has_changed = !(it->second == info);
-    if (!has_changed)
-        return;
 
     mViews.erase(h);
     mViews.emplace(h, std::move(info));
-    mApiHandler->updateFrameGraph(h);
+    if (has_changed) {
+        mApiHandler->updateFrameGraph(h);
+    }
 }
 
 } // namespace filament::fgviewer
@@ -74,7 +74,11 @@ void writePasses(std::ostream& os, const FrameGraphInfo& frameGraph) {
         const std::vector<ResourceId>& writes = pass.writes;
         os << "      \"writes\": [";
         writeResourceIds(os, writes);
-        os << "]\n";
+        os << "],\n";
+
+        os << "      \"cpuSetupTime\": " << pass.cpuSetupTime << ",\n";
+        os << "      \"cpuExecuteTime\": " << pass.cpuExecuteTime << ",\n";
+        os << "      \"gpuTime\": " << pass.gpuTime << "\n";
 
         os << "    }";
         if (i + 1 < passes.size()) os << ",";
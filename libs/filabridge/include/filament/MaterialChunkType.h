@@ -98,6 +98,10 @@ enum UTILS_PUBLIC ChunkType : uint64_t {
     DictionaryText = charTo64bitNum("DIC_TEXT"),
     DictionarySpirv = charTo64bitNum("DIC_SPIR"),
     DictionaryMetalLibrary = charTo64bitNum("DIC_MLIB"),
+
+    // zstd-compressed DictionaryText and DictionarySpirv chunks
+    DictionaryTextZstd = charTo64bitNum("DIC_TXTZ"),
+    DictionarySpirvZstd = charTo64bitNum("DIC_SPVZ"),
 };
 
 } // namespace filamat
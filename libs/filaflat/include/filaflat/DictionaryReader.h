@@ -19,12 +19,77 @@
 
 #include <filaflat/ChunkContainer.h>
 
+#include <utils/compiler.h>
+#include <utils/FixedCapacityVector.h>
+
+#include <mutex>
+#include <string_view>
+
+#include <stddef.h>
+#include <stdint.h>
+
 namespace filaflat {
 
+// Dictionaries can be stored compressed (e.g. DictionaryTextZstd for DictionaryText), which is
+// handled transparently when the library is built with FILAMENT_SUPPORTS_COMPRESSED_MATERIALS.
 struct DictionaryReader {
+    // Returns true if the container has the given dictionary in a form that can be read.
+    static bool hasDictionary(ChunkContainer const& container,
+            ChunkContainer::Type dictionaryTag) noexcept;
+
     static bool unflatten(ChunkContainer const& container,
             ChunkContainer::Type dictionaryTag,
             BlobDictionary& dictionary);
+
+private:
+    static bool unflatten(const uint8_t* start, const uint8_t* end,
+            ChunkContainer::Type dictionaryTag,
+            BlobDictionary& dictionary);
+};
+
+// A dictionary that references its blobs in place in the package, instead of copying (and for
+// SPIR-V, decompressing) all of them like DictionaryReader::unflatten() does.
+//
+// initialize() only records where the dictionary is. The blobs are located the first time one
+// of them is requested; SPIR-V blobs are decompressed on each request directly into the
+// destination. A compressed dictionary is decompressed as a whole at that time. The package must
+// outlive the dictionary. This is thread-safe.
+class UTILS_PUBLIC LazyBlobDictionary {
+public:
+    LazyBlobDictionary() noexcept = default;
+    ~LazyBlobDictionary() noexcept;
+
+    LazyBlobDictionary(LazyBlobDictionary const&) = delete;
+    LazyBlobDictionary& operator=(LazyBlobDictionary const&) = delete;
+
+    void initialize(ChunkContainer const& container, ChunkContainer::Type dictionaryTag) noexcept;
+
+    // For text dictionaries, returns the given line without its trailing null. The returned view
+    // has a null data pointer if the index is invalid.
+    std::string_view getString(size_t index) const noexcept;
+
+    // For binary dictionaries, copies (or decompresses) the given blob into content.
+    bool getBlob(size_t index, ShaderContent& content) const noexcept;
+
+private:
+    struct Blob {
+        const char* data;
+        size_t size;
+    };
+
+    bool buildIndex() const noexcept;
+    Blob const* getIndexedBlob(size_t index) const noexcept;
+
+    ChunkContainer::Type mDictionaryTag = ChunkContainer::Type::Unknown;
+    ChunkContainer const* mContainer = nullptr;
+    bool mCompressed = false;
+    mutable const uint8_t* mStart = nullptr;
+    mutable const uint8_t* mEnd = nullptr;
+    mutable ShaderContent mDecompressed;
+
+    mutable std::once_flag mIndexFlag;
+    mutable utils::FixedCapacityVector<Blob> mBlobs;
+    mutable bool mIndexValid = false;
 };
 
 } // namespace filaflat
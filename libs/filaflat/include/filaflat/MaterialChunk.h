@@ -33,6 +33,8 @@
 
 namespace filaflat {
 
+class LazyBlobDictionary;
+
 class MaterialChunk {
 public:
     using ShaderModel = filament::backend::ShaderModel;
@@ -50,6 +52,10 @@ public:
     bool getShader(ShaderContent& shaderContent, BlobDictionary const& dictionary,
             ShaderModel shaderModel, filament::Variant variant, ShaderStage stage);
 
+    // same as above, but only reads the dictionary entries used by the requested shader
+    bool getShader(ShaderContent& shaderContent, LazyBlobDictionary const& dictionary,
+            ShaderModel shaderModel, filament::Variant variant, ShaderStage stage);
+
     uint32_t getShaderCount() const noexcept;
 
     void visitShaders(utils::Invocable<void(ShaderModel, Variant, ShaderStage)>&& visitor) const;
@@ -70,13 +76,21 @@ private:
     const uint8_t* mBase = nullptr;
     tsl::robin_map<uint32_t, uint32_t> mOffsets;
 
+    // GetLine returns the line at an index as a string_view, without its trailing null
+    template<typename GetLine>
     bool getTextShader(Unflattener unflattener,
-            BlobDictionary const& dictionary, ShaderContent& shaderContent,
+            GetLine const& getLine, ShaderContent& shaderContent,
             ShaderModel shaderModel, filament::Variant variant, ShaderStage shaderStage);
 
+    // GetBlob copies the blob at an index into a ShaderContent, and returns false on failure
+    template<typename GetBlob>
     bool getBinaryShader(
-            BlobDictionary const& dictionary, ShaderContent& shaderContent,
+            GetBlob const& getBlob, ShaderContent& shaderContent,
             ShaderModel shaderModel, filament::Variant variant, ShaderStage shaderStage);
+
+    template<typename GetLine, typename GetBlob>
+    bool getShader(ShaderContent& shaderContent, GetLine const& getLine, GetBlob const& getBlob,
+            ShaderModel shaderModel, filament::Variant variant, ShaderStage stage);
 };
 
 } // namespace filamat
@@ -24,17 +24,98 @@
 #include <smolv.h>
 #endif
 
+#if defined (FILAMENT_SUPPORTS_COMPRESSED_MATERIALS)
+#include <zstd.h>
+#endif
+
 #include <assert.h>
+#include <string.h>
 
 using namespace filamat;
 
 namespace filaflat {
 
+static ChunkContainer::Type getCompressedTag(ChunkContainer::Type dictionaryTag) noexcept {
+    switch (dictionaryTag) {
+        case ChunkType::DictionaryText:
+            return ChunkType::DictionaryTextZstd;
+        case ChunkType::DictionarySpirv:
+            return ChunkType::DictionarySpirvZstd;
+        default:
+            return ChunkType::Unknown;
+    }
+}
+
+static bool hasCompressedDictionary(ChunkContainer const& container,
+        ChunkContainer::Type dictionaryTag) noexcept {
+#if defined (FILAMENT_SUPPORTS_COMPRESSED_MATERIALS)
+    ChunkContainer::Type const compressedTag = getCompressedTag(dictionaryTag);
+    return compressedTag != ChunkType::Unknown && container.hasChunk(compressedTag);
+#else
+    return false;
+#endif
+}
+
+// Decompresses the content of a compressed dictionary chunk, i.e. the chunk the original
+// dictionary would have had.
+static bool decompress(ChunkContainer const& container, ChunkContainer::Type dictionaryTag,
+        ShaderContent& out) noexcept {
+#if defined (FILAMENT_SUPPORTS_COMPRESSED_MATERIALS)
+    auto [start, end] = container.getChunkRange(getCompressedTag(dictionaryTag));
+    if (!start) {
+        return false;
+    }
+    Unflattener unflattener(start, end);
+    uint64_t size;
+    if (!unflattener.read(&size)) {
+        return false;
+    }
+    const uint8_t* const compressed = unflattener.getCursor();
+    size_t const compressedSize = end - compressed;
+    if (ZSTD_getFrameContentSize(compressed, compressedSize) != size) {
+        return false;
+    }
+    // the buffer's alignment is what the dictionary's alignment padding is relative to
+    ShaderContent content(size);
+    size_t const result = ZSTD_decompress(content.data(), content.size(),
+            compressed, compressedSize);
+    if (ZSTD_isError(result) || result != size) {
+        return false;
+    }
+    out = std::move(content);
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool DictionaryReader::hasDictionary(ChunkContainer const& container,
+        ChunkContainer::Type dictionaryTag) noexcept {
+    return container.hasChunk(dictionaryTag) || hasCompressedDictionary(container, dictionaryTag);
+}
+
 bool DictionaryReader::unflatten(ChunkContainer const& container,
         ChunkContainer::Type dictionaryTag,
         BlobDictionary& dictionary) {
 
+    if (!container.hasChunk(dictionaryTag)) {
+        // the dictionary is copied out of the decompressed chunk, which can be discarded after
+        ShaderContent decompressed;
+        if (!decompress(container, dictionaryTag, decompressed)) {
+            return false;
+        }
+        return unflatten(decompressed.data(), decompressed.data() + decompressed.size(),
+                dictionaryTag, dictionary);
+    }
+
     auto [start, end] = container.getChunkRange(dictionaryTag);
+    return unflatten(start, end, dictionaryTag, dictionary);
+}
+
+bool DictionaryReader::unflatten(const uint8_t* start, const uint8_t* end,
+        ChunkContainer::Type dictionaryTag,
+        BlobDictionary& dictionary) {
+
     Unflattener unflattener(start, end);
 
     if (dictionaryTag == ChunkType::DictionarySpirv) {
@@ -120,4 +201,111 @@ bool DictionaryReader::unflatten(ChunkContainer const& container,
     return false;
 }
 
+LazyBlobDictionary::~LazyBlobDictionary() noexcept = default;
+
+void LazyBlobDictionary::initialize(ChunkContainer const& container,
+        ChunkContainer::Type dictionaryTag) noexcept {
+    mDictionaryTag = dictionaryTag;
+    mContainer = &container;
+    mCompressed = !container.hasChunk(dictionaryTag);
+    auto [start, end] = container.getChunkRange(dictionaryTag);
+    mStart = start;
+    mEnd = end;
+}
+
+bool LazyBlobDictionary::buildIndex() const noexcept {
+    if (mCompressed && mContainer) {
+        // The whole dictionary is decompressed on first access, the blobs then reference the
+        // decompressed chunk. Dictionaries that are never accessed are never decompressed.
+        if (!decompress(*mContainer, mDictionaryTag, mDecompressed)) {
+            return false;
+        }
+        mStart = mDecompressed.data();
+        mEnd = mDecompressed.data() + mDecompressed.size();
+    }
+    if (!mStart) {
+        return false;
+    }
+    Unflattener unflattener(mStart, mEnd);
+
+    if (mDictionaryTag == ChunkType::DictionarySpirv) {
+        uint32_t compressionScheme;
+        if (!unflattener.read(&compressionScheme)) {
+            return false;
+        }
+        // For now, 1 is the only acceptable compression scheme.
+        assert(compressionScheme == 1);
+    }
+
+    uint32_t blobCount;
+    if (!unflattener.read(&blobCount)) {
+        return false;
+    }
+
+    mBlobs.reserve(blobCount);
+    for (uint32_t i = 0; i < blobCount; i++) {
+        if (mDictionaryTag == ChunkType::DictionaryText) {
+            const uint8_t* const start = unflattener.getCursor();
+            const char* str;
+            if (!unflattener.read(&str)) {
+                return false;
+            }
+            // the cursor is after the trailing null
+            mBlobs.push_back({ str, size_t(unflattener.getCursor() - start) - 1 });
+        } else {
+            unflattener.skipAlignmentPadding();
+            const char* data;
+            size_t size;
+            if (!unflattener.read(&data, &size)) {
+                return false;
+            }
+            mBlobs.push_back({ data, size });
+        }
+    }
+    return true;
+}
+
+LazyBlobDictionary::Blob const* LazyBlobDictionary::getIndexedBlob(size_t index) const noexcept {
+    std::call_once(mIndexFlag, [this] {
+        mIndexValid = buildIndex();
+    });
+    if (UTILS_UNLIKELY(!mIndexValid || index >= mBlobs.size())) {
+        return nullptr;
+    }
+    return &mBlobs[index];
+}
+
+std::string_view LazyBlobDictionary::getString(size_t index) const noexcept {
+    assert_invariant(mDictionaryTag == ChunkType::DictionaryText);
+    Blob const* const blob = getIndexedBlob(index);
+    return blob ? std::string_view{ blob->data, blob->size } : std::string_view{};
+}
+
+bool LazyBlobDictionary::getBlob(size_t index, ShaderContent& content) const noexcept {
+    Blob const* const blob = getIndexedBlob(index);
+    if (!blob) {
+        return false;
+    }
+
+    if (mDictionaryTag == ChunkType::DictionarySpirv) {
+        assert_invariant((intptr_t(blob->data) % 8) == 0);
+#if defined (FILAMENT_DRIVER_SUPPORTS_VULKAN)
+        size_t const spirvSize = smolv::GetDecodedBufferSize(blob->data, blob->size);
+        if (spirvSize == 0) {
+            return false;
+        }
+        content.reserve(spirvSize);
+        content.resize(spirvSize);
+        return smolv::Decode(blob->data, blob->size, content.data(), spirvSize);
+#else
+        return false;
+#endif
+    }
+
+    content.reserve(blob->size);
+    content.resize(blob->size);
+    memcpy(content.data(), blob->data, blob->size);
+    return true;
+}
+
 } // namespace filaflat
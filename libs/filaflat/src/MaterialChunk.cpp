@@ -16,11 +16,16 @@
 
 #include <filaflat/MaterialChunk.h>
 #include <filaflat/ChunkContainer.h>
+#include <filaflat/DictionaryReader.h>
 
 #include <backend/DriverEnums.h>
 
 #include <utils/Log.h>
 
+#include <string_view>
+
+#include <string.h>
+
 namespace filaflat {
 
 static inline uint32_t makeKey(
@@ -95,8 +100,9 @@ bool MaterialChunk::initialize(filamat::ChunkType materialTag) {
     return true;
 }
 
+template<typename GetLine>
 bool MaterialChunk::getTextShader(Unflattener unflattener,
-        BlobDictionary const& dictionary, ShaderContent& shaderContent,
+        GetLine const& getLine, ShaderContent& shaderContent,
         ShaderModel shaderModel, Variant variant, ShaderStage shaderStage) {
     if (mBase == nullptr) {
         return false;
@@ -138,11 +144,14 @@ bool MaterialChunk::getTextShader(Unflattener unflattener,
         if (!unflattener.read(&lineIndex)) {
             return false;
         }
-        const auto& content = dictionary[lineIndex];
+        std::string_view const content = getLine(lineIndex);
+        if (UTILS_UNLIKELY(!content.data() || cursor + content.size() + 1 >= shaderSize)) {
+            return false;
+        }
 
         // Replace null with newline.
-        memcpy(&shaderContent[cursor], content.data(), content.size() - 1);
-        cursor += content.size() - 1;
+        memcpy(&shaderContent[cursor], content.data(), content.size());
+        cursor += content.size();
         shaderContent[cursor++] = '\n';
     }
 
@@ -153,7 +162,8 @@ bool MaterialChunk::getTextShader(Unflattener unflattener,
     return true;
 }
 
-bool MaterialChunk::getBinaryShader(BlobDictionary const& dictionary,
+template<typename GetBlob>
+bool MaterialChunk::getBinaryShader(GetBlob const& getBlob,
         ShaderContent& shaderContent, ShaderModel shaderModel, filament::Variant variant, ShaderStage shaderStage) {
 
     if (mBase == nullptr) {
@@ -166,8 +176,7 @@ bool MaterialChunk::getBinaryShader(BlobDictionary const& dictionary,
         return false;
     }
 
-    shaderContent = dictionary[pos->second];
-    return true;
+    return getBlob(pos->second, shaderContent);
 }
 
 bool MaterialChunk::hasShader(ShaderModel model, Variant variant, ShaderStage stage) const noexcept {
@@ -178,22 +187,54 @@ bool MaterialChunk::hasShader(ShaderModel model, Variant variant, ShaderStage st
     return pos != mOffsets.end();
 }
 
-bool MaterialChunk::getShader(ShaderContent& shaderContent, BlobDictionary const& dictionary,
+template<typename GetLine, typename GetBlob>
+bool MaterialChunk::getShader(ShaderContent& shaderContent,
+        GetLine const& getLine, GetBlob const& getBlob,
         ShaderModel shaderModel, filament::Variant variant, ShaderStage stage) {
     switch (mMaterialTag) {
         case filamat::ChunkType::MaterialGlsl:
         case filamat::ChunkType::MaterialEssl1:
         case filamat::ChunkType::MaterialWgsl:
         case filamat::ChunkType::MaterialMetal:
-            return getTextShader(mUnflattener, dictionary, shaderContent, shaderModel, variant, stage);
+            return getTextShader(mUnflattener, getLine, shaderContent, shaderModel, variant, stage);
         case filamat::ChunkType::MaterialSpirv:
         case filamat::ChunkType::MaterialMetalLibrary:
-            return getBinaryShader(dictionary, shaderContent, shaderModel, variant, stage);
+            return getBinaryShader(getBlob, shaderContent, shaderModel, variant, stage);
         default:
             return false;
     }
 }
 
+bool MaterialChunk::getShader(ShaderContent& shaderContent, BlobDictionary const& dictionary,
+        ShaderModel shaderModel, filament::Variant variant, ShaderStage stage) {
+    auto getLine = [&dictionary](size_t index) -> std::string_view {
+        if (UTILS_UNLIKELY(index >= dictionary.size() || dictionary[index].empty())) {
+            return {};
+        }
+        auto const& content = dictionary[index];
+        return { (const char*)content.data(), content.size() - 1 };
+    };
+    auto getBlob = [&dictionary](size_t index, ShaderContent& content) {
+        if (UTILS_UNLIKELY(index >= dictionary.size())) {
+            return false;
+        }
+        content = dictionary[index];
+        return true;
+    };
+    return getShader(shaderContent, getLine, getBlob, shaderModel, variant, stage);
+}
+
+bool MaterialChunk::getShader(ShaderContent& shaderContent, LazyBlobDictionary const& dictionary,
+        ShaderModel shaderModel, filament::Variant variant, ShaderStage stage) {
+    auto getLine = [&dictionary](size_t index) {
+        return dictionary.getString(index);
+    };
+    auto getBlob = [&dictionary](size_t index, ShaderContent& content) {
+        return dictionary.getBlob(index, content);
+    };
+    return getShader(shaderContent, getLine, getBlob, shaderModel, variant, stage);
+}
+
 uint32_t MaterialChunk::getShaderCount() const noexcept {
     Unflattener unflattener{ mUnflattener }; // make a copy
     uint64_t numShaders;
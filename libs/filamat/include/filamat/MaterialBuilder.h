@@ -35,6 +35,7 @@
 #include <math/vec3.h>
 
 #include <atomic>
+#include <functional>
 #include <memory>
 #include <string>
 #include <utility>
@@ -283,6 +284,13 @@ public:
 
     MaterialBuilder& noSamplerValidation(bool enabled) noexcept;
 
+    /**
+     * Compress the text and SPIR-V shader dictionaries with zstd. This makes packages smaller,
+     * the dictionaries are decompressed when the material is loaded, which requires a runtime
+     * built with FILAMENT_SUPPORTS_COMPRESSED_MATERIALS. Disabled by default.
+     */
+    MaterialBuilder& compressDictionaries(bool enabled) noexcept;
+
     //! Enable generation of ESSL 1.0 code in FL0 materials.
     MaterialBuilder& includeEssl1(bool enabled) noexcept;
 
@@ -608,6 +616,70 @@ public:
     //! If true, will include debugging information in generated SPIRV.
     MaterialBuilder& generateDebugInfo(bool generateDebugInfo) noexcept;
 
+    /**
+     * Caches the compiled variants in the given directory, which can be shared by many materials
+     * and builders. Variants whose generated code and compilation options are unchanged are then
+     * read from the cache instead of being compiled again; identical variants of different
+     * materials are compiled once. The cache must be cleared when the tools are updated.
+     * Disabled by default.
+     */
+    MaterialBuilder& shaderCacheDirectory(const char* directory) noexcept;
+
+    /**
+     * Additional spirv-opt passes, given as spirv-opt flags separated by spaces (e.g.
+     * "--loop-unroll --strength-reduction"). They run after the passes of the SIZE or
+     * PERFORMANCE optimization levels, and can trade package size for GPU performance.
+     * build() fails if a flag is invalid.
+     */
+    MaterialBuilder& spirvOptimizerPasses(const char* passes) noexcept;
+
+    /**
+     * Compiles Metal Shading Language source into a Metal library (the content of a .metallib
+     * file), returns false if it failed.
+     */
+    using MetalLibraryCompiler = std::function<bool(std::string const& msl,
+            filament::backend::ShaderModel shaderModel, filament::backend::ShaderStage stage,
+            std::vector<uint8_t>& library)>;
+
+    /**
+     * When targeting Metal, also stores the Metal libraries produced by the given compiler. The
+     * runtime prefers them over the MSL source, see Engine::Config::preferredShaderLanguage.
+     * The MSL source is kept as a fallback. If a variant fails to compile, a warning is printed
+     * and only the source is stored. The compiler can be called from several threads.
+     */
+    MaterialBuilder& metalLibraryCompiler(MetalLibraryCompiler compiler) noexcept;
+
+    //! Compilation statistics of a variant, see collectShaderStats().
+    struct ShaderStats {
+        uint8_t variant;
+        filament::backend::ShaderStage stage;
+        filament::backend::ShaderModel shaderModel;
+        TargetApi targetApi;
+        TargetLanguage targetLanguage;
+        filament::backend::FeatureLevel featureLevel;
+        bool cached;            // read from the shader cache
+        // durations in microseconds
+        uint32_t generateTime;  // shader code generation
+        uint32_t parseTime;     // glslang front-end and linking
+        uint32_t optimizeTime;  // SPIR-V generation, optimization and cross-compilation
+        uint32_t minifyTime;    // GLSL minification
+        uint32_t totalTime;
+        // output sizes in bytes, before dictionary compression
+        size_t glslSize;
+        size_t spirvSize;
+        size_t mslSize;
+        size_t wgslSize;
+    };
+
+    /**
+     * If true, build() records the compilation time and output sizes of each variant, which are
+     * returned by getShaderStats(). Disabled by default.
+     */
+    MaterialBuilder& collectShaderStats(bool enabled) noexcept;
+
+    //! Statistics of the last build(), in no particular order.
+    std::vector<ShaderStats> const& getShaderStats() const noexcept { return mShaderStats; }
+
     //! Specifies a list of variants that should be filtered out during code generation.
     MaterialBuilder& variantFilter(filament::UserVariantFilterMask variantFilter) noexcept;
 
@@ -825,7 +897,7 @@ private:
     bool generateShaders(
             utils::JobSystem& jobSystem,
             const std::vector<filamat::Variant>& variants, ChunkContainer& container,
-            const MaterialInfo& info) const noexcept;
+            const MaterialInfo& info, std::vector<ShaderStats>* stats) const noexcept;
 
     bool hasCustomVaryings() const noexcept;
     bool needsStandardDepthProgram() const noexcept;
@@ -834,6 +906,10 @@ private:
 
     utils::CString mMaterialName;
     utils::CString mFileName;
+    utils::CString mShaderCacheDirectory;
+    std::vector<ShaderStats> mShaderStats;
+    std::vector<std::string> mSpirvOptimizerPasses;
+    MetalLibraryCompiler mMetalLibraryCompiler;
 
     class ShaderCode {
     public:
@@ -938,6 +1014,10 @@ private:
     filament::UserVariantFilterMask mVariantFilter = {};
 
     bool mNoSamplerValidation = false;
+
+    bool mCompressDictionaries = false;
+
+    bool mCollectShaderStats = false;
 };
 
 } // namespace filamat
@@ -40,6 +40,7 @@
 
 #include <utils/Log.h>
 
+#include <chrono>
 #include <sstream>
 #include <unordered_map>
 #include <vector>
@@ -292,10 +293,13 @@ static void collectDescriptorSets(const GLSLPostProcessor::Config& config, Descr
 
 } // namespace msl
 
-GLSLPostProcessor::GLSLPostProcessor(MaterialBuilder::Optimization optimization, uint32_t flags)
+GLSLPostProcessor::GLSLPostProcessor(MaterialBuilder::Optimization optimization, uint32_t flags,
+        ShaderCache const* cache, std::vector<std::string> optimizerPasses)
         : mOptimization(optimization),
           mPrintShaders(flags & PRINT_SHADERS),
-          mGenerateDebugInfo(flags & GENERATE_DEBUG_INFO) {
+          mGenerateDebugInfo(flags & GENERATE_DEBUG_INFO),
+          mCache(cache),
+          mOptimizerPasses(std::move(optimizerPasses)) {
     // SPIRV error handler registration needs to occur only once. To avoid a race we do it up here
     // in the constructor, which gets invoked before MaterialBuilder kicks off jobs.
     spv::spirvbin_t::registerErrorHandler([](const std::string& str) {
@@ -559,10 +563,105 @@ bool GLSLPostProcessor::spirvToWgsl(SpirvBlob *spirv, std::string *outWsl) {
 
 }
 
+std::string GLSLPostProcessor::getCacheKey(const std::string& inputShader, Config const& config,
+        ShaderCache::Outputs const& outputs) const {
+    // This must capture everything the outputs depend on: the input, the options and the parts of
+    // the MaterialInfo used to generate the descriptor sets.
+    ShaderCache::KeyBuilder key;
+    key.add(MATERIAL_VERSION)
+            .add(uint64_t(mOptimization))
+            .add(mGenerateDebugInfo)
+            .add(mOptimizerPasses.size());
+    for (auto const& pass : mOptimizerPasses) {
+        key.add(pass);
+    }
+    key
+            .add(uint64_t(outputs.glsl != nullptr) | uint64_t(outputs.spirv != nullptr) << 1 |
+                    uint64_t(outputs.msl != nullptr) << 2 | uint64_t(outputs.wgsl != nullptr) << 3)
+            .add(config.variant.key)
+            .add(config.variantFilter)
+            .add(uint64_t(config.targetApi))
+            .add(uint64_t(config.targetLanguage))
+            .add(uint64_t(config.shaderType))
+            .add(uint64_t(config.shaderModel))
+            .add(uint64_t(config.featureLevel))
+            .add(uint64_t(config.domain))
+            .add(config.hasFramebufferFetch)
+            .add(config.usesClipDistance);
+    key.add(config.glsl.subpassInputToColorLocation.size());
+    for (auto const& [index, location] : config.glsl.subpassInputToColorLocation) {
+        key.add(index).add(location);
+    }
+
+    MaterialInfo const& material = *config.materialInfo;
+    key.add(material.isLit)
+            .add(material.hasShadowMultiplier)
+            .add(uint64_t(material.reflectionMode))
+            .add(uint64_t(material.refractionMode))
+            .add(uint64_t(material.stereoscopicType))
+            .add(material.stereoscopicEyeCount);
+    auto const samplers = material.sib.getSamplerInfoList();
+    key.add(samplers.size());
+    for (auto const& sampler : samplers) {
+        key.add({ sampler.name.c_str_safe(), sampler.name.size() })
+                .add({ sampler.uniformName.c_str_safe(), sampler.uniformName.size() })
+                .add(sampler.binding)
+                .add(uint64_t(sampler.type))
+                .add(uint64_t(sampler.format))
+                .add(uint64_t(sampler.precision))
+                .add(sampler.multisample);
+    }
+
+    key.add(inputShader);
+    return key.get();
+}
+
 bool GLSLPostProcessor::process(const std::string& inputShader, Config const& config,
-                                std::string* outputGlsl, SpirvBlob* outputSpirv, std::string* outputMsl, std::string* outputWgsl) {
+        std::string* outputGlsl, SpirvBlob* outputSpirv, std::string* outputMsl,
+        std::string* outputWgsl, Timings* timings) {
+    // the GLSL target is a copy, and printing the shaders requires running the compiler
+    if (!mCache || mPrintShaders ||
+            config.targetLanguage == MaterialBuilder::TargetLanguage::GLSL) {
+        return processUncached(inputShader, config,
+                outputGlsl, outputSpirv, outputMsl, outputWgsl, timings);
+    }
+
+    ShaderCache::Outputs const outputs{
+            .glsl = outputGlsl, .spirv = outputSpirv, .msl = outputMsl, .wgsl = outputWgsl };
+
+    // outputGlsl can be the input, so the key must be computed first
+    std::string const key = getCacheKey(inputShader, config, outputs);
+    if (mCache->get(key, outputs)) {
+        if (timings) {
+            timings->cached = true;
+        }
+        return true;
+    }
+
+    bool const ok = processUncached(inputShader, config,
+            outputGlsl, outputSpirv, outputMsl, outputWgsl, timings);
+    if (ok) {
+        mCache->put(key, outputs);
+    }
+    return ok;
+}
+
+bool GLSLPostProcessor::processUncached(const std::string& inputShader, Config const& config,
+                                std::string* outputGlsl, SpirvBlob* outputSpirv, std::string* outputMsl, std::string* outputWgsl,
+                                Timings* timings) {
     using TargetLanguage = MaterialBuilder::TargetLanguage;
 
+    // records the time elapsed since the previous call into the given step
+    auto last = std::chrono::steady_clock::now();
+    auto lap = [timings, &last](uint32_t Timings::* step) {
+        if (timings) {
+            auto const now = std::chrono::steady_clock::now();
+            timings->*step += uint32_t(
+                    std::chrono::duration_cast<std::chrono::microseconds>(now - last).count());
+            last = now;
+        }
+    };
+
     if (config.targetLanguage == TargetLanguage::GLSL) {
         *outputGlsl = inputShader;
         if (mPrintShaders) {
@@ -636,6 +735,7 @@ bool GLSLPostProcessor::process(const std::string& inputShader, Config const& co
         slog.e << tShader.getInfoLog() << io::endl;
         return false;
     }
+    lap(&Timings::parse);
 
     switch (mOptimization) {
         case MaterialBuilder::Optimization::NONE:
@@ -678,6 +778,7 @@ bool GLSLPostProcessor::process(const std::string& inputShader, Config const& co
             }
             break;
     }
+    lap(&Timings::optimize);
 
     if (internalConfig.glslOutput) {
         if (!mGenerateDebugInfo) {
@@ -691,6 +792,7 @@ bool GLSLPostProcessor::process(const std::string& inputShader, Config const& co
                 *internalConfig.glslOutput =
                         internalConfig.minifier.renameStructFields(*internalConfig.glslOutput);
             }
+            lap(&Timings::minify);
         }
         if (mPrintShaders) {
             slog.i << *internalConfig.glslOutput << io::endl;
@@ -888,7 +990,7 @@ bool GLSLPostProcessor::fullOptimization(const TShader& tShader,
 }
 
 std::shared_ptr<spvtools::Optimizer> GLSLPostProcessor::createOptimizer(
-        MaterialBuilder::Optimization optimization, Config const& config) {
+        MaterialBuilder::Optimization optimization, Config const& config) const {
     auto optimizer = std::make_shared<spvtools::Optimizer>(SPV_ENV_UNIVERSAL_1_3);
 
     optimizer->SetMessageConsumer([](spv_message_level_t level,
@@ -912,6 +1014,13 @@ std::shared_ptr<spvtools::Optimizer> GLSLPostProcessor::createOptimizer(
         registerPerformancePasses(*optimizer, config);
     }
 
+    if (!mOptimizerPasses.empty()) {
+        // the passes have been validated by MaterialBuilder
+        UTILS_UNUSED_IN_RELEASE bool const ok =
+                optimizer->RegisterPassesFromFlags(mOptimizerPasses);
+        assert_invariant(ok);
+    }
+
     // Metal doesn't support relaxed precision, but does have support for float16 math operations.
     if (config.targetApi == MaterialBuilder::TargetApi::METAL) {
         optimizer->RegisterPass(CreateConvertRelaxedToHalfPass());
@@ -923,6 +1032,15 @@ std::shared_ptr<spvtools::Optimizer> GLSLPostProcessor::createOptimizer(
     return optimizer;
 }
 
+bool GLSLPostProcessor::validateOptimizerPasses(std::vector<std::string> const& passes) {
+    spvtools::Optimizer optimizer(SPV_ENV_UNIVERSAL_1_3);
+    optimizer.SetMessageConsumer([](spv_message_level_t level,
+            const char* source, const spv_position_t& position, const char* message) {
+        slog.e << stringifySpvOptimizerMessage(level, source, position, message) << io::endl;
+    });
+    return optimizer.RegisterPassesFromFlags(passes);
+}
+
 void GLSLPostProcessor::optimizeSpirv(OptimizerPtr optimizer, SpirvBlob& spirv) const {
     if (!optimizer->Run(spirv.data(), spirv.size(), &spirv)) {
         slog.e << "SPIR-V optimizer pass failed" << io::endl;
@@ -22,6 +22,7 @@
 #include <private/filament/Variant.h>
 #include <private/filament/SamplerInterfaceBlock.h>
 
+#include "ShaderCache.h"
 #include "ShaderMinifier.h"
 
 #include <spirv-tools/optimizer.hpp>
@@ -57,7 +58,10 @@ public:
         GENERATE_DEBUG_INFO = 1 << 1,
     };
 
-    GLSLPostProcessor(MaterialBuilder::Optimization optimization, uint32_t flags);
+    // If a cache is given, the outputs of process() are looked up in it first.
+    // optimizerPasses are spirv-opt flags, run after the passes of the optimization level.
+    GLSLPostProcessor(MaterialBuilder::Optimization optimization, uint32_t flags,
+            ShaderCache const* cache = nullptr, std::vector<std::string> optimizerPasses = {});
 
     ~GLSLPostProcessor();
 
@@ -78,11 +82,20 @@ public:
         } glsl;
     };
 
+    // time spent in each step of process(), in microseconds
+    struct Timings {
+        uint32_t parse = 0;     // glslang front-end and linking
+        uint32_t optimize = 0;  // SPIR-V generation, optimization and cross-compilation
+        uint32_t minify = 0;    // GLSL only
+        bool cached = false;    // the outputs were read from the cache
+    };
+
     bool process(const std::string& inputShader, Config const& config,
             std::string* outputGlsl,
             SpirvBlob* outputSpirv,
             std::string* outputMsl,
-            std::string* outputWgsl);
+            std::string* outputWgsl,
+            Timings* timings = nullptr);
 
     // public so backend_test can also use it
     static void spirvToMsl(const SpirvBlob* spirv, std::string* outMsl,
@@ -92,7 +105,20 @@ public:
 
     static bool spirvToWgsl(SpirvBlob* spirv, std::string* outWsl);
 
+    // returns false if the spirv-opt flags are invalid
+    static bool validateOptimizerPasses(std::vector<std::string> const& passes);
+
 private:
+    bool processUncached(const std::string& inputShader, Config const& config,
+            std::string* outputGlsl,
+            SpirvBlob* outputSpirv,
+            std::string* outputMsl,
+            std::string* outputWgsl,
+            Timings* timings);
+
+    std::string getCacheKey(const std::string& inputShader, Config const& config,
+            ShaderCache::Outputs const& outputs) const;
+
     struct InternalConfig {
         std::string* glslOutput = nullptr;
         SpirvBlob* spirvOutput = nullptr;
@@ -114,9 +140,9 @@ private:
      * Retrieve an optimizer instance tuned for the given optimization level and shader configuration.
      */
     using OptimizerPtr = std::shared_ptr<spvtools::Optimizer>;
-    static OptimizerPtr createOptimizer(
+    OptimizerPtr createOptimizer(
             MaterialBuilder::Optimization optimization,
-            Config const& config);
+            Config const& config) const;
 
     static void registerSizePasses(spvtools::Optimizer& optimizer, Config const& config);
     static void registerPerformancePasses(spvtools::Optimizer& optimizer, Config const& config);
@@ -128,6 +154,8 @@ private:
     const MaterialBuilder::Optimization mOptimization;
     const bool mPrintShaders;
     const bool mGenerateDebugInfo;
+    ShaderCache const* const mCache;
+    const std::vector<std::string> mOptimizerPasses;
 };
 
 } // namespace filamat
@@ -25,6 +25,7 @@
 #include "shaders/UibGenerator.h"
 
 #include "GLSLPostProcessor.h"
+#include "ShaderCache.h"
 #include "sca/GLSLTools.h"
 
 #include "shaders/MaterialInfo.h"
@@ -36,8 +37,10 @@
 #include "eiff/MaterialTextChunk.h"
 #include "eiff/MaterialBinaryChunk.h"
 #include "eiff/ChunkContainer.h"
+#include "eiff/CompressedChunk.h"
 #include "eiff/SimpleFieldChunk.h"
 #include "eiff/DictionaryTextChunk.h"
+#include "eiff/DictionaryMetalLibraryChunk.h"
 #include "eiff/DictionarySpirvChunk.h"
 
 #include <private/filament/BufferInterfaceBlock.h>
@@ -57,10 +60,15 @@
 #include <utils/Log.h>
 #include <utils/Mutex.h>
 #include <utils/Panic.h>
+#include <utils/Path.h>
 #include <utils/Hash.h>
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <optional>
+#include <sstream>
+#include <string>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -592,6 +600,11 @@ MaterialBuilder& MaterialBuilder::generateDebugInfo(bool generateDebugInfo) noex
     return *this;
 }
 
+MaterialBuilder& MaterialBuilder::shaderCacheDirectory(const char* directory) noexcept {
+    mShaderCacheDirectory = CString(directory);
+    return *this;
+}
+
 MaterialBuilder& MaterialBuilder::variantFilter(UserVariantFilterMask variantFilter) noexcept {
     mVariantFilter = variantFilter;
     return *this;
@@ -876,13 +889,19 @@ static void showErrorMessage(const char* materialName, filament::Variant variant
 }
 
 bool MaterialBuilder::generateShaders(JobSystem& jobSystem, const std::vector<Variant>& variants,
-        ChunkContainer& container, const MaterialInfo& info) const noexcept {
+        ChunkContainer& container, const MaterialInfo& info,
+        std::vector<ShaderStats>* stats) const noexcept {
     // Create a postprocessor to optimize / compile to Spir-V if necessary.
 
     uint32_t flags = 0;
     flags |= mPrintShaders ? GLSLPostProcessor::PRINT_SHADERS : 0;
     flags |= mGenerateDebugInfo ? GLSLPostProcessor::GENERATE_DEBUG_INFO : 0;
-    GLSLPostProcessor postProcessor(mOptimization, flags);
+    std::optional<ShaderCache> cache;
+    if (!mShaderCacheDirectory.empty()) {
+        cache.emplace(Path(mShaderCacheDirectory.c_str()));
+    }
+    GLSLPostProcessor postProcessor(mOptimization, flags, cache ? &*cache : nullptr,
+            mSpirvOptimizerPasses);
 
     // Start: must be protected by lock
     Mutex entriesLock;
@@ -890,11 +909,16 @@ bool MaterialBuilder::generateShaders(JobSystem& jobSystem, const std::vector<Va
     std::vector<TextEntry> essl1Entries;
     std::vector<BinaryEntry> spirvEntries;
     std::vector<TextEntry> metalEntries;
+    std::vector<BinaryEntry> metalLibraryEntries;
     std::vector<TextEntry> wgslEntries;
     LineDictionary textDictionary;
     BlobDictionary spirvDictionary;
+    BlobDictionary metalLibraryDictionary;
     // End: must be protected by lock
 
+    // Set when a Metal library can't be compiled, only the MSL source is stored then
+    std::atomic_bool metalLibraryFailed(!mMetalLibraryCompiler);
+
     ShaderGenerator sg(mProperties, mVariables, mOutputs, mDefines, mConstants, mPushConstants,
             mMaterialFragmentCode.getResolved(), mMaterialFragmentCode.getLineOffset(),
             mMaterialVertexCode.getResolved(), mMaterialVertexCode.getLineOffset(),
@@ -957,6 +981,12 @@ bool MaterialBuilder::generateShaders(JobSystem& jobSystem, const std::vector<Va
                 metalEntry.variant = v.variant;
                 wgslEntry.variant = v.variant;
 
+                using clock = std::chrono::steady_clock;
+                auto const microseconds = [](clock::duration const d) {
+                    return uint32_t(std::chrono::duration_cast<std::chrono::microseconds>(d).count());
+                };
+                auto const startTime = clock::now();
+
                 // Generate raw shader code.
                 // The quotes in Google-style line directives cause problems with certain drivers. These
                 // directives are optimized away when using the full filamat, so down below we
@@ -1024,7 +1054,10 @@ bool MaterialBuilder::generateShaders(JobSystem& jobSystem, const std::vector<Va
                     config.glsl.subpassInputToColorLocation.emplace_back(0, 0);
                 }
 
-                bool const ok = postProcessor.process(shader, config, pGlsl, pSpirv, pMsl, pWgsl);
+                auto const generateTime = clock::now() - startTime;
+                GLSLPostProcessor::Timings timings;
+                bool const ok = postProcessor.process(shader, config, pGlsl, pSpirv, pMsl, pWgsl,
+                        stats ? &timings : nullptr);
                 if (!ok) {
                     showErrorMessage(mMaterialName.c_str_safe(), v.variant, targetApi, v.stage,
                                      featureLevel, shader);
@@ -1042,6 +1075,21 @@ bool MaterialBuilder::generateShaders(JobSystem& jobSystem, const std::vector<Va
                     }
                 }
 
+                BinaryEntry metalLibraryEntry{};
+                if (targetApiNeedsMsl && !metalLibraryFailed.load()) {
+                    if (mMetalLibraryCompiler(msl, shaderModel, v.stage, metalLibraryEntry.data) &&
+                            !metalLibraryEntry.data.empty()) {
+                        metalLibraryEntry.shaderModel = params.shaderModel;
+                        metalLibraryEntry.variant = v.variant;
+                        metalLibraryEntry.stage = v.stage;
+                    } else if (!metalLibraryFailed.exchange(true)) {
+                        slog.w << "Warning: material " << mMaterialName.c_str_safe()
+                               << " variant " << +v.variant.key
+                               << " could not be compiled to a Metal library,"
+                                  " only the MSL source is stored." << io::endl;
+                    }
+                }
+
                 // NOTE: Everything below touches shared structures protected by a lock
                 // NOTE: do not execute expensive work from here on!
                 std::unique_lock<Mutex> const lock(entriesLock);
@@ -1049,6 +1097,27 @@ bool MaterialBuilder::generateShaders(JobSystem& jobSystem, const std::vector<Va
                 // below we rely on casting ShaderStage to uint8_t
                 static_assert(sizeof(filament::backend::ShaderStage) == 1);
 
+                if (stats) {
+                    stats->push_back({
+                            .variant = v.variant.key,
+                            .stage = v.stage,
+                            .shaderModel = shaderModel,
+                            .targetApi = targetApi,
+                            .targetLanguage = targetLanguage,
+                            .featureLevel = featureLevel,
+                            .cached = timings.cached,
+                            .generateTime = microseconds(generateTime),
+                            .parseTime = timings.parse,
+                            .optimizeTime = timings.optimize,
+                            .minifyTime = timings.minify,
+                            .totalTime = microseconds(clock::now() - startTime),
+                            .glslSize = targetApiNeedsGlsl ? shader.size() : 0,
+                            .spirvSize = spirv.size() * sizeof(uint32_t),
+                            .mslSize = msl.size(),
+                            .wgslSize = wgsl.size(),
+                    });
+                }
+
 
                 switch (targetApi) {
                     case TargetApi::WEBGPU:
@@ -1085,6 +1154,9 @@ bool MaterialBuilder::generateShaders(JobSystem& jobSystem, const std::vector<Va
                         metalEntry.stage = v.stage;
                         metalEntry.shader = msl;
                         metalEntries.push_back(metalEntry);
+                        if (!metalLibraryEntry.data.empty()) {
+                            metalLibraryEntries.push_back(std::move(metalLibraryEntry));
+                        }
                         break;
                 }
             });
@@ -1119,6 +1191,7 @@ bool MaterialBuilder::generateShaders(JobSystem& jobSystem, const std::vector<Va
     std::sort(essl1Entries.begin(), essl1Entries.end(), compare);
     std::sort(spirvEntries.begin(), spirvEntries.end(), compare);
     std::sort(metalEntries.begin(), metalEntries.end(), compare);
+    std::sort(metalLibraryEntries.begin(), metalLibraryEntries.end(), compare);
     std::sort(wgslEntries.begin(), wgslEntries.end(), compare);
 
     // Generate the dictionaries.
@@ -1135,13 +1208,31 @@ bool MaterialBuilder::generateShaders(JobSystem& jobSystem, const std::vector<Va
     for (const auto& s : metalEntries) {
         textDictionary.addText(s.shader);
     }
+    if (metalLibraryFailed.load()) {
+        metalLibraryEntries.clear();
+    }
+    for (auto& s : metalLibraryEntries) {
+        std::vector<uint8_t> library = std::move(s.data);
+        s.dictionaryIndex = metalLibraryDictionary.addBlob(library);
+    }
     for (const auto& s : wgslEntries) {
         textDictionary.addText(s.shader);
     }
 
+    // Emits a dictionary chunk, compressed if requested. The uncompressed chunk stays alive
+    // either way, the shader chunks below reference its dictionary.
+    auto pushDictionary = [&](std::unique_ptr<Chunk> chunk, ChunkType compressedType) {
+        if (mCompressDictionaries) {
+            chunk = std::make_unique<CompressedChunk>(std::move(chunk), compressedType);
+        }
+        container.push(std::move(chunk));
+    };
+
     // Emit dictionary chunk (TextDictionaryReader and DictionaryTextChunk)
-    const auto& dictionaryChunk = container.push<filamat::DictionaryTextChunk>(
+    auto textDictionaryChunk = std::make_unique<filamat::DictionaryTextChunk>(
             std::move(textDictionary), ChunkType::DictionaryText);
+    const auto& dictionaryChunk = *textDictionaryChunk;
+    pushDictionary(std::move(textDictionaryChunk), ChunkType::DictionaryTextZstd);
 
     // Emit GLSL chunk (MaterialTextChunk).
     if (!glslEntries.empty()) {
@@ -1158,7 +1249,8 @@ bool MaterialBuilder::generateShaders(JobSystem& jobSystem, const std::vector<Va
     // Emit SPIRV chunks (SpirvDictionaryReader and MaterialBinaryChunk).
     if (!spirvEntries.empty()) {
         const bool stripInfo = !mGenerateDebugInfo;
-        container.push<filamat::DictionarySpirvChunk>(std::move(spirvDictionary), stripInfo);
+        pushDictionary(std::make_unique<filamat::DictionarySpirvChunk>(
+                std::move(spirvDictionary), stripInfo), ChunkType::DictionarySpirvZstd);
         container.push<MaterialBinaryChunk>(std::move(spirvEntries), ChunkType::MaterialSpirv);
     }
 
@@ -1168,6 +1260,13 @@ bool MaterialBuilder::generateShaders(JobSystem& jobSystem, const std::vector<Va
                 dictionaryChunk.getDictionary(), ChunkType::MaterialMetal);
     }
 
+    // Emit Metal library chunks (DictionaryMetalLibraryChunk and MaterialBinaryChunk).
+    if (!metalLibraryEntries.empty()) {
+        container.push<DictionaryMetalLibraryChunk>(std::move(metalLibraryDictionary));
+        container.push<MaterialBinaryChunk>(std::move(metalLibraryEntries),
+                ChunkType::MaterialMetalLibrary);
+    }
+
     // Emit WGSL chunk (MaterialTextChunk).
     if (!wgslEntries.empty()) {
         container.push<MaterialTextChunk>(std::move(wgslEntries),
@@ -1343,7 +1442,14 @@ error:
             break;
     }
 
-    success = generateShaders(jobSystem, variants, container, info);
+    if (!GLSLPostProcessor::validateOptimizerPasses(mSpirvOptimizerPasses)) {
+        slog.e << "Error: invalid SPIR-V optimizer passes." << io::endl;
+        goto error;
+    }
+
+    mShaderStats.clear();
+    success = generateShaders(jobSystem, variants, container, info,
+            mCollectShaderStats ? &mShaderStats : nullptr);
     if (!success) {
         // Return an empty package to signal a failure to build the material.
         goto error;
@@ -1714,6 +1820,30 @@ MaterialBuilder& MaterialBuilder::noSamplerValidation(bool enabled) noexcept {
     return *this;
 }
 
+MaterialBuilder& MaterialBuilder::compressDictionaries(bool enabled) noexcept {
+    mCompressDictionaries = enabled;
+    return *this;
+}
+
+MaterialBuilder& MaterialBuilder::spirvOptimizerPasses(const char* passes) noexcept {
+    mSpirvOptimizerPasses.clear();
+    std::istringstream stream(passes ? passes : "");
+    for (std::string pass; stream >> pass;) {
+        mSpirvOptimizerPasses.push_back(std::move(pass));
+    }
+    return *this;
+}
+
+MaterialBuilder& MaterialBuilder::metalLibraryCompiler(MetalLibraryCompiler compiler) noexcept {
+    mMetalLibraryCompiler = std::move(compiler);
+    return *this;
+}
+
+MaterialBuilder& MaterialBuilder::collectShaderStats(bool enabled) noexcept {
+    mCollectShaderStats = enabled;
+    return *this;
+}
+
 MaterialBuilder& MaterialBuilder::includeEssl1(bool enabled) noexcept {
     mIncludeEssl1 = enabled;
     return *this;
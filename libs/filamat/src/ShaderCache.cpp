@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ShaderCache.h"
+
+#include <utils/Hash.h>
+#include <utils/Log.h>
+#include <utils/Path.h>
+
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace filamat {
+
+using namespace utils;
+
+static constexpr uint32_t CACHE_MAGIC = 0x4353'4d46; // "FMSC"
+static constexpr uint32_t CACHE_VERSION = 1;
+
+ShaderCache::KeyBuilder& ShaderCache::KeyBuilder::add(uint64_t const value) noexcept {
+    mKey.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    return *this;
+}
+
+ShaderCache::KeyBuilder& ShaderCache::KeyBuilder::add(std::string_view const str) noexcept {
+    // the size makes the concatenation of the strings unambiguous
+    add(str.size());
+    mKey.append(str);
+    return *this;
+}
+
+ShaderCache::ShaderCache(Path directory) : mDirectory(std::move(directory)) {
+    if (!mDirectory.exists() && !mDirectory.mkdirRecursive()) {
+        slog.w << "Unable to create the shader cache directory " << mDirectory.c_str() << io::endl;
+    }
+}
+
+Path ShaderCache::getEntryPath(std::string const& key) const noexcept {
+    auto const* const data = reinterpret_cast<const uint8_t*>(key.data());
+    uint64_t const hash = uint64_t(hash::murmurSlow(data, key.size(), 0)) << 32 |
+            hash::murmurSlow(data, key.size(), 0x9e3779b9u);
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.shader", (unsigned long long)hash);
+    return mDirectory + Path(name);
+}
+
+namespace {
+
+// Reads from an entry, all reads fail once one has.
+class EntryReader {
+public:
+    explicit EntryReader(std::string_view const data) noexcept : mData(data) {}
+
+    bool read(void* const out, size_t const size) noexcept {
+        if (!mValid || mData.size() - mOffset < size) {
+            mValid = false;
+            return false;
+        }
+        memcpy(out, mData.data() + mOffset, size);
+        mOffset += size;
+        return true;
+    }
+
+    template<typename T>
+    bool read(T* const out) noexcept {
+        return read(out, sizeof(T));
+    }
+
+    // reads a block of the given size, without copying it
+    std::string_view readView(size_t const size) noexcept {
+        if (!mValid || mData.size() - mOffset < size) {
+            mValid = false;
+            return {};
+        }
+        std::string_view const view = mData.substr(mOffset, size);
+        mOffset += size;
+        return view;
+    }
+
+private:
+    std::string_view mData;
+    size_t mOffset = 0;
+    bool mValid = true;
+};
+
+template<typename T>
+bool readOutput(EntryReader& reader, T* const output) noexcept {
+    uint8_t present = 0;
+    if (!reader.read(&present)) {
+        return false;
+    }
+    if (!present) {
+        // the entry must have all the requested outputs
+        return output == nullptr;
+    }
+    uint64_t size = 0;
+    if (!reader.read(&size)) {
+        return false;
+    }
+    std::string_view const data = reader.readView(size);
+    if (data.size() != size || size % sizeof(typename T::value_type)) {
+        return false;
+    }
+    if (output) {
+        output->resize(size / sizeof(typename T::value_type));
+        memcpy(output->data(), data.data(), size);
+    }
+    return true;
+}
+
+template<typename T>
+void writeOutput(std::string& entry, T const* const output) noexcept {
+    entry.push_back(output ? 1 : 0);
+    if (output) {
+        uint64_t const size = output->size() * sizeof(typename T::value_type);
+        entry.append(reinterpret_cast<const char*>(&size), sizeof(size));
+        entry.append(reinterpret_cast<const char*>(output->data()), size);
+    }
+}
+
+} // anonymous namespace
+
+bool ShaderCache::get(std::string const& key, Outputs const& outputs) const noexcept {
+    std::ifstream in(getEntryPath(key).c_str(), std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    std::string const entry{ std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+
+    EntryReader reader(entry);
+    uint32_t magic = 0, version = 0;
+    uint64_t keySize = 0;
+    if (!reader.read(&magic) || magic != CACHE_MAGIC ||
+            !reader.read(&version) || version != CACHE_VERSION ||
+            !reader.read(&keySize) || reader.readView(keySize) != key) {
+        return false;
+    }
+
+    // read into temporaries, so the outputs are untouched on failure
+    std::string glsl, msl, wgsl;
+    std::vector<uint32_t> spirv;
+    if (!readOutput(reader, outputs.glsl ? &glsl : nullptr) ||
+            !readOutput(reader, outputs.spirv ? &spirv : nullptr) ||
+            !readOutput(reader, outputs.msl ? &msl : nullptr) ||
+            !readOutput(reader, outputs.wgsl ? &wgsl : nullptr)) {
+        return false;
+    }
+
+    if (outputs.glsl) *outputs.glsl = std::move(glsl);
+    if (outputs.spirv) *outputs.spirv = std::move(spirv);
+    if (outputs.msl) *outputs.msl = std::move(msl);
+    if (outputs.wgsl) *outputs.wgsl = std::move(wgsl);
+    return true;
+}
+
+void ShaderCache::put(std::string const& key, Outputs const& outputs) const noexcept {
+    std::string entry;
+    uint64_t const keySize = key.size();
+    entry.append(reinterpret_cast<const char*>(&CACHE_MAGIC), sizeof(CACHE_MAGIC));
+    entry.append(reinterpret_cast<const char*>(&CACHE_VERSION), sizeof(CACHE_VERSION));
+    entry.append(reinterpret_cast<const char*>(&keySize), sizeof(keySize));
+    entry.append(key);
+    writeOutput(entry, outputs.glsl);
+    writeOutput(entry, outputs.spirv);
+    writeOutput(entry, outputs.msl);
+    writeOutput(entry, outputs.wgsl);
+
+    // Several jobs, or processes, can write the same entry at the same time, each one writes its
+    // own temporary file which is then renamed, so readers never see a partial entry.
+    Path const path = getEntryPath(key);
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), ".%08x.tmp", std::random_device{}());
+    std::string const tmp = path.getPath() + suffix;
+    {
+        std::ofstream out(tmp, std::ios::binary);
+        if (!out.write(entry.data(), std::streamsize(entry.size()))) {
+            out.close();
+            remove(tmp.c_str());
+            return;
+        }
+    }
+    if (rename(tmp.c_str(), path.c_str()) != 0) {
+        remove(tmp.c_str());
+    }
+}
+
+} // namespace filamat
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMAT_SHADERCACHE_H
+#define TNT_FILAMAT_SHADERCACHE_H
+
+#include <utils/Path.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <stdint.h>
+
+namespace filamat {
+
+// On-disk cache of the outputs of GLSLPostProcessor, shared by all the materials (and matc
+// processes) using the same directory.
+//
+// Entries are keyed by an opaque byte string, which must capture everything the outputs depend
+// on. Each entry is stored in its own file, named after a hash of the key, and the key itself is
+// stored in the file and compared on lookup, so hash collisions can't return wrong shaders.
+// Entries are written to a temporary file first and renamed, so concurrent writers are safe.
+// The cache doesn't know which version of the compiler produced an entry beyond what's in the
+// key, it must be cleared when the tools are updated.
+class ShaderCache {
+public:
+    class KeyBuilder {
+    public:
+        KeyBuilder& add(uint64_t value) noexcept;
+        KeyBuilder& add(std::string_view str) noexcept;
+        std::string const& get() const noexcept { return mKey; }
+    private:
+        std::string mKey;
+    };
+
+    // Outputs to read and write, null outputs aren't stored.
+    struct Outputs {
+        std::string* glsl;
+        std::vector<uint32_t>* spirv;
+        std::string* msl;
+        std::string* wgsl;
+    };
+
+    // The directory is created if needed.
+    explicit ShaderCache(utils::Path directory);
+
+    // Returns true and fills the outputs if the entry exists and has all the requested outputs.
+    bool get(std::string const& key, Outputs const& outputs) const noexcept;
+
+    void put(std::string const& key, Outputs const& outputs) const noexcept;
+
+private:
+    utils::Path getEntryPath(std::string const& key) const noexcept;
+
+    utils::Path mDirectory;
+};
+
+} // namespace filamat
+
+#endif // TNT_FILAMAT_SHADERCACHE_H
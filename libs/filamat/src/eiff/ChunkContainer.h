@@ -43,6 +43,10 @@ public:
         return *chunk;
     }
 
+    const Chunk& push(std::unique_ptr<Chunk> chunk) {
+        return *mChildren.emplace_back(std::move(chunk));
+    }
+
     // Helper method to add a SimpleFieldChunk to this ChunkContainer.
     template <typename T, typename... Args>
     const SimpleFieldChunk<T>& emplace(Args&&... args) {
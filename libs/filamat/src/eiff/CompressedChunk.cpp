@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CompressedChunk.h"
+
+#include <utils/Log.h>
+
+#include <zstd.h>
+
+#include <utility>
+
+namespace filamat {
+
+// zstd's "ultra" levels use a lot more memory to decompress, stay below them.
+static constexpr int COMPRESSION_LEVEL = 19;
+
+CompressedChunk::CompressedChunk(std::unique_ptr<Chunk> chunk, ChunkType compressedType) :
+        Chunk(compressedType), mChunk(std::move(chunk)) {
+
+    size_t const size = [this]() {
+        Flattener& dryRunner = Flattener::getDryRunner();
+        mChunk->flatten(dryRunner);
+        return dryRunner.getBytesWritten();
+    }();
+
+    // The alignment padding written by the chunk is relative to the start of this buffer, which
+    // is also how the reader decompresses it.
+    std::vector<uint8_t> uncompressed(size);
+    Flattener flattener(uncompressed.data());
+    mChunk->flatten(flattener);
+    mUncompressedSize = size;
+
+    mCompressed.resize(ZSTD_compressBound(size));
+    size_t const compressedSize = ZSTD_compress(mCompressed.data(), mCompressed.size(),
+            uncompressed.data(), uncompressed.size(), COMPRESSION_LEVEL);
+    if (ZSTD_isError(compressedSize)) {
+        utils::slog.e << "Error with dictionary compression: "
+                << ZSTD_getErrorName(compressedSize) << utils::io::endl;
+        mCompressed.clear();
+        return;
+    }
+    mCompressed.resize(compressedSize);
+}
+
+void CompressedChunk::flatten(Flattener& f) {
+    f.writeUint64(mUncompressedSize);
+    f.writeRaw(reinterpret_cast<const char*>(mCompressed.data()), mCompressed.size());
+}
+
+} // namespace filamat
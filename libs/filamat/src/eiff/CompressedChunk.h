@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMAT_COMPRESSED_CHUNK_H
+#define TNT_FILAMAT_COMPRESSED_CHUNK_H
+
+#include "Chunk.h"
+#include "Flattener.h"
+
+#include <memory>
+#include <vector>
+
+#include <stdint.h>
+
+namespace filamat {
+
+// Stores another chunk compressed with zstd, under a different chunk type. The payload is the
+// size of the uncompressed chunk (uint64) followed by a single zstd frame.
+//
+// The chunk is flattened and compressed when it's constructed, so it must be complete by then.
+// It's kept alive afterward so that other chunks can still reference its content.
+class CompressedChunk final : public Chunk {
+public:
+    CompressedChunk(std::unique_ptr<Chunk> chunk, ChunkType compressedType);
+    ~CompressedChunk() = default;
+
+private:
+    void flatten(Flattener& f) override;
+
+    std::unique_ptr<Chunk> mChunk;
+    std::vector<uint8_t> mCompressed;
+    uint64_t mUncompressedSize = 0;
+};
+
+} // namespace filamat
+
+#endif // TNT_FILAMAT_COMPRESSED_CHUNK_H
@@ -18,11 +18,16 @@
 #define TNT_GEOMETRY_TANGENTSPACEMESH_H
 
 #include <math/quat.h>
+#include <math/vec2.h>
 #include <math/vec3.h>
 #include <math/vec4.h>
 
 #include <variant>
 
+namespace utils {
+class JobSystem;
+} // namespace utils
+
 namespace filament {
 namespace geometry {
 
@@ -223,6 +228,17 @@ public:
          */
         Builder& algorithm(Algorithm algorithm) noexcept;
 
+        /**
+         * Optionally splits the work of large meshes across the given JobSystem. This applies to
+         * the per-vertex and per-triangle passes of all algorithms except MIKKTSPACE, which runs
+         * on a single thread. build() must then be called from a thread known to the JobSystem,
+         * i.e. one of its workers or an adopted thread.
+         *
+         * @param jobSystem The JobSystem to use, or nullptr to compute on the calling thread.
+         * @return Builder
+         */
+        Builder& jobSystem(utils::JobSystem* jobSystem) noexcept;
+
         /**
          * Computes the tangent space mesh. The resulting mesh object is owned by the callee. The
          * callee must call TangentSpaceMesh::destroy on the object once they are finished with it.
@@ -279,6 +295,20 @@ public:
      */
     void getPositions(filament::math::float3* out, size_t stride = 0) const;
 
+    /**
+     * Get output vertex positions quantized to normalized 16-bit signed integers relative to
+     * their bounding box. The original positions are recovered with
+     * `offset + scale * position.xyz`, which is typically folded into the transform of the
+     * renderable. The w component is set to 1.
+     *
+     * @param  out    Client-allocated array that will be used for copying out positions.
+     * @param  offset Center of the bounding box of the positions.
+     * @param  scale  Half-extent of the bounding box of the positions.
+     * @param  stride Stride for iterating through `out`
+     */
+    void getPositions(filament::math::short4* out, filament::math::float3* offset,
+            filament::math::float3* scale, size_t stride = 0) const;
+
     /**
      * Get output UVs.
      * Assumes the `out` param is at least of getVertexCount() length (while accounting for
@@ -291,6 +321,23 @@ public:
      */
     void getUVs(filament::math::float2* out, size_t stride = 0) const;
 
+    /**
+     * Get output UVs in 16-bit normalized unsigned integers. UVs outside of [0, 1] are clamped,
+     * use the half-float variant for repeating UVs.
+     *
+     * @param  out    Client-allocated array that will be used for copying out UVs.
+     * @param  stride Stride for iterating through `out`
+     */
+    void getUVs(filament::math::ushort2* out, size_t stride = 0) const;
+
+    /**
+     * Get output UVs in 16-bit floating points.
+     *
+     * @param  out    Client-allocated array that will be used for copying out UVs.
+     * @param  stride Stride for iterating through `out`
+     */
+    void getUVs(filament::math::half2* out, size_t stride = 0) const;
+
     /**
      * Get output tangent space.
      * Assumes the `out` param is at least of getVertexCount() length (while accounting for
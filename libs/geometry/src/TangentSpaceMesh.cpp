@@ -22,11 +22,25 @@
 #include <math/mat3.h>
 #include <math/norm.h>
 
+#include <utils/JobSystem.h>
 #include <utils/Log.h>
 #include <utils/Panic.h>
 
+#include <limits>
 #include <vector>
 
+#include <float.h>
+
+// SSE2 is part of the x86-64 baseline and NEON is mandatory on AArch64, so the quaternion packing
+// kernels are selected at compile time.
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#   include <arm_neon.h>
+#   define GEOMETRY_TSPACE_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define GEOMETRY_TSPACE_SSE2 1
+#endif
+
 namespace filament {
 namespace geometry {
 
@@ -49,6 +63,53 @@ constexpr uint8_t const POSITIONS_INDICES = POSITIONS_BIT | INDICES_BIT;
 constexpr uint8_t const NORMALS_UVS_POSITIONS_INDICES = NORMALS_BIT | UVS_BIT | POSITIONS_BIT | INDICES_BIT;
 constexpr uint8_t const NORMALS_TANGENTS = NORMALS_BIT | TANGENTS_BIT;
 
+// Number of vertices or triangles below which a pass isn't split into jobs.
+constexpr size_t const JOBS_PARALLEL_FOR_COUNT = 4096;
+
+// Calls work(first, count) over [0, count), split across the JobSystem when one is provided.
+template<typename F>
+void parallelFor(utils::JobSystem* js, size_t const count, F const& work) {
+    if (!js || count <= JOBS_PARALLEL_FOR_COUNT) {
+        work(0u, uint32_t(count));
+        return;
+    }
+    auto* job = utils::jobs::parallel_for(*js, nullptr, 0, uint32_t(count), std::cref(work),
+            utils::jobs::CountSplitter<JOBS_PARALLEL_FOR_COUNT>());
+    js->runAndWait(job);
+}
+
+// Packs quaternions into normalized shorts, rounding half away from zero like packSnorm16().
+void packQuats(quatf const* UTILS_RESTRICT in, short4* out, size_t const count,
+        size_t const stride) noexcept {
+#if defined(GEOMETRY_TSPACE_NEON)
+    float32x4_t const one = vdupq_n_f32(1.0f);
+    float32x4_t const minusOne = vdupq_n_f32(-1.0f);
+    for (size_t i = 0; i < count; ++i) {
+        float32x4_t q = vld1q_f32(&in[i].x);
+        q = vmulq_n_f32(vminq_f32(vmaxq_f32(q, minusOne), one), 32767.0f);
+        vst1_s16(&pointerAdd(out, i, stride)->x, vmovn_s32(vcvtaq_s32_f32(q)));
+    }
+#elif defined(GEOMETRY_TSPACE_SSE2)
+    __m128 const one = _mm_set1_ps(1.0f);
+    __m128 const minusOne = _mm_set1_ps(-1.0f);
+    __m128 const scale = _mm_set1_ps(32767.0f);
+    __m128 const half = _mm_set1_ps(0.5f);
+    __m128 const signMask = _mm_set1_ps(-0.0f);
+    for (size_t i = 0; i < count; ++i) {
+        __m128 q = _mm_loadu_ps(&in[i].x);
+        q = _mm_mul_ps(_mm_min_ps(_mm_max_ps(q, minusOne), one), scale);
+        // truncate q + copysign(0.5, q)
+        q = _mm_add_ps(q, _mm_or_ps(half, _mm_and_ps(q, signMask)));
+        __m128i const v = _mm_cvttps_epi32(q);
+        _mm_storel_epi64((__m128i*) pointerAdd(out, i, stride), _mm_packs_epi32(v, v));
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+        *pointerAdd(out, i, stride) = packSnorm16(in[i].xyzw);
+    }
+#endif
+}
+
 std::string_view to_string(Algorithm const algorithm) noexcept {
     switch (algorithm) {
         case Algorithm::DEFAULT:
@@ -190,12 +251,13 @@ void frisvadMethod(TangentSpaceMeshInput const* input, TangentSpaceMeshOutput* o
     float3 const* UTILS_RESTRICT normals = input->normals();
     size_t const nstride = input->normalsStride();
 
-    for (size_t qindex = 0; qindex < vertexCount; ++qindex) {
-        float3 const n = *normals;
-        auto const [b, t] = frisvadKernel(n);
-        quats[qindex] = mat3f::packTangentFrame({t, b, n}, sizeof(int32_t));
-        normals = pointerAdd(normals, 1, nstride);
-    }
+    parallelFor(input->jobSystem, vertexCount, [=](uint32_t first, uint32_t count) {
+        for (size_t qindex = first; qindex < first + count; ++qindex) {
+            float3 const n = *pointerAdd(normals, qindex, nstride);
+            auto const [b, t] = frisvadKernel(n);
+            quats[qindex] = mat3f::packTangentFrame({t, b, n}, sizeof(int32_t));
+        }
+    });
     output->vertexCount = input->vertexCount;
     output->triangleCount = input->triangleCount;
     output->passthrough(input->attributeData, {AttributeImpl::UV0, AttributeImpl::POSITIONS});
@@ -212,21 +274,22 @@ void hughesMollerMethod(TangentSpaceMeshInput const* input, TangentSpaceMeshOutp
     float3 const* UTILS_RESTRICT normals = input->normals();
     size_t const nstride = input->normalsStride();
 
-    for (size_t qindex = 0; qindex < vertexCount; ++qindex) {
-        float3 const n = *normals;
-        float3 b, t;
+    parallelFor(input->jobSystem, vertexCount, [=](uint32_t first, uint32_t count) {
+        for (size_t qindex = first; qindex < first + count; ++qindex) {
+            float3 const n = *pointerAdd(normals, qindex, nstride);
+            float3 b, t;
 
-        if (abs(n.x) > abs(n.z) + std::numeric_limits<float>::epsilon()) {
-            t = float3{-n.y, n.x, 0.0f};
-        } else {
-            t = float3{0.0f, -n.z, n.y};
-        }
-        t = normalize(t);
-        b = cross(n, t);
+            if (abs(n.x) > abs(n.z) + std::numeric_limits<float>::epsilon()) {
+                t = float3{-n.y, n.x, 0.0f};
+            } else {
+                t = float3{0.0f, -n.z, n.y};
+            }
+            t = normalize(t);
+            b = cross(n, t);
 
-        quats[qindex] = mat3f::packTangentFrame({t, b, n}, sizeof(int32_t));
-        normals = pointerAdd(normals, 1, nstride);
-    }
+            quats[qindex] = mat3f::packTangentFrame({t, b, n}, sizeof(int32_t));
+        }
+    });
     output->vertexCount = input->vertexCount;
     output->triangleCount = input->triangleCount;
     output->passthrough(input->attributeData, {AttributeImpl::UV0, AttributeImpl::POSITIONS});
@@ -309,66 +372,67 @@ void flatShadingMethod(TangentSpaceMeshInput const* input, TangentSpaceMeshOutpu
     size_t const outTriangleCount = triangleCount;
     uint3* outTriangles = output->triangles32.allocate(outTriangleCount);
 
-    size_t vindex = 0;
-    for (size_t tindex = 0; tindex < triangleCount; ++tindex) {
-        uint3 tri = isTriangle16 ?
-                uint3(*(ushort3*)(pointerAdd(triangles, tindex, tstride))) :
-                *(uint3*)(pointerAdd(triangles, tindex, tstride));
-
-        float3 const pa = *pointerAdd(positions, tri.x, pstride);
-        float3 const pb = *pointerAdd(positions, tri.y, pstride);
-        float3 const pc = *pointerAdd(positions, tri.z, pstride);
-
-        uint32_t i0 = vindex++, i1 = vindex++, i2 = vindex++;
-        outTriangles[tindex] = uint3{i0, i1, i2};
-
-        outPositions[i0] = pa;
-        outPositions[i1] = pb;
-        outPositions[i2] = pc;
-
-        float3 const n = normalize(cross(pc - pb, pa - pb));
-        const auto [t, b] = frisvadKernel(n);
-
-        quatf const tspace = mat3f::packTangentFrame({t, b, n}, sizeof(int32_t));
-        quats[i0] = tspace;
-        quats[i1] = tspace;
-        quats[i2] = tspace;
-
-        // We need to make sure that the aux data is ported to the new mesh
-        for (auto& [indata, outdata, attrib, stride]: outAttributes) {
-            if (std::holds_alternative<float2 const*>(indata)) {
-                float2* out = std::get<float2*>(outdata);
-                float2 const* in = std::get<float2 const*>(indata);
-                out[i0] = *pointerAdd(in, tri.x, stride);
-                out[i1] = *pointerAdd(in, tri.y, stride);
-                out[i2] = *pointerAdd(in, tri.z, stride);
-            } else if (std::holds_alternative<float3 const*>(indata)) {
-                float3* out = std::get<float3*>(outdata);
-                float3 const* in = std::get<float3 const*>(indata);
-                out[i0] = *pointerAdd(in, tri.x, stride);
-                out[i1] = *pointerAdd(in, tri.y, stride);
-                out[i2] = *pointerAdd(in, tri.z, stride);
-            } else if (std::holds_alternative<float4 const*>(indata)) {
-                float4* out = std::get<float4*>(outdata);
-                float4 const* in = std::get<float4 const*>(indata);
-                out[i0] = *pointerAdd(in, tri.x, stride);
-                out[i1] = *pointerAdd(in, tri.y, stride);
-                out[i2] = *pointerAdd(in, tri.z, stride);
-            } else if (std::holds_alternative<ushort3 const*>(indata)) {
-                ushort3* out = std::get<ushort3*>(outdata);
-                ushort3 const* in = std::get<ushort3 const*>(indata);
-                out[i0] = *pointerAdd(in, tri.x, stride);
-                out[i1] = *pointerAdd(in, tri.y, stride);
-                out[i2] = *pointerAdd(in, tri.z, stride);
-            } else if (std::holds_alternative<ushort4 const*>(indata)) {
-                ushort4* out = std::get<ushort4*>(outdata);
-                ushort4 const* in = std::get<ushort4 const*>(indata);
-                out[i0] = *pointerAdd(in, tri.x, stride);
-                out[i1] = *pointerAdd(in, tri.y, stride);
-                out[i2] = *pointerAdd(in, tri.z, stride);
+    parallelFor(input->jobSystem, triangleCount, [&](uint32_t first, uint32_t count) {
+        for (size_t tindex = first; tindex < first + count; ++tindex) {
+            uint3 tri = isTriangle16 ?
+                    uint3(*(ushort3*)(pointerAdd(triangles, tindex, tstride))) :
+                    *(uint3*)(pointerAdd(triangles, tindex, tstride));
+
+            float3 const pa = *pointerAdd(positions, tri.x, pstride);
+            float3 const pb = *pointerAdd(positions, tri.y, pstride);
+            float3 const pc = *pointerAdd(positions, tri.z, pstride);
+
+            uint32_t const i0 = tindex * 3, i1 = i0 + 1, i2 = i0 + 2;
+            outTriangles[tindex] = uint3{i0, i1, i2};
+
+            outPositions[i0] = pa;
+            outPositions[i1] = pb;
+            outPositions[i2] = pc;
+
+            float3 const n = normalize(cross(pc - pb, pa - pb));
+            const auto [t, b] = frisvadKernel(n);
+
+            quatf const tspace = mat3f::packTangentFrame({t, b, n}, sizeof(int32_t));
+            quats[i0] = tspace;
+            quats[i1] = tspace;
+            quats[i2] = tspace;
+
+            // We need to make sure that the aux data is ported to the new mesh
+            for (auto& [indata, outdata, attrib, stride]: outAttributes) {
+                if (std::holds_alternative<float2 const*>(indata)) {
+                    float2* out = std::get<float2*>(outdata);
+                    float2 const* in = std::get<float2 const*>(indata);
+                    out[i0] = *pointerAdd(in, tri.x, stride);
+                    out[i1] = *pointerAdd(in, tri.y, stride);
+                    out[i2] = *pointerAdd(in, tri.z, stride);
+                } else if (std::holds_alternative<float3 const*>(indata)) {
+                    float3* out = std::get<float3*>(outdata);
+                    float3 const* in = std::get<float3 const*>(indata);
+                    out[i0] = *pointerAdd(in, tri.x, stride);
+                    out[i1] = *pointerAdd(in, tri.y, stride);
+                    out[i2] = *pointerAdd(in, tri.z, stride);
+                } else if (std::holds_alternative<float4 const*>(indata)) {
+                    float4* out = std::get<float4*>(outdata);
+                    float4 const* in = std::get<float4 const*>(indata);
+                    out[i0] = *pointerAdd(in, tri.x, stride);
+                    out[i1] = *pointerAdd(in, tri.y, stride);
+                    out[i2] = *pointerAdd(in, tri.z, stride);
+                } else if (std::holds_alternative<ushort3 const*>(indata)) {
+                    ushort3* out = std::get<ushort3*>(outdata);
+                    ushort3 const* in = std::get<ushort3 const*>(indata);
+                    out[i0] = *pointerAdd(in, tri.x, stride);
+                    out[i1] = *pointerAdd(in, tri.y, stride);
+                    out[i2] = *pointerAdd(in, tri.z, stride);
+                } else if (std::holds_alternative<ushort4 const*>(indata)) {
+                    ushort4* out = std::get<ushort4*>(outdata);
+                    ushort4 const* in = std::get<ushort4 const*>(indata);
+                    out[i0] = *pointerAdd(in, tri.x, stride);
+                    out[i1] = *pointerAdd(in, tri.y, stride);
+                    out[i2] = *pointerAdd(in, tri.z, stride);
+                }
             }
         }
-    }
+    });
 
     output->vertexCount = outVertexCount;
     output->triangleCount = outTriangleCount;
@@ -385,20 +449,22 @@ void tangentsProvidedMethod(TangentSpaceMeshInput const* input, TangentSpaceMesh
     float4 const* tanvec = input->tangents();
     size_t const tstride = input->tangentsStride();
 
-    for (size_t qindex = 0; qindex < vertexCount; ++qindex) {
-        float3 const& n = *pointerAdd(normal, qindex, nstride);
-        float4 const& t4 = *pointerAdd(tanvec, qindex, nstride);
-        float3 tv = t4.xyz;
-        float3 b = t4.w > 0 ? cross(tv, n) : cross(n, tv);
+    parallelFor(input->jobSystem, vertexCount, [=](uint32_t first, uint32_t count) {
+        for (size_t qindex = first; qindex < first + count; ++qindex) {
+            float3 const& n = *pointerAdd(normal, qindex, nstride);
+            float4 const& t4 = *pointerAdd(tanvec, qindex, nstride);
+            float3 tv = t4.xyz;
+            float3 b = t4.w > 0 ? cross(tv, n) : cross(n, tv);
 
-        // Some assets do not provide perfectly orthogonal tangents and normals, so we adjust the
-        // tangent to enforce orthonormality. We would rather honor the exact normal vector than
-        // the exact tangent vector since the latter is only used for bump mapping and anisotropic
-        // lighting.
-        tv = t4.w > 0 ? cross(n, b) : cross(b, n);
+            // Some assets do not provide perfectly orthogonal tangents and normals, so we adjust
+            // the tangent to enforce orthonormality. We would rather honor the exact normal vector
+            // than the exact tangent vector since the latter is only used for bump mapping and
+            // anisotropic lighting.
+            tv = t4.w > 0 ? cross(n, b) : cross(b, n);
 
-        quats[qindex] = mat3f::packTangentFrame({tv, b, n});
-    }
+            quats[qindex] = mat3f::packTangentFrame({tv, b, n});
+        }
+    });
 
     output->vertexCount = vertexCount;
     output->triangleCount = input->triangleCount;
@@ -479,21 +545,24 @@ void lengyelMethod(TangentSpaceMeshInput const* input, TangentSpaceMeshOutput* o
         tan2[tri.z] += tdir;
     }
 
+    // The accumulation above scatters into shared vertices, only the per-vertex pass is split.
     quatf* quats = output->tspace().allocate(vertexCount);
-    for (size_t a = 0; a < vertexCount; a++) {
-        float3 const& n = *pointerAdd(normals, a, normalStride);
-        float3 const& t1 = tan1[a];
-        float3 const& t2 = tan2[a];
+    parallelFor(input->jobSystem, vertexCount, [&](uint32_t first, uint32_t count) {
+        for (size_t a = first; a < first + count; a++) {
+            float3 const& n = *pointerAdd(normals, a, normalStride);
+            float3 const& t1 = tan1[a];
+            float3 const& t2 = tan2[a];
 
-        // Gram-Schmidt orthogonalize
-        float3 const t = normalize(t1 - n * dot(n, t1));
+            // Gram-Schmidt orthogonalize
+            float3 const t = normalize(t1 - n * dot(n, t1));
 
-        // Calculate handedness
-        float const w = (dot(cross(n, t1), t2) < 0.0f) ? -1.0f : 1.0f;
+            // Calculate handedness
+            float const w = (dot(cross(n, t1), t2) < 0.0f) ? -1.0f : 1.0f;
 
-        float3 b = w < 0 ? cross(t, n) : cross(n, t);
-        quats[a] = mat3f::packTangentFrame({t, b, n}, sizeof(int32_t));
-    }
+            float3 b = w < 0 ? cross(t, n) : cross(n, t);
+            quats[a] = mat3f::packTangentFrame({t, b, n}, sizeof(int32_t));
+        }
+    });
 
     output->vertexCount = vertexCount;
     output->triangleCount = triangleCount;
@@ -579,6 +648,11 @@ Builder& Builder::algorithm(Algorithm algo) noexcept {
     return *this;
 }
 
+Builder& Builder::jobSystem(utils::JobSystem* jobSystem) noexcept {
+    mMesh->mInput->jobSystem = jobSystem;
+    return *this;
+}
+
 TangentSpaceMesh* Builder::build() {
     FILAMENT_CHECK_PRECONDITION(!mMesh->mInput->triangles32 || !mMesh->mInput->triangles16)
             << "Cannot provide both uint32 triangles and uint16 triangles";
@@ -663,6 +737,29 @@ void TangentSpaceMesh::getPositions(float3* positions, size_t stride) const {
     }
 }
 
+void TangentSpaceMesh::getPositions(short4* positions, float3* offset, float3* scale,
+        size_t stride) const {
+    auto inPositions = mInput->positions();
+    FILAMENT_CHECK_PRECONDITION(inPositions) << "Must provide input positions";
+    stride = stride ? stride : sizeof(decltype(*positions));
+    auto const& outPositions = mOutput->positions();
+    size_t const vertexCount = mOutput->vertexCount;
+
+    float3 minPosition{ std::numeric_limits<float>::max() };
+    float3 maxPosition{ std::numeric_limits<float>::lowest() };
+    for (size_t i = 0; i < vertexCount; ++i) {
+        minPosition = min(minPosition, outPositions[i]);
+        maxPosition = max(maxPosition, outPositions[i]);
+    }
+    *offset = vertexCount ? (minPosition + maxPosition) * 0.5f : float3{};
+    *scale = vertexCount ? max((maxPosition - minPosition) * 0.5f, float3{ FLT_MIN }) : float3{ 1 };
+
+    for (size_t i = 0; i < vertexCount; ++i) {
+        *positions = packSnorm16(float4{ (outPositions[i] - *offset) / *scale, 1.0f });
+        takeStride(positions, stride);
+    }
+}
+
 void TangentSpaceMesh::getUVs(float2* uvs, size_t stride) const {
     auto inUVs = mInput->uvs();
     FILAMENT_CHECK_PRECONDITION(inUVs) << "Must provide input positions";
@@ -674,6 +771,28 @@ void TangentSpaceMesh::getUVs(float2* uvs, size_t stride) const {
     }
 }
 
+void TangentSpaceMesh::getUVs(ushort2* uvs, size_t stride) const {
+    auto inUVs = mInput->uvs();
+    FILAMENT_CHECK_PRECONDITION(inUVs) << "Must provide input UVs";
+    stride = stride ? stride : sizeof(decltype(*uvs));
+    auto const& outUvs = mOutput->uvs();
+    for (size_t i = 0; i < mOutput->vertexCount; ++i) {
+        *uvs = ushort2{ packUnorm16(outUvs[i].x), packUnorm16(outUvs[i].y) };
+        takeStride(uvs, stride);
+    }
+}
+
+void TangentSpaceMesh::getUVs(half2* uvs, size_t stride) const {
+    auto inUVs = mInput->uvs();
+    FILAMENT_CHECK_PRECONDITION(inUVs) << "Must provide input UVs";
+    stride = stride ? stride : sizeof(decltype(*uvs));
+    auto const& outUvs = mOutput->uvs();
+    for (size_t i = 0; i < mOutput->vertexCount; ++i) {
+        *uvs = half2{ outUvs[i] };
+        takeStride(uvs, stride);
+    }
+}
+
 size_t TangentSpaceMesh::getTriangleCount() const noexcept {
     return mOutput->triangleCount;
 }
@@ -730,9 +849,9 @@ void TangentSpaceMesh::getQuats(short4* out, size_t stride) const noexcept {
     stride = stride ? stride : sizeof(decltype((*out)));
     auto const& tangents = mOutput->tspace();
     size_t const vertexCount = mOutput->vertexCount;
-    for (size_t i = 0; i < vertexCount; ++i) {
-        *out = packSnorm16(tangents[i].xyzw);
-        takeStride(out, stride);
+    if (vertexCount > 0) {
+        // The tangent space is always allocated by the methods, so it is tightly packed.
+        packQuats(&tangents[0], out, vertexCount, stride);
     }
 }
 
@@ -184,6 +184,8 @@ struct TangentSpaceMeshInput {
 
     size_t triangleCount = 0;
 
+    utils::JobSystem* jobSystem = nullptr;
+
     inline float3 const* positions() const {
         return data<DATA_TYPE_POSITIONS>(AttributeImpl::POSITIONS);
     }
@@ -16,11 +16,13 @@
 
 #include <geometry/TangentSpaceMesh.h>
 
+#include <math/norm.h>
 #include <math/quat.h>
 #include <math/vec3.h>
 
 #include <gtest/gtest.h>
 
+#include <utils/JobSystem.h>
 #include <utils/Log.h>
 
 #include <vector>
@@ -427,6 +429,82 @@ TEST_F(TangentSpaceMeshTest, Lengyel) {
     TangentSpaceMesh::destroy(mesh);
 }
 
+TEST_F(TangentSpaceMeshTest, QuantizedPositionsAndUVs) {
+    TangentSpaceMesh* mesh = TangentSpaceMesh::Builder()
+            .vertexCount(CUBE_VERTS.size())
+            .normals(CUBE_NORMALS.data())
+            .positions(CUBE_VERTS.data())
+            .uvs(CUBE_UVS.data())
+            .algorithm(TangentSpaceMesh::Algorithm::FRISVAD)
+            .build();
+
+    size_t const vertexCount = mesh->getVertexCount();
+    ASSERT_EQ(vertexCount, CUBE_VERTS.size());
+
+    float3 offset, scale;
+    std::vector<short4> positions(vertexCount);
+    mesh->getPositions(positions.data(), &offset, &scale);
+    EXPECT_PRED2(isAlmostEqual3, offset, CUBE_CENTER);
+    EXPECT_PRED2(isAlmostEqual3, scale, float3{ 0.5f });
+
+    std::vector<ushort2> uvs(vertexCount);
+    mesh->getUVs(uvs.data());
+
+    for (size_t i = 0; i < vertexCount; ++i) {
+        float3 const position = offset + scale * unpackSnorm16(positions[i]).xyz;
+        EXPECT_NEAR(position.x, CUBE_VERTS[i].x, 1e-4f);
+        EXPECT_NEAR(position.y, CUBE_VERTS[i].y, 1e-4f);
+        EXPECT_NEAR(position.z, CUBE_VERTS[i].z, 1e-4f);
+        EXPECT_EQ(positions[i].w, 32767);
+
+        EXPECT_NEAR(uvs[i].x / 65535.0f, CUBE_UVS[i].x, 1e-4f);
+        EXPECT_NEAR(uvs[i].y / 65535.0f, CUBE_UVS[i].y, 1e-4f);
+    }
+    TangentSpaceMesh::destroy(mesh);
+}
+
+TEST_F(TangentSpaceMeshTest, JobSystemMatchesSingleThreaded) {
+    // Enough vertices for the work to be split into several jobs.
+    std::vector<float3> normals(100000);
+    for (size_t i = 0; i < normals.size(); ++i) {
+        float const x = float(i);
+        normals[i] = normalize(float3{ std::sin(x), std::cos(x * 0.7f), std::sin(x * 1.3f) });
+    }
+
+    utils::JobSystem js;
+    js.adopt();
+
+    TangentSpaceMesh* serial = TangentSpaceMesh::Builder()
+            .vertexCount(normals.size())
+            .normals(normals.data())
+            .algorithm(TangentSpaceMesh::Algorithm::FRISVAD)
+            .build();
+    TangentSpaceMesh* parallel = TangentSpaceMesh::Builder()
+            .vertexCount(normals.size())
+            .normals(normals.data())
+            .algorithm(TangentSpaceMesh::Algorithm::FRISVAD)
+            .jobSystem(&js)
+            .build();
+
+    ASSERT_EQ(parallel->getVertexCount(), normals.size());
+
+    std::vector<quatf> serialQuats(normals.size());
+    std::vector<quatf> parallelQuats(normals.size());
+    std::vector<short4> packedQuats(normals.size());
+    serial->getQuats(serialQuats.data());
+    parallel->getQuats(parallelQuats.data());
+    parallel->getQuats(packedQuats.data());
+
+    for (size_t i = 0; i < normals.size(); ++i) {
+        EXPECT_EQ(serialQuats[i], parallelQuats[i]);
+        EXPECT_EQ(packedQuats[i], packSnorm16(parallelQuats[i].xyzw));
+    }
+
+    TangentSpaceMesh::destroy(serial);
+    TangentSpaceMesh::destroy(parallel);
+    js.emancipate();
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -20,6 +20,10 @@
 #include <gltfio/FilamentAsset.h>
 #include <gltfio/FilamentInstance.h>
 
+namespace utils {
+class JobSystem;
+} // namespace utils
+
 namespace filament::gltfio {
 
 struct FFilamentAsset;
@@ -56,6 +60,34 @@ public:
      */
     void updateBoneMatrices();
 
+    /**
+     * Applies an animation to each of the given animators, same as calling applyAnimation() on
+     * each of them. The keyframes are sampled concurrently on the given JobSystem, then the
+     * transforms are updated from the calling thread. This is useful for crowds of instances.
+     *
+     * This must be called from a thread owned by the JobSystem, e.g. from the thread that
+     * created the Engine when using Engine::getJobSystem(). Each animator must appear only once.
+     *
+     * @param js JobSystem used to sample the animations.
+     * @param animators Animators to update, e.g. obtained with FilamentInstance::getAnimator().
+     * @param animationIndices Zero-based index of the \c animation of interest, per animator.
+     * @param times Elapsed time of interest in seconds, per animator.
+     * @param count Number of animators.
+     */
+    static void applyAnimations(utils::JobSystem& js, Animator* const* animators,
+            size_t const* animationIndices, float const* times, size_t count);
+
+    /**
+     * Same as calling updateBoneMatrices() on each of the given animators, but the bone matrices
+     * are computed concurrently on the given JobSystem. They are then passed to
+     * filament::RenderableManager::setBones from the calling thread.
+     *
+     * This must be called from a thread owned by the JobSystem. Each animator must appear only
+     * once.
+     */
+    static void updateBoneMatrices(utils::JobSystem& js, Animator* const* animators,
+            size_t count);
+
     /**
      * Applies a blended transform to the union of nodes affected by two animations.
      * Used for cross-fading from a previous skinning-based animation or rigid body animation.
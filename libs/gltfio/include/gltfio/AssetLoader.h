@@ -83,6 +83,27 @@ struct AssetConfiguration {
     //! Optional to enable mikktspace tangents. Lifetime of struct only needs to be maintained for
     //  the duration of the constructor of AssetLoader.
     AssetConfigurationExtended* ext = nullptr;
+
+    //! Number of simplified levels of detail to generate for each triangle primitive, in addition
+    //! to the original geometry. ResourceLoader simplifies the meshes with meshoptimizer when it
+    //! loads the vertex data, and the levels are registered on the renderables with
+    //! RenderableManager::Builder::levelOfDetail(). At most 3, ignored with the extended
+    //! algorithm. Defaults to 0 (no generated levels).
+    uint8_t levelOfDetailCount = 0;
+
+    //! Stores float vertex attributes in smaller normalized types: colors become unorm8, texture
+    //! coordinates within [0, 1] become unorm16, and positions become snorm16 for meshes whose
+    //! nodes are neither skinned, instanced, nor animated. The dequantization of the positions is
+    //! folded into the local transform of the nodes that reference the mesh, so these transforms
+    //! include an extra translation and uniform scale. Ignored with the extended algorithm.
+    //! Defaults to false.
+    bool quantizeAttributes = false;
+
+    //! Keeps a copy of the vertex, index and image data that ResourceLoader uploads, so that the
+    //! asset can be saved with bakeAsset(). This uses as much CPU memory as the asset's buffers
+    //! and images, until the asset is destroyed. Ignored with the extended algorithm.
+    //! Defaults to false.
+    bool keepBakingData = false;
 };
 
 /**
@@ -177,6 +198,31 @@ public:
      */
     FilamentAsset* createAsset(const uint8_t* bytes, uint32_t nbytes);
 
+    /**
+     * Called when the asset no longer needs the content passed to createAsset().
+     */
+    using ReleaseCallback = void(*)(void const* bytes, size_t nbytes, void* user);
+
+    /**
+     * Same as createAsset(), but the content is used in place instead of being copied, e.g. it
+     * can be a memory-mapped GLB file. Vertex and index data which don't need a conversion are
+     * then uploaded to the GPU straight from this content.
+     *
+     * The content must stay valid and unmodified until the callback is called. This happens
+     * once the asset is destroyed or its source data is released (see
+     * FilamentAsset::releaseSourceData()) and all the pending uploads have completed, which
+     * can be after destroyAsset() returns. On failure, the callback is called before this
+     * returns null.
+     *
+     * @param bytes the contents of a glTF 2.0 file (JSON or GLB)
+     * @param nbytes the number of bytes in "bytes"
+     * @param callback called with bytes, nbytes and user when the content can be released
+     * @param user opaque pointer passed to the callback
+     * @return the asset, or null on failure
+     */
+    FilamentAsset* createAsset(const uint8_t* bytes, uint32_t nbytes,
+            ReleaseCallback callback, void* user = nullptr);
+
     /**
      * Consumes the contents of a glTF 2.0 file and produces a primary asset with one or more
      * instances. The primary asset has ownership over the instances.
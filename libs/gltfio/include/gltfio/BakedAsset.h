@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GLTFIO_BAKEDASSET_H
+#define GLTFIO_BAKEDASSET_H
+
+#include <backend/BufferDescriptor.h>
+
+#include <filament/Box.h>
+
+#include <utils/compiler.h>
+#include <utils/Entity.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace utils {
+    class EntityManager;
+    class NameComponentManager;
+}
+
+namespace filament {
+    class Engine;
+    class MaterialInstance;
+}
+
+namespace filament::gltfio {
+
+class FilamentAsset;
+class MaterialProvider;
+class TextureProvider;
+
+/**
+ * Saves a loaded asset in gltfio's baked format.
+ *
+ * A baked asset holds the vertex and index buffers in their final layout, after the conversions,
+ * tangent generation and Draco decoding that ResourceLoader performs, along with the encoded
+ * images (e.g. KTX2), the material keys and parameters, and the node hierarchy of the asset's first
+ * instance. BakedAssetLoader can then create it without parsing glTF or processing vertices.
+ *
+ * The asset must have been created with AssetConfiguration::keepBakingData, and its resources
+ * must be fully loaded. Skins, morph targets, animations, lights, cameras, material variants and
+ * generated levels of detail are not baked; assets that use skins or morph targets can't be baked.
+ *
+ * @return false if the asset can't be baked or if the file can't be written.
+ */
+UTILS_PUBLIC bool bakeAsset(FilamentAsset const* asset, const char* path);
+
+/**
+ * \class BakedAsset BakedAsset.h gltfio/BakedAsset.h
+ * \brief The entities and components created from a baked asset.
+ *
+ * Entities are owned by the asset, and are destroyed along with the asset by
+ * BakedAssetLoader::destroyAsset().
+ */
+class UTILS_PUBLIC BakedAsset {
+public:
+    /** Gets the transform root, the parent of all the asset's nodes. */
+    utils::Entity getRoot() const noexcept;
+
+    /** Gets all the entities of the asset, including the root. */
+    const utils::Entity* getEntities() const noexcept;
+    size_t getEntityCount() const noexcept;
+
+    /** Gets the entities that have a renderable component. */
+    const utils::Entity* getRenderableEntities() const noexcept;
+    size_t getRenderableEntityCount() const noexcept;
+
+    /** Gets the material instances of the asset. */
+    MaterialInstance* const* getMaterialInstances() const noexcept;
+    size_t getMaterialInstanceCount() const noexcept;
+
+    /** Gets the bounding box of the asset, in the space of its root. */
+    Aabb getBoundingBox() const noexcept;
+
+protected:
+    BakedAsset() noexcept = default;
+    ~BakedAsset() = default;
+
+public:
+    BakedAsset(BakedAsset const&) = delete;
+    BakedAsset(BakedAsset&&) = delete;
+    BakedAsset& operator=(BakedAsset const&) = delete;
+    BakedAsset& operator=(BakedAsset&&) = delete;
+};
+
+/**
+ * \struct BakedAssetConfiguration BakedAsset.h gltfio/BakedAsset.h
+ * \brief Construction parameters for BakedAssetLoader.
+ */
+struct BakedAssetConfiguration {
+    //! The engine that the loader passes to the builder objects.
+    filament::Engine* engine;
+
+    //! Creates the material instances. It must provide the same materials as the provider that
+    //! was used to load the asset before it was baked.
+    MaterialProvider* materials;
+
+    //! Optional manager for associating string names with entities.
+    utils::NameComponentManager* names = nullptr;
+
+    //! Optional entity manager, the default one is used if null.
+    utils::EntityManager* entities = nullptr;
+};
+
+/**
+ * \class BakedAssetLoader BakedAsset.h gltfio/BakedAsset.h
+ * \brief Creates BakedAsset objects from the files written by bakeAsset().
+ *
+ * Vertex and index data is uploaded straight from the given memory, so the fastest way to load a
+ * baked asset is to map its file in memory and to unmap it from the callback of the
+ * BufferDescriptor:
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+ * BakedAsset* asset = loader->createAsset({ data, size,
+ *         [](void* buffer, size_t size, void*) { munmap(buffer, size); } });
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * Textures are decoded synchronously, by the TextureProvider registered for their mime type.
+ */
+class UTILS_PUBLIC BakedAssetLoader {
+public:
+    static BakedAssetLoader* create(BakedAssetConfiguration const& config);
+    static void destroy(BakedAssetLoader** loader);
+
+    /**
+     * Registers a provider for the images of the given mime type, e.g. "image/ktx2".
+     *
+     * The provider must be destroyed after the loader.
+     */
+    void addTextureProvider(const char* mimeType, TextureProvider* provider);
+
+    /**
+     * Creates an asset from the contents of a baked file.
+     *
+     * The buffer's callback is called once all its data has been uploaded.
+     *
+     * @return the asset, or null if the data isn't a valid baked asset.
+     */
+    BakedAsset* createAsset(backend::BufferDescriptor&& data);
+
+    /** Destroys the given asset and all of its entities and components. */
+    void destroyAsset(BakedAsset const* asset);
+
+protected:
+    BakedAssetLoader() noexcept = default;
+    ~BakedAssetLoader() = default;
+
+public:
+    BakedAssetLoader(BakedAssetLoader const&) = delete;
+    BakedAssetLoader(BakedAssetLoader&&) = delete;
+    BakedAssetLoader& operator=(BakedAssetLoader const&) = delete;
+    BakedAssetLoader& operator=(BakedAssetLoader&&) = delete;
+};
+
+} // namespace filament::gltfio
+
+#endif // GLTFIO_BAKEDASSET_H
@@ -17,6 +17,8 @@
 #ifndef GLTFIO_MATERIALPROVIDER_H
 #define GLTFIO_MATERIALPROVIDER_H
 
+#include <backend/BufferDescriptor.h>
+
 #include <filament/Engine.h>
 #include <filament/Material.h>
 #include <filament/MaterialInstance.h>
@@ -28,6 +30,8 @@
 
 namespace filament::gltfio {
 
+class FilamentAsset;
+
 enum class AlphaMode : uint8_t {
     OPAQUE,
     MASK,
@@ -185,6 +189,20 @@ public:
      * if the glTF model does not provide them.
      */
     virtual bool needsDummyData(VertexAttribute attrib) const noexcept = 0;
+
+    /**
+     * Replaces the temporary material instances of the given asset with their final version, for
+     * those that are ready. Only the hybrid provider creates temporary material instances, see
+     * createHybridShaderProvider().
+     *
+     * Replaced material instances are destroyed, so the pointers returned by
+     * FilamentInstance::getMaterialInstances() must be fetched again after this call.
+     *
+     * This must be called on the engine's thread, e.g. once per frame until it returns zero.
+     *
+     * @return The number of material instances of the asset that are still temporary.
+     */
+    virtual size_t updateMaterials(FilamentAsset* asset) { return 0; }
 };
 
 void constrainMaterial(MaterialKey* key, UvMap* uvmap);
@@ -196,6 +214,9 @@ void processShaderString(std::string* shader, const UvMap& uvmap,
  * Creates a material provider that builds materials on the fly, composing GLSL at run time.
  *
  * @param optimizeShaders Optimizes shaders, but at significant cost to construction time.
+ * @param cacheDirectory Optional directory where built materials are saved, so that later runs
+ *                       can load them instead of compiling their shaders again. The directory is
+ *                       created if needed.
  * @return New material provider that can build materials at run time.
  *
  * Requires \c libfilamat to be linked in. Not available in \c libgltfio_core.
@@ -203,11 +224,15 @@ void processShaderString(std::string* shader, const UvMap& uvmap,
  * @see createUbershaderProvider
  */
 UTILS_PUBLIC
-MaterialProvider* createJitShaderProvider(Engine* engine, bool optimizeShaders = false);
+MaterialProvider* createJitShaderProvider(Engine* engine, bool optimizeShaders = false,
+        const char* cacheDirectory = nullptr);
 
 /**
  * Creates a material provider that loads a small set of pre-built materials.
  *
+ * The archive is copied, and each material is decompressed from it the first time an asset
+ * needs it.
+ *
  * @return New material provider that can quickly load a material from a cache.
  *
  * @see createJitShaderProvider
@@ -216,6 +241,34 @@ UTILS_PUBLIC
 MaterialProvider* createUbershaderProvider(Engine* engine, const void* archive,
         size_t archiveByteCount);
 
+/**
+ * Creates a material provider that uses the given archive in place, e.g. a memory-mapped file,
+ * instead of copying it. The buffer's callback is called when the provider is destroyed.
+ *
+ * @see createUbershaderProvider
+ */
+UTILS_PUBLIC
+MaterialProvider* createUbershaderProvider(Engine* engine, backend::BufferDescriptor&& archive);
+
+/**
+ * Creates a material provider that combines the two other providers: assets first render with
+ * pre-built ubershader materials, while specialized materials are built on a background thread.
+ * Call MaterialProvider::updateMaterials() to switch an asset to the specialized materials as they
+ * become ready; their parameters and textures are carried over.
+ *
+ * @param archive Archive of ubershader materials, see createUbershaderProvider().
+ * @param optimizeShaders Optimizes the specialized shaders, see createJitShaderProvider().
+ * @param cacheDirectory Optional directory where specialized materials are saved, see
+ *                       createJitShaderProvider().
+ * @return New material provider that loads quickly and eventually renders with fast materials.
+ *
+ * Requires \c libfilamat to be linked in. Not available in \c libgltfio_core.
+ */
+UTILS_PUBLIC
+MaterialProvider* createHybridShaderProvider(Engine* engine, const void* archive,
+        size_t archiveByteCount, bool optimizeShaders = false,
+        const char* cacheDirectory = nullptr);
+
 } // namespace filament::gltfio
 
 #endif // GLTFIO_MATERIALPROVIDER_H
@@ -49,6 +49,16 @@ struct ResourceConfiguration {
     //! If true, adjusts skinning weights to sum to 1. Well formed glTF files do not need this,
     //! but it is useful for robustness.
     bool normalizeSkinningWeights;
+
+    //! If true, textures with identical content are decoded and uploaded only once, and shared
+    //! by all the assets loaded with this ResourceLoader. A shared texture is destroyed along with
+    //! the last asset that uses it. This is useful when many assets use the same images.
+    bool shareTextures = false;
+
+    //! If true, the triangles of each primitive are re-ordered with meshoptimizer to improve the
+    //! post-transform vertex cache hit rate and to reduce overdraw. This runs on the JobSystem
+    //! when the resources are loaded and is not supported with the extended algorithm.
+    bool optimizeMeshes = false;
 };
 
 /**
@@ -173,6 +173,27 @@ public:
  */
 TextureProvider* createStbProvider(filament::Engine* engine);
 
+struct StbProviderConfiguration {
+    /**
+     * Compresses the decoded images on the CPU, to BC1 / BC3 (DXT) or else ETC2, whichever the
+     * engine supports first, to use 4 to 8 times less GPU memory. Images with an alpha channel
+     * use BC3 or ETC2_EAC_RGBA8. Their mipmaps are generated on the CPU before compression.
+     *
+     * Images are left uncompressed when neither format is supported. This is slower than
+     * decoding alone, and the runtime encoders don't match the quality of offline tools, so
+     * prefer KTX2 content when possible.
+     */
+    bool compressTextures = false;
+};
+
+/**
+ * Creates a decoder based on stb_image that can handle "image/png" and "image/jpeg", with
+ * options.
+ * This works only if your build configuration includes STB.
+ */
+TextureProvider* createStbProvider(filament::Engine* engine,
+        StbProviderConfiguration const& config);
+
 /**
  * Creates a decoder that can handle certain types of "image/ktx2" content as specified in
  * the KHR_texture_basisu specification.
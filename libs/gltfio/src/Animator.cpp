@@ -26,6 +26,7 @@
 #include <filament/RenderableManager.h>
 #include <filament/TransformManager.h>
 
+#include <utils/JobSystem.h>
 #include <utils/Log.h>
 
 #include <math/mat4.h>
@@ -34,6 +35,7 @@
 #include <math/vec3.h>
 #include <math/vec4.h>
 
+#include <functional>
 #include <map>
 #include <string>
 #include <vector>
@@ -68,6 +70,21 @@ struct Animation {
     vector<Channel> channels;
 };
 
+// The value of a channel at a given time. Rotations are stored as xyzw, scales and translations
+// as xyz. Morph weights are stored separately since their count varies.
+struct SampledValue {
+    float4 value;
+    uint32_t weightsOffset;
+    uint32_t weightsCount;
+    bool valid;
+};
+
+struct SkinnedRenderable {
+    RenderableManager::Instance renderable;
+    uint32_t boneOffset;
+    uint32_t boneCount;
+};
+
 struct AnimatorImpl {
     vector<Animation> animations;
     BoneVector boneMatrices;
@@ -76,17 +93,38 @@ struct AnimatorImpl {
     RenderableManager* renderableManager;
     TransformManager* transformManager;
     TrsTransformManager* trsTransformManager;
-    vector<float> weights;
     FixedCapacityVector<mat4f> crossFade;
+
+    // Results of sampleAnimation(), one value per channel of sampledAnimation.
+    const Animation* sampledAnimation = nullptr;
+    vector<SampledValue> sampledValues;
+    vector<float> sampledWeights;
+
+    // Results of computeBoneMatrices(), the bones of each renderable are stored contiguously in
+    // boneMatrices.
+    vector<SkinnedRenderable> skinnedRenderables;
+
     void addChannels(const FixedCapacityVector<Entity>& nodeMap, const cgltf_animation& srcAnim,
             Animation& dst);
-    void applyAnimation(const Channel& channel, float t, size_t prevIndex, size_t nextIndex);
+
+    // Sampling and computing the bones only read the component managers, so this can be done
+    // concurrently for several animators. Applying the results must be done serially.
+    void sampleAnimation(size_t animationIndex, float time);
+    void sampleChannel(const Channel& channel, float t, size_t prevIndex, size_t nextIndex,
+            SampledValue& result);
+    void applySampledAnimation();
+    void computeBoneMatrices(FFilamentInstance* instance);
+    void computeBoneMatrices();
+    void uploadBoneMatrices();
+
     void stashCrossFade();
     void applyCrossFade(float alpha);
     void resetBoneMatrices(FFilamentInstance* instance);
-    void updateBoneMatrices(FFilamentInstance* instance);
 };
 
+// below this many animators, the batch API doesn't use jobs
+static constexpr size_t JOBS_PARALLEL_FOR_ANIMATORS_COUNT = 16;
+
 static void createSampler(const cgltf_animation_sampler& src, Sampler& dst) {
     // Copy the time values into a red-black tree.
     const cgltf_accessor* timelineAccessor = src.input;
@@ -263,49 +301,37 @@ size_t Animator::getAnimationCount() const {
 }
 
 void Animator::applyAnimation(size_t animationIndex, float time) const {
-    const Animation& anim = mImpl->animations[animationIndex];
-    time = time == anim.duration ? time : fmod(time, anim.duration);
+    mImpl->sampleAnimation(animationIndex, time);
     TransformManager& transformManager = *mImpl->transformManager;
     transformManager.openLocalTransformTransaction();
-    for (const auto& channel : anim.channels) {
-        const Sampler* sampler = channel.sourceData;
-        if (sampler->times.size() < 2) {
-            continue;
-        }
-
-        const TimeValues& times = sampler->times;
-
-        // Find the first keyframe after the given time, or the keyframe that matches it exactly.
-        TimeValues::const_iterator iter = times.lower_bound(time);
+    mImpl->applySampledAnimation();
+    transformManager.commitLocalTransformTransaction();
+}
 
-        // Compute the interpolant (between 0 and 1) and determine the keyframe pair.
-        float t = 0.0f;
-        size_t nextIndex;
-        size_t prevIndex;
-        if (iter == times.end()) {
-            nextIndex = times.size() - 1;
-            prevIndex = nextIndex;
-        } else if (iter == times.begin()) {
-            nextIndex = 0;
-            prevIndex = 0;
-        } else {
-            TimeValues::const_iterator prev = iter; --prev;
-            nextIndex = iter->second;
-            prevIndex = prev->second;
-            const float nextTime = iter->first;
-            const float prevTime = prev->first;
-            float deltaTime = nextTime - prevTime;
-            assert(deltaTime >= 0);
-            if (deltaTime > 0) {
-                t = (time - prevTime) / deltaTime;
-            }
-        }
+void Animator::applyAnimations(JobSystem& js, Animator* const* animators,
+        size_t const* animationIndices, float const* times, size_t count) {
+    if (count == 0) {
+        return;
+    }
 
-        if (sampler->interpolation == Sampler::STEP) {
-            t = 0.0f;
+    auto work = [animators, animationIndices, times](uint32_t start, uint32_t count) {
+        for (uint32_t i = start, n = start + count; i < n; i++) {
+            animators[i]->mImpl->sampleAnimation(animationIndices[i], times[i]);
         }
+    };
+    if (count <= JOBS_PARALLEL_FOR_ANIMATORS_COUNT) {
+        work(0, count);
+    } else {
+        auto* job = jobs::parallel_for(js, nullptr, 0, uint32_t(count), std::cref(work),
+                jobs::CountSplitter<JOBS_PARALLEL_FOR_ANIMATORS_COUNT>());
+        js.runAndWait(job);
+    }
 
-        mImpl->applyAnimation(channel, t, prevIndex, nextIndex);
+    // All the animators share the engine's TransformManager, a single transaction is enough.
+    TransformManager& transformManager = *animators[0]->mImpl->transformManager;
+    transformManager.openLocalTransformTransaction();
+    for (size_t i = 0; i < count; i++) {
+        animators[i]->mImpl->applySampledAnimation();
     }
     transformManager.commitLocalTransformTransaction();
 }
@@ -324,15 +350,26 @@ void Animator::resetBoneMatrices() {
 }
 
 void Animator::updateBoneMatrices() {
-    // If this is a single-instance animator, then update only this instance.
-    if (mImpl->instance) {
-        mImpl->updateBoneMatrices(mImpl->instance);
-        return;
+    mImpl->computeBoneMatrices();
+    mImpl->uploadBoneMatrices();
+}
+
+void Animator::updateBoneMatrices(JobSystem& js, Animator* const* animators, size_t count) {
+    auto work = [animators](uint32_t start, uint32_t count) {
+        for (uint32_t i = start, n = start + count; i < n; i++) {
+            animators[i]->mImpl->computeBoneMatrices();
+        }
+    };
+    if (count <= JOBS_PARALLEL_FOR_ANIMATORS_COUNT) {
+        work(0, count);
+    } else {
+        auto* job = jobs::parallel_for(js, nullptr, 0, uint32_t(count), std::cref(work),
+                jobs::CountSplitter<JOBS_PARALLEL_FOR_ANIMATORS_COUNT>());
+        js.runAndWait(job);
     }
 
-    // If this is a broadcast animator, then update all instances.
-    for (FFilamentInstance* instance : mImpl->asset->mInstances) {
-        mImpl->updateBoneMatrices(instance);
+    for (size_t i = 0; i < count; i++) {
+        animators[i]->mImpl->uploadBoneMatrices();
     }
 }
 
@@ -434,44 +471,78 @@ void AnimatorImpl::addChannels(const FixedCapacityVector<Entity>& nodeMap,
     }
 }
 
-void AnimatorImpl::applyAnimation(const Channel& channel, float t, size_t prevIndex,
-        size_t nextIndex) {
-    const Sampler* sampler = channel.sourceData;
-    const TimeValues& times = sampler->times;
-    TrsTransformManager::Instance trsNode = trsTransformManager->getInstance(channel.targetEntity);
-    TransformManager::Instance node = transformManager->getInstance(channel.targetEntity);
+void AnimatorImpl::sampleAnimation(size_t animationIndex, float time) {
+    const Animation& anim = animations[animationIndex];
+    time = time == anim.duration ? time : fmod(time, anim.duration);
+    sampledAnimation = &anim;
+    sampledValues.resize(anim.channels.size());
+    sampledWeights.clear();
+    for (size_t channelIndex = 0, n = anim.channels.size(); channelIndex < n; ++channelIndex) {
+        const Channel& channel = anim.channels[channelIndex];
+        SampledValue& result = sampledValues[channelIndex];
+        const Sampler* sampler = channel.sourceData;
+        result.valid = sampler->times.size() >= 2;
+        if (!result.valid) {
+            continue;
+        }
 
-    switch (channel.transformType) {
+        const TimeValues& times = sampler->times;
 
-        case Channel::SCALE: {
-            float3 scale;
-            const float3* srcVec3 = (const float3*) sampler->values.data();
-            if (sampler->interpolation == Sampler::CUBIC) {
-                float3 vert0 = srcVec3[prevIndex * 3 + 1];
-                float3 tang0 = srcVec3[prevIndex * 3 + 2];
-                float3 tang1 = srcVec3[nextIndex * 3];
-                float3 vert1 = srcVec3[nextIndex * 3 + 1];
-                scale = cubicSpline(vert0, tang0, vert1, tang1, t);
-            } else {
-                scale = ((1 - t) * srcVec3[prevIndex]) + (t * srcVec3[nextIndex]);
+        // Find the first keyframe after the given time, or the keyframe that matches it exactly.
+        TimeValues::const_iterator iter = times.lower_bound(time);
+
+        // Compute the interpolant (between 0 and 1) and determine the keyframe pair.
+        float t = 0.0f;
+        size_t nextIndex;
+        size_t prevIndex;
+        if (iter == times.end()) {
+            nextIndex = times.size() - 1;
+            prevIndex = nextIndex;
+        } else if (iter == times.begin()) {
+            nextIndex = 0;
+            prevIndex = 0;
+        } else {
+            TimeValues::const_iterator prev = iter; --prev;
+            nextIndex = iter->second;
+            prevIndex = prev->second;
+            const float nextTime = iter->first;
+            const float prevTime = prev->first;
+            float deltaTime = nextTime - prevTime;
+            assert(deltaTime >= 0);
+            if (deltaTime > 0) {
+                t = (time - prevTime) / deltaTime;
             }
-            trsTransformManager->setScale(trsNode, scale);
-            break;
         }
 
+        if (sampler->interpolation == Sampler::STEP) {
+            t = 0.0f;
+        }
+
+        sampleChannel(channel, t, prevIndex, nextIndex, result);
+    }
+}
+
+void AnimatorImpl::sampleChannel(const Channel& channel, float t, size_t prevIndex,
+        size_t nextIndex, SampledValue& result) {
+    const Sampler* sampler = channel.sourceData;
+    const TimeValues& times = sampler->times;
+
+    switch (channel.transformType) {
+
+        case Channel::SCALE:
         case Channel::TRANSLATION: {
-            float3 translation;
+            float3 value;
             const float3* srcVec3 = (const float3*) sampler->values.data();
             if (sampler->interpolation == Sampler::CUBIC) {
                 float3 vert0 = srcVec3[prevIndex * 3 + 1];
                 float3 tang0 = srcVec3[prevIndex * 3 + 2];
                 float3 tang1 = srcVec3[nextIndex * 3];
                 float3 vert1 = srcVec3[nextIndex * 3 + 1];
-                translation = cubicSpline(vert0, tang0, vert1, tang1, t);
+                value = cubicSpline(vert0, tang0, vert1, tang1, t);
             } else {
-                translation = ((1 - t) * srcVec3[prevIndex]) + (t * srcVec3[nextIndex]);
+                value = ((1 - t) * srcVec3[prevIndex]) + (t * srcVec3[nextIndex]);
             }
-            trsTransformManager->setTranslation(trsNode, translation);
+            result.value = float4{ value, 0.0f };
             break;
         }
 
@@ -487,7 +558,7 @@ void AnimatorImpl::applyAnimation(const Channel& channel, float t, size_t prevIn
             } else {
                 rotation = slerp(srcQuat[prevIndex], srcQuat[nextIndex], t);
             }
-            trsTransformManager->setRotation(trsNode, rotation);
+            result.value = rotation.xyzw;
             break;
         }
 
@@ -495,6 +566,7 @@ void AnimatorImpl::applyAnimation(const Channel& channel, float t, size_t prevIn
             const float* const samplerValues = sampler->values.data();
             assert(sampler->values.size() % times.size() == 0);
             const int valuesPerKeyframe = sampler->values.size() / times.size();
+            const size_t offset = sampledWeights.size();
 
             if (sampler->interpolation == Sampler::CUBIC) {
                 assert(valuesPerKeyframe % 3 == 0);
@@ -503,7 +575,8 @@ void AnimatorImpl::applyAnimation(const Channel& channel, float t, size_t prevIn
                 const float* const splineVerts = samplerValues + numMorphTargets;
                 const float* const outTangents = samplerValues + numMorphTargets * 2;
 
-                weights.resize(numMorphTargets);
+                sampledWeights.resize(offset + numMorphTargets);
+                float* const weights = sampledWeights.data() + offset;
                 for (int comp = 0; comp < numMorphTargets; ++comp) {
                     float vert0 = splineVerts[comp + prevIndex * valuesPerKeyframe];
                     float tang0 = outTangents[comp + prevIndex * valuesPerKeyframe];
@@ -512,21 +585,60 @@ void AnimatorImpl::applyAnimation(const Channel& channel, float t, size_t prevIn
                     weights[comp] = cubicSpline(vert0, tang0, vert1, tang1, t);
                 }
             } else {
-                weights.resize(valuesPerKeyframe);
+                sampledWeights.resize(offset + valuesPerKeyframe);
+                float* const weights = sampledWeights.data() + offset;
                 for (int comp = 0; comp < valuesPerKeyframe; ++comp) {
                     float previous = samplerValues[comp + prevIndex * valuesPerKeyframe];
                     float current = samplerValues[comp + nextIndex * valuesPerKeyframe];
                     weights[comp] = (1 - t) * previous + t * current;
                 }
             }
+            result.weightsOffset = uint32_t(offset);
+            result.weightsCount = uint32_t(sampledWeights.size() - offset);
+            break;
+        }
+    }
+}
+
+void AnimatorImpl::applySampledAnimation() {
+    if (!sampledAnimation) {
+        return;
+    }
+    const vector<Channel>& channels = sampledAnimation->channels;
+    assert_invariant(channels.size() == sampledValues.size());
+    for (size_t channelIndex = 0, n = channels.size(); channelIndex < n; ++channelIndex) {
+        const Channel& channel = channels[channelIndex];
+        const SampledValue& sample = sampledValues[channelIndex];
+        if (!sample.valid) {
+            continue;
+        }
 
+        if (channel.transformType == Channel::WEIGHTS) {
             auto ci = renderableManager->getInstance(channel.targetEntity);
-            renderableManager->setMorphWeights(ci, weights.data(), weights.size());
-            return;
+            renderableManager->setMorphWeights(ci, sampledWeights.data() + sample.weightsOffset,
+                    sample.weightsCount);
+            continue;
         }
-    }
 
-    transformManager->setTransform(node, trsTransformManager->getTransform(trsNode));
+        TrsTransformManager::Instance trsNode =
+                trsTransformManager->getInstance(channel.targetEntity);
+        TransformManager::Instance node = transformManager->getInstance(channel.targetEntity);
+        switch (channel.transformType) {
+            case Channel::SCALE:
+                trsTransformManager->setScale(trsNode, sample.value.xyz);
+                break;
+            case Channel::TRANSLATION:
+                trsTransformManager->setTranslation(trsNode, sample.value.xyz);
+                break;
+            case Channel::ROTATION:
+                trsTransformManager->setRotation(trsNode, quatf{ sample.value });
+                break;
+            case Channel::WEIGHTS:
+                break;
+        }
+        transformManager->setTransform(node, trsTransformManager->getTransform(trsNode));
+    }
+    sampledAnimation = nullptr;
 }
 
 void AnimatorImpl::resetBoneMatrices(FFilamentInstance* instance) {
@@ -545,13 +657,28 @@ void AnimatorImpl::resetBoneMatrices(FFilamentInstance* instance) {
     }
 }
 
-void AnimatorImpl::updateBoneMatrices(FFilamentInstance* instance) {
+void AnimatorImpl::computeBoneMatrices() {
+    boneMatrices.clear();
+    skinnedRenderables.clear();
+
+    // If this is a single-instance animator, then update only this instance.
+    if (instance) {
+        computeBoneMatrices(instance);
+        return;
+    }
+
+    // If this is a broadcast animator, then update all instances.
+    for (FFilamentInstance* instance : asset->mInstances) {
+        computeBoneMatrices(instance);
+    }
+}
+
+void AnimatorImpl::computeBoneMatrices(FFilamentInstance* instance) {
     assert_invariant(instance->mSkins.size() == asset->mSkins.size());
     size_t skinIndex = 0;
     for (const auto& skin : instance->mSkins) {
         const auto& assetSkin = asset->mSkins[skinIndex++];
         size_t njoints = skin.joints.size();
-        boneMatrices.resize(njoints);
         for (Entity entity : skin.targets) {
             auto renderable = renderableManager->getInstance(entity);
             if (!renderable) {
@@ -562,18 +689,28 @@ void AnimatorImpl::updateBoneMatrices(FFilamentInstance* instance) {
             if (xformable) {
                 inverseGlobalTransform = inverse(transformManager->getWorldTransformAccurate(xformable));
             }
+            const size_t offset = boneMatrices.size();
+            boneMatrices.resize(offset + njoints);
+            mat4f* const bones = boneMatrices.data() + offset;
             for (size_t boneIndex = 0; boneIndex < njoints; ++boneIndex) {
                 const auto& joint = skin.joints[boneIndex];
                 const mat4f& inverseBindMatrix = assetSkin.inverseBindMatrices[boneIndex];
                 TransformManager::Instance jointInstance = transformManager->getInstance(joint);
                 mat4 globalJointTransform = transformManager->getWorldTransformAccurate(jointInstance);
-                boneMatrices[boneIndex] =
+                bones[boneIndex] =
                         mat4f{ inverseGlobalTransform * globalJointTransform } *
                         inverseBindMatrix;
             }
-            renderableManager->setBones(renderable, boneMatrices.data(), boneMatrices.size());
+            skinnedRenderables.push_back({ renderable, uint32_t(offset), uint32_t(njoints) });
         }
     }
 }
 
+void AnimatorImpl::uploadBoneMatrices() {
+    for (const SkinnedRenderable& skinned : skinnedRenderables) {
+        renderableManager->setBones(skinned.renderable, boneMatrices.data() + skinned.boneOffset,
+                skinned.boneCount);
+    }
+}
+
 } // namespace filament::gltfio
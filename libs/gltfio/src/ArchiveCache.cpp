@@ -27,11 +27,8 @@
 #include <utils/Log.h>
 #include <utils/Panic.h>
 #include <utils/debug.h>
-#include <utils/memalign.h>
 #include <utils/ostream.h>
 
-#include <zstd.h>
-
 #include <stdint.h>
 #include <stddef.h>
 #include <string.h>
@@ -58,19 +55,32 @@ static bool strIsEqual(const CString& a, const char* b) {
     return strncmp(a.c_str(), b, a.size()) == 0;
 }
 
-void ArchiveCache::load(const void* archiveData, uint64_t archiveByteCount) {
+void ArchiveCache::load(backend::BufferDescriptor&& archive) {
     assert_invariant(mArchive == nullptr && "Do not call load() twice");
-    const uint64_t decompSize = ZSTD_getFrameContentSize(archiveData, archiveByteCount);
-    if (decompSize == ZSTD_CONTENTSIZE_UNKNOWN || decompSize == ZSTD_CONTENTSIZE_ERROR) {
-        PANIC_POSTCONDITION("Decompression error.");
+    mArchive = readArchive(archive.buffer, archive.size);
+    if (mArchive == nullptr) {
+        PANIC_POSTCONDITION("Invalid ubershader archive.");
     }
-    uint64_t* basePointer = (uint64_t*) utils::aligned_alloc(decompSize, 8);
-    ZSTD_decompress(basePointer, decompSize, archiveData, archiveByteCount);
-    mArchive = (ReadableArchive*) basePointer;
-    convertOffsetsToPointers(mArchive);
+    mArchiveData = std::move(archive);
     mMaterials = FixedCapacityVector<Material*>(mArchive->specsCount, nullptr);
 }
 
+// Packages are decompressed only when their material is first requested, then the material owns
+// a copy of the package.
+Material* ArchiveCache::getMaterial(uint64_t specIndex) {
+    if (mMaterials[specIndex] == nullptr) {
+        const ArchiveSpec& spec = mArchive->specs[specIndex];
+        FixedCapacityVector<uint8_t> package(getPackageSize(*mArchive, spec));
+        if (package.empty() || !readPackage(*mArchive, spec, package.data(), package.size())) {
+            PANIC_POSTCONDITION("Decompression error.");
+        }
+        mMaterials[specIndex] = Material::Builder()
+            .package(package.data(), package.size())
+            .build(mEngine);
+    }
+    return mMaterials[specIndex];
+}
+
 // This loops though all ubershaders and returns the first one that meets the given requirements.
 Material* ArchiveCache::getMaterial(const ArchiveRequirements& reqs) {
     assert_invariant(mArchive && "Please call load() before requesting any materials.");
@@ -131,13 +141,7 @@ Material* ArchiveCache::getMaterial(const ArchiveRequirements& reqs) {
         }
 
         if (specIsSuitable) {
-            if (mMaterials[i] == nullptr) {
-                mMaterials[i] = Material::Builder()
-                    .package(spec.package, spec.packageByteCount)
-                    .build(mEngine);
-            }
-
-            return mMaterials[i];
+            return getMaterial(i);
         }
     }
     return nullptr;
@@ -147,12 +151,7 @@ Material* ArchiveCache::getDefaultMaterial() {
     assert_invariant(mArchive && "Please call load() before requesting any materials.");
     assert_invariant(!mMaterials.empty() && "Archive must have at least one material.");
     if (!mArchive) return nullptr;
-    if (mMaterials[0] == nullptr) {
-        mMaterials[0] = Material::Builder()
-            .package(mArchive->specs[0].package, mArchive->specs[0].packageByteCount)
-            .build(mEngine);
-    }
-    return mMaterials[0];
+    return getMaterial(0);
 }
 
 void ArchiveCache::destroyMaterials() {
@@ -178,7 +177,7 @@ FeatureMap ArchiveCache::getFeatureMap(Material* material) const {
 ArchiveCache::~ArchiveCache() {
     assert_invariant(mMaterials.empty() &&
         "Please call destroyMaterials explicitly to ensure correct destruction order");
-    utils::aligned_free(mArchive);
+    destroyArchive(mArchive);
 }
 
 } // namespace filament::gltfio
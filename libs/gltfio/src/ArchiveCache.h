@@ -17,6 +17,8 @@
 #ifndef GLTFIO_ARCHIVE_CACHE_H
 #define GLTFIO_ARCHIVE_CACHE_H
 
+#include <backend/BufferDescriptor.h>
+
 #include <filament/Engine.h>
 #include <filament/Material.h>
 
@@ -41,7 +43,9 @@ namespace filament::gltfio {
         ArchiveCache(Engine& engine) : mEngine(engine) {}
         ~ArchiveCache();
 
-        void load(const void* archiveData, uint64_t archiveByteCount);
+        // Uses the archive data in place (e.g. a memory-mapped file) until the cache is destroyed.
+        void load(backend::BufferDescriptor&& archive);
+
         Material* getMaterial(const ArchiveRequirements& requirements);
         Material* getDefaultMaterial();
         const Material* const* getMaterials() const noexcept { return mMaterials.data(); }
@@ -50,9 +54,12 @@ namespace filament::gltfio {
         FeatureMap getFeatureMap(Material* material) const;
 
     private:
+        Material* getMaterial(uint64_t specIndex);
+
         Engine& mEngine;
         utils::FixedCapacityVector<Material*> mMaterials;
         uberz::ReadableArchive* mArchive = nullptr;
+        backend::BufferDescriptor mArchiveData;
     };
 
     struct ArchiveRequirements {
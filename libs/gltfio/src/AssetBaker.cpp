@@ -0,0 +1,392 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gltfio/BakedAsset.h>
+
+#include "BakedFormat.h"
+#include "FFilamentAsset.h"
+#include "FFilamentInstance.h"
+
+#include <filament/Material.h>
+#include <filament/RenderableManager.h>
+#include <filament/TransformManager.h>
+
+#include <utils/Log.h>
+
+#include <tsl/robin_map.h>
+#include <tsl/robin_set.h>
+
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace filament;
+using namespace filament::math;
+using namespace utils;
+
+namespace filament::gltfio {
+
+namespace {
+
+// Lays out the file: data is appended as it comes, and the header is written last.
+class Writer {
+public:
+    Writer() : mData(sizeof(baked::Header)) {}
+
+    baked::Blob addBlob(const void* data, size_t size) {
+        mData.resize((mData.size() + baked::ALIGNMENT - 1) & ~(baked::ALIGNMENT - 1));
+        baked::Blob const blob = { mData.size(), size };
+        mData.insert(mData.end(), (const uint8_t*) data, (const uint8_t*) data + size);
+        return blob;
+    }
+
+    template<typename T>
+    baked::Blob addArray(std::vector<T> const& items) {
+        return addBlob(items.data(), items.size() * sizeof(T));
+    }
+
+    uint32_t addString(const char* string) {
+        if (!string) {
+            return baked::NONE;
+        }
+        if (auto pos = mStringOffsets.find(string); pos != mStringOffsets.end()) {
+            return pos->second;
+        }
+        uint32_t const offset = uint32_t(mStrings.size());
+        mStrings.insert(mStrings.end(), string, string + strlen(string) + 1);
+        mStringOffsets[string] = offset;
+        return offset;
+    }
+
+    std::vector<uint8_t> finish(baked::Header header) {
+        header.strings = addArray(mStrings);
+        memcpy(mData.data(), &header, sizeof(header));
+        return std::move(mData);
+    }
+
+private:
+    std::vector<uint8_t> mData;
+    std::vector<char> mStrings;
+    tsl::robin_map<std::string, uint32_t> mStringOffsets;
+};
+
+class AssetBaker {
+public:
+    AssetBaker(FFilamentAsset const& asset, BakingData const& bakingData)
+            : mAsset(asset), mBakingData(bakingData) {}
+
+    bool bake(std::vector<uint8_t>* result);
+
+private:
+    bool addNode(Entity entity, uint32_t parent);
+    uint32_t addVertexBuffer(VertexBuffer const* vertices);
+    uint32_t addIndexBuffer(IndexBuffer const* indices);
+    uint32_t addMaterial(MaterialInstance const* mi);
+    uint32_t addTexture(Texture const* texture);
+
+    FFilamentAsset const& mAsset;
+    BakingData const& mBakingData;
+    Writer mWriter;
+
+    std::vector<baked::Node> mNodes;
+    std::vector<baked::Primitive> mPrimitives;
+    std::vector<baked::VertexBuffer> mVertexBuffers;
+    std::vector<baked::Attribute> mAttributes;
+    std::vector<baked::Blob> mBuffers;
+    std::vector<baked::IndexBuffer> mIndexBuffers;
+    std::vector<baked::Material> mMaterials;
+    std::vector<baked::Parameter> mParameters;
+    std::vector<baked::TextureBinding> mTextureBindings;
+    std::vector<baked::Texture> mTextures;
+
+    tsl::robin_map<VertexBuffer const*, uint32_t> mVertexBufferIndices;
+    tsl::robin_map<IndexBuffer const*, uint32_t> mIndexBufferIndices;
+    tsl::robin_map<MaterialInstance const*, uint32_t> mMaterialIndices;
+    tsl::robin_map<Texture const*, uint32_t> mTextureIndices;
+};
+
+bool AssetBaker::bake(std::vector<uint8_t>* result) {
+    FFilamentInstance const* instance = mAsset.mInstances[0];
+    TransformManager const& tm = mAsset.mEngine->getTransformManager();
+    tsl::robin_set<Entity, Entity::Hasher> const entities(
+            instance->mEntities.begin(), instance->mEntities.end());
+
+    // Visit the nodes breadth first, so that parents come before their children.
+    std::deque<std::pair<Entity, uint32_t>> queue = { { instance->mRoot, baked::NONE } };
+    std::vector<Entity> children;
+    while (!queue.empty()) {
+        auto const [entity, parent] = queue.front();
+        queue.pop_front();
+        uint32_t const index = uint32_t(mNodes.size());
+        if (!addNode(entity, parent)) {
+            return false;
+        }
+        auto const ti = tm.getInstance(entity);
+        children.resize(tm.getChildCount(ti));
+        tm.getChildren(ti, children.data(), children.size());
+        for (Entity child : children) {
+            // skip the entities that were attached to the asset by the application
+            if (entities.find(child) != entities.end()) {
+                queue.emplace_back(child, index);
+            }
+        }
+    }
+
+    baked::Header header{};
+    memcpy(header.magic, baked::MAGIC, sizeof(header.magic));
+    header.version = baked::VERSION;
+    header.rootNode = 0;
+    Aabb const& box = mAsset.mBoundingBox;
+    memcpy(header.boundingBoxMin, &box.min, sizeof(header.boundingBoxMin));
+    memcpy(header.boundingBoxMax, &box.max, sizeof(header.boundingBoxMax));
+    header.nodes = mWriter.addArray(mNodes);
+    header.primitives = mWriter.addArray(mPrimitives);
+    header.vertexBuffers = mWriter.addArray(mVertexBuffers);
+    header.attributes = mWriter.addArray(mAttributes);
+    header.buffers = mWriter.addArray(mBuffers);
+    header.indexBuffers = mWriter.addArray(mIndexBuffers);
+    header.materials = mWriter.addArray(mMaterials);
+    header.parameters = mWriter.addArray(mParameters);
+    header.textureBindings = mWriter.addArray(mTextureBindings);
+    header.textures = mWriter.addArray(mTextures);
+    *result = mWriter.finish(header);
+    return true;
+}
+
+bool AssetBaker::addNode(Entity entity, uint32_t parent) {
+    TransformManager const& tm = mAsset.mEngine->getTransformManager();
+    RenderableManager const& rm = mAsset.mEngine->getRenderableManager();
+
+    baked::Node node{};
+    node.parent = parent;
+    node.name = mWriter.addString(mAsset.getName(entity));
+    mat4f const transform = tm.getTransform(tm.getInstance(entity));
+    memcpy(node.transform, &transform, sizeof(node.transform));
+    node.firstPrimitive = uint32_t(mPrimitives.size());
+    node.primitiveCount = 0;
+
+    auto const renderable = mBakingData.renderables.find(entity);
+    auto const ri = rm.getInstance(entity);
+    if (renderable != mBakingData.renderables.end() && ri) {
+        Box const box = rm.getAxisAlignedBoundingBox(ri);
+        float3 const min = box.getMin();
+        float3 const max = box.getMax();
+        memcpy(node.boundingBoxMin, &min, sizeof(node.boundingBoxMin));
+        memcpy(node.boundingBoxMax, &max, sizeof(node.boundingBoxMax));
+
+        // The level of detail 0 holds the original geometry.
+        std::vector<BakingData::PrimitiveData> const& primitives = renderable->second;
+        for (size_t i = 0; i < primitives.size(); i++) {
+            BakingData::PrimitiveData const& primitive = primitives[i];
+            uint32_t const vertexBuffer = addVertexBuffer(primitive.vertices);
+            uint32_t const indexBuffer = addIndexBuffer(primitive.indices);
+            uint32_t const material = addMaterial(rm.getMaterialInstanceAt(ri, i));
+            if (vertexBuffer == baked::NONE || indexBuffer == baked::NONE ||
+                    material == baked::NONE) {
+                const char* name = mAsset.getName(entity);
+                slog.e << "Incomplete data in " << (name ? name : "renderable")
+                       << ", make sure that its resources are loaded." << io::endl;
+                return false;
+            }
+            mPrimitives.push_back({ uint32_t(primitive.type), vertexBuffer, indexBuffer,
+                    material });
+        }
+        node.primitiveCount = uint32_t(primitives.size());
+    }
+
+    mNodes.push_back(node);
+    return true;
+}
+
+uint32_t AssetBaker::addVertexBuffer(VertexBuffer const* vertices) {
+    if (auto pos = mVertexBufferIndices.find(vertices); pos != mVertexBufferIndices.end()) {
+        return pos->second;
+    }
+    auto const data = mBakingData.vertexBuffers.find(vertices);
+    if (data == mBakingData.vertexBuffers.end()) {
+        return baked::NONE;
+    }
+    BakingData::VertexData const& vertexData = data->second;
+    if (vertexData.buffers.size() != vertexData.bufferCount) {
+        return baked::NONE;
+    }
+
+    baked::VertexBuffer result{};
+    result.vertexCount = vertexData.vertexCount;
+    result.firstAttribute = uint32_t(mAttributes.size());
+    result.attributeCount = uint32_t(vertexData.attributes.size());
+    result.firstBuffer = uint32_t(mBuffers.size());
+    result.bufferCount = vertexData.bufferCount;
+    for (BakingData::Attribute const& attribute : vertexData.attributes) {
+        mAttributes.push_back({ uint8_t(attribute.attribute), attribute.bufferIndex,
+                uint8_t(attribute.type), attribute.normalized, attribute.byteOffset,
+                attribute.byteStride });
+    }
+    for (std::vector<uint8_t> const& buffer : vertexData.buffers) {
+        if (buffer.empty()) {
+            return baked::NONE;
+        }
+        mBuffers.push_back(mWriter.addBlob(buffer.data(), buffer.size()));
+    }
+
+    uint32_t const index = uint32_t(mVertexBuffers.size());
+    mVertexBuffers.push_back(result);
+    mVertexBufferIndices[vertices] = index;
+    return index;
+}
+
+uint32_t AssetBaker::addIndexBuffer(IndexBuffer const* indices) {
+    if (auto pos = mIndexBufferIndices.find(indices); pos != mIndexBufferIndices.end()) {
+        return pos->second;
+    }
+    auto const data = mBakingData.indexBuffers.find(indices);
+    if (data == mBakingData.indexBuffers.end() || data->second.data.empty()) {
+        return baked::NONE;
+    }
+    BakingData::IndexData const& indexData = data->second;
+    uint32_t const index = uint32_t(mIndexBuffers.size());
+    mIndexBuffers.push_back({ uint32_t(indexData.type), indexData.indexCount,
+            mWriter.addBlob(indexData.data.data(), indexData.data.size()) });
+    mIndexBufferIndices[indices] = index;
+    return index;
+}
+
+uint32_t AssetBaker::addMaterial(MaterialInstance const* mi) {
+    if (auto pos = mMaterialIndices.find(mi); pos != mMaterialIndices.end()) {
+        return pos->second;
+    }
+    auto const data = mBakingData.materials.find(mi);
+    if (data == mBakingData.materials.end()) {
+        return baked::NONE;
+    }
+    BakingData::MaterialData const& materialData = data->second;
+    Material const* material = mi->getMaterial();
+
+    baked::Material result{};
+    result.key = materialData.key;
+    result.uvmap = materialData.uvmap;
+    result.name = mWriter.addString(materialData.name.c_str());
+    result.maskThreshold = mi->getMaskThreshold();
+
+    result.firstParameter = uint32_t(mParameters.size());
+    std::vector<Material::ParameterInfo> parameters(material->getParameterCount());
+    material->getParameters(parameters.data(), parameters.size());
+    for (Material::ParameterInfo const& info : parameters) {
+        if (info.isSampler || info.isSubpass || info.count != 1) {
+            continue;
+        }
+        baked::Parameter parameter{};
+        bool const supported = baked::visitParameterType(info.type, [&](auto value) {
+            static_assert(sizeof(value) <= sizeof(parameter.value));
+            value = mi->getParameter<decltype(value)>(info.name);
+            memcpy(parameter.value, &value, sizeof(value));
+        });
+        if (supported) {
+            parameter.name = mWriter.addString(info.name);
+            parameter.type = uint32_t(info.type);
+            mParameters.push_back(parameter);
+        }
+    }
+    result.parameterCount = uint32_t(mParameters.size()) - result.firstParameter;
+
+    result.firstTextureBinding = uint32_t(mTextureBindings.size());
+    for (FFilamentAsset::TextureParameter const& param : mAsset.mTextureParameters) {
+        if (param.materialInstance != mi) {
+            continue;
+        }
+        uint32_t const texture = addTexture(param.texture);
+        if (texture == baked::NONE) {
+            return baked::NONE;
+        }
+        TextureSampler const& sampler = param.sampler;
+        baked::TextureBinding binding{};
+        binding.parameter = mWriter.addString(param.materialParameter);
+        binding.texture = texture;
+        binding.minFilter = uint8_t(sampler.getMinFilter());
+        binding.magFilter = uint8_t(sampler.getMagFilter());
+        binding.wrapModeS = uint8_t(sampler.getWrapModeS());
+        binding.wrapModeT = uint8_t(sampler.getWrapModeT());
+        binding.wrapModeR = uint8_t(sampler.getWrapModeR());
+        binding.anisotropy = sampler.getAnisotropy();
+        mTextureBindings.push_back(binding);
+    }
+    result.textureBindingCount = uint32_t(mTextureBindings.size()) - result.firstTextureBinding;
+
+    uint32_t const index = uint32_t(mMaterials.size());
+    mMaterials.push_back(result);
+    mMaterialIndices[mi] = index;
+    return index;
+}
+
+uint32_t AssetBaker::addTexture(Texture const* texture) {
+    if (auto pos = mTextureIndices.find(texture); pos != mTextureIndices.end()) {
+        return pos->second;
+    }
+    // Textures whose image is found in a cache share the Texture of another glTF texture.
+    for (size_t i = 0, n = mAsset.mTextures.size(); i < n; i++) {
+        auto const image = mBakingData.images.find(i);
+        if (mAsset.mTextures[i].texture != texture || image == mBakingData.images.end()) {
+            continue;
+        }
+        BakingData::ImageData const& imageData = image->second;
+        uint32_t const index = uint32_t(mTextures.size());
+        mTextures.push_back({ mWriter.addString(imageData.mimeType.c_str()),
+                uint32_t(imageData.flags),
+                mWriter.addBlob(imageData.data.data(), imageData.data.size()) });
+        mTextureIndices[texture] = index;
+        return index;
+    }
+    return baked::NONE;
+}
+
+} // anonymous namespace
+
+bool bakeAsset(FilamentAsset const* asset, const char* path) {
+    FFilamentAsset const* fAsset = downcast(asset);
+    BakingData const* bakingData = fAsset->mBakingData.get();
+    if (!bakingData) {
+        slog.e << "Unable to bake an asset loaded without keepBakingData." << io::endl;
+        return false;
+    }
+    if (bakingData->unsupportedFeature) {
+        slog.e << "Unable to bake an asset that uses " << bakingData->unsupportedFeature << "."
+               << io::endl;
+        return false;
+    }
+    if (!fAsset->mResourcesLoaded || fAsset->mInstances.empty()) {
+        slog.e << "Unable to bake an asset whose resources are not loaded." << io::endl;
+        return false;
+    }
+
+    std::vector<uint8_t> data;
+    if (!AssetBaker(*fAsset, *bakingData).bake(&data)) {
+        return false;
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    out.write((const char*) data.data(), std::streamsize(data.size()));
+    if (!out) {
+        slog.e << "Unable to write " << path << io::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace filament::gltfio
@@ -58,7 +58,9 @@
 
 #include "downcast.h"
 
+#include <algorithm>
 #include <codecvt>
+#include <float.h>
 #include <locale>
 #include <memory>
 
@@ -72,6 +74,11 @@ using SceneMask = NodeManager::SceneMask;
 
 static const auto FREE_CALLBACK = [](void* mem, size_t, void*) { free(mem); };
 
+// Screen size below which each level of detail is used, level 0 holds the original geometry.
+static constexpr float kLevelOfDetailScreenSizes[] = { 1.0f, 0.5f, 0.25f, 0.125f };
+static constexpr uint8_t kMaxGeneratedLevelOfDetailCount =
+        RenderableManager::Builder::MAX_LEVEL_OF_DETAIL_COUNT - 1;
+
 // The default glTF material.
 static constexpr cgltf_material kDefaultMat = {
     .name = (char*) "Default GLTF material",
@@ -90,6 +97,159 @@ static constexpr cgltf_material kDefaultMat = {
     },
 };
 
+// Forwards to VertexBuffer::Builder, and records the layout of the vertex buffer when the asset
+// keeps baking data.
+class VertexBufferBuilder {
+public:
+    explicit VertexBufferBuilder(BakingData* bakingData) noexcept : mBakingData(bakingData) {}
+
+    VertexBufferBuilder& enableBufferObjects() noexcept {
+        mBuilder.enableBufferObjects();
+        return *this;
+    }
+
+    VertexBufferBuilder& vertexCount(uint32_t vertexCount) noexcept {
+        mBuilder.vertexCount(vertexCount);
+        mLayout.vertexCount = vertexCount;
+        return *this;
+    }
+
+    VertexBufferBuilder& bufferCount(uint8_t bufferCount) noexcept {
+        mBuilder.bufferCount(bufferCount);
+        mLayout.bufferCount = bufferCount;
+        return *this;
+    }
+
+    VertexBufferBuilder& attribute(VertexAttribute attribute, uint8_t bufferIndex,
+            VertexBuffer::AttributeType attributeType,
+            uint32_t byteOffset = 0, uint8_t byteStride = 0) {
+        mBuilder.attribute(attribute, bufferIndex, attributeType, byteOffset, byteStride);
+        if (mBakingData) {
+            mLayout.attributes.push_back(
+                    { attribute, bufferIndex, attributeType, byteOffset, byteStride, false });
+        }
+        return *this;
+    }
+
+    VertexBufferBuilder& normalized(VertexAttribute attribute, bool normalize = true) noexcept {
+        mBuilder.normalized(attribute, normalize);
+        for (BakingData::Attribute& entry : mLayout.attributes) {
+            if (entry.attribute == attribute) {
+                entry.normalized = normalize;
+            }
+        }
+        return *this;
+    }
+
+    VertexBuffer* build(Engine& engine) {
+        VertexBuffer* vertices = mBuilder.build(engine);
+        if (mBakingData && vertices) {
+            mBakingData->vertexBuffers[vertices] = std::move(mLayout);
+        }
+        return vertices;
+    }
+
+private:
+    VertexBuffer::Builder mBuilder;
+    BakingData* const mBakingData;
+    BakingData::VertexData mLayout;
+};
+
+// Chooses the meshes whose positions can be stored as normalized shorts. The dequantization is
+// folded into the local transform of the referencing nodes, and their children are compensated, so
+// this is only done for meshes whose nodes are neither skinned, instanced, nor animated.
+static void computePositionQuantization(const cgltf_data* srcAsset,
+        FixedCapacityVector<PositionQuantization>& result) {
+    FixedCapacityVector<bool> eligible(srcAsset->meshes_count, true);
+
+    for (cgltf_size i = 0, n = srcAsset->meshes_count; i < n; ++i) {
+        const cgltf_mesh& mesh = srcAsset->meshes[i];
+        for (cgltf_size j = 0; j < mesh.primitives_count; ++j) {
+            const cgltf_primitive& prim = mesh.primitives[j];
+            const cgltf_accessor* positions = nullptr;
+            for (cgltf_size k = 0; k < prim.attributes_count; ++k) {
+                if (prim.attributes[k].type == cgltf_attribute_type_position) {
+                    positions = prim.attributes[k].data;
+                }
+            }
+            if (!positions || positions->type != cgltf_type_vec3 ||
+                    positions->component_type != cgltf_component_type_r_32f ||
+                    !positions->has_min || !positions->has_max || prim.targets_count > 0) {
+                eligible[i] = false;
+            }
+        }
+    }
+
+    auto disqualify = [srcAsset, &eligible](const cgltf_node* node) {
+        if (node && node->mesh) {
+            eligible[node->mesh - srcAsset->meshes] = false;
+        }
+    };
+    for (cgltf_size i = 0, n = srcAsset->nodes_count; i < n; ++i) {
+        const cgltf_node& node = srcAsset->nodes[i];
+        if (node.skin || node.has_mesh_gpu_instancing) {
+            disqualify(&node);
+        }
+    }
+    // An animated node loses the compensation for its parent's dequantization.
+    for (cgltf_size i = 0, n = srcAsset->animations_count; i < n; ++i) {
+        const cgltf_animation& anim = srcAsset->animations[i];
+        for (cgltf_size j = 0; j < anim.channels_count; ++j) {
+            const cgltf_node* target = anim.channels[j].target_node;
+            disqualify(target);
+            disqualify(target ? target->parent : nullptr);
+        }
+    }
+
+    for (cgltf_size i = 0, n = srcAsset->meshes_count; i < n; ++i) {
+        const cgltf_mesh& mesh = srcAsset->meshes[i];
+        if (!eligible[i] || mesh.primitives_count == 0) {
+            continue;
+        }
+        Aabb aabb;
+        for (cgltf_size j = 0; j < mesh.primitives_count; ++j) {
+            const cgltf_primitive& prim = mesh.primitives[j];
+            for (cgltf_size k = 0; k < prim.attributes_count; ++k) {
+                if (prim.attributes[k].type == cgltf_attribute_type_position) {
+                    const float* minp = &prim.attributes[k].data->min[0];
+                    const float* maxp = &prim.attributes[k].data->max[0];
+                    aabb.min = min(aabb.min, float3(minp[0], minp[1], minp[2]));
+                    aabb.max = max(aabb.max, float3(maxp[0], maxp[1], maxp[2]));
+                }
+            }
+        }
+        const float3 halfExtent = (aabb.max - aabb.min) * 0.5f;
+        result[i] = {
+            .offset = (aabb.min + aabb.max) * 0.5f,
+            .scale = std::max({ halfExtent.x, halfExtent.y, halfExtent.z, FLT_MIN }),
+        };
+    }
+}
+
+// Returns the conversion applied to a float vertex attribute when quantization is enabled.
+static FFilamentAsset::ResourceInfo::BufferSlot::Quantization getQuantization(
+        cgltf_attribute_type atype, const cgltf_accessor* accessor,
+        PositionQuantization const& quantization) {
+    using Quantization = FFilamentAsset::ResourceInfo::BufferSlot::Quantization;
+    switch (atype) {
+        case cgltf_attribute_type_position:
+            return quantization.isQuantized() ? Quantization::POSITION_SNORM16 : Quantization::NONE;
+        case cgltf_attribute_type_texcoord:
+            // Half floats are too coarse for texture coordinates that tile over large ranges, so
+            // only the coordinates known to be within [0, 1] are quantized.
+            if (accessor->type == cgltf_type_vec2 && accessor->has_min && accessor->has_max &&
+                    accessor->min[0] >= 0.0f && accessor->min[1] >= 0.0f &&
+                    accessor->max[0] <= 1.0f && accessor->max[1] <= 1.0f) {
+                return Quantization::UV_UNORM16;
+            }
+            return Quantization::NONE;
+        case cgltf_attribute_type_color:
+            return Quantization::COLOR_UNORM8;
+        default:
+            return Quantization::NONE;
+    }
+}
+
 static std::string getNodeName(cgltf_node const* node, char const* defaultNodeName) {
     auto const getNameImpl = [node, defaultNodeName]() -> char const* {
         if (node->name) return node->name;
@@ -260,7 +420,11 @@ struct FAssetLoader : public AssetLoader {
             mTransformManager(config.engine->getTransformManager()),
             mMaterials(*config.materials),
             mEngine(*config.engine),
-            mDefaultNodeName(config.defaultNodeName) {
+            mDefaultNodeName(config.defaultNodeName),
+            mLevelOfDetailCount(std::min(config.levelOfDetailCount,
+                    kMaxGeneratedLevelOfDetailCount)),
+            mQuantizeAttributes(config.quantizeAttributes),
+            mKeepBakingData(config.keepBakingData) {
         if (config.ext) {
             FILAMENT_CHECK_PRECONDITION(AssetConfigurationExtended::isSupported())
                     << "Extend asset loading is not supported on this platform";
@@ -270,6 +434,8 @@ struct FAssetLoader : public AssetLoader {
     }
 
     FFilamentAsset* createAsset(const uint8_t* bytes, uint32_t nbytes);
+    FFilamentAsset* createAsset(const uint8_t* bytes, uint32_t nbytes,
+            AssetLoader::ReleaseCallback callback, void* user);
     FFilamentAsset* createInstancedAsset(const uint8_t* bytes, uint32_t numBytes,
             FilamentInstance** instances, size_t numInstances);
     FilamentInstance* createInstance(FFilamentAsset* fAsset);
@@ -302,12 +468,18 @@ struct FAssetLoader : public AssetLoader {
 private:
     void importSkins(FFilamentInstance* instance, const cgltf_data* srcAsset);
 
+    // Parses bytes, which are either owned by glbdata or described by externalData
+    FFilamentAsset* createInstancedAsset(const uint8_t* bytes, uint32_t byteCount,
+            FilamentInstance** instances, size_t numInstances,
+            utils::FixedCapacityVector<uint8_t> glbdata,
+            FFilamentAsset::SourceAsset::ExternalData const& externalData);
+
     // Methods used during the first traveral (creation of VertexBuffer, IndexBuffer, etc)
     FFilamentAsset* createRootAsset(const cgltf_data* srcAsset);
     void recursePrimitives(const cgltf_node* rootNode, FFilamentAsset* fAsset);
     void createPrimitives(const cgltf_node* node, const char* name, FFilamentAsset* fAsset);
     bool createPrimitive(const cgltf_primitive& inPrim, const char* name, Primitive* outPrim,
-            FFilamentAsset* fAsset);
+            PositionQuantization const& quantization, FFilamentAsset* fAsset);
 
     // Methods used during subsequent traverals (creation of entities, renderables, etc)
     void createInstances(size_t numInstances, FFilamentAsset* fAsset);
@@ -344,6 +516,9 @@ public:
 
     // Transient state used only for the asset currently being loaded:
     const char* mDefaultNodeName;
+    const uint8_t mLevelOfDetailCount;
+    const bool mQuantizeAttributes;
+    const bool mKeepBakingData;
     bool mError = false;
     bool mDiagnosticsEnabled = false;
     MaterialInstanceCache mMaterialInstanceCache;
@@ -362,8 +537,28 @@ FFilamentAsset* FAssetLoader::createAsset(const uint8_t* bytes, uint32_t byteCou
     return createInstancedAsset(bytes, byteCount, &instances, 1);
 }
 
+FFilamentAsset* FAssetLoader::createAsset(const uint8_t* bytes, uint32_t byteCount,
+        AssetLoader::ReleaseCallback callback, void* user) {
+    FilamentInstance* instances;
+    return createInstancedAsset(bytes, byteCount, &instances, 1, {},
+            { bytes, byteCount, callback, user });
+}
+
 FFilamentAsset* FAssetLoader::createInstancedAsset(const uint8_t* bytes, uint32_t byteCount,
         FilamentInstance** instances, size_t numInstances) {
+    // Clients can free up their source blob immediately, but cgltf has pointers into the data that
+    // need to stay valid. Therefore we create a copy of the source blob and stash it inside the
+    // asset.
+    utils::FixedCapacityVector<uint8_t> glbdata(byteCount);
+    std::copy_n(bytes, byteCount, glbdata.data());
+    uint8_t const* const data = glbdata.data();
+    return createInstancedAsset(data, byteCount, instances, numInstances, std::move(glbdata), {});
+}
+
+FFilamentAsset* FAssetLoader::createInstancedAsset(const uint8_t* bytes, uint32_t byteCount,
+        FilamentInstance** instances, size_t numInstances,
+        utils::FixedCapacityVector<uint8_t> glbdata,
+        FFilamentAsset::SourceAsset::ExternalData const& externalData) {
     // This method can be used to load JSON or GLB. By using a default options struct, we are asking
     // cgltf to examine the magic identifier to determine which type of file is being loaded.
     cgltf_options options {};
@@ -382,17 +577,18 @@ FFilamentAsset* FAssetLoader::createInstancedAsset(const uint8_t* bytes, uint32_
         options.file.release = [](const cgltf_memory_options*, const cgltf_file_options*, void*) {};
     }
 
-    // Clients can free up their source blob immediately, but cgltf has pointers into the data that
-    // need to stay valid. Therefore we create a copy of the source blob and stash it inside the
-    // asset.
-    utils::FixedCapacityVector<uint8_t> glbdata(byteCount);
-    std::copy_n(bytes, byteCount, glbdata.data());
+    auto releaseExternalData = [&externalData]() {
+        if (externalData.release) {
+            externalData.release(externalData.bytes, externalData.size, externalData.user);
+        }
+    };
 
     // The ownership of an allocated `sourceAsset` will be moved to FFilamentAsset::mSourceAsset.
     cgltf_data* sourceAsset;
-    cgltf_result result = cgltf_parse(&options, glbdata.data(), byteCount, &sourceAsset);
+    cgltf_result result = cgltf_parse(&options, bytes, byteCount, &sourceAsset);
     if (result != cgltf_result_success) {
         slog.e << "Unable to parse glTF file." << io::endl;
+        releaseExternalData();
         return nullptr;
     }
 
@@ -401,9 +597,13 @@ FFilamentAsset* FAssetLoader::createInstancedAsset(const uint8_t* bytes, uint32_
         delete fAsset;
         fAsset = nullptr;
         mError = false;
+        releaseExternalData();
         return nullptr;
     }
+
+    // From now on, the source data is released with the source asset.
     glbdata.swap(fAsset->mSourceAsset->glbData);
+    fAsset->mSourceAsset->externalData = externalData;
 
     createInstances(numInstances, fAsset);
     if (mError) {
@@ -485,6 +685,18 @@ FFilamentAsset* FAssetLoader::createRootAsset(const cgltf_data* srcAsset) {
     FFilamentAsset* fAsset = new FFilamentAsset(&mEngine, mNameManager, &mEntityManager,
             &mNodeManager, &mTrsTransformManager, srcAsset, (bool) mLoaderExtended);
 
+    // Levels of detail are generated from the cgltf accessors, which the extended algorithm
+    // doesn't keep around.
+    fAsset->mLevelOfDetailCount = mLoaderExtended ? 0 : mLevelOfDetailCount;
+
+    if (mQuantizeAttributes && !mLoaderExtended) {
+        computePositionQuantization(srcAsset, fAsset->mPositionQuantization);
+    }
+
+    if (mKeepBakingData && !mLoaderExtended) {
+        fAsset->mBakingData = std::make_unique<BakingData>();
+    }
+
     // It is not an error for a glTF file to have zero scenes.
     fAsset->mScenes.clear();
     if (srcAsset->scenes == nullptr) {
@@ -607,6 +819,23 @@ void FAssetLoader::recurseEntities(const cgltf_node* node, SceneMask scenes, Ent
                 mTrsTransformManager.getInstance(entity));
     }
 
+    // The dequantization of the mesh positions is folded into the node's transform, which its
+    // children have to undo.
+    if (node->parent && node->parent->mesh) {
+        PositionQuantization const& quantization =
+                fAsset->mPositionQuantization[node->parent->mesh - srcAsset->meshes];
+        if (quantization.isQuantized()) {
+            localTransform = inverse(quantization.getDequantizationTransform()) * localTransform;
+        }
+    }
+    if (node->mesh) {
+        PositionQuantization const& quantization =
+                fAsset->mPositionQuantization[node->mesh - srcAsset->meshes];
+        if (quantization.isQuantized()) {
+            localTransform = localTransform * quantization.getDequantizationTransform();
+        }
+    }
+
     auto parentTransform = mTransformManager.getInstance(parent);
     mTransformManager.create(entity, parentTransform, localTransform);
 
@@ -704,7 +933,8 @@ void FAssetLoader::createPrimitives(const cgltf_node* node, const char* name,
             } else {
                 // Create a Filament VertexBuffer and IndexBuffer for this prim if we haven't
                 // already.
-                mError = !createPrimitive(inputPrim, name, &outputPrim, fAsset);
+                mError = !createPrimitive(inputPrim, name, &outputPrim,
+                        fAsset->mPositionQuantization[mesh - gltf->meshes], fAsset);
             }
             if (mError) {
                 return;
@@ -741,7 +971,10 @@ void FAssetLoader::createRenderable(const cgltf_node* node, Entity entity, const
 
     // glTF spec says that all primitives must have the same number of morph targets.
     const cgltf_size numMorphTargets = inputPrim ? inputPrim->targets_count : 0;
-    RenderableManager::Builder builder(primitiveCount);
+
+    // Each level of detail is a copy of the mesh's primitives, with its own simplified indices.
+    const size_t levelCount = 1 + fAsset->mLevelOfDetailCount;
+    RenderableManager::Builder builder(primitiveCount * levelCount);
 
     // For each prim, create a Filament VertexBuffer, IndexBuffer, and MaterialInstance.
     // The VertexBuffer and IndexBuffer objects are cached for possible re-use, but MaterialInstance
@@ -772,10 +1005,17 @@ void FAssetLoader::createRenderable(const cgltf_node* node, Entity entity, const
         }
 
         fAsset->mDependencyGraph.addEdge(entity, mi);
-        builder.material(index, mi);
+        for (size_t level = 0; level < levelCount; ++level) {
+            builder.material(level * primitiveCount + index, mi);
+        }
 
         assert_invariant(outputPrim->vertices);
 
+        if (BakingData* bakingData = fAsset->mBakingData.get()) {
+            bakingData->renderables[entity].push_back(
+                    { primType, outputPrim->vertices, outputPrim->indices });
+        }
+
         // Expand the object-space bounding box.
         aabb.min = min(outputPrim->aabb.min, aabb.min);
         aabb.max = max(outputPrim->aabb.max, aabb.max);
@@ -786,13 +1026,38 @@ void FAssetLoader::createRenderable(const cgltf_node* node, Entity entity, const
         // view and accessor features already have this functionality.
         builder.geometry(index, primType, outputPrim->vertices, outputPrim->indices);
 
+        // The simplified indices only exist once ResourceLoader has run, until then the levels
+        // of detail are left empty and ResourceLoader fills them in. Only triangles are
+        // simplified, other primitive types use their original indices at every level.
+        for (size_t level = 1; level < levelCount; ++level) {
+            IndexBuffer* lodIndices = nullptr;
+            if (level <= outputPrim->lodIndices.size()) {
+                lodIndices = outputPrim->lodIndices[level - 1];
+            } else if (inputPrim->type != cgltf_primitive_type_triangles) {
+                lodIndices = outputPrim->indices;
+            }
+            if (lodIndices) {
+                builder.geometry(level * primitiveCount + index, primType,
+                        outputPrim->vertices, lodIndices);
+            }
+        }
+
         if (numMorphTargets) {
             outputPrim->morphTargetOffset = morphingVertexCount;    // FIXME: can I do that here?
-            builder.morphing(0, index, morphingVertexCount);
+            for (size_t level = 0; level < levelCount; ++level) {
+                builder.morphing(0, level * primitiveCount + index, morphingVertexCount);
+            }
             morphingVertexCount += outputPrim->vertices->getVertexCount();
         }
     }
 
+    if (levelCount > 1) {
+        for (size_t level = 0; level < levelCount; ++level) {
+            builder.levelOfDetail(uint8_t(level), level * primitiveCount, primitiveCount,
+                    kLevelOfDetailScreenSizes[level]);
+        }
+    }
+
     if (numMorphTargets) {
         MorphTargetBuffer* morphTargetBuffer = MorphTargetBuffer::Builder()
                 .count(numMorphTargets)
@@ -873,8 +1138,22 @@ void FAssetLoader::createRenderable(const cgltf_node* node, Entity entity, const
         builder.skinning(node->skin->joints_count);
     }
 
+    if (BakingData* bakingData = fAsset->mBakingData.get()) {
+        if (node->skin) {
+            bakingData->unsupportedFeature = "skinning";
+        } else if (numMorphTargets) {
+            bakingData->unsupportedFeature = "morph targets";
+        }
+    }
+
     // Per the spec, glTF models must have valid mix / max annotations for position attributes.
     // If desired, clients can call "recomputeBoundingBoxes()" in FilamentInstance.
+    // Quantized positions are bounded in the space of the normalized shorts.
+    PositionQuantization const& quantization =
+            fAsset->mPositionQuantization[mesh - srcAsset->meshes];
+    if (quantization.isQuantized()) {
+        aabb = aabb.transform(inverse(quantization.getDequantizationTransform()));
+    }
     Box box = Box().set(aabb.min, aabb.max);
     if (box.isEmpty()) {
         slog.w << "Missing bounding box in " << name << io::endl;
@@ -922,13 +1201,16 @@ void FAssetLoader::createMaterialVariants(const cgltf_mesh* mesh, Entity entity,
                 break;
             }
             fAsset->mDependencyGraph.addEdge(entity, mi);
-            instance->mVariants[variantIndex].mappings.push_back({entity, prim, mi});
+            for (size_t level = 0; level <= fAsset->mLevelOfDetailCount; ++level) {
+                instance->mVariants[variantIndex].mappings.push_back(
+                        {entity, level * n + prim, mi});
+            }
         }
     }
 }
 
 bool FAssetLoader::createPrimitive(const cgltf_primitive& inPrim, const char* name,
-        Primitive* outPrim, FFilamentAsset* fAsset) {
+        Primitive* outPrim, PositionQuantization const& quantization, FFilamentAsset* fAsset) {
 
     using BufferSlot = FFilamentAsset::ResourceInfo::BufferSlot;
 
@@ -962,6 +1244,10 @@ bool FAssetLoader::createPrimitive(const cgltf_primitive& inPrim, const char* na
             .bufferType(indexType)
             .build(mEngine);
 
+        if (BakingData* bakingData = fAsset->mBakingData.get()) {
+            bakingData->indexBuffers[indices] = { indexType, uint32_t(accessor->count) };
+        }
+
         FFilamentAsset::ResourceInfo::BufferSlot slot = { accessor };
         slot.indexBuffer = indices;
         addBufferSlot(slot);
@@ -979,12 +1265,16 @@ bool FAssetLoader::createPrimitive(const cgltf_primitive& inPrim, const char* na
         for (size_t i = 0; i < vertexCount; ++i) {
             indexData[i] = i;
         }
+        if (BakingData* bakingData = fAsset->mBakingData.get()) {
+            bakingData->indexBuffers[indices] = { IndexBuffer::IndexType::UINT, vertexCount };
+            bakingData->setIndexData(indices, indexData, indexDataSize);
+        }
         IndexBuffer::BufferDescriptor bd(indexData, indexDataSize, FREE_CALLBACK);
         indices->setBuffer(mEngine, std::move(bd));
     }
     fAsset->mIndexBuffers.push_back(indices);
 
-    VertexBuffer::Builder vbb;
+    VertexBufferBuilder vbb(fAsset->mBakingData.get());
     vbb.enableBufferObjects();
 
     bool hasUv0 = false, hasUv1 = false, hasVertexColor = false, hasNormals = false;
@@ -1093,6 +1383,26 @@ bool FAssetLoader::createPrimitive(const cgltf_primitive& inPrim, const char* na
         }
         const int stride = (fatype == actualType) ? accessor->stride : 0;
 
+        // Float attributes can be stored in smaller normalized types, ResourceLoader converts
+        // the data when it uploads the buffers.
+        BufferSlot::Quantization quantize = BufferSlot::Quantization::NONE;
+        if (mQuantizeAttributes && accessor->component_type == cgltf_component_type_r_32f) {
+            quantize = getQuantization(atype, accessor, quantization);
+        }
+        if (quantize != BufferSlot::Quantization::NONE) {
+            using AttributeType = VertexBuffer::AttributeType;
+            vbb.attribute(semantic, slot,
+                    quantize == BufferSlot::Quantization::POSITION_SNORM16 ? AttributeType::SHORT4 :
+                    quantize == BufferSlot::Quantization::UV_UNORM16 ? AttributeType::USHORT2 :
+                    AttributeType::UBYTE4);
+            vbb.normalized(semantic);
+            BufferSlot entry{ accessor, atype, slot++ };
+            entry.quantization = quantize;
+            entry.positionQuantization = quantization;
+            addBufferSlot(entry);
+            continue;
+        }
+
         // The cgltf library provides a stride value for all accessors, even though they do not
         // exist in the glTF file. It is computed from the type and the stride of the buffer view.
         // As a convenience, cgltf also replaces zero (default) stride with the actual stride.
@@ -1254,6 +1564,10 @@ bool FAssetLoader::createPrimitive(const cgltf_primitive& inPrim, const char* na
             mDummyBufferObject->setBuffer(mEngine, std::move(bd));
         }
         vertices->setBufferObjectAt(mEngine, slot, mDummyBufferObject);
+        if (BakingData* bakingData = fAsset->mBakingData.get()) {
+            std::vector<uint8_t> const dummyData(sizeof(ubyte4) * vertexCount, 0xff);
+            bakingData->setVertexData(vertices, slot, dummyData.data(), dummyData.size());
+        }
     }
 
     return true;
@@ -1483,6 +1797,10 @@ MaterialInstance* FAssetLoader::createMaterialInstance(const cgltf_material* inp
         return nullptr;
     }
 
+    if (BakingData* bakingData = fAsset->mBakingData.get()) {
+        bakingData->materials[mi] = { matkey, *uvmap, inputMat->name ? inputMat->name : "" };
+    }
+
     auto mrConfig = inputMat->pbr_metallic_roughness;
     auto sgConfig = inputMat->pbr_specular_glossiness;
     auto ccConfig = inputMat->clearcoat;
@@ -1763,6 +2081,11 @@ FilamentAsset* AssetLoader::createAsset(uint8_t const* bytes, uint32_t nbytes) {
     return downcast(this)->createAsset(bytes, nbytes);
 }
 
+FilamentAsset* AssetLoader::createAsset(uint8_t const* bytes, uint32_t nbytes,
+        ReleaseCallback callback, void* user) {
+    return downcast(this)->createAsset(bytes, nbytes, callback, user);
+}
+
 FilamentAsset* AssetLoader::createInstancedAsset(const uint8_t* bytes, uint32_t numBytes,
         FilamentInstance** instances, size_t numInstances) {
     return downcast(this)->createInstancedAsset(bytes, numBytes, instances, numInstances);
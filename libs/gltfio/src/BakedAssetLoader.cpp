@@ -0,0 +1,576 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gltfio/BakedAsset.h>
+
+#include <gltfio/MaterialProvider.h>
+#include <gltfio/TextureProvider.h>
+
+#include "BakedFormat.h"
+#include "downcast.h"
+
+#include <filament/Engine.h>
+#include <filament/IndexBuffer.h>
+#include <filament/MaterialInstance.h>
+#include <filament/RenderableManager.h>
+#include <filament/Texture.h>
+#include <filament/TextureSampler.h>
+#include <filament/TransformManager.h>
+#include <filament/VertexBuffer.h>
+
+#include <utils/EntityManager.h>
+#include <utils/Log.h>
+#include <utils/NameComponentManager.h>
+
+#include <tsl/robin_map.h>
+
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace filament;
+using namespace filament::math;
+using namespace utils;
+
+namespace filament::gltfio {
+
+struct FBakedAsset : public BakedAsset {
+    std::vector<Entity> mEntities;              // in node order, the root comes first
+    std::vector<Entity> mRenderables;
+    std::vector<MaterialInstance*> mMaterialInstances;
+    std::vector<VertexBuffer*> mVertexBuffers;
+    std::vector<IndexBuffer*> mIndexBuffers;
+    std::vector<Texture*> mTextures;
+    Aabb mBoundingBox;
+};
+
+FILAMENT_DOWNCAST(BakedAsset)
+
+namespace {
+
+// Keeps the file alive until all the buffers that point into it have been uploaded.
+struct SharedData {
+    backend::BufferDescriptor data;
+    std::atomic<uint32_t> refs;
+
+    static void release(void*, size_t, void* user) {
+        SharedData* const shared = (SharedData*) user;
+        if (shared->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete shared;
+        }
+    }
+
+    backend::BufferDescriptor slice(baked::Blob const& blob) {
+        refs.fetch_add(1, std::memory_order_relaxed);
+        return { (const uint8_t*) data.buffer + blob.offset, size_t(blob.size), &release, this };
+    }
+};
+
+// Checks the structure of a baked file before anything is created from it, so that a corrupt
+// file is rejected instead of causing out-of-bounds reads.
+class Reader {
+public:
+    Reader(const uint8_t* data, size_t size) : mData(data), mSize(size) {}
+
+    bool read();
+
+    baked::Header const* header = nullptr;
+    baked::Node const* nodes = nullptr;
+    baked::Primitive const* primitives = nullptr;
+    baked::VertexBuffer const* vertexBuffers = nullptr;
+    baked::Attribute const* attributes = nullptr;
+    baked::Blob const* buffers = nullptr;
+    baked::IndexBuffer const* indexBuffers = nullptr;
+    baked::Material const* materials = nullptr;
+    baked::Parameter const* parameters = nullptr;
+    baked::TextureBinding const* textureBindings = nullptr;
+    baked::Texture const* textures = nullptr;
+    const char* strings = nullptr;
+
+    size_t nodeCount = 0;
+    size_t primitiveCount = 0;
+    size_t vertexBufferCount = 0;
+    size_t attributeCount = 0;
+    size_t bufferCount = 0;
+    size_t indexBufferCount = 0;
+    size_t materialCount = 0;
+    size_t parameterCount = 0;
+    size_t textureBindingCount = 0;
+    size_t textureCount = 0;
+    size_t stringsSize = 0;
+
+    const uint8_t* getData(baked::Blob const& blob) const { return mData + blob.offset; }
+
+    const char* getString(uint32_t offset) const {
+        return offset == baked::NONE ? nullptr : strings + offset;
+    }
+
+private:
+    bool isValid(baked::Blob const& blob) const {
+        return blob.offset % baked::ALIGNMENT == 0 && blob.offset <= mSize &&
+               blob.size <= mSize - blob.offset;
+    }
+
+    bool isValidString(uint32_t offset, bool optional) const {
+        return offset < stringsSize || (optional && offset == baked::NONE);
+    }
+
+    static bool isValidRange(uint32_t first, uint32_t count, size_t size) {
+        return first <= size && count <= size - first;
+    }
+
+    template<typename T>
+    bool getArray(baked::Blob const& blob, T const*& items, size_t& count) const {
+        if (!isValid(blob) || blob.size % sizeof(T) != 0) {
+            return false;
+        }
+        items = (T const*) (mData + blob.offset);
+        count = blob.size / sizeof(T);
+        return true;
+    }
+
+    const uint8_t* mData;
+    size_t mSize;
+};
+
+bool Reader::read() {
+    if (uintptr_t(mData) % alignof(baked::Blob) != 0 || mSize < sizeof(baked::Header)) {
+        return false;
+    }
+    header = (baked::Header const*) mData;
+    if (memcmp(header->magic, baked::MAGIC, sizeof(header->magic)) != 0) {
+        return false;
+    }
+    if (header->version != baked::VERSION) {
+        slog.e << "Unsupported baked asset version " << header->version << io::endl;
+        return false;
+    }
+
+    if (!getArray(header->nodes, nodes, nodeCount) ||
+            !getArray(header->primitives, primitives, primitiveCount) ||
+            !getArray(header->vertexBuffers, vertexBuffers, vertexBufferCount) ||
+            !getArray(header->attributes, attributes, attributeCount) ||
+            !getArray(header->buffers, buffers, bufferCount) ||
+            !getArray(header->indexBuffers, indexBuffers, indexBufferCount) ||
+            !getArray(header->materials, materials, materialCount) ||
+            !getArray(header->parameters, parameters, parameterCount) ||
+            !getArray(header->textureBindings, textureBindings, textureBindingCount) ||
+            !getArray(header->textures, textures, textureCount) ||
+            !getArray(header->strings, strings, stringsSize)) {
+        return false;
+    }
+
+    // Every string must be terminated within the string table.
+    if (stringsSize && strings[stringsSize - 1] != '\0') {
+        return false;
+    }
+
+    if (header->rootNode != 0 || nodeCount == 0) {
+        return false;
+    }
+    for (size_t i = 0; i < nodeCount; i++) {
+        baked::Node const& node = nodes[i];
+        bool const validParent = i == 0 ? node.parent == baked::NONE : node.parent < i;
+        if (!validParent || !isValidString(node.name, true) ||
+                !isValidRange(node.firstPrimitive, node.primitiveCount, primitiveCount)) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < primitiveCount; i++) {
+        baked::Primitive const& primitive = primitives[i];
+        if (primitive.type > uint32_t(RenderableManager::PrimitiveType::TRIANGLE_STRIP) ||
+                primitive.vertexBuffer >= vertexBufferCount ||
+                primitive.indexBuffer >= indexBufferCount ||
+                primitive.material >= materialCount) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < vertexBufferCount; i++) {
+        baked::VertexBuffer const& vb = vertexBuffers[i];
+        if (vb.bufferCount == 0 || vb.bufferCount > backend::MAX_VERTEX_BUFFER_COUNT ||
+                !isValidRange(vb.firstAttribute, vb.attributeCount, attributeCount) ||
+                !isValidRange(vb.firstBuffer, vb.bufferCount, bufferCount)) {
+            return false;
+        }
+        for (uint32_t j = 0; j < vb.attributeCount; j++) {
+            baked::Attribute const& attribute = attributes[vb.firstAttribute + j];
+            if (attribute.attribute >= backend::MAX_VERTEX_ATTRIBUTE_COUNT ||
+                    attribute.bufferIndex >= vb.bufferCount ||
+                    attribute.type > uint8_t(VertexBuffer::AttributeType::HALF4)) {
+                return false;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < bufferCount; i++) {
+        if (!isValid(buffers[i])) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < indexBufferCount; i++) {
+        baked::IndexBuffer const& ib = indexBuffers[i];
+        size_t const indexSize = ib.type == uint32_t(IndexBuffer::IndexType::USHORT) ? 2 :
+                                 ib.type == uint32_t(IndexBuffer::IndexType::UINT)   ? 4 : 0;
+        if (!indexSize || !isValid(ib.data) || ib.data.size != size_t(ib.indexCount) * indexSize) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < materialCount; i++) {
+        baked::Material const& material = materials[i];
+        if (!isValidString(material.name, true) ||
+                !isValidRange(material.firstParameter, material.parameterCount, parameterCount) ||
+                !isValidRange(material.firstTextureBinding, material.textureBindingCount,
+                        textureBindingCount)) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < parameterCount; i++) {
+        baked::Parameter const& parameter = parameters[i];
+        if (!isValidString(parameter.name, false) ||
+                !baked::visitParameterType(Material::ParameterType(parameter.type), [](auto) {})) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < textureBindingCount; i++) {
+        baked::TextureBinding const& binding = textureBindings[i];
+        if (!isValidString(binding.parameter, false) || binding.texture >= textureCount) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < textureCount; i++) {
+        baked::Texture const& texture = textures[i];
+        if (!isValidString(texture.mimeType, false) || !isValid(texture.data)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // anonymous namespace
+
+struct FBakedAssetLoader : public BakedAssetLoader {
+    explicit FBakedAssetLoader(BakedAssetConfiguration const& config)
+            : mEngine(config.engine),
+              mMaterials(config.materials),
+              mNameManager(config.names),
+              mEntityManager(config.entities ? *config.entities : EntityManager::get()) {}
+
+    BakedAsset* createAsset(backend::BufferDescriptor&& data);
+    void destroyAsset(FBakedAsset const* asset);
+
+private:
+    bool createTextures(Reader const& reader, FBakedAsset* asset);
+    void createMaterials(Reader const& reader, FBakedAsset* asset);
+    void createBuffers(Reader const& reader, SharedData* shared, FBakedAsset* asset);
+    void createEntities(Reader const& reader, FBakedAsset* asset);
+
+public:
+    Engine* const mEngine;
+    MaterialProvider* const mMaterials;
+    NameComponentManager* const mNameManager;
+    EntityManager& mEntityManager;
+    tsl::robin_map<std::string, TextureProvider*> mTextureProviders;
+};
+
+FILAMENT_DOWNCAST(BakedAssetLoader)
+
+BakedAsset* FBakedAssetLoader::createAsset(backend::BufferDescriptor&& data) {
+    // The loader holds one reference until it's done, then each buffer upload holds one.
+    SharedData* const shared = new SharedData{ std::move(data), 1 };
+    Reader reader((const uint8_t*) shared->data.buffer, shared->data.size);
+    if (!reader.read()) {
+        slog.e << "Invalid baked asset." << io::endl;
+        SharedData::release(nullptr, 0, shared);
+        return nullptr;
+    }
+
+    FBakedAsset* asset = new FBakedAsset();
+    baked::Header const& header = *reader.header;
+    asset->mBoundingBox = { float3(header.boundingBoxMin[0], header.boundingBoxMin[1],
+            header.boundingBoxMin[2]), float3(header.boundingBoxMax[0], header.boundingBoxMax[1],
+            header.boundingBoxMax[2]) };
+
+    if (!createTextures(reader, asset)) {
+        SharedData::release(nullptr, 0, shared);
+        destroyAsset(asset);
+        return nullptr;
+    }
+    createMaterials(reader, asset);
+    createBuffers(reader, shared, asset);
+    createEntities(reader, asset);
+
+    SharedData::release(nullptr, 0, shared);
+    return asset;
+}
+
+bool FBakedAssetLoader::createTextures(Reader const& reader, FBakedAsset* asset) {
+    asset->mTextures.reserve(reader.textureCount);
+    bool success = true;
+    for (size_t i = 0; i < reader.textureCount; i++) {
+        baked::Texture const& texture = reader.textures[i];
+        const char* mimeType = reader.getString(texture.mimeType);
+        auto const provider = mTextureProviders.find(mimeType);
+        if (provider == mTextureProviders.end()) {
+            slog.e << "No texture provider for " << mimeType << io::endl;
+            success = false;
+            break;
+        }
+        Texture* result = provider->second->pushTexture(reader.getData(texture.data),
+                size_t(texture.data.size), mimeType,
+                TextureProvider::TextureFlags(texture.flags));
+        if (!result) {
+            slog.e << "Unable to create texture: " << provider->second->getPushMessage()
+                   << io::endl;
+            success = false;
+            break;
+        }
+        asset->mTextures.push_back(result);
+    }
+
+    // Textures are used as soon as the asset is created, so wait for all of them to be decoded.
+    for (auto const& [mimeType, provider] : mTextureProviders) {
+        provider->waitForCompletion();
+        provider->updateQueue();
+        while (Texture* texture = provider->popTexture()) {
+            (void) texture;
+        }
+    }
+    return success;
+}
+
+void FBakedAssetLoader::createMaterials(Reader const& reader, FBakedAsset* asset) {
+    asset->mMaterialInstances.reserve(reader.materialCount);
+    for (size_t i = 0; i < reader.materialCount; i++) {
+        baked::Material const& material = reader.materials[i];
+        MaterialKey key = material.key;
+        UvMap uvmap = material.uvmap;
+        MaterialInstance* mi = mMaterials->createMaterialInstance(&key, &uvmap,
+                reader.getString(material.name), nullptr);
+        asset->mMaterialInstances.push_back(mi);
+        if (!mi) {
+            continue;
+        }
+
+        for (uint32_t j = 0; j < material.parameterCount; j++) {
+            baked::Parameter const& parameter = reader.parameters[material.firstParameter + j];
+            const char* name = reader.getString(parameter.name);
+            if (!mi->getMaterial()->hasParameter(name)) {
+                continue;
+            }
+            baked::visitParameterType(Material::ParameterType(parameter.type), [&](auto value) {
+                memcpy(&value, parameter.value, sizeof(value));
+                mi->setParameter(name, value);
+            });
+        }
+
+        for (uint32_t j = 0; j < material.textureBindingCount; j++) {
+            baked::TextureBinding const& binding =
+                    reader.textureBindings[material.firstTextureBinding + j];
+            const char* name = reader.getString(binding.parameter);
+            if (!mi->getMaterial()->hasParameter(name)) {
+                continue;
+            }
+            TextureSampler sampler(TextureSampler::MinFilter(binding.minFilter),
+                    TextureSampler::MagFilter(binding.magFilter),
+                    TextureSampler::WrapMode(binding.wrapModeS),
+                    TextureSampler::WrapMode(binding.wrapModeT),
+                    TextureSampler::WrapMode(binding.wrapModeR));
+            sampler.setAnisotropy(binding.anisotropy);
+            mi->setParameter(name, asset->mTextures[binding.texture], sampler);
+        }
+
+        if (mi->getMaterial()->getBlendingMode() == BlendingMode::MASKED) {
+            mi->setMaskThreshold(material.maskThreshold);
+        }
+    }
+}
+
+void FBakedAssetLoader::createBuffers(Reader const& reader, SharedData* shared,
+        FBakedAsset* asset) {
+    asset->mVertexBuffers.reserve(reader.vertexBufferCount);
+    for (size_t i = 0; i < reader.vertexBufferCount; i++) {
+        baked::VertexBuffer const& vb = reader.vertexBuffers[i];
+        VertexBuffer::Builder builder;
+        builder.vertexCount(vb.vertexCount).bufferCount(uint8_t(vb.bufferCount));
+        for (uint32_t j = 0; j < vb.attributeCount; j++) {
+            baked::Attribute const& attribute = reader.attributes[vb.firstAttribute + j];
+            builder.attribute(VertexAttribute(attribute.attribute), attribute.bufferIndex,
+                    VertexBuffer::AttributeType(attribute.type), attribute.byteOffset,
+                    uint8_t(attribute.byteStride));
+            if (attribute.normalized) {
+                builder.normalized(VertexAttribute(attribute.attribute));
+            }
+        }
+        VertexBuffer* vertices = builder.build(*mEngine);
+        for (uint32_t slot = 0; slot < vb.bufferCount; slot++) {
+            vertices->setBufferAt(*mEngine, uint8_t(slot),
+                    shared->slice(reader.buffers[vb.firstBuffer + slot]));
+        }
+        asset->mVertexBuffers.push_back(vertices);
+    }
+
+    asset->mIndexBuffers.reserve(reader.indexBufferCount);
+    for (size_t i = 0; i < reader.indexBufferCount; i++) {
+        baked::IndexBuffer const& ib = reader.indexBuffers[i];
+        IndexBuffer* indices = IndexBuffer::Builder()
+                .indexCount(ib.indexCount)
+                .bufferType(IndexBuffer::IndexType(ib.type))
+                .build(*mEngine);
+        indices->setBuffer(*mEngine, shared->slice(ib.data));
+        asset->mIndexBuffers.push_back(indices);
+    }
+}
+
+void FBakedAssetLoader::createEntities(Reader const& reader, FBakedAsset* asset) {
+    TransformManager& tm = mEngine->getTransformManager();
+    asset->mEntities.resize(reader.nodeCount);
+    mEntityManager.create(reader.nodeCount, asset->mEntities.data());
+
+    for (size_t i = 0; i < reader.nodeCount; i++) {
+        baked::Node const& node = reader.nodes[i];
+        Entity const entity = asset->mEntities[i];
+
+        mat4f transform;
+        memcpy(&transform, node.transform, sizeof(transform));
+        TransformManager::Instance const parent = node.parent == baked::NONE ?
+                TransformManager::Instance{} :
+                tm.getInstance(asset->mEntities[node.parent]);
+        tm.create(entity, parent, transform);
+
+        if (const char* name = reader.getString(node.name); name && mNameManager) {
+            mNameManager->addComponent(entity);
+            mNameManager->setName(mNameManager->getInstance(entity), name);
+        }
+
+        if (node.primitiveCount == 0) {
+            continue;
+        }
+        RenderableManager::Builder builder(node.primitiveCount);
+        for (uint32_t j = 0; j < node.primitiveCount; j++) {
+            baked::Primitive const& primitive = reader.primitives[node.firstPrimitive + j];
+            builder.geometry(j, RenderableManager::PrimitiveType(primitive.type),
+                    asset->mVertexBuffers[primitive.vertexBuffer],
+                    asset->mIndexBuffers[primitive.indexBuffer]);
+            if (MaterialInstance* mi = asset->mMaterialInstances[primitive.material]) {
+                builder.material(j, mi);
+            }
+        }
+        Box box;
+        box.set(float3(node.boundingBoxMin[0], node.boundingBoxMin[1], node.boundingBoxMin[2]),
+                float3(node.boundingBoxMax[0], node.boundingBoxMax[1], node.boundingBoxMax[2]));
+        builder.boundingBox(box)
+                .culling(true)
+                .castShadows(true)
+                .receiveShadows(true)
+                .build(*mEngine, entity);
+        asset->mRenderables.push_back(entity);
+    }
+}
+
+void FBakedAssetLoader::destroyAsset(FBakedAsset const* asset) {
+    if (!asset) {
+        return;
+    }
+    if (mNameManager) {
+        for (Entity entity : asset->mEntities) {
+            mNameManager->removeComponent(entity);
+        }
+    }
+    for (Entity entity : asset->mEntities) {
+        mEngine->destroy(entity);
+    }
+    mEntityManager.destroy(asset->mEntities.size(),
+            const_cast<Entity*>(asset->mEntities.data()));
+    for (MaterialInstance* mi : asset->mMaterialInstances) {
+        if (mi) {
+            mEngine->destroy(mi);
+        }
+    }
+    for (VertexBuffer* vb : asset->mVertexBuffers) {
+        mEngine->destroy(vb);
+    }
+    for (IndexBuffer* ib : asset->mIndexBuffers) {
+        mEngine->destroy(ib);
+    }
+    for (Texture* texture : asset->mTextures) {
+        mEngine->destroy(texture);
+    }
+    delete asset;
+}
+
+Entity BakedAsset::getRoot() const noexcept {
+    return downcast(this)->mEntities[0];
+}
+
+const Entity* BakedAsset::getEntities() const noexcept {
+    return downcast(this)->mEntities.data();
+}
+
+size_t BakedAsset::getEntityCount() const noexcept {
+    return downcast(this)->mEntities.size();
+}
+
+const Entity* BakedAsset::getRenderableEntities() const noexcept {
+    return downcast(this)->mRenderables.data();
+}
+
+size_t BakedAsset::getRenderableEntityCount() const noexcept {
+    return downcast(this)->mRenderables.size();
+}
+
+MaterialInstance* const* BakedAsset::getMaterialInstances() const noexcept {
+    return downcast(this)->mMaterialInstances.data();
+}
+
+size_t BakedAsset::getMaterialInstanceCount() const noexcept {
+    return downcast(this)->mMaterialInstances.size();
+}
+
+Aabb BakedAsset::getBoundingBox() const noexcept {
+    return downcast(this)->mBoundingBox;
+}
+
+BakedAssetLoader* BakedAssetLoader::create(BakedAssetConfiguration const& config) {
+    return new FBakedAssetLoader(config);
+}
+
+void BakedAssetLoader::destroy(BakedAssetLoader** loader) {
+    delete downcast(*loader);
+    *loader = nullptr;
+}
+
+void BakedAssetLoader::addTextureProvider(const char* mimeType, TextureProvider* provider) {
+    downcast(this)->mTextureProviders[mimeType] = provider;
+}
+
+BakedAsset* BakedAssetLoader::createAsset(backend::BufferDescriptor&& data) {
+    return downcast(this)->createAsset(std::move(data));
+}
+
+void BakedAssetLoader::destroyAsset(BakedAsset const* asset) {
+    downcast(this)->destroyAsset(downcast(asset));
+}
+
+} // namespace filament::gltfio
@@ -0,0 +1,275 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GLTFIO_BAKEDFORMAT_H
+#define GLTFIO_BAKEDFORMAT_H
+
+#include <gltfio/MaterialProvider.h>
+#include <gltfio/TextureProvider.h>
+
+#include <filament/IndexBuffer.h>
+#include <filament/Material.h>
+#include <filament/MaterialInstance.h>
+#include <filament/RenderableManager.h>
+#include <filament/VertexBuffer.h>
+
+#include <math/mat3.h>
+#include <math/vec2.h>
+#include <math/vec3.h>
+#include <math/vec4.h>
+
+#include <utils/Entity.h>
+
+#include <tsl/robin_map.h>
+
+#include <string>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace filament::gltfio {
+
+// Layout of the files written by bakeAsset() and read by BakedAssetLoader.
+//
+// A baked file starts with a Header, followed by arrays of the structures below and by the raw
+// vertex, index and image data. Every array and every blob of data starts on an ALIGNMENT
+// boundary, so the file can be used in place once it's mapped in memory. All values are little
+// endian. Strings are referenced by their offset in the string table, which holds null-terminated
+// strings.
+namespace baked {
+
+constexpr char MAGIC[8] = { 'G', 'L', 'T', 'F', 'B', 'A', 'K', 'E' };
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t NONE = UINT32_MAX;
+constexpr size_t ALIGNMENT = 16;
+
+// A range of bytes in the file; also used for arrays, whose count is size / sizeof(element).
+struct Blob {
+    uint64_t offset;
+    uint64_t size;
+};
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t rootNode;
+    float boundingBoxMin[3];
+    float boundingBoxMax[3];
+    Blob nodes;             // Node[]
+    Blob primitives;        // Primitive[]
+    Blob vertexBuffers;     // VertexBuffer[]
+    Blob attributes;        // Attribute[]
+    Blob buffers;           // Blob[], the contents of each vertex buffer slot
+    Blob indexBuffers;      // IndexBuffer[]
+    Blob materials;         // Material[]
+    Blob parameters;        // Parameter[]
+    Blob textureBindings;   // TextureBinding[]
+    Blob textures;          // Texture[]
+    Blob strings;           // char[]
+};
+
+// Nodes are sorted so that parents come before their children.
+struct Node {
+    uint32_t parent;            // index of the parent node, or NONE for the root
+    uint32_t name;              // string, or NONE
+    float transform[16];        // local transform, column major
+    uint32_t firstPrimitive;
+    uint32_t primitiveCount;    // 0 for nodes that aren't renderables
+    float boundingBoxMin[3];    // object-space bounding box of the renderable
+    float boundingBoxMax[3];
+};
+
+struct Primitive {
+    uint32_t type;              // RenderableManager::PrimitiveType
+    uint32_t vertexBuffer;
+    uint32_t indexBuffer;
+    uint32_t material;
+};
+
+struct VertexBuffer {
+    uint32_t vertexCount;
+    uint32_t firstAttribute;
+    uint32_t attributeCount;
+    uint32_t firstBuffer;
+    uint32_t bufferCount;
+    uint32_t reserved;
+};
+
+struct Attribute {
+    uint8_t attribute;          // VertexAttribute
+    uint8_t bufferIndex;
+    uint8_t type;               // VertexBuffer::AttributeType
+    uint8_t normalized;
+    uint32_t byteOffset;
+    uint32_t byteStride;
+};
+
+struct IndexBuffer {
+    uint32_t type;              // IndexBuffer::IndexType
+    uint32_t indexCount;
+    Blob data;
+};
+
+struct Material {
+    MaterialKey key;
+    UvMap uvmap;
+    uint32_t name;              // string, or NONE
+    float maskThreshold;
+    uint32_t firstParameter;
+    uint32_t parameterCount;
+    uint32_t firstTextureBinding;
+    uint32_t textureBindingCount;
+};
+
+// The value of a uniform parameter, stored as it is passed to MaterialInstance::setParameter().
+struct Parameter {
+    uint32_t name;              // string
+    uint32_t type;              // Material::ParameterType
+    uint32_t value[12];
+};
+
+struct TextureBinding {
+    uint32_t parameter;         // string
+    uint32_t texture;
+    uint8_t minFilter;          // TextureSampler::MinFilter
+    uint8_t magFilter;          // TextureSampler::MagFilter
+    uint8_t wrapModeS;          // TextureSampler::WrapMode
+    uint8_t wrapModeT;
+    uint8_t wrapModeR;
+    uint8_t reserved[3];
+    float anisotropy;
+};
+
+// The encoded image (e.g. KTX2 or PNG), decoded by a TextureProvider when the asset is loaded.
+struct Texture {
+    uint32_t mimeType;          // string
+    uint32_t flags;             // TextureProvider::TextureFlags
+    Blob data;
+};
+
+static_assert(sizeof(Header) == 216);
+static_assert(sizeof(Node) == 104);
+static_assert(sizeof(Primitive) == 16);
+static_assert(sizeof(VertexBuffer) == 24);
+static_assert(sizeof(Attribute) == 12);
+static_assert(sizeof(IndexBuffer) == 24);
+static_assert(sizeof(Material) == 52);
+static_assert(sizeof(Parameter) == 56);
+static_assert(sizeof(TextureBinding) == 20);
+static_assert(sizeof(Texture) == 24);
+
+// Calls f() with a value of the C++ type of the given parameter type. Returns false for the types
+// that aren't baked: booleans and 4x4 matrices can't be read back, and glTF materials don't use
+// them.
+template<typename F>
+bool visitParameterType(filament::Material::ParameterType type, F&& f) {
+    using ParameterType = filament::Material::ParameterType;
+    switch (type) {
+        case ParameterType::FLOAT:  f(float{});          return true;
+        case ParameterType::FLOAT2: f(math::float2{});   return true;
+        case ParameterType::FLOAT3: f(math::float3{});   return true;
+        case ParameterType::FLOAT4: f(math::float4{});   return true;
+        case ParameterType::INT:    f(int32_t{});        return true;
+        case ParameterType::INT2:   f(math::int2{});     return true;
+        case ParameterType::INT3:   f(math::int3{});     return true;
+        case ParameterType::INT4:   f(math::int4{});     return true;
+        case ParameterType::UINT:   f(uint32_t{});       return true;
+        case ParameterType::UINT2:  f(math::uint2{});    return true;
+        case ParameterType::UINT3:  f(math::uint3{});    return true;
+        case ParameterType::UINT4:  f(math::uint4{});    return true;
+        case ParameterType::MAT3:   f(math::mat3f{});    return true;
+        default:                                         return false;
+    }
+}
+
+} // namespace baked
+
+// The post-processed data of an asset, recorded while it loads when
+// AssetConfiguration::keepBakingData is set, so that bakeAsset() can save it.
+struct BakingData {
+    struct Attribute {
+        VertexAttribute attribute;
+        uint8_t bufferIndex;
+        VertexBuffer::AttributeType type;
+        uint32_t byteOffset;
+        uint8_t byteStride;
+        bool normalized;
+    };
+
+    struct VertexData {
+        uint32_t vertexCount = 0;
+        uint8_t bufferCount = 0;
+        std::vector<Attribute> attributes;
+        std::vector<std::vector<uint8_t>> buffers;     // indexed by buffer slot
+    };
+
+    struct IndexData {
+        IndexBuffer::IndexType type;
+        uint32_t indexCount;
+        std::vector<uint8_t> data;
+    };
+
+    struct PrimitiveData {
+        RenderableManager::PrimitiveType type;
+        VertexBuffer const* vertices;
+        IndexBuffer const* indices;
+    };
+
+    struct MaterialData {
+        MaterialKey key;
+        UvMap uvmap;
+        std::string name;
+    };
+
+    struct ImageData {
+        std::vector<uint8_t> data;
+        std::string mimeType;
+        TextureProvider::TextureFlags flags;
+    };
+
+    void setVertexData(VertexBuffer const* vertices, size_t slot, const void* data, size_t size) {
+        std::vector<std::vector<uint8_t>>& buffers = vertexBuffers[vertices].buffers;
+        if (buffers.size() <= slot) {
+            buffers.resize(slot + 1);
+        }
+        buffers[slot].assign((const uint8_t*) data, (const uint8_t*) data + size);
+    }
+
+    void setIndexData(IndexBuffer const* indices, const void* data, size_t size) {
+        indexBuffers[indices].data.assign((const uint8_t*) data, (const uint8_t*) data + size);
+    }
+
+    void setImageData(size_t textureIndex, const uint8_t* data, size_t size,
+            std::string const& mimeType, TextureProvider::TextureFlags flags) {
+        images[textureIndex] = { { data, data + size }, mimeType, flags };
+    }
+
+    tsl::robin_map<VertexBuffer const*, VertexData> vertexBuffers;
+    tsl::robin_map<IndexBuffer const*, IndexData> indexBuffers;
+    tsl::robin_map<utils::Entity, std::vector<PrimitiveData>, utils::Entity::Hasher> renderables;
+    tsl::robin_map<MaterialInstance const*, MaterialData> materials;
+
+    // encoded images, indexed like FFilamentAsset::mTextures
+    tsl::robin_map<size_t, ImageData> images;
+
+    // the reason why the asset can't be baked, if any
+    const char* unsupportedFeature = nullptr;
+};
+
+} // namespace filament::gltfio
+
+#endif // GLTFIO_BAKEDFORMAT_H
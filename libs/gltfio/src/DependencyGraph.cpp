@@ -18,6 +18,8 @@
 
 #include <utils/Panic.h>
 
+#include <utility>
+
 using namespace filament;
 using namespace utils;
 
@@ -138,6 +140,29 @@ DependencyGraph::TextureNode* DependencyGraph::getStatus(Texture* texture) {
     return iter->second.get();
 }
 
+void DependencyGraph::replaceMaterial(Material* from, Material* to) {
+    if (auto iter = mMaterialToEntity.find(from); iter != mMaterialToEntity.end()) {
+        tsl::robin_set<Entity, Entity::Hasher> entities = std::move(iter.value());
+        mMaterialToEntity.erase(iter);
+        for (auto entity : entities) {
+            auto& materials = mEntityToMaterial.at(entity).materials;
+            materials.erase(from);
+            materials.insert(to);
+        }
+        mMaterialToEntity[to] = std::move(entities);
+    }
+    if (auto iter = mMaterialToTexture.find(from); iter != mMaterialToTexture.end()) {
+        MaterialNode node = std::move(iter.value());
+        mMaterialToTexture.erase(iter);
+        mMaterialToTexture[to] = std::move(node);
+    }
+    for (auto iter = mTextureToMaterial.begin(); iter != mTextureToMaterial.end(); ++iter) {
+        if (iter.value().erase(from)) {
+            iter.value().insert(to);
+        }
+    }
+}
+
 void DependencyGraph::disableProgressiveReveal() {
     mDisabled = true;
     for (auto& [entity, status] : mEntityToMaterial) {
@@ -79,6 +79,10 @@ public:
     // Marks the given texture as being fully decoded, with all miplevels initialized.
     void markAsReady(Texture* texture);
 
+    // Moves all the edges of the given material to another one, e.g. when a material instance is
+    // replaced by a specialized version of itself.
+    void replaceMaterial(Material* from, Material* to);
+
     // Causes the dependency graph to enter a disabled state, whereby adding Entity <=> Material
     // edges will immediately mark the entity as ready without actually growing the graph.
     void disableProgressiveReveal();
@@ -21,12 +21,15 @@
 #endif
 
 #include <utils/compiler.h>
+#include <utils/JobSystem.h>
 #include <utils/Log.h>
 
+#include <algorithm>
+#include <vector>
+
 #if GLTFIO_DRACO_SUPPORTED
 
 #include <memory>
-#include <vector>
 
 using std::unique_ptr;
 using std::vector;
@@ -49,6 +52,40 @@ DracoMesh* DracoCache::findOrCreateMesh(const cgltf_buffer_view* key) {
     return mesh;
 }
 
+void DracoCache::decodeMeshes(JobSystem& js, const cgltf_buffer_view* const* keys,
+        size_t const count) {
+    // Only the decoding runs in parallel, the cache itself is not thread-safe.
+    std::vector<const cgltf_buffer_view*> pending;
+    pending.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        const cgltf_buffer_view* key = keys[i];
+        if (mCache.find(key) == mCache.end() &&
+                std::find(pending.begin(), pending.end(), key) == pending.end()) {
+            assert(key->buffer && key->buffer->data);
+            pending.push_back(key);
+        }
+    }
+    if (pending.empty()) {
+        return;
+    }
+
+    std::vector<DracoMesh*> meshes(pending.size());
+    JobSystem::Job* parent = js.createJob();
+    for (size_t i = 0; i < pending.size(); i++) {
+        const cgltf_buffer_view* key = pending[i];
+        DracoMesh*& result = meshes[i];
+        js.run(jobs::createJob(js, parent, [key, &result] {
+            const uint8_t* compressedData = key->offset + (uint8_t*) key->buffer->data;
+            result = DracoMesh::decode(compressedData, key->size);
+        }));
+    }
+    js.runAndWait(parent);
+
+    for (size_t i = 0; i < pending.size(); i++) {
+        mCache.emplace(pending[i], meshes[i]);
+    }
+}
+
 DracoMesh::DracoMesh(struct DracoMeshDetails* details) : mDetails(details) {}
 
 #if GLTFIO_DRACO_SUPPORTED
@@ -23,6 +23,12 @@
 
 #include <memory>
 
+#include <stddef.h>
+
+namespace utils {
+class JobSystem;
+} // namespace utils
+
 #ifndef GLTFIO_DRACO_SUPPORTED
 #define GLTFIO_DRACO_SUPPORTED 0
 #endif
@@ -38,6 +44,10 @@ class DracoMesh;
 class DracoCache {
 public:
     DracoMesh* findOrCreateMesh(const cgltf_buffer_view* key);
+
+    // Decodes the meshes that are not in the cache yet, each mesh in its own job. Returns once
+    // all of them are decoded and added to the cache.
+    void decodeMeshes(utils::JobSystem& js, const cgltf_buffer_view* const* keys, size_t count);
 private:
     tsl::robin_map<const cgltf_buffer_view*, std::unique_ptr<DracoMesh>> mCache;
 };
@@ -42,11 +42,14 @@
 #include <cgltf.h>
 
 #include "downcast.h"
+#include "BakedFormat.h"
 #include "DependencyGraph.h"
 #include "DracoCache.h"
 #include "FFilamentInstance.h"
+#include "TextureCache.h"
 #include "Utility.h"
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <variant>
@@ -99,9 +102,24 @@ struct Primitive {
     MorphTargetBuffer* morphTargetBuffer = nullptr;
     uint32_t morphTargetOffset;
     std::vector<int> slotIndices;
+    std::vector<IndexBuffer*> lodIndices; // simplified indices of each generated level of detail
 };
 using MeshCache = utils::FixedCapacityVector<utils::FixedCapacityVector<Primitive>>;
 
+// Meshes whose positions are stored as normalized shorts have their dequantization folded into the
+// local transform of the nodes that reference them: mesh position = offset + scale * quantized.
+// The scale is uniform so that the normals and tangents don't need to be adjusted.
+struct PositionQuantization {
+    math::float3 offset = {};
+    float scale = 0.0f; // zero for meshes that keep their positions as is
+
+    bool isQuantized() const noexcept { return scale > 0.0f; }
+
+    math::mat4f getDequantizationTransform() const noexcept {
+        return math::mat4f::translation(offset) * math::mat4f::scaling(scale);
+    }
+};
+
 struct FFilamentAsset : public FilamentAsset {
     struct ResourceInfo;
     struct ResourceInfoExtended;
@@ -114,7 +132,8 @@ struct FFilamentAsset : public FilamentAsset {
             mNodeManager(nodeManager), mTrsTransformManager(trsTransformManager),
             mSourceAsset(new SourceAsset {(cgltf_data*)srcAsset}),
             mTextures(srcAsset->textures_count),
-            mMeshCache(srcAsset->meshes_count) {
+            mMeshCache(srcAsset->meshes_count),
+            mPositionQuantization(srcAsset->meshes_count) {
         if (!useExtendedAlgo) {
             mResourceInfo = ResourceInfo{};
         } else {
@@ -246,6 +265,20 @@ struct FFilamentAsset : public FilamentAsset {
     // to the dependency graph used for gradual reveal of entities.
     void applyTextureBinding(size_t textureIndex,const TextureSlot& tb, bool addDependency = true);
 
+    // Replaces a material instance owned by this asset everywhere it is referenced (renderables,
+    // variants, texture bindings), sets its textures on the new instance, and destroys it.
+    // Uniform parameters must be copied by the caller.
+    void replaceMaterialInstance(MaterialInstance* from, MaterialInstance* to);
+
+    // Texture parameters set on material instances, so that they can be set again when a
+    // material instance is replaced.
+    struct TextureParameter {
+        MaterialInstance* materialInstance;
+        const char* materialParameter;
+        Texture* texture;
+        TextureSampler sampler;
+    };
+
     struct Skin {
         utils::CString name;
         utils::FixedCapacityVector<math::mat4f> inverseBindMatrices;
@@ -260,6 +293,7 @@ struct FFilamentAsset : public FilamentAsset {
     std::vector<utils::Entity> mLightEntities;
     std::vector<utils::Entity> mCameraEntities;
     size_t mRenderableCount = 0;
+    uint8_t mLevelOfDetailCount = 0; // generated levels of detail, in addition to the original
     std::vector<VertexBuffer*> mVertexBuffers;
     std::vector<BufferObject*> mBufferObjects;
     std::vector<IndexBuffer*> mIndexBuffers;
@@ -286,10 +320,23 @@ struct FFilamentAsset : public FilamentAsset {
     // Encapsulates reference-counted source data, which includes the cgltf hierachy
     // and potentially also includes buffer data that can be uploaded to the GPU.
     struct SourceAsset {
-        ~SourceAsset() { cgltf_free(hierarchy); }
+        // content that is used in place rather than copied into glbData
+        struct ExternalData {
+            uint8_t const* bytes = nullptr;
+            size_t size = 0;
+            void (*release)(void const* bytes, size_t size, void* user) = nullptr;
+            void* user = nullptr;
+        };
+        ~SourceAsset() {
+            cgltf_free(hierarchy);
+            if (externalData.release) {
+                externalData.release(externalData.bytes, externalData.size, externalData.user);
+            }
+        }
         cgltf_data* hierarchy;
         DracoCache dracoCache;
         utils::FixedCapacityVector<uint8_t> glbData;
+        ExternalData externalData;
     };
 
     // We used shared ownership for the raw cgltf data in order to permit ResourceLoader to
@@ -304,23 +351,38 @@ struct FFilamentAsset : public FilamentAsset {
     // Stores all information related to a single cgltf_texture.
     // Note that more than one cgltf_texture can map to a single Filament texture,
     // e.g. if several have the same URL or bufferView. For each Filament texture,
-    // only one of its corresponding TextureInfo slots will have isOwner=true.
+    // only one of its corresponding TextureInfo slots will have isOwner=true. Textures that come
+    // from the ResourceLoader's shared cache are never owned, instead each slot that uses one
+    // has isShared=true and holds a reference to it.
     struct TextureInfo {
         std::vector<TextureSlot> bindings;
         Texture* texture;
         TextureProvider::TextureFlags flags;
         bool isOwner;
+        bool isShared;
     };
 
     // Mapping from cgltf_texture to Texture* is required when creating new instances.
     utils::FixedCapacityVector<TextureInfo> mTextures;
 
+    std::vector<TextureParameter> mTextureParameters;
+
+    // Set if any of the textures is shared with other assets.
+    TextureCacheHandle mTextureCache;
+
     // Resource URIs can be queried by the end user.
     utils::FixedCapacityVector<const char*> mResourceUris;
 
     // The mapping from cgltf_mesh to VertexBuffer* (etc) is required when creating new instances.
     MeshCache mMeshCache;
 
+    // One entry per cgltf_mesh, kept after the source data is released because the bounding boxes
+    // of the renderables are expressed in quantized space.
+    utils::FixedCapacityVector<PositionQuantization> mPositionQuantization;
+
+    // Only exists when the asset is loaded with AssetConfiguration::keepBakingData.
+    std::unique_ptr<BakingData> mBakingData;
+
     // Asset information that is produced by AssetLoader and consumed by ResourceLoader:
     struct ResourceInfo {
         // Encapsulates VertexBuffer::setBufferAt() or IndexBuffer::setBuffer().
@@ -333,6 +395,16 @@ struct FFilamentAsset : public FilamentAsset {
             MorphTargetBuffer* morphTargetBuffer;
             uint32_t morphTargetOffset;
             uint32_t morphTargetCount;
+
+            // Vertex attributes that are converted to a smaller type when they are uploaded.
+            enum class Quantization : uint8_t {
+                NONE,
+                POSITION_SNORM16,   // float3 to normalized short4, see PositionQuantization
+                UV_UNORM16,         // float2 in [0, 1] to normalized ushort2
+                COLOR_UNORM8,       // float3 or float4 to normalized ubyte4
+            };
+            Quantization quantization = Quantization::NONE;
+            PositionQuantization positionQuantization = {};
         };
 
         std::vector<BufferSlot> mBufferSlots;
@@ -87,9 +87,11 @@ FFilamentAsset::~FFilamentAsset() {
     for (auto ib : mIndexBuffers) {
         mEngine->destroy(ib);
     }
-    for (auto tx : mTextures) {
+    for (auto const& tx : mTextures) {
         if (UTILS_LIKELY(tx.isOwner)) {
             mEngine->destroy(tx.texture);
+        } else if (tx.isShared) {
+            mTextureCache->release(tx.texture);
         }
     }
     for (auto tb : mMorphTargetBuffers) {
@@ -153,11 +155,71 @@ void FFilamentAsset::applyTextureBinding(size_t textureIndex, const TextureSlot&
         sampler.setMinFilter(TextureSampler::MinFilter::LINEAR_MIPMAP_LINEAR);
     }
     tb.materialInstance->setParameter(tb.materialParameter, info.texture, sampler);
+    mTextureParameters.push_back({ tb.materialInstance, tb.materialParameter, info.texture,
+            sampler });
     if (addDependency) {
         mDependencyGraph.addEdge(info.texture, tb.materialInstance, tb.materialParameter);
     }
 }
 
+void FFilamentAsset::replaceMaterialInstance(MaterialInstance* from, MaterialInstance* to) {
+    for (auto& param : mTextureParameters) {
+        if (param.materialInstance == from) {
+            to->setParameter(param.materialParameter, param.texture, param.sampler);
+            param.materialInstance = to;
+        }
+    }
+
+    // Textures that are still loading will be set on the new instance.
+    for (auto& info : mTextures) {
+        for (auto& slot : info.bindings) {
+            if (slot.materialInstance == from) {
+                slot.materialInstance = to;
+            }
+        }
+    }
+    mDependencyGraph.replaceMaterial(from, to);
+
+    if (mBakingData) {
+        auto& materials = mBakingData->materials;
+        if (auto pos = materials.find(from); pos != materials.end()) {
+            BakingData::MaterialData data = std::move(pos.value());
+            materials.erase(pos);
+            materials[to] = std::move(data);
+        }
+    }
+
+    for (FFilamentInstance* instance : mInstances) {
+        for (auto& mi : instance->mMaterialInstances) {
+            if (mi == from) {
+                mi = to;
+            }
+        }
+        for (auto& variant : instance->mVariants) {
+            for (auto& mapping : variant.mappings) {
+                if (mapping.material == from) {
+                    mapping.material = to;
+                }
+            }
+        }
+    }
+
+    RenderableManager& rm = mEngine->getRenderableManager();
+    for (Entity entity : mEntities) {
+        auto const ri = rm.getInstance(entity);
+        if (!ri) {
+            continue;
+        }
+        for (size_t prim = 0, count = rm.getPrimitiveCount(ri); prim < count; prim++) {
+            if (rm.getMaterialInstanceAt(ri, prim) == from) {
+                rm.setMaterialInstanceAt(ri, prim, to);
+            }
+        }
+    }
+
+    mEngine->destroy(from);
+}
+
 const char* FFilamentAsset::getMorphTargetNameAt(utils::Entity entity,
         size_t targetIndex) const noexcept {
     if (!mResourcesLoaded) {
@@ -306,6 +306,13 @@ void FFilamentInstance::recomputeBoundingBoxes() {
                 aabb.min = min(aabb.min, primBounds.min);
                 aabb.max = max(aabb.max, primBounds.max);
             }
+            // Quantized positions are bounded in the space of the normalized shorts, whose
+            // dequantization is part of the node's transform.
+            PositionQuantization const& quantization =
+                    mOwner->mPositionQuantization[mesh - mOwner->mSourceAsset->hierarchy->meshes];
+            if (quantization.isQuantized()) {
+                aabb = aabb.transform(inverse(quantization.getDequantizationTransform()));
+            }
             auto renderable = rm.getInstance(entity);
             rm.setAxisAlignedBoundingBox(renderable, Box().set(aabb.min, aabb.max));
 
@@ -18,11 +18,30 @@
 
 #include <filamat/MaterialBuilder.h>
 
+#include <filament/MaterialEnums.h>
+
 #include <utils/Hash.h>
+#include <utils/JobSystem.h>
+#include <utils/Log.h>
+#include <utils/Path.h>
 
 #include <tsl/robin_map.h>
 
+#include "FFilamentAsset.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 using namespace filamat;
 using namespace filament;
@@ -33,7 +52,7 @@ namespace {
 
 class JitShaderProvider : public MaterialProvider {
 public:
-    explicit JitShaderProvider(Engine* engine, bool optimizeShaders);
+    JitShaderProvider(Engine* engine, bool optimizeShaders, const char* cacheDirectory);
     ~JitShaderProvider() override;
 
     MaterialInstance* createMaterialInstance(MaterialKey* config, UvMap* uvmap,
@@ -49,16 +68,32 @@ public:
         return false;
     }
 
+    // Returns the package of the given material, from the cache when possible. This doesn't
+    // change the state of the provider or the engine, so it can be called from any thread.
+    std::vector<uint8_t> getPackage(const MaterialKey& config, const UvMap& uvmap,
+            const char* label, JobSystem& js, bool useCache) const;
+
+    Path getCachePath(const MaterialKey& config, const std::string& shader,
+            bool optimizeShaders) const;
+
     using HashFn = hash::MurmurHashFn<MaterialKey>;
     tsl::robin_map<MaterialKey, Material*, HashFn> mCache;
     std::vector<Material*> mMaterials;
     Engine* const mEngine;
     const bool mOptimizeShaders;
+    const std::string mCacheDirectory;
 };
 
-JitShaderProvider::JitShaderProvider(Engine* engine, bool optimizeShaders) : mEngine(engine),
-        mOptimizeShaders(optimizeShaders) {
+JitShaderProvider::JitShaderProvider(Engine* engine, bool optimizeShaders,
+        const char* cacheDirectory) : mEngine(engine), mOptimizeShaders(optimizeShaders),
+        mCacheDirectory(cacheDirectory ? cacheDirectory : "") {
     MaterialBuilder::init();
+    if (!mCacheDirectory.empty()) {
+        Path const directory(mCacheDirectory);
+        if (!directory.isDirectory() && !directory.mkdirRecursive()) {
+            slog.w << "Unable to create the material cache directory " << directory << io::endl;
+        }
+    }
 }
 
 JitShaderProvider::~JitShaderProvider() {
@@ -343,10 +378,8 @@ std::string shaderFromKey(const MaterialKey& config) {
     return shader;
 }
 
-Material* createMaterial(Engine* engine, const MaterialKey& config, const UvMap& uvmap,
-        const char* name, bool optimizeShaders) {
-    std::string shader = shaderFromKey(config);
-    processShaderString(&shader, uvmap, config);
+Package buildPackage(Engine* engine, const MaterialKey& config, const UvMap& uvmap,
+        const std::string& shader, const char* name, bool optimizeShaders, JobSystem& js) {
     MaterialBuilder builder;
     builder.name(name)
            .flipUV(false)
@@ -581,21 +614,102 @@ Material* createMaterial(Engine* engine, const MaterialKey& config, const UvMap&
         builder.shading(Shading::LIT);
     }
 
-    Package pkg = builder.build(engine->getJobSystem());
-    return Material::Builder().package(pkg.getData(), pkg.getSize()).build(*engine);
+    return builder.build(js);
 }
 
-Material* JitShaderProvider::getMaterial(MaterialKey* config, UvMap* uvmap, const char* label) {
-    constrainMaterial(config, uvmap);
-    auto iter = mCache.find(*config);
-    if (iter == mCache.end()) {
+std::vector<uint8_t> readCachedPackage(const Path& path) {
+    std::vector<uint8_t> buffer;
+    if (!path.exists()) {
+        return buffer;
+    }
+    std::ifstream in(path, std::ifstream::in | std::ifstream::binary);
+    buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    if (in.bad()) {
+        buffer.clear();
+    }
+    return buffer;
+}
 
-        bool optimizeShaders = mOptimizeShaders;
+void writeCachedPackage(const Path& path, const Package& pkg) {
+    // Write to a temporary file first, so that other processes never see a partial package.
+    std::string const temporary = path.getPath() + ".tmp";
+    {
+        std::ofstream out(temporary, std::ofstream::out | std::ofstream::binary);
+        out.write((const char*) pkg.getData(), (std::streamsize) pkg.getSize());
+        if (!out) {
+            slog.w << "Unable to write the cached material " << temporary << io::endl;
+            return;
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+    }
+}
+
+// The cached package depends on the generated shader, the material key, the settings of the
+// engine that are baked into the package, and the version of the material format.
+Path JitShaderProvider::getCachePath(const MaterialKey& config, const std::string& shader,
+        bool optimizeShaders) const {
+    size_t seed = std::hash<std::string_view>{}(shader);
+    hash::combine(seed, HashFn{}(config));
+    hash::combine(seed, MATERIAL_VERSION);
+    hash::combine(seed, uint32_t(mEngine->getBackend()));
+    hash::combine(seed, uint32_t(mEngine->getConfig().stereoscopicType));
+    hash::combine(seed, uint32_t(mEngine->getConfig().stereoscopicEyeCount));
+    hash::combine(seed, optimizeShaders);
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.filamat", (unsigned long long) seed);
+    return Path(mCacheDirectory).concat(name);
+}
+
+std::vector<uint8_t> JitShaderProvider::getPackage(const MaterialKey& config,
+        const UvMap& uvmap, const char* label, JobSystem& js, bool useCache) const {
+    bool optimizeShaders = mOptimizeShaders;
 #ifndef NDEBUG
-        optimizeShaders = false;
+    optimizeShaders = false;
 #endif
 
-        Material* mat = createMaterial(mEngine, *config, *uvmap, label, optimizeShaders);
+    std::string shader = shaderFromKey(config);
+    processShaderString(&shader, uvmap, config);
+
+    Path cachePath;
+    if (!mCacheDirectory.empty()) {
+        cachePath = getCachePath(config, shader, optimizeShaders);
+        if (useCache) {
+            std::vector<uint8_t> cached = readCachedPackage(cachePath);
+            if (!cached.empty()) {
+                return cached;
+            }
+        }
+    }
+
+    Package const pkg = buildPackage(mEngine, config, uvmap, shader, label, optimizeShaders, js);
+    if (!pkg.isValid()) {
+        return {};
+    }
+    if (!cachePath.isEmpty()) {
+        writeCachedPackage(cachePath, pkg);
+    }
+    return { pkg.getData(), pkg.getData() + pkg.getSize() };
+}
+
+Material* buildMaterial(Engine* engine, const std::vector<uint8_t>& package) {
+    if (package.empty()) {
+        return nullptr;
+    }
+    return Material::Builder().package(package.data(), package.size()).build(*engine);
+}
+
+Material* JitShaderProvider::getMaterial(MaterialKey* config, UvMap* uvmap, const char* label) {
+    constrainMaterial(config, uvmap);
+    auto iter = mCache.find(*config);
+    if (iter == mCache.end()) {
+        JobSystem& js = mEngine->getJobSystem();
+        Material* mat = buildMaterial(mEngine, getPackage(*config, *uvmap, label, js, true));
+        if (!mat && !mCacheDirectory.empty()) {
+            // the cached package may be damaged, build it again
+            mat = buildMaterial(mEngine, getPackage(*config, *uvmap, label, js, false));
+        }
         mCache.emplace(std::make_pair(*config, mat));
         mMaterials.push_back(mat);
         return mat;
@@ -608,12 +722,325 @@ MaterialInstance* JitShaderProvider::createMaterialInstance(MaterialKey* config,
     return getMaterial(config, uvmap, label)->createInstance(label);
 }
 
+template<typename T>
+void copyParameter(const MaterialInstance* from, MaterialInstance* to, const char* name) {
+    to->setParameter(name, from->getParameter<T>(name));
+}
+
+// Copies the uniform parameters that both material instances have in common.
+void copyParameters(const MaterialInstance* from, MaterialInstance* to) {
+    using ParameterInfo = Material::ParameterInfo;
+    using ParameterType = Material::ParameterType;
+
+    const Material* src = from->getMaterial();
+    const Material* dst = to->getMaterial();
+    std::vector<ParameterInfo> srcParameters(src->getParameterCount());
+    std::vector<ParameterInfo> dstParameters(dst->getParameterCount());
+    src->getParameters(srcParameters.data(), srcParameters.size());
+    dst->getParameters(dstParameters.data(), dstParameters.size());
+
+    for (const ParameterInfo& param : dstParameters) {
+        if (param.isSampler || param.isSubpass || param.count != 1) {
+            continue;
+        }
+        auto const match = std::find_if(srcParameters.begin(), srcParameters.end(),
+                [&param](const ParameterInfo& other) {
+                    return !other.isSampler && !other.isSubpass && other.count == 1 &&
+                           other.type == param.type && !strcmp(other.name, param.name);
+                });
+        if (match == srcParameters.end()) {
+            continue;
+        }
+        switch (param.type) {
+            case ParameterType::FLOAT:  copyParameter<float>(from, to, param.name); break;
+            case ParameterType::FLOAT2: copyParameter<math::float2>(from, to, param.name); break;
+            case ParameterType::FLOAT3: copyParameter<math::float3>(from, to, param.name); break;
+            case ParameterType::FLOAT4: copyParameter<math::float4>(from, to, param.name); break;
+            case ParameterType::INT:    copyParameter<int32_t>(from, to, param.name); break;
+            case ParameterType::INT2:   copyParameter<math::int2>(from, to, param.name); break;
+            case ParameterType::INT3:   copyParameter<math::int3>(from, to, param.name); break;
+            case ParameterType::INT4:   copyParameter<math::int4>(from, to, param.name); break;
+            case ParameterType::UINT:   copyParameter<uint32_t>(from, to, param.name); break;
+            case ParameterType::UINT2:  copyParameter<math::uint2>(from, to, param.name); break;
+            case ParameterType::UINT3:  copyParameter<math::uint3>(from, to, param.name); break;
+            case ParameterType::UINT4:  copyParameter<math::uint4>(from, to, param.name); break;
+            case ParameterType::MAT3:   copyParameter<math::mat3f>(from, to, param.name); break;
+            default:
+                // booleans and 4x4 matrices can't be read back, and glTF materials don't use them
+                break;
+        }
+    }
+
+    if (dst->getBlendingMode() == BlendingMode::MASKED) {
+        to->setMaskThreshold(from->getMaskThreshold());
+    }
+}
+
+/*
+ * Creates ubershader material instances right away, and builds the specialized version of their
+ * material on a background thread. Once it's built, updateMaterials() replaces the ubershader
+ * instance with an instance of the specialized material.
+ */
+class HybridShaderProvider : public MaterialProvider {
+public:
+    HybridShaderProvider(Engine* engine, const void* archive, size_t archiveByteCount,
+            bool optimizeShaders, const char* cacheDirectory);
+    ~HybridShaderProvider() override;
+
+    MaterialInstance* createMaterialInstance(MaterialKey* config, UvMap* uvmap,
+            const char* label, const char* extras) override;
+
+    Material* getMaterial(MaterialKey* config, UvMap* uvmap, const char* label) override;
+
+    size_t getMaterialsCount() const noexcept override;
+    const Material* const* getMaterials() const noexcept override;
+    void destroyMaterials() override;
+
+    bool needsDummyData(VertexAttribute attrib) const noexcept override {
+        return mUbershaders->needsDummyData(attrib);
+    }
+
+    size_t updateMaterials(FilamentAsset* asset) override;
+
+private:
+    enum class State : uint8_t {
+        BUILDING,
+        READY,
+        FAILED
+    };
+
+    struct Request {
+        MaterialKey config;
+        UvMap uvmap;
+        std::string label;
+    };
+
+    struct Result {
+        MaterialKey config;
+        std::vector<uint8_t> package;
+    };
+
+    Material* getSpecializedMaterial(const MaterialKey& config) const;
+    void requestSpecializedMaterial(const MaterialKey& config, const UvMap& uvmap,
+            const char* label);
+    void collectResults();
+    void run();
+
+    using HashFn = hash::MurmurHashFn<MaterialKey>;
+
+    // owns the specialized materials
+    JitShaderProvider mJitShaders;
+    MaterialProvider* const mUbershaders;
+    Engine* const mEngine;
+
+    tsl::robin_map<MaterialKey, State, HashFn> mSpecializations;
+
+    // ubershader instances waiting for their specialized material
+    tsl::robin_map<MaterialInstance*, MaterialKey> mTemporaryInstances;
+
+    mutable std::vector<const Material*> mMaterials;
+
+    // shared with the compiler thread
+    std::mutex mLock;
+    std::condition_variable mCondition;
+    std::deque<Request> mRequests;
+    std::vector<Result> mResults;
+    bool mExitRequested = false;
+
+    std::thread mCompilerThread;
+};
+
+HybridShaderProvider::HybridShaderProvider(Engine* engine, const void* archive,
+        size_t archiveByteCount, bool optimizeShaders, const char* cacheDirectory)
+        : mJitShaders(engine, optimizeShaders, cacheDirectory),
+          mUbershaders(createUbershaderProvider(engine, archive, archiveByteCount)),
+          mEngine(engine) {
+    mCompilerThread = std::thread(&HybridShaderProvider::run, this);
+}
+
+HybridShaderProvider::~HybridShaderProvider() {
+    {
+        std::lock_guard<std::mutex> const lock(mLock);
+        mExitRequested = true;
+    }
+    mCondition.notify_one();
+    mCompilerThread.join();
+    delete mUbershaders;
+}
+
+void HybridShaderProvider::run() {
+    // Materials are built with a private job system, so that building them never delays the
+    // jobs of the engine. It uses few threads to leave room for rendering.
+    JobSystem js(2);
+    js.adopt();
+
+    std::unique_lock<std::mutex> lock(mLock);
+    while (true) {
+        mCondition.wait(lock, [this] { return mExitRequested || !mRequests.empty(); });
+        if (mExitRequested) {
+            break;
+        }
+        Request request = std::move(mRequests.front());
+        mRequests.pop_front();
+        lock.unlock();
+
+        std::vector<uint8_t> package = mJitShaders.getPackage(request.config, request.uvmap,
+                request.label.c_str(), js, true);
+
+        lock.lock();
+        mResults.push_back({ request.config, std::move(package) });
+    }
+    lock.unlock();
+
+    js.emancipate();
+}
+
+Material* HybridShaderProvider::getSpecializedMaterial(const MaterialKey& config) const {
+    auto iter = mJitShaders.mCache.find(config);
+    return iter != mJitShaders.mCache.end() ? iter->second : nullptr;
+}
+
+void HybridShaderProvider::requestSpecializedMaterial(const MaterialKey& config,
+        const UvMap& uvmap, const char* label) {
+    if (mSpecializations.find(config) != mSpecializations.end()) {
+        return;
+    }
+    mSpecializations[config] = State::BUILDING;
+    {
+        std::lock_guard<std::mutex> const lock(mLock);
+        mRequests.push_back({ config, uvmap, label ? label : "" });
+    }
+    mCondition.notify_one();
+}
+
+void HybridShaderProvider::collectResults() {
+    std::vector<Result> results;
+    {
+        std::lock_guard<std::mutex> const lock(mLock);
+        std::swap(results, mResults);
+    }
+    for (const Result& result : results) {
+        auto iter = mSpecializations.find(result.config);
+        if (iter == mSpecializations.end() || iter->second != State::BUILDING) {
+            // requested before destroyMaterials()
+            continue;
+        }
+        Material* material = buildMaterial(mEngine, result.package);
+        if (!material) {
+            slog.w << "Unable to build a specialized material, keeping the ubershader."
+                   << io::endl;
+            iter.value() = State::FAILED;
+            continue;
+        }
+        iter.value() = State::READY;
+        mJitShaders.mCache.emplace(result.config, material);
+        mJitShaders.mMaterials.push_back(material);
+    }
+}
+
+MaterialInstance* HybridShaderProvider::createMaterialInstance(MaterialKey* config,
+        UvMap* uvmap, const char* label, const char* extras) {
+    collectResults();
+
+    // diagnostics are only supported by specialized materials
+    if (config->enableDiagnostics) {
+        return mJitShaders.createMaterialInstance(config, uvmap, label, extras);
+    }
+
+    // This constrains the key like the ubershader does, so that the specialized material has
+    // the same parameters as the ubershader instance.
+    mUbershaders->getMaterial(config, uvmap, label);
+
+    if (Material* material = getSpecializedMaterial(*config)) {
+        return material->createInstance(label);
+    }
+
+    MaterialInstance* mi = mUbershaders->createMaterialInstance(config, uvmap, label, extras);
+    if (mi) {
+        requestSpecializedMaterial(*config, *uvmap, label);
+        mTemporaryInstances[mi] = *config;
+    }
+    return mi;
+}
+
+Material* HybridShaderProvider::getMaterial(MaterialKey* config, UvMap* uvmap,
+        const char* label) {
+    collectResults();
+    Material* material = mUbershaders->getMaterial(config, uvmap, label);
+    if (Material* specialized = getSpecializedMaterial(*config)) {
+        return specialized;
+    }
+    requestSpecializedMaterial(*config, *uvmap, label);
+    return material;
+}
+
+size_t HybridShaderProvider::getMaterialsCount() const noexcept {
+    return mUbershaders->getMaterialsCount() + mJitShaders.getMaterialsCount();
+}
+
+const Material* const* HybridShaderProvider::getMaterials() const noexcept {
+    const Material* const* ubershaders = mUbershaders->getMaterials();
+    const Material* const* specialized = mJitShaders.getMaterials();
+    mMaterials.assign(ubershaders, ubershaders + mUbershaders->getMaterialsCount());
+    mMaterials.insert(mMaterials.end(), specialized,
+            specialized + mJitShaders.getMaterialsCount());
+    return mMaterials.data();
+}
+
+void HybridShaderProvider::destroyMaterials() {
+    {
+        std::lock_guard<std::mutex> const lock(mLock);
+        mRequests.clear();
+    }
+    mSpecializations.clear();
+    mTemporaryInstances.clear();
+    mMaterials.clear();
+    mJitShaders.destroyMaterials();
+    mUbershaders->destroyMaterials();
+}
+
+size_t HybridShaderProvider::updateMaterials(FilamentAsset* asset) {
+    collectResults();
+
+    gltfio::FFilamentAsset* fAsset = downcast(asset);
+    size_t temporaryCount = 0;
+    for (gltfio::FFilamentInstance* instance : fAsset->mInstances) {
+        for (size_t i = 0, n = instance->mMaterialInstances.size(); i < n; i++) {
+            MaterialInstance* const mi = instance->mMaterialInstances[i];
+            auto iter = mTemporaryInstances.find(mi);
+            if (iter == mTemporaryInstances.end()) {
+                continue;
+            }
+            State const state = mSpecializations.at(iter->second);
+            if (state == State::BUILDING) {
+                temporaryCount++;
+                continue;
+            }
+            Material* const material = getSpecializedMaterial(iter->second);
+            mTemporaryInstances.erase(iter);
+            if (state == State::READY) {
+                MaterialInstance* const specialized = material->createInstance(mi->getName());
+                copyParameters(mi, specialized);
+                fAsset->replaceMaterialInstance(mi, specialized);
+            }
+        }
+    }
+    return temporaryCount;
+}
+
 } // anonymous namespace
 
 namespace filament::gltfio {
 
-MaterialProvider* createJitShaderProvider(filament::Engine* engine, bool optimizeShaders) {
-    return new JitShaderProvider(engine, optimizeShaders);
+MaterialProvider* createJitShaderProvider(filament::Engine* engine, bool optimizeShaders,
+        const char* cacheDirectory) {
+    return new JitShaderProvider(engine, optimizeShaders, cacheDirectory);
+}
+
+MaterialProvider* createHybridShaderProvider(filament::Engine* engine, const void* archive,
+        size_t archiveByteCount, bool optimizeShaders, const char* cacheDirectory) {
+    return new HybridShaderProvider(engine, archive, archiveByteCount, optimizeShaders,
+            cacheDirectory);
 }
 
 } // namespace filament::gltfio
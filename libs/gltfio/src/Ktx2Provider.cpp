@@ -116,9 +116,14 @@ Texture* Ktx2Provider::pushTexture(const uint8_t* data, size_t byteCount,
     }
 
     JobSystem* js = &mEngine->getJobSystem();
-    item->job = jobs::createJob(*js, mDecoderRootJob, [item] {
+    item->job = jobs::createJob(*js, mDecoderRootJob, [item, js] {
         using Result = ktxreader::Ktx2Reader::Result;
-        const bool success = Result::SUCCESS == item->async->doTranscoding();
+        if (JobSystem::isCancelled(item->job)) {
+            item->transcoderState.store(TranscoderState::ERROR);
+            return;
+        }
+        // The miplevels are transcoded in their own jobs, this one only waits for them.
+        const bool success = Result::SUCCESS == item->async->doTranscoding(*js);
         item->transcoderState.store(success ? TranscoderState::SUCCESS : TranscoderState::ERROR);
     });
 
@@ -160,19 +165,19 @@ void Ktx2Provider::updateQueue() {
         }
         item->async->getTexture();
         const TranscoderState state = item->transcoderState.load();
-        if (state != TranscoderState::NOT_STARTED) {
-            if (item->job) {
-                js->waitAndRelease(item->job);
-            }
-            if (state == TranscoderState::ERROR) {
-                item->state = QueueItemState::READY;
-                ++mDecodedCount;
-                continue;
-            }
+        if (state == TranscoderState::NOT_STARTED) {
+            // upload the miplevels that are already transcoded, without waiting for the others
+            item->async->uploadImages();
+            continue;
+        }
+        if (item->job) {
+            js->waitAndRelease(item->job);
+        }
+        if (state == TranscoderState::SUCCESS) {
             item->async->uploadImages();
-            item->state = QueueItemState::READY;
-            ++mDecodedCount;
         }
+        item->state = QueueItemState::READY;
+        ++mDecodedCount;
     }
 
     // Here we periodically clean up the "queue" (which is really just a vector) by removing unused
@@ -193,9 +198,12 @@ void Ktx2Provider::waitForCompletion() {
 }
 
 void Ktx2Provider::cancelDecoding() {
-    // TODO: Currently, Ktx2Provider runs jobs eagerly and JobSystem does not allow cancellation of
-    // in-flight jobs. We should consider throttling the number of simultaneous decoder jobs, which
-    // would allow for actual cancellation.
+    // Jobs that haven't started yet return immediately, we only wait for the ones in flight.
+    for (auto& item : mQueueItems) {
+        if (item->job) {
+            JobSystem::requestCancel(item->job);
+        }
+    }
     waitForCompletion();
 
     // For cancelled jobs, we need to set the QueueItemState to POPPED and free the decoded data
@@ -232,6 +240,8 @@ void Ktx2Provider::transcodeSingleTexture() {
 
 Ktx2Provider::Ktx2Provider(Engine* engine) : mEngine(engine) {
     mDecoderRootJob = mEngine->getJobSystem().createJob();
+    // the decoder jobs inherit this priority, so they don't compete with the frame's jobs
+    JobSystem::setPriority(mDecoderRootJob, JobSystem::JobPriority::BACKGROUND);
 #ifdef NDEBUG
     const bool quiet = true;
 #else
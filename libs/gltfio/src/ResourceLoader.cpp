@@ -19,7 +19,9 @@
 
 #include "GltfEnums.h"
 #include "FFilamentAsset.h"
+#include "FFilamentInstance.h"
 #include "TangentsJob.h"
+#include "TextureCache.h"
 #include "downcast.h"
 #include "Utility.h"
 #include "extended/ResourceLoaderExtended.h"
@@ -28,6 +30,7 @@
 #include <filament/Engine.h>
 #include <filament/IndexBuffer.h>
 #include <filament/MaterialInstance.h>
+#include <filament/RenderableManager.h>
 #include <filament/Texture.h>
 #include <filament/VertexBuffer.h>
 #include <filament/MorphTargetBuffer.h>
@@ -49,10 +52,13 @@
 
 #include <tsl/robin_map.h>
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <memory>
 #include <string>
 #include <tuple>
+#include <vector>
 
 using namespace filament;
 using namespace filament::math;
@@ -81,11 +87,15 @@ struct ResourceLoader::Impl {
     explicit Impl(const ResourceConfiguration& config) :
         mEngine(config.engine),
         mNormalizeSkinningWeights(config.normalizeSkinningWeights),
+        mOptimizeMeshes(config.optimizeMeshes),
         mGltfPath(config.gltfPath ? config.gltfPath : ""),
-        mUriDataCache(std::make_shared<UriDataCache>()) {}
+        mUriDataCache(std::make_shared<UriDataCache>()) {
+        setTextureSharing(config.shareTextures);
+    }
 
     Engine* const mEngine;
     bool mNormalizeSkinningWeights;
+    bool mOptimizeMeshes;
     std::string mGltfPath;
 
     // User-provided resource data with URI string keys, populated with addResourceData().
@@ -99,15 +109,24 @@ struct ResourceLoader::Impl {
     BufferTextureCache mBufferTextureCache;
     FilepathTextureCache mFilepathTextureCache;
 
+    // Content-addressed textures shared across assets, null unless shareTextures is set. Unlike
+    // the caches above, this outlives loadResources() since the assets keep their textures alive.
+    TextureCacheHandle mTextureCache;
+
     FFilamentAsset* mAsyncAsset = nullptr;
     size_t mRemainingTextureDownloads = 0;
 
     void addResourceData(const char* uri, BufferDescriptor&& buffer);
     void computeTangents(FFilamentAsset* asset);
+    void optimizeMeshes(FFilamentAsset* asset);
+    void generateLevelsOfDetail(FFilamentAsset* asset);
     void createTextures(FFilamentAsset* asset, bool async);
     void cancelTextureDecoding();
     std::pair<Texture*, CacheResult> getOrCreateTexture(FFilamentAsset* asset, size_t textureIndex,
             TextureProvider::TextureFlags flags);
+    std::pair<Texture*, CacheResult> pushTexture(TextureProvider* provider, const uint8_t* data,
+            size_t byteCount, std::string const& mime, TextureProvider::TextureFlags flags);
+    void setTextureSharing(bool enabled);
     ~Impl();
 };
 
@@ -227,9 +246,80 @@ inline void createSkins(cgltf_data const* gltf, bool normalize,
     }
 }
 
+using BufferSlot = FFilamentAsset::ResourceInfo::BufferSlot;
+
+// Converts a float vertex attribute to the normalized type chosen by AssetLoader and uploads it.
+inline void uploadQuantizedAttribute(FFilamentAsset* asset, Engine& engine, BufferSlot const& slot) {
+    const cgltf_accessor* accessor = slot.accessor;
+    const size_t count = accessor->count;
+    const size_t componentCount = cgltf_num_components(accessor->type);
+    FixedCapacityVector<float> floats(count * componentCount);
+    cgltf_accessor_unpack_floats(accessor, floats.data(), floats.size());
+
+    auto snorm16 = [](float v) {
+        return int16_t(std::round(std::clamp(v, -1.0f, 1.0f) * 32767.0f));
+    };
+    auto unorm16 = [](float v) {
+        return uint16_t(std::round(std::clamp(v, 0.0f, 1.0f) * 65535.0f));
+    };
+    auto unorm8 = [](float v) {
+        return uint8_t(std::round(std::clamp(v, 0.0f, 1.0f) * 255.0f));
+    };
+
+    size_t byteCount = 0;
+    void* data = nullptr;
+    switch (slot.quantization) {
+        case BufferSlot::Quantization::POSITION_SNORM16: {
+            PositionQuantization const& quantization = slot.positionQuantization;
+            byteCount = count * sizeof(short4);
+            short4* positions = (short4*) malloc(byteCount);
+            for (size_t i = 0; i < count; ++i) {
+                const float3 p = (float3(floats[i * componentCount + 0],
+                        floats[i * componentCount + 1], floats[i * componentCount + 2]) -
+                        quantization.offset) / quantization.scale;
+                positions[i] = short4(snorm16(p.x), snorm16(p.y), snorm16(p.z), 32767);
+            }
+            data = positions;
+            break;
+        }
+        case BufferSlot::Quantization::UV_UNORM16: {
+            byteCount = count * sizeof(ushort2);
+            ushort2* uvs = (ushort2*) malloc(byteCount);
+            for (size_t i = 0; i < count; ++i) {
+                uvs[i] = ushort2(unorm16(floats[i * 2 + 0]), unorm16(floats[i * 2 + 1]));
+            }
+            data = uvs;
+            break;
+        }
+        case BufferSlot::Quantization::COLOR_UNORM8: {
+            byteCount = count * sizeof(ubyte4);
+            ubyte4* colors = (ubyte4*) malloc(byteCount);
+            for (size_t i = 0; i < count; ++i) {
+                const float* c = &floats[i * componentCount];
+                colors[i] = ubyte4(unorm8(c[0]), unorm8(c[1]), unorm8(c[2]),
+                        componentCount == 4 ? unorm8(c[3]) : 255);
+            }
+            data = colors;
+            break;
+        }
+        case BufferSlot::Quantization::NONE:
+            return;
+    }
+
+    if (BakingData* bakingData = asset->mBakingData.get()) {
+        bakingData->setVertexData(slot.vertexBuffer, slot.bufferIndex, data, byteCount);
+    }
+
+    BufferObject* bo = BufferObject::Builder().size(byteCount).build(engine);
+    asset->mBufferObjects.push_back(bo);
+    bo->setBuffer(engine, BufferDescriptor(data, byteCount, FREE_CALLBACK));
+    slot.vertexBuffer->setBufferObjectAt(engine, slot.bufferIndex, bo);
+}
+
 inline void uploadBuffers(FFilamentAsset* asset, Engine& engine,
         UriDataCacheHandle uriDataCache) {
     // Upload VertexBuffer and IndexBuffer data to the GPU.
+    BakingData* const bakingData = asset->mBakingData.get();
     auto& slots = std::get<FFilamentAsset::ResourceInfo>(asset->mResourceInfo).mBufferSlots;
     for (auto const& slot: slots) {
         const cgltf_accessor* accessor = slot.accessor;
@@ -248,11 +338,19 @@ inline void uploadBuffers(FFilamentAsset* asset, Engine& engine,
         assert_invariant(bufferData);
         const uint32_t size = utility::computeBindingSize(accessor);
         if (slot.vertexBuffer) {
+            if (slot.quantization != BufferSlot::Quantization::NONE) {
+                uploadQuantizedAttribute(asset, engine, slot);
+                continue;
+            }
             if (utility::requiresConversion(accessor)) {
                 const size_t floatsCount = accessor->count * cgltf_num_components(accessor->type);
                 const size_t floatsByteCount = sizeof(float) * floatsCount;
                 float* floatsData = (float*) malloc(floatsByteCount);
                 cgltf_accessor_unpack_floats(accessor, floatsData, floatsCount);
+                if (bakingData) {
+                    bakingData->setVertexData(slot.vertexBuffer, slot.bufferIndex, floatsData,
+                            floatsByteCount);
+                }
                 BufferObject* bo = BufferObject::Builder().size(floatsByteCount).build(engine);
                 asset->mBufferObjects.push_back(bo);
                 bo->setBuffer(engine, BufferDescriptor(floatsData, floatsByteCount, FREE_CALLBACK));
@@ -260,6 +358,9 @@ inline void uploadBuffers(FFilamentAsset* asset, Engine& engine,
                 continue;
             }
 
+            if (bakingData) {
+                bakingData->setVertexData(slot.vertexBuffer, slot.bufferIndex, data, size);
+            }
             BufferObject* bo = BufferObject::Builder().size(size).build(engine);
             asset->mBufferObjects.push_back(bo);
             bo->setBuffer(engine, BufferDescriptor(data, size, uploadCallback,
@@ -271,11 +372,17 @@ inline void uploadBuffers(FFilamentAsset* asset, Engine& engine,
                 const size_t size16 = size * 2;
                 uint16_t* data16 = (uint16_t*) malloc(size16);
                 utility::convertBytesToShorts(data16, data, size);
+                if (bakingData) {
+                    bakingData->setIndexData(slot.indexBuffer, data16, size16);
+                }
                 IndexBuffer::BufferDescriptor bd(data16, size16, FREE_CALLBACK);
 
                 slot.indexBuffer->setBuffer(engine, std::move(bd));
                 continue;
             }
+            if (bakingData) {
+                bakingData->setIndexData(slot.indexBuffer, data, size);
+            }
             IndexBuffer::BufferDescriptor bd(data, size, uploadCallback,
                     uploadUserdata(asset, uriDataCache));
             slot.indexBuffer->setBuffer(engine, std::move(bd));
@@ -318,6 +425,32 @@ inline void uploadBuffers(FFilamentAsset* asset, Engine& engine,
     }
 }
 
+// Reads the positions and the indices of a triangle primitive, generating trivial indices for
+// primitives that don't have any. Returns false if the primitive has no positions.
+bool readTriangles(cgltf_primitive const& prim, std::vector<float3>* positions,
+        std::vector<uint32_t>* indices) {
+    cgltf_accessor const* positionsInfo = nullptr;
+    for (cgltf_size aindex = 0; aindex < prim.attributes_count; aindex++) {
+        if (prim.attributes[aindex].type == cgltf_attribute_type_position) {
+            positionsInfo = prim.attributes[aindex].data;
+            break;
+        }
+    }
+    if (!positionsInfo) {
+        return false;
+    }
+
+    size_t const vertexCount = positionsInfo->count;
+    positions->resize(vertexCount);
+    cgltf_accessor_unpack_floats(positionsInfo, &(*positions)[0].x, vertexCount * 3);
+
+    indices->resize(prim.indices ? prim.indices->count : vertexCount);
+    for (size_t j = 0, c = indices->size(); j < c; ++j) {
+        (*indices)[j] = prim.indices ? cgltf_accessor_read_index(prim.indices, j) : j;
+    }
+    return true;
+}
+
 } // anonymous namespace
 
 ResourceLoader::ResourceLoader(const ResourceConfiguration& config) : pImpl(new Impl(config)) { }
@@ -328,7 +461,9 @@ ResourceLoader::~ResourceLoader() {
 
 void ResourceLoader::setConfiguration(const ResourceConfiguration& config) {
     pImpl->mNormalizeSkinningWeights = config.normalizeSkinningWeights;
+    pImpl->mOptimizeMeshes = config.optimizeMeshes;
     pImpl->mGltfPath = config.gltfPath;
+    pImpl->setTextureSharing(config.shareTextures);
 }
 
 void ResourceLoader::addResourceData(const char* uri, BufferDescriptor&& buffer) {
@@ -434,6 +569,18 @@ bool ResourceLoader::loadResources(FFilamentAsset* asset, bool async) {
         // as tangent generation.
         DracoCache* dracoCache = &asset->mSourceAsset->dracoCache;
         auto& primitives = std::get<FFilamentAsset::ResourceInfo>(asset->mResourceInfo).mPrimitives;
+
+        // Decode all the Draco meshes in parallel first, then copy their data into the
+        // accessors of each primitive.
+        std::vector<const cgltf_buffer_view*> dracoMeshes;
+        for (auto& [prim, vertexBuffer]: primitives) {
+            if (prim->has_draco_mesh_compression) {
+                dracoMeshes.push_back(prim->draco_mesh_compression.buffer_view);
+            }
+        }
+        dracoCache->decodeMeshes(pImpl->mEngine->getJobSystem(),
+                dracoMeshes.data(), dracoMeshes.size());
+
         // Go through every primitive and check if it has a Draco mesh.
         for (auto& [prim, vertexBuffer]: primitives) {
             if (!prim->has_draco_mesh_compression) {
@@ -449,6 +596,15 @@ bool ResourceLoader::loadResources(FFilamentAsset* asset, bool async) {
         // that we need to generate the contents of a GPU buffer by processing one or more CPU
         // buffer(s).
         pImpl->computeTangents(asset);
+
+        if (pImpl->mOptimizeMeshes) {
+            pImpl->optimizeMeshes(asset);
+        }
+
+        // Simplify triangle meshes into the levels of detail that AssetLoader has reserved.
+        if (asset->mLevelOfDetailCount > 0) {
+            pImpl->generateLevelsOfDetail(asset);
+        }
     } else {
         auto& slots = std::get<FFilamentAsset::ResourceInfoExtended>(asset->mResourceInfo).slots;
         ResourceLoaderExtended::loadResources(slots, pImpl->mEngine, asset->mBufferObjects);
@@ -516,6 +672,9 @@ void ResourceLoader::asyncUpdateLoad() {
     for (const auto& iter : pImpl->mTextureProviders) {
         iter.second->updateQueue();
         while (Texture* texture = iter.second->popTexture()) {
+            if (pImpl->mTextureCache) {
+                pImpl->mTextureCache->markAsReady(texture);
+            }
             pImpl->mAsyncAsset->mDependencyGraph.markAsReady(texture);
         }
     }
@@ -547,18 +706,28 @@ std::pair<Texture*, CacheResult> ResourceLoader::Impl::getOrCreateTexture(FFilam
     TextureProvider* provider = foundProvider->second;
     assert_invariant(provider);
 
+    // Keeps a copy of the encoded image, whether or not the texture is found in a cache.
+    BakingData* const bakingData = asset->mBakingData.get();
+    auto keepImageData = [=, &mime](const uint8_t* data, size_t size) {
+        if (bakingData) {
+            bakingData->setImageData(textureIndex, data, size, mime, flags);
+        }
+    };
+
     // Check if the texture slot uses BufferView data.
     if (void** bufferViewData = bv ? &bv->buffer->data : nullptr; bufferViewData) {
         assert_invariant(!dataUriContent);
         const size_t offset = bv ? bv->offset : 0;
         const uint8_t* sourceData = offset + (const uint8_t*) *bufferViewData;
+        const uint32_t totalSize = uint32_t(bv ? bv->size : 0);
+        keepImageData(sourceData, totalSize);
         if (auto iter = mBufferTextureCache.find(sourceData); iter != mBufferTextureCache.end()) {
             return {iter->second, CacheResult::FOUND};
         }
-        const uint32_t totalSize = uint32_t(bv ? bv->size : 0);
-        if (Texture* texture = provider->pushTexture(sourceData, totalSize, mime.c_str(), flags); texture) {
+        if (auto [texture, result] = pushTexture(provider, sourceData, totalSize, mime, flags);
+                texture) {
             mBufferTextureCache[sourceData] = texture;
-            return {texture, CacheResult::MISS};
+            return {texture, result};
         }
     }
 
@@ -566,14 +735,16 @@ std::pair<Texture*, CacheResult> ResourceLoader::Impl::getOrCreateTexture(FFilam
     // Note that this is a data URI in an image, not a buffer. Data URI's in buffers are decoded
     // by the cgltf_load_buffers() function.
     else if (dataUriContent) {
+        keepImageData(dataUriContent, dataUriSize);
         if (auto iter = mBufferTextureCache.find(uri); iter != mBufferTextureCache.end()) {
             free((void*)dataUriContent);
             return {iter->second, CacheResult::FOUND};
         }
-        if (Texture* texture = provider->pushTexture(dataUriContent, dataUriSize, mime.c_str(), flags); texture) {
+        if (auto [texture, result] = pushTexture(provider, dataUriContent, dataUriSize, mime,
+                flags); texture) {
             free((void*)dataUriContent);
             mBufferTextureCache[uri] = texture;
-            return {texture, CacheResult::MISS};
+            return {texture, result};
         }
         free((void*)dataUriContent);
     }
@@ -581,12 +752,14 @@ std::pair<Texture*, CacheResult> ResourceLoader::Impl::getOrCreateTexture(FFilam
     // Check the user-supplied resource cache for this URI.
     else if (auto iter = mUriDataCache->find(uri); iter != mUriDataCache->end()) {
         const uint8_t* sourceData = (const uint8_t*) iter->second.buffer;
+        keepImageData(sourceData, iter->second.size);
         if (auto iter = mBufferTextureCache.find(sourceData); iter != mBufferTextureCache.end()) {
             return {iter->second, CacheResult::FOUND};
         }
-        if (Texture* texture = provider->pushTexture(sourceData, iter->second.size, mime.c_str(), flags); texture) {
+        if (auto [texture, result] = pushTexture(provider, sourceData, iter->second.size, mime,
+                flags); texture) {
             mBufferTextureCache[sourceData] = texture;
-            return {texture, CacheResult::MISS};
+            return {texture, result};
         }
     }
 
@@ -607,9 +780,11 @@ std::pair<Texture*, CacheResult> ResourceLoader::Impl::getOrCreateTexture(FFilam
         buffer.reserve((size_t) filest.tellg());
         filest.seekg(0, ios::beg);
         buffer.assign((istreambuf_iterator<char>(filest)), istreambuf_iterator<char>());
-        if (Texture* texture = provider->pushTexture(buffer.data(), buffer.size(), mime.c_str(), flags); texture) {
+        keepImageData(buffer.data(), buffer.size());
+        if (auto [texture, result] = pushTexture(provider, buffer.data(), buffer.size(), mime,
+                flags); texture) {
             mFilepathTextureCache[uri] = texture;
-            return {texture, CacheResult::MISS};
+            return {texture, result};
         }
 
     } else {
@@ -623,6 +798,32 @@ std::pair<Texture*, CacheResult> ResourceLoader::Impl::getOrCreateTexture(FFilam
     return {};
 }
 
+std::pair<Texture*, CacheResult> ResourceLoader::Impl::pushTexture(TextureProvider* provider,
+        const uint8_t* data, size_t byteCount, std::string const& mime,
+        TextureProvider::TextureFlags flags) {
+    if (!mTextureCache) {
+        return { provider->pushTexture(data, byteCount, mime.c_str(), flags), CacheResult::MISS };
+    }
+    TextureCache::Key key = TextureCache::makeKey(data, byteCount, mime, flags);
+    if (Texture* texture = mTextureCache->find(key)) {
+        return { texture, CacheResult::FOUND };
+    }
+    Texture* texture = provider->pushTexture(data, byteCount, mime.c_str(), flags);
+    if (texture) {
+        mTextureCache->insert(std::move(key), texture);
+    }
+    return { texture, CacheResult::MISS };
+}
+
+void ResourceLoader::Impl::setTextureSharing(bool enabled) {
+    // Assets that already share textures keep the previous cache alive.
+    if (!enabled) {
+        mTextureCache.reset();
+    } else if (!mTextureCache) {
+        mTextureCache = std::make_shared<TextureCache>(*mEngine);
+    }
+}
+
 void ResourceLoader::Impl::cancelTextureDecoding() {
     for (const auto& iter : mTextureProviders) {
         iter.second->cancelDecoding();
@@ -649,12 +850,24 @@ void ResourceLoader::Impl::createTextures(FFilamentAsset* asset, bool async) {
         if (info.texture == nullptr) {
             info.texture = texture;
             info.isOwner = cacheResult == CacheResult::MISS;
+            if (mTextureCache && mTextureCache->contains(texture)) {
+                info.isOwner = false;
+                info.isShared = true;
+                mTextureCache->retain(texture);
+                asset->mTextureCache = mTextureCache;
+            }
         }
 
         // For each binding to a material instance, call setParameter(...) on the material.
         for (const TextureSlot& slot : info.bindings) {
             asset->applyTextureBinding(textureIndex, slot);
         }
+
+        // A shared texture that another asset has already finished decoding won't be popped
+        // from its provider again.
+        if (info.isShared && mTextureCache->isReady(texture)) {
+            asset->mDependencyGraph.markAsReady(texture);
+        }
     }
 
     // Non-threaded systems are required to use the asynchronous API.
@@ -668,6 +881,14 @@ void ResourceLoader::Impl::createTextures(FFilamentAsset* asset, bool async) {
         iter.second->waitForCompletion();
         iter.second->updateQueue();
     }
+
+    if (mTextureCache) {
+        for (FFilamentAsset::TextureInfo const& info : asset->mTextures) {
+            if (info.isShared) {
+                mTextureCache->markAsReady(info.texture);
+            }
+        }
+    }
 }
 
 void ResourceLoader::Impl::computeTangents(FFilamentAsset* asset) {
@@ -737,6 +958,7 @@ void ResourceLoader::Impl::computeTangents(FFilamentAsset* asset) {
     // Kick off jobs for computing tangent frames.
     JobSystem* js = &mEngine->getJobSystem();
     JobSystem::Job* parent = js->createJob();
+    JobSystem::setPriority(parent, JobSystem::JobPriority::BACKGROUND);
     for (Params& params : jobParams) {
         Params* pptr = &params;
         js->run(jobs::createJob(*js, parent, [pptr] { TangentsJob::run(pptr); }));
@@ -746,6 +968,10 @@ void ResourceLoader::Impl::computeTangents(FFilamentAsset* asset) {
     // Finally, upload quaternions to the GPU from the main thread.
     for (Params& params : jobParams) {
         if (params.context.vb) {
+            if (BakingData* bakingData = asset->mBakingData.get()) {
+                bakingData->setVertexData(params.context.vb, params.context.slot,
+                        params.out.results, params.out.vertexCount * sizeof(short4));
+            }
             BufferObject* bo = BufferObject::Builder()
                     .size(params.out.vertexCount * sizeof(short4)).build(*mEngine);
             asset->mBufferObjects.push_back(bo);
@@ -761,6 +987,211 @@ void ResourceLoader::Impl::computeTangents(FFilamentAsset* asset) {
     }
 }
 
+void ResourceLoader::Impl::optimizeMeshes(FFilamentAsset* asset) {
+    SYSTRACE_CALL();
+
+    cgltf_data const* gltf = asset->mSourceAsset->hierarchy;
+
+    // Clusters of triangles are re-ordered for overdraw as long as the vertex cache efficiency
+    // doesn't degrade by more than this factor.
+    constexpr float kOverdrawThreshold = 1.05f;
+
+    struct Job {
+        cgltf_primitive const* prim;
+        IndexBuffer* indexBuffer;
+        IndexBuffer::IndexType indexType;
+        std::vector<uint32_t> indices;
+    };
+
+    // Create a job description for each triangle-based primitive.
+    std::vector<Job> jobs;
+    for (size_t i = 0, n = gltf->meshes_count; i < n; ++i) {
+        cgltf_mesh const& mesh = gltf->meshes[i];
+        FixedCapacityVector<Primitive> const& prims = asset->mMeshCache[i];
+        for (cgltf_size pindex = 0, pcount = prims.size(); pindex < pcount; ++pindex) {
+            cgltf_primitive const& prim = mesh.primitives[pindex];
+            IndexBuffer::IndexType indexType = IndexBuffer::IndexType::UINT;
+            if (prim.type != cgltf_primitive_type_triangles || !prims[pindex].indices ||
+                    (prim.indices && !getIndexType(prim.indices->component_type, &indexType))) {
+                continue;
+            }
+            jobs.push_back({ &prim, prims[pindex].indices, indexType });
+        }
+    }
+
+    auto optimize = [](Job* job) {
+        std::vector<float3> positions;
+        std::vector<uint32_t>& indices = job->indices;
+        if (!readTriangles(*job->prim, &positions, &indices) || indices.size() % 3 != 0) {
+            indices.clear();
+            return;
+        }
+        size_t const vertexCount = positions.size();
+        meshopt_optimizeVertexCache(indices.data(), indices.data(), indices.size(), vertexCount);
+        meshopt_optimizeOverdraw(indices.data(), indices.data(), indices.size(),
+                &positions[0].x, vertexCount, sizeof(float3), kOverdrawThreshold);
+    };
+
+    // Kick off jobs for optimizing the meshes.
+    JobSystem* js = &mEngine->getJobSystem();
+    JobSystem::Job* parent = js->createJob();
+    JobSystem::setPriority(parent, JobSystem::JobPriority::BACKGROUND);
+    for (Job& job : jobs) {
+        Job* jptr = &job;
+        js->run(jobs::createJob(*js, parent, [optimize, jptr] { optimize(jptr); }));
+    }
+    js->runAndWait(parent);
+
+    // Finally, replace the contents of the index buffers from the main thread. Vertices are not
+    // re-ordered for fetch efficiency because the vertex buffers may be shared with other
+    // primitives and have already been uploaded.
+    BakingData* const bakingData = asset->mBakingData.get();
+    for (Job& job : jobs) {
+        std::vector<uint32_t> const& indices = job.indices;
+        if (indices.empty()) {
+            continue;
+        }
+        if (job.indexType == IndexBuffer::IndexType::USHORT) {
+            size_t const size = indices.size() * sizeof(uint16_t);
+            uint16_t* data = (uint16_t*) malloc(size);
+            std::copy(indices.begin(), indices.end(), data);
+            if (bakingData) {
+                bakingData->setIndexData(job.indexBuffer, data, size);
+            }
+            job.indexBuffer->setBuffer(*mEngine,
+                    IndexBuffer::BufferDescriptor(data, size, FREE_CALLBACK));
+        } else {
+            size_t const size = indices.size() * sizeof(uint32_t);
+            uint32_t* data = (uint32_t*) malloc(size);
+            std::copy(indices.begin(), indices.end(), data);
+            if (bakingData) {
+                bakingData->setIndexData(job.indexBuffer, data, size);
+            }
+            job.indexBuffer->setBuffer(*mEngine,
+                    IndexBuffer::BufferDescriptor(data, size, FREE_CALLBACK));
+        }
+    }
+}
+
+void ResourceLoader::Impl::generateLevelsOfDetail(FFilamentAsset* asset) {
+    SYSTRACE_CALL();
+
+    cgltf_data const* gltf = asset->mSourceAsset->hierarchy;
+    size_t const lodCount = asset->mLevelOfDetailCount;
+
+    // Each level keeps half the triangles of the previous one, with a growing error budget
+    // relative to the mesh extents.
+    constexpr float kTriangleRatio = 0.5f;
+    constexpr float kTargetError = 1e-2f;
+
+    struct Job {
+        cgltf_primitive const* prim;
+        Primitive* primitive;
+        std::vector<uint32_t> indices[RenderableManager::Builder::MAX_LEVEL_OF_DETAIL_COUNT];
+    };
+
+    // Create a job description for each triangle-based primitive.
+    std::vector<Job> jobs;
+    for (size_t i = 0, n = gltf->meshes_count; i < n; ++i) {
+        cgltf_mesh const& mesh = gltf->meshes[i];
+        FixedCapacityVector<Primitive>& prims = asset->mMeshCache[i];
+        for (cgltf_size pindex = 0, pcount = prims.size(); pindex < pcount; ++pindex) {
+            cgltf_primitive const& prim = mesh.primitives[pindex];
+            if (prim.type == cgltf_primitive_type_triangles && prims[pindex].vertices &&
+                    prims[pindex].lodIndices.empty()) {
+                jobs.push_back({ &prim, &prims[pindex] });
+            }
+        }
+    }
+
+    auto simplify = [lodCount, optimize = mOptimizeMeshes](Job* job) {
+        std::vector<float3> positions;
+        std::vector<uint32_t> source;
+        if (!readTriangles(*job->prim, &positions, &source)) {
+            return;
+        }
+
+        // Each level is simplified from the previous one, which is cheaper than going back to
+        // the original geometry every time.
+        for (size_t level = 1; level <= lodCount; ++level) {
+            std::vector<uint32_t> const& previous = level == 1 ? source : job->indices[level - 1];
+            size_t const targetCount = size_t(float(previous.size()) * kTriangleRatio) / 3 * 3;
+            std::vector<uint32_t>& out = job->indices[level];
+            out.resize(previous.size());
+            out.resize(meshopt_simplify(out.data(), previous.data(), previous.size(),
+                    &positions[0].x, positions.size(), sizeof(float3), targetCount,
+                    kTargetError * float(1u << (level - 1))));
+            if (out.empty()) {
+                // the mesh can't be simplified further without collapsing, keep the last level
+                out = previous;
+            } else if (optimize) {
+                meshopt_optimizeVertexCache(out.data(), out.data(), out.size(), positions.size());
+            }
+        }
+    };
+
+    // Kick off jobs for simplifying the meshes.
+    JobSystem* js = &mEngine->getJobSystem();
+    JobSystem::Job* parent = js->createJob();
+    JobSystem::setPriority(parent, JobSystem::JobPriority::BACKGROUND);
+    for (Job& job : jobs) {
+        Job* jptr = &job;
+        js->run(jobs::createJob(*js, parent, [simplify, jptr] { simplify(jptr); }));
+    }
+    js->runAndWait(parent);
+
+    // Upload the simplified indices to the GPU from the main thread. A primitive that couldn't be
+    // simplified keeps its original indices at every level.
+    for (Job& job : jobs) {
+        Primitive& primitive = *job.primitive;
+        primitive.lodIndices.resize(lodCount, primitive.indices);
+        for (size_t level = 1; level <= lodCount; ++level) {
+            std::vector<uint32_t> const& indices = job.indices[level];
+            if (indices.empty()) {
+                continue;
+            }
+            IndexBuffer* ib = IndexBuffer::Builder()
+                    .indexCount(indices.size())
+                    .bufferType(IndexBuffer::IndexType::UINT)
+                    .build(*mEngine);
+            asset->mIndexBuffers.push_back(ib);
+            size_t const size = indices.size() * sizeof(uint32_t);
+            uint32_t* data = (uint32_t*) malloc(size);
+            std::copy(indices.begin(), indices.end(), data);
+            ib->setBuffer(*mEngine, IndexBuffer::BufferDescriptor(data, size, FREE_CALLBACK));
+            primitive.lodIndices[level - 1] = ib;
+        }
+    }
+
+    // Finally, point the levels of detail of the existing renderables at the new indices.
+    // Instances created from now on pick them up from the mesh cache.
+    RenderableManager& rm = mEngine->getRenderableManager();
+    for (FFilamentInstance const* instance : asset->mInstances) {
+        for (size_t nindex = 0, n = gltf->nodes_count; nindex < n; ++nindex) {
+            cgltf_mesh const* mesh = gltf->nodes[nindex].mesh;
+            Entity const entity = instance->mNodeMap[nindex];
+            if (!mesh || !entity || !rm.hasComponent(entity)) {
+                continue;
+            }
+            auto const ri = rm.getInstance(entity);
+            FixedCapacityVector<Primitive> const& prims = asset->mMeshCache[mesh - gltf->meshes];
+            for (size_t pindex = 0, pcount = prims.size(); pindex < pcount; ++pindex) {
+                Primitive const& primitive = prims[pindex];
+                RenderableManager::PrimitiveType primType;
+                if (primitive.lodIndices.empty() ||
+                        !getPrimitiveType(mesh->primitives[pindex].type, &primType)) {
+                    continue;
+                }
+                for (size_t level = 1; level <= lodCount; ++level) {
+                    IndexBuffer* const ib = primitive.lodIndices[level - 1];
+                    rm.setGeometryAt(ri, level * pcount + pindex, primType, primitive.vertices,
+                            ib, 0, ib->getIndexCount());
+                }
+            }
+        }
+    }
+}
+
 ResourceLoader::Impl::~Impl() {
     for (const auto& iter : mTextureProviders) {
         iter.second->cancelDecoding();
@@ -16,9 +16,15 @@
 
 #include <gltfio/TextureProvider.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <optional>
 #include <string>
 #include <vector>
 
+#include <image/BlockCompression.h>
+
 #include <utils/JobSystem.h>
 #include <utils/Log.h>
 
@@ -27,6 +33,8 @@
 
 #include <stb_image.h>
 
+#include <stdlib.h>
+
 using namespace filament;
 using namespace utils;
 
@@ -36,9 +44,114 @@ using std::unique_ptr;
 
 namespace filament::gltfio {
 
+namespace {
+
+using image::BlockFormat;
+
+struct CompressedFormat {
+    Texture::InternalFormat internalFormat;
+    Texture::CompressedType type;
+    BlockFormat blockFormat;
+};
+
+// Returns the first compressed format supported by the engine, BC first since ETC2 is often
+// emulated on desktop GPUs.
+std::optional<CompressedFormat> getCompressedFormat(Engine& engine, bool alpha, bool sRGB) {
+    using Format = Texture::InternalFormat;
+    using Type = Texture::CompressedType;
+    CompressedFormat const candidates[] = {
+        alpha ? (sRGB ? CompressedFormat{ Format::DXT5_SRGBA, Type::DXT5_SRGBA, BlockFormat::BC3 }
+                      : CompressedFormat{ Format::DXT5_RGBA, Type::DXT5_RGBA, BlockFormat::BC3 })
+              : (sRGB ? CompressedFormat{ Format::DXT1_SRGB, Type::DXT1_SRGB, BlockFormat::BC1 }
+                      : CompressedFormat{ Format::DXT1_RGB, Type::DXT1_RGB, BlockFormat::BC1 }),
+        alpha ? (sRGB ? CompressedFormat{ Format::ETC2_EAC_SRGBA8, Type::ETC2_EAC_SRGBA8,
+                                BlockFormat::ETC2_EAC_RGBA8 }
+                      : CompressedFormat{ Format::ETC2_EAC_RGBA8, Type::ETC2_EAC_RGBA8,
+                                BlockFormat::ETC2_EAC_RGBA8 })
+              : (sRGB ? CompressedFormat{ Format::ETC2_SRGB8, Type::ETC2_SRGB8,
+                                BlockFormat::ETC2_RGB8 }
+                      : CompressedFormat{ Format::ETC2_RGB8, Type::ETC2_RGB8,
+                                BlockFormat::ETC2_RGB8 }),
+    };
+    for (auto const& candidate : candidates) {
+        if (Texture::isTextureFormatSupported(engine, candidate.internalFormat)) {
+            return candidate;
+        }
+    }
+    return std::nullopt;
+}
+
+// Box filters an RGBA8 level into the next one, in linear space for sRGB images.
+void downsample(uint8_t const* src, uint32_t width, uint32_t height, uint8_t* dst, bool sRGB) {
+    static auto const toLinear = [] {
+        std::array<float, 256> table{};
+        for (size_t i = 0; i < 256; i++) {
+            float const c = float(i) / 255.0f;
+            table[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        return table;
+    }();
+    auto const toSRGB = [](float const c) {
+        float const s = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+        return uint8_t(std::clamp(s * 255.0f + 0.5f, 0.0f, 255.0f));
+    };
+
+    uint32_t const w = std::max(1u, width / 2);
+    uint32_t const h = std::max(1u, height / 2);
+    for (uint32_t y = 0; y < h; y++) {
+        uint32_t const y0 = std::min(y * 2, height - 1);
+        uint32_t const y1 = std::min(y * 2 + 1, height - 1);
+        for (uint32_t x = 0; x < w; x++) {
+            uint32_t const x0 = std::min(x * 2, width - 1);
+            uint32_t const x1 = std::min(x * 2 + 1, width - 1);
+            uint8_t const* p[4] = {
+                    src + (y0 * width + x0) * 4, src + (y0 * width + x1) * 4,
+                    src + (y1 * width + x0) * 4, src + (y1 * width + x1) * 4 };
+            uint8_t* out = dst + (y * w + x) * 4;
+            for (int c = 0; c < 4; c++) {
+                if (sRGB && c < 3) {
+                    float const sum = toLinear[p[0][c]] + toLinear[p[1][c]] +
+                                      toLinear[p[2][c]] + toLinear[p[3][c]];
+                    out[c] = toSRGB(sum * 0.25f);
+                } else {
+                    out[c] = uint8_t((p[0][c] + p[1][c] + p[2][c] + p[3][c] + 2) / 4);
+                }
+            }
+        }
+    }
+}
+
+// Compresses all the levels of an image, one after the other, in a buffer allocated with malloc.
+uint8_t* compressLevels(uint8_t const* texels, uint32_t width, uint32_t height,
+        size_t levelCount, BlockFormat format, bool sRGB) {
+    size_t size = 0;
+    for (size_t level = 0; level < levelCount; level++) {
+        size += image::getCompressedSize(format,
+                std::max(1u, width >> level), std::max(1u, height >> level));
+    }
+    uint8_t* const blocks = (uint8_t*) malloc(size);
+    uint8_t* out = blocks;
+    std::vector<uint8_t> current(texels, texels + size_t(width) * height * 4);
+    std::vector<uint8_t> next;
+    for (size_t level = 0; level < levelCount; level++) {
+        image::compressBlocks(format, current.data(), width, height, 0, out);
+        out += image::getCompressedSize(format, width, height);
+        if (level + 1 < levelCount) {
+            next.resize(size_t(std::max(1u, width / 2)) * std::max(1u, height / 2) * 4);
+            downsample(current.data(), width, height, next.data(), sRGB);
+            std::swap(current, next);
+            width = std::max(1u, width / 2);
+            height = std::max(1u, height / 2);
+        }
+    }
+    return blocks;
+}
+
+} // anonymous namespace
+
 class StbProvider final : public TextureProvider {
 public:
-    StbProvider(Engine* engine);
+    StbProvider(Engine* engine, StbProviderConfiguration const& config);
     ~StbProvider();
 
     Texture* pushTexture(const uint8_t* data, size_t byteCount,
@@ -67,6 +180,9 @@ private:
         atomic<intptr_t> decodedTexelsBaseMipmap;
         vector<uint8_t> sourceBuffer;
         JobSystem::Job*  decoderJob;
+        // when set, decodedTexelsBaseMipmap holds all the compressed levels
+        std::optional<CompressedFormat> compressedFormat;
+        bool sRGB;
     };
 
     // Declare some sentinel values for the "decodedTexelsBaseMipmap" field.
@@ -75,6 +191,8 @@ private:
     static const intptr_t DECODING_ERROR = 0x1;
 
     void decodeSingleTexture();
+    static void decode(TextureInfo* info);
+    static void freeDecoded(TextureInfo const* info, intptr_t data);
 
     size_t mPushedCount = 0;
     size_t mPoppedCount = 0;
@@ -84,6 +202,7 @@ private:
     std::string mRecentPushMessage;
     std::string mRecentPopMessage;
     Engine* const mEngine;
+    bool const mCompress;
 };
 
 Texture* StbProvider::pushTexture(const uint8_t* data, size_t byteCount,
@@ -96,11 +215,19 @@ Texture* StbProvider::pushTexture(const uint8_t* data, size_t byteCount,
 
     using InternalFormat = Texture::InternalFormat;
 
+    bool const sRGB = any(flags & TextureFlags::sRGB);
+    std::optional<CompressedFormat> compressedFormat;
+    if (mCompress) {
+        // stb_image reports the number of components of the file, 2 and 4 have alpha
+        compressedFormat = getCompressedFormat(*mEngine, numComponents % 2 == 0, sRGB);
+    }
+
     Texture* texture = Texture::Builder()
             .width(width)
             .height(height)
             .levels(0xff)
-            .format(any(flags & TextureFlags::sRGB) ? InternalFormat::SRGB8_A8 : InternalFormat::RGBA8)
+            .format(compressedFormat ? compressedFormat->internalFormat :
+                    sRGB ? InternalFormat::SRGB8_A8 : InternalFormat::RGBA8)
             .build(*mEngine);
 
     if (texture == nullptr) {
@@ -114,6 +241,8 @@ Texture* StbProvider::pushTexture(const uint8_t* data, size_t byteCount,
 
     info->texture = texture;
     info->state = TextureState::DECODING;
+    info->compressedFormat = compressedFormat;
+    info->sRGB = sRGB;
     info->sourceBuffer.assign(data, data + byteCount);
     info->decodedTexelsBaseMipmap.store(DECODING_NOT_READY);
 
@@ -127,17 +256,15 @@ Texture* StbProvider::pushTexture(const uint8_t* data, size_t byteCount,
 
     JobSystem* js = &mEngine->getJobSystem();
     info->decoderJob = jobs::createJob(*js, mDecoderRootJob, [info] {
-        auto& source = info->sourceBuffer;
-        int width, height, comp;
+        if (JobSystem::isCancelled(info->decoderJob)) {
+            info->decodedTexelsBaseMipmap.store(DECODING_ERROR);
+            return;
+        }
 
         // Test asynchronous loading by uncommenting this line.
         // std::this_thread::sleep_for(std::chrono::milliseconds(rand() % 10000));
 
-        stbi_uc* texels = stbi_load_from_memory(source.data(), source.size(),
-                &width, &height, &comp, 4);
-        source.clear();
-        source.shrink_to_fit();
-        info->decodedTexelsBaseMipmap.store(texels ? intptr_t(texels) : DECODING_ERROR);
+        decode(info);
     });
 
     js->runAndRetain(info->decoderJob);
@@ -183,6 +310,29 @@ void StbProvider::updateQueue() {
                 ++mDecodedCount;
                 continue;
             }
+            if (info->compressedFormat) {
+                // the buffer is released with the last level, levels are uploaded in order
+                uint8_t* blocks = (uint8_t*) data;
+                size_t const levelCount = texture->getLevels();
+                for (size_t level = 0; level < levelCount; level++) {
+                    uint32_t const width = uint32_t(texture->getWidth(level));
+                    uint32_t const height = uint32_t(texture->getHeight(level));
+                    size_t const size = image::getCompressedSize(
+                            info->compressedFormat->blockFormat, width, height);
+                    bool const last = level + 1 == levelCount;
+                    Texture::PixelBufferDescriptor::Callback const callback =
+                            last ? Texture::PixelBufferDescriptor::Callback(
+                                    [](void*, size_t, void* mem) { free(mem); }) : nullptr;
+                    texture->setImage(*mEngine, level, Texture::PixelBufferDescriptor(
+                            blocks, size, info->compressedFormat->type, uint32_t(size),
+                            callback, last ? (void*) data : nullptr));
+                    blocks += size;
+                }
+                info->state = TextureState::READY;
+                ++mDecodedCount;
+                continue;
+            }
+
             Texture::PixelBufferDescriptor pbd((uint8_t*) data,
                     texture->getWidth() * texture->getHeight() * 4, Texture::Format::RGBA,
                     Texture::Type::UBYTE, [](void* mem, size_t, void*) { stbi_image_free(mem); });
@@ -215,9 +365,12 @@ void StbProvider::waitForCompletion() {
 }
 
 void StbProvider::cancelDecoding() {
-    // TODO: Currently, StbProvider runs jobs eagerly and JobSystem does not allow cancellation of
-    // in-flight jobs. We should consider throttling the number of simultaneous decoder jobs, which
-    // would allow for actual cancellation.
+    // Jobs that haven't started yet return immediately, we only wait for the ones in flight.
+    for (auto& info : mTextures) {
+        if (info->decoderJob) {
+            JobSystem::requestCancel(info->decoderJob);
+        }
+    }
     waitForCompletion();
 
     // For cancelled jobs, we need to set the TextureInfo to the popped state and free the decoded
@@ -230,8 +383,9 @@ void StbProvider::cancelDecoding() {
         // decodedTexelsBaseMipmap is loaded is in the job threads, and we have waited them to
         // completion above. We also expect the TextureProvider API calls to be made only from one
         // thread.
-        if (intptr_t data = info->decodedTexelsBaseMipmap.load()) {
-            delete [] (uint8_t*) data;
+        if (intptr_t data = info->decodedTexelsBaseMipmap.load(); data != DECODING_NOT_READY &&
+                data != DECODING_ERROR) {
+            freeDecoded(info.get(), data);
         }
         info->state = TextureState::POPPED;
     }
@@ -249,20 +403,42 @@ void StbProvider::decodeSingleTexture() {
     assert_invariant(!UTILS_HAS_THREADING);
     for (auto& info : mTextures) {
         if (info->state == TextureState::DECODING) {
-            auto& source = info->sourceBuffer;
-            int width, height, comp;
-            stbi_uc* texels = stbi_load_from_memory(source.data(), source.size(),
-                    &width, &height, &comp, 4);
-            source.clear();
-            source.shrink_to_fit();
-            info->decodedTexelsBaseMipmap.store(texels ? intptr_t(texels) : DECODING_ERROR);
+            decode(info.get());
             break;
         }
     }
 }
 
-StbProvider::StbProvider(Engine* engine) : mEngine(engine) {
+void StbProvider::decode(TextureInfo* info) {
+    auto& source = info->sourceBuffer;
+    int width, height, comp;
+    stbi_uc* texels = stbi_load_from_memory(source.data(), source.size(),
+            &width, &height, &comp, 4);
+    source.clear();
+    source.shrink_to_fit();
+    if (texels && info->compressedFormat) {
+        // the levels can't be generated by the GPU, they're compressed along with the base level
+        uint8_t* blocks = compressLevels(texels, width, height, info->texture->getLevels(),
+                info->compressedFormat->blockFormat, info->sRGB);
+        stbi_image_free(texels);
+        texels = blocks;
+    }
+    info->decodedTexelsBaseMipmap.store(texels ? intptr_t(texels) : DECODING_ERROR);
+}
+
+void StbProvider::freeDecoded(TextureInfo const* info, intptr_t const data) {
+    if (info->compressedFormat) {
+        free((void*) data);
+    } else {
+        stbi_image_free((void*) data);
+    }
+}
+
+StbProvider::StbProvider(Engine* engine, StbProviderConfiguration const& config)
+        : mEngine(engine), mCompress(config.compressTextures) {
     mDecoderRootJob = mEngine->getJobSystem().createJob();
+    // the decoder jobs inherit this priority, so they don't compete with the frame's jobs
+    JobSystem::setPriority(mDecoderRootJob, JobSystem::JobPriority::BACKGROUND);
 #ifndef NDEBUG
     slog.i << "Texture Decoder has "
             << mEngine->getJobSystem().getThreadCount()
@@ -276,7 +452,11 @@ StbProvider::~StbProvider() {
 }
 
 TextureProvider* createStbProvider(Engine* engine) {
-    return new StbProvider(engine);
+    return new StbProvider(engine, {});
+}
+
+TextureProvider* createStbProvider(Engine* engine, StbProviderConfiguration const& config) {
+    return new StbProvider(engine, config);
 }
 
 } // namespace filament::gltfio
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TextureCache.h"
+
+#include <utils/debug.h>
+#include <utils/Hash.h>
+
+#include <utility>
+
+namespace filament::gltfio {
+
+TextureCache::~TextureCache() {
+    // All the assets hold a reference to the cache, so none of the remaining textures are in use.
+    for (auto const& [texture, entry] : mEntries) {
+        assert_invariant(entry.refCount == 0);
+        mEngine.destroy(texture);
+    }
+}
+
+TextureCache::Key TextureCache::makeKey(const uint8_t* data, size_t size, std::string mimeType,
+        TextureProvider::TextureFlags flags) noexcept {
+    // Two 32-bit hashes of the content make collisions between distinct images very unlikely.
+    uint64_t const lo = utils::hash::murmurSlow(data, size, 0);
+    uint64_t const hi = utils::hash::murmurSlow(data, size, 0x9e3779b9);
+    return { (hi << 32u) | lo, size, std::move(mimeType), flags };
+}
+
+Texture* TextureCache::find(Key const& key) const noexcept {
+    auto const iter = mTextures.find(key);
+    return iter != mTextures.end() ? iter->second : nullptr;
+}
+
+void TextureCache::insert(Key key, Texture* texture) {
+    assert_invariant(texture && !contains(texture));
+    mTextures[key] = texture;
+    mEntries[texture] = { std::move(key), 0, false };
+}
+
+bool TextureCache::contains(Texture const* texture) const noexcept {
+    return mEntries.find(texture) != mEntries.end();
+}
+
+void TextureCache::markAsReady(Texture const* texture) noexcept {
+    if (auto iter = mEntries.find(texture); iter != mEntries.end()) {
+        iter.value().ready = true;
+    }
+}
+
+bool TextureCache::isReady(Texture const* texture) const noexcept {
+    auto const iter = mEntries.find(texture);
+    return iter != mEntries.end() && iter->second.ready;
+}
+
+void TextureCache::retain(Texture const* texture) noexcept {
+    auto iter = mEntries.find(texture);
+    assert_invariant(iter != mEntries.end());
+    iter.value().refCount++;
+}
+
+void TextureCache::release(Texture* texture) noexcept {
+    auto iter = mEntries.find(texture);
+    assert_invariant(iter != mEntries.end());
+    assert_invariant(iter->second.refCount > 0);
+    if (--iter.value().refCount == 0) {
+        mTextures.erase(iter->second.key);
+        mEntries.erase(iter);
+        mEngine.destroy(texture);
+    }
+}
+
+} // namespace filament::gltfio
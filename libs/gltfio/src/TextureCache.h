@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GLTFIO_TEXTURE_CACHE_H
+#define GLTFIO_TEXTURE_CACHE_H
+
+#include <gltfio/TextureProvider.h>
+
+#include <filament/Engine.h>
+#include <filament/Texture.h>
+
+#include <tsl/robin_map.h>
+
+#include <memory>
+#include <string>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace filament::gltfio {
+
+// Shares Texture objects across all the assets loaded by a ResourceLoader. Used by gltfio; users
+// do not need to access this class directly.
+//
+// Textures are keyed by the hash of their encoded content, its size, mime type and flags, so
+// identical images are decoded and uploaded once even when they come from different files or
+// URIs. Each asset holds a reference to the cache and to the textures it uses; a texture is
+// destroyed when the last asset that uses it is destroyed.
+class TextureCache {
+public:
+    struct Key {
+        uint64_t hash;
+        size_t size;
+        std::string mimeType;
+        TextureProvider::TextureFlags flags;
+        bool operator==(Key const& rhs) const noexcept {
+            return hash == rhs.hash && size == rhs.size && flags == rhs.flags &&
+                    mimeType == rhs.mimeType;
+        }
+    };
+
+    explicit TextureCache(Engine& engine) : mEngine(engine) {}
+    ~TextureCache();
+
+    TextureCache(TextureCache const&) = delete;
+    TextureCache& operator=(TextureCache const&) = delete;
+
+    static Key makeKey(const uint8_t* data, size_t size, std::string mimeType,
+            TextureProvider::TextureFlags flags) noexcept;
+
+    // Returns the texture created for this content or null. This doesn't add a reference.
+    Texture* find(Key const& key) const noexcept;
+
+    // Adds a texture that was just pushed to a TextureProvider, with no references.
+    void insert(Key key, Texture* texture);
+
+    bool contains(Texture const* texture) const noexcept;
+
+    // A texture is ready once it has been popped from its TextureProvider, or once a synchronous
+    // load completes. Assets that reuse a ready texture can't wait for it to be popped again.
+    void markAsReady(Texture const* texture) noexcept;
+    bool isReady(Texture const* texture) const noexcept;
+
+    void retain(Texture const* texture) noexcept;
+
+    // Destroys the texture when its last reference is released.
+    void release(Texture* texture) noexcept;
+
+private:
+    struct KeyHasher {
+        size_t operator()(Key const& key) const noexcept { return size_t(key.hash); }
+    };
+    struct Entry {
+        Key key;
+        uint32_t refCount;
+        bool ready;
+    };
+    Engine& mEngine;
+    tsl::robin_map<Key, Texture*, KeyHasher> mTextures;
+    tsl::robin_map<Texture const*, Entry> mEntries;
+};
+
+using TextureCacheHandle = std::shared_ptr<TextureCache>;
+
+} // namespace filament::gltfio
+
+#endif // GLTFIO_TEXTURE_CACHE_H
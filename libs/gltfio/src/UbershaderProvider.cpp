@@ -26,6 +26,9 @@
 
 #include "ArchiveCache.h"
 
+#include <stdlib.h>
+#include <string.h>
+
 using namespace filament;
 using namespace filament::math;
 using namespace filament::uberz;
@@ -103,7 +106,7 @@ static void prepareConfig(MaterialKey* config, const char* label) {
 
 class UbershaderProvider : public MaterialProvider {
 public:
-    UbershaderProvider(Engine* engine, const void* archive, size_t archiveByteCount);
+    UbershaderProvider(Engine* engine, backend::BufferDescriptor&& archive);
     ~UbershaderProvider() {}
 
     MaterialInstance* createMaterialInstance(MaterialKey* config, UvMap* uvmap,
@@ -134,7 +137,7 @@ public:
     Engine* const mEngine;
 };
 
-UbershaderProvider::UbershaderProvider(Engine* engine, const void* archive, size_t archiveByteCount)
+UbershaderProvider::UbershaderProvider(Engine* engine, backend::BufferDescriptor&& archive)
         : mMaterials(*engine), mEngine(engine) {
     unsigned char texels[4] = {};
     mDummyTexture = Texture::Builder()
@@ -144,7 +147,7 @@ UbershaderProvider::UbershaderProvider(Engine* engine, const void* archive, size
     Texture::PixelBufferDescriptor pbd(texels, sizeof(texels), Texture::Format::RGBA,
             Texture::Type::UBYTE);
     mDummyTexture->setImage(*mEngine, 0, std::move(pbd));
-    mMaterials.load(archive, archiveByteCount);
+    mMaterials.load(std::move(archive));
 }
 
 size_t UbershaderProvider::getMaterialsCount() const noexcept {
@@ -390,7 +393,15 @@ namespace filament::gltfio {
 
 MaterialProvider* createUbershaderProvider(Engine* engine, const void* archive,
         size_t archiveByteCount) {
-    return new UbershaderProvider(engine, archive, archiveByteCount);
+    // The archive stays compressed, its materials are decompressed when they're first needed.
+    void* copy = malloc(archiveByteCount);
+    memcpy(copy, archive, archiveByteCount);
+    return new UbershaderProvider(engine, { copy, archiveByteCount,
+            [](void* buffer, size_t, void*) { free(buffer); } });
+}
+
+MaterialProvider* createUbershaderProvider(Engine* engine, backend::BufferDescriptor&& archive) {
+    return new UbershaderProvider(engine, std::move(archive));
 }
 
 } // namespace filament::gltfio
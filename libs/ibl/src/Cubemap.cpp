@@ -205,9 +205,13 @@ Cubemap::Texel Cubemap::trilinearFilterAt(const Cubemap& l0, const Cubemap& l1,
 {
     Cubemap::Address addr(getAddressFor(L));
     const Image& i0 = l0.getImageForFace(addr.face);
-    const Image& i1 = l1.getImageForFace(addr.face);
     float x0 = std::min(addr.s * l0.mDimensions, l0.mUpperBound);
     float y0 = std::min(addr.t * l0.mDimensions, l0.mUpperBound);
+    if (&l0 == &l1 || lerp == 0.0f) {
+        // e.g. samples clamped to the last level, only one level contributes
+        return filterAt(i0, x0, y0);
+    }
+    const Image& i1 = l1.getImageForFace(addr.face);
     float x1 = std::min(addr.s * l1.mDimensions, l1.mUpperBound);
     float y1 = std::min(addr.t * l1.mDimensions, l1.mUpperBound);
     float3 c0 = filterAt(i0, x0, y0);
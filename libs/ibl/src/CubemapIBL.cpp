@@ -410,8 +410,12 @@ void CubemapIBL::roughnessFilter(
         entry.brdf_NoL *= 1.0f / weight;
     }
 
-    // we can sample the cubemap in any order, sort by the weight, it could improve fp precision
+    // we can sample the cubemap in any order, sort by level so that consecutive samples read
+    // the same images, then by the weight, it could improve fp precision
     std::sort(cache.begin(), cache.end(), [](CacheEntry const& lhs, CacheEntry const& rhs) {
+        if (lhs.l0 != rhs.l0) {
+            return lhs.l0 < rhs.l0;
+        }
         return lhs.brdf_NoL < rhs.brdf_NoL;
     });
 
@@ -428,30 +432,44 @@ void CubemapIBL::roughnessFilter(
             size_t p = progress.fetch_add(1, std::memory_order_relaxed) + 1;
             updater(0, (float) p / ((float) dim * 6.0f), userdata);
         }
-        mat3 R;
+        // Texels are filtered in groups, each cache entry is loaded once per group and the
+        // independent accumulations of the group can be interleaved and vectorized.
+        constexpr size_t GROUP_SIZE = 4;
+        mat3f R[GROUP_SIZE];
+        float3 Li[GROUP_SIZE];
         const size_t numSamples = cache.size();
-        for (size_t x = 0; x < dim; ++x, ++data) {
-            const float2 p(Cubemap::center(x, y));
-            const float3 N(dst.getDirectionFor(f, p.x, p.y) * mirror);
-
-            // center the cone around the normal (handle case of normal close to up)
-            const float3 up = std::abs(N.z) < 0.999 ? float3(0, 0, 1) : float3(1, 0, 0);
-            R[0] = normalize(cross(up, N));
-            R[1] = cross(N, R[0]);
-            R[2] = N;
-
-            R *= mat3f::rotation(state.distribution(state.gen), float3{0,0,1});
+        for (size_t x = 0; x < dim; x += GROUP_SIZE) {
+            const size_t count = std::min(GROUP_SIZE, dim - x);
+            for (size_t k = 0; k < count; k++) {
+                const float2 p(Cubemap::center(x + k, y));
+                const float3 N(dst.getDirectionFor(f, p.x, p.y) * mirror);
+
+                // center the cone around the normal (handle case of normal close to up)
+                const float3 up = std::abs(N.z) < 0.999 ? float3(0, 0, 1) : float3(1, 0, 0);
+                mat3 Rk;
+                Rk[0] = normalize(cross(up, N));
+                Rk[1] = cross(N, Rk[0]);
+                Rk[2] = N;
+
+                Rk *= mat3f::rotation(state.distribution(state.gen), float3{0,0,1});
+                R[k] = mat3f(Rk);
+                Li[k] = 0;
+            }
 
-            float3 Li = 0;
             for (size_t sample = 0; sample < numSamples; sample++) {
                 const CacheEntry& e = cache[sample];
-                const float3 L(R * e.L);
                 const Cubemap& cmBase = levels[e.l0];
                 const Cubemap& next = levels[e.l1];
-                const float3 c0 = Cubemap::trilinearFilterAt(cmBase, next, e.lerp, L);
-                Li += c0 * e.brdf_NoL;
+                for (size_t k = 0; k < count; k++) {
+                    const float3 L(R[k] * e.L);
+                    const float3 c0 = Cubemap::trilinearFilterAt(cmBase, next, e.lerp, L);
+                    Li[k] += c0 * e.brdf_NoL;
+                }
+            }
+
+            for (size_t k = 0; k < count; k++, ++data) {
+                Cubemap::writeAt(data, Cubemap::Texel(Li[k]));
             }
-            Cubemap::writeAt(data, Cubemap::Texel(Li));
         }
     };
 
@@ -320,17 +320,48 @@ public:
                 filament::Texture const* environmentCubemap,
                 filament::Texture* outReflectionsTexture = nullptr);
 
-        // TODO: option for progressive filtering
+        /**
+         * Progressively generates a prefiltered cubemap, for environments that change at runtime
+         * (e.g. rendered into a cubemap every few frames). Each call filters passCount passes,
+         * a pass being three faces of one level, so that the cost of each call is bounded. All
+         * the levels are filtered after 2 * outReflectionsTexture->getLevels() passes.
+         *
+         * The environment cubemap can be updated between calls. Its mipmaps, if
+         * Options.generateMipmap is true, are only generated by the first pass of each cycle.
+         *
+         * @param options                   Options for this environment
+         * @param environmentCubemap        Environment cubemap (input). Can't be null. Same
+         *                                  requirements as operator().
+         * @param outReflectionsTexture     Output prefiltered texture. Can't be null. Same
+         *                                  requirements as operator(). Filtering starts over
+         *                                  when a different texture is used.
+         * @param passCount                 Number of passes to filter during this call.
+         * @return true if this call completed the filtering of all the levels, the next call
+         *         then starts over with the first level.
+         */
+        bool step(Options options,
+                filament::Texture const* environmentCubemap,
+                filament::Texture* outReflectionsTexture,
+                uint32_t passCount = 1u);
 
         // TODO: add a callback for when the processing is done?
 
     private:
         filament::Texture* createReflectionsTexture();
+        void checkPreconditions(filament::Texture const* environmentCubemap,
+                filament::Texture const* outReflectionsTexture) const;
+        void filter(Options const& options,
+                filament::Texture const* environmentCubemap,
+                filament::Texture* outReflectionsTexture,
+                uint32_t firstPass, uint32_t lastPass);
         IBLPrefilterContext& mContext;
         filament::Material* mKernelMaterial = nullptr;
         filament::Texture* mKernelTexture = nullptr;
         uint32_t mSampleCount = 0u;
         uint8_t mLevelCount = 1u;
+        // progressive filtering state, see step()
+        filament::Texture const* mStepTarget = nullptr;
+        uint32_t mNextPass = 0u;
     };
 
 private:
@@ -580,6 +580,8 @@ IBLPrefilterContext::SpecularFilter::operator=(SpecularFilter&& rhs) noexcept {
         swap(mKernelTexture, rhs.mKernelTexture);
         mSampleCount = rhs.mSampleCount;
         mLevelCount = rhs.mLevelCount;
+        mStepTarget = rhs.mStepTarget;
+        mNextPass = rhs.mNextPass;
     }
     return *this;
 }
@@ -613,8 +615,53 @@ Texture* IBLPrefilterContext::SpecularFilter::operator()(
         Texture const* environmentCubemap, Texture* outReflectionsTexture) {
 
     SYSTRACE_CALL();
-    using namespace backend;
 
+    if (outReflectionsTexture == nullptr) {
+        outReflectionsTexture = createReflectionsTexture();
+    }
+
+    checkPreconditions(environmentCubemap, outReflectionsTexture);
+
+    filter(options, environmentCubemap, outReflectionsTexture,
+            0, outReflectionsTexture->getLevels() * 2u);
+
+    return outReflectionsTexture;
+}
+
+bool IBLPrefilterContext::SpecularFilter::step(
+        IBLPrefilterContext::SpecularFilter::Options options,
+        Texture const* environmentCubemap, Texture* outReflectionsTexture, uint32_t passCount) {
+
+    SYSTRACE_CALL();
+
+    FILAMENT_CHECK_PRECONDITION(outReflectionsTexture != nullptr)
+            << "outReflectionsTexture is null!";
+
+    checkPreconditions(environmentCubemap, outReflectionsTexture);
+
+    if (outReflectionsTexture != mStepTarget) {
+        // start over with a new target
+        mStepTarget = outReflectionsTexture;
+        mNextPass = 0;
+    }
+
+    // one pass per side of each level, that is three faces
+    const uint32_t totalPassCount = outReflectionsTexture->getLevels() * 2u;
+    const uint32_t first = std::min(mNextPass, totalPassCount);
+    const uint32_t last = std::min(first + std::max(passCount, 1u), totalPassCount);
+
+    filter(options, environmentCubemap, outReflectionsTexture, first, last);
+
+    mNextPass = last;
+    if (last == totalPassCount) {
+        mNextPass = 0;
+        return true;
+    }
+    return false;
+}
+
+void IBLPrefilterContext::SpecularFilter::checkPreconditions(
+        Texture const* environmentCubemap, Texture const* outReflectionsTexture) const {
     FILAMENT_CHECK_PRECONDITION(environmentCubemap != nullptr) << "environmentCubemap is null!";
 
     FILAMENT_CHECK_PRECONDITION(
@@ -627,10 +674,6 @@ Texture* IBLPrefilterContext::SpecularFilter::operator()(
     FILAMENT_CHECK_PRECONDITION(environmentCubemap->getLevels() == maxLevelCount)
             << "environmentCubemap must have " << +maxLevelCount << " mipmap levels allocated.";
 
-    if (outReflectionsTexture == nullptr) {
-        outReflectionsTexture = createReflectionsTexture();
-    }
-
     FILAMENT_CHECK_PRECONDITION(
             outReflectionsTexture->getTarget() == Texture::Sampler::SAMPLER_CUBEMAP)
             << "outReflectionsTexture must be a cubemap.";
@@ -638,6 +681,16 @@ Texture* IBLPrefilterContext::SpecularFilter::operator()(
     FILAMENT_CHECK_PRECONDITION(mLevelCount <= outReflectionsTexture->getLevels())
             << "outReflectionsTexture has " << +outReflectionsTexture->getLevels() << " levels but "
             << +mLevelCount << " are requested.";
+}
+
+void IBLPrefilterContext::SpecularFilter::filter(Options const& options,
+        Texture const* environmentCubemap, Texture* outReflectionsTexture,
+        uint32_t const firstPass, uint32_t const lastPass) {
+    using namespace backend;
+
+    if (firstPass >= lastPass) {
+        return;
+    }
 
     const TextureCubemapFace faces[2][3] = {
             { TextureCubemapFace::POSITIVE_X, TextureCubemapFace::POSITIVE_Y, TextureCubemapFace::POSITIVE_Z },
@@ -657,8 +710,8 @@ Texture* IBLPrefilterContext::SpecularFilter::operator()(
     const float linear = options.hdrLinear;
     const float compress = options.hdrMax;
     const uint8_t levels = outReflectionsTexture->getLevels();
-    uint32_t dim = outReflectionsTexture->getWidth();
-    const float omegaP = (4.0f * f::PI) / float(6 * dim * dim);
+    const uint32_t baseDim = outReflectionsTexture->getWidth();
+    const float omegaP = (4.0f * f::PI) / float(6 * baseDim * baseDim);
 
     TextureSampler environmentSampler;
     environmentSampler.setMagFilter(SamplerMagFilter::LINEAR);
@@ -669,7 +722,7 @@ Texture* IBLPrefilterContext::SpecularFilter::operator()(
     mi->setParameter("compress", float2{ linear, compress });
     mi->setParameter("lodOffset", options.lodOffset - log4(omegaP));
 
-    if (options.generateMipmap) {
+    if (options.generateMipmap && firstPass == 0) {
         // We need mipmaps for prefiltering
         environmentCubemap->generateMipmaps(engine);
     }
@@ -679,7 +732,7 @@ Texture* IBLPrefilterContext::SpecularFilter::operator()(
            .texture(RenderTarget::AttachmentPoint::COLOR1, outReflectionsTexture)
            .texture(RenderTarget::AttachmentPoint::COLOR2, outReflectionsTexture);
 
-    for (size_t lod = 0; lod < levels; lod++) {
+    for (uint32_t lod = firstPass / 2u, c = (lastPass + 1u) / 2u; lod < c; lod++) {
         SYSTRACE_NAME("executeFilterLOD");
 
         mi->setParameter("sampleCount", uint32_t(lod == 0 ? 1u : sampleCount));
@@ -696,9 +749,12 @@ Texture* IBLPrefilterContext::SpecularFilter::operator()(
                .mipLevel(RenderTarget::AttachmentPoint::COLOR1, lod)
                .mipLevel(RenderTarget::AttachmentPoint::COLOR2, lod);
 
+        const uint32_t dim = std::max(1u, baseDim >> lod);
         view->setViewport({ 0, 0, dim, dim });
 
-        for (size_t i = 0; i < 2; i++) {
+        const uint32_t firstSide = lod == firstPass / 2u ? firstPass % 2u : 0u;
+        const uint32_t lastSide = std::min(2u, lastPass - lod * 2u);
+        for (size_t i = firstSide; i < lastSide; i++) {
             mi->setParameter("side", i == 0 ? 1.0f : -1.0f);
 
             builder.face(RenderTarget::AttachmentPoint::COLOR0, faces[i][0])
@@ -710,13 +766,9 @@ Texture* IBLPrefilterContext::SpecularFilter::operator()(
             renderer->renderStandaloneView(view);
             engine.destroy(rt);
         }
-
-        dim >>= 1;
     }
 
     rcm.clearMaterialInstanceAt(ci, 0);
 
     engine.destroy(mi);
-
-    return outReflectionsTexture;
 }
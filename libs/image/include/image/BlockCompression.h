@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef IMAGE_BLOCKCOMPRESSION_H
+#define IMAGE_BLOCKCOMPRESSION_H
+
+#include <utils/compiler.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace image {
+
+/**
+ * Block compressed formats that can be encoded at runtime, e.g. for images decoded or generated
+ * by the application. These are fast, single pass encoders: the quality is below that of offline
+ * tools, but images use 4 to 8 times less memory than RGBA8.
+ *
+ * The sRGB variants of the formats use the same encoding.
+ */
+enum class BlockFormat : uint8_t {
+    BC1,                // DXT1, RGB, 8 bytes per block
+    BC3,                // DXT5, RGBA, 16 bytes per block
+    ETC2_RGB8,          // RGB, 8 bytes per block, ETC1 compatible
+    ETC2_EAC_RGBA8,     // RGBA, 16 bytes per block
+};
+
+/** Returns the size in bytes of a width x height image compressed with the given format. */
+UTILS_PUBLIC
+size_t getCompressedSize(BlockFormat format, uint32_t width, uint32_t height) noexcept;
+
+/**
+ * Compresses an RGBA8 image, one 4x4 block at a time.
+ *
+ * Images whose size is not a multiple of 4 are padded by replicating their last row and column.
+ * Blocks are written row by row, in the same orientation as the source rows.
+ *
+ * @param format    Format to compress to.
+ * @param rgba      Source texels, 4 bytes per texel.
+ * @param width     Width of the image in texels.
+ * @param height    Height of the image in texels.
+ * @param stride    Number of bytes between two rows of the source, or 0 if tightly packed.
+ * @param out       Destination, of at least getCompressedSize(format, width, height) bytes.
+ */
+UTILS_PUBLIC
+void compressBlocks(BlockFormat format, uint8_t const* rgba, uint32_t width, uint32_t height,
+        size_t stride, uint8_t* out) noexcept;
+
+} // namespace image
+
+#endif // IMAGE_BLOCKCOMPRESSION_H
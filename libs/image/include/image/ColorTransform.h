@@ -27,7 +27,9 @@
 #include <math/half.h>
 
 #include <algorithm>
+#include <array>
 #include <memory>
+#include <type_traits>
 
 namespace image {
 
@@ -143,6 +145,19 @@ inline filament::math::float4 sRGBToLinear(const filament::math::float4& sRGB) {
     return linear;
 }
 
+// Converts an 8-bit sRGB value to linear, using a table of the 256 possible results rather than
+// calling pow() for each channel of each pixel.
+inline float sRGBToLinear8(uint8_t sRGB) {
+    static const std::array<float, 256> table = [] {
+        std::array<float, 256> result{};
+        for (size_t i = 0; i < result.size(); i++) {
+            result[i] = sRGBToLinear(filament::math::float3(float(i) / 255.0f)).x;
+        }
+        return result;
+    }();
+    return table[sRGB];
+}
+
 template<typename T>
 T linearToSRGB(const T& color);
 
@@ -353,6 +368,10 @@ static LinearImage toLinearWithAlpha(size_t w, size_t h, size_t bpr, const uint8
     for (size_t y = 0; y < h; ++y) {
         T const* p = reinterpret_cast<T const*>(src + y * bpr);
         for (size_t x = 0; x < w; ++x, p += 4) {
+            if constexpr (std::is_same_v<T, uint8_t>) {
+                *d++ = { sRGBToLinear8(p[0]), sRGBToLinear8(p[1]), sRGBToLinear8(p[2]), 1.0f };
+                continue;
+            }
             filament::math::float3 sRGB(p[0], p[1], p[2]);
             sRGB /= std::numeric_limits<T>::max();
             *d++ = filament::math::float4(sRGBToLinear(sRGB), 1.0f);
@@ -368,6 +387,10 @@ static LinearImage toLinear(size_t w, size_t h, size_t bpr, const uint8_t* src)
     for (size_t y = 0; y < h; ++y) {
         T const* p = reinterpret_cast<T const*>(src + y * bpr);
         for (size_t x = 0; x < w; ++x, p += 3) {
+            if constexpr (std::is_same_v<T, uint8_t>) {
+                *d++ = { sRGBToLinear8(p[0]), sRGBToLinear8(p[1]), sRGBToLinear8(p[2]) };
+                continue;
+            }
             filament::math::float3 sRGB(p[0], p[1], p[2]);
             sRGB /= std::numeric_limits<T>::max();
             *d++ = sRGBToLinear(sRGB);
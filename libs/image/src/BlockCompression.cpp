@@ -0,0 +1,326 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <image/BlockCompression.h>
+
+#define STB_DXT_IMPLEMENTATION
+#define STB_DXT_STATIC
+#include <stb_dxt.h>
+
+#include <algorithm>
+#include <limits>
+
+#include <string.h>
+
+namespace image {
+
+namespace {
+
+// 16 RGBA texels, row by row
+using Block = uint8_t[64];
+
+void writeBigEndian(uint8_t* out, uint64_t const bits) noexcept {
+    for (int i = 0; i < 8; i++) {
+        out[i] = uint8_t(bits >> (56 - 8 * i));
+    }
+}
+
+int clamp255(int const v) noexcept {
+    return std::clamp(v, 0, 255);
+}
+
+// ------------------------------------------------------------------------------------------------
+// ETC1 (and ETC2 RGB8, which decodes ETC1 blocks unchanged)
+// ------------------------------------------------------------------------------------------------
+
+constexpr int ETC1_MODIFIERS[8][2] = {
+        { 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 },
+        { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 }
+};
+
+struct SubBlock {
+    uint32_t error;
+    uint8_t table;
+    uint8_t indices[8];     // 2-bit pixel indices, in the order of the sub-block's pixels
+};
+
+// Picks the best modifier table, and the modifier of each pixel, for a base color.
+SubBlock fitSubBlock(uint8_t const* const* pixels,
+        int const r, int const g, int const b) noexcept {
+    SubBlock best{ std::numeric_limits<uint32_t>::max(), 0, {} };
+    for (uint8_t table = 0; table < 8; table++) {
+        int const small = ETC1_MODIFIERS[table][0];
+        int const big = ETC1_MODIFIERS[table][1];
+        // pixel index -> modifier
+        int const modifiers[4] = { small, big, -small, -big };
+        SubBlock candidate{ 0, table, {} };
+        for (int i = 0; i < 8; i++) {
+            uint8_t const* p = pixels[i];
+            uint32_t bestError = std::numeric_limits<uint32_t>::max();
+            for (uint8_t index = 0; index < 4; index++) {
+                int const dr = clamp255(r + modifiers[index]) - p[0];
+                int const dg = clamp255(g + modifiers[index]) - p[1];
+                int const db = clamp255(b + modifiers[index]) - p[2];
+                uint32_t const error = uint32_t(dr * dr + dg * dg + db * db);
+                if (error < bestError) {
+                    bestError = error;
+                    candidate.indices[i] = index;
+                }
+            }
+            candidate.error += bestError;
+            if (candidate.error >= best.error) {
+                break;
+            }
+        }
+        if (candidate.error < best.error) {
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+uint64_t encodeEtc1Block(Block const& block) noexcept {
+    uint64_t bestBits = 0;
+    uint32_t bestError = std::numeric_limits<uint32_t>::max();
+
+    for (int flip = 0; flip < 2; flip++) {
+        // flip == 0: two 2x4 sub-blocks side by side, flip == 1: two 4x2 sub-blocks
+        uint8_t const* pixels[2][8];
+        uint8_t positions[2][8];    // pixel index in the block, x * 4 + y
+        int count[2] = {};
+        for (int y = 0; y < 4; y++) {
+            for (int x = 0; x < 4; x++) {
+                int const s = flip ? (y >= 2) : (x >= 2);
+                pixels[s][count[s]] = block + (y * 4 + x) * 4;
+                positions[s][count[s]] = uint8_t(x * 4 + y);
+                count[s]++;
+            }
+        }
+
+        int average[2][3];
+        for (int s = 0; s < 2; s++) {
+            for (int c = 0; c < 3; c++) {
+                int sum = 0;
+                for (int i = 0; i < 8; i++) {
+                    sum += pixels[s][i][c];
+                }
+                average[s][c] = (sum + 4) / 8;
+            }
+        }
+
+        // the differential mode (555 + 333 delta) is more precise, use it when the two colors
+        // are close enough
+        int q[2][3];
+        bool differential = true;
+        for (int s = 0; s < 2; s++) {
+            for (int c = 0; c < 3; c++) {
+                q[s][c] = (average[s][c] * 31 + 127) / 255;
+            }
+        }
+        for (int c = 0; c < 3; c++) {
+            int const d = q[1][c] - q[0][c];
+            differential = differential && d >= -4 && d <= 3;
+        }
+
+        int base[2][3];
+        if (differential) {
+            for (int s = 0; s < 2; s++) {
+                for (int c = 0; c < 3; c++) {
+                    base[s][c] = (q[s][c] << 3) | (q[s][c] >> 2);
+                }
+            }
+        } else {
+            for (int s = 0; s < 2; s++) {
+                for (int c = 0; c < 3; c++) {
+                    q[s][c] = (average[s][c] * 15 + 127) / 255;
+                    base[s][c] = q[s][c] * 17;
+                }
+            }
+        }
+
+        SubBlock const fits[2] = {
+                fitSubBlock(pixels[0], base[0][0], base[0][1], base[0][2]),
+                fitSubBlock(pixels[1], base[1][0], base[1][1], base[1][2]) };
+        uint32_t const error = fits[0].error + fits[1].error;
+        if (error >= bestError) {
+            continue;
+        }
+        bestError = error;
+
+        uint64_t bits = 0;
+        for (int c = 0; c < 3; c++) {
+            int const shift = 59 - c * 8;
+            if (differential) {
+                bits |= uint64_t(q[0][c]) << shift;
+                bits |= uint64_t((q[1][c] - q[0][c]) & 0x7) << (shift - 3);
+            } else {
+                bits |= uint64_t(q[0][c]) << (shift + 1);
+                bits |= uint64_t(q[1][c]) << (shift - 3);
+            }
+        }
+        bits |= uint64_t(fits[0].table) << 37;
+        bits |= uint64_t(fits[1].table) << 34;
+        bits |= uint64_t(differential) << 33;
+        bits |= uint64_t(flip) << 32;
+        for (int s = 0; s < 2; s++) {
+            for (int i = 0; i < 8; i++) {
+                uint8_t const index = fits[s].indices[i];
+                int const p = positions[s][i];
+                bits |= uint64_t(index >> 1) << (16 + p);
+                bits |= uint64_t(index & 1) << p;
+            }
+        }
+        bestBits = bits;
+    }
+    return bestBits;
+}
+
+// ------------------------------------------------------------------------------------------------
+// EAC alpha
+// ------------------------------------------------------------------------------------------------
+
+constexpr int EAC_MODIFIERS[16][8] = {
+        { -3, -6, -9, -15, 2, 5, 8, 14 },
+        { -3, -7, -10, -13, 2, 6, 9, 12 },
+        { -2, -5, -8, -13, 1, 4, 7, 12 },
+        { -2, -4, -6, -13, 1, 3, 5, 12 },
+        { -3, -6, -8, -12, 2, 5, 7, 11 },
+        { -3, -7, -9, -11, 2, 6, 8, 10 },
+        { -4, -7, -8, -11, 3, 6, 7, 10 },
+        { -3, -5, -8, -11, 2, 4, 7, 10 },
+        { -2, -6, -8, -10, 1, 5, 7, 9 },
+        { -2, -5, -8, -10, 1, 4, 7, 9 },
+        { -2, -4, -8, -10, 1, 3, 7, 9 },
+        { -2, -5, -7, -10, 1, 4, 6, 9 },
+        { -3, -4, -7, -10, 2, 3, 6, 9 },
+        { -1, -2, -3, -10, 0, 1, 2, 9 },
+        { -4, -6, -8, -9, 3, 5, 7, 8 },
+        { -3, -5, -7, -9, 2, 4, 6, 8 }
+};
+
+uint64_t encodeEacAlphaBlock(Block const& block) noexcept {
+    int alpha[16];      // in the order of the indices, x * 4 + y
+    int amin = 255;
+    int amax = 0;
+    for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 4; x++) {
+            int const a = block[(y * 4 + x) * 4 + 3];
+            alpha[x * 4 + y] = a;
+            amin = std::min(amin, a);
+            amax = std::max(amax, a);
+        }
+    }
+
+    if (amin == amax) {
+        // table 13 has a modifier of 0 at index 4
+        uint64_t bits = uint64_t(amin) << 56 | uint64_t(1) << 52 | uint64_t(13) << 48;
+        for (int i = 0; i < 16; i++) {
+            bits |= uint64_t(4) << (45 - 3 * i);
+        }
+        return bits;
+    }
+
+    uint64_t bestBits = 0;
+    uint32_t bestError = std::numeric_limits<uint32_t>::max();
+    for (int table = 0; table < 16; table++) {
+        int const* modifiers = EAC_MODIFIERS[table];
+        int const range = modifiers[7] - modifiers[3];
+        // the multiplier that stretches the table over [amin, amax], rounded down and up
+        int const low = std::clamp((amax - amin) / range, 1, 15);
+        int const high = std::min(low + 1, 15);
+        // the table isn't symmetric, so try a few bases around the one that maps to amin
+        for (int candidate = 0; candidate < 10; candidate++) {
+            int const multiplier = candidate < 5 ? low : high;
+            int const base = clamp255(amin - modifiers[3] * multiplier + candidate % 5 - 2);
+            uint64_t bits = uint64_t(base) << 56 | uint64_t(multiplier) << 52 |
+                            uint64_t(table) << 48;
+            uint32_t error = 0;
+            for (int i = 0; i < 16 && error < bestError; i++) {
+                uint32_t pixelError = std::numeric_limits<uint32_t>::max();
+                int bestIndex = 0;
+                for (int index = 0; index < 8; index++) {
+                    int const d = clamp255(base + modifiers[index] * multiplier) - alpha[i];
+                    if (uint32_t(d * d) < pixelError) {
+                        pixelError = uint32_t(d * d);
+                        bestIndex = index;
+                    }
+                }
+                error += pixelError;
+                bits |= uint64_t(bestIndex) << (45 - 3 * i);
+            }
+            if (error < bestError) {
+                bestError = error;
+                bestBits = bits;
+            }
+        }
+    }
+    return bestBits;
+}
+
+size_t getBlockSize(BlockFormat const format) noexcept {
+    switch (format) {
+        case BlockFormat::BC1:
+        case BlockFormat::ETC2_RGB8:
+            return 8;
+        case BlockFormat::BC3:
+        case BlockFormat::ETC2_EAC_RGBA8:
+            return 16;
+    }
+    return 16;
+}
+
+} // anonymous namespace
+
+size_t getCompressedSize(BlockFormat const format, uint32_t const width,
+        uint32_t const height) noexcept {
+    return size_t((width + 3) / 4) * ((height + 3) / 4) * getBlockSize(format);
+}
+
+void compressBlocks(BlockFormat const format, uint8_t const* rgba, uint32_t const width,
+        uint32_t const height, size_t stride, uint8_t* out) noexcept {
+    stride = stride ? stride : size_t(width) * 4;
+    size_t const blockSize = getBlockSize(format);
+    Block block;
+    for (uint32_t by = 0; by < height; by += 4) {
+        for (uint32_t bx = 0; bx < width; bx += 4) {
+            // gather the block, replicating the last row and column of the image
+            for (uint32_t y = 0; y < 4; y++) {
+                uint8_t const* row = rgba + std::min(by + y, height - 1) * stride;
+                for (uint32_t x = 0; x < 4; x++) {
+                    memcpy(block + (y * 4 + x) * 4, row + std::min(bx + x, width - 1) * 4, 4);
+                }
+            }
+            switch (format) {
+                case BlockFormat::BC1:
+                    stb_compress_dxt_block(out, block, 0, STB_DXT_NORMAL);
+                    break;
+                case BlockFormat::BC3:
+                    stb_compress_dxt_block(out, block, 1, STB_DXT_NORMAL);
+                    break;
+                case BlockFormat::ETC2_RGB8:
+                    writeBigEndian(out, encodeEtc1Block(block));
+                    break;
+                case BlockFormat::ETC2_EAC_RGBA8:
+                    writeBigEndian(out, encodeEacAlphaBlock(block));
+                    writeBigEndian(out + 8, encodeEtc1Block(block));
+                    break;
+            }
+            out += blockSize;
+        }
+    }
+}
+
+} // namespace image
@@ -21,14 +21,19 @@
 #include <math/vec3.h>
 #include <math/vec4.h>
 
+#include <utils/JobSystem.h>
 #include <utils/Panic.h>
 
+#include <algorithm>
+#include <functional>
+#include <limits>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 using namespace image;
+using namespace utils;
 
 namespace {
 
@@ -134,6 +139,11 @@ void generateMadProgram(uint32_t ntarget, uint32_t nsource, float left, float ri
     // than necessary.
     const float filterBounds = domainScale * std::abs(filter.boundingRadius);
 
+    // The bound above grows with the size of the target when minifying, so the iteration is also
+    // limited to the support of the filter function, past which the weights are zero. The Box
+    // function is non-zero up to 0.5, and all the others are zero beyond their radius of 1 or 2.
+    const float supportBounds = std::max(std::abs(filter.boundingRadius), 1.0f) / domainScale;
+
     // Iterate through target samples. "xtarget" points to the center of each target pixel.
     float xtarget = dtarget / 2.0f;
     for (uint32_t itarget = 0; itarget < ntarget; ++itarget, xtarget += dtarget) {
@@ -143,9 +153,15 @@ void generateMadProgram(uint32_t ntarget, uint32_t nsource, float left, float ri
         uint32_t count = 0;
         float sum = 0;
 
-        // Iterate through source samples that lie within the bounded region.
-        const auto isource_lower = int32_t((xtarget - filterBounds) * nsource);
-        const auto isource_upper = int32_t(std::ceil((xtarget + filterBounds) * nsource));
+        // Iterate through source samples that lie within the bounded region, skipping those where
+        // the filter is zero. The support is mapped from the source range to the whole row, with
+        // one extra sample on each side for rounding.
+        const float xlower = left + (xtarget - supportBounds) * (right - left);
+        const float xupper = left + (xtarget + supportBounds) * (right - left);
+        const auto isource_lower = std::max(int32_t((xtarget - filterBounds) * nsource),
+                int32_t(std::floor(std::min(xlower, xupper) * nsource)) - 1);
+        const auto isource_upper = std::min(int32_t(std::ceil((xtarget + filterBounds) * nsource)),
+                int32_t(std::ceil(std::max(xlower, xupper) * nsource)) + 1);
         for (int32_t isource = isource_lower; isource <= isource_upper; ++isource) {
             const float xsource = (((isource + 0.5f) / nsource) - left) / (right - left);
             const bool outside_image = isource < 0 || isource >= int32_t(nsource);
@@ -172,22 +188,43 @@ void generateMadProgram(uint32_t ntarget, uint32_t nsource, float left, float ri
     }
 }
 
-// Transforms a MAD program intended for single-channel data into a program intended for
-// multi-channel data.
-void expandMadProgram(uint32_t nchannels, MadProgram* program) {
-    if (nchannels == 1) {
-        return;
-    }
-    MadProgram result;
-    result.reserve(program->size() * nchannels);
-    for (auto mad : *program) {
-        mad.sourceIndex *= nchannels;
-        mad.targetIndex *= nchannels;
-        for (uint32_t j = 0; j < nchannels; ++j, ++mad.sourceIndex, ++mad.targetIndex) {
-            result.push_back(mad);
+// A filter kernel laid out for SIMD: each target sample reads a contiguous span of source
+// samples, whose weights are stored contiguously too. Gaps in the MAD program get a weight of zero.
+struct Kernel {
+    struct Span {
+        uint32_t first;     // index of the first source sample
+        uint32_t count;     // number of source samples
+        uint32_t weights;   // offset of the first weight
+    };
+    std::vector<Span> spans;    // indexed by target sample
+    std::vector<float> weights;
+};
+
+void generateKernel(uint32_t ntarget, uint32_t nsource, float left, float right,
+        FilterFunction filter, float radiusMultiplier, Kernel* result) {
+    MadProgram program;
+    generateMadProgram(ntarget, nsource, left, right, filter, radiusMultiplier, &program);
+
+    result->spans.assign(ntarget, { 0, 0, 0 });
+    result->weights.clear();
+    for (size_t i = 0, n = program.size(); i < n;) {
+        // The instructions of a target sample are consecutive, and sorted by source index.
+        const uint32_t itarget = program[i].targetIndex;
+        size_t end = i + 1;
+        while (end < n && program[end].targetIndex == itarget) {
+            ++end;
+        }
+        assert_invariant(program[i].sourceIndex >= 0);
+        assert_invariant(program[end - 1].sourceIndex < int32_t(nsource));
+        const auto first = uint32_t(program[i].sourceIndex);
+        const auto count = uint32_t(program[end - 1].sourceIndex + 1) - first;
+        const auto offset = uint32_t(result->weights.size());
+        result->spans[itarget] = { first, count, offset };
+        result->weights.resize(offset + count, 0.0f);
+        for (; i < end; ++i) {
+            result->weights[offset + program[i].sourceIndex - first] = program[i].weight;
         }
     }
-    program->swap(result);
 }
 
 FilterFunction createFilterFunction(Filter ftype) {
@@ -207,77 +244,204 @@ FilterFunction createFilterFunction(Filter ftype) {
     return fn;
 }
 
+Filter resolveFilter(Filter filter, uint32_t ntarget, uint32_t nsource) {
+    if (filter == Filter::DEFAULT) {
+        return ntarget > nsource ? Filter::MITCHELL : Filter::LANCZOS;
+    }
+    return filter;
+}
+
 template <class VecT>
-void normalizeImpl(LinearImage& image) {
-    const uint32_t width = image.getWidth(), height = image.getHeight();
-    auto vecs = (VecT*) image.getPixelRef();
-    for (uint32_t n = 0; n < width * height; ++n) {
+void normalizeRows(LinearImage& image, uint32_t row, uint32_t count) {
+    const uint32_t width = image.getWidth();
+    auto vecs = image.get<VecT>(0, row);
+    for (uint32_t n = 0; n < width * count; ++n) {
         vecs[n] = normalize(vecs[n]);
     }
 }
 
-void normalize(LinearImage& image) {
+void normalizeRows(LinearImage& image, uint32_t row, uint32_t count) {
     FILAMENT_CHECK_PRECONDITION(image.getChannels() == 3 || image.getChannels() == 4)
             << "Must be a 3 or 4 channel image";
     if (image.getChannels() == 3) {
-      normalizeImpl< filament::math::float3>(image);
+        normalizeRows<float3>(image, row, count);
     } else {
-      normalizeImpl< filament::math::float4>(image);
+        normalizeRows<float4>(image, row, count);
     }
 }
 
-LinearImage resampleImage1D(const LinearImage& source, MadProgram* program,
-        uint32_t twidth, Filter filter, float left, float right, float filterRadiusMultiplier) {
-    const uint32_t swidth = source.getWidth();
-    const uint32_t sheight = source.getHeight();
-    const uint32_t nchan = source.getChannels();
-    const bool mag = twidth > swidth;
-    if (filter == Filter::DEFAULT) filter = mag ? Filter::MITCHELL : Filter::LANCZOS;
-    const FilterFunction hfn = createFilterFunction(filter);
-
-    // Generate a flat list of multiply-add (MAD) instructions.
-    program->clear();
-    generateMadProgram(twidth, swidth, left, right, hfn, filterRadiusMultiplier, program);
-    expandMadProgram(nchan, program);
-
-    // Allocate the target image.
-    LinearImage result(twidth, sheight, nchan);
-    float const* sourceRow = source.getPixelRef();
-    float* targetRow = result.getPixelRef();
-
-    // The MIN filter is special because it starts with non-zero values and ignores filter weights.
-    if (filter == Filter::MINIMUM) {
-        for (uint32_t n = 0; n < twidth * sheight * nchan; ++n) {
-            targetRow[n] = std::numeric_limits<float>::max();
-        }
-        for (uint32_t row = 0; row < sheight; ++row) {
-            for (auto mad : *program) {
-                const float a = sourceRow[mad.sourceIndex];
-                const float b = targetRow[mad.targetIndex];
-                targetRow[mad.targetIndex] = std::min(a, b);
+// Runs f(firstRow, rowCount) over the given number of rows, split across the JobSystem if any.
+template<typename F>
+void forEachRows(JobSystem* js, uint32_t rows, F f) {
+    constexpr uint32_t ROWS_PER_JOB = 16;
+    if (!js || rows < 2 * ROWS_PER_JOB) {
+        f(0u, rows);
+        return;
+    }
+    auto job = jobs::parallel_for(*js, nullptr, 0, rows, std::ref(f),
+            jobs::CountSplitter<ROWS_PER_JOB, 8>());
+    js->runAndWait(job);
+}
+
+// Filters one row of NCHAN-channel pixels. NCHAN is a template parameter for the common channel
+// counts so that the channel loop unrolls and the accumulators stay in registers.
+template<uint32_t NCHAN, bool MINIMUM>
+void filterRow(float const* UTILS_RESTRICT source, float* UTILS_RESTRICT target,
+        Kernel const& kernel, uint32_t nchan) {
+    const uint32_t n = NCHAN ? NCHAN : nchan;
+    float acc[4];
+    for (Kernel::Span const& span : kernel.spans) {
+        float const* src = source + span.first * n;
+        float const* weights = kernel.weights.data() + span.weights;
+        for (uint32_t c0 = 0; c0 < n; c0 += 4) {
+            const uint32_t nc = std::min(n - c0, 4u);
+            for (uint32_t c = 0; c < 4; ++c) {
+                acc[c] = MINIMUM ? std::numeric_limits<float>::max() : 0.0f;
+            }
+            for (uint32_t i = 0; i < span.count; ++i) {
+                float const* s = src + i * n + c0;
+                const float w = weights[i];
+                if (MINIMUM) {
+                    if (w != 0) {
+                        for (uint32_t c = 0; c < nc; ++c) acc[c] = std::min(acc[c], s[c]);
+                    }
+                } else {
+                    for (uint32_t c = 0; c < nc; ++c) acc[c] += s[c] * w;
+                }
+            }
+            for (uint32_t c = 0; c < nc; ++c) {
+                target[c0 + c] = acc[c];
             }
-            targetRow += twidth * nchan;
-            sourceRow += swidth * nchan;
         }
-        return result;
+        target += n;
     }
+}
 
-    // Resize the image horizontally by executing the MAD instructions over each row.
-    for (uint32_t row = 0; row < sheight; ++row) {
-        for (auto mad : *program) {
-            targetRow[mad.targetIndex] += sourceRow[mad.sourceIndex] * mad.weight;
-        }
-        targetRow += twidth * nchan;
-        sourceRow += swidth * nchan;
+template<bool MINIMUM>
+void filterRows(LinearImage const& source, LinearImage& result, Kernel const& kernel,
+        uint32_t row, uint32_t count) {
+    const uint32_t nchan = source.getChannels();
+    auto filter = &filterRow<0, MINIMUM>;
+    switch (nchan) {
+        case 1: filter = &filterRow<1, MINIMUM>; break;
+        case 2: filter = &filterRow<2, MINIMUM>; break;
+        case 3: filter = &filterRow<3, MINIMUM>; break;
+        case 4: filter = &filterRow<4, MINIMUM>; break;
+    }
+    for (uint32_t y = row; y < row + count; ++y) {
+        filter(source.getPixelRef(0, y), result.getPixelRef(0, y), kernel, nchan);
     }
+}
 
-    // Perform post processing for the current pass.
-    if (filter == Filter::GAUSSIAN_NORMALS) {
-        normalize(result);
+// Computes each target row as the weighted sum of whole source rows. The inner loop is a
+// contiguous multiply-add that the compiler vectorizes; it runs over tiles of the row so that the
+// accumulated tile stays in the L1 cache while the source rows stream through.
+template<bool MINIMUM>
+void filterColumns(LinearImage const& source, LinearImage& result, Kernel const& kernel,
+        uint32_t row, uint32_t count) {
+    constexpr uint32_t TILE_SIZE = 1024;
+    const uint32_t rowSize = source.getWidth() * source.getChannels();
+    for (uint32_t y = row; y < row + count; ++y) {
+        Kernel::Span const& span = kernel.spans[y];
+        float const* weights = kernel.weights.data() + span.weights;
+        float* UTILS_RESTRICT target = result.getPixelRef(0, y);
+        for (uint32_t x0 = 0; x0 < rowSize; x0 += TILE_SIZE) {
+            const uint32_t x1 = std::min(x0 + TILE_SIZE, rowSize);
+            if (MINIMUM) {
+                std::fill(target + x0, target + x1, std::numeric_limits<float>::max());
+            }
+            for (uint32_t i = 0; i < span.count; ++i) {
+                float const* UTILS_RESTRICT src = source.getPixelRef(0, span.first + i);
+                const float w = weights[i];
+                if (MINIMUM) {
+                    if (w != 0) {
+                        for (uint32_t x = x0; x < x1; ++x) target[x] = std::min(target[x], src[x]);
+                    }
+                } else {
+                    for (uint32_t x = x0; x < x1; ++x) target[x] += src[x] * w;
+                }
+            }
+        }
     }
+}
+
+// Resizes the image horizontally.
+LinearImage resampleRows(JobSystem* js, const LinearImage& source, uint32_t twidth,
+        Filter filter, float left, float right, float filterRadiusMultiplier) {
+    const uint32_t swidth = source.getWidth();
+    const uint32_t sheight = source.getHeight();
+    filter = resolveFilter(filter, twidth, swidth);
+    Kernel kernel;
+    generateKernel(twidth, swidth, left, right, createFilterFunction(filter),
+            filterRadiusMultiplier, &kernel);
+
+    LinearImage result(twidth, sheight, source.getChannels());
+    forEachRows(js, sheight, [&](uint32_t row, uint32_t count) {
+        if (filter == Filter::MINIMUM) {
+            filterRows<true>(source, result, kernel, row, count);
+        } else {
+            filterRows<false>(source, result, kernel, row, count);
+        }
+        if (filter == Filter::GAUSSIAN_NORMALS) {
+            normalizeRows(result, row, count);
+        }
+    });
+    return result;
+}
+
+// Resizes the image vertically.
+LinearImage resampleColumns(JobSystem* js, const LinearImage& source, uint32_t theight,
+        Filter filter, float top, float bottom, float filterRadiusMultiplier) {
+    const uint32_t swidth = source.getWidth();
+    const uint32_t sheight = source.getHeight();
+    filter = resolveFilter(filter, theight, sheight);
+    Kernel kernel;
+    generateKernel(theight, sheight, top, bottom, createFilterFunction(filter),
+            filterRadiusMultiplier, &kernel);
+
+    LinearImage result(swidth, theight, source.getChannels());
+    forEachRows(js, theight, [&](uint32_t row, uint32_t count) {
+        if (filter == Filter::MINIMUM) {
+            filterColumns<true>(source, result, kernel, row, count);
+        } else {
+            filterColumns<false>(source, result, kernel, row, count);
+        }
+        if (filter == Filter::GAUSSIAN_NORMALS) {
+            normalizeRows(result, row, count);
+        }
+    });
     return result;
 }
 
+LinearImage resample(JobSystem* js, const LinearImage& source, uint32_t width, uint32_t height,
+        const ImageSampler& sampler) {
+    FILAMENT_CHECK_PRECONDITION(sampler.east.mode == Boundary::EXCLUDE &&
+            sampler.north.mode == Boundary::EXCLUDE && sampler.west.mode == Boundary::EXCLUDE &&
+            sampler.south.mode == Boundary::EXCLUDE)
+            << "Not yet implemented.";
+    const float radius = sampler.filterRadiusMultiplier;
+    Region const& region = sampler.sourceRegion;
+    LinearImage result = resampleRows(js, source, width, sampler.horizontalFilter,
+            region.left, region.right, radius);
+    return resampleColumns(js, result, height, sampler.verticalFilter,
+            region.top, region.bottom, radius);
+}
+
+void generateMips(JobSystem* js, const LinearImage& source, Filter filter, LinearImage* result,
+        uint32_t mips) {
+    mips = std::min(mips, getMipmapCount(source));
+    uint32_t width = source.getWidth();
+    uint32_t height = source.getHeight();
+    for (uint32_t n = 0; n < mips; ++n) {
+        width = std::max(width >> 1u, 1u);
+        height = std::max(height >> 1u, 1u);
+        result[n] = resample(js, source, width, height, ImageSampler {
+            .horizontalFilter = filter,
+            .verticalFilter = filter
+        });
+    }
+}
+
 } // anonymous namespace
 
 namespace image {
@@ -288,22 +452,7 @@ SingleSample::~SingleSample() {
 
 LinearImage resampleImage(const LinearImage& source, uint32_t width, uint32_t height,
         const ImageSampler& sampler) {
-    FILAMENT_CHECK_PRECONDITION(sampler.east.mode == Boundary::EXCLUDE &&
-            sampler.north.mode == Boundary::EXCLUDE && sampler.west.mode == Boundary::EXCLUDE &&
-            sampler.south.mode == Boundary::EXCLUDE)
-            << "Not yet implemented.";
-    const auto hfilter = sampler.horizontalFilter;
-    const auto vfilter = sampler.verticalFilter;
-    const float radius = sampler.filterRadiusMultiplier;
-    const float left = sampler.sourceRegion.left;
-    const float top = sampler.sourceRegion.top;
-    const float right = sampler.sourceRegion.right;
-    const float bottom = sampler.sourceRegion.bottom;
-    MadProgram program;
-    LinearImage result;
-    result = transpose(resampleImage1D(source, &program, width, hfilter, left, right, radius));
-    result = transpose(resampleImage1D(result, &program, height, vfilter, top, bottom, radius));
-    return result;
+    return resample(nullptr, source, width, height, sampler);
 }
 
 LinearImage resampleImage(const LinearImage& source, uint32_t width, uint32_t height,
@@ -314,6 +463,11 @@ LinearImage resampleImage(const LinearImage& source, uint32_t width, uint32_t he
     });
 }
 
+LinearImage resampleImage(JobSystem& js, const LinearImage& source, uint32_t width,
+        uint32_t height, const ImageSampler& sampler) {
+    return resample(&js, source, width, height, sampler);
+}
+
 void computeSingleSample(const LinearImage& source, float x, float y, SingleSample* result,
         Filter filter) {
     const float radius = 1.0f;
@@ -321,14 +475,13 @@ void computeSingleSample(const LinearImage& source, float x, float y, SingleSamp
     const float top = y - radius / source.getHeight();
     const float right = x + radius / source.getWidth();
     const float bottom = y + radius / source.getHeight();
-    MadProgram program;
-    LinearImage row = transpose(resampleImage1D(source, &program, 1, filter, left, right, radius));
-    row = resampleImage1D(row, &program, 1, filter, top, bottom, radius);
+    LinearImage column = resampleRows(nullptr, source, 1, filter, left, right, radius);
+    LinearImage pixel = resampleColumns(nullptr, column, 1, filter, top, bottom, radius);
     if (!result->data) {
         result->data = new float[source.getChannels()];
     }
     float* dst = result->data;
-    float const* src = row.getPixelRef();
+    float const* src = pixel.getPixelRef();
     for (uint32_t c = 0; c < source.getChannels(); ++c) {
         dst[c] = src[c];
     }
@@ -338,14 +491,12 @@ void computeSingleSample(const LinearImage& source, float x, float y, SingleSamp
 // Unlike traditional mipmap generation, our implementation generates all levels from the original
 // image, under the premise that this produces a higher quality result.
 void generateMipmaps(const LinearImage& source, Filter filter, LinearImage* result, uint32_t mips) {
-    mips = std::min(mips, getMipmapCount(source));
-    uint32_t width = source.getWidth();
-    uint32_t height = source.getHeight();
-    for (uint32_t n = 0; n < mips; ++n) {
-        width = std::max(width >> 1u, 1u);
-        height = std::max(height >> 1u, 1u);
-        result[n] = resampleImage(source, width, height, filter);
-    }
+    generateMips(nullptr, source, filter, result, mips);
+}
+
+void generateMipmaps(JobSystem& js, const LinearImage& source, Filter filter, LinearImage* result,
+        uint32_t mips) {
+    generateMips(&js, source, filter, result, mips);
 }
 
 uint32_t getMipmapCount(const LinearImage& source) {
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <image/BlockCompression.h>
 #include <image/ColorTransform.h>
 #include <image/Ktx1Bundle.h>
 #include <image/ImageOps.h>
@@ -26,12 +27,14 @@
 
 #include <gtest/gtest.h>
 
+#include <utils/JobSystem.h>
 #include <utils/Panic.h>
 #include <utils/Path.h>
 
 #include <math/vec3.h>
 #include <math/vec4.h>
 
+#include <algorithm>
 #include <fstream>
 #include <string>
 #include <sstream>
@@ -333,6 +336,36 @@ TEST_F(ImageTest, ColorTransformRGBA) { // NOLINT
     ASSERT_NEAR(pixels[3].w, 0.99183642f, 0.001f);
 }
 
+TEST_F(ImageTest, ColorTransformSRGB8) { // NOLINT
+    constexpr size_t w = 256;
+    std::unique_ptr<uint8_t[]> data(new uint8_t[w * 3]);
+    for (size_t i = 0; i < w * 3; i++) {
+        data[i] = uint8_t(i / 3);
+    }
+    LinearImage img = image::toLinear<uint8_t>(w, 1, w * 3, data.get());
+    auto pixels = img.get<float3>();
+    for (size_t i = 0; i < w; i++) {
+        const float3 expected = sRGBToLinear(float3(float(i) / 255.0f));
+        ASSERT_EQ(pixels[i], expected);
+    }
+}
+
+TEST_F(ImageTest, ResampleWithJobSystem) { // NOLINT
+    utils::JobSystem js;
+    js.adopt();
+    auto normals = createNormalMap(256);
+    for (Filter filter : { Filter::BOX, Filter::GAUSSIAN_NORMALS, Filter::MITCHELL,
+            Filter::LANCZOS, Filter::MINIMUM }) {
+        ImageSampler sampler { .horizontalFilter = filter, .verticalFilter = filter };
+        for (auto [width, height] : { std::pair{ 100u, 60u }, std::pair{ 300u, 400u } }) {
+            auto expected = resampleImage(normals, width, height, sampler);
+            auto actual = resampleImage(js, normals, width, height, sampler);
+            ASSERT_EQ(compare(expected, actual, 0.0f), 0);
+        }
+    }
+    js.emancipate();
+}
+
 TEST_F(ImageTest, Mipmaps) { // NOLINT
     Filter filter = filterFromString("HERMITE");
     ASSERT_EQ(filter, Filter::HERMITE);
@@ -362,6 +395,119 @@ TEST_F(ImageTest, Mipmaps) { // NOLINT
     }
 }
 
+// Reference decoders for the ETC1 (individual and differential modes) and EAC alpha blocks.
+static uint64_t readBigEndian(uint8_t const* in) {
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; i++) {
+        bits = (bits << 8) | in[i];
+    }
+    return bits;
+}
+
+static void decodeEtc1Block(uint8_t const* in, uint8_t rgb[16][3]) {
+    static constexpr int modifiers[8][2] = {
+            { 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 },
+            { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 } };
+    uint64_t const bits = readBigEndian(in);
+    bool const differential = (bits >> 33) & 1;
+    bool const flip = (bits >> 32) & 1;
+    int base[2][3];
+    for (int c = 0; c < 3; c++) {
+        int const shift = 59 - c * 8;
+        if (differential) {
+            int const c0 = int(bits >> shift) & 0x1F;
+            int d = int(bits >> (shift - 3)) & 0x7;
+            d = d >= 4 ? d - 8 : d;
+            int const c1 = c0 + d;
+            base[0][c] = (c0 << 3) | (c0 >> 2);
+            base[1][c] = (c1 << 3) | (c1 >> 2);
+        } else {
+            base[0][c] = (int(bits >> (shift + 1)) & 0xF) * 17;
+            base[1][c] = (int(bits >> (shift - 3)) & 0xF) * 17;
+        }
+    }
+    int const tables[2] = { int(bits >> 37) & 0x7, int(bits >> 34) & 0x7 };
+    for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 4; x++) {
+            int const s = flip ? (y >= 2) : (x >= 2);
+            int const p = x * 4 + y;
+            int const msb = int(bits >> (16 + p)) & 1;
+            int const lsb = int(bits >> p) & 1;
+            int modifier = modifiers[tables[s]][lsb];
+            modifier = msb ? -modifier : modifier;
+            for (int c = 0; c < 3; c++) {
+                rgb[y * 4 + x][c] = uint8_t(std::clamp(base[s][c] + modifier, 0, 255));
+            }
+        }
+    }
+}
+
+static void decodeEacAlphaBlock(uint8_t const* in, uint8_t alpha[16]) {
+    static constexpr int modifiers[16][8] = {
+            { -3, -6, -9, -15, 2, 5, 8, 14 }, { -3, -7, -10, -13, 2, 6, 9, 12 },
+            { -2, -5, -8, -13, 1, 4, 7, 12 }, { -2, -4, -6, -13, 1, 3, 5, 12 },
+            { -3, -6, -8, -12, 2, 5, 7, 11 }, { -3, -7, -9, -11, 2, 6, 8, 10 },
+            { -4, -7, -8, -11, 3, 6, 7, 10 }, { -3, -5, -8, -11, 2, 4, 7, 10 },
+            { -2, -6, -8, -10, 1, 5, 7, 9 }, { -2, -5, -8, -10, 1, 4, 7, 9 },
+            { -2, -4, -8, -10, 1, 3, 7, 9 }, { -2, -5, -7, -10, 1, 4, 6, 9 },
+            { -3, -4, -7, -10, 2, 3, 6, 9 }, { -1, -2, -3, -10, 0, 1, 2, 9 },
+            { -4, -6, -8, -9, 3, 5, 7, 8 }, { -3, -5, -7, -9, 2, 4, 6, 8 } };
+    uint64_t const bits = readBigEndian(in);
+    int const base = int(bits >> 56);
+    int const multiplier = int(bits >> 52) & 0xF;
+    int const table = int(bits >> 48) & 0xF;
+    for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 4; x++) {
+            int const index = int(bits >> (45 - 3 * (x * 4 + y))) & 0x7;
+            alpha[y * 4 + x] = uint8_t(std::clamp(
+                    base + modifiers[table][index] * multiplier, 0, 255));
+        }
+    }
+}
+
+TEST_F(ImageTest, BlockCompression) { // NOLINT
+    EXPECT_EQ(getCompressedSize(BlockFormat::BC1, 5, 4), 16);
+    EXPECT_EQ(getCompressedSize(BlockFormat::BC3, 4, 4), 16);
+    EXPECT_EQ(getCompressedSize(BlockFormat::ETC2_RGB8, 1, 1), 8);
+    EXPECT_EQ(getCompressedSize(BlockFormat::ETC2_EAC_RGBA8, 8, 6), 64);
+
+    // a 6x4 image, i.e. two blocks, whose left and right halves have different colors and
+    // alpha ramps
+    uint32_t const width = 6, height = 4;
+    vector<uint8_t> rgba(width * height * 4);
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            uint8_t* p = rgba.data() + (y * width + x) * 4;
+            bool const left = x < 2;
+            p[0] = left ? 200 : 40;
+            p[1] = left ? 60 : 180;
+            p[2] = left ? 30 : 90;
+            p[3] = uint8_t(255 - 16 * (x + y));
+        }
+    }
+
+    vector<uint8_t> blocks(getCompressedSize(BlockFormat::ETC2_EAC_RGBA8, width, height));
+    compressBlocks(BlockFormat::ETC2_EAC_RGBA8, rgba.data(), width, height, 0, blocks.data());
+
+    for (uint32_t block = 0; block < 2; block++) {
+        uint8_t alpha[16];
+        uint8_t rgb[16][3];
+        decodeEacAlphaBlock(blocks.data() + block * 16, alpha);
+        decodeEtc1Block(blocks.data() + block * 16 + 8, rgb);
+        for (uint32_t y = 0; y < 4; y++) {
+            for (uint32_t x = 0; x < 4; x++) {
+                // the last column is replicated
+                uint32_t const sx = std::min(block * 4 + x, width - 1);
+                uint8_t const* p = rgba.data() + (y * width + sx) * 4;
+                for (int c = 0; c < 3; c++) {
+                    EXPECT_NEAR(rgb[y * 4 + x][c], p[c], 12) << block << " " << x << " " << y;
+                }
+                EXPECT_NEAR(alpha[y * 4 + x], p[3], 4) << block << " " << x << " " << y;
+            }
+        }
+    }
+}
+
 TEST_F(ImageTest, Ktx) { // NOLINT
     uint8_t foo[] = {1, 2, 3};
     uint8_t* data;
@@ -32,6 +32,10 @@ namespace basist {
     class ktx2_transcoder;
 }
 
+namespace utils {
+    class JobSystem;
+}
+
 namespace ktxreader {
 
 class Ktx2Reader {
@@ -93,6 +97,25 @@ class Ktx2Reader {
          */
         Texture* load(const void* data, size_t size, TransferFunction transfer);
 
+        /**
+         * Same as load(), but textures that are already in a GPU format are uploaded straight
+         * from the given data, which must stay valid until the release callback is called.
+         *
+         * This is the case of KTX2 files that hold ASTC, ETC2/EAC or BC data without
+         * supercompression. Their levels are handed to Texture::setImage() without being copied or
+         * transcoded, so the fastest way to load them is to map the file in memory and to unmap it
+         * from the callback:
+         *
+         *    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+         *    Texture* texture = reader->load(data, size, TransferFunction::sRGB,
+         *            [](void* buffer, size_t size, void*) { munmap(buffer, size); });
+         *
+         * Other files are transcoded as by load(). The release callback is called exactly once,
+         * including when this method fails, possibly from another thread.
+         */
+        Texture* load(const void* data, size_t size, TransferFunction transfer,
+                Texture::PixelBufferDescriptor::Callback release, void* user = nullptr);
+
         /**
          * Asynchronous Interface
          * ======================
@@ -131,6 +154,15 @@ class Ktx2Reader {
              */
             Result doTranscoding();
 
+            /**
+             * Same as doTranscoding(), but transcodes the mipmaps concurrently, one job per
+             * miplevel in the given JobSystem.
+             *
+             * This must be called from a thread owned by the JobSystem (e.g. from within a job).
+             * Each miplevel becomes available to uploadImages() as soon as it is transcoded.
+             */
+            Result doTranscoding(utils::JobSystem& js);
+
             /**
              * Uploads pending mipmaps to the texture.
              *
@@ -19,11 +19,15 @@
 #include <filament/Engine.h>
 #include <filament/Texture.h>
 
+#include <utils/JobSystem.h>
 #include <utils/Log.h>
 
+#include <algorithm>
 #include <atomic>
 #include <vector>
 
+#include <string.h>
+
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Warray-bounds"
 #include <basisu_transcoder.h>
@@ -32,6 +36,8 @@
 using namespace basist;
 using namespace filament;
 
+using utils::JobSystem;
+
 using TransferFunction = ktxreader::Ktx2Reader::TransferFunction;
 using Result = ktxreader::Ktx2Reader::Result;
 using Async = ktxreader::Ktx2Reader::Async;
@@ -113,6 +119,147 @@ static void freeCallback(void* buf, size_t, void* userdata) {
     free(buf);
 }
 
+namespace {
+struct NativeFormatInfo {
+    bool isSupported;
+    TransferFunction transferFunction;
+    Texture::InternalFormat internalFormat;
+    Texture::CompressedType compressedPixelDataType;
+};
+
+// A KTX2 file whose levels are stored in a GPU format, without supercompression.
+struct NativeImage {
+    NativeFormatInfo format;
+    uint32_t width;
+    uint32_t height;
+    uint32_t levelCount;
+    const ktx2_level_index* levels;
+};
+}
+
+// Maps the Vulkan format of a KTX2 file to the equivalent Filament format, for the compressed
+// formats that can be uploaded without transcoding. Formats that do not hold colors (e.g. BC4 or
+// EAC) are considered linear.
+static NativeFormatInfo getNativeFormatInfo(uint32_t vkFormat) {
+    using tif = Texture::InternalFormat;
+    using tct = Texture::CompressedType;
+    const auto sRGB = TransferFunction::sRGB;
+    const auto LINEAR = TransferFunction::LINEAR;
+
+    // VK_FORMAT_ASTC_4x4_UNORM_BLOCK to VK_FORMAT_ASTC_12x12_SRGB_BLOCK alternate between UNORM
+    // and SRGB, with the block sizes in the same order as Filament's enums.
+    if (vkFormat >= 157 && vkFormat <= 184) {
+        const uint16_t blockIndex = (vkFormat - 157) / 2;
+        const bool srgb = (vkFormat - 157) & 1;
+        const uint16_t first = uint16_t(srgb ? tif::SRGB8_ALPHA8_ASTC_4x4 : tif::RGBA_ASTC_4x4);
+        const uint16_t firstType = uint16_t(srgb ? tct::SRGB8_ALPHA8_ASTC_4x4 : tct::RGBA_ASTC_4x4);
+        return { true, srgb ? sRGB : LINEAR, tif(first + blockIndex), tct(firstType + blockIndex) };
+    }
+
+    switch (vkFormat) {
+        case 131: return { true, LINEAR, tif::DXT1_RGB, tct::DXT1_RGB };
+        case 132: return { true, sRGB, tif::DXT1_SRGB, tct::DXT1_SRGB };
+        case 133: return { true, LINEAR, tif::DXT1_RGBA, tct::DXT1_RGBA };
+        case 134: return { true, sRGB, tif::DXT1_SRGBA, tct::DXT1_SRGBA };
+        case 135: return { true, LINEAR, tif::DXT3_RGBA, tct::DXT3_RGBA };
+        case 136: return { true, sRGB, tif::DXT3_SRGBA, tct::DXT3_SRGBA };
+        case 137: return { true, LINEAR, tif::DXT5_RGBA, tct::DXT5_RGBA };
+        case 138: return { true, sRGB, tif::DXT5_SRGBA, tct::DXT5_SRGBA };
+        case 139: return { true, LINEAR, tif::RED_RGTC1, tct::RED_RGTC1 };
+        case 140: return { true, LINEAR, tif::SIGNED_RED_RGTC1, tct::SIGNED_RED_RGTC1 };
+        case 141: return { true, LINEAR, tif::RED_GREEN_RGTC2, tct::RED_GREEN_RGTC2 };
+        case 142: return { true, LINEAR, tif::SIGNED_RED_GREEN_RGTC2, tct::SIGNED_RED_GREEN_RGTC2 };
+        case 143: return { true, LINEAR, tif::RGB_BPTC_UNSIGNED_FLOAT, tct::RGB_BPTC_UNSIGNED_FLOAT };
+        case 144: return { true, LINEAR, tif::RGB_BPTC_SIGNED_FLOAT, tct::RGB_BPTC_SIGNED_FLOAT };
+        case 145: return { true, LINEAR, tif::RGBA_BPTC_UNORM, tct::RGBA_BPTC_UNORM };
+        case 146: return { true, sRGB, tif::SRGB_ALPHA_BPTC_UNORM, tct::SRGB_ALPHA_BPTC_UNORM };
+        case 147: return { true, LINEAR, tif::ETC2_RGB8, tct::ETC2_RGB8 };
+        case 148: return { true, sRGB, tif::ETC2_SRGB8, tct::ETC2_SRGB8 };
+        case 149: return { true, LINEAR, tif::ETC2_RGB8_A1, tct::ETC2_RGB8_A1 };
+        case 150: return { true, sRGB, tif::ETC2_SRGB8_A1, tct::ETC2_SRGB8_A1 };
+        case 151: return { true, LINEAR, tif::ETC2_EAC_RGBA8, tct::ETC2_EAC_RGBA8 };
+        case 152: return { true, sRGB, tif::ETC2_EAC_SRGBA8, tct::ETC2_EAC_SRGBA8 };
+        case 153: return { true, LINEAR, tif::EAC_R11, tct::EAC_R11 };
+        case 154: return { true, LINEAR, tif::EAC_R11_SIGNED, tct::EAC_R11_SIGNED };
+        case 155: return { true, LINEAR, tif::EAC_RG11, tct::EAC_RG11 };
+        case 156: return { true, LINEAR, tif::EAC_RG11_SIGNED, tct::EAC_RG11_SIGNED };
+        default: return {};
+    }
+}
+
+// Returns true if the given KTX2 blob holds a 2D texture in a GPU format that can be uploaded as
+// is, and if all of its levels lie within the blob. Such files can't be read by BasisU.
+static bool parseNativeImage(const void* data, size_t size, NativeImage* image) {
+    if (size < sizeof(ktx2_header)) {
+        return false;
+    }
+    const ktx2_header& header = *static_cast<const ktx2_header*>(data);
+    if (memcmp(header.m_identifier, g_ktx2_file_identifier, sizeof(header.m_identifier)) != 0) {
+        return false;
+    }
+    const NativeFormatInfo format = getNativeFormatInfo(header.m_vk_format);
+    if (!format.isSupported ||
+            header.m_supercompression_scheme != KTX2_SS_NONE ||
+            header.m_pixel_depth > 1 || header.m_layer_count > 1 || header.m_face_count != 1) {
+        return false;
+    }
+
+    // A level count of 0 asks the loader to generate the mipmaps, which we don't do.
+    const uint32_t levelCount = std::max(uint32_t(header.m_level_count), 1u);
+    if (levelCount > KTX2_MAX_SUPPORTED_LEVEL_COUNT ||
+            size < sizeof(ktx2_header) + levelCount * sizeof(ktx2_level_index)) {
+        return false;
+    }
+    const auto* levels = reinterpret_cast<const ktx2_level_index*>(
+            static_cast<const uint8_t*>(data) + sizeof(ktx2_header));
+    for (uint32_t levelIndex = 0; levelIndex < levelCount; levelIndex++) {
+        const uint64_t offset = levels[levelIndex].m_byte_offset;
+        const uint64_t length = levels[levelIndex].m_byte_length;
+        if (length == 0 || length > UINT32_MAX || offset > size || length > size - offset) {
+            return false;
+        }
+    }
+
+    *image = { format, header.m_pixel_width, std::max(uint32_t(header.m_pixel_height), 1u),
+            levelCount, levels };
+    return true;
+}
+
+static Texture* createNativeTexture(Engine& engine, bool quiet, const NativeImage& image,
+        TransferFunction transfer) {
+    if (image.format.transferFunction != transfer) {
+        if (!quiet) {
+            utils::slog.e << "Source texture is marked "
+                    << (transfer == TransferFunction::sRGB ? "linear" : "sRGB")
+                    << ", but client is requesting "
+                    << (transfer == TransferFunction::sRGB ? "sRGB." : "linear.")
+                    << utils::io::endl;
+        }
+        return nullptr;
+    }
+
+    if (!Texture::isTextureFormatSupported(engine, image.format.internalFormat)) {
+        if (!quiet) {
+            utils::slog.e << "The texture format of the KTX2 file is not supported."
+                    << utils::io::endl;
+        }
+        return nullptr;
+    }
+
+    Texture* texture = Texture::Builder()
+        .width(image.width)
+        .height(image.height)
+        .levels(image.levelCount)
+        .sampler(Texture::Sampler::SAMPLER_2D)
+        .format(image.format.internalFormat)
+        .build(engine);
+
+    if (texture == nullptr && !quiet) {
+        utils::slog.e << "Unable to construct texture using KTX2 info." << utils::io::endl;
+    }
+    return texture;
+}
+
 // This helper is used by both the asynchronous and synchronous API's.
 static Result transcodeImageLevel(ktx2_transcoder& transcoder,
         ktx2_transcoder_state& transcoderState, Texture::InternalFormat format,
@@ -161,6 +308,50 @@ static Result transcodeImageLevel(ktx2_transcoder& transcoder,
     return Result::SUCCESS;
 }
 
+// Transcodes all the miplevels concurrently, one job per level. The BasisU transcoder is
+// thread-safe at level granularity as long as each job uses its own ktx2_transcoder_state.
+// The consumer is called from the jobs as each level completes. This must be called from a
+// thread owned by the JobSystem.
+template<typename Consumer>
+static Result transcodeImageLevels(JobSystem& js, ktx2_transcoder& transcoder,
+        Texture::InternalFormat format, Consumer consumer) {
+    std::atomic<Result> result{ Result::SUCCESS };
+    auto transcode = [&transcoder, format, &consumer, &result](uint32_t levelIndex) {
+        ktx2_transcoder_state basisThreadState;
+        basisThreadState.clear();
+        Texture::PixelBufferDescriptor* pbd;
+        Result const r = transcodeImageLevel(transcoder, basisThreadState, format,
+                levelIndex, &pbd);
+        if (UTILS_UNLIKELY(r != Result::SUCCESS)) {
+            result.store(r, std::memory_order_relaxed);
+            return;
+        }
+        consumer(levelIndex, pbd);
+    };
+
+    uint32_t const levelCount = transcoder.get_levels();
+    if (levelCount <= 1) {
+        for (uint32_t levelIndex = 0; levelIndex < levelCount; levelIndex++) {
+            transcode(levelIndex);
+        }
+        return result.load(std::memory_order_relaxed);
+    }
+
+    // The base level is by far the most expensive, it's scheduled first so that the smaller
+    // levels can fill the other threads.
+    // Transcoding is loading work, it must not delay the frame's jobs.
+    JobSystem::Job* parent = js.createJob();
+    JobSystem::setPriority(parent, JobSystem::JobPriority::BACKGROUND);
+    for (uint32_t levelIndex = 0; levelIndex < levelCount; levelIndex++) {
+        JobSystem::Job* job = utils::jobs::createJob(js, parent, [&transcode, levelIndex]() {
+            transcode(levelIndex);
+        });
+        js.run(job);
+    }
+    js.runAndWait(parent);
+    return result.load(std::memory_order_relaxed);
+}
+
 namespace ktxreader {
 
 class FAsync : public Async {
@@ -170,6 +361,7 @@ public:
             mSourceBuffer(std::move(buf)) {}
     Texture* getTexture() const noexcept { return mTexture; }
     Result doTranscoding();
+    Result doTranscoding(JobSystem& js);
     void uploadImages();
 
 protected:
@@ -231,6 +423,24 @@ void Ktx2Reader::unrequestFormat(Texture::InternalFormat format) noexcept {
 }
 
 Texture* Ktx2Reader::load(const void* data, size_t size, TransferFunction transfer) {
+    // Files that are already in a GPU format only need their levels to be copied.
+    NativeImage image;
+    if (parseNativeImage(data, size, &image)) {
+        Texture* texture = createNativeTexture(mEngine, mQuiet, image, transfer);
+        if (texture == nullptr) {
+            return nullptr;
+        }
+        for (uint32_t levelIndex = 0; levelIndex < image.levelCount; levelIndex++) {
+            const ktx2_level_index& level = image.levels[levelIndex];
+            const size_t length = level.m_byte_length;
+            void* buffer = malloc(length);
+            memcpy(buffer, static_cast<const uint8_t*>(data) + level.m_byte_offset, length);
+            texture->setImage(mEngine, levelIndex, Texture::PixelBufferDescriptor(buffer, length,
+                    image.format.compressedPixelDataType, uint32_t(length), freeCallback));
+        }
+        return texture;
+    }
+
     Texture* texture = createTexture(mTranscoder, data, size, transfer);
     if (texture == nullptr) {
         return nullptr;
@@ -244,21 +454,77 @@ Texture* Ktx2Reader::load(const void* data, size_t size, TransferFunction transf
         return nullptr;
     }
 
-    ktx2_transcoder_state basisThreadState;
-    basisThreadState.clear();
+    // Levels are transcoded concurrently, but Texture::setImage() must be called from this thread.
+    Texture::PixelBufferDescriptor* levels[KTX2_MAX_SUPPORTED_LEVEL_COUNT] = {};
+    Result const result = transcodeImageLevels(mEngine.getJobSystem(), *mTranscoder,
+            texture->getFormat(), [&levels](uint32_t levelIndex, auto* pbd) {
+                levels[levelIndex] = pbd;
+            });
 
     for (uint32_t levelIndex = 0, n = mTranscoder->get_levels(); levelIndex < n; levelIndex++) {
-        Texture::PixelBufferDescriptor* pbd;
-        Result result = transcodeImageLevel(*mTranscoder, basisThreadState, texture->getFormat(),
-                levelIndex, &pbd);
-        if (UTILS_UNLIKELY(result != Result::SUCCESS)) {
-            mEngine.destroy(texture);
-            if (!mQuiet) {
-                utils::slog.e << "Failed to transcode level " << levelIndex << utils::io::endl;
+        Texture::PixelBufferDescriptor* const pbd = levels[levelIndex];
+        if (pbd && result == Result::SUCCESS) {
+            texture->setImage(mEngine, levelIndex, std::move(*pbd));
+        }
+        delete pbd;
+    }
+
+    if (UTILS_UNLIKELY(result != Result::SUCCESS)) {
+        mEngine.destroy(texture);
+        if (!mQuiet) {
+            utils::slog.e << "Failed to transcode texture." << utils::io::endl;
+        }
+        return nullptr;
+    }
+    return texture;
+}
+
+Texture* Ktx2Reader::load(const void* data, size_t size, TransferFunction transfer,
+        Texture::PixelBufferDescriptor::Callback release, void* user) {
+    NativeImage image;
+    if (!parseNativeImage(data, size, &image)) {
+        // BasisU files are transcoded into new buffers, so the source isn't needed afterwards.
+        Texture* texture = load(data, size, transfer);
+        if (release) {
+            release(const_cast<void*>(data), size, user);
+        }
+        return texture;
+    }
+
+    Texture* texture = createNativeTexture(mEngine, mQuiet, image, transfer);
+    if (texture == nullptr) {
+        if (release) {
+            release(const_cast<void*>(data), size, user);
+        }
+        return nullptr;
+    }
+
+    // Each level is uploaded straight from the given data, which is released along with the
+    // last level.
+    struct Userdata {
+        std::atomic<uint32_t> remainingBuffers;
+        Texture::PixelBufferDescriptor::Callback release;
+        void* user;
+        const void* data;
+        size_t size;
+    };
+    auto* userdata = new Userdata{ { image.levelCount }, release, user, data, size };
+    auto callback = [](void*, size_t, void* user) {
+        auto* userdata = static_cast<Userdata*>(user);
+        if (userdata->remainingBuffers.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            if (userdata->release) {
+                userdata->release(const_cast<void*>(userdata->data), userdata->size,
+                        userdata->user);
             }
-            return nullptr;
+            delete userdata;
         }
-        texture->setImage(mEngine, levelIndex, std::move(*pbd));
+    };
+    for (uint32_t levelIndex = 0; levelIndex < image.levelCount; levelIndex++) {
+        const ktx2_level_index& level = image.levels[levelIndex];
+        const size_t length = level.m_byte_length;
+        texture->setImage(mEngine, levelIndex, Texture::PixelBufferDescriptor(
+                static_cast<const uint8_t*>(data) + level.m_byte_offset, length,
+                image.format.compressedPixelDataType, uint32_t(length), callback, userdata));
     }
     return texture;
 }
@@ -287,6 +553,13 @@ Result FAsync::doTranscoding() {
     return Result::SUCCESS;
 }
 
+Result FAsync::doTranscoding(JobSystem& js) {
+    return transcodeImageLevels(js, *mTranscoder, mTexture->getFormat(),
+            [this](uint32_t levelIndex, Texture::PixelBufferDescriptor* pbd) {
+                mTranscoderResults[levelIndex].store(pbd);
+            });
+}
+
 void FAsync::uploadImages() {
     size_t levelIndex = 0;
     UTILS_NOUNROLL
@@ -434,6 +707,10 @@ Result Async::doTranscoding() {
     return static_cast<FAsync*>(this)->doTranscoding();
 }
 
+Result Async::doTranscoding(JobSystem& js) {
+    return static_cast<FAsync*>(this)->doTranscoding(js);
+}
+
 void Async::uploadImages() {
     return static_cast<FAsync*>(this)->uploadImages();
 }
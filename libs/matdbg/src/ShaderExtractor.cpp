@@ -83,7 +83,7 @@ bool ShaderExtractor::getShader(ShaderModel shaderModel,
         Variant variant, ShaderStage stage, ShaderContent& shader) noexcept {
 
     ChunkContainer const& cc = mChunkContainer;
-    if (!cc.hasChunk(mMaterialTag) || !cc.hasChunk(mDictionaryTag)) {
+    if (!cc.hasChunk(mMaterialTag) || !DictionaryReader::hasDictionary(cc, mDictionaryTag)) {
         return false;
     }
 
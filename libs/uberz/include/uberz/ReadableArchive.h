@@ -17,6 +17,7 @@
 #ifndef UBERZ_READABLE_ARCHIVE_H
 #define UBERZ_READABLE_ARCHIVE_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <uberz/ArchiveEnums.h>
@@ -27,8 +28,29 @@ namespace filament::uberz {
 
 // ArchiveSpec is a parse-free binary format. The client simply casts a word-aligned content blob
 // into a ReadableArchive struct pointer, then calls the following function to convert all the
-// offset fields into pointers.
-void convertOffsetsToPointers(struct ReadableArchive* archive);
+// offset fields into pointers. Package offsets are relative to packageData, which defaults to the
+// archive itself.
+void convertOffsetsToPointers(struct ReadableArchive* archive,
+        const uint8_t* packageData = nullptr);
+
+// Reads the contents of an archive file, as produced by WritableArchive::serialize().
+//
+// Only the header, the specs and the flags are copied. The specs point to their packages in the
+// given data, which must outlive the returned archive, and each package is decompressed on demand
+// with readPackage(). Archives from before version 1, which are compressed as a whole, are fully
+// decompressed instead.
+//
+// Returns null if the data isn't a valid archive. The result must be freed with destroyArchive().
+struct ReadableArchive* readArchive(const void* data, size_t size);
+void destroyArchive(struct ReadableArchive* archive);
+
+// Returns the size of the given spec's package once it's decompressed, or 0 if it's invalid.
+size_t getPackageSize(const struct ReadableArchive& archive, const struct ArchiveSpec& spec);
+
+// Decompresses the package of the given spec in dst, which must hold getPackageSize() bytes.
+// Packages are compressed independently, so different specs can be read concurrently.
+bool readPackage(const struct ReadableArchive& archive, const struct ArchiveSpec& spec,
+        void* dst, size_t dstSize);
 
 UTILS_WARNING_PUSH
 UTILS_WARNING_ENABLE_PADDED
@@ -36,6 +58,9 @@ UTILS_WARNING_ENABLE_PADDED
 // Precompiled set of materials bundled with a list of features flags that each material supports.
 // This is the readable counterpart to WriteableArchive.
 // Used by gltfio; users do not need to access this class directly.
+//
+// Since version 1, the archive itself isn't compressed. Each package is a separate zstd frame, and
+// packageByteCount is its compressed size. Specs with identical packages share the same frame.
 struct ReadableArchive {
     uint32_t magic;
     uint32_t version;
@@ -46,6 +71,9 @@ struct ReadableArchive {
     };
 };
 
+static constexpr uint32_t ARCHIVE_MAGIC = 'UBER';
+static constexpr uint32_t ARCHIVE_VERSION = 1;
+
 static constexpr Shading INVALID_SHADING_MODEL = (Shading) 0xff;
 static constexpr BlendingMode INVALID_BLENDING = (BlendingMode) 0xff;
 
@@ -27,6 +27,10 @@
 
 #include <tsl/robin_map.h>
 
+namespace utils {
+class JobSystem;
+} // namespace utils
+
 namespace filament::uberz {
 
 // Precompiled set of materials bundled with a list of features flags that each material supports.
@@ -42,12 +46,17 @@ public:
     void addSpecLine(std::string_view line);
     utils::FixedCapacityVector<uint8_t> serialize() const;
 
+    // Same as serialize(), but compresses the packages in parallel.
+    utils::FixedCapacityVector<uint8_t> serialize(utils::JobSystem& js) const;
+
     // Low-level alternatives to addSpecLine that do not involve parsing:
     void setShadingModel(Shading sm);
     void setBlendingModel(BlendingMode bm);
     void setFeatureFlag(const char* key, ArchiveFeature value);
 
 private:
+    utils::FixedCapacityVector<uint8_t> serialize(utils::JobSystem* js) const;
+
     size_t mLineNumber = 1;
     ssize_t mMaterialIndex = -1;
 
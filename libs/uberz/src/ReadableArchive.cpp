@@ -17,6 +17,13 @@
 #include <uberz/ReadableArchive.h>
 
 #include <utils/debug.h>
+#include <utils/memalign.h>
+
+#include <zstd.h>
+
+#include <algorithm>
+
+#include <string.h>
 
 using namespace filament;
 using namespace utils;
@@ -27,16 +34,19 @@ static_assert(sizeof(ReadableArchive) == 4 + 4 + 8 + 8);
 static_assert(sizeof(ArchiveSpec) == 1 + 1 + 2 + 4 + 8 + 8);
 static_assert(sizeof(ArchiveFlag) == 8 + 8);
 
-void convertOffsetsToPointers(ReadableArchive* archive) {
+void convertOffsetsToPointers(ReadableArchive* archive, const uint8_t* packageData) {
     constexpr size_t wordSize = sizeof(uint64_t);
     assert_invariant(archive->specsOffset % wordSize == 0);
     uint64_t* basePointer = (uint64_t*) archive;
+    if (packageData == nullptr) {
+        packageData = (const uint8_t*) basePointer;
+    }
     archive->specs = (ArchiveSpec*) (basePointer + archive->specsOffset / wordSize);
     for (uint64_t i = 0; i < archive->specsCount; ++i) {
         ArchiveSpec& spec = archive->specs[i];
         assert_invariant(spec.flagsOffset % wordSize == 0);
         spec.flags = (ArchiveFlag*) (basePointer + (spec.flagsOffset / wordSize));
-        spec.package = ((uint8_t*) basePointer) + spec.packageOffset;
+        spec.package = const_cast<uint8_t*>(packageData) + spec.packageOffset;
         for (uint64_t j = 0; j < spec.flagsCount; ++j) {
             ArchiveFlag& flag = spec.flags[j];
             flag.name = ((const char*) basePointer) + flag.nameOffset;
@@ -44,4 +54,125 @@ void convertOffsetsToPointers(ReadableArchive* archive) {
     }
 }
 
+// Version 0 archives are a single zstd frame, which holds the specs, the flags and the packages.
+static ReadableArchive* readLegacyArchive(const void* data, size_t size) {
+    const uint64_t decompSize = ZSTD_getFrameContentSize(data, size);
+    if (decompSize == ZSTD_CONTENTSIZE_UNKNOWN || decompSize == ZSTD_CONTENTSIZE_ERROR ||
+            decompSize < sizeof(ReadableArchive)) {
+        return nullptr;
+    }
+    ReadableArchive* archive = (ReadableArchive*) utils::aligned_alloc(decompSize,
+            sizeof(uint64_t));
+    const size_t result = ZSTD_decompress(archive, decompSize, data, size);
+    if (ZSTD_isError(result) || result != decompSize || archive->magic != ARCHIVE_MAGIC ||
+            archive->version != 0) {
+        utils::aligned_free(archive);
+        return nullptr;
+    }
+    convertOffsetsToPointers(archive);
+    return archive;
+}
+
+// Checks that the specs, flags and names are within the metadata, and that the packages are within
+// the archive, so that a corrupt file is rejected before any of its offsets is followed. Also
+// returns the size of the metadata, which ends where the first package begins.
+static bool validateArchive(const uint8_t* data, size_t size, size_t* metadataSize) {
+    constexpr size_t wordSize = sizeof(uint64_t);
+    ReadableArchive header;
+    memcpy(&header, data, sizeof(header));
+    if (header.specsOffset % wordSize != 0 || header.specsOffset > size ||
+            header.specsCount > (size - header.specsOffset) / sizeof(ArchiveSpec)) {
+        return false;
+    }
+
+    const size_t specsEnd = header.specsOffset + header.specsCount * sizeof(ArchiveSpec);
+    size_t packagesBegin = size;
+    for (uint64_t i = 0; i < header.specsCount; ++i) {
+        ArchiveSpec spec;
+        memcpy(&spec, data + header.specsOffset + i * sizeof(ArchiveSpec), sizeof(spec));
+        if (spec.packageOffset > size || spec.packageByteCount > size - spec.packageOffset) {
+            return false;
+        }
+        packagesBegin = std::min(packagesBegin, size_t(spec.packageOffset));
+    }
+    if (packagesBegin < specsEnd) {
+        return false;
+    }
+
+    for (uint64_t i = 0; i < header.specsCount; ++i) {
+        ArchiveSpec spec;
+        memcpy(&spec, data + header.specsOffset + i * sizeof(ArchiveSpec), sizeof(spec));
+        if (spec.flagsOffset % wordSize != 0 || spec.flagsOffset > packagesBegin ||
+                spec.flagsCount > (packagesBegin - spec.flagsOffset) / sizeof(ArchiveFlag)) {
+            return false;
+        }
+        for (uint64_t j = 0; j < spec.flagsCount; ++j) {
+            ArchiveFlag flag;
+            memcpy(&flag, data + spec.flagsOffset + j * sizeof(ArchiveFlag), sizeof(flag));
+            if (flag.nameOffset >= packagesBegin ||
+                    !memchr(data + flag.nameOffset, 0, packagesBegin - flag.nameOffset)) {
+                return false;
+            }
+        }
+    }
+
+    *metadataSize = packagesBegin;
+    return true;
+}
+
+ReadableArchive* readArchive(const void* data, size_t size) {
+    uint32_t magic = 0;
+    if (size < sizeof(ReadableArchive)) {
+        return nullptr;
+    }
+    memcpy(&magic, data, sizeof(magic));
+    if (magic == ZSTD_MAGICNUMBER) {
+        return readLegacyArchive(data, size);
+    }
+
+    // The metadata is copied, because the given data may be read-only (e.g. memory mapped) and
+    // isn't necessarily word-aligned. The packages stay where they are.
+    const uint8_t* const bytes = (const uint8_t*) data;
+    ReadableArchive header;
+    memcpy(&header, bytes, sizeof(header));
+    size_t metadataSize;
+    if (header.magic != ARCHIVE_MAGIC || header.version != ARCHIVE_VERSION ||
+            !validateArchive(bytes, size, &metadataSize)) {
+        return nullptr;
+    }
+    ReadableArchive* archive = (ReadableArchive*) utils::aligned_alloc(metadataSize,
+            sizeof(uint64_t));
+    memcpy(archive, bytes, metadataSize);
+    convertOffsetsToPointers(archive, bytes);
+    return archive;
+}
+
+void destroyArchive(ReadableArchive* archive) {
+    utils::aligned_free(archive);
+}
+
+size_t getPackageSize(const ReadableArchive& archive, const ArchiveSpec& spec) {
+    if (archive.version == 0) {
+        return spec.packageByteCount;
+    }
+    const uint64_t size = ZSTD_getFrameContentSize(spec.package, spec.packageByteCount);
+    if (size == ZSTD_CONTENTSIZE_UNKNOWN || size == ZSTD_CONTENTSIZE_ERROR) {
+        return 0;
+    }
+    return size_t(size);
+}
+
+bool readPackage(const ReadableArchive& archive, const ArchiveSpec& spec, void* dst,
+        size_t dstSize) {
+    if (archive.version == 0) {
+        if (dstSize != spec.packageByteCount) {
+            return false;
+        }
+        memcpy(dst, spec.package, dstSize);
+        return true;
+    }
+    const size_t result = ZSTD_decompress(dst, dstSize, spec.package, spec.packageByteCount);
+    return !ZSTD_isError(result) && result == dstSize;
+}
+
 } // namespace filament::uberz
@@ -19,8 +19,12 @@
 
 #include <zstd.h>
 
+#include <functional>
 #include <string_view>
 
+#include <string.h>
+
+#include <utils/JobSystem.h>
 #include <utils/Log.h>
 
 using namespace utils;
@@ -226,7 +230,55 @@ void WritableArchive::addSpecLine(string_view line) {
     ++mLineNumber;
 }
 
+// Compresses each package into its own zstd frame, so that readers can decompress the packages
+// they need, independently of each other.
+static FixedCapacityVector<FixedCapacityVector<uint8_t>> compressPackages(JobSystem* js,
+        FixedCapacityVector<const FixedCapacityVector<uint8_t>*> const& packages) {
+
+    // Maximum zstd compression is slow, but that's okay since uberz is invoked during the build,
+    // not at run time.  However in debug builds it is debilitatingly slow, and we're fine with
+    // larger archives, so we use minimum compression.
+#ifdef NDEBUG
+    const int compressionLevel = ZSTD_maxCLevel();
+#else
+    const int compressionLevel = ZSTD_minCLevel();
+#endif
+
+    FixedCapacityVector<FixedCapacityVector<uint8_t>> compressed(packages.size());
+    auto compress = [&](size_t first, size_t count) {
+        for (size_t i = first; i < first + count; i++) {
+            const FixedCapacityVector<uint8_t>& package = *packages[i];
+            FixedCapacityVector<uint8_t> buffer(ZSTD_compressBound(package.size()));
+            const size_t zstdResult = ZSTD_compress(buffer.data(), buffer.size(),
+                    package.data(), package.size(), compressionLevel);
+            if (ZSTD_isError(zstdResult)) {
+                PANIC_POSTCONDITION("Error during archive compression: %s",
+                        ZSTD_getErrorName(zstdResult));
+            }
+            buffer.resize(zstdResult);
+            compressed[i] = std::move(buffer);
+        }
+    };
+
+    if (js) {
+        auto* job = jobs::parallel_for(*js, nullptr, 0, uint32_t(packages.size()),
+                std::ref(compress), jobs::CountSplitter<1, 8>());
+        js->runAndWait(job);
+    } else {
+        compress(0, packages.size());
+    }
+    return compressed;
+}
+
 FixedCapacityVector<uint8_t> WritableArchive::serialize() const {
+    return serialize(nullptr);
+}
+
+FixedCapacityVector<uint8_t> WritableArchive::serialize(JobSystem& js) const {
+    return serialize(&js);
+}
+
+FixedCapacityVector<uint8_t> WritableArchive::serialize(JobSystem* js) const {
     size_t byteCount = sizeof(ReadableArchive);
     for (const auto& mat : mMaterials) {
         byteCount += sizeof(ArchiveSpec);
@@ -243,29 +295,56 @@ FixedCapacityVector<uint8_t> WritableArchive::serialize() const {
             byteCount += pair.first.size() + 1;
         }
     }
-    size_t filamatOffset = byteCount;
-    for (const auto& mat : mMaterials) {
-        byteCount += mat.package.size();
+
+    // Byte-identical packages (e.g. ubershaders that differ only by their spec) are stored once,
+    // their specs all point to the same bytes. Readers don't need to know about this.
+    auto uniqueIndices = FixedCapacityVector<uint32_t>::with_capacity(mMaterials.size());
+    auto uniquePackages = FixedCapacityVector<const FixedCapacityVector<uint8_t>*>::with_capacity(
+            mMaterials.size());
+    for (size_t i = 0, n = mMaterials.size(); i < n; i++) {
+        const auto& package = mMaterials[i].package;
+        uint32_t uniqueIndex = uniquePackages.size();
+        for (size_t j = 0; j < uniquePackages.size(); j++) {
+            const auto& other = *uniquePackages[j];
+            if (other.size() == package.size() &&
+                    memcmp(other.data(), package.data(), package.size()) == 0) {
+                uniqueIndex = j;
+                break;
+            }
+        }
+        if (uniqueIndex == uniquePackages.size()) {
+            uniquePackages.push_back(&package);
+        }
+        uniqueIndices.push_back(uniqueIndex);
+    }
+
+    const FixedCapacityVector<FixedCapacityVector<uint8_t>> compressedPackages =
+            compressPackages(js, uniquePackages);
+
+    auto packageOffsets = FixedCapacityVector<uint64_t>::with_capacity(uniquePackages.size());
+    for (const auto& compressed : compressedPackages) {
+        packageOffsets.push_back(byteCount);
+        byteCount += compressed.size();
     }
 
     ReadableArchive archive;
-    archive.magic = 'UBER';
-    archive.version = 0;
+    archive.magic = ARCHIVE_MAGIC;
+    archive.version = ARCHIVE_VERSION;
     archive.specsCount = mMaterials.size();
     archive.specsOffset = sizeof(ReadableArchive);
 
     auto specs = FixedCapacityVector<ArchiveSpec>::with_capacity(mMaterials.size());
     size_t flagCount = 0;
     for (const auto& mat : mMaterials) {
+        const uint32_t uniqueIndex = uniqueIndices[specs.size()];
         ArchiveSpec spec = {};
         spec.shadingModel = mat.shadingModel;
         spec.blendingMode = mat.blendingMode;
         spec.flagsCount = mat.flags.size();
         spec.flagsOffset = flaglistOffset + flagCount * sizeof(ArchiveFlag);
-        spec.packageByteCount = mat.package.size();
-        spec.packageOffset = filamatOffset;
+        spec.packageByteCount = compressedPackages[uniqueIndex].size();
+        spec.packageOffset = packageOffsets[uniqueIndex];
         specs.push_back(spec);
-        filamatOffset += mat.package.size();
         flagCount += mat.flags.size();
     }
 
@@ -301,31 +380,12 @@ FixedCapacityVector<uint8_t> WritableArchive::serialize() const {
     writeCursor += sizeof(ArchiveFlag) * flags.size();
     memcpy(writeCursor, flagNames.data(), charCount);
     writeCursor += charCount;
-    for (const auto& mat : mMaterials) {
-        memcpy(writeCursor, mat.package.data(), mat.package.size());
-        writeCursor += mat.package.size();
+    for (const auto& compressed : compressedPackages) {
+        memcpy(writeCursor, compressed.data(), compressed.size());
+        writeCursor += compressed.size();
     }
     assert_invariant(writeCursor - outputBuf.data() == outputBuf.size());
-
-    FixedCapacityVector<uint8_t> compressedBuf(ZSTD_compressBound(outputBuf.size()));
-
-    // Maximum zstd compression is slow, but that's okay since uberz is invoked during the build,
-    // not at run time.  However in debug builds it is debilitatingly slow, and we're fine with
-    // larger archives, so we use minimum compression.
-#ifdef NDEBUG
-    const int compressionLevel = ZSTD_maxCLevel();
-#else
-    const int compressionLevel = ZSTD_minCLevel();
-#endif
-
-    size_t zstdResult = ZSTD_compress(compressedBuf.data(), compressedBuf.size(), outputBuf.data(),
-            outputBuf.size(), compressionLevel);
-    if (ZSTD_isError(zstdResult)) {
-        PANIC_POSTCONDITION("Error during archive compression: %s", ZSTD_getErrorName(zstdResult));
-    }
-
-    compressedBuf.resize(zstdResult);
-    return compressedBuf;
+    return outputBuf;
 }
 
 void WritableArchive::setShadingModel(Shading sm) {
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PerformanceCounters.h"
+
+#include <utils/compiler.h>
+#include <utils/Condition.h>
+#include <utils/Mutex.h>
+#include <utils/SpscQueue.h>
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+using namespace utils;
+
+// These mirror the two ways filament's CommandBufferQueue hands command buffers from the main
+// thread to the driver thread: the mutex/condition based queue it used to have, and the
+// lock-free queue it uses now, with its optional spin-before-sleep.
+
+namespace {
+
+struct Range {
+    void* begin;
+    void* end;
+};
+
+class LockedQueue {
+public:
+    explicit LockedQueue(uint32_t) noexcept {}
+
+    void push(Range const& range) {
+        std::lock_guard<Mutex> const lock(mLock);
+        mItems.push_back(range);
+        mCondition.notify_one();
+    }
+
+    bool waitForItems(std::vector<Range>& items) {
+        std::unique_lock<Mutex> lock(mLock);
+        mCondition.wait(lock, [this]() { return !mItems.empty() || mExitRequested; });
+        items = std::move(mItems);
+        mItems.clear();
+        return !mExitRequested;
+    }
+
+    void requestExit() {
+        std::lock_guard<Mutex> const lock(mLock);
+        mExitRequested = true;
+        mCondition.notify_one();
+    }
+
+private:
+    Mutex mLock;
+    Condition mCondition;
+    std::vector<Range> mItems;
+    bool mExitRequested = false;
+};
+
+class LockFreeQueue {
+public:
+    explicit LockFreeQueue(uint32_t spinCount) noexcept : mSpinCount(spinCount) {}
+
+    void push(Range const& range) {
+        if (UTILS_UNLIKELY(!mItems.push(range))) {
+            wait([this]() { return !mItems.full(); });
+            mItems.push(range);
+        }
+        wake();
+    }
+
+    bool waitForItems(std::vector<Range>& items) {
+        wait([this]() { return !mItems.empty() || mExitRequested.load(); });
+        items.clear();
+        Range range;
+        while (mItems.pop(range)) {
+            items.push_back(range);
+        }
+        wake();
+        return !mExitRequested.load();
+    }
+
+    void requestExit() {
+        mExitRequested.store(true);
+        wake();
+    }
+
+private:
+    template<typename Predicate>
+    void wait(Predicate&& predicate) {
+        for (uint32_t i = 0; i < mSpinCount; i++) {
+            if (predicate()) {
+                return;
+            }
+            UTILS_PAUSE();
+        }
+        std::unique_lock<Mutex> lock(mLock);
+        mSleepers.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        mCondition.wait(lock, std::forward<Predicate>(predicate));
+        mSleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void wake() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (mSleepers.load(std::memory_order_relaxed)) {
+            std::lock_guard<Mutex> const lock(mLock);
+            mCondition.notify_all();
+        }
+    }
+
+    SpscQueue<Range, 256> mItems;
+    Mutex mLock;
+    Condition mCondition;
+    std::atomic<uint32_t> mSleepers{ 0 };
+    std::atomic<bool> mExitRequested{ false };
+    uint32_t const mSpinCount;
+};
+
+} // anonymous namespace
+
+template<typename Queue>
+static void BM_CommandBufferHandoff(benchmark::State& state) {
+    Queue queue(uint32_t(state.range(0)));
+    std::atomic<size_t> consumed{ 0 };
+
+    std::thread consumer([&queue, &consumed]() {
+        std::vector<Range> items;
+        while (queue.waitForItems(items)) {
+            consumed.fetch_add(items.size(), std::memory_order_relaxed);
+        }
+    });
+
+    size_t produced = 0;
+    {
+        PerformanceCounters pc(state);
+        for (auto _ : state) {
+            queue.push({});
+            produced++;
+        }
+        // the handoff is only complete once the consumer has seen everything
+        while (consumed.load(std::memory_order_relaxed) < produced) {
+            std::this_thread::yield();
+        }
+    }
+
+    queue.requestExit();
+    consumer.join();
+    state.SetItemsProcessed((int64_t)state.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_CommandBufferHandoff, LockedQueue)->Arg(0);
+BENCHMARK_TEMPLATE(BM_CommandBufferHandoff, LockFreeQueue)->Arg(0)->Arg(1000);
@@ -31,6 +31,7 @@
 #include <tsl/robin_map.h>
 
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <mutex>
 #include <type_traits>
@@ -47,6 +48,9 @@ class JobSystem {
     static constexpr size_t MAX_JOB_COUNT = 1 << 14; // 16384
     static constexpr uint32_t JOB_COUNT_MASK = MAX_JOB_COUNT - 1;
     static constexpr uint32_t WAITER_COUNT_SHIFT = 24;
+    // set in runningJobCount when cancellation of a job is requested
+    static constexpr uint32_t JOB_CANCELLED_BIT = 1u << (WAITER_COUNT_SHIFT - 1);
+    static_assert(JOB_COUNT_MASK < JOB_CANCELLED_BIT, "JOB_CANCELLED_BIT overlaps the job count");
     static_assert(MAX_JOB_COUNT <= 0x7FFE, "MAX_JOB_COUNT must be <= 0x7FFE");
     using WorkQueue = WorkStealingDequeue<uint16_t, MAX_JOB_COUNT>;
     using Mutex = utils::Mutex;
@@ -61,6 +65,17 @@ public:
 
     static constexpr ThreadId invalidThreadId = 0xff;
 
+    /*
+     * Each thread has a work queue per JobPriority. Background jobs only run (or are stolen)
+     * when there is no normal job left, so they yield to frame work at job boundaries.
+     */
+    enum class JobPriority : uint8_t {
+        NORMAL,         // frame-critical work (e.g. culling, command generation), the default
+        BACKGROUND,     // work that can be delayed in favor of the frame (e.g. texture decoding)
+    };
+
+    static constexpr size_t JOB_PRIORITY_COUNT = 2;
+
     class alignas(CACHELINE_SIZE) Job {
     public:
         Job() noexcept {} /* = default; */ /* clang bug */ // NOLINT(modernize-use-equals-default,cppcoreguidelines-pro-type-member-init)
@@ -82,7 +97,8 @@ public:
                                                                 // v7 | v8
         void* storage[JOB_STORAGE_SIZE_WORDS];                  // 48 | 48
         JobFunc function;                                       //  4 |  8
-        uint16_t parent;                                        //  2 |  2
+        uint16_t parent : 15;                                   //  2 |  2
+        uint16_t priority : 1;                                  //  (JobPriority)
         mutable ThreadId id = invalidThreadId;                  //  1 |  1
         mutable std::atomic<uint8_t> refCount = { 1 };          //  1 |  1
         std::atomic<uint32_t> runningJobCount = { 1 };          //  4 |  4
@@ -266,6 +282,50 @@ public:
      */
     void cancel(Job*& job) noexcept;
 
+    /*
+     * Requests the cooperative cancellation of a job that has been retained, see runAndRetain()
+     * and retain(). The job's function is still called, it is expected to check isCancelled()
+     * before starting its work, and possibly while it's running, to return early.
+     * Children of the job are not affected.
+     *
+     * The job still completes normally, it MUST BE waited on or released as usual.
+     * This can be called from any thread.
+     */
+    static void requestCancel(Job* job) noexcept;
+
+    /*
+     * Returns whether cancellation of this job was requested with requestCancel().
+     * This can be called from any thread, typically from the job itself.
+     */
+    static bool isCancelled(Job const* job) noexcept;
+
+    /*
+     * Sets the priority of a job, which must be called before the job is run. Child jobs
+     * inherit the priority of their parent when they're created, so the priority of a whole
+     * tree of jobs is set on its root.
+     */
+    static void setPriority(Job* job, JobPriority priority) noexcept;
+
+    static JobPriority getPriority(Job const* job) noexcept;
+
+    /*
+     * Runs continuation once job and all its children have completed, which is the
+     * non-blocking alternative to waiting on a job from another job: instead of calling
+     * runAndWait() on its children, a job can schedule the rest of its work as a continuation
+     * and return. This frees its thread for other jobs, and doesn't grow the stack with the
+     * jobs that would have been run while waiting.
+     *
+     * This must be called before job is run, and a job can only have one continuation.
+     * continuation is run on the thread that completes job, and is owned by the JobSystem
+     * after this call (as with run()). To keep a parent job waiting on it, create the
+     * continuation with that parent.
+     */
+    void runAfter(Job* job, Job*& continuation) noexcept;
+    void runAfter(Job* job, Job*&& continuation) noexcept { // allows runAfter(job, createJob(...))
+        Job* p = continuation;
+        runAfter(job, p);
+    }
+
     /*
      * Adds a reference to a Job.
      *
@@ -346,6 +406,55 @@ public:
     // for debugging
     friend io::ostream& operator << (io::ostream& out, JobSystem const& js);
 
+    /*
+     * Instrumentation
+     * ---------------
+     *
+     * When enabled, each thread records the number of jobs it executed, its successful and
+     * failed steal attempts, and the time it spent idle waiting for work. Jobs can also be
+     * labeled with setLabel(); the duration of labeled jobs is recorded per label. Child jobs
+     * (e.g. parallel_for's) inherit the label of their parent when they're created. Labels are
+     * also used as trace names when the JobSystem is built with SYSTRACE_TAG_JOBSYSTEM.
+     *
+     * Recording has a cost per job, so it's disabled by default.
+     */
+
+    struct ThreadStatistics {
+        uint64_t jobCount = 0;              // number of jobs executed
+        uint64_t stealCount = 0;            // number of jobs stolen from other threads
+        uint64_t failedStealCount = 0;      // number of attempts to steal from an empty queue
+        std::chrono::nanoseconds idleTime{};
+    };
+
+    struct LabelStatistics {
+        const char* label = nullptr;
+        uint64_t jobCount = 0;
+        std::chrono::nanoseconds totalTime{};
+        std::chrono::nanoseconds maxTime{};
+    };
+
+    struct Statistics {
+        std::vector<ThreadStatistics> threads;  // indexed by ThreadId
+        std::vector<LabelStatistics> labels;    // sorted by decreasing total time
+    };
+
+    // This must be called while no jobs are running.
+    void setInstrumentationEnabled(bool enabled) noexcept;
+
+    bool isInstrumentationEnabled() const noexcept {
+        return mInstrumentationEnabled.load(std::memory_order_relaxed);
+    }
+
+    // Labels a job that hasn't been run yet. label must stay valid for the lifetime of the
+    // JobSystem (typically a string literal). This does nothing if instrumentation is disabled.
+    void setLabel(Job* job, const char* label) noexcept;
+
+    // Returns the statistics recorded since instrumentation was enabled, or the last reset.
+    // This can be called from any thread.
+    Statistics getStatistics() const noexcept;
+
+    void resetStatistics() noexcept;
+
 
     // utility functions...
 
@@ -362,6 +471,17 @@ public:
     static void setThreadPriority(Priority priority) noexcept;
     static void setThreadAffinityById(size_t id) noexcept;
 
+    /*
+     * Returns the number of performance cores, that is all cores except the efficiency cores
+     * of heterogeneous (e.g. big.LITTLE) CPUs. Cores are classified by their capacity on Linux
+     * and Android, where efficiency cores have less than half the capacity of the largest ones.
+     * Elsewhere, and on homogeneous CPUs, this is the number of hardware threads.
+     */
+    static size_t getPerformanceCoreCount() noexcept;
+
+    // restricts the current thread to the performance cores, see getPerformanceCoreCount()
+    static void setThreadAffinityToPerformanceCores() noexcept;
+
     size_t getParallelSplitCount() const noexcept {
         return mParallelSplitCount;
     }
@@ -400,14 +520,22 @@ private:
     };
 
     struct alignas(CACHELINE_SIZE) ThreadState {    // this causes 40-bytes padding
-        // make sure storage is cache-line aligned
-        WorkQueue workQueue;
+        // make sure storage is cache-line aligned, indexed by JobPriority
+        WorkQueue workQueues[JOB_PRIORITY_COUNT];
 
         // these are not accessed by the worker threads
         alignas(CACHELINE_SIZE)         // this causes 56-bytes padding
         JobSystem* js;                  // this is in fact const and always initialized
         std::thread thread;             // unused for adopted threads
         default_random_engine rndGen;
+
+        // instrumentation, only written by this thread
+        std::atomic<uint64_t> jobCount = { 0 };
+        std::atomic<uint64_t> stealCount = { 0 };
+        std::atomic<uint64_t> failedStealCount = { 0 };
+        std::atomic<uint64_t> idleTime = { 0 };      // in nanoseconds
+        mutable Mutex labelLock;
+        tsl::robin_map<const char*, LabelStatistics> labels;
     };
 
     static_assert(sizeof(ThreadState) % CACHELINE_SIZE == 0,
@@ -425,15 +553,17 @@ private:
     void requestExit() noexcept;
     bool exitRequested() const noexcept;
     bool hasActiveJobs() const noexcept;
+    bool hasActiveJobs(JobPriority priority) const noexcept;
 
     void loop(ThreadState* state) noexcept;
     bool execute(ThreadState& state) noexcept;
-    Job* steal(ThreadState& state) noexcept;
-    void finish(Job* job) noexcept;
+    void executeInstrumented(ThreadState& state, Job* job) noexcept;
+    Job* steal(ThreadState& state, JobPriority priority) noexcept;
+    void finish(ThreadState& state, Job* job) noexcept;
 
-    void put(WorkQueue& workQueue, Job* job) noexcept;
-    Job* pop(WorkQueue& workQueue) noexcept;
-    Job* steal(WorkQueue& workQueue) noexcept;
+    void put(ThreadState& state, Job* job) noexcept;
+    Job* pop(WorkQueue& workQueue, JobPriority priority) noexcept;
+    Job* steal(WorkQueue& workQueue, JobPriority priority) noexcept;
 
     [[nodiscard]]
     uint32_t wait(std::unique_lock<Mutex>& lock, Job* job) noexcept;
@@ -445,7 +575,7 @@ private:
     Mutex mWaiterLock;
     Condition mWaiterCondition;
 
-    std::atomic<int32_t> mActiveJobs = { 0 };
+    std::atomic<int32_t> mActiveJobs[JOB_PRIORITY_COUNT] = { 0, 0 }; // indexed by JobPriority
     Arena<ObjectPoolAllocator<Job>, LockingPolicy::Mutex> mJobPool;
 
     template <typename T>
@@ -464,10 +594,15 @@ private:
     Job* const mJobStorageBase;                         // Base for conversion to indices
     uint16_t mThreadCount = 0;                          // total # of threads in the pool
     uint8_t mParallelSplitCount = 0;                    // # of split allowable in parallel_for
+    bool mUsePerformanceCores = false;                  // worker threads avoid efficiency cores
     Job* mRootJob = nullptr;
 
     Mutex mThreadMapLock; // this should have very little contention
     tsl::robin_map<std::thread::id, ThreadState *> mThreadMap;
+
+    std::atomic<bool> mInstrumentationEnabled = { false };
+    std::vector<const char*> mLabels;                   // indexed by job, when instrumented
+    std::vector<uint16_t> mContinuations;               // indexed by job, job index + 1 or 0
 };
 
 // -------------------------------------------------------------------------------------------------
@@ -22,6 +22,9 @@
 #include <utils/Entity.h>
 #include <utils/EntityInstance.h>
 #include <utils/SingleInstanceComponentManager.h>
+#include <utils/StringPool.h>
+
+#include <tsl/robin_map.h>
 
 #include <stddef.h>
 
@@ -47,7 +50,8 @@ class EntityManager;
  * printf("%s\n", names->getName(names->getInstance(myEntity));
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
  */
-class UTILS_PUBLIC NameComponentManager : private SingleInstanceComponentManager<CString> {
+class UTILS_PUBLIC NameComponentManager :
+        private SingleInstanceComponentManager<StringPool::Id, Entity, Entity> {
 public:
     using Instance = EntityInstance<NameComponentManager>;
 
@@ -86,6 +90,9 @@ public:
 
     /**
      * Stores a copy of the given string and associates it with the given instance.
+     *
+     * Names are interned: entities with the same name share a single copy of it, which is kept
+     * until the NameComponentManager is destroyed.
      */
     void setName(Instance instance, const char* name) noexcept;
 
@@ -96,11 +103,33 @@ public:
      */
     const char* getName(Instance instance) const noexcept;
 
+    /**
+     * Finds an entity with the given name, in constant time.
+     *
+     * @return the entity most recently given this name, or a null entity if there is none.
+     */
+    Entity getEntity(const char* name) const noexcept;
+
+    /**
+     * Returns the next entity with the same name as the given instance, in the order of
+     * getEntity(), or a null entity if there is none.
+     */
+    Entity getNextEntityWithSameName(Instance instance) const noexcept;
+
     void gc(EntityManager& em) noexcept {
-        SingleInstanceComponentManager<CString>::gc(em, [this](Entity e) {
+        SingleInstanceComponentManager::gc(em, [this](Entity e) {
             removeComponent(e);
         });
     }
+
+private:
+    void link(Instance instance, StringPool::Id id) noexcept;
+    void unlink(Instance instance) noexcept;
+
+    StringPool mNames;
+
+    // first entity of each name; entities with the same name are linked together
+    tsl::robin_map<StringPool::Id, Entity> mFirstEntity;
 };
 
 } // namespace utils
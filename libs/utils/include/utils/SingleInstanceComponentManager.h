@@ -108,6 +108,12 @@ public:
         return getComponentCount() == 0;
     }
 
+    // Returns a number that changes whenever the Instance of an Entity may have changed, i.e.
+    // when components are added, removed or swapped. This can be used to cache Instances.
+    uint32_t getVersion() const noexcept {
+        return mVersion;
+    }
+
     Entity const* getEntities() const noexcept {
         return data<ENTITY_INDEX>() + 1;
     }
@@ -121,6 +127,19 @@ public:
     // This invalidates all pointers components.
     inline Instance addComponent(Entity e);
 
+    // Makes room for `count` more components, so that adding them doesn't reallocate the
+    // storage or rehash the instance map.
+    // This invalidates all pointers components.
+    void reserve(size_t count) {
+        // the storage grows geometrically, so calling this for small batches is cheap
+        mData.ensureCapacity(mData.size() + count);
+        auto& map = mInstanceMap;
+        size_t const needed = map.size() + count;
+        if (float(needed) > float(map.bucket_count()) * map.max_load_factor()) {
+            map.reserve(needed);
+        }
+    }
+
     // Removes a component from the given entity.
     // This invalidates all pointers components.
     inline Instance removeComponent(Entity e);
@@ -214,6 +233,7 @@ protected:
             Entity& ei = elementAt<ENTITY_INDEX>(i);
             Entity& ej = elementAt<ENTITY_INDEX>(j);
             std::swap(ei, ej);
+            mVersion++;
             if (ei) {
                 map[ei] = i;
             }
@@ -260,6 +280,7 @@ private:
     // maps an entity to an instance index
     tsl::robin_map<Entity, Instance, Entity::Hasher> mInstanceMap;
     default_random_engine mRng;
+    uint32_t mVersion = 0;
 };
 
 // Keep these outside of the class because CLion has trouble parsing them
@@ -274,6 +295,7 @@ SingleInstanceComponentManager<Elements ...>::addComponent(Entity e) {
             // index 0 is used when the component doesn't exist
             ci = Instance(mData.size() - 1);
             mInstanceMap[e] = ci;
+            mVersion++;
         } else {
             // if the entity already has this component, just return its instance
             ci = mInstanceMap[e];
@@ -305,6 +327,7 @@ SingleInstanceComponentManager<Elements ... >::removeComponent(Entity e) {
         }
         mData.pop_back();
         map.erase(pos);
+        mVersion++;
         return last;
     }
     return 0;
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_UTILS_SPSCQUEUE_H
+#define TNT_UTILS_SPSCQUEUE_H
+
+#include <utils/architecture.h>
+
+#include <atomic>
+#include <type_traits>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace utils {
+
+/*
+ * A lock-free, bounded, single-producer / single-consumer queue.
+ *
+ * push() must only be called from the producer thread and pop() from the consumer thread, the
+ * other methods can be called from either. Each side only ever writes its own index, so the
+ * queue never blocks; callers decide how to wait when it's empty or full.
+ */
+template<typename T, size_t CAPACITY>
+class SpscQueue {
+    static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0,
+            "CAPACITY must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+public:
+    SpscQueue() noexcept = default;
+
+    SpscQueue(SpscQueue const& rhs) = delete;
+    SpscQueue& operator=(SpscQueue const& rhs) = delete;
+
+    static constexpr size_t capacity() noexcept { return CAPACITY; }
+
+    // producer only: returns false if the queue is full
+    bool push(T const& item) noexcept {
+        uint32_t const tail = mTail.load(std::memory_order_relaxed);
+        if (tail - mHead.load(std::memory_order_acquire) == CAPACITY) {
+            return false;
+        }
+        mItems[tail & MASK] = item;
+        mTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer only: returns false if the queue is empty
+    bool pop(T& item) noexcept {
+        uint32_t const head = mHead.load(std::memory_order_relaxed);
+        if (head == mTail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = mItems[head & MASK];
+        mHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // these are only a snapshot when called concurrently with push() or pop()
+    size_t size() const noexcept {
+        return mTail.load(std::memory_order_acquire) - mHead.load(std::memory_order_acquire);
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+
+    bool full() const noexcept { return size() == CAPACITY; }
+
+private:
+    static constexpr uint32_t MASK = CAPACITY - 1;
+
+    // the indices are on their own cache line to avoid false sharing between the two threads,
+    // they're free-running and wrap around naturally.
+    alignas(CACHELINE_SIZE) std::atomic<uint32_t> mHead{ 0 };    // written by the consumer
+    alignas(CACHELINE_SIZE) std::atomic<uint32_t> mTail{ 0 };    // written by the producer
+    alignas(CACHELINE_SIZE) T mItems[CAPACITY];
+};
+
+} // namespace utils
+
+#endif // TNT_UTILS_SPSCQUEUE_H
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_UTILS_STRINGPOOL_H
+#define TNT_UTILS_STRINGPOOL_H
+
+#include <utils/compiler.h>
+#include <utils/debug.h>
+
+#include <tsl/robin_map.h>
+
+#include <string_view>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace utils {
+
+/**
+ * A pool of immutable, deduplicated strings.
+ *
+ * Each distinct string is stored once, in large blocks of memory, and is identified by a 32-bit
+ * id. Interning a string that's already in the pool returns its existing id. Strings are never
+ * removed individually, so their ids and pointers stay valid until the pool is cleared or
+ * destroyed.
+ *
+ * StringPool is not thread-safe.
+ */
+class UTILS_PUBLIC StringPool {
+public:
+    using Id = uint32_t;
+
+    // the id of the null string
+    static constexpr Id NULL_ID = 0;
+
+    StringPool() noexcept;
+    ~StringPool() noexcept;
+
+    StringPool(StringPool const&) = delete;
+    StringPool& operator=(StringPool const&) = delete;
+    StringPool(StringPool&& rhs) noexcept;
+    StringPool& operator=(StringPool&& rhs) noexcept;
+
+    // Returns the id of the given string, adding a copy of it to the pool if needed.
+    Id intern(std::string_view string);
+
+    // Returns the id of the given string, adding a copy of it to the pool if needed.
+    // A null string returns NULL_ID.
+    Id intern(const char* string) {
+        return string ? intern(std::string_view{ string }) : NULL_ID;
+    }
+
+    // Returns the id of the given string, or NULL_ID if it's not in the pool.
+    Id find(std::string_view string) const noexcept;
+
+    // Returns the null-terminated string with the given id, or nullptr for NULL_ID.
+    const char* get(Id id) const noexcept {
+        assert_invariant(id <= mStrings.size());
+        return id ? mStrings[id - 1].data() : nullptr;
+    }
+
+    // Returns the length of the string with the given id.
+    size_t length(Id id) const noexcept {
+        assert_invariant(id <= mStrings.size());
+        return id ? mStrings[id - 1].size() : 0;
+    }
+
+    // number of distinct strings in the pool
+    size_t size() const noexcept {
+        return mStrings.size();
+    }
+
+    // Removes all strings. All ids and pointers previously returned become invalid.
+    void clear() noexcept;
+
+private:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    char* allocate(size_t size);
+
+    std::vector<char*> mBlocks;
+    char* mCurrent = nullptr;
+    size_t mAvailable = 0;
+    std::vector<std::string_view> mStrings;     // indexed by id - 1
+    tsl::robin_map<std::string_view, Id> mIds;  // keys point into the blocks
+};
+
+} // namespace utils
+
+#endif // TNT_UTILS_STRINGPOOL_H
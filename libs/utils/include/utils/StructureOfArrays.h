@@ -32,18 +32,44 @@
 #include <array>        // note: this is safe, see how std::array is used below (inline / private)
 #include <cstddef>
 #include <iterator>     // for std::random_access_iterator_tag
+#include <numeric>      // for std::gcd, std::lcm
 #include <tuple>
 #include <utility>
 
 namespace utils {
 
-template <typename Allocator, typename ... Elements>
+/*
+ * Stores a structure of arrays, i.e. each element of the structure is stored in its own array.
+ *
+ * When Alignment is not 0, each array is aligned to (at least) Alignment bytes, and the capacity
+ * is always a multiple of getChunkSize(), which is the smallest number of elements that spans
+ * a multiple of Alignment bytes in every array. This lets vectorized kernels process the arrays
+ * in full-width aligned blocks, without scalar handling of the tail (see forEachChunk()).
+ */
+template <typename Allocator, size_t Alignment, typename ... Elements>
 class StructureOfArraysBase {
     // number of elements
     static constexpr const size_t kArrayCount = sizeof...(Elements);
 
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+
+    // alignment of each array, at least the same alignment guaranteed by malloc
+    template<typename T>
+    static constexpr size_t kAlignmentOf = std::max({ Alignment, alignof(std::max_align_t), alignof(T) });
+
+    static constexpr size_t computeChunkSize() noexcept {
+        size_t chunkSize = 1;
+        if constexpr (Alignment > 0) {
+            // number of elements of each array that spans a multiple of Alignment bytes
+            ((chunkSize = std::lcm(chunkSize, Alignment / std::gcd(Alignment, sizeof(Elements)))), ...);
+        }
+        return chunkSize;
+    }
+
+    static constexpr size_t kChunkSize = computeChunkSize();
+
 public:
-    using SoA = StructureOfArraysBase<Allocator, Elements...>;
+    using SoA = StructureOfArraysBase<Allocator, Alignment, Elements...>;
 
     using Structure = std::tuple<Elements...>;
 
@@ -54,6 +80,9 @@ public:
     // Number of arrays
     static constexpr size_t getArrayCount() noexcept { return kArrayCount; }
 
+    // Number of elements the capacity is always a multiple of, 1 when Alignment is 0
+    static constexpr size_t getChunkSize() noexcept { return kChunkSize; }
+
     // Size needed to store "size" array elements
     static size_t getNeededSize(size_t size) noexcept {
         return getOffset(kArrayCount - 1, size) + sizeof(TypeAt<kArrayCount - 1>) * size;
@@ -268,14 +297,16 @@ public:
     }
 
     // set the capacity of the array. the capacity cannot be smaller than the current size,
-    // the call is a no-op in that case.
+    // the call is a no-op in that case. The capacity is rounded up to a multiple of
+    // getChunkSize().
     UTILS_NOINLINE
     void setCapacity(size_t capacity) {
+        capacity = ((capacity + kChunkSize - 1) / kChunkSize) * kChunkSize;
         // allocate enough space for "capacity" elements of each array
         // capacity cannot change when optional storage is specified
         if (capacity >= mSize) {
             // TODO: not entirely sure if "max" of all alignments is always correct
-            constexpr size_t align = std::max({ std::max(alignof(std::max_align_t), alignof(Elements))... });
+            constexpr size_t align = std::max({ kAlignmentOf<Elements>... });
             const size_t sizeNeeded = getNeededSize(capacity);
             void* buffer = mAllocator.alloc(sizeNeeded, align);
             auto const oldBuffer = std::get<0>(mArrays);
@@ -406,6 +437,19 @@ public:
         return *this;
     }
 
+    // Calls f(first, count) for consecutive chunks of getChunkSize() elements covering
+    // [0, size()), count is smaller than getChunkSize() only for the last chunk.
+    // When Alignment is not 0, each chunk starts on an Alignment boundary in every array, and
+    // all getChunkSize() elements of the last chunk can be accessed because they're within the
+    // capacity -- the content of the elements past size() is unspecified (and uninitialized
+    // for trivial types).
+    template<typename F>
+    void forEachChunk(F&& f) const {
+        for (size_t i = 0; i < mSize; i += kChunkSize) {
+            f(i, std::min(kChunkSize, mSize - i));
+        }
+    }
+
     template<typename F, typename ... ARGS>
     void forEach(F&& f, ARGS&& ... args) {
         for_each(mArrays, [&](size_t, auto* p) {
@@ -580,7 +624,7 @@ private:
         const size_t sizes[] = { (sizeof(Elements) * capacity)... };
 
         // we align each array to at least the same alignment guaranteed by malloc
-        constexpr size_t const alignments[] = { std::max(alignof(std::max_align_t), alignof(Elements))... };
+        constexpr size_t const alignments[] = { kAlignmentOf<Elements>... };
 
         // hopefully most of this gets unrolled and inlined
         std::array<size_t, kArrayCount> offsets;
@@ -667,38 +711,38 @@ private:
 };
 
 
-template<typename Allocator, typename... Elements>
+template<typename Allocator, size_t Alignment, typename... Elements>
 inline
-typename StructureOfArraysBase<Allocator, Elements...>::IteratorValueRef&
-StructureOfArraysBase<Allocator, Elements...>::IteratorValueRef::operator=(
+typename StructureOfArraysBase<Allocator, Alignment, Elements...>::IteratorValueRef&
+StructureOfArraysBase<Allocator, Alignment, Elements...>::IteratorValueRef::operator=(
         IteratorValueRef const& rhs) {
     return operator=(IteratorValue(rhs));
 }
 
-template<typename Allocator, typename... Elements>
+template<typename Allocator, size_t Alignment, typename... Elements>
 inline
-typename StructureOfArraysBase<Allocator, Elements...>::IteratorValueRef&
-StructureOfArraysBase<Allocator, Elements...>::IteratorValueRef::operator=(
+typename StructureOfArraysBase<Allocator, Alignment, Elements...>::IteratorValueRef&
+StructureOfArraysBase<Allocator, Alignment, Elements...>::IteratorValueRef::operator=(
         IteratorValueRef&& rhs) noexcept {
     return operator=(IteratorValue(rhs));
 }
 
-template<typename Allocator, typename... Elements>
+template<typename Allocator, size_t Alignment, typename... Elements>
 template<size_t... Is>
 inline
-typename StructureOfArraysBase<Allocator, Elements...>::IteratorValueRef&
-StructureOfArraysBase<Allocator, Elements...>::IteratorValueRef::assign(
+typename StructureOfArraysBase<Allocator, Alignment, Elements...>::IteratorValueRef&
+StructureOfArraysBase<Allocator, Alignment, Elements...>::IteratorValueRef::assign(
         IteratorValue const& rhs, std::index_sequence<Is...>) {
     // implements IteratorValueRef& IteratorValueRef::operator=(IteratorValue const& rhs)
     auto UTILS_UNUSED l = { (soa->elementAt<Is>(index) = std::get<Is>(rhs.elements), 0)... };
     return *this;
 }
 
-template<typename Allocator, typename... Elements>
+template<typename Allocator, size_t Alignment, typename... Elements>
 template<size_t... Is>
 inline
-typename StructureOfArraysBase<Allocator, Elements...>::IteratorValueRef&
-StructureOfArraysBase<Allocator, Elements...>::IteratorValueRef::assign(
+typename StructureOfArraysBase<Allocator, Alignment, Elements...>::IteratorValueRef&
+StructureOfArraysBase<Allocator, Alignment, Elements...>::IteratorValueRef::assign(
         IteratorValue&& rhs, std::index_sequence<Is...>) noexcept {
     // implements IteratorValueRef& IteratorValueRef::operator=(IteratorValue&& rhs) noexcept
     auto UTILS_UNUSED l = {
@@ -707,7 +751,12 @@ StructureOfArraysBase<Allocator, Elements...>::IteratorValueRef::assign(
 }
 
 template <typename ... Elements>
-using StructureOfArrays = StructureOfArraysBase<HeapArena<>, Elements ...>;
+using StructureOfArrays = StructureOfArraysBase<HeapArena<>, 0, Elements ...>;
+
+// A StructureOfArrays whose arrays are aligned to Alignment bytes, and padded to a multiple
+// of getChunkSize() elements, suitable for SIMD loops.
+template <size_t Alignment, typename ... Elements>
+using AlignedStructureOfArrays = StructureOfArraysBase<HeapArena<>, Alignment, Elements ...>;
 
 } // namespace utils
 
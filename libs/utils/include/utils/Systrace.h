@@ -37,10 +37,18 @@
 #define FILAMENT_APPLE_SYSTRACE 0
 #endif
 
+// Systrace on Linux writes a JSON trace file (see utils/linux/Systrace.h), it should only be
+// enabled in dev builds.
+#ifndef FILAMENT_LINUX_SYSTRACE
+#define FILAMENT_LINUX_SYSTRACE 0
+#endif
+
 #if defined(__ANDROID__)
 #include <utils/android/Systrace.h>
 #elif defined(__APPLE__) && FILAMENT_APPLE_SYSTRACE
 #include <utils/darwin/Systrace.h>
+#elif defined(__linux__) && FILAMENT_LINUX_SYSTRACE
+#include <utils/linux/Systrace.h>
 #else
 
 #define SYSTRACE_ENABLE()
@@ -55,6 +63,8 @@
 #define SYSTRACE_ASYNC_END(name, cookie)
 #define SYSTRACE_VALUE32(name, val)
 #define SYSTRACE_VALUE64(name, val)
+#define SYSTRACE_FLOW_BEGIN(name, id)
+#define SYSTRACE_FLOW_END(name, id)
 
 #endif // ANDROID
 
@@ -90,6 +90,10 @@
 #define SYSTRACE_VALUE64(name, val) \
         ___trctx.value(SYSTRACE_TAG, name, int64_t(val))
 
+// flow events are not supported by ATrace
+#define SYSTRACE_FLOW_BEGIN(name, id)
+#define SYSTRACE_FLOW_END(name, id)
+
 // ------------------------------------------------------------------------------------------------
 // No user serviceable code below...
 // ------------------------------------------------------------------------------------------------
@@ -49,6 +49,11 @@ public:
 
     ThermalStatus getCurrentThermalStatus() const noexcept;
 
+    // Returns the forecasted thermal headroom in forecastSeconds, where 1.0 means that the device
+    // reaches the SEVERE status, or NaN if it's not available. This must not be called more than
+    // once per second.
+    float getThermalHeadroom(int forecastSeconds) const noexcept;
+
 private:
     AThermalManager* mThermalManager = nullptr;
 };
@@ -134,6 +134,14 @@
 #   define UTILS_HAS_THREADING 1
 #endif
 
+// Whether filament's backend runs on its own thread. Multi-threaded WASM builds only use threads
+// for the JobSystem, the backend stays on the browser's main thread which owns the WebGL context.
+#if UTILS_HAS_THREADING && !defined(__EMSCRIPTEN__)
+#   define UTILS_HAS_DRIVER_THREAD 1
+#else
+#   define UTILS_HAS_DRIVER_THREAD 0
+#endif
+
 #if __has_attribute(noinline)
 #define UTILS_NOINLINE __attribute__((noinline))
 #else
@@ -93,6 +93,10 @@ extern thread_local std::stack<const char*> ___tracerSections;
 #define SYSTRACE_VALUE64(name, val) \
         ___tracer.value(SYSTRACE_TAG, name, int64_t(val))
 
+// flow events are not supported by signposts
+#define SYSTRACE_FLOW_BEGIN(name, id)
+#define SYSTRACE_FLOW_END(name, id)
+
 // ------------------------------------------------------------------------------------------------
 // No user serviceable code below...
 // ------------------------------------------------------------------------------------------------
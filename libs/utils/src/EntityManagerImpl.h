@@ -31,6 +31,8 @@
 #include <tsl/robin_map.h>
 #endif
 
+#include <algorithm>
+#include <atomic>
 #include <deque>
 #include <mutex> // for std::lock_guard
 #include <vector>
@@ -51,8 +53,10 @@ public:
     UTILS_NOINLINE
     size_t getEntityCount() const noexcept {
         std::lock_guard<Mutex> const lock(mFreeListLock);
-        if (mCurrentIndex < RAW_INDEX_COUNT) {
-            return (mCurrentIndex - 1) - mFreeList.size();
+        // mCurrentIndex can overshoot RAW_INDEX_COUNT, see create()
+        uint32_t const currentIndex = mCurrentIndex.load(std::memory_order_relaxed);
+        if (currentIndex < RAW_INDEX_COUNT) {
+            return (currentIndex - 1) - mFreeList.size();
         } else {
             return getMaxEntityCount() - mFreeList.size();
         }
@@ -60,15 +64,48 @@ public:
 
     UTILS_NOINLINE
     void create(size_t n, Entity* entities) {
+        uint8_t* const gens = mGens;
+        size_t i = 0;
+
+        // Fast path: as long as there are not enough freed indices to recycle, fresh indices
+        // are reserved as a single block without taking the lock, so that several threads
+        // can build their part of a scene concurrently. Fresh indices always have a
+        // generation of 0, so no synchronization is needed with destroy().
+        if (mFreeListSize.load(std::memory_order_relaxed) < MIN_FREE_INDICES &&
+                mCurrentIndex.load(std::memory_order_relaxed) < RAW_INDEX_COUNT) {
+            Entity::Type const first = mCurrentIndex.fetch_add(n, std::memory_order_relaxed);
+            // the part of the block past RAW_INDEX_COUNT is served from the free-list below
+            size_t const count = first < RAW_INDEX_COUNT ?
+                    std::min(n, size_t(RAW_INDEX_COUNT - first)) : 0;
+            for (; i < count; i++) {
+                Entity::Type const index = first + i;
+                entities[i] = Entity{ makeIdentity(gens[index], index) };
+            }
+#if FILAMENT_UTILS_TRACK_ENTITIES
+            std::lock_guard<Mutex> const lock(mFreeListLock);
+            for (size_t j = 0; j < count; j++) {
+                mDebugActiveEntities.emplace(entities[j], CallStack::unwind(5));
+            }
+#endif
+            if (UTILS_LIKELY(i == n)) {
+                return;
+            }
+        }
+
         Entity::Type index{};
         auto& freeList = mFreeList;
-        uint8_t* const gens = mGens;
 
         // this must be thread-safe, acquire the free-list mutex
         std::lock_guard<Mutex> const lock(mFreeListLock);
-        Entity::Type currentIndex = mCurrentIndex;
-        for (size_t i = 0; i < n; i++) {
-            if (UTILS_UNLIKELY(currentIndex >= RAW_INDEX_COUNT || freeList.size() >= MIN_FREE_INDICES)) {
+        for (; i < n; i++) {
+            // the fast path of other threads can still bump mCurrentIndex concurrently
+            bool recycle = freeList.size() >= MIN_FREE_INDICES ||
+                    mCurrentIndex.load(std::memory_order_relaxed) >= RAW_INDEX_COUNT;
+            if (!recycle) {
+                index = mCurrentIndex.fetch_add(1, std::memory_order_relaxed);
+                recycle = index >= RAW_INDEX_COUNT;
+            }
+            if (UTILS_UNLIKELY(recycle)) {
 
                 // this could only happen if we had gone through all the indices at least once
                 if (UTILS_UNLIKELY(freeList.empty())) {
@@ -79,15 +116,13 @@ public:
 
                 index = freeList.front();
                 freeList.pop_front();
-            } else {
-                index = currentIndex++;
             }
             entities[i] = Entity{ makeIdentity(gens[index], index) };
 #if FILAMENT_UTILS_TRACK_ENTITIES
             mDebugActiveEntities.emplace(entities[i], CallStack::unwind(5));
 #endif
         }
-        mCurrentIndex = currentIndex;
+        mFreeListSize.store(freeList.size(), std::memory_order_relaxed);
     }
 
     UTILS_NOINLINE
@@ -123,9 +158,14 @@ public:
 #endif
             }
         }
+        mFreeListSize.store(freeList.size(), std::memory_order_relaxed);
         lock.unlock();
 
-        // notify our listeners that some entities are being destroyed
+        // notify our listeners that some entities are being destroyed, most of the time there
+        // are none and we don't need to take the listener lock.
+        if (mListenerCount.load(std::memory_order_acquire) == 0) {
+            return;
+        }
         auto listeners = getListeners();
         for (auto const& l : listeners) {
             l->onEntitiesDestroyed(n, entities);
@@ -135,11 +175,13 @@ public:
     void registerListener(Listener* l) noexcept {
         std::lock_guard<Mutex> const lock(mListenerLock);
         mListeners.insert(l);
+        mListenerCount.store(mListeners.size(), std::memory_order_release);
     }
 
     void unregisterListener(Listener* l) noexcept {
         std::lock_guard<Mutex> const lock(mListenerLock);
         mListeners.erase(l);
+        mListenerCount.store(mListeners.size(), std::memory_order_release);
     }
 
 #if FILAMENT_UTILS_TRACK_ENTITIES
@@ -171,7 +213,11 @@ private:
         return result; // the c++ standard guarantees a move
     }
 
-    uint32_t mCurrentIndex = 1;
+    // next fresh index, it can go past RAW_INDEX_COUNT when concurrent create() race
+    std::atomic<uint32_t> mCurrentIndex{ 1 };
+
+    // size of mFreeList, readable without the lock
+    std::atomic<size_t> mFreeListSize{ 0 };
 
     // stores indices that got freed
     mutable Mutex mFreeListLock;
@@ -179,6 +225,7 @@ private:
 
     mutable Mutex mListenerLock;
     tsl::robin_set<Listener*> mListeners;
+    std::atomic<size_t> mListenerCount{ 0 };
 
 #if FILAMENT_UTILS_TRACK_ENTITIES
     tsl::robin_map<Entity, CallStack, Entity::Hasher> mDebugActiveEntities;
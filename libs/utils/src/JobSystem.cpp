@@ -47,6 +47,7 @@
 #include <math.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 
 
 #if defined(WIN32)
@@ -92,6 +93,85 @@
 
 namespace utils {
 
+namespace {
+
+struct CpuTopology {
+    uint32_t performanceCoreCount = 0;
+    uint64_t performanceCores = 0;      // mask, only used when heterogeneous
+    bool heterogeneous = false;
+};
+
+CpuTopology const& getCpuTopology() noexcept {
+    static CpuTopology const topology = [] {
+        CpuTopology topology;
+        uint32_t const coreCount = std::max(1u, std::thread::hardware_concurrency());
+        topology.performanceCoreCount = coreCount;
+#if defined(__linux__)
+        // The kernel exposes the relative capacity of each core (in [0, 1024]), which is
+        // missing or identical for all cores on homogeneous CPUs.
+        constexpr uint32_t MAX_CORE_COUNT = 64;
+        if (coreCount > MAX_CORE_COUNT) {
+            return topology;
+        }
+        uint32_t capacities[MAX_CORE_COUNT];
+        uint32_t maxCapacity = 0;
+        for (uint32_t i = 0; i < coreCount; i++) {
+            char path[64];
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cpu_capacity", i);
+            FILE* const file = fopen(path, "r");
+            if (!file) {
+                return topology;
+            }
+            int const n = fscanf(file, "%u", &capacities[i]);
+            fclose(file);
+            if (n != 1) {
+                return topology;
+            }
+            maxCapacity = std::max(maxCapacity, capacities[i]);
+        }
+        uint32_t performanceCoreCount = 0;
+        uint64_t performanceCores = 0;
+        for (uint32_t i = 0; i < coreCount; i++) {
+            if (capacities[i] * 2 >= maxCapacity) {
+                performanceCores |= uint64_t(1) << i;
+                performanceCoreCount++;
+            }
+        }
+        if (performanceCoreCount < coreCount) {
+            topology.performanceCoreCount = performanceCoreCount;
+            topology.performanceCores = performanceCores;
+            topology.heterogeneous = true;
+        }
+#endif
+        return topology;
+    }();
+    return topology;
+}
+
+// measures the time between its construction and destruction, when enabled
+class IdleTimer {
+public:
+    IdleTimer(std::atomic<uint64_t>& idleTime, bool const enabled) noexcept
+            : mIdleTime(enabled ? &idleTime : nullptr) {
+        if (UTILS_UNLIKELY(mIdleTime)) {
+            mStart = std::chrono::steady_clock::now();
+        }
+    }
+    ~IdleTimer() noexcept {
+        if (UTILS_UNLIKELY(mIdleTime)) {
+            auto const d = std::chrono::steady_clock::now() - mStart;
+            mIdleTime->fetch_add(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(d).count(),
+                    std::memory_order_relaxed);
+        }
+    }
+private:
+    std::atomic<uint64_t>* mIdleTime;
+    std::chrono::steady_clock::time_point mStart;
+};
+
+} // anonymous namespace
+
 void JobSystem::setThreadName(const char* name) noexcept {
 #if defined(__linux__)
     pthread_setname_np(pthread_self(), name);
@@ -170,6 +250,27 @@ void JobSystem::setThreadAffinityById(size_t id) noexcept {
 #endif
 }
 
+size_t JobSystem::getPerformanceCoreCount() noexcept {
+    return getCpuTopology().performanceCoreCount;
+}
+
+void JobSystem::setThreadAffinityToPerformanceCores() noexcept {
+#if defined(__linux__)
+    CpuTopology const& topology = getCpuTopology();
+    if (!topology.heterogeneous) {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (size_t i = 0; i < 64; i++) {
+        if (topology.performanceCores & (uint64_t(1) << i)) {
+            CPU_SET(i, &set);
+        }
+    }
+    sched_setaffinity(gettid(), sizeof(set), &set);
+#endif
+}
+
 JobSystem::JobSystem(const size_t userThreadCount, const size_t adoptableThreadsCount) noexcept
     : mJobPool("JobSystem Job pool", MAX_JOB_COUNT * sizeof(Job)),
       mJobStorageBase(static_cast<Job *>(mJobPool.getAllocator().getCurrent()))
@@ -179,7 +280,8 @@ JobSystem::JobSystem(const size_t userThreadCount, const size_t adoptableThreads
     unsigned int threadPoolCount = userThreadCount;
     if (threadPoolCount == 0) {
         // default value, system dependant
-        unsigned int hwThreads = std::thread::hardware_concurrency();
+        // efficiency cores are not counted, see getPerformanceCoreCount()
+        unsigned int hwThreads = unsigned(getPerformanceCoreCount());
         if (UTILS_HAS_HYPER_THREADING) {
             // For now we avoid using HT, this simplifies profiling.
             // TODO: figure-out what to do with Hyper-threading
@@ -195,7 +297,14 @@ JobSystem::JobSystem(const size_t userThreadCount, const size_t adoptableThreads
     threadPoolCount = std::min(UTILS_HAS_THREADING ? 32u : 0u, threadPoolCount);
 
     mThreadStates = aligned_vector<ThreadState>(threadPoolCount + adoptableThreadsCount);
+    mContinuations.resize(MAX_JOB_COUNT, 0);
     mThreadCount = uint16_t(threadPoolCount);
+
+    // On heterogeneous CPUs, keep the worker threads on the performance cores if they fit,
+    // so that frame-critical jobs (e.g. parallel_for chunks) don't end up on efficiency cores
+    // and become the stragglers everybody waits on. The cores are available to the whole pool
+    // (rather than one core per thread), which leaves the balancing to the OS.
+    mUsePerformanceCores = threadPoolCount + 1 <= getPerformanceCoreCount();
     mParallelSplitCount = (uint8_t)std::ceil((std::log2f(threadPoolCount + adoptableThreadsCount)));
 
     static_assert(std::atomic<bool>::is_always_lock_free);
@@ -266,7 +375,11 @@ inline bool JobSystem::exitRequested() const noexcept {
 }
 
 inline bool JobSystem::hasActiveJobs() const noexcept {
-    return mActiveJobs.load(std::memory_order_relaxed) > 0;
+    return hasActiveJobs(JobPriority::NORMAL) || hasActiveJobs(JobPriority::BACKGROUND);
+}
+
+inline bool JobSystem::hasActiveJobs(JobPriority const priority) const noexcept {
+    return mActiveJobs[size_t(priority)].load(std::memory_order_relaxed) > 0;
 }
 
 inline bool JobSystem::hasJobCompleted(Job const* job) noexcept {
@@ -335,17 +448,18 @@ JobSystem::Job* JobSystem::allocateJob() noexcept {
     return mJobPool.make<Job>();
 }
 
-void JobSystem::put(WorkQueue& workQueue, Job* job) noexcept {
+void JobSystem::put(ThreadState& state, Job* job) noexcept {
     assert(job);
     size_t const index = job - mJobStorageBase;
     assert(index >= 0 && index < MAX_JOB_COUNT);
 
-    // put the job into the queue
-    workQueue.push(uint16_t(index + 1));
+    // put the job into the queue of its priority
+    size_t const priority = job->priority;
+    state.workQueues[priority].push(uint16_t(index + 1));
 
     // increase our active job count (the order in which we're doing this must not matter
     // because we're not using std::memory_order_seq_cst (here or in WorkQueue::push()).
-    mActiveJobs.fetch_add(1, std::memory_order_relaxed);
+    mActiveJobs[priority].fetch_add(1, std::memory_order_relaxed);
 
     // Note: it's absolutely possible for mActiveJobs to be 0 here, because the job could have
     // been handled by a zealous worker already. In that case we could avoid calling wakeOne(),
@@ -354,22 +468,22 @@ void JobSystem::put(WorkQueue& workQueue, Job* job) noexcept {
     wakeOne();
 }
 
-JobSystem::Job* JobSystem::pop(WorkQueue& workQueue) noexcept {
+JobSystem::Job* JobSystem::pop(WorkQueue& workQueue, JobPriority const priority) noexcept {
     size_t const index = workQueue.pop();
     assert(index <= MAX_JOB_COUNT);
     Job* const job = !index ? nullptr : &mJobStorageBase[index - 1];
     if (UTILS_LIKELY(job)) {
-        mActiveJobs.fetch_sub(1, std::memory_order_relaxed);
+        mActiveJobs[size_t(priority)].fetch_sub(1, std::memory_order_relaxed);
     }
     return job;
 }
 
-JobSystem::Job* JobSystem::steal(WorkQueue& workQueue) noexcept {
+JobSystem::Job* JobSystem::steal(WorkQueue& workQueue, JobPriority const priority) noexcept {
     size_t const index = workQueue.steal();
     assert_invariant(index <= MAX_JOB_COUNT);
     Job* const job = !index ? nullptr : &mJobStorageBase[index - 1];
     if (UTILS_LIKELY(job)) {
-        mActiveJobs.fetch_sub(1, std::memory_order_relaxed);
+        mActiveJobs[size_t(priority)].fetch_sub(1, std::memory_order_relaxed);
     }
     return job;
 }
@@ -396,50 +510,96 @@ inline JobSystem::ThreadState* JobSystem::getStateToStealFrom(ThreadState& state
     return stateToStealFrom;
 }
 
-JobSystem::Job* JobSystem::steal(ThreadState& state) noexcept {
+JobSystem::Job* JobSystem::steal(ThreadState& state, JobPriority const priority) noexcept {
     HEAVY_SYSTRACE_CALL();
     Job* job = nullptr;
     do {
         ThreadState* const stateToStealFrom = getStateToStealFrom(state);
         if (stateToStealFrom) {
-            job = steal(stateToStealFrom->workQueue);
+            job = steal(stateToStealFrom->workQueues[size_t(priority)], priority);
+            if (UTILS_UNLIKELY(isInstrumentationEnabled())) {
+                (job ? state.stealCount : state.failedStealCount)
+                        .fetch_add(1, std::memory_order_relaxed);
+            }
         }
-        // nullptr -> nothing to steal in that queue either, if there are active jobs,
-        // continue to try stealing one.
-    } while (!job && hasActiveJobs());
+        // nullptr -> nothing to steal in that queue either, if there are active jobs of that
+        // priority, continue to try stealing one.
+    } while (!job && hasActiveJobs(priority));
     return job;
 }
 
 bool JobSystem::execute(ThreadState& state) noexcept {
     HEAVY_SYSTRACE_CALL();
 
-    Job* job = pop(state.workQueue);
-
-    // It is beneficial for some benchmarks to poll on steal() for a bit, because going back to
-    // sleep and waking up is pretty expensive. However, it is unclear it helps in practice with
-    // larger jobs or when parallel_for is used.
-    constexpr size_t const STEAL_TRY_COUNT = 1;
-    for (size_t i = 0; UTILS_UNLIKELY(!job && i < STEAL_TRY_COUNT); i++) {
-        // our queue is empty, try to steal a job
-        job = steal(state);
+    // Normal jobs, ours or stolen, always go first. Background jobs only run when there are
+    // none left, which means they yield to frame work at job boundaries.
+    Job* job = nullptr;
+    for (size_t p = 0; !job && p < JOB_PRIORITY_COUNT; p++) {
+        JobPriority const priority = JobPriority(p);
+        job = pop(state.workQueues[p], priority);
+
+        // It is beneficial for some benchmarks to poll on steal() for a bit, because going back
+        // to sleep and waking up is pretty expensive. However, it is unclear it helps in
+        // practice with larger jobs or when parallel_for is used.
+        constexpr size_t const STEAL_TRY_COUNT = 1;
+        for (size_t i = 0; UTILS_UNLIKELY(!job && i < STEAL_TRY_COUNT); i++) {
+            // our queue is empty, try to steal a job
+            job = steal(state, priority);
+        }
     }
 
     if (UTILS_LIKELY(job)) {
         assert((job->runningJobCount.load(std::memory_order_relaxed) & JOB_COUNT_MASK) >= 1);
-        if (UTILS_LIKELY(job->function)) {
+        if (UTILS_UNLIKELY(isInstrumentationEnabled())) {
+            executeInstrumented(state, job);
+        } else if (UTILS_LIKELY(job->function)) {
             HEAVY_SYSTRACE_NAME("job->function");
             job->id = std::distance(mThreadStates.data(), &state);
             job->function(job->storage, *this, job);
             job->id = invalidThreadId;
         }
-        finish(job);
+        finish(state, job);
     }
     return job != nullptr;
 }
 
+UTILS_NOINLINE
+void JobSystem::executeInstrumented(ThreadState& state, Job* job) noexcept {
+    state.jobCount.fetch_add(1, std::memory_order_relaxed);
+    if (UTILS_UNLIKELY(!job->function)) {
+        return;
+    }
+
+    const char* const label = mLabels[job - mJobStorageBase];
+    auto const start = std::chrono::steady_clock::now();
+    job->id = std::distance(mThreadStates.data(), &state);
+    if (label) {
+        SYSTRACE_NAME(label);
+        job->function(job->storage, *this, job);
+    } else {
+        job->function(job->storage, *this, job);
+    }
+    job->id = invalidThreadId;
+
+    if (label) {
+        // note: this includes the time spent running other jobs while waiting on children
+        auto const duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start);
+        std::lock_guard<Mutex> const lock(state.labelLock);
+        LabelStatistics& stats = state.labels[label];
+        stats.label = label;
+        stats.jobCount++;
+        stats.totalTime += duration;
+        stats.maxTime = std::max(stats.maxTime, duration);
+    }
+}
+
 void JobSystem::loop(ThreadState* state) noexcept {
     setThreadName("JobSystem::loop");
     setThreadPriority(Priority::DISPLAY);
+    if (mUsePerformanceCores) {
+        setThreadAffinityToPerformanceCores();
+    }
 
     // record our work queue
     std::unique_lock<Mutex> lock(mThreadMapLock);
@@ -451,6 +611,7 @@ void JobSystem::loop(ThreadState* state) noexcept {
     // run our main loop...
     do {
         if (!execute(*state)) {
+            IdleTimer const idle(state->idleTime, isInstrumentationEnabled());
             std::unique_lock<Mutex> lock(mWaiterLock);
             while (!exitRequested() && !hasActiveJobs()) {
                 wait(lock);
@@ -460,7 +621,7 @@ void JobSystem::loop(ThreadState* state) noexcept {
 }
 
 UTILS_NOINLINE
-void JobSystem::finish(Job* job) noexcept {
+void JobSystem::finish(ThreadState& state, Job* job) noexcept {
     HEAVY_SYSTRACE_CALL();
 
     bool notify = false;
@@ -480,6 +641,14 @@ void JobSystem::finish(Job* job) noexcept {
             if (waiters) {
                 notify = true;
             }
+            // the job is done, its continuation can start (the job's parent, if any, is still
+            // alive at this point)
+            uint16_t& continuation = mContinuations[job - storage];
+            if (UTILS_UNLIKELY(continuation)) {
+                Job* const next = &storage[continuation - 1];
+                continuation = 0;
+                put(state, next);
+            }
             Job* const parent = job->parent == 0x7FFF ? nullptr : &storage[job->parent];
             decRef(job);
             job = parent;
@@ -520,15 +689,102 @@ JobSystem::Job* JobSystem::create(Job* parent, JobFunc func) noexcept {
         }
         job->function = func;
         job->parent = uint16_t(index);
+        // children inherit the priority of their parent
+        job->priority = parent ? parent->priority : uint16_t(JobPriority::NORMAL);
+        if (UTILS_UNLIKELY(isInstrumentationEnabled())) {
+            // children inherit the label of their parent as well
+            mLabels[job - mJobStorageBase] = parent ? mLabels[index] : nullptr;
+        }
     }
     return job;
 }
 
 void JobSystem::cancel(Job*& job) noexcept {
-    finish(job);
+    finish(getState(), job);
     job = nullptr;
 }
 
+void JobSystem::requestCancel(Job* job) noexcept {
+    // memory_order_relaxed is fine, the job's side effects are already synchronized by wait()
+    job->runningJobCount.fetch_or(JOB_CANCELLED_BIT, std::memory_order_relaxed);
+}
+
+bool JobSystem::isCancelled(Job const* job) noexcept {
+    return job->runningJobCount.load(std::memory_order_relaxed) & JOB_CANCELLED_BIT;
+}
+
+void JobSystem::runAfter(Job* job, Job*& continuation) noexcept {
+    assert_invariant(job && continuation);
+    uint16_t& next = mContinuations[job - mJobStorageBase];
+    assert_invariant(!next);
+    next = uint16_t(continuation - mJobStorageBase + 1);
+    continuation = nullptr;
+}
+
+void JobSystem::setPriority(Job* job, JobPriority const priority) noexcept {
+    job->priority = uint16_t(priority);
+}
+
+JobSystem::JobPriority JobSystem::getPriority(Job const* job) noexcept {
+    return JobPriority(job->priority);
+}
+
+void JobSystem::setInstrumentationEnabled(bool const enabled) noexcept {
+    if (enabled) {
+        // jobs created while disabled don't have a label
+        mLabels.assign(MAX_JOB_COUNT, nullptr);
+    }
+    mInstrumentationEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+void JobSystem::setLabel(Job* job, const char* label) noexcept {
+    if (isInstrumentationEnabled()) {
+        mLabels[job - mJobStorageBase] = label;
+    }
+}
+
+JobSystem::Statistics JobSystem::getStatistics() const noexcept {
+    Statistics statistics;
+    statistics.threads.reserve(mThreadStates.size());
+    tsl::robin_map<const char*, LabelStatistics> labels;
+    for (auto const& state : mThreadStates) {
+        statistics.threads.push_back({
+                state.jobCount.load(std::memory_order_relaxed),
+                state.stealCount.load(std::memory_order_relaxed),
+                state.failedStealCount.load(std::memory_order_relaxed),
+                std::chrono::nanoseconds(state.idleTime.load(std::memory_order_relaxed)) });
+
+        std::lock_guard<Mutex> const lock(state.labelLock);
+        for (auto const& [label, stats] : state.labels) {
+            LabelStatistics& total = labels[label];
+            total.label = label;
+            total.jobCount += stats.jobCount;
+            total.totalTime += stats.totalTime;
+            total.maxTime = std::max(total.maxTime, stats.maxTime);
+        }
+    }
+    statistics.labels.reserve(labels.size());
+    for (auto const& [label, stats] : labels) {
+        statistics.labels.push_back(stats);
+    }
+    std::sort(statistics.labels.begin(), statistics.labels.end(),
+            [](LabelStatistics const& lhs, LabelStatistics const& rhs) {
+                return lhs.totalTime > rhs.totalTime;
+            });
+    return statistics;
+}
+
+void JobSystem::resetStatistics() noexcept {
+    for (auto& state : mThreadStates) {
+        state.jobCount.store(0, std::memory_order_relaxed);
+        state.stealCount.store(0, std::memory_order_relaxed);
+        state.failedStealCount.store(0, std::memory_order_relaxed);
+        state.idleTime.store(0, std::memory_order_relaxed);
+        std::lock_guard<Mutex> const lock(state.labelLock);
+        state.labels.clear();
+    }
+}
+
 JobSystem::Job* JobSystem::retain(Job* job) noexcept {
     Job* retained = job;
     incRef(retained);
@@ -545,7 +801,7 @@ void JobSystem::run(Job*& job) noexcept {
 
     ThreadState& state(getState());
 
-    put(state.workQueue, job);
+    put(state, job);
 
     // after run() returns, the job is virtually invalid (it'll die on its own)
     job = nullptr;
@@ -557,7 +813,7 @@ void JobSystem::run(Job*& job, uint8_t id) noexcept {
     ThreadState& state = mThreadStates[id];
     assert_invariant(&state == &getState());
 
-    put(state.workQueue, job);
+    put(state, job);
 
     // after run() returns, the job is virtually invalid (it'll die on its own)
     job = nullptr;
@@ -592,6 +848,7 @@ void JobSystem::waitAndRelease(Job*& job) noexcept {
             // this could take time however, so we will wait with a condition, and
             // continue to handle more jobs, as they get added.
 
+            IdleTimer const idle(state.idleTime, isInstrumentationEnabled());
             std::unique_lock<Mutex> lock(mWaiterLock);
             uint32_t const runningJobCount = wait(lock, job);
             // we could be waking up because either:
@@ -671,7 +928,9 @@ void JobSystem::emancipate() {
 io::ostream& operator<<(io::ostream& out, JobSystem const& js) {
     for (auto const& item : js.mThreadStates) {
         size_t const id = std::distance(js.mThreadStates.data(), &item);
-        out << id << ": " << item.workQueue.getCount() << io::endl;
+        out << id << ": " << item.workQueues[size_t(JobSystem::JobPriority::NORMAL)].getCount()
+            << " (background: " << item.workQueues[size_t(JobSystem::JobPriority::BACKGROUND)].getCount()
+            << ")" << io::endl;
     }
     return out;
 }
@@ -20,6 +20,8 @@
 namespace utils {
 
 static constexpr size_t NAME = 0;
+static constexpr size_t PREVIOUS = 1;
+static constexpr size_t NEXT = 2;
 
 NameComponentManager::NameComponentManager(EntityManager&) {
 }
@@ -28,12 +30,27 @@ NameComponentManager::~NameComponentManager() = default;
 
 void NameComponentManager::setName(Instance instance, const char* name) noexcept {
     if (instance) {
-        elementAt<NAME>(instance) = CString{ name };
+        unlink(instance);
+        link(instance, mNames.intern(name));
     }
 }
 
 const char* NameComponentManager::getName(Instance instance) const noexcept {
-    return elementAt<NAME>(instance).c_str();
+    return mNames.get(elementAt<NAME>(instance));
+}
+
+Entity NameComponentManager::getEntity(const char* name) const noexcept {
+    if (name) {
+        StringPool::Id const id = mNames.find(name);
+        if (auto pos = mFirstEntity.find(id); pos != mFirstEntity.end()) {
+            return pos->second;
+        }
+    }
+    return {};
+}
+
+Entity NameComponentManager::getNextEntityWithSameName(Instance instance) const noexcept {
+    return elementAt<NEXT>(instance);
 }
 
 void NameComponentManager::addComponent(Entity e) {
@@ -41,7 +58,48 @@ void NameComponentManager::addComponent(Entity e) {
 }
 
 void NameComponentManager::removeComponent(Entity e) {
+    if (Instance const instance = getInstance(e)) {
+        unlink(instance);
+    }
     SingleInstanceComponentManager::removeComponent(e);
 }
 
+void NameComponentManager::link(Instance instance, StringPool::Id id) noexcept {
+    elementAt<NAME>(instance) = id;
+    if (id == StringPool::NULL_ID) {
+        return;
+    }
+    // the entity becomes the first one with this name
+    Entity const e = SingleInstanceComponentManager::getEntity(instance);
+    Entity& first = mFirstEntity[id];
+    if (first) {
+        elementAt<PREVIOUS>(getInstance(first)) = e;
+    }
+    elementAt<PREVIOUS>(instance) = {};
+    elementAt<NEXT>(instance) = first;
+    first = e;
+}
+
+void NameComponentManager::unlink(Instance instance) noexcept {
+    StringPool::Id const id = elementAt<NAME>(instance);
+    if (id == StringPool::NULL_ID) {
+        return;
+    }
+    Entity const previous = elementAt<PREVIOUS>(instance);
+    Entity const next = elementAt<NEXT>(instance);
+    if (previous) {
+        elementAt<NEXT>(getInstance(previous)) = next;
+    } else if (next) {
+        mFirstEntity[id] = next;
+    } else {
+        mFirstEntity.erase(id);
+    }
+    if (next) {
+        elementAt<PREVIOUS>(getInstance(next)) = previous;
+    }
+    elementAt<NAME>(instance) = StringPool::NULL_ID;
+    elementAt<PREVIOUS>(instance) = {};
+    elementAt<NEXT>(instance) = {};
+}
+
 } // namespace utils
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <utils/StringPool.h>
+
+#include <utils/Panic.h>
+
+#include <algorithm>
+#include <utility>
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace utils {
+
+StringPool::StringPool() noexcept = default;
+
+StringPool::~StringPool() noexcept {
+    clear();
+}
+
+StringPool::StringPool(StringPool&& rhs) noexcept
+        : mBlocks(std::move(rhs.mBlocks)),
+          mCurrent(std::exchange(rhs.mCurrent, nullptr)),
+          mAvailable(std::exchange(rhs.mAvailable, 0)),
+          mStrings(std::move(rhs.mStrings)),
+          mIds(std::move(rhs.mIds)) {
+}
+
+StringPool& StringPool::operator=(StringPool&& rhs) noexcept {
+    if (this != &rhs) {
+        clear();
+        std::swap(mBlocks, rhs.mBlocks);
+        std::swap(mCurrent, rhs.mCurrent);
+        std::swap(mAvailable, rhs.mAvailable);
+        std::swap(mStrings, rhs.mStrings);
+        std::swap(mIds, rhs.mIds);
+    }
+    return *this;
+}
+
+void StringPool::clear() noexcept {
+    for (char* block : mBlocks) {
+        ::free(block);
+    }
+    mBlocks.clear();
+    mCurrent = nullptr;
+    mAvailable = 0;
+    mStrings.clear();
+    mIds.clear();
+}
+
+char* StringPool::allocate(size_t const size) {
+    if (UTILS_UNLIKELY(size > mAvailable)) {
+        // Large strings get a block of their own, so that the current block isn't wasted.
+        size_t const blockSize = std::max(size, BLOCK_SIZE);
+        char* const block = (char*)::malloc(blockSize);
+        FILAMENT_CHECK_POSTCONDITION(block) << "Out of memory";
+        mBlocks.push_back(block);
+        if (blockSize > BLOCK_SIZE) {
+            return block;
+        }
+        mCurrent = block;
+        mAvailable = blockSize;
+    }
+    char* const p = mCurrent;
+    mCurrent += size;
+    mAvailable -= size;
+    return p;
+}
+
+StringPool::Id StringPool::intern(std::string_view const string) {
+    if (auto pos = mIds.find(string); pos != mIds.end()) {
+        return pos->second;
+    }
+
+    FILAMENT_CHECK_PRECONDITION(mStrings.size() < UINT32_MAX) << "Too many strings";
+
+    size_t const length = string.size();
+    char* const copy = allocate(length + 1);
+    memcpy(copy, string.data(), length);
+    copy[length] = '\0';
+
+    std::string_view const key{ copy, length };
+    mStrings.push_back(key);
+    Id const id = Id(mStrings.size());
+    mIds.emplace(key, id);
+    return id;
+}
+
+StringPool::Id StringPool::find(std::string_view const string) const noexcept {
+    if (auto pos = mIds.find(string); pos != mIds.end()) {
+        return pos->second;
+    }
+    return NULL_ID;
+}
+
+} // namespace utils
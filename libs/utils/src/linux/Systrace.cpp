@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <utils/Systrace.h>
+
+#if FILAMENT_LINUX_SYSTRACE
+
+#include <utils/Log.h>
+#include <utils/Mutex.h>
+#include <utils/ostream.h>
+
+#include <mutex>
+#include <string>
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace utils {
+namespace details {
+
+namespace {
+
+// events are accumulated per thread and written to the file in batches of about this size
+constexpr size_t FLUSH_THRESHOLD = 64 * 1024;
+
+struct Output {
+    Mutex lock;
+    FILE* file = nullptr;   // guarded by lock, never closed, stdio flushes it at exit
+    int pid = 0;
+};
+
+Output& getOutput() noexcept {
+    // intentionally leaked, so that threads exiting late can still flush their events
+    static Output* const output = new Output;
+    return *output;
+}
+
+double now() noexcept {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    // the trace event format uses microseconds
+    return double(ts.tv_sec) * 1e6 + double(ts.tv_nsec) * 1e-3;
+}
+
+class ThreadBuffer {
+public:
+    ThreadBuffer() noexcept : mTid(int(syscall(SYS_gettid))) {
+        mData.reserve(FLUSH_THRESHOLD + 1024);
+        // name this thread's track, the name is set by the time the first event is traced
+        char name[16] = {};
+        pthread_getname_np(pthread_self(), name, sizeof(name));
+        mData += R"({"name":"thread_name","ph":"M","pid":)";
+        mData += std::to_string(getOutput().pid);
+        mData += R"(,"tid":)";
+        mData += std::to_string(mTid);
+        mData += R"(,"args":{"name":")";
+        appendEscaped(name);
+        mData += "\"}},\n";
+    }
+
+    ~ThreadBuffer() noexcept {
+        flush();
+    }
+
+    // starts an event, which must be terminated with commit()
+    void begin(char const phase, const char* name) noexcept {
+        char buf[128];
+        if (name) {
+            mData += R"({"name":")";
+            appendEscaped(name);
+            mData += "\",";
+        } else {
+            mData += "{";
+        }
+        snprintf(buf, sizeof(buf), R"("ph":"%c","ts":%.3f,"pid":%d,"tid":%d)",
+                phase, now(), getOutput().pid, mTid);
+        mData += buf;
+    }
+
+    void append(const char* str) noexcept {
+        mData += str;
+    }
+
+    void commit() noexcept {
+        mData += "},\n";
+        if (UTILS_UNLIKELY(mData.size() >= FLUSH_THRESHOLD)) {
+            flush();
+        }
+    }
+
+    void flush() noexcept {
+        if (!mData.empty()) {
+            Output& output = getOutput();
+            std::lock_guard const lock(output.lock);
+            if (output.file) {
+                fwrite(mData.data(), 1, mData.size(), output.file);
+            }
+            mData.clear();
+        }
+    }
+
+private:
+    void appendEscaped(const char* str) noexcept {
+        for (const char* p = str; *p; p++) {
+            char const c = *p;
+            if (c == '"' || c == '\\') {
+                mData += '\\';
+                mData += c;
+            } else if (uint8_t(c) >= 0x20) {
+                mData += c;
+            }
+        }
+    }
+
+    std::string mData;
+    int const mTid;
+};
+
+ThreadBuffer& getThreadBuffer() noexcept {
+    static thread_local ThreadBuffer buffer;
+    return buffer;
+}
+
+void openOutput() noexcept {
+    Output& output = getOutput();
+    std::lock_guard const lock(output.lock);
+    if (output.file) {
+        return;
+    }
+    output.pid = getpid();
+    char path[256];
+    const char* filename = getenv("FILAMENT_TRACE_FILE");
+    if (!filename || !*filename) {
+        snprintf(path, sizeof(path), "filament-%d.json", output.pid);
+        filename = path;
+    }
+    output.file = fopen(filename, "w");
+    if (!output.file) {
+        slog.e << "Systrace: couldn't open " << filename << io::endl;
+        return;
+    }
+    // the format allows the closing bracket to be missing, so the file is valid at any time
+    fputs("[\n", output.file);
+    slog.i << "Systrace: writing trace to " << filename << io::endl;
+}
+
+} // anonymous namespace
+
+Systrace::GlobalState Systrace::sGlobalState = {};
+
+void Systrace::enable(uint32_t tags) noexcept {
+    openOutput();
+    if (getOutput().file) {
+        sGlobalState.isTracingEnabled.fetch_or(tags, std::memory_order_relaxed);
+    }
+}
+
+void Systrace::disable(uint32_t tags) noexcept {
+    sGlobalState.isTracingEnabled.fetch_and(~tags, std::memory_order_relaxed);
+    // other threads write their pending events when their buffer fills up or when they exit
+    getThreadBuffer().flush();
+    Output& output = getOutput();
+    std::lock_guard const lock(output.lock);
+    if (output.file) {
+        fflush(output.file);
+    }
+}
+
+// unfortunately, this generates quite a bit of code because reading a global is not
+// trivial. For this reason, we do not inline this method.
+bool Systrace::isTracingEnabled(uint32_t tag) noexcept {
+    if (tag) {
+        uint32_t const enabled = sGlobalState.isTracingEnabled.load(std::memory_order_relaxed);
+        // nothing is traced until the trace file is opened by enable()
+        return enabled && bool((enabled | SYSTRACE_TAG_ALWAYS) & tag);
+    }
+    return false;
+}
+
+void Systrace::init(uint32_t tag) noexcept {
+    // must be called first
+    mIsTracingEnabled = isTracingEnabled(tag);
+}
+
+// ------------------------------------------------------------------------------------------------
+
+void Systrace::beginSection(const char* name) noexcept {
+    ThreadBuffer& buffer = getThreadBuffer();
+    buffer.begin('B', name);
+    buffer.commit();
+}
+
+void Systrace::endSection() noexcept {
+    ThreadBuffer& buffer = getThreadBuffer();
+    buffer.begin('E', nullptr);
+    buffer.commit();
+}
+
+void Systrace::beginAsyncSection(const char* name, int64_t cookie) noexcept {
+    char buf[64];
+    snprintf(buf, sizeof(buf), R"(,"cat":"async","id":"0x%llx")", (unsigned long long)cookie);
+    ThreadBuffer& buffer = getThreadBuffer();
+    buffer.begin('b', name);
+    buffer.append(buf);
+    buffer.commit();
+}
+
+void Systrace::endAsyncSection(const char* name, int64_t cookie) noexcept {
+    char buf[64];
+    snprintf(buf, sizeof(buf), R"(,"cat":"async","id":"0x%llx")", (unsigned long long)cookie);
+    ThreadBuffer& buffer = getThreadBuffer();
+    buffer.begin('e', name);
+    buffer.append(buf);
+    buffer.commit();
+}
+
+void Systrace::setCounter(const char* name, int64_t value) noexcept {
+    char buf[64];
+    snprintf(buf, sizeof(buf), R"(,"args":{"value":%lld})", (long long)value);
+    ThreadBuffer& buffer = getThreadBuffer();
+    buffer.begin('C', name);
+    buffer.append(buf);
+    buffer.commit();
+}
+
+void Systrace::instant(const char* name) noexcept {
+    ThreadBuffer& buffer = getThreadBuffer();
+    buffer.begin('i', name);
+    buffer.append(R"(,"s":"p")");
+    buffer.commit();
+}
+
+void Systrace::beginFlow(const char* name, uint64_t id) noexcept {
+    // binds to the enclosing slice
+    char buf[64];
+    snprintf(buf, sizeof(buf), R"(,"cat":"flow","id":"0x%llx")", (unsigned long long)id);
+    ThreadBuffer& buffer = getThreadBuffer();
+    buffer.begin('s', name);
+    buffer.append(buf);
+    buffer.commit();
+}
+
+void Systrace::endFlow(const char* name, uint64_t id) noexcept {
+    // binds to the next slice that begins on this thread
+    char buf[64];
+    snprintf(buf, sizeof(buf), R"(,"cat":"flow","id":"0x%llx")", (unsigned long long)id);
+    ThreadBuffer& buffer = getThreadBuffer();
+    buffer.begin('f', name);
+    buffer.append(buf);
+    buffer.commit();
+}
+
+} // namespace details
+} // namespace utils
+
+#endif // FILAMENT_LINUX_SYSTRACE
@@ -17,6 +17,9 @@
 #include <gtest/gtest.h>
 
 #include <memory>
+#include <thread>
+#include <unordered_set>
+#include <vector>
 
 #include "../src/EntityManagerImpl.h"
 #include <utils/NameComponentManager.h>
@@ -129,6 +132,44 @@ TEST(EntityTest, Lots) {
 }
 
 
+TEST(EntityTest, Concurrent) {
+    EntityManagerImpl em;
+    constexpr size_t THREAD_COUNT = 4;
+    constexpr size_t BATCH_COUNT = 64;
+    constexpr size_t BATCH_SIZE = 256;
+    std::vector<Entity> entities(THREAD_COUNT * BATCH_COUNT * BATCH_SIZE);
+
+    // each thread creates its entities in batches, destroying some of them along the way
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < THREAD_COUNT; t++) {
+        threads.emplace_back([&em, &entities, t]() {
+            Entity* const base = entities.data() + t * BATCH_COUNT * BATCH_SIZE;
+            for (size_t b = 0; b < BATCH_COUNT; b++) {
+                em.create(BATCH_SIZE, base + b * BATCH_SIZE);
+                if (b % 4 == 3) {
+                    em.destroy(BATCH_SIZE, base + b * BATCH_SIZE);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // all the live entities must be distinct
+    std::unordered_set<uint32_t> ids;
+    size_t alive = 0;
+    for (auto const& e : entities) {
+        EXPECT_FALSE(e.isNull());
+        if (em.isAlive(e)) {
+            alive++;
+            EXPECT_TRUE(ids.insert(e.getId()).second);
+        }
+    }
+    EXPECT_EQ(THREAD_COUNT * BATCH_COUNT * BATCH_SIZE * 3 / 4, alive);
+    EXPECT_EQ(alive, em.getEntityCount());
+}
+
 TEST(EntityTest, NameComponent) {
 
     EntityManagerImpl em;
@@ -176,3 +217,51 @@ TEST(EntityTest, NameComponent) {
 
     cm.gc(em);
 }
+
+TEST(EntityTest, NameLookup) {
+
+    EntityManagerImpl em;
+    NameComponentManager cm(em);
+
+    Entity entities[4];
+    em.create(4, entities);
+    for (Entity e : entities) {
+        cm.addComponent(e);
+    }
+
+    EXPECT_TRUE(cm.getEntity("a").isNull());
+
+    cm.setName(cm.getInstance(entities[0]), "a");
+    cm.setName(cm.getInstance(entities[1]), "b");
+    cm.setName(cm.getInstance(entities[2]), "a");
+    cm.setName(cm.getInstance(entities[3]), "a");
+
+    // names are shared
+    EXPECT_EQ(cm.getName(cm.getInstance(entities[0])), cm.getName(cm.getInstance(entities[2])));
+
+    EXPECT_EQ(entities[1], cm.getEntity("b"));
+    EXPECT_EQ(entities[3], cm.getEntity("a"));
+    EXPECT_EQ(entities[2], cm.getNextEntityWithSameName(cm.getInstance(entities[3])));
+    EXPECT_EQ(entities[0], cm.getNextEntityWithSameName(cm.getInstance(entities[2])));
+    EXPECT_TRUE(cm.getNextEntityWithSameName(cm.getInstance(entities[0])).isNull());
+
+    // renaming and removing entities keeps the lookup up to date
+    cm.setName(cm.getInstance(entities[3]), "b");
+    EXPECT_EQ(entities[2], cm.getEntity("a"));
+    EXPECT_EQ(entities[3], cm.getEntity("b"));
+
+    cm.removeComponent(entities[2]);
+    EXPECT_EQ(entities[0], cm.getEntity("a"));
+    EXPECT_TRUE(cm.getNextEntityWithSameName(cm.getInstance(entities[0])).isNull());
+
+    cm.removeComponent(entities[0]);
+    EXPECT_TRUE(cm.getEntity("a").isNull());
+
+    cm.setName(cm.getInstance(entities[1]), nullptr);
+    EXPECT_EQ(nullptr, cm.getName(cm.getInstance(entities[1])));
+    EXPECT_EQ(entities[3], cm.getEntity("b"));
+
+    em.destroy(4, entities);
+
+    cm.gc(em);
+}
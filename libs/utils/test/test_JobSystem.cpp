@@ -219,6 +219,125 @@ TEST(JobSystem, JobSystemParallelChildren) {
 }
 
 
+TEST(JobSystem, JobSystemCancellation) {
+    JobSystem js;
+    js.adopt();
+
+    std::atomic_int calls = { 0 };
+    std::atomic_int work = { 0 };
+    auto const functor = [&calls, &work](JobSystem&, JobSystem::Job* job) {
+        calls++;
+        if (!JobSystem::isCancelled(job)) {
+            work++;
+        }
+    };
+
+    // the function of a cancelled job is still called, but it skips its work
+    JobSystem::Job* cancelled = js.createJob(nullptr, functor);
+    JobSystem::requestCancel(cancelled);
+    EXPECT_TRUE(JobSystem::isCancelled(cancelled));
+    js.runAndWait(cancelled);
+
+    JobSystem::Job* job = js.createJob(nullptr, functor);
+    EXPECT_FALSE(JobSystem::isCancelled(job));
+    js.runAndWait(job);
+
+    EXPECT_EQ(2, calls);
+    EXPECT_EQ(1, work);
+
+    js.emancipate();
+}
+
+TEST(JobSystem, JobSystemPriority) {
+    JobSystem js;
+    js.adopt();
+
+    JobSystem::Job* root = js.createJob();
+    EXPECT_EQ(JobSystem::JobPriority::NORMAL, JobSystem::getPriority(root));
+    JobSystem::setPriority(root, JobSystem::JobPriority::BACKGROUND);
+    EXPECT_EQ(JobSystem::JobPriority::BACKGROUND, JobSystem::getPriority(root));
+
+    // children inherit the priority of their parent, and still all run
+    std::atomic_int background = { 0 };
+    for (int i = 0; i < 256; i++) {
+        JobSystem::Job* job = js.createJob(root, [&background](JobSystem&, JobSystem::Job* job) {
+            if (JobSystem::getPriority(job) == JobSystem::JobPriority::BACKGROUND) {
+                background++;
+            }
+        });
+        js.run(job);
+    }
+    js.runAndWait(root);
+    EXPECT_EQ(256, background);
+
+    JobSystem::Job* job = js.createJob();
+    EXPECT_EQ(JobSystem::JobPriority::NORMAL, JobSystem::getPriority(job));
+    js.runAndWait(job);
+
+    js.emancipate();
+}
+
+TEST(JobSystem, JobSystemInstrumentation) {
+    JobSystem js;
+    js.adopt();
+
+    js.setInstrumentationEnabled(true);
+    EXPECT_TRUE(js.isInstrumentationEnabled());
+
+    JobSystem::Job* root = js.createJob();
+    js.setLabel(root, "root");
+    for (int i = 0; i < 64; i++) {
+        js.run(js.createJob(root, [](JobSystem&, JobSystem::Job*) {}));
+    }
+    js.runAndWait(root);
+
+    JobSystem::Statistics const stats = js.getStatistics();
+    EXPECT_EQ(js.getThreadCount() + 1, stats.threads.size());
+    uint64_t jobCount = 0;
+    for (auto const& thread : stats.threads) {
+        jobCount += thread.jobCount;
+    }
+    EXPECT_EQ(65, jobCount);
+
+    // the children inherit the label of their parent, but the root itself has no function
+    ASSERT_EQ(1, stats.labels.size());
+    EXPECT_STREQ("root", stats.labels[0].label);
+    EXPECT_EQ(64, stats.labels[0].jobCount);
+    EXPECT_GE(stats.labels[0].totalTime, stats.labels[0].maxTime);
+
+    js.resetStatistics();
+    EXPECT_TRUE(js.getStatistics().labels.empty());
+
+    js.setInstrumentationEnabled(false);
+    js.emancipate();
+}
+
+TEST(JobSystem, JobSystemContinuation) {
+    JobSystem js;
+    js.adopt();
+
+    std::atomic_int children = { 0 };
+    std::atomic_int seen = { -1 };
+
+    // the continuation keeps the root alive, so waiting on the root waits for it as well
+    JobSystem::Job* root = js.createJob();
+    JobSystem::Job* work = js.createJob(root);
+    for (int i = 0; i < 64; i++) {
+        js.run(js.createJob(work, [&children](JobSystem&, JobSystem::Job*) {
+            children++;
+        }));
+    }
+    js.runAfter(work, js.createJob(root, [&children, &seen](JobSystem&, JobSystem::Job*) {
+        seen = children.load();
+    }));
+    js.run(work);
+    js.runAndWait(root);
+
+    EXPECT_EQ(64, seen);
+
+    js.emancipate();
+}
+
 TEST(JobSystem, JobSystemSequentialChildren) {
     JobSystem js;
     js.adopt();
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <utils/SpscQueue.h>
+
+#include <thread>
+
+#include <stdint.h>
+
+using namespace utils;
+
+TEST(SpscQueueTest, Simple) {
+    SpscQueue<int, 4> queue;
+    int v = 0;
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(queue.pop(v));
+
+    EXPECT_TRUE(queue.push(1));
+    EXPECT_TRUE(queue.push(2));
+    EXPECT_TRUE(queue.push(3));
+    EXPECT_EQ(queue.size(), 3);
+    EXPECT_TRUE(queue.pop(v));
+    EXPECT_EQ(v, 1);
+    EXPECT_TRUE(queue.pop(v));
+    EXPECT_EQ(v, 2);
+
+    EXPECT_TRUE(queue.push(4));
+    EXPECT_TRUE(queue.push(5));
+    EXPECT_TRUE(queue.push(6));
+    EXPECT_TRUE(queue.full());
+    EXPECT_FALSE(queue.push(7));
+
+    for (int i = 3; i <= 6; i++) {
+        EXPECT_TRUE(queue.pop(v));
+        EXPECT_EQ(v, i);
+    }
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(queue.pop(v));
+}
+
+TEST(SpscQueueTest, TwoThreads) {
+    constexpr uint32_t COUNT = 1u << 20;
+    SpscQueue<uint32_t, 64> queue;
+
+    std::thread producer([&queue]() {
+        for (uint32_t i = 0; i < COUNT;) {
+            if (queue.push(i)) {
+                i++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    // items must come out in order, and none can be lost
+    uint32_t expected = 0;
+    while (expected < COUNT) {
+        uint32_t v;
+        if (queue.pop(v)) {
+            EXPECT_EQ(v, expected);
+            expected++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    producer.join();
+    EXPECT_TRUE(queue.empty());
+}
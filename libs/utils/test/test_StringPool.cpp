@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <utils/StringPool.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace utils;
+
+TEST(StringPoolTest, Intern) {
+    StringPool pool;
+    EXPECT_EQ(0, pool.size());
+    EXPECT_EQ(StringPool::NULL_ID, pool.intern(nullptr));
+    EXPECT_EQ(nullptr, pool.get(StringPool::NULL_ID));
+
+    StringPool::Id const a = pool.intern("hello");
+    StringPool::Id const b = pool.intern("world");
+    EXPECT_NE(StringPool::NULL_ID, a);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(2, pool.size());
+
+    // interning the same string again returns the same id and the same copy
+    std::string const hello = "hello";
+    EXPECT_EQ(a, pool.intern(hello.c_str()));
+    EXPECT_EQ(a, pool.intern(std::string_view{ "hello, world", 5 }));
+    EXPECT_EQ(2, pool.size());
+
+    EXPECT_STREQ("hello", pool.get(a));
+    EXPECT_STREQ("world", pool.get(b));
+    EXPECT_EQ(5, pool.length(a));
+
+    EXPECT_EQ(a, pool.find("hello"));
+    EXPECT_EQ(StringPool::NULL_ID, pool.find("goodbye"));
+
+    StringPool::Id const empty = pool.intern("");
+    EXPECT_NE(StringPool::NULL_ID, empty);
+    EXPECT_STREQ("", pool.get(empty));
+}
+
+TEST(StringPoolTest, Lots) {
+    StringPool pool;
+    std::vector<const char*> strings;
+    for (size_t i = 0; i < 100000; i++) {
+        StringPool::Id const id = pool.intern(std::to_string(i).c_str());
+        EXPECT_EQ(i + 1, id);
+        strings.push_back(pool.get(id));
+    }
+
+    // a string larger than a block
+    std::string const large(200000, 'x');
+    StringPool::Id const largeId = pool.intern(large.c_str());
+    EXPECT_EQ(large, pool.get(largeId));
+
+    // strings never move
+    for (size_t i = 0; i < strings.size(); i++) {
+        EXPECT_EQ(strings[i], pool.get(pool.find(std::to_string(i))));
+    }
+
+    StringPool moved = std::move(pool);
+    EXPECT_EQ(strings[42], moved.get(moved.find("42")));
+
+    moved.clear();
+    EXPECT_EQ(0, moved.size());
+    EXPECT_EQ(StringPool::NULL_ID, moved.find("42"));
+}
@@ -183,3 +183,37 @@ TEST(StructureOfArraysTest, MoveOnly) {
     EXPECT_EQ(*soa.elementAt<1>(1).get(), 2);
 }
 
+
+TEST(StructureOfArraysTest, Aligned) {
+    using AlignedSoA = utils::AlignedStructureOfArrays<32, float, uint8_t, float3, double>;
+
+    // 32 uint8_t are needed to span 32 bytes
+    static_assert(AlignedSoA::getChunkSize() == 32);
+    static_assert(SoA::getChunkSize() == 1);
+
+    AlignedSoA soa;
+    soa.setCapacity(40);
+    EXPECT_EQ(soa.capacity(), 64);
+
+    soa.resize(40);
+    soa.forEach([](auto const* p) {
+        EXPECT_EQ(uintptr_t(p) % 32, 0);
+    });
+
+    size_t chunkCount = 0;
+    size_t elementCount = 0;
+    soa.forEachChunk([&](size_t const first, size_t const count) {
+        EXPECT_EQ(first % AlignedSoA::getChunkSize(), 0);
+        EXPECT_EQ(uintptr_t(soa.data<0>() + first) % 32, 0);
+        EXPECT_EQ(uintptr_t(soa.data<2>() + first) % 32, 0);
+        EXPECT_LE(first + AlignedSoA::getChunkSize(), soa.capacity());
+        elementCount += count;
+        chunkCount++;
+    });
+    EXPECT_EQ(chunkCount, 2);
+    EXPECT_EQ(elementCount, 40);
+
+    // growing keeps the capacity a multiple of the chunk size
+    soa.resize(65);
+    EXPECT_EQ(soa.capacity() % AlignedSoA::getChunkSize(), 0);
+}
@@ -19,6 +19,10 @@
 
 #include <viewer/AutomationSpec.h>
 
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace filament {
 
 class ColorGrading;
@@ -103,6 +107,24 @@ public:
          * Which image format will be used for exporting screenshots.
          */
         ExportFormat exportFormat = ExportFormat::TIFF;
+
+        /**
+         * If true, the CPU and GPU timings of each test are measured, including the GPU time of
+         * each rendering pass, and written out to a JSON file (see timingsFilename) after the
+         * last test. This enables the pass timings of the Renderer.
+         */
+        bool exportTimings = false;
+
+        /**
+         * Number of frames measured for each test when exportTimings is true. Automation waits
+         * for these frames, in addition to minFrameCount, before advancing to the next test.
+         */
+        int timingFrameCount = 60;
+
+        /**
+         * Name of the JSON file written when exportTimings is true.
+         */
+        std::string timingsFilename = "timings.json";
     };
 
     /**
@@ -248,6 +270,14 @@ public:
     static void exportScreenshot(View* view, Renderer* renderer, std::string filename,
             bool autoclose, AutomationEngine* automationEngine);
 
+    /**
+     * Writes out the timings measured so far to a JSON file. This is done automatically after
+     * the last test when Options::exportTimings is true.
+     *
+     * @param filename Desired JSON filename.
+     */
+    void exportTimings(const char* filename) const;
+
     Options getOptions() const { return mOptions; }
     bool isRunning() const { return mIsRunning; }
     size_t currentTest() const { return mCurrentTest; }
@@ -257,6 +287,25 @@ public:
     ~AutomationEngine();
 
 private:
+    // Sums of the timings measured during a test, in nanoseconds
+    struct TestTimings {
+        std::string name;
+        size_t frameCount = 0;
+        double gpuFrameTime = 0;
+        double cpuFrameTime = 0;
+        double prepare = 0;
+        double scene = 0;
+        double culling = 0;
+        double shadows = 0;
+        double frameGraphSetup = 0;
+        double frameGraphCompile = 0;
+        double frameGraphExecute = 0;
+        double flush = 0;
+        std::vector<std::pair<std::string, double>> passes;
+    };
+
+    void measureTimings(Renderer* renderer);
+
     AutomationSpec const * const mSpec;
     Settings * const mSettings;
     Options mOptions;
@@ -276,6 +325,9 @@ private:
     bool mTerminated = false;
     bool mOwnsSettings = false;
 
+    std::vector<TestTimings> mTimings;
+    uint32_t mLastMeasuredFrameId = 0;
+
 public:
     // For internal use from a screenshot callback.
     void requestClose() { mShouldClose = true; }
@@ -22,11 +22,17 @@
 #include <utils/compiler.h>
 
 #include <stddef.h>
+#include <stdint.h>
 #include <mutex>
+#include <vector>
 
 class CivetServer;
 
 namespace filament {
+
+class Engine;
+class Renderer;
+
 namespace viewer {
 
 class MessageSender;
@@ -79,6 +85,44 @@ public:
     void sendMessage(const Settings& settings);
     void sendMessage(const char* label, const char* buffer, size_t bufsize);
 
+    /**
+     * Sets how often sendTelemetry() actually sends telemetry, in frames. 0, the default,
+     * disables telemetry.
+     */
+    void setTelemetryPeriod(uint32_t frameCount) { mTelemetryPeriod = frameCount; }
+
+    /**
+     * Streams performance telemetry to the connected clients, as a "telemetry.bin" message.
+     * This should be called once per frame, after Renderer::endFrame(); only one call every
+     * setTelemetryPeriod() frames encodes and sends anything. Each message holds all the frames
+     * completed since the previous one, so a long period costs less without losing frames, as
+     * long as it stays below Renderer::getMaxFrameHistorySize().
+     *
+     * Per-pass GPU timings are only included when enabled with
+     * Renderer::setPassTimingsEnabled(), and JobSystem thread statistics when enabled with
+     * JobSystem::setInstrumentationEnabled().
+     *
+     * The message is little-endian, durations are in microseconds:
+     *
+     *     uint32   magic 'FTEL', version 1
+     *     uint16   frame count, then for each frame:
+     *         uint32   frameId, GPU frame time, denoised GPU frame time,
+     *                  main thread time (beginFrame to endFrame), backend thread time,
+     *                  and the 8 Renderer::FrameInfo::CpuTimings, in declaration order
+     *     uint16   pass count, then for each pass:
+     *         uint8    name length, followed by the name (not null-terminated)
+     *         uint32   GPU time
+     *     uint16   JobSystem thread count, then for each thread, cumulative since
+     *              instrumentation was enabled or reset:
+     *         uint64   job count, steal count, idle time
+     *     uint16   resource count, then the number of each Engine resource, as uint32:
+     *              buffer objects, vertex buffers, index buffers, skinning buffers,
+     *              morph target buffers, instance buffers, textures, render targets,
+     *              materials, indirect lights, skyboxes, color gradings, views, scenes,
+     *              swap chains, streams
+     */
+    void sendTelemetry(Engine& engine, Renderer const& renderer);
+
     // For internal use (makes JNI simpler)
     ReceivedMessage const* peekReceivedMessage() const;
 
@@ -92,6 +136,11 @@ private:
     ReceivedMessage* mReceivedMessages[kMessageCapacity] = {};
     ReceivedMessage* mIncomingMessage = nullptr;
     JsonSerializer mSerializer;
+    uint32_t mTelemetryPeriod = 0;
+    uint32_t mTelemetryCountdown = 0;
+    uint32_t mLastTelemetryFrameId = 0;
+    bool mHasSentTelemetry = false;
+    std::vector<uint8_t> mTelemetry;
     mutable std::mutex mReceivedMessagesMutex;
     friend class MessageReceiver;
 };
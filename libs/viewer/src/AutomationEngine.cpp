@@ -28,6 +28,7 @@
 #include <utils/Log.h>
 #include <utils/Path.h>
 
+#include <algorithm>
 #include <iomanip>
 #include <fstream>
 #include <sstream>
@@ -39,6 +40,10 @@ namespace viewer {
 
 static std::string gStatus;
 
+// Frames skipped after applying a test's settings, before measuring timings. This covers the
+// latency of the GPU timings, and lets the frame rate settle.
+static constexpr int TIMING_WARMUP_FRAMES = 8;
+
 struct ScreenshotState {
     View* view;
     std::string filename;
@@ -184,6 +189,85 @@ void AutomationEngine::exportSettings(const Settings& settings, const char* file
     gStatus = "Exported to '" + std::string(filename) + "' in the current folder.";
 }
 
+void AutomationEngine::measureTimings(Renderer* renderer) {
+    auto const history = renderer->getFrameInfoHistory(1);
+    if (history.empty() || history[0].frameId == mLastMeasuredFrameId || mTimings.empty()) {
+        return;
+    }
+    Renderer::FrameInfo const& info = history[0];
+    mLastMeasuredFrameId = info.frameId;
+
+    TestTimings& timings = mTimings.back();
+    timings.frameCount++;
+    timings.gpuFrameTime += double(info.frameTime);
+    timings.cpuFrameTime += double(info.endFrame - info.beginFrame);
+    timings.prepare += double(info.cpu.prepare);
+    timings.scene += double(info.cpu.scene);
+    timings.culling += double(info.cpu.culling);
+    timings.shadows += double(info.cpu.shadows);
+    timings.frameGraphSetup += double(info.cpu.frameGraphSetup);
+    timings.frameGraphCompile += double(info.cpu.frameGraphCompile);
+    timings.frameGraphExecute += double(info.cpu.frameGraphExecute);
+    timings.flush += double(info.cpu.flush);
+
+    // passes that run several times per frame are summed up
+    for (auto const& pass : renderer->getPassTimings()) {
+        auto pos = std::find_if(timings.passes.begin(), timings.passes.end(),
+                [&pass](auto const& entry) { return entry.first == pass.name; });
+        if (pos == timings.passes.end()) {
+            pos = timings.passes.emplace(pos, pass.name, 0.0);
+        }
+        pos->second += double(pass.gpuTime);
+    }
+}
+
+void AutomationEngine::exportTimings(const char* filename) const {
+    // average in milliseconds
+    auto const ms = [](double const sum, size_t const count) {
+        return count ? sum / (double(count) * 1e6) : 0.0;
+    };
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(4);
+    out << "{\n    \"tests\": [";
+    for (size_t i = 0; i < mTimings.size(); i++) {
+        TestTimings const& t = mTimings[i];
+        size_t const n = t.frameCount;
+        out << (i ? ",\n" : "\n");
+        out << "        {\n";
+        out << "            \"name\": \"" << t.name << "\",\n";
+        out << "            \"frames\": " << n << ",\n";
+        out << "            \"gpuFrameTime\": " << ms(t.gpuFrameTime, n) << ",\n";
+        out << "            \"cpuFrameTime\": " << ms(t.cpuFrameTime, n) << ",\n";
+        out << "            \"cpu\": {\n";
+        out << "                \"prepare\": " << ms(t.prepare, n) << ",\n";
+        out << "                \"scene\": " << ms(t.scene, n) << ",\n";
+        out << "                \"culling\": " << ms(t.culling, n) << ",\n";
+        out << "                \"shadows\": " << ms(t.shadows, n) << ",\n";
+        out << "                \"frameGraphSetup\": " << ms(t.frameGraphSetup, n) << ",\n";
+        out << "                \"frameGraphCompile\": " << ms(t.frameGraphCompile, n) << ",\n";
+        out << "                \"frameGraphExecute\": " << ms(t.frameGraphExecute, n) << ",\n";
+        out << "                \"flush\": " << ms(t.flush, n) << "\n";
+        out << "            },\n";
+        out << "            \"passes\": {";
+        for (size_t j = 0; j < t.passes.size(); j++) {
+            out << (j ? ",\n" : "\n");
+            out << "                \"" << t.passes[j].first << "\": " << ms(t.passes[j].second, n);
+        }
+        out << (t.passes.empty() ? "}\n" : "\n            }\n");
+        out << "        }";
+    }
+    out << "\n    ]\n}";
+
+    std::ofstream file(filename);
+    if (!file) {
+        gStatus = "Failed to export timings file.";
+        return;
+    }
+    file << out.str() << std::endl;
+    gStatus = "Exported timings to '" + std::string(filename) + "'.";
+}
+
 void AutomationEngine::applySettings(Engine* engine, const char* json, size_t jsonLength,
         const ViewerContent& content) {
     JsonSerializer serializer;
@@ -236,6 +320,11 @@ void AutomationEngine::tick(Engine* engine, const ViewerContent& content, float
         for (size_t i = 0; i < content.materialCount; i++) {
             viewer::applySettings(engine, mSettings->material, content.materials[i]);
         }
+        if (mOptions.exportTimings) {
+            content.renderer->setPassTimingsEnabled(true);
+            mTimings.emplace_back();
+            mTimings.back().name = mSpec->getName(mCurrentTest) + std::to_string(mCurrentTest);
+        }
         if (mOptions.verbose) {
             utils::slog.i << "Running test " << mCurrentTest << utils::io::endl;
         }
@@ -247,6 +336,7 @@ void AutomationEngine::tick(Engine* engine, const ViewerContent& content, float
                 mIsRunning = true;
                 mRequestStart = false;
                 mCurrentTest = 0;
+                mTimings.clear();
                 activateTest();
             }
         }
@@ -256,7 +346,15 @@ void AutomationEngine::tick(Engine* engine, const ViewerContent& content, float
     mElapsedTime += deltaTime;
     mElapsedFrames++;
 
-    if (mElapsedTime < mOptions.sleepDuration || mElapsedFrames < mOptions.minFrameCount) {
+    int minFrameCount = mOptions.minFrameCount;
+    if (mOptions.exportTimings) {
+        if (mElapsedFrames > TIMING_WARMUP_FRAMES) {
+            measureTimings(content.renderer);
+        }
+        minFrameCount += TIMING_WARMUP_FRAMES + mOptions.timingFrameCount;
+    }
+
+    if (mElapsedTime < mOptions.sleepDuration || mElapsedFrames < minFrameCount) {
         return;
     }
 
@@ -279,6 +377,9 @@ void AutomationEngine::tick(Engine* engine, const ViewerContent& content, float
     }
 
     if (isLastTest) {
+        if (mOptions.exportTimings) {
+            exportTimings(mOptions.timingsFilename.c_str());
+        }
         mIsRunning = false;
         if (mBatchModeEnabled && !mOptions.exportScreenshots) {
             mShouldClose = true;
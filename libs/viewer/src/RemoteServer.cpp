@@ -18,11 +18,19 @@
 
 #include <CivetServer.h>
 
+#include <filament/Engine.h>
+#include <filament/Renderer.h>
+
+#include <utils/JobSystem.h>
 #include <utils/Log.h>
 
+#include <algorithm>
 #include <cstring>
+#include <type_traits>
 #include <vector>
 
+#include <stdint.h>
+
 using namespace utils;
 
 namespace filament {
@@ -166,6 +174,121 @@ void RemoteServer::sendMessage(const char* label, const char* buffer, size_t buf
     mMessageSender->sendMessage(label, buffer, bufsize);
 }
 
+namespace {
+
+constexpr uint32_t kTelemetryMagic = 0x4C455446; // 'FTEL'
+constexpr uint32_t kTelemetryVersion = 1;
+
+// Appends values in the host's byte order, which is little-endian on all our platforms.
+template<typename T>
+void write(std::vector<uint8_t>& out, T const value) {
+    static_assert(std::is_arithmetic_v<T>);
+    uint8_t const* const bytes = reinterpret_cast<uint8_t const*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+void writeMicroseconds(std::vector<uint8_t>& out, int64_t const ns) {
+    write(out, uint32_t(std::clamp(ns / 1000, int64_t(0), int64_t(UINT32_MAX))));
+}
+
+} // anonymous namespace
+
+void RemoteServer::sendTelemetry(Engine& engine, Renderer const& renderer) {
+    if (!mMessageSender || !mTelemetryPeriod) {
+        return;
+    }
+    if (mTelemetryCountdown) {
+        mTelemetryCountdown--;
+        return;
+    }
+    mTelemetryCountdown = mTelemetryPeriod - 1;
+
+    using FrameInfo = Renderer::FrameInfo;
+    auto const history = renderer.getFrameInfoHistory(renderer.getMaxFrameHistorySize());
+
+    std::vector<uint8_t>& out = mTelemetry;
+    out.clear();
+    write(out, kTelemetryMagic);
+    write(out, kTelemetryVersion);
+
+    // The history is sorted from the most recent frame; only send the frames we haven't sent yet,
+    // oldest first.
+    size_t frameCount = 0;
+    while (frameCount < history.size() && (!mHasSentTelemetry ||
+            history[frameCount].frameId > mLastTelemetryFrameId)) {
+        frameCount++;
+    }
+    write(out, uint16_t(frameCount));
+    for (size_t i = frameCount; i-- > 0;) {
+        FrameInfo const& info = history[i];
+        write(out, info.frameId);
+        writeMicroseconds(out, info.frameTime);
+        writeMicroseconds(out, info.denoisedFrameTime);
+        writeMicroseconds(out, info.endFrame - info.beginFrame);
+        writeMicroseconds(out, info.backendEndFrame - info.backendBeginFrame);
+        writeMicroseconds(out, info.cpu.prepare);
+        writeMicroseconds(out, info.cpu.scene);
+        writeMicroseconds(out, info.cpu.culling);
+        writeMicroseconds(out, info.cpu.shadows);
+        writeMicroseconds(out, info.cpu.frameGraphSetup);
+        writeMicroseconds(out, info.cpu.frameGraphCompile);
+        writeMicroseconds(out, info.cpu.frameGraphExecute);
+        writeMicroseconds(out, info.cpu.flush);
+    }
+    if (frameCount) {
+        mLastTelemetryFrameId = history[0].frameId;
+        mHasSentTelemetry = true;
+    }
+
+    auto const passes = renderer.getPassTimings();
+    write(out, uint16_t(passes.size()));
+    for (auto const& pass : passes) {
+        size_t const length = std::min(pass.name ? strlen(pass.name) : 0, size_t(UINT8_MAX));
+        write(out, uint8_t(length));
+        out.insert(out.end(), pass.name, pass.name + length);
+        writeMicroseconds(out, pass.gpuTime);
+    }
+
+    JobSystem const& js = engine.getJobSystem();
+    if (js.isInstrumentationEnabled()) {
+        auto const stats = js.getStatistics();
+        write(out, uint16_t(stats.threads.size()));
+        for (auto const& thread : stats.threads) {
+            write(out, uint64_t(thread.jobCount));
+            write(out, uint64_t(thread.stealCount));
+            write(out, uint64_t(thread.idleTime.count() / 1000));
+        }
+    } else {
+        write(out, uint16_t(0));
+    }
+
+    size_t const resources[] = {
+            engine.getBufferObjectCount(),
+            engine.getVertexBufferCount(),
+            engine.getIndexBufferCount(),
+            engine.getSkinningBufferCount(),
+            engine.getMorphTargetBufferCount(),
+            engine.getInstanceBufferCount(),
+            engine.getTextureCount(),
+            engine.getRenderTargetCount(),
+            engine.getMaterialCount(),
+            engine.getIndirectLightCount(),
+            engine.getSkyboxeCount(),
+            engine.getColorGradingCount(),
+            engine.getViewCount(),
+            engine.getSceneCount(),
+            engine.getSwapChainCount(),
+            engine.getStreamCount(),
+    };
+    write(out, uint16_t(std::size(resources)));
+    for (size_t const count : resources) {
+        write(out, uint32_t(count));
+    }
+
+    mMessageSender->sendMessage("telemetry.bin", reinterpret_cast<char const*>(out.data()),
+            out.size());
+}
+
 // NOTE: This is invoked off the main thread.
 bool MessageReceiver::handleData(CivetServer* server, struct mg_connection* conn, int bits,
                                   char* data, size_t size) {
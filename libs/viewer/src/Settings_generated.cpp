@@ -178,6 +178,8 @@ int parse(jsmntok_t const* tokens, int i, const char* jsonChunk, DynamicResoluti
             i = parse(tokens, i + 1, jsonChunk, &out->enabled);
         } else if (compare(tok, jsonChunk, "homogeneousScaling") == 0) {
             i = parse(tokens, i + 1, jsonChunk, &out->homogeneousScaling);
+        } else if (compare(tok, jsonChunk, "predictive") == 0) {
+            i = parse(tokens, i + 1, jsonChunk, &out->predictive);
         } else if (compare(tok, jsonChunk, "quality") == 0) {
             i = parse(tokens, i + 1, jsonChunk, &out->quality);
         } else {
@@ -199,6 +201,7 @@ std::ostream& operator<<(std::ostream& out, const DynamicResolutionOptions& in)
         << "\"sharpness\": " << (in.sharpness) << ",\n"
         << "\"enabled\": " << to_string(in.enabled) << ",\n"
         << "\"homogeneousScaling\": " << to_string(in.homogeneousScaling) << ",\n"
+        << "\"predictive\": " << to_string(in.predictive) << ",\n"
         << "\"quality\": " << (in.quality) << "\n"
         << "}";
 }
@@ -304,6 +307,23 @@ std::ostream& operator<<(std::ostream& out, const BloomOptions& in) {
         << "}";
 }
 
+int parse(jsmntok_t const* tokens, int i, const char* jsonChunk, FogOptions::Mode* out) {
+    if (0 == compare(tokens[i], jsonChunk, "PER_MATERIAL")) { *out = FogOptions::Mode::PER_MATERIAL; }
+    else if (0 == compare(tokens[i], jsonChunk, "FULL_SCREEN")) { *out = FogOptions::Mode::FULL_SCREEN; }
+    else {
+        slog.w << "Invalid FogOptions::Mode: '" << STR(tokens[i], jsonChunk) << "'" << io::endl;
+    }
+    return i + 1;
+}
+
+std::ostream& operator<<(std::ostream& out, FogOptions::Mode in) {
+    switch (in) {
+        case FogOptions::Mode::PER_MATERIAL: return out << "\"PER_MATERIAL\"";
+        case FogOptions::Mode::FULL_SCREEN: return out << "\"FULL_SCREEN\"";
+    }
+    return out << "\"INVALID\"";
+}
+
 int parse(jsmntok_t const* tokens, int i, const char* jsonChunk, FogOptions* out) {
     CHECK_TOKTYPE(tokens[i], JSMN_OBJECT);
     int size = tokens[i++].size;
@@ -336,6 +356,8 @@ int parse(jsmntok_t const* tokens, int i, const char* jsonChunk, FogOptions* out
             i = parse(tokens, i + 1, jsonChunk, &unused);
         } else if (compare(tok, jsonChunk, "enabled") == 0) {
             i = parse(tokens, i + 1, jsonChunk, &out->enabled);
+        } else if (compare(tok, jsonChunk, "mode") == 0) {
+            i = parse(tokens, i + 1, jsonChunk, &out->mode);
         } else {
             slog.w << "Invalid FogOptions key: '" << STR(tok, jsonChunk) << "'" << io::endl;
             i = parse(tokens, i + 1);
@@ -361,7 +383,8 @@ std::ostream& operator<<(std::ostream& out, const FogOptions& in) {
         << "\"inScatteringSize\": " << (in.inScatteringSize) << ",\n"
         << "\"fogColorFromIbl\": " << to_string(in.fogColorFromIbl) << ",\n"
         // JSON serialization for skyColor is not supported.
-        << "\"enabled\": " << to_string(in.enabled) << "\n"
+        << "\"enabled\": " << to_string(in.enabled) << ",\n"
+        << "\"mode\": " << (in.mode) << "\n"
         << "}";
 }
 
@@ -45,6 +45,9 @@ std::ostream& operator<<(std::ostream& out, BloomOptions::BlendMode in);
 int parse(jsmntok_t const* tokens, int i, const char* jsonChunk, BloomOptions* out);
 std::ostream& operator<<(std::ostream& out, const BloomOptions& in);
 
+int parse(jsmntok_t const* tokens, int i, const char* jsonChunk, FogOptions::Mode* out);
+std::ostream& operator<<(std::ostream& out, FogOptions::Mode in);
+
 int parse(jsmntok_t const* tokens, int i, const char* jsonChunk, FogOptions* out);
 std::ostream& operator<<(std::ostream& out, const FogOptions& in);
 
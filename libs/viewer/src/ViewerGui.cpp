@@ -966,8 +966,10 @@ void ViewerGui::updateUserInterface() {
         }
 
         bool excludeSkybox = !std::isinf(mSettings.view.fog.cutOffDistance);
+        bool fullScreen = mSettings.view.fog.mode == View::FogOptions::Mode::FULL_SCREEN;
         ImGui::Indent();
         ImGui::Checkbox("Enable large-scale fog", &mSettings.view.fog.enabled);
+        ImGui::Checkbox("Full-screen pass", &fullScreen);
         ImGui::SliderFloat("Start [m]", &mSettings.view.fog.distance, 0.0f, 100.0f);
         ImGui::SliderFloat("Extinction [1/m]", &mSettings.view.fog.density, 0.0f, 1.0f);
         ImGui::SliderFloat("Floor [m]", &mSettings.view.fog.height, 0.0f, 100.0f);
@@ -978,6 +980,8 @@ void ViewerGui::updateUserInterface() {
         ImGui::Combo("Color##fogColor", &fogColorSource, "Constant\0IBL\0Skybox\0\0");
         ImGui::ColorPicker3("Color", mSettings.view.fog.color.v);
         ImGui::Unindent();
+        mSettings.view.fog.mode = fullScreen ?
+                View::FogOptions::Mode::FULL_SCREEN : View::FogOptions::Mode::PER_MATERIAL;
         mSettings.view.fog.cutOffDistance =
                 excludeSkybox ? 1e6f : std::numeric_limits<float>::infinity();
         switch (fogColorSource) {
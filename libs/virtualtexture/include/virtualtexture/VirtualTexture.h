@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VIRTUALTEXTURE_VIRTUALTEXTURE_H
+#define VIRTUALTEXTURE_VIRTUALTEXTURE_H
+
+#include <functional>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace filament {
+class Engine;
+class Texture;
+} // namespace filament
+
+namespace filament::virtualtexture {
+
+/**
+ * A page of a virtual texture: a square of pageSize x pageSize texels of a mip level.
+ *
+ * Pages are identified by a 32-bit value, (level << 28) | (y << 14) | x, which is what the
+ * feedback pass writes, see VirtualTexture::addFeedback().
+ */
+struct PageId {
+    uint8_t level = 0;
+    uint16_t x = 0;
+    uint16_t y = 0;
+
+    static constexpr uint32_t INVALID = 0xFFFFFFFFu;
+
+    uint32_t pack() const noexcept {
+        return (uint32_t(level) << 28) | (uint32_t(y) << 14) | uint32_t(x);
+    }
+
+    static PageId unpack(uint32_t const id) noexcept {
+        return { uint8_t(id >> 28), uint16_t(id & 0x3FFF), uint16_t((id >> 14) & 0x3FFF) };
+    }
+
+    bool operator==(PageId const& rhs) const noexcept { return pack() == rhs.pack(); }
+    bool operator!=(PageId const& rhs) const noexcept { return !(*this == rhs); }
+};
+
+/**
+ * VirtualTexture streams the pages of a very large texture (e.g. the imagery of a terrain, or an
+ * atlas of many materials) on demand, and keeps the pages that are visible resident in a fixed
+ * amount of memory.
+ *
+ * Each frame:
+ *   1. The scene is rendered with a "feedback" material at a low resolution (e.g. 1/8th of the
+ *      view) into an RGBA8 render target cleared to white. Each fragment writes the id of the page
+ *      it would sample. The result is read back with Renderer::readPixels() and passed to
+ *      addFeedback().
+ *   2. update() is called. Missing pages are loaded with the PageLoader on the engine's JobSystem,
+ *      at background priority, the coarsest levels first. Loaded pages are uploaded, at most
+ *      Config::maxUploadsPerFrame per frame, replacing the least recently used pages.
+ *   3. The materials sample the virtual texture through getPageTable(), which maps each page of
+ *      each level to the finest resident page covering it.
+ *
+ * The coarsest level is always resident, so that there is always something to sample.
+ *
+ * Feedback material (unlit, fragment shader), with uv in [0, 1] over the virtual texture:
+ *
+ *     vec2 texels = uv * vec2(pageCount) * pageSize;
+ *     vec2 dx = dFdx(texels), dy = dFdy(texels);
+ *     float lod = floor(0.5 * log2(max(dot(dx, dx), dot(dy, dy))));
+ *     uint level = uint(clamp(lod, 0.0, float(levelCount - 1)));
+ *     uvec2 page = uvec2(uv * vec2(pageCount)) >> level;
+ *     uint id = (level << 28) | (page.y << 14) | page.x;
+ *     material.baseColor = vec4(uvec4(id, id >> 8, id >> 16, id >> 24) & 0xFFu) / 255.0;
+ *
+ * Sampling, when isSparse() is false. The page table must be sampled with NEAREST filtering, and
+ * its texels are (slot.x, slot.y, level, resident):
+ *
+ *     vec4 entry = textureLod(pageTable, uv, lod) * 255.0;
+ *     vec2 inPage = fract(uv * vec2(pageCount) * exp2(-entry.z));
+ *     vec2 texel = entry.xy * slotSize + border + inPage * pageSize;
+ *     vec4 color = textureLod(cache, texel / cacheSize, 0.0);
+ *
+ * where slotSize is pageSize + 2 * border and cacheSize the size of getTexture(). When
+ * isSparse() is true, getTexture() is the virtual texture itself, and only the level of the
+ * entry is needed: textureLod(texture, uv, max(lod, entry.z)).
+ */
+class VirtualTexture {
+public:
+    struct Config {
+        // size of the virtual texture in texels, powers of two and multiples of pageSize
+        uint32_t width = 0;
+        uint32_t height = 0;
+        // size of a page in texels, a power of two
+        uint32_t pageSize = 128;
+        // texels of the neighbouring pages stored around each page, for bilinear filtering.
+        // Only used when the texture is not sparse.
+        uint32_t border = 1;
+        // number of pages kept resident
+        uint32_t residentPageCount = 1024;
+        // maximum number of pages uploaded in each update()
+        uint32_t maxUploadsPerFrame = 8;
+        // maximum number of pages being loaded at the same time
+        uint32_t maxPendingLoads = 32;
+        // whether the texels are sRGB encoded
+        bool sRGB = true;
+        // use a sparse texture (Texture::Usage::SPARSE) when the backend supports it
+        bool useSparseTexture = true;
+    };
+
+    /**
+     * Loads a page. Called from a JobSystem thread, so must be thread-safe.
+     *
+     * @param page      The page to load.
+     * @param size      Width and height of the page in texels, pageSize + 2 * border.
+     * @param border    Number of texels of the neighbouring pages to store on each side.
+     * @param texels    Where to write the size x size RGBA8 texels, row by row in the
+     *                  direction of increasing v.
+     * @return false if the page couldn't be loaded. It will be requested again.
+     */
+    using PageLoader = std::function<bool(PageId page, uint32_t size, uint32_t border,
+            uint8_t* texels)>;
+
+    /**
+     * Fetches the content of a KTX2 file, see createKtx2Loader().
+     * Called from a JobSystem thread, so must be thread-safe.
+     */
+    using FileFetcher = std::function<bool(PageId page, std::vector<uint8_t>& content)>;
+
+    /**
+     * Returns a PageLoader for pages stored as individual KTX2 files (e.g. Basis Universal tiles),
+     * which are transcoded to RGBA8. Each file must be size x size texels, including the border.
+     */
+    static PageLoader createKtx2Loader(FileFetcher fetch);
+
+    struct Statistics {
+        uint32_t residentPageCount;     // pages in the cache
+        uint32_t pendingLoadCount;      // pages being loaded
+        uint32_t uploadCount;           // pages uploaded by the last update()
+        uint32_t evictionCount;         // pages evicted by the last update()
+        uint32_t requestCount;          // distinct pages requested since the previous update()
+    };
+
+    VirtualTexture(Engine& engine, Config const& config, PageLoader loader);
+
+    /**
+     * Destroys the textures, after waiting for the pages being loaded.
+     */
+    ~VirtualTexture();
+
+    VirtualTexture(VirtualTexture const&) = delete;
+    VirtualTexture& operator=(VirtualTexture const&) = delete;
+
+    /**
+     * Records the pages read back from the feedback pass.
+     *
+     * @param rgba8     RGBA8 texels, each encoding a PageId as a little-endian uint32. Texels
+     *                  equal to PageId::INVALID (white) are ignored.
+     * @param width     Width of the feedback buffer in texels.
+     * @param height    Height of the feedback buffer in texels.
+     * @param stride    Number of texels per row, or 0 if equal to width.
+     */
+    void addFeedback(void const* rgba8, uint32_t width, uint32_t height, uint32_t stride = 0);
+
+    /**
+     * Requests a page directly, e.g. to prefetch the pages around the camera.
+     */
+    void requestPage(PageId page);
+
+    /**
+     * Loads the requested pages, uploads the ones that are ready and updates the page table.
+     * Must be called once per frame on the engine's thread, before rendering.
+     */
+    void update();
+
+    /** Returns the physical page cache, or the virtual texture itself when isSparse(). */
+    Texture* getTexture() const noexcept { return mTexture; }
+
+    /** Returns the page table texture, with one level per level of pages (RGBA8). */
+    Texture* getPageTable() const noexcept { return mPageTable; }
+
+    /** Returns whether getTexture() is a sparse texture. */
+    bool isSparse() const noexcept { return mSparse; }
+
+    /** Returns the number of pages of level 0 horizontally and vertically. */
+    uint32_t getPageCountX() const noexcept;
+    uint32_t getPageCountY() const noexcept;
+
+    /** Returns the number of levels of pages, the last level has a single row or column. */
+    uint8_t getLevelCount() const noexcept;
+
+    Statistics getStatistics() const noexcept;
+
+private:
+    struct Impl;
+    Engine& mEngine;
+    Impl* mImpl;
+    Texture* mTexture = nullptr;
+    Texture* mPageTable = nullptr;
+    bool mSparse = false;
+};
+
+} // namespace filament::virtualtexture
+
+#endif // VIRTUALTEXTURE_VIRTUALTEXTURE_H
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <virtualtexture/VirtualTexture.h>
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Warray-bounds"
+#include <basisu_transcoder.h>
+#pragma clang diagnostic pop
+
+#include <utils/Log.h>
+
+#include <utility>
+#include <vector>
+
+using namespace basist;
+
+namespace filament::virtualtexture {
+
+VirtualTexture::PageLoader VirtualTexture::createKtx2Loader(FileFetcher fetch) {
+    // not thread-safe, so it's called here rather than from the loading jobs
+    basisu_transcoder_init();
+
+    return [fetch = std::move(fetch)](PageId const page, uint32_t const size, uint32_t,
+            uint8_t* const texels) -> bool {
+        std::vector<uint8_t> content;
+        if (!fetch(page, content)) {
+            return false;
+        }
+
+        // each page is transcoded by a single job, so every job uses its own transcoder
+        ktx2_transcoder transcoder;
+        if (!transcoder.init(content.data(), uint32_t(content.size()))) {
+            utils::slog.e << "VirtualTexture: page " << page.pack()
+                          << " is not a valid KTX2 file." << utils::io::endl;
+            return false;
+        }
+        if (transcoder.get_width() != size || transcoder.get_height() != size) {
+            utils::slog.e << "VirtualTexture: page " << page.pack() << " is "
+                          << transcoder.get_width() << "x" << transcoder.get_height()
+                          << ", expected " << size << "x" << size << utils::io::endl;
+            return false;
+        }
+        if (!transcoder.start_transcoding()) {
+            return false;
+        }
+
+        ktx2_transcoder_state state;
+        return transcoder.transcode_image_level(0, 0, 0, texels, size * size,
+                transcoder_texture_format::cTFRGBA32, 0, size, size, -1, -1, &state);
+    };
+}
+
+} // namespace filament::virtualtexture
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PageCache.h"
+
+#include <utils/debug.h>
+
+#include <algorithm>
+
+namespace filament::virtualtexture {
+
+PageCache::PageCache(uint32_t const pagesX, uint32_t const pagesY, uint32_t const slotCount)
+        : mPagesX(pagesX), mPagesY(pagesY), mSlots(slotCount) {
+    assert_invariant(pagesX && pagesY);
+    uint8_t levelCount = 1;
+    while ((std::max(pagesX, pagesY) >> levelCount) != 0) {
+        levelCount++;
+    }
+    mLevelCount = levelCount;
+    mResidency.resize(levelCount);
+    mPageTable.resize(levelCount);
+    for (uint8_t level = 0; level < levelCount; level++) {
+        size_t const count = size_t(getPageCountX(level)) * getPageCountY(level);
+        mResidency[level].resize(count, INVALID_SLOT);
+        mPageTable[level].resize(count, Mapping{ INVALID_SLOT, level });
+    }
+}
+
+bool PageCache::isValid(PageId const page) const noexcept {
+    return page.level < mLevelCount &&
+           page.x < getPageCountX(page.level) && page.y < getPageCountY(page.level);
+}
+
+uint32_t PageCache::getSlot(PageId const page) const noexcept {
+    assert_invariant(isValid(page));
+    return mResidency[page.level][getIndex(page)];
+}
+
+bool PageCache::touch(PageId const page) noexcept {
+    uint32_t const slot = getSlot(page);
+    if (slot == INVALID_SLOT) {
+        return false;
+    }
+    mSlots[slot].lastUsed = mFrame;
+    return true;
+}
+
+uint32_t PageCache::insert(PageId const page, bool const pinned,
+        std::optional<PageId>& evicted) noexcept {
+    assert_invariant(getSlot(page) == INVALID_SLOT);
+    evicted.reset();
+
+    // a free slot, or else the least recently used one
+    uint32_t best = INVALID_SLOT;
+    for (uint32_t i = 0, n = uint32_t(mSlots.size()); i < n; i++) {
+        Slot const& slot = mSlots[i];
+        if (!slot.occupied) {
+            best = i;
+            break;
+        }
+        if (slot.pinned || slot.lastUsed == mFrame) {
+            continue;
+        }
+        if (best == INVALID_SLOT || slot.lastUsed < mSlots[best].lastUsed) {
+            best = i;
+        }
+    }
+    if (best == INVALID_SLOT) {
+        return INVALID_SLOT;
+    }
+
+    Slot& slot = mSlots[best];
+    if (slot.occupied) {
+        mResidency[slot.page.level][getIndex(slot.page)] = INVALID_SLOT;
+        evicted = slot.page;
+    } else {
+        mResidentCount++;
+    }
+    slot = { page, mFrame, true, pinned };
+    mResidency[page.level][getIndex(page)] = best;
+    mPageTableDirty = true;
+    return best;
+}
+
+void PageCache::updatePageTable() noexcept {
+    // from the coarsest level, each page maps to itself if it's resident, or else to its parent
+    for (int level = mLevelCount - 1; level >= 0; level--) {
+        uint32_t const w = getPageCountX(level);
+        uint32_t const h = getPageCountY(level);
+        auto const& residency = mResidency[level];
+        auto& table = mPageTable[level];
+        for (uint32_t y = 0; y < h; y++) {
+            for (uint32_t x = 0; x < w; x++) {
+                size_t const i = size_t(y) * w + x;
+                if (residency[i] != INVALID_SLOT) {
+                    table[i] = { residency[i], uint8_t(level) };
+                } else if (level + 1 < mLevelCount) {
+                    uint32_t const parentWidth = getPageCountX(level + 1);
+                    uint32_t const px = std::min(x / 2, parentWidth - 1);
+                    uint32_t const py = std::min(y / 2, getPageCountY(level + 1) - 1);
+                    table[i] = mPageTable[level + 1][size_t(py) * parentWidth + px];
+                } else {
+                    table[i] = { INVALID_SLOT, uint8_t(level) };
+                }
+            }
+        }
+    }
+    mPageTableDirty = false;
+}
+
+} // namespace filament::virtualtexture
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VIRTUALTEXTURE_PAGECACHE_H
+#define VIRTUALTEXTURE_PAGECACHE_H
+
+#include <virtualtexture/VirtualTexture.h>
+
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+#include <stdint.h>
+
+namespace filament::virtualtexture {
+
+/*
+ * Tracks which pages of a virtual texture are resident, and in which slot of the physical cache,
+ * independently of the GPU resources.
+ *
+ * Pages are evicted least recently used first. Pages used during the current frame, and pinned
+ * pages, are never evicted.
+ */
+class PageCache {
+public:
+    static constexpr uint32_t INVALID_SLOT = 0xFFFFFFFFu;
+
+    // The page to sample for a page of the page table
+    struct Mapping {
+        uint32_t slot = INVALID_SLOT;   // slot of the finest resident page covering it
+        uint8_t level = 0;              // level of that page
+    };
+
+    // pagesX and pagesY are the number of pages of level 0, and must be powers of two
+    PageCache(uint32_t pagesX, uint32_t pagesY, uint32_t slotCount);
+
+    uint8_t getLevelCount() const noexcept { return mLevelCount; }
+
+    uint32_t getPageCountX(uint8_t const level) const noexcept {
+        return std::max(1u, mPagesX >> level);
+    }
+
+    uint32_t getPageCountY(uint8_t const level) const noexcept {
+        return std::max(1u, mPagesY >> level);
+    }
+
+    uint32_t getSlotCount() const noexcept { return uint32_t(mSlots.size()); }
+
+    uint32_t getResidentCount() const noexcept { return mResidentCount; }
+
+    bool isValid(PageId page) const noexcept;
+
+    // Starts a new frame, the pages not used since the previous one become evictable.
+    void beginFrame() noexcept { mFrame++; }
+
+    // Returns the slot of a page, or INVALID_SLOT if it's not resident.
+    uint32_t getSlot(PageId page) const noexcept;
+
+    // Marks a page as used during this frame. Returns whether it's resident.
+    bool touch(PageId page) noexcept;
+
+    // Reserves a slot for a page that isn't resident, evicting the least recently used page if
+    // needed, which is returned in evicted. Returns INVALID_SLOT if all the slots are in use.
+    uint32_t insert(PageId page, bool pinned, std::optional<PageId>& evicted) noexcept;
+
+    // Whether the page table changed since the last updatePageTable().
+    bool isPageTableDirty() const noexcept { return mPageTableDirty; }
+
+    // Resolves, for each page of each level, the finest resident page covering it.
+    void updatePageTable() noexcept;
+
+    // The page table of a level, getPageCountX(level) * getPageCountY(level) mappings, row by row.
+    Mapping const* getPageTable(uint8_t const level) const noexcept {
+        return mPageTable[level].data();
+    }
+
+private:
+    struct Slot {
+        PageId page;
+        uint64_t lastUsed = 0;
+        bool occupied = false;
+        bool pinned = false;
+    };
+
+    size_t getIndex(PageId const page) const noexcept {
+        return size_t(page.y) * getPageCountX(page.level) + page.x;
+    }
+
+    uint32_t mPagesX;
+    uint32_t mPagesY;
+    uint8_t mLevelCount;
+    uint32_t mResidentCount = 0;
+    uint64_t mFrame = 1;
+    bool mPageTableDirty = true;
+    std::vector<Slot> mSlots;
+    // for each level, the slot of each page or INVALID_SLOT
+    std::vector<std::vector<uint32_t>> mResidency;
+    std::vector<std::vector<Mapping>> mPageTable;
+};
+
+} // namespace filament::virtualtexture
+
+#endif // VIRTUALTEXTURE_PAGECACHE_H
@@ -0,0 +1,377 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <virtualtexture/VirtualTexture.h>
+
+#include "PageCache.h"
+
+#include <filament/Engine.h>
+#include <filament/Texture.h>
+
+#include <utils/compiler.h>
+#include <utils/JobSystem.h>
+#include <utils/Mutex.h>
+#include <utils/Panic.h>
+
+#include <tsl/robin_set.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <stdlib.h>
+
+using namespace utils;
+
+namespace filament::virtualtexture {
+
+namespace {
+
+void freeCallback(void* buffer, size_t, void*) {
+    free(buffer);
+}
+
+bool isPowerOfTwo(uint32_t const n) noexcept {
+    return n && !(n & (n - 1));
+}
+
+} // anonymous namespace
+
+struct VirtualTexture::Impl {
+    Impl(Config const& config, PageLoader&& loader) noexcept
+            : config(config),
+              loader(std::move(loader)),
+              cache(config.width / config.pageSize, config.height / config.pageSize,
+                      config.residentPageCount) {
+    }
+
+    struct LoadedPage {
+        PageId page;
+        uint8_t* texels;    // allocated with malloc(), nullptr if the page couldn't be loaded
+    };
+
+    void load(PageId page) noexcept;
+
+    Config const config;
+    PageLoader const loader;
+    PageCache cache;
+    uint32_t slotSize = 0;      // size of a page in the cache, including the borders
+    uint32_t border = 0;
+    uint32_t slotColumns = 1;
+
+    tsl::robin_set<uint32_t> requests;
+    // pages being loaded, or loaded but not uploaded yet
+    tsl::robin_set<uint32_t> pending;
+
+    Mutex lock;
+    std::vector<LoadedPage> loaded;     // guarded by lock
+
+    JobSystem::Job* rootJob = nullptr;
+    std::atomic<bool> cancelled = false;
+    Statistics statistics = {};
+};
+
+void VirtualTexture::Impl::load(PageId const page) noexcept {
+    uint8_t* texels = nullptr;
+    if (!cancelled.load(std::memory_order_relaxed)) {
+        texels = (uint8_t*) malloc(size_t(slotSize) * slotSize * 4);
+        if (!loader(page, slotSize, border, texels)) {
+            free(texels);
+            texels = nullptr;
+        }
+    }
+    std::lock_guard const guard(lock);
+    loaded.push_back({ page, texels });
+}
+
+VirtualTexture::VirtualTexture(Engine& engine, Config const& config, PageLoader loader)
+        : mEngine(engine) {
+    FILAMENT_CHECK_PRECONDITION(isPowerOfTwo(config.pageSize) &&
+            isPowerOfTwo(config.width) && isPowerOfTwo(config.height) &&
+            config.width >= config.pageSize && config.height >= config.pageSize)
+            << "VirtualTexture: the size of the texture and of its pages must be powers of two";
+
+    FILAMENT_CHECK_PRECONDITION(config.width / config.pageSize <= 0x4000 &&
+            config.height / config.pageSize <= 0x4000)
+            << "VirtualTexture: at most 16384 x 16384 pages are supported";
+
+    FILAMENT_CHECK_PRECONDITION(loader) << "VirtualTexture: a PageLoader is required";
+
+    mImpl = new Impl(config, std::move(loader));
+    Impl& impl = *mImpl;
+    PageCache& cache = impl.cache;
+
+    // the coarsest level must fit in the cache, with room to spare for the other pages
+    uint8_t const lastLevel = cache.getLevelCount() - 1;
+    uint32_t const pinnedCount = cache.getPageCountX(lastLevel) * cache.getPageCountY(lastLevel);
+    FILAMENT_CHECK_PRECONDITION(config.residentPageCount > pinnedCount)
+            << "VirtualTexture: residentPageCount must be larger than " << pinnedCount;
+
+    using Format = Texture::InternalFormat;
+    Format const format = config.sRGB ? Format::SRGB8_A8 : Format::RGBA8;
+    size_t const maxSize = Texture::getMaxTextureSize(engine, Texture::Sampler::SAMPLER_2D);
+
+    if (config.useSparseTexture && config.width <= maxSize && config.height <= maxSize) {
+        math::uint2 const page =
+                Texture::getSparsePageSize(engine, Texture::Sampler::SAMPLER_2D, format);
+        mSparse = page.x && page.y &&
+                  config.pageSize % page.x == 0 && config.pageSize % page.y == 0;
+    }
+
+    if (mSparse) {
+        // the pages are committed and uploaded in place, the hardware filters across them
+        impl.slotSize = config.pageSize;
+        mTexture = Texture::Builder()
+                .width(config.width)
+                .height(config.height)
+                .levels(cache.getLevelCount())
+                .format(format)
+                .usage(Texture::Usage::DEFAULT | Texture::Usage::SPARSE)
+                .build(engine);
+    } else {
+        impl.border = config.border;
+        impl.slotSize = config.pageSize + 2 * config.border;
+        impl.slotColumns = uint32_t(std::ceil(std::sqrt(float(config.residentPageCount))));
+        uint32_t const slotRows =
+                (config.residentPageCount + impl.slotColumns - 1) / impl.slotColumns;
+        FILAMENT_CHECK_PRECONDITION(impl.slotColumns <= 256 &&
+                impl.slotColumns * impl.slotSize <= maxSize &&
+                slotRows * impl.slotSize <= maxSize)
+                << "VirtualTexture: residentPageCount is too large for the maximum texture size";
+        mTexture = Texture::Builder()
+                .width(impl.slotColumns * impl.slotSize)
+                .height(slotRows * impl.slotSize)
+                .levels(1)
+                .format(format)
+                .build(engine);
+    }
+
+    mPageTable = Texture::Builder()
+            .width(cache.getPageCountX(0))
+            .height(cache.getPageCountY(0))
+            .levels(cache.getLevelCount())
+            .format(Format::RGBA8)
+            .build(engine);
+
+    JobSystem& js = engine.getJobSystem();
+    impl.rootJob = js.createJob();
+    // the loading jobs inherit this priority, so they don't compete with the frame's jobs
+    JobSystem::setPriority(impl.rootJob, JobSystem::JobPriority::BACKGROUND);
+
+    // the coarsest level is always resident
+    for (uint16_t y = 0; y < cache.getPageCountY(lastLevel); y++) {
+        for (uint16_t x = 0; x < cache.getPageCountX(lastLevel); x++) {
+            requestPage({ lastLevel, x, y });
+        }
+    }
+}
+
+VirtualTexture::~VirtualTexture() {
+    Impl& impl = *mImpl;
+    // the jobs that haven't started return immediately
+    impl.cancelled.store(true, std::memory_order_relaxed);
+    mEngine.getJobSystem().runAndWait(impl.rootJob);
+    for (auto const& page: impl.loaded) {
+        free(page.texels);
+    }
+    mEngine.destroy(mTexture);
+    mEngine.destroy(mPageTable);
+    delete mImpl;
+}
+
+uint32_t VirtualTexture::getPageCountX() const noexcept {
+    return mImpl->cache.getPageCountX(0);
+}
+
+uint32_t VirtualTexture::getPageCountY() const noexcept {
+    return mImpl->cache.getPageCountY(0);
+}
+
+uint8_t VirtualTexture::getLevelCount() const noexcept {
+    return mImpl->cache.getLevelCount();
+}
+
+VirtualTexture::Statistics VirtualTexture::getStatistics() const noexcept {
+    return mImpl->statistics;
+}
+
+void VirtualTexture::addFeedback(void const* rgba8, uint32_t const width, uint32_t const height,
+        uint32_t stride) {
+    stride = stride ? stride : width;
+    auto& requests = mImpl->requests;
+    uint8_t const* const texels = static_cast<uint8_t const*>(rgba8);
+    for (uint32_t y = 0; y < height; y++) {
+        uint8_t const* row = texels + size_t(y) * stride * 4;
+        // neighbouring texels usually request the same page
+        uint32_t previous = PageId::INVALID;
+        for (uint32_t x = 0; x < width; x++) {
+            uint32_t const id = uint32_t(row[x * 4]) | (uint32_t(row[x * 4 + 1]) << 8) |
+                 (uint32_t(row[x * 4 + 2]) << 16) | (uint32_t(row[x * 4 + 3]) << 24);
+            if (id != previous && id != PageId::INVALID) {
+                requests.insert(id);
+            }
+            previous = id;
+        }
+    }
+}
+
+void VirtualTexture::requestPage(PageId const page) {
+    mImpl->requests.insert(page.pack());
+}
+
+void VirtualTexture::update() {
+    Impl& impl = *mImpl;
+    PageCache& cache = impl.cache;
+    Config const& config = impl.config;
+    Statistics& statistics = impl.statistics;
+
+    cache.beginFrame();
+    statistics.requestCount = uint32_t(impl.requests.size());
+    statistics.uploadCount = 0;
+    statistics.evictionCount = 0;
+
+    // Keep the requested pages, and the ones sampled in their place, resident. The pages between a
+    // requested page and its first resident ancestor are missing.
+    std::vector<PageId> missing;
+    for (uint32_t const id: impl.requests) {
+        PageId page = PageId::unpack(id);
+        if (!cache.isValid(page)) {
+            continue;
+        }
+        while (!cache.touch(page)) {
+            if (impl.pending.find(page.pack()) == impl.pending.end()) {
+                missing.push_back(page);
+            }
+            if (page.level + 1 >= cache.getLevelCount()) {
+                break;
+            }
+            page = { uint8_t(page.level + 1), uint16_t(page.x / 2), uint16_t(page.y / 2) };
+        }
+    }
+    impl.requests.clear();
+
+    // load the coarsest pages first, they cover the most pixels
+    std::sort(missing.begin(), missing.end(), [](PageId const& lhs, PageId const& rhs) {
+        return lhs.level != rhs.level ? lhs.level > rhs.level : lhs.pack() < rhs.pack();
+    });
+    missing.erase(std::unique(missing.begin(), missing.end()), missing.end());
+
+    JobSystem& js = mEngine.getJobSystem();
+    for (PageId const page: missing) {
+        if (impl.pending.size() >= config.maxPendingLoads) {
+            break;
+        }
+        impl.pending.insert(page.pack());
+        if constexpr (UTILS_HAS_THREADING) {
+            js.run(jobs::createJob(js, impl.rootJob, [&impl, page] {
+                impl.load(page);
+            }));
+        } else {
+            impl.load(page);
+        }
+    }
+
+    // upload the loaded pages, within the budget
+    std::vector<Impl::LoadedPage> ready;
+    {
+        std::lock_guard const guard(impl.lock);
+        size_t const count = std::min(impl.loaded.size(), size_t(config.maxUploadsPerFrame));
+        ready.assign(impl.loaded.begin(), impl.loaded.begin() + count);
+        impl.loaded.erase(impl.loaded.begin(), impl.loaded.begin() + count);
+    }
+
+    uint8_t const lastLevel = cache.getLevelCount() - 1;
+    uint32_t const pageSize = config.pageSize;
+    for (auto const& [page, texels]: ready) {
+        impl.pending.erase(page.pack());
+        if (!texels) {
+            // it will be requested again
+            continue;
+        }
+        std::optional<PageId> evicted;
+        uint32_t const slot = cache.insert(page, page.level == lastLevel, evicted);
+        if (slot == PageCache::INVALID_SLOT) {
+            // all the resident pages are in use
+            free(texels);
+            continue;
+        }
+        statistics.uploadCount++;
+
+        size_t const size = size_t(impl.slotSize) * impl.slotSize * 4;
+        if (mSparse) {
+            // the pages of the smallest levels can be smaller than pageSize
+            auto const region = [&](PageId const p) {
+                uint32_t const w = std::max(1u, config.width >> p.level);
+                uint32_t const h = std::max(1u, config.height >> p.level);
+                return math::uint2{ std::min(pageSize, w - p.x * pageSize),
+                        std::min(pageSize, h - p.y * pageSize) };
+            };
+            if (evicted) {
+                statistics.evictionCount++;
+                math::uint2 const r = region(*evicted);
+                mTexture->decommitPages(mEngine, evicted->level,
+                        evicted->x * pageSize, evicted->y * pageSize, r.x, r.y);
+            }
+            math::uint2 const r = region(page);
+            mTexture->commitPages(mEngine, page.level,
+                    page.x * pageSize, page.y * pageSize, r.x, r.y);
+            mTexture->setImage(mEngine, page.level, page.x * pageSize, page.y * pageSize, r.x, r.y,
+                    Texture::PixelBufferDescriptor(texels, size,
+                            Texture::Format::RGBA, Texture::Type::UBYTE, 1, 0, 0, pageSize,
+                            freeCallback));
+        } else {
+            statistics.evictionCount += evicted ? 1 : 0;
+            uint32_t const x = (slot % impl.slotColumns) * impl.slotSize;
+            uint32_t const y = (slot / impl.slotColumns) * impl.slotSize;
+            mTexture->setImage(mEngine, 0, x, y, impl.slotSize, impl.slotSize,
+                    Texture::PixelBufferDescriptor(texels, size,
+                            Texture::Format::RGBA, Texture::Type::UBYTE, freeCallback));
+        }
+    }
+
+    statistics.residentPageCount = cache.getResidentCount();
+    statistics.pendingLoadCount = uint32_t(impl.pending.size());
+
+    if (!cache.isPageTableDirty()) {
+        return;
+    }
+
+    // texels are (slot.x, slot.y, level, resident)
+    cache.updatePageTable();
+    for (uint8_t level = 0; level < cache.getLevelCount(); level++) {
+        size_t const count = size_t(cache.getPageCountX(level)) * cache.getPageCountY(level);
+        PageCache::Mapping const* const table = cache.getPageTable(level);
+        uint8_t* const texels = (uint8_t*) malloc(count * 4);
+        for (size_t i = 0; i < count; i++) {
+            PageCache::Mapping const& mapping = table[i];
+            bool const resident = mapping.slot != PageCache::INVALID_SLOT;
+            uint32_t const slot = resident && !mSparse ? mapping.slot : 0;
+            texels[i * 4 + 0] = uint8_t(slot % impl.slotColumns);
+            texels[i * 4 + 1] = uint8_t(slot / impl.slotColumns);
+            texels[i * 4 + 2] = mapping.level;
+            texels[i * 4 + 3] = resident ? 0xFF : 0;
+        }
+        mPageTable->setImage(mEngine, level,
+                Texture::PixelBufferDescriptor(texels, count * 4,
+                        Texture::Format::RGBA, Texture::Type::UBYTE, freeCallback));
+    }
+}
+
+} // namespace filament::virtualtexture
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../src/PageCache.h"
+
+#include <gtest/gtest.h>
+
+#include <optional>
+
+using namespace filament::virtualtexture;
+
+class VirtualTextureTest : public testing::Test {};
+
+TEST_F(VirtualTextureTest, PageId) {
+    PageId const page{ 5, 1234, 16383 };
+    EXPECT_EQ(PageId::unpack(page.pack()), page);
+    EXPECT_EQ(PageId{}.pack(), 0u);
+    EXPECT_NE(page.pack(), PageId::INVALID);
+}
+
+TEST_F(VirtualTextureTest, Levels) {
+    PageCache const cache(8, 2, 4);
+    EXPECT_EQ(cache.getLevelCount(), 4);
+    EXPECT_EQ(cache.getPageCountX(3), 1u);
+    EXPECT_EQ(cache.getPageCountY(1), 1u);
+    EXPECT_TRUE(cache.isValid({ 1, 3, 0 }));
+    EXPECT_FALSE(cache.isValid({ 1, 4, 0 }));
+    EXPECT_FALSE(cache.isValid({ 4, 0, 0 }));
+}
+
+TEST_F(VirtualTextureTest, LeastRecentlyUsedEviction) {
+    PageCache cache(4, 4, 2);
+    std::optional<PageId> evicted;
+
+    cache.beginFrame();
+    EXPECT_EQ(cache.insert({ 0, 0, 0 }, false, evicted), 0u);
+    EXPECT_FALSE(evicted);
+    cache.beginFrame();
+    EXPECT_EQ(cache.insert({ 0, 1, 0 }, false, evicted), 1u);
+    EXPECT_FALSE(evicted);
+    EXPECT_EQ(cache.getResidentCount(), 2u);
+
+    // the pages used during the current frame can't be evicted
+    cache.beginFrame();
+    EXPECT_TRUE(cache.touch({ 0, 0, 0 }));
+    EXPECT_TRUE(cache.touch({ 0, 1, 0 }));
+    EXPECT_EQ(cache.insert({ 0, 2, 0 }, false, evicted), PageCache::INVALID_SLOT);
+
+    // (1, 0) was used more recently than (0, 0)
+    cache.beginFrame();
+    EXPECT_TRUE(cache.touch({ 0, 1, 0 }));
+    cache.beginFrame();
+    EXPECT_EQ(cache.insert({ 0, 2, 0 }, false, evicted), 0u);
+    ASSERT_TRUE(evicted);
+    EXPECT_EQ(*evicted, (PageId{ 0, 0, 0 }));
+    EXPECT_FALSE(cache.touch({ 0, 0, 0 }));
+    EXPECT_EQ(cache.getSlot({ 0, 2, 0 }), 0u);
+    EXPECT_EQ(cache.getResidentCount(), 2u);
+}
+
+TEST_F(VirtualTextureTest, PinnedPages) {
+    PageCache cache(2, 2, 2);
+    std::optional<PageId> evicted;
+    cache.beginFrame();
+    EXPECT_EQ(cache.insert({ 1, 0, 0 }, true, evicted), 0u);
+    EXPECT_EQ(cache.insert({ 0, 0, 0 }, false, evicted), 1u);
+    cache.beginFrame();
+    EXPECT_EQ(cache.insert({ 0, 1, 1 }, false, evicted), 1u);
+    ASSERT_TRUE(evicted);
+    EXPECT_EQ(*evicted, (PageId{ 0, 0, 0 }));
+    cache.beginFrame();
+    EXPECT_EQ(cache.insert({ 0, 0, 1 }, false, evicted), 1u);
+    EXPECT_EQ(cache.getSlot({ 1, 0, 0 }), 0u);
+}
+
+TEST_F(VirtualTextureTest, PageTableFallsBackToParent) {
+    PageCache cache(4, 4, 4);
+    std::optional<PageId> evicted;
+    EXPECT_TRUE(cache.isPageTableDirty());
+    cache.insert({ 2, 0, 0 }, true, evicted);   // slot 0
+    cache.insert({ 1, 1, 0 }, false, evicted);  // slot 1
+    cache.insert({ 0, 3, 3 }, false, evicted);  // slot 2
+    cache.updatePageTable();
+    EXPECT_FALSE(cache.isPageTableDirty());
+
+    auto const* level0 = cache.getPageTable(0);
+    // (0, 0) -> the coarsest level
+    EXPECT_EQ(level0[0].slot, 0u);
+    EXPECT_EQ(level0[0].level, 2);
+    // (2, 0) -> (1, 0) of level 1
+    EXPECT_EQ(level0[2].slot, 1u);
+    EXPECT_EQ(level0[2].level, 1);
+    // (3, 3) is resident
+    EXPECT_EQ(level0[15].slot, 2u);
+    EXPECT_EQ(level0[15].level, 0);
+
+    auto const* level1 = cache.getPageTable(1);
+    EXPECT_EQ(level1[1].slot, 1u);
+    EXPECT_EQ(level1[3].slot, 0u);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -67,6 +67,12 @@
 #include <sstream>
 #include <string>
 
+#if !defined(WIN32)
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <unistd.h>
+#endif
+
 #include "generated/resources/gltf_demo.h"
 #include "materials/uberarchive.h"
 
@@ -136,6 +142,7 @@ struct App {
     std::string messageBoxText;
     std::string settingsFile;
     std::string batchFile;
+    std::string timingsFile;
 
     AutomationSpec* automationSpec = nullptr;
     AutomationEngine* automationEngine = nullptr;
@@ -174,6 +181,9 @@ static void printUsage(char* name) {
         "       Start automation using the given JSON spec, then quit the app\n\n"
         "   --headless, -e\n"
         "       Use a headless swapchain; ignored if --batch is not present\n\n"
+        "   --timings=<path to JSON file>, -m <path>\n"
+        "       Measure the CPU and per-pass GPU timings of each automation test and write\n"
+        "       them to the given JSON file; ignored if --batch is not present\n\n"
         "   --ibl=<path>, -i <path>\n"
         "       Override the built-in IBL\n"
         "       path can either be a directory containing IBL data files generated by cmgen,\n"
@@ -220,13 +230,14 @@ static std::ifstream::pos_type getFileSize(const char* filename) {
 }
 
 static int handleCommandLineArguments(int argc, char* argv[], App* app) {
-    static constexpr const char* OPTSTR = "ha:f:i:usc:rt:b:evg:d";
+    static constexpr const char* OPTSTR = "ha:f:i:usc:rt:b:evg:dm:";
     static const struct option OPTIONS[] = {
         { "help",              no_argument,          nullptr, 'h' },
         { "api",               required_argument,    nullptr, 'a' },
         { "feature-level",     required_argument,    nullptr, 'f' },
         { "batch",             required_argument,    nullptr, 'b' },
         { "headless",          no_argument,          nullptr, 'e' },
+        { "timings",           required_argument,    nullptr, 'm' },
         { "ibl",               required_argument,    nullptr, 'i' },
         { "ubershader",        no_argument,          nullptr, 'u' },
         { "actual-size",       no_argument,          nullptr, 's' },
@@ -326,6 +337,10 @@ static int handleCommandLineArguments(int argc, char* argv[], App* app) {
                 app->screenshotAsPPM = true;
                 break;
             }
+            case 'm': {
+                app->timingsFile = arg;
+                break;
+            }
         }
     }
     if (app->config.headless && app->batchFile.empty()) {
@@ -627,16 +642,36 @@ int main(int argc, char** argv) {
             exit(1);
         }
 
-        // Consume the glTF file.
-        std::ifstream in(filename.c_str(), std::ifstream::binary | std::ifstream::in);
-        std::vector<uint8_t> buffer(static_cast<unsigned long>(contentSize));
-        if (!in.read((char*) buffer.data(), contentSize)) {
-            std::cerr << "Unable to read " << filename << std::endl;
-            exit(1);
+        // Map the glTF file, the asset uses it in place and unmaps it once it no longer needs it.
+        void* mapping = nullptr;
+#if !defined(WIN32)
+        int const fd = open(filename.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            mapping = mmap(nullptr, size_t(contentSize), PROT_READ, MAP_PRIVATE, fd, 0);
+            mapping = mapping == MAP_FAILED ? nullptr : mapping;
+            close(fd);
         }
+#endif
 
-        // Parse the glTF file and create Filament entities.
-        app.asset = app.assetLoader->createAsset(buffer.data(), buffer.size());
+        if (mapping) {
+            app.asset = app.assetLoader->createAsset((uint8_t const*) mapping, contentSize,
+                    [](void const* bytes, size_t nbytes, void*) {
+#if !defined(WIN32)
+                        munmap(const_cast<void*>(bytes), nbytes);
+#endif
+                    });
+        } else {
+            // Consume the glTF file.
+            std::ifstream in(filename.c_str(), std::ifstream::binary | std::ifstream::in);
+            std::vector<uint8_t> buffer(static_cast<unsigned long>(contentSize));
+            if (!in.read((char*) buffer.data(), contentSize)) {
+                std::cerr << "Unable to read " << filename << std::endl;
+                exit(1);
+            }
+
+            // Parse the glTF file and create Filament entities.
+            app.asset = app.assetLoader->createAsset(buffer.data(), buffer.size());
+        }
         if (!app.asset) {
             std::cerr << "Unable to parse " << filename << std::endl;
             exit(1);
@@ -779,6 +814,10 @@ int main(int argc, char** argv) {
             options.exportFormat = app.screenshotAsPPM
                                            ? AutomationEngine::Options::ExportFormat::PPM
                                            : AutomationEngine::Options::ExportFormat::TIFF;
+            if (!app.timingsFile.empty()) {
+                options.exportTimings = true;
+                options.timingsFilename = app.timingsFile;
+            }
             app.automationEngine->setOptions(options);
             app.viewer->stopAnimation();
         }
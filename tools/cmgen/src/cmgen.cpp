@@ -37,6 +37,7 @@
 #include <math/vec4.h>
 
 #include <cmath>
+#include <atomic>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -108,6 +109,12 @@ static size_t g_num_samples = 1024;
 
 static bool g_mirror = false;
 
+static utils::Path g_batch_filename;
+
+static utils::JobSystem* g_save_js = nullptr;
+static utils::JobSystem::Job* g_save_jobs = nullptr;     // parent of the pending saveImage() jobs
+static std::atomic<bool> g_save_failed = false;
+
 // -----------------------------------------------------------------------------------------------
 
 static void generateMipmaps(utils::JobSystem& js, std::vector<Cubemap>& levels,
@@ -135,6 +142,9 @@ static void UTILS_UNUSED outputSpectrum(std::ostream& out,
         const std::unique_ptr<filament::math::float3[]>& sh, size_t numBands);
 static void saveImage(const std::string& path, ImageEncoder::Format format, const Image& image,
         const std::string& compression);
+static void beginSaving(utils::JobSystem& js);
+static bool finishSaving();
+static bool readBatchFile(const utils::Path& filename, std::vector<utils::Path>* inputs);
 static LinearImage toLinearImage(const Image& image);
 static void exportKtxFaces(Ktx1Bundle& container, uint32_t miplevel, const Cubemap& cm);
 
@@ -148,8 +158,9 @@ static void printUsage(char* name) {
             "according to the aspect ratio of the source image.\n"
             "\n"
             "Usages:\n"
-            "    CMGEN [options] <input-file>\n"
+            "    CMGEN [options] <input-file> [<input-file>...]\n"
             "    CMGEN [options] <uv[N]>\n"
+            "    CMGEN [options] --batch=<batch-file>\n"
             "\n"
             "Supported input formats:\n"
             "    PNG, 8 and 16 bits\n"
@@ -224,6 +235,10 @@ static void printUsage(char* name) {
             "       SH windowing to reduce ringing\n\n"
             "   --debug, -d\n"
             "       Generate extra data for debugging\n\n"
+            "   --batch=filename\n"
+            "       Process all the inputs listed in <filename>, one per line, with the same\n"
+            "       options. Outputs are written in a folder per input, except for --sh-output\n"
+            "       which is only per input with --deploy\n\n"
     );
     const std::string from("CMGEN");
     for (size_t pos = usage.find(from); pos != std::string::npos; pos = usage.find(from, pos)) {
@@ -273,6 +288,7 @@ static int handleCommandLineArgments(int argc, char* argv[]) {
             { "deploy",               required_argument, nullptr, 'x' },
             { "no-mirror",                  no_argument, nullptr, 'm' },
             { "debug",                      no_argument, nullptr, 'd' },
+            { "batch",                required_argument, nullptr, 'j' },
             { nullptr, 0, nullptr, 0 }  // termination of the option list
     };
     int opt;
@@ -452,6 +468,9 @@ static int handleCommandLineArgments(int argc, char* argv[]) {
             case 'm':
                 g_mirror = true;
                 break;
+            case 'j':
+                g_batch_filename = arg;
+                break;
         }
     }
 
@@ -474,28 +493,33 @@ static int handleCommandLineArgments(int argc, char* argv[]) {
     return optind;
 }
 
-int main(int argc, char* argv[]) {
-    utils::JobSystem js;
-    js.adopt();
-
-    int option_index = handleCommandLineArgments(argc, argv);
-    int num_args = argc - option_index;
-    if (!g_dfg && num_args < 1) {
-        printUsage(argv[0]);
-        return 1;
+// Decodes the given input image. Inputs that don't exist are generated patterns, for which the
+// image is left invalid.
+static bool decodeInput(const utils::Path& iname, LinearImage* image) {
+    if (!iname.exists()) {
+        return true;
     }
-
-    if (g_dfg) {
-        if (!g_quiet) {
-            std::cout << "Generating IBL DFG LUT..." << std::endl;
-        }
-        size_t size = g_output_size ? g_output_size : DFG_LUT_DEFAULT_SIZE;
-        iblLutDfg(js, g_dfg_filename, size, g_dfg_multiscatter, g_dfg_cloth);
-        if (num_args < 1) return 0;
+    if (!g_quiet) {
+        std::cout << "Decoding image..." << std::endl;
+    }
+    std::ifstream input_stream(iname.getPath(), std::ios::binary);
+    *image = ImageDecoder::decode(input_stream, iname.getPath());
+    if (!image->isValid()) {
+        std::cerr << "Unable to open image: " << iname.getPath() << std::endl;
+        return false;
+    }
+    if (image->getChannels() != 3) {
+        std::cerr << "Input image must be RGB (3 channels)! This image has "
+                  << image->getChannels() << " channels." << std::endl;
+        return false;
     }
+    return true;
+}
 
-    std::string command(argv[option_index]);
-    utils::Path iname(command);
+// Generates all the requested outputs for one input, returns the exit code of the tool.
+static int processInput(utils::JobSystem& js, const utils::Path& iname,
+        const LinearImage& linputImage) {
+    beginSaving(js);
 
     if (g_deploy) {
         utils::Path sh_dir = g_deploy_dir;
@@ -532,22 +556,7 @@ int main(int argc, char* argv[]) {
     // Cubemaps are just views on Images
     std::vector<Cubemap> levels;
 
-    if (iname.exists()) {
-        if (!g_quiet) {
-            std::cout << "Decoding image..." << std::endl;
-        }
-        std::ifstream input_stream(iname.getPath(), std::ios::binary);
-        LinearImage linputImage = ImageDecoder::decode(input_stream, iname.getPath());
-        if (!linputImage.isValid()) {
-            std::cerr << "Unable to open image: " << iname.getPath() << std::endl;
-            exit(1);
-        }
-        if (linputImage.getChannels() != 3) {
-            std::cerr << "Input image must be RGB (3 channels)! This image has "
-                      << linputImage.getChannels() << " channels." << std::endl;
-            exit(1);
-        }
-
+    if (linputImage.isValid()) {
         // Convert from LinearImage to the deprecated Image object which is used throughout cmgen.
         const size_t width = linputImage.getWidth(), height = linputImage.getHeight();
         Image inputImage(width, height);
@@ -587,7 +596,8 @@ int main(int argc, char* argv[]) {
             std::cerr << "  2:1, lat/long or equirectangular" << std::endl;
             std::cerr << "  3:4, vertical cross (height must be power of two)" << std::endl;
             std::cerr << "  4:3, horizontal cross (width must be power of two)" << std::endl;
-            exit(0);
+            finishSaving();
+            return 1;
         }
     } else {
         if (!g_quiet) {
@@ -618,8 +628,8 @@ int main(int argc, char* argv[]) {
     }
 
     // we mirror by default -- the mirror option in fact un-mirrors.
-    g_mirror = !g_mirror;
-    if (g_mirror) {
+    const bool mirror = !g_mirror;
+    if (mirror) {
         if (!g_quiet) {
             std::cout << "Mirroring..." << std::endl;
         }
@@ -701,7 +711,74 @@ int main(int argc, char* argv[]) {
         }
     }
 
-    return 0;
+    return finishSaving() ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    utils::JobSystem js;
+    js.adopt();
+
+    int option_index = handleCommandLineArgments(argc, argv);
+    int num_args = argc - option_index;
+    if (!g_dfg && num_args < 1 && g_batch_filename.isEmpty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (g_dfg) {
+        if (!g_quiet) {
+            std::cout << "Generating IBL DFG LUT..." << std::endl;
+        }
+        size_t size = g_output_size ? g_output_size : DFG_LUT_DEFAULT_SIZE;
+        beginSaving(js);
+        iblLutDfg(js, g_dfg_filename, size, g_dfg_multiscatter, g_dfg_cloth);
+        if (!finishSaving()) return 1;
+        if (num_args < 1 && g_batch_filename.isEmpty()) return 0;
+    }
+
+    std::vector<utils::Path> inputs;
+    for (int i = option_index; i < argc; i++) {
+        inputs.emplace_back(argv[i]);
+    }
+    if (!g_batch_filename.isEmpty() && !readBatchFile(g_batch_filename, &inputs)) {
+        return 1;
+    }
+
+    // The SH output options are resolved for each input in deploy mode.
+    const ShFile sh_file = g_sh_file;
+    const utils::Path sh_filename = g_sh_filename;
+
+    // Inputs are processed one at a time, each of them using the whole JobSystem, while the next
+    // one is decoded in the background.
+    LinearImage decoded[2];
+    bool decodedOk[2] = {};
+    auto decode = [&](size_t index) {
+        return js.runAndRetain(utils::jobs::createJob(js, nullptr, [&, index]() {
+            decodedOk[index % 2] = decodeInput(inputs[index], &decoded[index % 2]);
+        }));
+    };
+    size_t failures = 0;
+    utils::JobSystem::Job* pending = inputs.empty() ? nullptr : decode(0);
+    for (size_t i = 0; i < inputs.size(); i++) {
+        js.waitAndRelease(pending);
+        const LinearImage image = decoded[i % 2];
+        const bool ok = decodedOk[i % 2];
+        decoded[i % 2].reset();
+        if (i + 1 < inputs.size()) {
+            pending = decode(i + 1);
+        }
+        g_sh_file = sh_file;
+        g_sh_filename = sh_filename;
+        if (!ok || processInput(js, inputs[i], image) != 0) {
+            std::cerr << "Failed to process " << inputs[i].getPath() << std::endl;
+            failures++;
+        }
+    }
+    if (inputs.size() > 1) {
+        std::cout << "Processed " << inputs.size() << " inputs, " << failures << " failed."
+                  << std::endl;
+    }
+    return failures ? 1 : 0;
 }
 
 void generateMipmaps(utils::JobSystem& js, std::vector<Cubemap>& levels,
@@ -1269,12 +1346,50 @@ static LinearImage toLinearImage(const Image& image) {
     return linearImage;
 }
 
+// Images are encoded and written in the background, so that the next stage doesn't wait for the
+// disk. The image is copied first, because it is often a view on a temporary cubemap.
 static void saveImage(const std::string& path, ImageEncoder::Format format, const Image& image,
         const std::string& compression) {
-    std::ofstream outputStream(path, std::ios::binary | std::ios::trunc);
-    if (!ImageEncoder::encode(outputStream, format, toLinearImage(image), compression, path)) {
-        exit(1);
+    assert_invariant(g_save_jobs);
+    LinearImage linearImage = toLinearImage(image);
+    utils::JobSystem::Job* job = utils::jobs::createJob(*g_save_js, g_save_jobs,
+            [path, format, linearImage, compression]() {
+                std::ofstream outputStream(path, std::ios::binary | std::ios::trunc);
+                if (!ImageEncoder::encode(outputStream, format, linearImage, compression, path)) {
+                    g_save_failed = true;
+                }
+            });
+    g_save_js->run(job);
+}
+
+static void beginSaving(utils::JobSystem& js) {
+    g_save_js = &js;
+    g_save_jobs = js.createJob();
+}
+
+// Waits for all the images passed to saveImage() to be written, returns false if any failed.
+static bool finishSaving() {
+    g_save_js->runAndWait(g_save_jobs);
+    g_save_jobs = nullptr;
+    return !g_save_failed.exchange(false);
+}
+
+// Reads the inputs of a batch file, one per line, skipping empty lines and comments.
+static bool readBatchFile(const utils::Path& filename, std::vector<utils::Path>* inputs) {
+    std::ifstream input(filename.getPath());
+    if (!input) {
+        std::cerr << "Unable to open batch file: " << filename << std::endl;
+        return false;
+    }
+    std::string line;
+    while (std::getline(input, line)) {
+        std::istringstream fields(line);
+        std::string path;
+        if (fields >> path && path[0] != '#') {
+            inputs->emplace_back(path);
+        }
     }
+    return true;
 }
 
 static void exportKtxFaces(Ktx1Bundle& container, uint32_t miplevel, const Cubemap& cm) {
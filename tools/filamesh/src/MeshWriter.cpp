@@ -20,6 +20,8 @@
 
 #include <meshoptimizer.h>
 
+#include <algorithm>
+
 using namespace filamesh;
 using namespace filament::math;
 using namespace std;
@@ -48,11 +50,27 @@ void MeshWriter::optimize(Mesh& mesh) {
         exit(1);
     }
 
-    // First, re-order triangles to improve cache locality and reduce the number of VS invocations.
+    const uint32_t vertexCount = mesh.vertexCount;
+
+    // The overdraw optimizer sorts clusters of triangles by their orientation and position, so it
+    // needs the positions as floats rather than half-floats.
+    vector<float3> positions(vertexCount);
+    for (uint32_t i = 0; i < vertexCount; i++) {
+        positions[i] = float3((mFlags & INTERLEAVED) ?
+                mesh.vertices[i].position.xyz : mesh.positions[i].xyz);
+    }
+
+    // First, re-order triangles to improve cache locality and reduce the number of VS invocations,
+    // then re-order clusters of triangles to reduce overdraw without hurting the cache too much.
     // Note that assimp already has aiProcess_ImproveCacheLocality, but MeshWriter doesn't know
     // about assimp, and it doesn't hurt to do it again here since this generally runs offline.
-    meshopt_optimizeVertexCache(mesh.indices.data(), mesh.indices.data(), mesh.indices.size(),
-                mesh.vertexCount);
+    // Each part is a range of the index buffer, so triangles must stay within their part.
+    for (const Part& part : mesh.parts) {
+        uint32_t* indices = mesh.indices.data() + part.offset;
+        meshopt_optimizeVertexCache(indices, indices, part.indexCount, vertexCount);
+        meshopt_optimizeOverdraw(indices, indices, part.indexCount, &positions[0].x, vertexCount,
+                sizeof(float3), 1.05f);
+    }
 
     // At this point, triangle order has been established but we still need to shuffle vertices to
     // optimize the fetch. This makes it so that lower-numbered indices generally come before
@@ -62,8 +80,6 @@ void MeshWriter::optimize(Mesh& mesh) {
                 mesh.indices.size(), mesh.vertices.data(), mesh.vertices.size(),
                 sizeof(Vertex));
     } else {
-        const uint32_t vertexCount = mesh.vertexCount;
-
         // Allocate a remapping table and create a copy of the index buffer.
         vector<uint32_t> remappingVector(vertexCount);
         vector<uint32_t> indicesVector = mesh.indices;
@@ -90,6 +106,14 @@ void MeshWriter::optimize(Mesh& mesh) {
         }
     }
 
+    // Vertices have moved, so the index range of each part must be recomputed.
+    for (Part& part : mesh.parts) {
+        const auto first = mesh.indices.begin() + part.offset;
+        const auto [minIndex, maxIndex] = minmax_element(first, first + part.indexCount);
+        part.minIndex = *minIndex;
+        part.maxIndex = *maxIndex;
+    }
+
     // As a last step, the meshoptimizer README recommends applying individual meshopt_quantize*
     // functions as needed, but we actually already quantized the data according to our constraints
     // e.g. we already (potentially) use snorm16 for uvs, half-floats for tangents, etc.
@@ -86,6 +86,23 @@ static void usage(char* name) {
             "           directionalLighting, dynamicLighting, shadowReceiver, skinning, vsm, fog,"
             "           ssr (screen-space reflections), stereo\n"
             "       This variant filter is merged with the filter from the material, if any\n\n"
+            "   --cache-dir=<dir>, -C <dir>\n"
+            "       Cache the compiled shaders in the given directory, which can be shared by\n"
+            "       many materials. Unchanged shaders are then not compiled again.\n"
+            "       The cache must be cleared when matc is updated.\n\n"
+            "   --metallib, -M\n"
+            "       Also store precompiled Metal libraries, built with the Xcode command line\n"
+            "       tools for iOS (mobile) and macOS (desktop). The MSL source is kept as a\n"
+            "       fallback, and is the only one stored if the libraries can't be built.\n\n"
+            "   --spirv-opt=<passes>, -Y <passes>\n"
+            "       Additional spirv-opt passes run after the optimization level's own, e.g.:\n"
+            "           MATC --spirv-opt=\"--loop-unroll --strength-reduction\" ...\n\n"
+            "   --profile=<file>, -j <file>\n"
+            "       Write the compilation time and output size of each variant to the given file,\n"
+            "       in JSON. Sizes are measured before the shaders are deduplicated.\n\n"
+            "   --compress, -z\n"
+            "       Compress the shader dictionaries with zstd, the material can only be loaded\n"
+            "       by runtimes built with FILAMENT_SUPPORTS_COMPRESSED_MATERIALS\n\n"
             "   --version, -v\n"
             "       Print the material version number\n\n"
             "Internal use and debugging only:\n"
@@ -181,7 +198,7 @@ static void parseDefine(std::string defineString, Config::StringReplacementMap&
 }
 
 bool CommandlineConfig::parse() {
-    static constexpr const char* OPTSTR = "hLxo:f:dm:a:l:p:D:T:P:OSEr:vV:gtwF1R";
+    static constexpr const char* OPTSTR = "hLxo:f:dm:a:l:p:D:T:P:OSEr:vV:gtwF1RzC:j:MY:";
     static const struct option OPTIONS[] = {
             { "help",                    no_argument, nullptr, 'h' },
             { "license",                 no_argument, nullptr, 'L' },
@@ -207,6 +224,11 @@ bool CommandlineConfig::parse() {
             { "raw",                     no_argument, nullptr, 'w' },
             { "no-sampler-validation",   no_argument, nullptr, 'F' },
             { "save-raw-variants",       no_argument, nullptr, 'R' },
+            { "compress",                no_argument, nullptr, 'z' },
+            { "cache-dir",         required_argument, nullptr, 'C' },
+            { "profile",           required_argument, nullptr, 'j' },
+            { "metallib",                no_argument, nullptr, 'M' },
+            { "spirv-opt",         required_argument, nullptr, 'Y' },
             { nullptr, 0, nullptr, 0 }  // termination of the option list
     };
 
@@ -334,6 +356,21 @@ bool CommandlineConfig::parse() {
             case 'R':
                 mSaveRawVariants = true;
                 break;
+            case 'z':
+                mCompressDictionaries = true;
+                break;
+            case 'C':
+                mShaderCacheDirectory = arg;
+                break;
+            case 'j':
+                mShaderStatsFile = arg;
+                break;
+            case 'M':
+                mCompileMetalLibraries = true;
+                break;
+            case 'Y':
+                mSpirvOptimizerPasses = arg;
+                break;
         }
     }
 
@@ -25,6 +25,7 @@
 #include <map>
 #include <memory>
 #include <ostream>
+#include <string>
 
 #include <utils/compiler.h>
 
@@ -123,6 +124,26 @@ public:
         return mNoSamplerValidation;
     }
 
+    bool compressDictionaries() const noexcept {
+        return mCompressDictionaries;
+    }
+
+    std::string const& getShaderCacheDirectory() const noexcept {
+        return mShaderCacheDirectory;
+    }
+
+    std::string const& getShaderStatsFile() const noexcept {
+        return mShaderStatsFile;
+    }
+
+    bool compileMetalLibraries() const noexcept {
+        return mCompileMetalLibraries;
+    }
+
+    std::string const& getSpirvOptimizerPasses() const noexcept {
+        return mSpirvOptimizerPasses;
+    }
+
     bool includeEssl1() const noexcept {
         return mIncludeEssl1;
     }
@@ -154,6 +175,11 @@ protected:
     bool mRawShaderMode = false;
     bool mNoSamplerValidation = false;
     bool mSaveRawVariants = false;
+    bool mCompressDictionaries = false;
+    std::string mShaderCacheDirectory;
+    std::string mShaderStatsFile;
+    bool mCompileMetalLibraries = false;
+    std::string mSpirvOptimizerPasses;
     Optimization mOptimizationLevel = Optimization::PERFORMANCE;
     Metadata mReflectionTarget = Metadata::NONE;
     Platform mPlatform = Platform::ALL;
@@ -16,8 +16,11 @@
 
 #include "MaterialCompiler.h"
 
+#include <algorithm>
+#include <fstream>
 #include <memory>
 #include <iostream>
+#include <tuple>
 #include <utility>
 
 #include <filamat/MaterialBuilder.h>
@@ -30,6 +33,7 @@
 #include "DirIncluder.h"
 #include "MaterialLexeme.h"
 #include "MaterialLexer.h"
+#include "MetalLibraryCompiler.h"
 #include "JsonishLexer.h"
 #include "JsonishParser.h"
 #include "ParametersProcessor.h"
@@ -255,6 +259,77 @@ static bool reflectParameters(const MaterialBuilder& builder) {
     return true;
 }
 
+static const char* toString(filament::backend::ShaderStage const stage) noexcept {
+    switch (stage) {
+        case filament::backend::ShaderStage::VERTEX:    return "vertex";
+        case filament::backend::ShaderStage::FRAGMENT:  return "fragment";
+        case filament::backend::ShaderStage::COMPUTE:   return "compute";
+    }
+    return "";
+}
+
+static const char* toString(MaterialBuilder::TargetApi const api) noexcept {
+    switch (api) {
+        case MaterialBuilder::TargetApi::OPENGL:    return "opengl";
+        case MaterialBuilder::TargetApi::VULKAN:    return "vulkan";
+        case MaterialBuilder::TargetApi::METAL:     return "metal";
+        case MaterialBuilder::TargetApi::WEBGPU:    return "webgpu";
+        case MaterialBuilder::TargetApi::ALL:       return "all";
+    }
+    return "";
+}
+
+// Writes the compilation statistics of each variant as JSON.
+static bool writeShaderStats(const MaterialBuilder& builder, const Package& package,
+        const char* name, const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Unable to create shader stats file " << path << std::endl;
+        return false;
+    }
+
+    auto stats = builder.getShaderStats();
+    std::sort(stats.begin(), stats.end(), [](auto const& lhs, auto const& rhs) {
+        return std::tie(lhs.targetApi, lhs.shaderModel, lhs.featureLevel, lhs.variant, lhs.stage) <
+               std::tie(rhs.targetApi, rhs.shaderModel, rhs.featureLevel, rhs.variant, rhs.stage);
+    });
+
+    out << "{" << std::endl;
+    out << R"(  "name": ")" << name << "\"," << std::endl;
+    out << R"(  "packageSize": )" << package.getSize() << "," << std::endl;
+    out << R"(  "variants": [)" << std::endl;
+    for (size_t i = 0; i < stats.size(); i++) {
+        auto const& item = stats[i];
+        out << "    {" << std::endl;
+        out << R"(      "variant": )" << +item.variant << "," << std::endl;
+        out << R"(      "stage": ")" << toString(item.stage) << "\"," << std::endl;
+        out << R"(      "shaderModel": ")"
+            << (item.shaderModel == filament::backend::ShaderModel::MOBILE ? "mobile" : "desktop")
+            << "\"," << std::endl;
+        out << R"(      "api": ")" << toString(item.targetApi) << "\"," << std::endl;
+        out << R"(      "language": ")"
+            << (item.targetLanguage == MaterialBuilder::TargetLanguage::GLSL ? "glsl" : "spirv")
+            << "\"," << std::endl;
+        out << R"(      "featureLevel": )" << +item.featureLevel << "," << std::endl;
+        out << R"(      "cached": )" << (item.cached ? "true" : "false") << "," << std::endl;
+        out << R"(      "timeUs": { "generate": )" << item.generateTime
+            << R"(, "parse": )" << item.parseTime
+            << R"(, "optimize": )" << item.optimizeTime
+            << R"(, "minify": )" << item.minifyTime
+            << R"(, "total": )" << item.totalTime << " }," << std::endl;
+        out << R"(      "size": { "glsl": )" << item.glslSize
+            << R"(, "spirv": )" << item.spirvSize
+            << R"(, "msl": )" << item.mslSize
+            << R"(, "wgsl": )" << item.wgslSize << " }" << std::endl;
+        out << "    }";
+        if (i < stats.size() - 1) out << ",";
+        out << std::endl;
+    }
+    out << "  ]" << std::endl;
+    out << "}" << std::endl;
+    return bool(out);
+}
+
 bool MaterialCompiler::isValidJsonStart(const char* buffer, size_t size) const noexcept {
     // Skip all whitespace characters.
     const char* end = buffer + size;
@@ -402,6 +477,10 @@ bool MaterialCompiler::run(const Config& config) {
 
     builder
         .noSamplerValidation(config.noSamplerValidation())
+        .compressDictionaries(config.compressDictionaries())
+        .shaderCacheDirectory(config.getShaderCacheDirectory().c_str())
+        .collectShaderStats(!config.getShaderStatsFile().empty())
+        .spirvOptimizerPasses(config.getSpirvOptimizerPasses().c_str())
         .includeEssl1(config.includeEssl1())
         .includeCallback(includer)
         .fileName(materialFilePath.getName().c_str())
@@ -413,6 +492,10 @@ bool MaterialCompiler::run(const Config& config) {
         .generateDebugInfo(config.isDebug())
         .variantFilter(config.getVariantFilter() | builder.getVariantFilter());
 
+    if (config.compileMetalLibraries()) {
+        builder.metalLibraryCompiler(compileMetalLibrary);
+    }
+
     for (const auto& define : config.getDefines()) {
         builder.shaderDefine(define.first.c_str(), define.second.c_str());
     }
@@ -435,6 +518,12 @@ bool MaterialCompiler::run(const Config& config) {
         std::cerr << "Could not compile material " << input->getName() << std::endl;
         return false;
     }
+    if (!config.getShaderStatsFile().empty()) {
+        if (!writeShaderStats(builder, package, materialFilePath.getName().c_str(),
+                config.getShaderStatsFile())) {
+            return false;
+        }
+    }
     return writePackage(package, config);
 }
 
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MetalLibraryCompiler.h"
+
+#include <utils/Path.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+
+#include <stdint.h>
+
+namespace matc {
+
+using namespace filament::backend;
+
+namespace {
+
+// Removes the file when going out of scope.
+class ScopedTempFile {
+public:
+    explicit ScopedTempFile(utils::Path path) noexcept : mPath(std::move(path)) {}
+    ~ScopedTempFile() noexcept { std::remove(mPath.c_str()); }
+    ScopedTempFile(const ScopedTempFile& rhs) = delete;
+    ScopedTempFile& operator=(const ScopedTempFile& rhs) = delete;
+    utils::Path const& getPath() const noexcept { return mPath; }
+private:
+    utils::Path mPath;
+};
+
+} // anonymous namespace
+
+bool compileMetalLibrary(std::string const& msl, ShaderModel shaderModel, ShaderStage,
+        std::vector<uint8_t>& library) {
+    // variants, and materials in other matc processes, are compiled concurrently, each one
+    // needs its own files
+    static const uint32_t sProcessId = std::random_device{}();
+    static std::atomic_uint32_t sIndex{ 0 };
+    std::string const name = "matc_" + std::to_string(sProcessId) + "_" +
+            std::to_string(sIndex++);
+
+    utils::Path const tempDir = utils::Path::getTemporaryDirectory();
+    ScopedTempFile const source(tempDir + (name + ".metal"));
+    ScopedTempFile const air(tempDir + (name + ".air"));
+    ScopedTempFile const output(tempDir + (name + ".metallib"));
+
+    {
+        std::ofstream out(source.getPath().c_str(), std::ofstream::binary);
+        out << msl;
+        if (!out) {
+            return false;
+        }
+    }
+
+    const char* const sdk = shaderModel == ShaderModel::MOBILE ? "iphoneos" : "macosx";
+    std::string const xcrun = std::string("xcrun -sdk ") + sdk;
+    std::string const command =
+            xcrun + " metal -c \"" + source.getPath().getPath() +
+            "\" -o \"" + air.getPath().getPath() + "\" && " +
+            xcrun + " metallib \"" + air.getPath().getPath() +
+            "\" -o \"" + output.getPath().getPath() + "\"";
+    if (std::system(command.c_str()) != 0) {
+        std::cerr << "Unable to compile a Metal library with: " << command << std::endl;
+        return false;
+    }
+
+    std::ifstream in(output.getPath().c_str(), std::ifstream::binary);
+    if (!in) {
+        return false;
+    }
+    library.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return !library.empty();
+}
+
+} // namespace matc
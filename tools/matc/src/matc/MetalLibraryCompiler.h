@@ -0,0 +1,37 @@
+/*
+ * Copyright (C) 2025 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_METALLIBRARYCOMPILER_H_
+#define TNT_METALLIBRARYCOMPILER_H_
+
+#include <backend/DriverEnums.h>
+
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+namespace matc {
+
+// Compiles MSL into a Metal library with the Xcode command line tools, for iOS when the shader
+// model is MOBILE and for macOS otherwise. Used as a filamat::MaterialBuilder::MetalLibraryCompiler.
+bool compileMetalLibrary(std::string const& msl,
+        filament::backend::ShaderModel shaderModel, filament::backend::ShaderStage stage,
+        std::vector<uint8_t>& library);
+
+} // namespace matc
+
+#endif // TNT_METALLIBRARYCOMPILER_H_
@@ -59,6 +59,7 @@ struct Config {
     bool transpile = false;
     bool binary = false;
     bool analyze = false;
+    bool printStats = false;
     uint64_t shaderIndex;
     int serverPort = 0;
 };
@@ -100,6 +101,8 @@ static void printUsage(const char* name) {
             "       Print the Vulkan dictionary\n\n"
             "   --print-dic-wgsl\n"
             "       Print the WebGPU dictionary\n\n"
+            "   --print-stats, -j\n"
+            "       Print the size of each chunk and of each shader, in JSON\n\n"
             "   --web-server=[port], -w\n"
             "       Serve a web page at the given port (e.g. 8080)\n\n"
             "   --dump-spirv-binary=[index], -b\n"
@@ -131,7 +134,7 @@ static void license() {
 }
 
 static int handleArguments(int argc, char* argv[], Config* config) {
-    static constexpr const char* OPTSTR = "hla:g:G:s:v:b:m:b:w:u:UXxyz";
+    static constexpr const char* OPTSTR = "hla:g:G:s:v:b:m:b:w:u:UXxyzj";
     constexpr int DUMP_METAL_LIBRARY_OPTION = 1000;
     static const struct option OPTIONS[] = {
             { "help",               no_argument,       nullptr, 'h' },
@@ -152,6 +155,7 @@ static int handleArguments(int argc, char* argv[], Config* config) {
             { "dump-spirv-binary",  required_argument, nullptr, 'b' },
             { "dump-metal-library", required_argument, nullptr, DUMP_METAL_LIBRARY_OPTION },
             { "web-server",         required_argument, nullptr, 'w' },
+            { "print-stats",        no_argument,       nullptr, 'j' },
             { nullptr, 0, nullptr, 0 }  // termination of the option list
     };
 
@@ -219,6 +223,9 @@ static int handleArguments(int argc, char* argv[], Config* config) {
             case 'z':
                 config->printDictionarySPIRV = true;
                 break;
+            case 'j':
+                config->printStats = true;
+                break;
             case 'U':
                 config->printDictionaryWGSL = true;
                 break;
@@ -428,6 +435,88 @@ static void dumpBinary(const uint8_t* data, size_t size, const std::string& file
     out.write(reinterpret_cast<const char*>(data), size);
 }
 
+static const char* toString(filament::backend::ShaderStage const stage) noexcept {
+    switch (stage) {
+        case filament::backend::ShaderStage::VERTEX:    return "vertex";
+        case filament::backend::ShaderStage::FRAGMENT:  return "fragment";
+        case filament::backend::ShaderStage::COMPUTE:   return "compute";
+    }
+    return "";
+}
+
+static const char* toString(filament::backend::ShaderModel const model) noexcept {
+    switch (model) {
+        case filament::backend::ShaderModel::MOBILE:    return "mobile";
+        case filament::backend::ShaderModel::DESKTOP:   return "desktop";
+    }
+    return "";
+}
+
+// Prints the size of the chunks, and of each shader once extracted from its dictionary.
+static bool printStats(const ChunkContainer& container, void* data, size_t size) {
+    using filament::backend::ShaderLanguage;
+    struct Language {
+        ShaderLanguage language;
+        filamat::ChunkType chunkType;
+        const char* name;
+    };
+    constexpr Language languages[] = {
+            { ShaderLanguage::ESSL3,         filamat::ChunkType::MaterialGlsl,         "glsl" },
+            { ShaderLanguage::ESSL1,         filamat::ChunkType::MaterialEssl1,        "essl1" },
+            { ShaderLanguage::SPIRV,         filamat::ChunkType::MaterialSpirv,        "spirv" },
+            { ShaderLanguage::MSL,           filamat::ChunkType::MaterialMetal,        "msl" },
+            { ShaderLanguage::METAL_LIBRARY, filamat::ChunkType::MaterialMetalLibrary, "metallib" },
+            { ShaderLanguage::WGSL,          filamat::ChunkType::MaterialWgsl,         "wgsl" },
+    };
+
+    std::cout << "{" << std::endl;
+    std::cout << R"(  "packageSize": )" << size << "," << std::endl;
+    std::cout << R"(  "chunks": {)" << std::endl;
+    for (size_t i = 0, c = container.getChunkCount(); i < c; i++) {
+        auto const chunk = container.getChunk(i);
+        char tag[9] = {};
+        for (size_t j = 0; j < 8; j++) {
+            tag[j] = char(uint64_t(chunk.type) >> (56 - j * 8));
+        }
+        std::cout << "    \"" << tag << "\": " << chunk.desc.size;
+        if (i < c - 1) std::cout << ",";
+        std::cout << std::endl;
+    }
+    std::cout << "  }," << std::endl;
+
+    std::cout << R"(  "shaders": {)" << std::endl;
+    bool firstLanguage = true;
+    for (auto const& language : languages) {
+        if (!container.hasChunk(language.chunkType)) {
+            continue;
+        }
+        ShaderExtractor parser(language.language, data, size);
+        std::vector<ShaderInfo> info(getShaderCount(container, language.chunkType));
+        if (!parser.parse() || !getShaderInfo(container, info.data(), language.chunkType)) {
+            std::cerr << "Failed to parse " << language.name << " chunk." << std::endl;
+            return false;
+        }
+        if (!firstLanguage) std::cout << "," << std::endl;
+        firstLanguage = false;
+        std::cout << "    \"" << language.name << "\": [" << std::endl;
+        filaflat::ShaderContent content;
+        for (size_t i = 0; i < info.size(); i++) {
+            auto const& item = info[i];
+            parser.getShader(item.shaderModel, item.variant, item.pipelineStage, content);
+            std::cout << R"(      { "variant": )" << +item.variant.key
+                      << R"(, "stage": ")" << toString(item.pipelineStage)
+                      << R"(", "shaderModel": ")" << toString(item.shaderModel)
+                      << R"(", "size": )" << content.size() << " }";
+            if (i < info.size() - 1) std::cout << ",";
+            std::cout << std::endl;
+        }
+        std::cout << "    ]";
+    }
+    std::cout << std::endl << "  }" << std::endl;
+    std::cout << "}" << std::endl;
+    return true;
+}
+
 static bool parseChunks(Config config, void* data, size_t size) {
     using namespace filament::matdbg;
     ChunkContainer container(data, size);
@@ -612,6 +701,10 @@ static bool parseChunks(Config config, void* data, size_t size) {
         }
     }
 
+    if (config.printStats) {
+        return printStats(container, data, size);
+    }
+
     TextWriter writer;
 
     if (config.printDictionaryGLSL || config.printDictionaryESSL1 || config.printDictionarySPIRV ||
@@ -24,13 +24,20 @@
 #include <imageio/ImageDecoder.h>
 #include <imageio/ImageEncoder.h>
 
+#include <utils/JobSystem.h>
 #include <utils/Path.h>
 
 #include <getopt/getopt.h>
 
+#include <atomic>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <mutex>
+#include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 using namespace image;
 using namespace std;
@@ -58,6 +65,7 @@ static bool g_ktx2Container = false;
 static bool g_sourceIsLinear = false;
 static bool g_quietMode = false;
 static uint32_t g_mipLevelCount = 0;
+static std::string g_batchFile;
 
 static const char* USAGE = R"TXT(
 MIPGEN generates mipmaps for an image down to the 1x1 level.
@@ -71,6 +79,7 @@ If the output format is a container format like KTX, then
 
 Usage:
     MIPGEN [options] <input_file> <output_pattern>
+    MIPGEN [options] --batch=<batch_file>
 
 Options:
    --help, -h
@@ -96,6 +105,10 @@ Options:
    --mip-levels=N, -m N
        specifies the number of mip levels to generate
        if 0 (default), all levels are generated
+   --batch=FILE, -b FILE
+       process all the images listed in the given file, concurrently, with the same options;
+       each line holds an input file and an output pattern separated by whitespace, and lines
+       that start with # are ignored
    --compression=COMPRESSION, -c COMPRESSION
        format specific compression:
            KTX, PNG, Radiance: Ignored
@@ -108,6 +121,7 @@ Examples:
     MIPGEN -g --kernel=hermite grassland.png mip_%03d.png
     MIPGEN -f ktx2 --compression=uastc grassland.png mips.ktx
     MIPGEN -f ktx grassland.png mips.ktx
+    MIPGEN -f ktx2 --compression=uastc --batch=textures.txt
 )TXT";
 
 static const char* HTML_PREFIX = R"HTML(<!DOCTYPE html>
@@ -151,7 +165,7 @@ static void license() {
 }
 
 static int handleArguments(int argc, char* argv[]) {
-    static constexpr const char* OPTSTR = "hLlgpf:c:k:saqm:";
+    static constexpr const char* OPTSTR = "hLlgpf:c:k:saqm:b:";
     static const struct option OPTIONS[] = {
             { "help",                 no_argument, 0, 'h' },
             { "license",              no_argument, 0, 'L' },
@@ -165,6 +179,7 @@ static int handleArguments(int argc, char* argv[]) {
             { "add-alpha",            no_argument, 0, 'a' },
             { "quiet",                no_argument, 0, 'q' },
             { "mip-levels",     required_argument, 0, 'm' },
+            { "batch",          required_argument, 0, 'b' },
             { 0, 0, 0, 0 }  // termination of the option list
     };
 
@@ -259,29 +274,26 @@ static int handleArguments(int argc, char* argv[]) {
                     // keep default value
                 }
                 break;
+            case 'b':
+                g_batchFile = arg;
+                break;
         }
     }
 
     return optind;
 }
 
-int main(int argc, char* argv[]) {
-    int optionIndex = handleArguments(argc, argv);
-    int numArgs = argc - optionIndex;
-    if (numArgs < 2) {
-        printUsage(argv[0]);
-        return 1;
-    }
-    Path inputPath(argv[optionIndex++]);
-    std::string outputPattern(argv[optionIndex]);
+// Generates the miplevels of one image, returns the exit code of the tool.
+static int generate(JobSystem& js, const Path& inputPath, const std::string& outputPattern) {
+    bool ktx1Container = g_ktx1Container;
+    bool ktx2Container = g_ktx2Container;
+    ImageEncoder::Format format = g_format;
     if (Path(outputPattern).getExtension() == "ktx") {
-        g_ktx1Container = true;
-        g_formatSpecified = true;
+        ktx1Container = true;
     } else if (Path(outputPattern).getExtension() == "ktx2") {
-        g_ktx2Container = true;
-        g_formatSpecified = true;
+        ktx2Container = true;
     } else if (!g_formatSpecified) {
-        g_format = ImageEncoder::chooseFormat(outputPattern, g_sourceIsLinear);
+        format = ImageEncoder::chooseFormat(outputPattern, g_sourceIsLinear);
     }
 
     if (!g_quietMode) {
@@ -324,9 +336,9 @@ int main(int argc, char* argv[]) {
     uint32_t count = getMipmapCount(sourceImage);
     count = g_mipLevelCount == 0 ? count : min(g_mipLevelCount - 1, count);
     vector<LinearImage> miplevels(count);
-    generateMipmaps(sourceImage, g_filter, miplevels.data(), count);
+    generateMipmaps(js, sourceImage, g_filter, miplevels.data(), count);
 
-    if (g_ktx1Container) {
+    if (ktx1Container) {
         if (!g_quietMode) {
             puts("Writing KTX file to disk...");
         }
@@ -411,7 +423,7 @@ int main(int argc, char* argv[]) {
         return 0;
     }
 
-    if (g_ktx2Container) {
+    if (ktx2Container) {
         if (!g_quietMode) {
             puts("Writing KTX2 file to disk...");
         }
@@ -433,6 +445,11 @@ int main(int argc, char* argv[]) {
             builder.miplevel(mipIndex++, 0, image);
         }
 
+        // The BasisU encoder has global state and runs its own thread pool, so batched images are
+        // encoded one at a time.
+        static std::mutex basisMutex;
+        std::unique_lock<std::mutex> basisLock(basisMutex);
+
         BasisEncoder* encoder = builder.build();
         if (!encoder) {
             puts("Error while creating BasisU encoder.");
@@ -442,6 +459,7 @@ int main(int argc, char* argv[]) {
         bool success = encoder->encode();
         if (!success) {
             // Error message has already been printed.
+            delete encoder;
             return 1;
         }
 
@@ -476,7 +494,7 @@ int main(int argc, char* argv[]) {
             if (g_filter == Filter::GAUSSIAN_NORMALS) {
                 image = vectorsToColors(image);
             }
-            if (!ImageEncoder::encode(outputStream, g_format, image, g_compressionString, path)) {
+            if (!ImageEncoder::encode(outputStream, format, image, g_compressionString, path)) {
                 cerr << "An error occurred while encoding the image." << endl;
                 return 1;
             }
@@ -521,4 +539,78 @@ int main(int argc, char* argv[]) {
     if (!g_quietMode) {
         puts("Done.");
     }
+    return 0;
+}
+
+// Reads the input and output pairs of a batch file, skipping empty lines and comments.
+static bool readBatchFile(const std::string& filename,
+        vector<pair<Path, std::string>>* items) {
+    ifstream input(filename);
+    if (!input) {
+        cerr << "Unable to open batch file: " << filename << endl;
+        return false;
+    }
+    std::string line;
+    for (size_t lineNumber = 1; getline(input, line); lineNumber++) {
+        istringstream fields(line);
+        std::string inputPath, outputPattern;
+        if (!(fields >> inputPath) || inputPath[0] == '#') {
+            continue;
+        }
+        if (!(fields >> outputPattern)) {
+            cerr << filename << ":" << lineNumber << ": missing output pattern." << endl;
+            return false;
+        }
+        items->emplace_back(inputPath, outputPattern);
+    }
+    return true;
+}
+
+// Processes all the images of a batch file concurrently. Each image is decoded, filtered, encoded
+// and written by its own job, so that the I/O of some images overlaps with the work on others.
+static int generateBatch(JobSystem& js, const vector<pair<Path, std::string>>& items) {
+    std::atomic<uint32_t> failures = 0;
+    auto generateRange = [&](uint32_t first, uint32_t count) {
+        for (uint32_t i = first; i < first + count; i++) {
+            if (generate(js, items[i].first, items[i].second) != 0) {
+                cerr << "Failed to process " << items[i].first.getPath() << endl;
+                failures++;
+            }
+        }
+    };
+    auto job = jobs::parallel_for(js, nullptr, 0, uint32_t(items.size()), std::ref(generateRange),
+            jobs::CountSplitter<1, 16>());
+    js.runAndWait(job);
+    cout << "Processed " << items.size() << " images, " << failures << " failed." << endl;
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+    int optionIndex = handleArguments(argc, argv);
+    int numArgs = argc - optionIndex;
+    if (numArgs < 2 && g_batchFile.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    vector<pair<Path, std::string>> items;
+    if (!g_batchFile.empty()) {
+        if (g_createGallery) {
+            cerr << "The --page option is not supported in batch mode." << endl;
+            return 1;
+        }
+        if (!readBatchFile(g_batchFile, &items)) {
+            return 1;
+        }
+        // Progress messages from concurrent images would be interleaved.
+        g_quietMode = true;
+    }
+
+    JobSystem js;
+    js.adopt();
+    int result = items.empty() && g_batchFile.empty() ?
+            generate(js, Path(argv[optionIndex]), argv[optionIndex + 1]) :
+            generateBatch(js, items);
+    js.emancipate();
+    return result;
 }
@@ -18,20 +18,21 @@
 
 #include <getopt/getopt.h>
 
+#include <atomic>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <string>
 
 #include <tsl/robin_map.h>
 
 #include <utils/FixedCapacityVector.h>
-#include <utils/memalign.h>
+#include <utils/JobSystem.h>
+#include <utils/Panic.h>
 
 #include <uberz/ReadableArchive.h>
 #include <uberz/WritableArchive.h>
 
-#include <zstd.h>
-
 using namespace std;
 using namespace utils;
 using namespace filament::uberz;
@@ -170,40 +171,61 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
+    JobSystem js;
+    js.adopt();
+
     size_t existingMaterialsCount = 0;
     ReadableArchive* existingArchive = nullptr;
+    FixedCapacityVector<uint8_t> archiveBuffer;
 
     // In append mode, the first step is to consume the output file.
     if (g_appendMode) {
         const size_t archiveSize = getFileSize(g_outputFile.c_str());
-        FixedCapacityVector<uint8_t> archiveBuffer(archiveSize);
+        archiveBuffer = FixedCapacityVector<uint8_t>(archiveSize);
         uint8_t* archiveData = archiveBuffer.data();
         std::ifstream in(g_outputFile.c_str(), std::ifstream::in | std::ifstream::binary);
         if (!in.read((char*) archiveData, archiveSize)) {
             cerr << "Unable to consume " << g_outputFile << endl;
             exit(1);
         }
-        const uint64_t decompSize = ZSTD_getFrameContentSize(archiveData, archiveSize);
-        if (decompSize == ZSTD_CONTENTSIZE_UNKNOWN || decompSize == ZSTD_CONTENTSIZE_ERROR) {
-            PANIC_POSTCONDITION("Decompression error.");
+        existingArchive = readArchive(archiveData, archiveSize);
+        if (!existingArchive) {
+            PANIC_POSTCONDITION("Invalid archive.");
         }
-        uint64_t* basePointer = (uint64_t*) utils::aligned_alloc(decompSize, 8);
-        ZSTD_decompress(basePointer, decompSize, archiveData, archiveSize);
-        existingArchive = (ReadableArchive*) basePointer;
-        convertOffsetsToPointers(existingArchive);
         existingMaterialsCount = existingArchive->specsCount;
     }
 
     WritableArchive outputArchive(existingMaterialsCount + additionalMaterialsCount);
 
-    // In append mode, add the existing materials into the new WritableArchive.
+    // In append mode, add the existing materials into the new WritableArchive. Their packages are
+    // compressed independently, so they're all decompressed in parallel first.
     if (existingArchive) {
+        FixedCapacityVector<FixedCapacityVector<uint8_t>> packages(existingMaterialsCount);
+        std::atomic<bool> decompressed = true;
+        auto decompress = [&](size_t first, size_t count) {
+            for (size_t specIndex = first; specIndex < first + count; ++specIndex) {
+                const ArchiveSpec& spec = existingArchive->specs[specIndex];
+                FixedCapacityVector<uint8_t> package(getPackageSize(*existingArchive, spec));
+                if (!readPackage(*existingArchive, spec, package.data(), package.size())) {
+                    decompressed = false;
+                }
+                packages[specIndex] = std::move(package);
+            }
+        };
+        auto* job = jobs::parallel_for(js, nullptr, 0, uint32_t(existingMaterialsCount),
+                std::ref(decompress), jobs::CountSplitter<1, 8>());
+        js.runAndWait(job);
+        if (!decompressed) {
+            PANIC_POSTCONDITION("Decompression error.");
+        }
+
         for (size_t specIndex = 0; specIndex < existingMaterialsCount; ++specIndex) {
             // We do not know where this material was originally consumed from, so just use
             // a made-up string (it is only used for error messages).
             std::string materialName = "mat" + to_string(specIndex);
             const ArchiveSpec& spec = existingArchive->specs[specIndex];
-            outputArchive.addMaterial(materialName.c_str(), spec.package, spec.packageByteCount);
+            const FixedCapacityVector<uint8_t>& package = packages[specIndex];
+            outputArchive.addMaterial(materialName.c_str(), package.data(), package.size());
             outputArchive.setShadingModel(spec.shadingModel);
             outputArchive.setBlendingModel(spec.blendingMode);
             for (uint16_t flagIndex = 0; flagIndex < spec.flagsCount; ++flagIndex) {
@@ -211,7 +233,7 @@ int main(int argc, char* argv[]) {
                 outputArchive.setFeatureFlag(flag.name, flag.value);
             }
         }
-        utils::aligned_free(existingArchive);
+        destroyArchive(existingArchive);
     }
 
     for (int argIndex = optionIndex; argIndex < argc; ++argIndex) {
@@ -259,7 +281,8 @@ int main(int argc, char* argv[]) {
         }
     }
 
-    FixedCapacityVector<uint8_t> binBuffer = outputArchive.serialize();
+    FixedCapacityVector<uint8_t> binBuffer = outputArchive.serialize(js);
+    js.emancipate();
 
     ofstream binStream(g_outputFile, ios::binary);
     if (!binStream) {
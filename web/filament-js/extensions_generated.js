@@ -9,6 +9,7 @@ Filament.loadGeneratedExtensions = function() {
             sharpness: 0.9,
             enabled: false,
             homogeneousScaling: false,
+            predictive: false,
             quality: Filament.View$QualityLevel.LOW,
         };
         return Object.assign(options, overrides);
@@ -53,6 +54,7 @@ Filament.loadGeneratedExtensions = function() {
             fogColorFromIbl: false,
             // JavaScript binding for skyColor is not yet supported, must use default value.
             enabled: false,
+            mode: Filament.View$FogOptions$Mode.PER_MATERIAL,
         };
         return Object.assign(options, overrides);
     };
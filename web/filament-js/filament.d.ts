@@ -1137,6 +1137,11 @@ export enum View$BlendMode {
  * homogeneousScaling: by default the system scales the major axis first. Set this to true
  *                     to force homogeneous scaling.
  *
+ * predictive: by default the scale is driven by a PID controller fed with the measured frame
+ *             time. Set this to true to instead pick the scale predicted to meet the target
+ *             frame time, from a model of the GPU time as a function of the rendered area and
+ *             the number of renderables in the scene. This reacts faster to load changes.
+ *
  * minScale:  the minimum scale in X and Y this View should use
  *
  * maxScale:  the maximum scale in X and Y this View should use
@@ -1173,6 +1178,10 @@ export interface View$DynamicResolutionOptions {
      * set to true to force homogeneous scaling
      */
     homogeneousScaling?: boolean;
+    /**
+     * set to true to predict the scale from a model of the GPU frame time
+     */
+    predictive?: boolean;
     /**
      * Upscaling quality
      * LOW:    bilinear filtered blit. Fastest, poor quality
@@ -1300,6 +1309,11 @@ export interface View$BloomOptions {
     haloThreshold?: number;
 }
 
+export enum View$FogOptions$Mode {
+    PER_MATERIAL,
+    FULL_SCREEN,
+}
+
 /**
  * Options to control large-scale fog in the scene
  */
@@ -1389,6 +1403,10 @@ export interface View$FogOptions {
      * Enable or disable large-scale fog
      */
     enabled?: boolean;
+    /**
+     * How the fog is applied to the scene.
+     */
+    mode?: View$FogOptions$Mode;
 }
 
 export enum View$DepthOfFieldOptions$Filter {
@@ -610,7 +610,7 @@ class_<SwapChain>("SwapChain")
 /// Renderer ::core class:: Represents the platform's native window.
 /// See also the [Engine] methods `createRenderer` and `destroyRenderer`.
 class_<Renderer>("Renderer")
-    .function("renderView", &Renderer::render, allow_raw_pointers())
+    .function("renderView", select_overload<void(View const*)>(&Renderer::render), allow_raw_pointers())
     .function("renderStandaloneView", &Renderer::renderStandaloneView, allow_raw_pointers())
     /// render ::method:: requests rendering for a single frame on the given [View]
     /// swapChain ::argument:: the [SwapChain] corresponding to the canvas
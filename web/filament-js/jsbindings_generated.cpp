@@ -16,6 +16,7 @@ value_object<View::DynamicResolutionOptions>("View$DynamicResolutionOptions")
     .field("sharpness", &View::DynamicResolutionOptions::sharpness)
     .field("enabled", &View::DynamicResolutionOptions::enabled)
     .field("homogeneousScaling", &View::DynamicResolutionOptions::homogeneousScaling)
+    .field("predictive", &View::DynamicResolutionOptions::predictive)
     .field("quality", &View::DynamicResolutionOptions::quality)
     ;
 
@@ -54,6 +55,7 @@ value_object<View::FogOptions>("View$FogOptions")
     .field("fogColorFromIbl", &View::FogOptions::fogColorFromIbl)
     // JavaScript binding for skyColor is not yet supported, must use default value.
     .field("enabled", &View::FogOptions::enabled)
+    .field("mode", &View::FogOptions::mode)
     ;
 
 value_object<View::DepthOfFieldOptions>("View$DepthOfFieldOptions")
@@ -27,6 +27,11 @@ enum_<View::BloomOptions::BlendMode>("View$BloomOptions$BlendMode")
     .value("INTERPOLATE", View::BloomOptions::BlendMode::INTERPOLATE)
     ;
 
+enum_<View::FogOptions::Mode>("View$FogOptions$Mode")
+    .value("PER_MATERIAL", View::FogOptions::Mode::PER_MATERIAL)
+    .value("FULL_SCREEN", View::FogOptions::Mode::FULL_SCREEN)
+    ;
+
 enum_<View::DepthOfFieldOptions::Filter>("View$DepthOfFieldOptions$Filter")
     .value("NONE", View::DepthOfFieldOptions::Filter::NONE)
     .value("UNUSED", View::DepthOfFieldOptions::Filter::UNUSED)